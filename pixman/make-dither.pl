@@ -0,0 +1,193 @@
+#!/usr/bin/perl -w
+
+# Generates the ordered dither matrices used for dithered stores:
+#
+#  - an 8 x 8 Bayer matrix
+#  - a 64 x 64 blue noise matrix, made with Ulichney's void-and-cluster
+#    method on a torus so that it tiles without seams
+#
+# Both are written as tables of 64 x 64 thresholds, the Bayer matrix
+# repeated 8 times in each direction. A matrix of M ranks r gives the
+# thresholds (2 * r + 1) * 255 / (2 * M), which are spread evenly over
+# [0, 254].
+
+use strict;
+
+my $size = 64;
+my $n = $size * $size;
+my $sigma = 1.5;
+my $radius = 9;
+
+# A small LCG, so that the output doesn't depend on perl's rand ()
+my $seed = 1;
+
+sub random
+{
+    my ($range) = @_;
+
+    $seed = ($seed * 1103515245 + 12345) % 2147483648;
+    return int (($seed >> 8) * $range / 8388608);
+}
+
+# Gaussian weights by offset; beyond the radius they are negligible
+my @kernel;
+for my $dy (-$radius .. $radius)
+{
+    for my $dx (-$radius .. $radius)
+    {
+	push @kernel, [ $dx, $dy,
+			exp (-($dx * $dx + $dy * $dy) / (2 * $sigma * $sigma)) ];
+    }
+}
+
+my @pattern = (0) x $n;
+my @energy = (0) x $n;
+
+sub update
+{
+    my ($p, $sign) = @_;
+    my $x = $p % $size;
+    my $y = int ($p / $size);
+
+    for my $k (@kernel)
+    {
+	my $q = (($y + $k->[1]) % $size) * $size + (($x + $k->[0]) % $size);
+
+	$energy[$q] += $sign * $k->[2];
+    }
+}
+
+sub tightest_cluster
+{
+    my $best = -1;
+
+    for my $p (0 .. $n - 1)
+    {
+	$best = $p if $pattern[$p] && ($best < 0 || $energy[$p] > $energy[$best]);
+    }
+
+    return $best;
+}
+
+sub largest_void
+{
+    my $best = -1;
+
+    for my $p (0 .. $n - 1)
+    {
+	$best = $p if !$pattern[$p] && ($best < 0 || $energy[$p] < $energy[$best]);
+    }
+
+    return $best;
+}
+
+# Initial binary pattern: a tenth of the cells, at random
+my $n_ones = int ($n / 10);
+for (my $i = 0; $i < $n_ones; )
+{
+    my $p = random ($n);
+
+    next if $pattern[$p];
+
+    $pattern[$p] = 1;
+    update ($p, 1);
+    $i++;
+}
+
+# Move points from the tightest clusters to the largest voids until
+# that doesn't change anything
+while (1)
+{
+    my $cluster = tightest_cluster ();
+
+    $pattern[$cluster] = 0;
+    update ($cluster, -1);
+
+    my $void = largest_void ();
+
+    $pattern[$void] = 1;
+    update ($void, 1);
+
+    last if $void == $cluster;
+}
+
+my @rank;
+my @initial = @pattern;
+my @initial_energy = @energy;
+
+# Rank the initial points by removing the tightest clusters first
+for (my $r = $n_ones - 1; $r >= 0; $r--)
+{
+    my $cluster = tightest_cluster ();
+
+    $pattern[$cluster] = 0;
+    update ($cluster, -1);
+    $rank[$cluster] = $r;
+}
+
+# Then fill the largest voids in order
+@pattern = @initial;
+@energy = @initial_energy;
+for my $r ($n_ones .. $n - 1)
+{
+    my $void = largest_void ();
+
+    $pattern[$void] = 1;
+    update ($void, 1);
+    $rank[$void] = $r;
+}
+
+my @bayer;
+for my $y (0 .. 7)
+{
+    for my $x (0 .. 7)
+    {
+	my $v = 0;
+
+	# Interleave the bits of x ^ y and y, least significant first
+	for my $b (0 .. 2)
+	{
+	    $v = ($v << 2) | (((($x ^ $y) >> $b) & 1) << 1) | (($y >> $b) & 1);
+	}
+	$bayer[$y * 8 + $x] = $v;
+    }
+}
+
+sub print_table
+{
+    my ($name, $ranks, $n_ranks, $period) = @_;
+
+    print "const uint8_t $name\[" . $n . "] =\n";
+    print "{\n";
+    for my $y (0 .. $size - 1)
+    {
+	for my $x (0 .. $size - 1)
+	{
+	    my $r = $ranks->[($y % $period) * $period + ($x % $period)];
+
+	    print "\t" if ($x % 16) == 0;
+	    print sprintf ("%d, ", int ((2 * $r + 1) * 255 / (2 * $n_ranks)));
+	    print "\n" if ($x % 16) == 15;
+	}
+    }
+    print "};\n";
+}
+
+print <<"PROLOG";
+/* WARNING: This file is generated by $0.
+ * Please edit that file instead of this one.
+ */
+
+#include <stdint.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pixman-private.h"
+
+PROLOG
+
+print_table ("dither_bayer_8", \@bayer, 64, 8);
+print "\n";
+print_table ("dither_blue_noise_64", \@rank, $n, $size);
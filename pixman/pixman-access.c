@@ -160,38 +160,6 @@
     while (0)
 #endif
 
-/*
- * YV12 setup and access macros
- */
-
-#define YV12_SETUP(image)                                               \
-    bits_image_t *__bits_image = (bits_image_t *)image;                 \
-    uint32_t *bits = __bits_image->bits;                                \
-    int stride = __bits_image->rowstride;                               \
-    int offset0 = stride < 0 ?                                          \
-    ((-stride) >> 1) * ((__bits_image->height - 1) >> 1) - stride :	\
-    stride * __bits_image->height;					\
-    int offset1 = stride < 0 ?                                          \
-    offset0 + ((-stride) >> 1) * ((__bits_image->height) >> 1) :	\
-	offset0 + (offset0 >> 2)
-
-/* Note no trailing semicolon on the above macro; if it's there, then
- * the typical usage of YV12_SETUP(image); will have an extra trailing ;
- * that some compilers will interpret as a statement -- and then any further
- * variable declarations will cause an error.
- */
-
-#define YV12_Y(line)                                                    \
-    ((uint8_t *) ((bits) + (stride) * (line)))
-
-#define YV12_U(line)                                                    \
-    ((uint8_t *) ((bits) + offset1 +                                    \
-                  ((stride) >> 1) * ((line) >> 1)))
-
-#define YV12_V(line)                                                    \
-    ((uint8_t *) ((bits) + offset0 +                                    \
-                  ((stride) >> 1) * ((line) >> 1)))
-
 /* Misc. helpers */
 
 static force_inline void
@@ -506,6 +474,203 @@ MAKE_ACCESSORS(a1b1g1r1);
 MAKE_ACCESSORS(a1);
 MAKE_ACCESSORS(g1);
 
+/* 64 bpp formats. The pixels are read and written as two 32 bit words
+ * so that they work with accessors.
+ */
+static force_inline uint64_t
+fetch_64 (bits_image_t *image, const uint32_t *p)
+{
+#ifdef WORDS_BIGENDIAN
+    return ((uint64_t)READ (image, p) << 32) | READ (image, p + 1);
+#else
+    return ((uint64_t)READ (image, p + 1) << 32) | READ (image, p);
+#endif
+}
+
+static force_inline void
+store_64 (bits_image_t *image, uint32_t *p, uint64_t v)
+{
+#ifdef WORDS_BIGENDIAN
+    WRITE (image, p, (uint32_t)(v >> 32));
+    WRITE (image, p + 1, (uint32_t)v);
+#else
+    WRITE (image, p, (uint32_t)v);
+    WRITE (image, p + 1, (uint32_t)(v >> 32));
+#endif
+}
+
+static force_inline argb_t
+convert_a16b16g16r16_to_argb (uint64_t p)
+{
+    argb_t argb;
+
+    argb.a = unorm_to_float (p >> 48, 16);
+    argb.r = unorm_to_float (p >>  0, 16);
+    argb.g = unorm_to_float (p >> 16, 16);
+    argb.b = unorm_to_float (p >> 32, 16);
+
+    return argb;
+}
+
+static force_inline argb_t
+convert_x16b16g16r16_to_argb (uint64_t p)
+{
+    argb_t argb = convert_a16b16g16r16_to_argb (p);
+
+    argb.a = 1.0;
+
+    return argb;
+}
+
+static force_inline argb_t
+convert_a16b16g16r16_float_to_argb (uint64_t p)
+{
+    argb_t argb;
+
+    argb.a = half_to_float (p >> 48);
+    argb.r = half_to_float (p >>  0);
+    argb.g = half_to_float (p >> 16);
+    argb.b = half_to_float (p >> 32);
+
+    return argb;
+}
+
+static force_inline uint64_t
+convert_argb_to_a16b16g16r16 (const argb_t *argb)
+{
+    return
+	((uint64_t)float_to_unorm16 (argb->a) << 48) |
+	((uint64_t)float_to_unorm16 (argb->b) << 32) |
+	((uint64_t)float_to_unorm16 (argb->g) << 16) |
+	((uint64_t)float_to_unorm16 (argb->r) <<  0);
+}
+
+static force_inline uint64_t
+convert_argb_to_x16b16g16r16 (const argb_t *argb)
+{
+    return convert_argb_to_a16b16g16r16 (argb) & 0xffffffffffffULL;
+}
+
+static force_inline uint64_t
+convert_argb_to_a16b16g16r16_float (const argb_t *argb)
+{
+    return
+	((uint64_t)float_to_half (argb->a) << 48) |
+	((uint64_t)float_to_half (argb->b) << 32) |
+	((uint64_t)float_to_half (argb->g) << 16) |
+	((uint64_t)float_to_half (argb->r) <<  0);
+}
+
+#define convert_a16b16g16r16_to_8888		convert_16161616_to_8888
+#define convert_x16b16g16r16_to_8888(p)		(convert_16161616_to_8888 (p) | 0xff000000)
+#define convert_a16b16g16r16_float_to_8888	convert_f16161616_to_8888
+#define convert_8888_to_a16b16g16r16		convert_8888_to_16161616
+#define convert_8888_to_x16b16g16r16(s)		(convert_8888_to_16161616 (s) & 0xffffffffffffULL)
+#define convert_8888_to_a16b16g16r16_float	convert_8888_to_f16161616
+
+#define MAKE_WIDE_ACCESSORS(format)					\
+    static void								\
+    fetch_scanline_ ## format ## _32 (pixman_image_t *image,		\
+				      int             x,		\
+				      int             y,		\
+				      int             width,		\
+				      uint32_t *      buffer,		\
+				      const uint32_t *mask)		\
+    {									\
+	const uint32_t *bits =						\
+	    image->bits.bits + y * image->bits.rowstride + 2 * x;	\
+	int i;								\
+									\
+	for (i = 0; i < width; ++i)					\
+	{								\
+	    buffer[i] = convert_ ## format ## _to_8888 (		\
+		fetch_64 (&image->bits, bits + 2 * i));			\
+	}								\
+    }									\
+									\
+    static void								\
+    fetch_scanline_ ## format ## _float (pixman_image_t *image,		\
+					 int             x,		\
+					 int             y,		\
+					 int             width,		\
+					 uint32_t *      buffer,	\
+					 const uint32_t *mask)		\
+    {									\
+	const uint32_t *bits =						\
+	    image->bits.bits + y * image->bits.rowstride + 2 * x;	\
+	argb_t *argb = (argb_t *)buffer;				\
+	int i;								\
+									\
+	for (i = 0; i < width; ++i)					\
+	{								\
+	    argb[i] = convert_ ## format ## _to_argb (			\
+		fetch_64 (&image->bits, bits + 2 * i));			\
+	}								\
+    }									\
+									\
+    static uint32_t							\
+    fetch_pixel_ ## format ## _32 (bits_image_t *image,		\
+				   int		 offset,		\
+				   int		 line)			\
+    {									\
+	const uint32_t *bits = image->bits + line * image->rowstride;	\
+									\
+	return convert_ ## format ## _to_8888 (				\
+	    fetch_64 (image, bits + 2 * offset));			\
+    }									\
+									\
+    static argb_t							\
+    fetch_pixel_ ## format ## _float (bits_image_t *image,		\
+				      int	    offset,		\
+				      int	    line)		\
+    {									\
+	const uint32_t *bits = image->bits + line * image->rowstride;	\
+									\
+	return convert_ ## format ## _to_argb (				\
+	    fetch_64 (image, bits + 2 * offset));			\
+    }									\
+									\
+    static void								\
+    store_scanline_ ## format ## _32 (bits_image_t *  image,		\
+				      int             x,		\
+				      int             y,		\
+				      int             width,		\
+				      const uint32_t *values)		\
+    {									\
+	uint32_t *bits = image->bits + y * image->rowstride + 2 * x;	\
+	int i;								\
+									\
+	for (i = 0; i < width; ++i)					\
+	{								\
+	    store_64 (image, bits + 2 * i,				\
+		      convert_8888_to_ ## format (values[i]));		\
+	}								\
+    }									\
+									\
+    static void								\
+    store_scanline_ ## format ## _float (bits_image_t *  image,	\
+					 int             x,		\
+					 int             y,		\
+					 int             width,		\
+					 const uint32_t *values)	\
+    {									\
+	uint32_t *bits = image->bits + y * image->rowstride + 2 * x;	\
+	const argb_t *argb = (const argb_t *)values;			\
+	int i;								\
+									\
+	for (i = 0; i < width; ++i)					\
+	{								\
+	    store_64 (image, bits + 2 * i,				\
+		      convert_argb_to_ ## format (&argb[i]));		\
+	}								\
+    }									\
+									\
+    static const void *const __dummy__ ## format
+
+MAKE_WIDE_ACCESSORS(a16b16g16r16);
+MAKE_WIDE_ACCESSORS(x16b16g16r16);
+MAKE_WIDE_ACCESSORS(a16b16g16r16_float);
+
 /********************************** Fetch ************************************/
 /* Table mapping sRGB-encoded 8 bit numbers to linearly encoded
  * floating point numbers. We assume that single precision
@@ -740,32 +905,19 @@ fetch_scanline_yuy2 (pixman_image_t *image,
                      uint32_t *      buffer,
                      const uint32_t *mask)
 {
-    const uint32_t *bits = image->bits.bits + image->bits.rowstride * line;
+    const uint8_t *bits =
+	(const uint8_t *)(image->bits.bits + image->bits.rowstride * line);
     int i;
-    
+
     for (i = 0; i < width; i++)
     {
-	int16_t y, u, v;
-	int32_t r, g, b;
-	
-	y = ((uint8_t *) bits)[(x + i) << 1] - 16;
-	u = ((uint8_t *) bits)[(((x + i) << 1) & - 4) + 1] - 128;
-	v = ((uint8_t *) bits)[(((x + i) << 1) & - 4) + 3] - 128;
-	
-	/* R = 1.164(Y - 16) + 1.596(V - 128) */
-	r = 0x012b27 * y + 0x019a2e * v;
-	/* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-	g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-	/* B = 1.164(Y - 16) + 2.018(U - 128) */
-	b = 0x012b27 * y + 0x0206a2 * u;
-	
-	*buffer++ = 0xff000000 |
-	    (r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	    (g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	    (b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+	*buffer++ = convert_yuv_to_8888 (bits[(x + i) << 1],
+					 bits[(((x + i) << 1) & - 4) + 1],
+					 bits[(((x + i) << 1) & - 4) + 3]);
     }
 }
 
+/* Also used for i420, which only differs in the order of the planes */
 static void
 fetch_scanline_yv12 (pixman_image_t *image,
                      int             x,
@@ -774,32 +926,36 @@ fetch_scanline_yv12 (pixman_image_t *image,
                      uint32_t *      buffer,
                      const uint32_t *mask)
 {
-    YV12_SETUP (image);
-    uint8_t *y_line = YV12_Y (line);
-    uint8_t *u_line = YV12_U (line);
-    uint8_t *v_line = YV12_V (line);
+    const uint8_t *y_line = PLANE_LINE (&image->bits, 0, line);
+    const uint8_t *u_line = PLANE_LINE (&image->bits, 1, line);
+    const uint8_t *v_line = PLANE_LINE (&image->bits, 2, line);
     int i;
-    
+
     for (i = 0; i < width; i++)
     {
-	int16_t y, u, v;
-	int32_t r, g, b;
-
-	y = y_line[x + i] - 16;
-	u = u_line[(x + i) >> 1] - 128;
-	v = v_line[(x + i) >> 1] - 128;
-
-	/* R = 1.164(Y - 16) + 1.596(V - 128) */
-	r = 0x012b27 * y + 0x019a2e * v;
-	/* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-	g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-	/* B = 1.164(Y - 16) + 2.018(U - 128) */
-	b = 0x012b27 * y + 0x0206a2 * u;
-
-	*buffer++ = 0xff000000 |
-	    (r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	    (g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	    (b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+	*buffer++ = convert_yuv_to_8888 (y_line[x + i],
+					 u_line[(x + i) >> 1],
+					 v_line[(x + i) >> 1]);
+    }
+}
+
+static void
+fetch_scanline_nv12 (pixman_image_t *image,
+                     int             x,
+                     int             line,
+                     int             width,
+                     uint32_t *      buffer,
+                     const uint32_t *mask)
+{
+    const uint8_t *y_line = PLANE_LINE (&image->bits, 0, line);
+    const uint8_t *uv_line = PLANE_LINE (&image->bits, 1, line);
+    int i;
+
+    for (i = 0; i < width; i++)
+    {
+	*buffer++ = convert_yuv_to_8888 (y_line[x + i],
+					 uv_line[((x + i) & ~1) + 0],
+					 uv_line[((x + i) & ~1) + 1]);
     }
 }
 
@@ -910,28 +1066,12 @@ fetch_pixel_yuy2 (bits_image_t *image,
 		  int           offset,
 		  int           line)
 {
-    const uint32_t *bits = image->bits + image->rowstride * line;
-    
-    int16_t y, u, v;
-    int32_t r, g, b;
-    
-    y = ((uint8_t *) bits)[offset << 1] - 16;
-    u = ((uint8_t *) bits)[((offset << 1) & - 4) + 1] - 128;
-    v = ((uint8_t *) bits)[((offset << 1) & - 4) + 3] - 128;
-    
-    /* R = 1.164(Y - 16) + 1.596(V - 128) */
-    r = 0x012b27 * y + 0x019a2e * v;
-    
-    /* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-    g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-    
-    /* B = 1.164(Y - 16) + 2.018(U - 128) */
-    b = 0x012b27 * y + 0x0206a2 * u;
-    
-    return 0xff000000 |
-	(r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	(g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	(b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+    const uint8_t *bits =
+	(const uint8_t *)(image->bits + image->rowstride * line);
+
+    return convert_yuv_to_8888 (bits[offset << 1],
+				bits[((offset << 1) & - 4) + 1],
+				bits[((offset << 1) & - 4) + 3]);
 }
 
 static uint32_t
@@ -939,25 +1079,21 @@ fetch_pixel_yv12 (bits_image_t *image,
 		  int           offset,
 		  int           line)
 {
-    YV12_SETUP (image);
-    int16_t y = YV12_Y (line)[offset] - 16;
-    int16_t u = YV12_U (line)[offset >> 1] - 128;
-    int16_t v = YV12_V (line)[offset >> 1] - 128;
-    int32_t r, g, b;
-    
-    /* R = 1.164(Y - 16) + 1.596(V - 128) */
-    r = 0x012b27 * y + 0x019a2e * v;
-    
-    /* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-    g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-    
-    /* B = 1.164(Y - 16) + 2.018(U - 128) */
-    b = 0x012b27 * y + 0x0206a2 * u;
-    
-    return 0xff000000 |
-	(r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	(g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	(b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+    return convert_yuv_to_8888 (PLANE_LINE (image, 0, line)[offset],
+				PLANE_LINE (image, 1, line)[offset >> 1],
+				PLANE_LINE (image, 2, line)[offset >> 1]);
+}
+
+static uint32_t
+fetch_pixel_nv12 (bits_image_t *image,
+		  int           offset,
+		  int           line)
+{
+    const uint8_t *uv_line = PLANE_LINE (image, 1, line);
+
+    return convert_yuv_to_8888 (PLANE_LINE (image, 0, line)[offset],
+				uv_line[(offset & ~1) + 0],
+				uv_line[(offset & ~1) + 1]);
 }
 
 /*********************************** Store ************************************/
@@ -1120,6 +1256,55 @@ store_scanline_generic_float (bits_image_t *  image,
     free (argb8_pixels);
 }
 
+/* Dithers a8r8g8b8 values down to the channel sizes of the format,
+ * then stores them with the store of the format.
+ */
+static void
+store_scanline_dither (bits_image_t *  image,
+		       int             x,
+		       int             y,
+		       int             width,
+		       const uint32_t *values)
+{
+    const uint8_t *row = dither_row (image, y);
+    int bits[4], i, j;
+    uint32_t buffer[64];
+
+    bits[0] = PIXMAN_FORMAT_B (image->format);
+    bits[1] = PIXMAN_FORMAT_G (image->format);
+    bits[2] = PIXMAN_FORMAT_R (image->format);
+    bits[3] = PIXMAN_FORMAT_A (image->format);
+
+    while (width)
+    {
+	int n = width < 64 ? width : 64;
+
+	for (i = 0; i < n; ++i)
+	{
+	    uint32_t t = row[(x + i + image->dither_offset_x) & 63];
+	    uint32_t p = values[i];
+
+	    for (j = 0; j < 4; ++j)
+	    {
+		if (bits[j] && bits[j] < 8)
+		{
+		    uint32_t c = dither_channel ((p >> (8 * j)) & 0xff, t, bits[j]);
+
+		    p = (p & ~(0xffU << (8 * j))) | (c << (8 * j));
+		}
+	    }
+
+	    buffer[i] = p;
+	}
+
+	image->store_scanline_undithered_32 (image, x, y, n, buffer);
+
+	x += n;
+	values += n;
+	width -= n;
+    }
+}
+
 static void
 fetch_scanline_generic_float (pixman_image_t *image,
 			      int	      x,
@@ -1275,6 +1460,17 @@ typedef struct
 	    store_scanline_generic_float				\
     }
 
+#define WIDE_FORMAT_INFO(format)					\
+    {									\
+	PIXMAN_ ## format,						\
+	    fetch_scanline_ ## format ## _32,				\
+	    fetch_scanline_ ## format ## _float,			\
+	    fetch_pixel_ ## format ## _32,				\
+	    fetch_pixel_ ## format ## _float,				\
+	    store_scanline_ ## format ## _32,				\
+	    store_scanline_ ## format ## _float				\
+    }
+
 static const format_info_t accessors[] =
 {
 /* 32 bpp formats */
@@ -1352,6 +1548,10 @@ static const format_info_t accessors[] =
     
 /* Wide formats */
     
+    WIDE_FORMAT_INFO (a16b16g16r16),
+    WIDE_FORMAT_INFO (x16b16g16r16),
+    WIDE_FORMAT_INFO (a16b16g16r16_float),
+
     { PIXMAN_a2r10g10b10,
       NULL, fetch_scanline_a2r10g10b10_float,
       fetch_pixel_generic_lossy_32, fetch_pixel_a2r10g10b10_float,
@@ -1382,6 +1582,16 @@ static const format_info_t accessors[] =
       fetch_scanline_yv12, fetch_scanline_generic_float,
       fetch_pixel_yv12, fetch_pixel_generic_float,
       NULL, NULL },
+
+    { PIXMAN_i420,
+      fetch_scanline_yv12, fetch_scanline_generic_float,
+      fetch_pixel_yv12, fetch_pixel_generic_float,
+      NULL, NULL },
+
+    { PIXMAN_nv12,
+      fetch_scanline_nv12, fetch_scanline_generic_float,
+      fetch_pixel_nv12, fetch_pixel_generic_float,
+      NULL, NULL },
     
     { PIXMAN_null },
 };
@@ -1401,6 +1611,10 @@ setup_accessors (bits_image_t *image)
 	    image->fetch_pixel_float = info->fetch_pixel_float;
 	    image->store_scanline_32 = info->store_scanline_32;
 	    image->store_scanline_float = info->store_scanline_float;
+
+	    image->store_scanline_undithered_32 = info->store_scanline_32;
+	    if (!(image->common.flags & FAST_PATH_NO_DITHER))
+		image->store_scanline_32 = store_scanline_dither;
 	    
 	    return;
 	}
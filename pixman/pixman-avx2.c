@@ -0,0 +1,3735 @@
+/*
+ * Copyright © 2008 Rodrigo Kumpera
+ * Copyright © 2008 André Tupinambá
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of Red Hat not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  Red Hat makes no representations about the
+ * suitability of this software for any purpose.  It is provided "as is"
+ * without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN
+ * AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING
+ * OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+ * SOFTWARE.
+ *
+ * Based on pixman-sse2.c. The arithmetic is identical to the SSE2
+ * implementation, so results are bit-exact with it and with the C
+ * fallbacks; only the vector width differs.
+ */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <immintrin.h> /* for AVX2 intrinsics */
+#include <float.h>
+#include "pixman-private.h"
+#include "pixman-combine32.h"
+#include "pixman-inlines.h"
+
+static __m256i mask_0080;
+static __m256i mask_00ff;
+static __m256i mask_0101;
+static __m256i mask_ff000000;
+
+static __m256i mask_red;
+static __m256i mask_green;
+static __m256i mask_blue;
+static __m256i mask_565_fix_rb;
+static __m256i mask_565_fix_g;
+
+/*
+ * Single pixel helpers. These use the low 128 bits of the 256 bit
+ * constants and are used for the unaligned heads and tails of scanlines.
+ */
+static force_inline __m128i
+unpack_32_1x128 (uint32_t data)
+{
+    return _mm_unpacklo_epi8 (_mm_cvtsi32_si128 (data), _mm_setzero_si128 ());
+}
+
+static force_inline uint32_t
+pack_1x128_32 (__m128i data)
+{
+    return _mm_cvtsi128_si32 (_mm_packus_epi16 (data, _mm_setzero_si128 ()));
+}
+
+static force_inline __m128i
+expand_alpha_1x128 (__m128i data)
+{
+    return _mm_shufflelo_epi16 (data, _MM_SHUFFLE (3, 3, 3, 3));
+}
+
+static force_inline __m128i
+expand_alpha_rev_1x128 (__m128i data)
+{
+    return _mm_shufflelo_epi16 (data, _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+static force_inline __m128i
+expand_pixel_8_1x128 (uint8_t data)
+{
+    return _mm_shufflelo_epi16 (
+	unpack_32_1x128 ((uint32_t)data), _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+static force_inline __m128i
+pix_multiply_1x128 (__m128i data,
+		    __m128i alpha)
+{
+    return _mm_mulhi_epu16 (
+	_mm_adds_epu16 (_mm_mullo_epi16 (data, alpha),
+			_mm256_castsi256_si128 (mask_0080)),
+	_mm256_castsi256_si128 (mask_0101));
+}
+
+static force_inline __m128i
+negate_1x128 (__m128i data)
+{
+    return _mm_xor_si128 (data, _mm256_castsi256_si128 (mask_00ff));
+}
+
+static force_inline __m128i
+over_1x128 (__m128i src, __m128i alpha, __m128i dst)
+{
+    return _mm_adds_epu8 (src, pix_multiply_1x128 (dst, negate_1x128 (alpha)));
+}
+
+static force_inline __m128i
+in_over_1x128 (__m128i* src, __m128i* alpha, __m128i* mask, __m128i* dst)
+{
+    return over_1x128 (pix_multiply_1x128 (*src, *mask),
+		       pix_multiply_1x128 (*alpha, *mask),
+		       *dst);
+}
+
+static force_inline uint32_t
+core_combine_over_u_pixel_avx2 (uint32_t src, uint32_t dst)
+{
+    uint8_t a;
+    __m128i xmms;
+
+    a = src >> 24;
+
+    if (a == 0xff)
+    {
+	return src;
+    }
+    else if (src)
+    {
+	xmms = unpack_32_1x128 (src);
+	return pack_1x128_32 (
+	    over_1x128 (xmms, expand_alpha_1x128 (xmms),
+			unpack_32_1x128 (dst)));
+    }
+
+    return dst;
+}
+
+/* Returns dst multiplied by the alpha of src */
+static force_inline uint32_t
+core_combine_in_u_pixel_avx2 (uint32_t src, uint32_t dst)
+{
+    uint32_t maska = src >> 24;
+
+    if (maska == 0)
+    {
+	return 0;
+    }
+    else if (maska != 0xff)
+    {
+	return pack_1x128_32 (
+	    pix_multiply_1x128 (unpack_32_1x128 (dst),
+				expand_alpha_1x128 (unpack_32_1x128 (src))));
+    }
+
+    return dst;
+}
+
+/* Returns dst multiplied by the inverse alpha of src */
+static force_inline uint32_t
+core_combine_out_u_pixel_avx2 (uint32_t src, uint32_t dst)
+{
+    return pack_1x128_32 (
+	pix_multiply_1x128 (
+	    unpack_32_1x128 (dst),
+	    negate_1x128 (expand_alpha_1x128 (unpack_32_1x128 (src)))));
+}
+
+static force_inline uint32_t
+combine1 (const uint32_t *ps, const uint32_t *pm)
+{
+    uint32_t s = *ps;
+
+    if (pm)
+    {
+	__m128i ms, mm;
+
+	mm = unpack_32_1x128 (*pm);
+	mm = expand_alpha_1x128 (mm);
+
+	ms = unpack_32_1x128 (s);
+	ms = pix_multiply_1x128 (ms, mm);
+
+	s = pack_1x128_32 (ms);
+    }
+
+    return s;
+}
+
+/*
+ * Eight pixel helpers.
+ *
+ * Unpacking works within the two 128 bit lanes, so the "lo" half of
+ * an unpacked register holds pixels 0, 1, 4 and 5, and the "hi" half
+ * holds pixels 2, 3, 6 and 7. Packing undoes this, so as long as both
+ * halves are treated alike the order never has to be fixed up.
+ */
+
+/* load 8 pixels from a 32-byte boundary aligned address */
+static force_inline __m256i
+load_256_aligned (__m256i* src)
+{
+    return _mm256_load_si256 (src);
+}
+
+/* load 8 pixels from a unaligned address */
+static force_inline __m256i
+load_256_unaligned (const __m256i* src)
+{
+    return _mm256_loadu_si256 (src);
+}
+
+/* save 8 pixels on a 32-byte boundary aligned address */
+static force_inline void
+save_256_aligned (__m256i* dst,
+                  __m256i  data)
+{
+    _mm256_store_si256 (dst, data);
+}
+
+/* save 8 pixels on a 32-byte boundary aligned address, bypassing the
+ * cache when streaming is set. The caller has to issue an sfence when
+ * it is done with streaming stores.
+ */
+static force_inline void
+save_256_aligned_nt (__m256i*      dst,
+                     __m256i       data,
+                     pixman_bool_t streaming)
+{
+    if (streaming)
+	_mm256_stream_si256 (dst, data);
+    else
+	_mm256_store_si256 (dst, data);
+}
+
+/* save 8 pixels on a unaligned address */
+static force_inline void
+save_256_unaligned (__m256i* dst,
+                    __m256i  data)
+{
+    _mm256_storeu_si256 (dst, data);
+}
+
+static force_inline void
+unpack_256_2x256 (__m256i data, __m256i* data_lo, __m256i* data_hi)
+{
+    *data_lo = _mm256_unpacklo_epi8 (data, _mm256_setzero_si256 ());
+    *data_hi = _mm256_unpackhi_epi8 (data, _mm256_setzero_si256 ());
+}
+
+static force_inline __m256i
+pack_2x256_256 (__m256i lo, __m256i hi)
+{
+    return _mm256_packus_epi16 (lo, hi);
+}
+
+static force_inline int
+is_opaque_256 (__m256i x)
+{
+    __m256i ffs = _mm256_cmpeq_epi8 (x, x);
+
+    return (_mm256_movemask_epi8 (
+		_mm256_cmpeq_epi8 (x, ffs)) & 0x88888888) == 0x88888888;
+}
+
+static force_inline int
+is_zero_256 (__m256i x)
+{
+    return _mm256_testz_si256 (x, x);
+}
+
+static force_inline int
+is_transparent_256 (__m256i x)
+{
+    return (_mm256_movemask_epi8 (
+		_mm256_cmpeq_epi8 (x, _mm256_setzero_si256 ())) & 0x88888888)
+	== 0x88888888;
+}
+
+static force_inline void
+expand_alpha_2x256 (__m256i  data_lo,
+                    __m256i  data_hi,
+                    __m256i* alpha_lo,
+                    __m256i* alpha_hi)
+{
+    __m256i lo, hi;
+
+    lo = _mm256_shufflelo_epi16 (data_lo, _MM_SHUFFLE (3, 3, 3, 3));
+    hi = _mm256_shufflelo_epi16 (data_hi, _MM_SHUFFLE (3, 3, 3, 3));
+
+    *alpha_lo = _mm256_shufflehi_epi16 (lo, _MM_SHUFFLE (3, 3, 3, 3));
+    *alpha_hi = _mm256_shufflehi_epi16 (hi, _MM_SHUFFLE (3, 3, 3, 3));
+}
+
+static force_inline void
+expand_alpha_rev_2x256 (__m256i  data_lo,
+                        __m256i  data_hi,
+                        __m256i* alpha_lo,
+                        __m256i* alpha_hi)
+{
+    __m256i lo, hi;
+
+    lo = _mm256_shufflelo_epi16 (data_lo, _MM_SHUFFLE (0, 0, 0, 0));
+    hi = _mm256_shufflelo_epi16 (data_hi, _MM_SHUFFLE (0, 0, 0, 0));
+
+    *alpha_lo = _mm256_shufflehi_epi16 (lo, _MM_SHUFFLE (0, 0, 0, 0));
+    *alpha_hi = _mm256_shufflehi_epi16 (hi, _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+static force_inline void
+pix_multiply_2x256 (__m256i* data_lo,
+                    __m256i* data_hi,
+                    __m256i* alpha_lo,
+                    __m256i* alpha_hi,
+                    __m256i* ret_lo,
+                    __m256i* ret_hi)
+{
+    __m256i lo, hi;
+
+    lo = _mm256_mullo_epi16 (*data_lo, *alpha_lo);
+    hi = _mm256_mullo_epi16 (*data_hi, *alpha_hi);
+    lo = _mm256_adds_epu16 (lo, mask_0080);
+    hi = _mm256_adds_epu16 (hi, mask_0080);
+    *ret_lo = _mm256_mulhi_epu16 (lo, mask_0101);
+    *ret_hi = _mm256_mulhi_epu16 (hi, mask_0101);
+}
+
+static force_inline void
+negate_2x256 (__m256i  data_lo,
+              __m256i  data_hi,
+              __m256i* neg_lo,
+              __m256i* neg_hi)
+{
+    *neg_lo = _mm256_xor_si256 (data_lo, mask_00ff);
+    *neg_hi = _mm256_xor_si256 (data_hi, mask_00ff);
+}
+
+static force_inline void
+over_2x256 (__m256i* src_lo,
+            __m256i* src_hi,
+            __m256i* alpha_lo,
+            __m256i* alpha_hi,
+            __m256i* dst_lo,
+            __m256i* dst_hi)
+{
+    __m256i t1, t2;
+
+    negate_2x256 (*alpha_lo, *alpha_hi, &t1, &t2);
+
+    pix_multiply_2x256 (dst_lo, dst_hi, &t1, &t2, dst_lo, dst_hi);
+
+    *dst_lo = _mm256_adds_epu8 (*src_lo, *dst_lo);
+    *dst_hi = _mm256_adds_epu8 (*src_hi, *dst_hi);
+}
+
+static force_inline void
+in_over_2x256 (__m256i* src_lo,
+               __m256i* src_hi,
+               __m256i* alpha_lo,
+               __m256i* alpha_hi,
+               __m256i* mask_lo,
+               __m256i* mask_hi,
+               __m256i* dst_lo,
+               __m256i* dst_hi)
+{
+    __m256i s_lo, s_hi;
+    __m256i a_lo, a_hi;
+
+    pix_multiply_2x256 (src_lo,   src_hi, mask_lo, mask_hi, &s_lo, &s_hi);
+    pix_multiply_2x256 (alpha_lo, alpha_hi, mask_lo, mask_hi, &a_lo, &a_hi);
+
+    over_2x256 (&s_lo, &s_hi, &a_lo, &a_hi, dst_lo, dst_hi);
+}
+
+/* Multiplies each pixel of @data by the alpha of the corresponding pixel
+ * of @alpha, or by its inverse if @negate is set.
+ */
+static force_inline __m256i
+pix_multiply_alpha_256 (__m256i data, __m256i alpha, pixman_bool_t negate)
+{
+    __m256i data_lo, data_hi;
+    __m256i alpha_lo, alpha_hi;
+
+    unpack_256_2x256 (data, &data_lo, &data_hi);
+    unpack_256_2x256 (alpha, &alpha_lo, &alpha_hi);
+
+    expand_alpha_2x256 (alpha_lo, alpha_hi, &alpha_lo, &alpha_hi);
+    if (negate)
+	negate_2x256 (alpha_lo, alpha_hi, &alpha_lo, &alpha_hi);
+
+    pix_multiply_2x256 (&data_lo, &data_hi, &alpha_lo, &alpha_hi,
+			&data_lo, &data_hi);
+
+    return pack_2x256_256 (data_lo, data_hi);
+}
+
+static force_inline __m256i
+combine8 (const __m256i *ps, const __m256i *pm)
+{
+    __m256i s, m;
+
+    if (pm)
+    {
+	m = load_256_unaligned (pm);
+
+	if (is_transparent_256 (m))
+	    return _mm256_setzero_si256 ();
+    }
+
+    s = load_256_unaligned (ps);
+
+    if (pm)
+	s = pix_multiply_alpha_256 (s, m, FALSE);
+
+    return s;
+}
+
+/* Expands eight a8 values into a pair of registers holding each value
+ * replicated into all four 16 bit channels, in the same pixel order
+ * that unpack_256_2x256 produces.
+ */
+static force_inline void
+expand_a8_2x256 (const uint8_t *m, __m256i* mask_lo, __m256i* mask_hi)
+{
+    __m256i mask = _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((__m128i *)m));
+
+    unpack_256_2x256 (mask, mask_lo, mask_hi);
+    expand_alpha_rev_2x256 (*mask_lo, *mask_hi, mask_lo, mask_hi);
+}
+
+static force_inline __m256i
+unpack_565_to_8888 (__m256i lo)
+{
+    __m256i r, g, b, rb, t;
+
+    r = _mm256_and_si256 (_mm256_slli_epi32 (lo, 8), mask_red);
+    g = _mm256_and_si256 (_mm256_slli_epi32 (lo, 5), mask_green);
+    b = _mm256_and_si256 (_mm256_slli_epi32 (lo, 3), mask_blue);
+
+    rb = _mm256_or_si256 (r, b);
+    t  = _mm256_and_si256 (rb, mask_565_fix_rb);
+    t  = _mm256_srli_epi32 (t, 5);
+    rb = _mm256_or_si256 (rb, t);
+
+    t  = _mm256_and_si256 (g, mask_565_fix_g);
+    t  = _mm256_srli_epi32 (t, 6);
+    g  = _mm256_or_si256 (g, t);
+
+    return _mm256_or_si256 (rb, g);
+}
+
+/*
+ * Combiners
+ */
+
+static force_inline void
+core_combine_over_u_avx2 (uint32_t *	   pd,
+			  const uint32_t * ps,
+			  const uint32_t * pm,
+			  int              w)
+{
+    uint32_t s, d;
+
+    /* Align dst on a 32-byte boundary */
+    while (w && ((uintptr_t)pd & 31))
+    {
+	d = *pd;
+	s = combine1 (ps, pm);
+
+	if (s)
+	    *pd = core_combine_over_u_pixel_avx2 (s, d);
+	pd++;
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i src;
+
+	src = combine8 ((__m256i *)ps, (__m256i *)pm);
+
+	if (!is_zero_256 (src))
+	{
+	    if (is_opaque_256 (src))
+	    {
+		save_256_aligned ((__m256i *)pd, src);
+	    }
+	    else
+	    {
+		__m256i dst = load_256_aligned ((__m256i *)pd);
+		__m256i src_lo, src_hi, dst_lo, dst_hi;
+		__m256i alpha_lo, alpha_hi;
+
+		unpack_256_2x256 (src, &src_lo, &src_hi);
+		unpack_256_2x256 (dst, &dst_lo, &dst_hi);
+
+		expand_alpha_2x256 (src_lo, src_hi, &alpha_lo, &alpha_hi);
+
+		over_2x256 (&src_lo, &src_hi, &alpha_lo, &alpha_hi,
+			    &dst_lo, &dst_hi);
+
+		save_256_aligned ((__m256i *)pd,
+				  pack_2x256_256 (dst_lo, dst_hi));
+	    }
+	}
+
+	ps += 8;
+	pd += 8;
+	if (pm)
+	    pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	d = *pd;
+	s = combine1 (ps, pm);
+
+	if (s)
+	    *pd = core_combine_over_u_pixel_avx2 (s, d);
+	pd++;
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+}
+
+static void
+avx2_combine_over_u (pixman_implementation_t *imp,
+                     pixman_op_t              op,
+                     uint32_t *               pd,
+                     const uint32_t *         ps,
+                     const uint32_t *         pm,
+                     int                      w)
+{
+    core_combine_over_u_avx2 (pd, ps, pm, w);
+}
+
+static void
+avx2_combine_over_reverse_u (pixman_implementation_t *imp,
+                             pixman_op_t              op,
+                             uint32_t *               pd,
+                             const uint32_t *         ps,
+                             const uint32_t *         pm,
+                             int                      w)
+{
+    uint32_t s, d;
+
+    while (w && ((uintptr_t)pd & 31))
+    {
+	d = *pd;
+	s = combine1 (ps, pm);
+
+	*pd++ = core_combine_over_u_pixel_avx2 (d, s);
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i src_lo, src_hi, dst_lo, dst_hi;
+	__m256i alpha_lo, alpha_hi;
+
+	unpack_256_2x256 (combine8 ((__m256i *)ps, (__m256i *)pm),
+			  &src_lo, &src_hi);
+	unpack_256_2x256 (load_256_aligned ((__m256i *)pd),
+			  &dst_lo, &dst_hi);
+
+	expand_alpha_2x256 (dst_lo, dst_hi, &alpha_lo, &alpha_hi);
+
+	over_2x256 (&dst_lo, &dst_hi, &alpha_lo, &alpha_hi,
+		    &src_lo, &src_hi);
+
+	save_256_aligned ((__m256i *)pd, pack_2x256_256 (src_lo, src_hi));
+
+	ps += 8;
+	pd += 8;
+	if (pm)
+	    pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	d = *pd;
+	s = combine1 (ps, pm);
+
+	*pd++ = core_combine_over_u_pixel_avx2 (d, s);
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+}
+
+/* IN, IN_REVERSE, OUT and OUT_REVERSE all multiply one operand by the
+ * (possibly inverted) alpha of the other, so they share one loop.
+ */
+static force_inline void
+core_combine_alpha_u_avx2 (uint32_t *       pd,
+			   const uint32_t * ps,
+			   const uint32_t * pm,
+			   int              w,
+			   pixman_bool_t    reverse,
+			   pixman_bool_t    negate)
+{
+    uint32_t s, d;
+
+    while (w && ((uintptr_t)pd & 31))
+    {
+	s = combine1 (ps, pm);
+	d = *pd;
+
+	if (negate)
+	    *pd++ = reverse ? core_combine_out_u_pixel_avx2 (s, d) :
+			      core_combine_out_u_pixel_avx2 (d, s);
+	else
+	    *pd++ = reverse ? core_combine_in_u_pixel_avx2 (s, d) :
+			      core_combine_in_u_pixel_avx2 (d, s);
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i src = combine8 ((__m256i *)ps, (__m256i *)pm);
+	__m256i dst = load_256_aligned ((__m256i *)pd);
+
+	if (reverse)
+	    dst = pix_multiply_alpha_256 (dst, src, negate);
+	else
+	    dst = pix_multiply_alpha_256 (src, dst, negate);
+
+	save_256_aligned ((__m256i *)pd, dst);
+
+	ps += 8;
+	pd += 8;
+	if (pm)
+	    pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	s = combine1 (ps, pm);
+	d = *pd;
+
+	if (negate)
+	    *pd++ = reverse ? core_combine_out_u_pixel_avx2 (s, d) :
+			      core_combine_out_u_pixel_avx2 (d, s);
+	else
+	    *pd++ = reverse ? core_combine_in_u_pixel_avx2 (s, d) :
+			      core_combine_in_u_pixel_avx2 (d, s);
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+}
+
+static void
+avx2_combine_in_u (pixman_implementation_t *imp,
+                   pixman_op_t              op,
+                   uint32_t *               pd,
+                   const uint32_t *         ps,
+                   const uint32_t *         pm,
+                   int                      w)
+{
+    core_combine_alpha_u_avx2 (pd, ps, pm, w, FALSE, FALSE);
+}
+
+static void
+avx2_combine_in_reverse_u (pixman_implementation_t *imp,
+                           pixman_op_t              op,
+                           uint32_t *               pd,
+                           const uint32_t *         ps,
+                           const uint32_t *         pm,
+                           int                      w)
+{
+    core_combine_alpha_u_avx2 (pd, ps, pm, w, TRUE, FALSE);
+}
+
+static void
+avx2_combine_out_u (pixman_implementation_t *imp,
+                    pixman_op_t              op,
+                    uint32_t *               pd,
+                    const uint32_t *         ps,
+                    const uint32_t *         pm,
+                    int                      w)
+{
+    core_combine_alpha_u_avx2 (pd, ps, pm, w, FALSE, TRUE);
+}
+
+static void
+avx2_combine_out_reverse_u (pixman_implementation_t *imp,
+                            pixman_op_t              op,
+                            uint32_t *               pd,
+                            const uint32_t *         ps,
+                            const uint32_t *         pm,
+                            int                      w)
+{
+    core_combine_alpha_u_avx2 (pd, ps, pm, w, TRUE, TRUE);
+}
+
+static force_inline void
+core_combine_add_u_avx2 (uint32_t *       pd,
+			 const uint32_t * ps,
+			 const uint32_t * pm,
+			 int              w)
+{
+    uint32_t s, d;
+
+    while (w && ((uintptr_t)pd & 31))
+    {
+	s = combine1 (ps, pm);
+	d = *pd;
+
+	*pd++ = _mm_cvtsi128_si32 (
+	    _mm_adds_epu8 (_mm_cvtsi32_si128 (s), _mm_cvtsi32_si128 (d)));
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i s;
+
+	s = combine8 ((__m256i *)ps, (__m256i *)pm);
+
+	save_256_aligned (
+	    (__m256i *)pd, _mm256_adds_epu8 (s, load_256_aligned ((__m256i *)pd)));
+
+	ps += 8;
+	pd += 8;
+	if (pm)
+	    pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	s = combine1 (ps, pm);
+	d = *pd;
+
+	*pd++ = _mm_cvtsi128_si32 (
+	    _mm_adds_epu8 (_mm_cvtsi32_si128 (s), _mm_cvtsi32_si128 (d)));
+	ps++;
+	if (pm)
+	    pm++;
+	w--;
+    }
+}
+
+static void
+avx2_combine_add_u (pixman_implementation_t *imp,
+                    pixman_op_t              op,
+                    uint32_t *               pd,
+                    const uint32_t *         ps,
+                    const uint32_t *         pm,
+                    int                      w)
+{
+    core_combine_add_u_avx2 (pd, ps, pm, w);
+}
+
+static void
+avx2_combine_src_ca (pixman_implementation_t *imp,
+                     pixman_op_t              op,
+                     uint32_t *               pd,
+                     const uint32_t *         ps,
+                     const uint32_t *         pm,
+                     int                      w)
+{
+    uint32_t s, m;
+
+    while (w && (uintptr_t)pd & 31)
+    {
+	s = *ps++;
+	m = *pm++;
+	*pd++ = pack_1x128_32 (
+	    pix_multiply_1x128 (unpack_32_1x128 (s), unpack_32_1x128 (m)));
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i src_lo, src_hi, mask_lo, mask_hi;
+
+	unpack_256_2x256 (load_256_unaligned ((__m256i *)ps), &src_lo, &src_hi);
+	unpack_256_2x256 (load_256_unaligned ((__m256i *)pm), &mask_lo, &mask_hi);
+
+	pix_multiply_2x256 (&src_lo, &src_hi, &mask_lo, &mask_hi,
+			    &src_lo, &src_hi);
+
+	save_256_aligned ((__m256i *)pd, pack_2x256_256 (src_lo, src_hi));
+
+	ps += 8;
+	pd += 8;
+	pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	s = *ps++;
+	m = *pm++;
+	*pd++ = pack_1x128_32 (
+	    pix_multiply_1x128 (unpack_32_1x128 (s), unpack_32_1x128 (m)));
+	w--;
+    }
+}
+
+static force_inline uint32_t
+core_combine_over_ca_pixel_avx2 (uint32_t src,
+				 uint32_t mask,
+				 uint32_t dst)
+{
+    __m128i s = unpack_32_1x128 (src);
+    __m128i expAlpha = expand_alpha_1x128 (s);
+    __m128i unpk_mask = unpack_32_1x128 (mask);
+    __m128i unpk_dst  = unpack_32_1x128 (dst);
+
+    return pack_1x128_32 (in_over_1x128 (&s, &expAlpha, &unpk_mask, &unpk_dst));
+}
+
+static void
+avx2_combine_over_ca (pixman_implementation_t *imp,
+                      pixman_op_t              op,
+                      uint32_t *               pd,
+                      const uint32_t *         ps,
+                      const uint32_t *         pm,
+                      int                      w)
+{
+    uint32_t s, m, d;
+
+    while (w && (uintptr_t)pd & 31)
+    {
+	s = *ps++;
+	m = *pm++;
+	d = *pd;
+
+	*pd++ = core_combine_over_ca_pixel_avx2 (s, m, d);
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i src_lo, src_hi, dst_lo, dst_hi, mask_lo, mask_hi;
+	__m256i alpha_lo, alpha_hi;
+
+	unpack_256_2x256 (load_256_unaligned ((__m256i *)ps), &src_lo, &src_hi);
+	unpack_256_2x256 (load_256_aligned ((__m256i *)pd), &dst_lo, &dst_hi);
+	unpack_256_2x256 (load_256_unaligned ((__m256i *)pm), &mask_lo, &mask_hi);
+
+	expand_alpha_2x256 (src_lo, src_hi, &alpha_lo, &alpha_hi);
+
+	in_over_2x256 (&src_lo, &src_hi, &alpha_lo, &alpha_hi,
+		       &mask_lo, &mask_hi, &dst_lo, &dst_hi);
+
+	save_256_aligned ((__m256i *)pd, pack_2x256_256 (dst_lo, dst_hi));
+
+	ps += 8;
+	pd += 8;
+	pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	s = *ps++;
+	m = *pm++;
+	d = *pd;
+
+	*pd++ = core_combine_over_ca_pixel_avx2 (s, m, d);
+	w--;
+    }
+}
+
+static void
+avx2_combine_add_ca (pixman_implementation_t *imp,
+                     pixman_op_t              op,
+                     uint32_t *               pd,
+                     const uint32_t *         ps,
+                     const uint32_t *         pm,
+                     int                      w)
+{
+    uint32_t s, m, d;
+
+    while (w && (uintptr_t)pd & 31)
+    {
+	s = *ps++;
+	m = *pm++;
+	d = *pd;
+
+	*pd++ = pack_1x128_32 (
+	    _mm_adds_epu8 (pix_multiply_1x128 (unpack_32_1x128 (s),
+					       unpack_32_1x128 (m)),
+			   unpack_32_1x128 (d)));
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m256i src_lo, src_hi, dst_lo, dst_hi, mask_lo, mask_hi;
+
+	unpack_256_2x256 (load_256_unaligned ((__m256i *)ps), &src_lo, &src_hi);
+	unpack_256_2x256 (load_256_aligned ((__m256i *)pd), &dst_lo, &dst_hi);
+	unpack_256_2x256 (load_256_unaligned ((__m256i *)pm), &mask_lo, &mask_hi);
+
+	pix_multiply_2x256 (&src_lo, &src_hi, &mask_lo, &mask_hi,
+			    &src_lo, &src_hi);
+
+	save_256_aligned (
+	    (__m256i *)pd, pack_2x256_256 (_mm256_adds_epu8 (src_lo, dst_lo),
+					   _mm256_adds_epu8 (src_hi, dst_hi)));
+
+	ps += 8;
+	pd += 8;
+	pm += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	s = *ps++;
+	m = *pm++;
+	d = *pd;
+
+	*pd++ = pack_1x128_32 (
+	    _mm_adds_epu8 (pix_multiply_1x128 (unpack_32_1x128 (s),
+					       unpack_32_1x128 (m)),
+			   unpack_32_1x128 (d)));
+	w--;
+    }
+}
+
+/*
+ * Float combiners for the wide pipeline, two pixels at a time. They do
+ * the operations of the ones in pixman-combine-float.c in the same
+ * order, so they give the same results, and leave the other operators
+ * to them.
+ */
+typedef enum
+{
+    ZERO,
+    ONE,
+    SRC_ALPHA,
+    DEST_ALPHA,
+    INV_SA,
+    INV_DA,
+    SA_OVER_DA,
+    DA_OVER_SA,
+    INV_SA_OVER_DA,
+    INV_DA_OVER_SA,
+    ONE_MINUS_SA_OVER_DA,
+    ONE_MINUS_DA_OVER_SA,
+    ONE_MINUS_INV_DA_OVER_SA,
+    ONE_MINUS_INV_SA_OVER_DA
+} combine_factor_t;
+
+typedef __m256 (* combine_channel_avx2_t) (__m256 sa, __m256 s,
+					   __m256 da, __m256 d);
+
+static force_inline __m256
+select_ps (__m256 m, __m256 a, __m256 b)
+{
+    return _mm256_blendv_ps (b, a, m);
+}
+
+static force_inline __m256
+splat_alpha_ps (__m256 v)
+{
+    return _mm256_permute_ps (v, _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+/* IS_ZERO() in pixman-combine-float.c */
+static force_inline __m256
+is_zero_ps (__m256 f)
+{
+    return _mm256_and_ps (
+	_mm256_cmp_ps (f, _mm256_set1_ps (-FLT_MIN), _CMP_GT_OQ),
+	_mm256_cmp_ps (f, _mm256_set1_ps (FLT_MIN), _CMP_LT_OQ));
+}
+
+static force_inline __m256
+clamp_ps (__m256 f)
+{
+    __m256 one = _mm256_set1_ps (1.0f);
+
+    f = select_ps (_mm256_cmp_ps (f, one, _CMP_GT_OQ), one, f);
+
+    return _mm256_andnot_ps (
+	_mm256_cmp_ps (f, _mm256_setzero_ps (), _CMP_LT_OQ), f);
+}
+
+/* The C code doesn't divide where the divisor is zero. Neither must
+ * this, in case division by zero traps, so those lanes divide by one
+ * and their results are thrown away.
+ */
+static force_inline __m256
+divisor_ps (__m256 f, __m256 zero)
+{
+    return select_ps (zero, _mm256_set1_ps (1.0f), f);
+}
+
+static force_inline __m256
+get_factor_avx2 (combine_factor_t factor, __m256 sa, __m256 da)
+{
+    __m256 one = _mm256_set1_ps (1.0f);
+    __m256 zero = _mm256_setzero_ps ();
+    __m256 f = zero, z;
+
+    switch (factor)
+    {
+    case ZERO:
+	f = zero;
+	break;
+
+    case ONE:
+	f = one;
+	break;
+
+    case SRC_ALPHA:
+	f = sa;
+	break;
+
+    case DEST_ALPHA:
+	f = da;
+	break;
+
+    case INV_SA:
+	f = _mm256_sub_ps (one, sa);
+	break;
+
+    case INV_DA:
+	f = _mm256_sub_ps (one, da);
+	break;
+
+    case SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = clamp_ps (_mm256_div_ps (sa, divisor_ps (da, z)));
+	f = select_ps (z, one, f);
+	break;
+
+    case DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = clamp_ps (_mm256_div_ps (da, divisor_ps (sa, z)));
+	f = select_ps (z, one, f);
+	break;
+
+    case INV_SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = _mm256_div_ps (_mm256_sub_ps (one, sa), divisor_ps (da, z));
+	f = select_ps (z, one, clamp_ps (f));
+	break;
+
+    case INV_DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = _mm256_div_ps (_mm256_sub_ps (one, da), divisor_ps (sa, z));
+	f = select_ps (z, one, clamp_ps (f));
+	break;
+
+    case ONE_MINUS_SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = _mm256_sub_ps (one, _mm256_div_ps (sa, divisor_ps (da, z)));
+	f = _mm256_andnot_ps (z, clamp_ps (f));
+	break;
+
+    case ONE_MINUS_DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = _mm256_sub_ps (one, _mm256_div_ps (da, divisor_ps (sa, z)));
+	f = _mm256_andnot_ps (z, clamp_ps (f));
+	break;
+
+    case ONE_MINUS_INV_DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = _mm256_div_ps (_mm256_sub_ps (one, da), divisor_ps (sa, z));
+	f = _mm256_andnot_ps (z, clamp_ps (_mm256_sub_ps (one, f)));
+	break;
+
+    case ONE_MINUS_INV_SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = _mm256_div_ps (_mm256_sub_ps (one, sa), divisor_ps (da, z));
+	f = _mm256_andnot_ps (z, clamp_ps (_mm256_sub_ps (one, f)));
+	break;
+    }
+
+    return f;
+}
+
+static force_inline void
+combine_float_inner_avx2 (pixman_bool_t component,
+			  float *dest, const float *src, const float *mask,
+			  int n_pixels,
+			  combine_channel_avx2_t combine_a,
+			  combine_channel_avx2_t combine_c)
+{
+    __m256i last = _mm256_setr_epi32 (-1, -1, -1, -1, 0, 0, 0, 0);
+    int i;
+
+    for (i = 0; i < 4 * n_pixels; i += 8)
+    {
+	/* An odd pixel at the end is loaded with zeros after it, which
+	 * the combiners handle without dividing by zero.
+	 */
+	__m256i valid =
+	    (i + 4 < 4 * n_pixels) ? _mm256_set1_epi32 (-1) : last;
+	__m256 s = _mm256_maskload_ps (src + i, valid);
+	__m256 d = _mm256_maskload_ps (dest + i, valid);
+	__m256 sa, da, result;
+
+	if (!mask)
+	{
+	    sa = splat_alpha_ps (s);
+	}
+	else if (component)
+	{
+	    __m256 m = _mm256_maskload_ps (mask + i, valid);
+
+	    sa = _mm256_mul_ps (m, splat_alpha_ps (s));
+	    s = _mm256_mul_ps (s, m);
+	}
+	else
+	{
+	    s = _mm256_mul_ps (
+		s, splat_alpha_ps (_mm256_maskload_ps (mask + i, valid)));
+	    sa = splat_alpha_ps (s);
+	}
+
+	da = splat_alpha_ps (d);
+
+	result = combine_c (sa, s, da, d);
+	if (combine_a != combine_c)
+	    result = _mm256_blend_ps (result, combine_a (sa, s, da, d), 0x11);
+
+	_mm256_maskstore_ps (dest + i, valid, result);
+    }
+}
+
+#define MAKE_COMBINER_AVX2(name, component, combine_a, combine_c)	\
+    static void								\
+    avx2_combine_ ## name ## _float (pixman_implementation_t *imp,	\
+				     pixman_op_t              op,	\
+				     float                   *dest,	\
+				     const float             *src,	\
+				     const float             *mask,	\
+				     int                      n_pixels)	\
+    {									\
+	combine_float_inner_avx2 (component, dest, src, mask, n_pixels,	\
+				  combine_a, combine_c);		\
+    }
+
+#define MAKE_COMBINERS_AVX2(name, combine_a, combine_c)			\
+    MAKE_COMBINER_AVX2 (name ## _ca, TRUE, combine_a, combine_c)	\
+    MAKE_COMBINER_AVX2 (name ## _u, FALSE, combine_a, combine_c)
+
+#define MAKE_PD_COMBINERS_AVX2(name, a, b)				\
+    static force_inline __m256						\
+    pd_combine_ ## name ## _avx2 (__m256 sa, __m256 s,			\
+				  __m256 da, __m256 d)			\
+    {									\
+	__m256 fa = get_factor_avx2 (a, sa, da);			\
+	__m256 fb = get_factor_avx2 (b, sa, da);			\
+									\
+	return _mm256_min_ps (_mm256_set1_ps (1.0f),			\
+			      _mm256_add_ps (_mm256_mul_ps (s, fa),	\
+					     _mm256_mul_ps (d, fb)));	\
+    }									\
+									\
+    MAKE_COMBINERS_AVX2 (name, pd_combine_ ## name ## _avx2,		\
+			 pd_combine_ ## name ## _avx2)
+
+MAKE_PD_COMBINERS_AVX2 (clear,			ZERO,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (src,			ONE,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (dst,			ZERO,				ONE)
+MAKE_PD_COMBINERS_AVX2 (over,			ONE,				INV_SA)
+MAKE_PD_COMBINERS_AVX2 (over_reverse,		INV_DA,				ONE)
+MAKE_PD_COMBINERS_AVX2 (in,			DEST_ALPHA,			ZERO)
+MAKE_PD_COMBINERS_AVX2 (in_reverse,		ZERO,				SRC_ALPHA)
+MAKE_PD_COMBINERS_AVX2 (out,			INV_DA,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (out_reverse,		ZERO,				INV_SA)
+MAKE_PD_COMBINERS_AVX2 (atop,			DEST_ALPHA,			INV_SA)
+MAKE_PD_COMBINERS_AVX2 (atop_reverse,		INV_DA,				SRC_ALPHA)
+MAKE_PD_COMBINERS_AVX2 (xor,			INV_DA,				INV_SA)
+MAKE_PD_COMBINERS_AVX2 (add,			ONE,				ONE)
+
+MAKE_PD_COMBINERS_AVX2 (saturate,		INV_DA_OVER_SA,			ONE)
+
+MAKE_PD_COMBINERS_AVX2 (disjoint_clear,		ZERO,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (disjoint_src,		ONE,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (disjoint_dst,		ZERO,				ONE)
+MAKE_PD_COMBINERS_AVX2 (disjoint_over,		ONE,				INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (disjoint_over_reverse,	INV_DA_OVER_SA,			ONE)
+MAKE_PD_COMBINERS_AVX2 (disjoint_in,		ONE_MINUS_INV_DA_OVER_SA,	ZERO)
+MAKE_PD_COMBINERS_AVX2 (disjoint_in_reverse,	ZERO,				ONE_MINUS_INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (disjoint_out,		INV_DA_OVER_SA,			ZERO)
+MAKE_PD_COMBINERS_AVX2 (disjoint_out_reverse,	ZERO,				INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (disjoint_atop,		ONE_MINUS_INV_DA_OVER_SA,	INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (disjoint_atop_reverse,	INV_DA_OVER_SA,			ONE_MINUS_INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (disjoint_xor,		INV_DA_OVER_SA,			INV_SA_OVER_DA)
+
+MAKE_PD_COMBINERS_AVX2 (conjoint_clear,		ZERO,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (conjoint_src,		ONE,				ZERO)
+MAKE_PD_COMBINERS_AVX2 (conjoint_dst,		ZERO,				ONE)
+MAKE_PD_COMBINERS_AVX2 (conjoint_over,		ONE,				ONE_MINUS_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (conjoint_over_reverse,	ONE_MINUS_DA_OVER_SA,		ONE)
+MAKE_PD_COMBINERS_AVX2 (conjoint_in,		DA_OVER_SA,			ZERO)
+MAKE_PD_COMBINERS_AVX2 (conjoint_in_reverse,	ZERO,				SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (conjoint_out,		ONE_MINUS_DA_OVER_SA,		ZERO)
+MAKE_PD_COMBINERS_AVX2 (conjoint_out_reverse,	ZERO,				ONE_MINUS_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (conjoint_atop,		DA_OVER_SA,			ONE_MINUS_SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (conjoint_atop_reverse,	ONE_MINUS_DA_OVER_SA,		SA_OVER_DA)
+MAKE_PD_COMBINERS_AVX2 (conjoint_xor,		ONE_MINUS_DA_OVER_SA,		ONE_MINUS_SA_OVER_DA)
+
+#define MAKE_SEPARABLE_PDF_COMBINERS_AVX2(name)				\
+    static force_inline __m256						\
+    combine_ ## name ## _a_avx2 (__m256 sa, __m256 s,			\
+				 __m256 da, __m256 d)			\
+    {									\
+	return _mm256_sub_ps (_mm256_add_ps (da, sa),			\
+			      _mm256_mul_ps (da, sa));			\
+    }									\
+									\
+    static force_inline __m256						\
+    combine_ ## name ## _c_avx2 (__m256 sa, __m256 s,			\
+				 __m256 da, __m256 d)			\
+    {									\
+	__m256 one = _mm256_set1_ps (1.0f);				\
+	__m256 f = _mm256_add_ps (					\
+	    _mm256_mul_ps (_mm256_sub_ps (one, sa), d),			\
+	    _mm256_mul_ps (_mm256_sub_ps (one, da), s));		\
+									\
+	return _mm256_add_ps (f, blend_ ## name ## _avx2 (sa, s, da, d)); \
+    }									\
+									\
+    MAKE_COMBINERS_AVX2 (name, combine_ ## name ## _a_avx2,		\
+			 combine_ ## name ## _c_avx2)
+
+static force_inline __m256
+blend_multiply_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    return _mm256_mul_ps (d, s);
+}
+
+static force_inline __m256
+blend_screen_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 t = _mm256_add_ps (_mm256_mul_ps (d, sa), _mm256_mul_ps (s, da));
+
+    return _mm256_sub_ps (t, _mm256_mul_ps (s, d));
+}
+
+static force_inline __m256
+blend_overlay_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two = _mm256_set1_ps (2.0f);
+    __m256 lo = _mm256_mul_ps (_mm256_mul_ps (two, s), d);
+    __m256 hi = _mm256_sub_ps (
+	_mm256_mul_ps (sa, da),
+	_mm256_mul_ps (_mm256_mul_ps (two, _mm256_sub_ps (da, d)),
+		       _mm256_sub_ps (sa, s)));
+    __m256 m = _mm256_cmp_ps (_mm256_mul_ps (two, d), da, _CMP_LT_OQ);
+
+    return select_ps (m, lo, hi);
+}
+
+static force_inline __m256
+blend_darken_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    return _mm256_min_ps (_mm256_mul_ps (d, sa), _mm256_mul_ps (s, da));
+}
+
+static force_inline __m256
+blend_lighten_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    return _mm256_max_ps (_mm256_mul_ps (s, da), _mm256_mul_ps (d, sa));
+}
+
+static force_inline __m256
+blend_hard_light_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two = _mm256_set1_ps (2.0f);
+    __m256 lo = _mm256_mul_ps (_mm256_mul_ps (two, s), d);
+    __m256 hi = _mm256_sub_ps (
+	_mm256_mul_ps (sa, da),
+	_mm256_mul_ps (_mm256_mul_ps (two, _mm256_sub_ps (da, d)),
+		       _mm256_sub_ps (sa, s)));
+    __m256 m = _mm256_cmp_ps (_mm256_mul_ps (two, s), sa, _CMP_LT_OQ);
+
+    return select_ps (m, lo, hi);
+}
+
+static force_inline __m256
+blend_difference_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 dsa = _mm256_mul_ps (d, sa);
+    __m256 sda = _mm256_mul_ps (s, da);
+
+    return select_ps (_mm256_cmp_ps (sda, dsa, _CMP_LT_OQ),
+		      _mm256_sub_ps (dsa, sda), _mm256_sub_ps (sda, dsa));
+}
+
+static force_inline __m256
+blend_exclusion_avx2 (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two = _mm256_set1_ps (2.0f);
+
+    __m256 t = _mm256_add_ps (_mm256_mul_ps (s, da), _mm256_mul_ps (d, sa));
+
+    return _mm256_sub_ps (t, _mm256_mul_ps (_mm256_mul_ps (two, d), s));
+}
+
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (multiply)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (screen)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (overlay)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (darken)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (lighten)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (hard_light)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (difference)
+MAKE_SEPARABLE_PDF_COMBINERS_AVX2 (exclusion)
+
+/*
+ * Composite functions
+ */
+
+static void
+avx2_composite_over_n_8888 (pixman_implementation_t *imp,
+                            pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t src;
+    uint32_t *dst_line, *dst, d;
+    int32_t w;
+    int dst_stride;
+    __m128i xmm_src, xmm_alpha;
+    __m256i ymm_src, ymm_alpha;
+
+    src = _pixman_image_get_solid (imp, src_image, dest_image->bits.format);
+
+    if (src == 0)
+	return;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    xmm_src = unpack_32_1x128 (src);
+    xmm_alpha = expand_alpha_1x128 (xmm_src);
+    ymm_src = _mm256_broadcastq_epi64 (xmm_src);
+    ymm_alpha = _mm256_broadcastq_epi64 (xmm_alpha);
+
+    while (height--)
+    {
+	dst = dst_line;
+
+	dst_line += dst_stride;
+	w = width;
+
+	while (w && (uintptr_t)dst & 31)
+	{
+	    d = *dst;
+	    *dst++ = pack_1x128_32 (
+		over_1x128 (xmm_src, xmm_alpha, unpack_32_1x128 (d)));
+	    w--;
+	}
+
+	while (w >= 8)
+	{
+	    __m256i dst_lo, dst_hi;
+
+	    unpack_256_2x256 (load_256_aligned ((__m256i *)dst),
+			      &dst_lo, &dst_hi);
+
+	    over_2x256 (&ymm_src, &ymm_src, &ymm_alpha, &ymm_alpha,
+			&dst_lo, &dst_hi);
+
+	    save_256_aligned ((__m256i *)dst, pack_2x256_256 (dst_lo, dst_hi));
+
+	    w -= 8;
+	    dst += 8;
+	}
+
+	while (w)
+	{
+	    d = *dst;
+	    *dst++ = pack_1x128_32 (
+		over_1x128 (xmm_src, xmm_alpha, unpack_32_1x128 (d)));
+	    w--;
+	}
+    }
+}
+
+static void
+avx2_composite_over_8888_8888 (pixman_implementation_t *imp,
+                               pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    int dst_stride, src_stride;
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    dst = dst_line;
+    src = src_line;
+
+    while (height--)
+    {
+	core_combine_over_u_avx2 (dst, src, NULL, width);
+
+	dst += dst_stride;
+	src += src_stride;
+    }
+}
+
+static void
+avx2_composite_over_n_8_8888 (pixman_implementation_t *imp,
+                              pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t src, srca;
+    uint32_t *dst_line, *dst;
+    uint8_t *mask_line, *mask;
+    int dst_stride, mask_stride;
+    int32_t w;
+    uint64_t m;
+
+    __m128i xmm_src, xmm_alpha, xmm_mask, xmm_dst;
+    __m256i ymm_src, ymm_alpha, ymm_def;
+
+    src = _pixman_image_get_solid (imp, src_image, dest_image->bits.format);
+
+    srca = src >> 24;
+    if (src == 0)
+	return;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	mask_image, mask_x, mask_y, uint8_t, mask_stride, mask_line, 1);
+
+    ymm_def = _mm256_set1_epi32 (src);
+    xmm_src = unpack_32_1x128 (src);
+    xmm_alpha = expand_alpha_1x128 (xmm_src);
+    ymm_src = _mm256_broadcastq_epi64 (xmm_src);
+    ymm_alpha = _mm256_broadcastq_epi64 (xmm_alpha);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	mask = mask_line;
+	mask_line += mask_stride;
+	w = width;
+
+	while (w && (uintptr_t)dst & 31)
+	{
+	    uint8_t a = *mask++;
+
+	    if (a)
+	    {
+		xmm_mask = expand_pixel_8_1x128 (a);
+		xmm_dst = unpack_32_1x128 (*dst);
+
+		*dst = pack_1x128_32 (
+		    in_over_1x128 (&xmm_src, &xmm_alpha, &xmm_mask, &xmm_dst));
+	    }
+
+	    w--;
+	    dst++;
+	}
+
+	while (w >= 8)
+	{
+	    memcpy (&m, mask, sizeof (uint64_t));
+
+	    if (srca == 0xff && m == 0xffffffffffffffffULL)
+	    {
+		save_256_aligned ((__m256i *)dst, ymm_def);
+	    }
+	    else if (m)
+	    {
+		__m256i dst_lo, dst_hi, mask_lo, mask_hi;
+
+		unpack_256_2x256 (load_256_aligned ((__m256i *)dst),
+				  &dst_lo, &dst_hi);
+		expand_a8_2x256 (mask, &mask_lo, &mask_hi);
+
+		in_over_2x256 (&ymm_src, &ymm_src,
+			       &ymm_alpha, &ymm_alpha,
+			       &mask_lo, &mask_hi,
+			       &dst_lo, &dst_hi);
+
+		save_256_aligned (
+		    (__m256i *)dst, pack_2x256_256 (dst_lo, dst_hi));
+	    }
+
+	    w -= 8;
+	    dst += 8;
+	    mask += 8;
+	}
+
+	while (w)
+	{
+	    uint8_t a = *mask++;
+
+	    if (a)
+	    {
+		xmm_mask = expand_pixel_8_1x128 (a);
+		xmm_dst = unpack_32_1x128 (*dst);
+
+		*dst = pack_1x128_32 (
+		    in_over_1x128 (&xmm_src, &xmm_alpha, &xmm_mask, &xmm_dst));
+	    }
+
+	    w--;
+	    dst++;
+	}
+    }
+}
+
+static void
+avx2_composite_over_8888_n_8888 (pixman_implementation_t *imp,
+                                 pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    uint32_t mask;
+    int32_t w;
+    int dst_stride, src_stride;
+
+    __m128i xmm_mask;
+    __m256i ymm_mask;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    mask = _pixman_image_get_solid (imp, mask_image, PIXMAN_a8r8g8b8);
+
+    xmm_mask = _mm_set1_epi16 (mask >> 24);
+    ymm_mask = _mm256_set1_epi16 (mask >> 24);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w && (uintptr_t)dst & 31)
+	{
+	    uint32_t s = *src++;
+
+	    if (s)
+	    {
+		__m128i ms = unpack_32_1x128 (s);
+		__m128i alpha = expand_alpha_1x128 (ms);
+		__m128i dest = unpack_32_1x128 (*dst);
+
+		*dst = pack_1x128_32 (
+		    in_over_1x128 (&ms, &alpha, &xmm_mask, &dest));
+	    }
+	    dst++;
+	    w--;
+	}
+
+	while (w >= 8)
+	{
+	    __m256i ymm_src = load_256_unaligned ((__m256i *)src);
+
+	    if (!is_zero_256 (ymm_src))
+	    {
+		__m256i src_lo, src_hi, dst_lo, dst_hi;
+		__m256i alpha_lo, alpha_hi;
+
+		unpack_256_2x256 (ymm_src, &src_lo, &src_hi);
+		unpack_256_2x256 (load_256_aligned ((__m256i *)dst),
+				  &dst_lo, &dst_hi);
+		expand_alpha_2x256 (src_lo, src_hi, &alpha_lo, &alpha_hi);
+
+		in_over_2x256 (&src_lo, &src_hi, &alpha_lo, &alpha_hi,
+			       &ymm_mask, &ymm_mask, &dst_lo, &dst_hi);
+
+		save_256_aligned (
+		    (__m256i *)dst, pack_2x256_256 (dst_lo, dst_hi));
+	    }
+
+	    dst += 8;
+	    src += 8;
+	    w -= 8;
+	}
+
+	while (w)
+	{
+	    uint32_t s = *src++;
+
+	    if (s)
+	    {
+		__m128i ms = unpack_32_1x128 (s);
+		__m128i alpha = expand_alpha_1x128 (ms);
+		__m128i dest = unpack_32_1x128 (*dst);
+
+		*dst = pack_1x128_32 (
+		    in_over_1x128 (&ms, &alpha, &xmm_mask, &dest));
+	    }
+	    dst++;
+	    w--;
+	}
+    }
+}
+
+static void
+avx2_composite_src_x888_8888 (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int32_t w;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w && (uintptr_t)dst & 31)
+	{
+	    *dst++ = *src++ | 0xff000000;
+	    w--;
+	}
+
+	while (w >= 16)
+	{
+	    __m256i ymm_src1, ymm_src2;
+
+	    ymm_src1 = load_256_unaligned ((__m256i *)src + 0);
+	    ymm_src2 = load_256_unaligned ((__m256i *)src + 1);
+
+	    save_256_aligned ((__m256i *)dst + 0,
+			      _mm256_or_si256 (ymm_src1, mask_ff000000));
+	    save_256_aligned ((__m256i *)dst + 1,
+			      _mm256_or_si256 (ymm_src2, mask_ff000000));
+
+	    dst += 16;
+	    src += 16;
+	    w -= 16;
+	}
+
+	while (w)
+	{
+	    *dst++ = *src++ | 0xff000000;
+	    w--;
+	}
+    }
+}
+
+static void
+avx2_composite_add_8_8 (pixman_implementation_t *imp,
+			pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint8_t     *dst_line, *dst;
+    uint8_t     *src_line, *src;
+    int dst_stride, src_stride;
+    int32_t w;
+    uint16_t t;
+
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint8_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint8_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	src = src_line;
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+	w = width;
+
+	while (w && (uintptr_t)dst & 31)
+	{
+	    t = (*dst) + (*src++);
+	    *dst++ = t | (0 - (t >> 8));
+	    w--;
+	}
+
+	while (w >= 32)
+	{
+	    save_256_aligned (
+		(__m256i *)dst,
+		_mm256_adds_epu8 (load_256_unaligned ((__m256i *)src),
+				  load_256_aligned ((__m256i *)dst)));
+
+	    dst += 32;
+	    src += 32;
+	    w -= 32;
+	}
+
+	while (w)
+	{
+	    t = (*dst) + (*src++);
+	    *dst++ = t | (0 - (t >> 8));
+	    w--;
+	}
+    }
+}
+
+static void
+avx2_composite_add_8888_8888 (pixman_implementation_t *imp,
+                              pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+
+	core_combine_add_u_avx2 (dst, src, NULL, width);
+    }
+}
+
+static force_inline void
+avx2_blt_lines (uint8_t *     src_bytes,
+                uint8_t *     dst_bytes,
+                int           src_stride,
+                int           dst_stride,
+                int           byte_width,
+                int           height,
+                pixman_bool_t streaming)
+{
+    while (height--)
+    {
+	int w;
+	uint8_t *s = src_bytes;
+	uint8_t *d = dst_bytes;
+	src_bytes += src_stride;
+	dst_bytes += dst_stride;
+	w = byte_width;
+
+	while (w >= 2 && ((uintptr_t)d & 3))
+	{
+	    *(uint16_t *)d = *(uint16_t *)s;
+	    w -= 2;
+	    s += 2;
+	    d += 2;
+	}
+
+	while (w >= 4 && ((uintptr_t)d & 31))
+	{
+	    *(uint32_t *)d = *(uint32_t *)s;
+
+	    w -= 4;
+	    s += 4;
+	    d += 4;
+	}
+
+	while (w >= 128)
+	{
+	    __m256i ymm0, ymm1, ymm2, ymm3;
+
+	    ymm0 = load_256_unaligned ((__m256i*)(s));
+	    ymm1 = load_256_unaligned ((__m256i*)(s + 32));
+	    ymm2 = load_256_unaligned ((__m256i*)(s + 64));
+	    ymm3 = load_256_unaligned ((__m256i*)(s + 96));
+
+	    save_256_aligned_nt ((__m256i*)(d),      ymm0, streaming);
+	    save_256_aligned_nt ((__m256i*)(d + 32), ymm1, streaming);
+	    save_256_aligned_nt ((__m256i*)(d + 64), ymm2, streaming);
+	    save_256_aligned_nt ((__m256i*)(d + 96), ymm3, streaming);
+
+	    s += 128;
+	    d += 128;
+	    w -= 128;
+	}
+
+	while (w >= 32)
+	{
+	    save_256_aligned_nt ((__m256i*)d, load_256_unaligned ((__m256i*)s),
+				 streaming);
+
+	    w -= 32;
+	    d += 32;
+	    s += 32;
+	}
+
+	while (w >= 4)
+	{
+	    *(uint32_t *)d = *(uint32_t *)s;
+
+	    w -= 4;
+	    s += 4;
+	    d += 4;
+	}
+
+	if (w >= 2)
+	{
+	    *(uint16_t *)d = *(uint16_t *)s;
+	    w -= 2;
+	    s += 2;
+	    d += 2;
+	}
+    }
+}
+
+static pixman_bool_t
+avx2_blt (pixman_implementation_t *imp,
+          uint32_t *               src_bits,
+          uint32_t *               dst_bits,
+          int                      src_stride,
+          int                      dst_stride,
+          int                      src_bpp,
+          int                      dst_bpp,
+          int                      src_x,
+          int                      src_y,
+          int                      dest_x,
+          int                      dest_y,
+          int                      width,
+          int                      height)
+{
+    uint8_t *   src_bytes;
+    uint8_t *   dst_bytes;
+    int byte_width;
+
+    if (src_bpp != dst_bpp)
+	return FALSE;
+
+    if (src_bpp == 16)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 2;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 2;
+	src_bytes =(uint8_t *)(((uint16_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint16_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 2 * width;
+	src_stride *= 2;
+	dst_stride *= 2;
+    }
+    else if (src_bpp == 32)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 4;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 4;
+	src_bytes = (uint8_t *)(((uint32_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint32_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 4 * width;
+	src_stride *= 4;
+	dst_stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    if (_pixman_use_streaming_stores (width, height, dst_bpp))
+    {
+	avx2_blt_lines (src_bytes, dst_bytes, src_stride, dst_stride,
+			byte_width, height, TRUE);
+	_mm_sfence ();
+    }
+    else
+    {
+	avx2_blt_lines (src_bytes, dst_bytes, src_stride, dst_stride,
+			byte_width, height, FALSE);
+    }
+
+    return TRUE;
+}
+
+static void
+avx2_composite_copy_area (pixman_implementation_t *imp,
+                          pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    avx2_blt (imp, src_image->bits.bits,
+	      dest_image->bits.bits,
+	      src_image->bits.rowstride,
+	      dest_image->bits.rowstride,
+	      PIXMAN_FORMAT_BPP (src_image->bits.format),
+	      PIXMAN_FORMAT_BPP (dest_image->bits.format),
+	      src_x, src_y, dest_x, dest_y, width, height);
+}
+
+static force_inline void
+avx2_fill_lines (uint8_t *     byte_line,
+                 int           stride,
+                 int           byte_width,
+                 int           height,
+                 uint32_t      filler,
+                 pixman_bool_t streaming)
+{
+    __m256i ymm_def = _mm256_set1_epi32 (filler);
+
+    while (height--)
+    {
+	int w;
+	uint8_t *d = byte_line;
+	byte_line += stride;
+	w = byte_width;
+
+	if (w >= 1 && ((uintptr_t)d & 1))
+	{
+	    *(uint8_t *)d = filler;
+	    w -= 1;
+	    d += 1;
+	}
+
+	while (w >= 2 && ((uintptr_t)d & 3))
+	{
+	    *(uint16_t *)d = filler;
+	    w -= 2;
+	    d += 2;
+	}
+
+	while (w >= 4 && ((uintptr_t)d & 31))
+	{
+	    *(uint32_t *)d = filler;
+
+	    w -= 4;
+	    d += 4;
+	}
+
+	while (w >= 128)
+	{
+	    save_256_aligned_nt ((__m256i*)(d),      ymm_def, streaming);
+	    save_256_aligned_nt ((__m256i*)(d + 32), ymm_def, streaming);
+	    save_256_aligned_nt ((__m256i*)(d + 64), ymm_def, streaming);
+	    save_256_aligned_nt ((__m256i*)(d + 96), ymm_def, streaming);
+
+	    d += 128;
+	    w -= 128;
+	}
+
+	while (w >= 32)
+	{
+	    save_256_aligned_nt ((__m256i*)(d),      ymm_def, streaming);
+
+	    d += 32;
+	    w -= 32;
+	}
+
+	while (w >= 4)
+	{
+	    *(uint32_t *)d = filler;
+
+	    w -= 4;
+	    d += 4;
+	}
+
+	if (w >= 2)
+	{
+	    *(uint16_t *)d = filler;
+	    w -= 2;
+	    d += 2;
+	}
+
+	if (w >= 1)
+	{
+	    *(uint8_t *)d = filler;
+	    w -= 1;
+	    d += 1;
+	}
+    }
+}
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+static pixman_bool_t
+avx2_fill (pixman_implementation_t *imp,
+           uint32_t *               bits,
+           int                      stride,
+           int                      bpp,
+           int                      x,
+           int                      y,
+           int                      width,
+           int                      height,
+           uint32_t		    filler)
+{
+    uint32_t byte_width;
+    uint8_t *byte_line;
+
+    if (bpp == 8)
+    {
+	uint8_t b;
+	uint16_t w;
+
+	stride = stride * (int) sizeof (uint32_t) / 1;
+	byte_line = (uint8_t *)(((uint8_t *)bits) + stride * y + x);
+	byte_width = width;
+	stride *= 1;
+
+	b = filler & 0xff;
+	w = (b << 8) | b;
+	filler = (w << 16) | w;
+    }
+    else if (bpp == 16)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 2;
+	byte_line = (uint8_t *)(((uint16_t *)bits) + stride * y + x);
+	byte_width = 2 * width;
+	stride *= 2;
+
+        filler = (filler & 0xffff) * 0x00010001;
+    }
+    else if (bpp == 32)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 4;
+	byte_line = (uint8_t *)(((uint32_t *)bits) + stride * y + x);
+	byte_width = 4 * width;
+	stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    if (_pixman_use_streaming_stores (width, height, bpp))
+    {
+	avx2_fill_lines (byte_line, stride, byte_width, height, filler, TRUE);
+	_mm_sfence ();
+    }
+    else
+    {
+	avx2_fill_lines (byte_line, stride, byte_width, height, filler, FALSE);
+    }
+
+    return TRUE;
+}
+
+/* Glyph rows are short and start anywhere, so these use unaligned
+ * accesses and masked loads and stores for the last few pixels of
+ * a row, instead of aligning the destination and doing the head and
+ * the tail one pixel at a time.
+ */
+static force_inline __m256i
+tail_lanes_256 (int w)
+{
+    return _mm256_cmpgt_epi32 (_mm256_set1_epi32 (w),
+			       _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+static force_inline void
+avx2_glyph_over_n_8_line (uint32_t *     dst,
+                          const uint8_t *mask,
+                          int            w,
+                          uint32_t       srca,
+                          __m256i        ymm_src,
+                          __m256i        ymm_alpha,
+                          __m256i        ymm_def)
+{
+    __m256i dst_lo, dst_hi, mask_lo, mask_hi;
+    uint64_t m;
+
+    while (w >= 8)
+    {
+	memcpy (&m, mask, sizeof (uint64_t));
+
+	if (srca == 0xff && m == 0xffffffffffffffffULL)
+	{
+	    save_256_unaligned ((__m256i *)dst, ymm_def);
+	}
+	else if (m)
+	{
+	    unpack_256_2x256 (load_256_unaligned ((__m256i *)dst),
+			      &dst_lo, &dst_hi);
+	    expand_a8_2x256 (mask, &mask_lo, &mask_hi);
+
+	    in_over_2x256 (&ymm_src, &ymm_src,
+			   &ymm_alpha, &ymm_alpha,
+			   &mask_lo, &mask_hi,
+			   &dst_lo, &dst_hi);
+
+	    save_256_unaligned (
+		(__m256i *)dst, pack_2x256_256 (dst_lo, dst_hi));
+	}
+
+	w -= 8;
+	dst += 8;
+	mask += 8;
+    }
+
+    if (w)
+    {
+	uint8_t tail[8] = { 0 };
+
+	memcpy (tail, mask, w);
+	memcpy (&m, tail, sizeof (uint64_t));
+
+	if (m)
+	{
+	    __m256i lanes = tail_lanes_256 (w);
+
+	    unpack_256_2x256 (_mm256_maskload_epi32 ((int *)dst, lanes),
+			      &dst_lo, &dst_hi);
+	    expand_a8_2x256 (tail, &mask_lo, &mask_hi);
+
+	    in_over_2x256 (&ymm_src, &ymm_src,
+			   &ymm_alpha, &ymm_alpha,
+			   &mask_lo, &mask_hi,
+			   &dst_lo, &dst_hi);
+
+	    _mm256_maskstore_epi32 ((int *)dst, lanes,
+				    pack_2x256_256 (dst_lo, dst_hi));
+	}
+    }
+}
+
+static force_inline void
+avx2_glyph_over_n_8888_ca_line (uint32_t *      dst,
+                                const uint32_t *mask,
+                                int             w,
+                                __m256i         ymm_src,
+                                __m256i         ymm_alpha)
+{
+    __m256i dst_lo, dst_hi, mask_lo, mask_hi, ymm_mask;
+
+    while (w >= 8)
+    {
+	ymm_mask = load_256_unaligned ((const __m256i *)mask);
+
+	if (!is_zero_256 (ymm_mask))
+	{
+	    unpack_256_2x256 (load_256_unaligned ((__m256i *)dst),
+			      &dst_lo, &dst_hi);
+	    unpack_256_2x256 (ymm_mask, &mask_lo, &mask_hi);
+
+	    in_over_2x256 (&ymm_src, &ymm_src,
+			   &ymm_alpha, &ymm_alpha,
+			   &mask_lo, &mask_hi,
+			   &dst_lo, &dst_hi);
+
+	    save_256_unaligned (
+		(__m256i *)dst, pack_2x256_256 (dst_lo, dst_hi));
+	}
+
+	w -= 8;
+	dst += 8;
+	mask += 8;
+    }
+
+    if (w)
+    {
+	__m256i lanes = tail_lanes_256 (w);
+
+	ymm_mask = _mm256_maskload_epi32 ((const int *)mask, lanes);
+
+	if (!is_zero_256 (ymm_mask))
+	{
+	    unpack_256_2x256 (_mm256_maskload_epi32 ((int *)dst, lanes),
+			      &dst_lo, &dst_hi);
+	    unpack_256_2x256 (ymm_mask, &mask_lo, &mask_hi);
+
+	    in_over_2x256 (&ymm_src, &ymm_src,
+			   &ymm_alpha, &ymm_alpha,
+			   &mask_lo, &mask_hi,
+			   &dst_lo, &dst_hi);
+
+	    _mm256_maskstore_epi32 ((int *)dst, lanes,
+				    pack_2x256_256 (dst_lo, dst_hi));
+	}
+    }
+}
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+static pixman_bool_t
+avx2_glyphs (pixman_implementation_t  *imp,
+             pixman_op_t               op,
+             uint32_t                  src,
+             int                       dest_stride,
+             const pixman_glyph_box_t *boxes,
+             int                       n_boxes)
+{
+    __m256i ymm_src, ymm_alpha, ymm_def;
+    uint32_t srca = src >> 24;
+    int i, h;
+
+    if (op != PIXMAN_OP_OVER)
+	return FALSE;
+
+    if (src == 0)
+	return TRUE;
+
+    ymm_def = _mm256_set1_epi32 (src);
+    ymm_src = _mm256_broadcastq_epi64 (unpack_32_1x128 (src));
+    ymm_alpha = _mm256_broadcastq_epi64 (
+	expand_alpha_1x128 (unpack_32_1x128 (src)));
+
+    for (i = 0; i < n_boxes; ++i)
+    {
+	const pixman_glyph_box_t *box = &boxes[i];
+	const uint8_t *mask_line = box->mask;
+	uint32_t *dst_line = box->dest;
+
+	for (h = box->height; h--; )
+	{
+	    if (box->component_alpha)
+	    {
+		avx2_glyph_over_n_8888_ca_line (
+		    dst_line, (const uint32_t *)mask_line, box->width,
+		    ymm_src, ymm_alpha);
+	    }
+	    else
+	    {
+		avx2_glyph_over_n_8_line (dst_line, mask_line, box->width,
+					  srca, ymm_src, ymm_alpha, ymm_def);
+	    }
+
+	    mask_line += box->mask_stride;
+	    dst_line += dest_stride;
+	}
+    }
+
+    return TRUE;
+}
+
+/*
+ * Bilinear scaling
+ *
+ * BILINEAR_INTERPOLATE_ONE_PIXEL is the SSE2 code, used for scanline
+ * heads and tails. BILINEAR_INTERPOLATE_FOUR_PIXELS fetches the 2x2
+ * blocks of four consecutive destination pixels into one register pair
+ * (pixels 0 and 2 in the low halves of the lanes, 1 and 3 in the high
+ * halves) and interpolates them with the same arithmetic. The four pixel
+ * variant keeps its own copy of the horizontal positions, so
+ * BILINEAR_START_FOUR_PIXELS must be used to resynchronize it after any
+ * single pixel steps.
+ */
+
+#define BMSK ((1 << BILINEAR_INTERPOLATION_BITS) - 1)
+
+#define BILINEAR_DECLARE_VARIABLES						\
+    const __m256i ymm_wt = _mm256_set1_epi16 (wt);				\
+    const __m256i ymm_wb = _mm256_set1_epi16 (wb);				\
+    const __m256i ymm_xorc8 = _mm256_set_epi16 (0, 0, 0, 0, BMSK, BMSK, BMSK, BMSK,\
+						0, 0, 0, 0, BMSK, BMSK, BMSK, BMSK);\
+    const __m256i ymm_addc8 = _mm256_set_epi16 (0, 0, 0, 0, 1, 1, 1, 1,	\
+						0, 0, 0, 0, 1, 1, 1, 1);	\
+    const __m256i ymm_xorc7 = _mm256_set_epi16 (0, BMSK, 0, BMSK, 0, BMSK, 0, BMSK,\
+						0, BMSK, 0, BMSK, 0, BMSK, 0, BMSK);\
+    const __m256i ymm_addc7 = _mm256_set_epi16 (0, 1, 0, 1, 0, 1, 0, 1,	\
+						0, 1, 0, 1, 0, 1, 0, 1);	\
+    const __m256i ymm_ux4 = _mm256_set1_epi16 ((int16_t)(unit_x * 4));	\
+    const __m256i ymm_zero = _mm256_setzero_si256 ();				\
+    __m256i ymm_x02 = ymm_zero;							\
+    __m256i ymm_x13 = ymm_zero
+
+#define BILINEAR_INTERPOLATE_ONE_PIXEL(pix)					\
+do {										\
+    __m128i xmm_wh, xmm_lo, xmm_hi, xmm_x, a;					\
+    /* fetch 2x2 pixel block into sse2 registers */				\
+    __m128i tltr = _mm_loadl_epi64 (						\
+			    (__m128i *)&src_top[pixman_fixed_to_int (vx)]);	\
+    __m128i blbr = _mm_loadl_epi64 (						\
+			    (__m128i *)&src_bottom[pixman_fixed_to_int (vx)]);	\
+    xmm_x = _mm_set1_epi16 ((int16_t)vx);					\
+    vx += unit_x;								\
+    /* vertical interpolation */						\
+    a = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (tltr,		\
+				_mm_setzero_si128 ()),				\
+					_mm256_castsi256_si128 (ymm_wt)),	\
+		       _mm_mullo_epi16 (_mm_unpacklo_epi8 (blbr,		\
+				_mm_setzero_si128 ()),				\
+					_mm256_castsi256_si128 (ymm_wb)));	\
+    if (BILINEAR_INTERPOLATION_BITS < 8)					\
+    {										\
+	/* calculate horizontal weights */					\
+	xmm_wh = _mm_add_epi16 (_mm256_castsi256_si128 (ymm_addc7),		\
+		    _mm_xor_si128 (_mm256_castsi256_si128 (ymm_xorc7),		\
+		   _mm_srli_epi16 (xmm_x, 16 - BILINEAR_INTERPOLATION_BITS)));	\
+	/* horizontal interpolation */						\
+	a = _mm_madd_epi16 (_mm_unpackhi_epi16 (_mm_shuffle_epi32 (		\
+		a, _MM_SHUFFLE (1, 0, 3, 2)), a), xmm_wh);			\
+    }										\
+    else									\
+    {										\
+	/* calculate horizontal weights */					\
+	xmm_wh = _mm_add_epi16 (_mm256_castsi256_si128 (ymm_addc8),		\
+		    _mm_xor_si128 (_mm256_castsi256_si128 (ymm_xorc8),		\
+		_mm_srli_epi16 (xmm_x, 16 - BILINEAR_INTERPOLATION_BITS)));	\
+	/* horizontal interpolation */						\
+	xmm_lo = _mm_mullo_epi16 (a, xmm_wh);					\
+	xmm_hi = _mm_mulhi_epu16 (a, xmm_wh);					\
+	a = _mm_add_epi32 (_mm_unpacklo_epi16 (xmm_lo, xmm_hi),			\
+			   _mm_unpackhi_epi16 (xmm_lo, xmm_hi));		\
+    }										\
+    /* shift and pack the result */						\
+    a = _mm_srli_epi32 (a, BILINEAR_INTERPOLATION_BITS * 2);			\
+    a = _mm_packs_epi32 (a, a);							\
+    a = _mm_packus_epi16 (a, a);						\
+    pix = _mm_cvtsi128_si32 (a);						\
+} while (0)
+
+#define BILINEAR_START_FOUR_PIXELS()						\
+do {										\
+    uint32_t x0 = vx;								\
+    uint32_t ux = unit_x;							\
+    ymm_x02 = _mm256_inserti128_si256 (_mm256_castsi128_si256 (		\
+		  _mm_set1_epi16 ((int16_t)(x0 + 0 * ux))),			\
+		  _mm_set1_epi16 ((int16_t)(x0 + 2 * ux)), 1);			\
+    ymm_x13 = _mm256_inserti128_si256 (_mm256_castsi128_si256 (		\
+		  _mm_set1_epi16 ((int16_t)(x0 + 1 * ux))),			\
+		  _mm_set1_epi16 ((int16_t)(x0 + 3 * ux)), 1);			\
+} while (0)
+
+#define BILINEAR_LOAD_FOUR_PIXELS(line, x0, x1, x2, x3)			\
+    _mm256_inserti128_si256 (_mm256_castsi128_si256 (				\
+	_mm_unpacklo_epi64 (_mm_loadl_epi64 ((__m128i *)&line[x0]),		\
+			    _mm_loadl_epi64 ((__m128i *)&line[x1]))),		\
+	_mm_unpacklo_epi64 (_mm_loadl_epi64 ((__m128i *)&line[x2]),		\
+			    _mm_loadl_epi64 ((__m128i *)&line[x3])), 1)
+
+#define BILINEAR_INTERPOLATE_FOUR_PIXELS(pix)					\
+do {										\
+    __m256i tltr, blbr, a02, a13, wh02, wh13, lo, hi;				\
+    int x0, x1, x2, x3;								\
+    x0 = pixman_fixed_to_int (vx);						\
+    vx += unit_x;								\
+    x1 = pixman_fixed_to_int (vx);						\
+    vx += unit_x;								\
+    x2 = pixman_fixed_to_int (vx);						\
+    vx += unit_x;								\
+    x3 = pixman_fixed_to_int (vx);						\
+    vx += unit_x;								\
+    /* fetch 2x2 pixel blocks into avx2 registers */				\
+    tltr = BILINEAR_LOAD_FOUR_PIXELS (src_top, x0, x1, x2, x3);		\
+    blbr = BILINEAR_LOAD_FOUR_PIXELS (src_bottom, x0, x1, x2, x3);		\
+    /* vertical interpolation */						\
+    a02 = _mm256_add_epi16 (							\
+	_mm256_mullo_epi16 (_mm256_unpacklo_epi8 (tltr, ymm_zero), ymm_wt),	\
+	_mm256_mullo_epi16 (_mm256_unpacklo_epi8 (blbr, ymm_zero), ymm_wb));	\
+    a13 = _mm256_add_epi16 (							\
+	_mm256_mullo_epi16 (_mm256_unpackhi_epi8 (tltr, ymm_zero), ymm_wt),	\
+	_mm256_mullo_epi16 (_mm256_unpackhi_epi8 (blbr, ymm_zero), ymm_wb));	\
+    if (BILINEAR_INTERPOLATION_BITS < 8)					\
+    {										\
+	/* calculate horizontal weights */					\
+	wh02 = _mm256_add_epi16 (ymm_addc7, _mm256_xor_si256 (ymm_xorc7,	\
+		_mm256_srli_epi16 (ymm_x02, 16 - BILINEAR_INTERPOLATION_BITS)));\
+	wh13 = _mm256_add_epi16 (ymm_addc7, _mm256_xor_si256 (ymm_xorc7,	\
+		_mm256_srli_epi16 (ymm_x13, 16 - BILINEAR_INTERPOLATION_BITS)));\
+	/* horizontal interpolation */						\
+	a02 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (_mm256_shuffle_epi32 (	\
+		a02, _MM_SHUFFLE (1, 0, 3, 2)), a02), wh02);			\
+	a13 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (_mm256_shuffle_epi32 (	\
+		a13, _MM_SHUFFLE (1, 0, 3, 2)), a13), wh13);			\
+    }										\
+    else									\
+    {										\
+	/* calculate horizontal weights */					\
+	wh02 = _mm256_add_epi16 (ymm_addc8, _mm256_xor_si256 (ymm_xorc8,	\
+		_mm256_srli_epi16 (ymm_x02, 16 - BILINEAR_INTERPOLATION_BITS)));\
+	wh13 = _mm256_add_epi16 (ymm_addc8, _mm256_xor_si256 (ymm_xorc8,	\
+		_mm256_srli_epi16 (ymm_x13, 16 - BILINEAR_INTERPOLATION_BITS)));\
+	/* horizontal interpolation */						\
+	lo = _mm256_mullo_epi16 (a02, wh02);					\
+	hi = _mm256_mulhi_epu16 (a02, wh02);					\
+	a02 = _mm256_add_epi32 (_mm256_unpacklo_epi16 (lo, hi),			\
+				_mm256_unpackhi_epi16 (lo, hi));		\
+	lo = _mm256_mullo_epi16 (a13, wh13);					\
+	hi = _mm256_mulhi_epu16 (a13, wh13);					\
+	a13 = _mm256_add_epi32 (_mm256_unpacklo_epi16 (lo, hi),			\
+				_mm256_unpackhi_epi16 (lo, hi));		\
+    }										\
+    ymm_x02 = _mm256_add_epi16 (ymm_x02, ymm_ux4);				\
+    ymm_x13 = _mm256_add_epi16 (ymm_x13, ymm_ux4);				\
+    /* shift and pack the result; the lanes now hold pixels 0 1 0 1 and	\
+     * 2 3 2 3, so gather the low quadwords of each lane			\
+     */										\
+    a02 = _mm256_srli_epi32 (a02, BILINEAR_INTERPOLATION_BITS * 2);		\
+    a13 = _mm256_srli_epi32 (a13, BILINEAR_INTERPOLATION_BITS * 2);		\
+    a02 = _mm256_packs_epi32 (a02, a13);					\
+    a02 = _mm256_packus_epi16 (a02, a02);					\
+    pix = _mm256_castsi256_si128 (						\
+	_mm256_permute4x64_epi64 (a02, _MM_SHUFFLE (3, 1, 2, 0)));		\
+} while (0)
+
+static force_inline void
+scaled_bilinear_scanline_avx2_8888_8888_SRC (uint32_t *       dst,
+					     const uint32_t * mask,
+					     const uint32_t * src_top,
+					     const uint32_t * src_bottom,
+					     int32_t          w,
+					     int              wt,
+					     int              wb,
+					     pixman_fixed_t   vx,
+					     pixman_fixed_t   unit_x,
+					     pixman_fixed_t   max_vx,
+					     pixman_bool_t    zero_src)
+{
+    BILINEAR_DECLARE_VARIABLES;
+    __m128i pix1, pix2;
+    uint32_t pix;
+
+    BILINEAR_START_FOUR_PIXELS ();
+
+    while (w >= 8)
+    {
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (pix1);
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (pix2);
+
+	_mm_storeu_si128 ((__m128i *)dst + 0, pix1);
+	_mm_storeu_si128 ((__m128i *)dst + 1, pix2);
+
+	dst += 8;
+	w -= 8;
+    }
+
+    if (w >= 4)
+    {
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (pix1);
+
+	_mm_storeu_si128 ((__m128i *)dst, pix1);
+
+	dst += 4;
+	w -= 4;
+    }
+
+    while (w)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix);
+	*dst++ = pix;
+	w--;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_cover_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_pad_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_none_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_normal_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+static force_inline void
+scaled_bilinear_scanline_avx2_8888_8888_OVER (uint32_t *       dst,
+					      const uint32_t * mask,
+					      const uint32_t * src_top,
+					      const uint32_t * src_bottom,
+					      int32_t          w,
+					      int              wt,
+					      int              wb,
+					      pixman_fixed_t   vx,
+					      pixman_fixed_t   unit_x,
+					      pixman_fixed_t   max_vx,
+					      pixman_bool_t    zero_src)
+{
+    BILINEAR_DECLARE_VARIABLES;
+    __m128i pix1, pix2;
+    uint32_t pix, d;
+
+    while (w && ((uintptr_t)dst & 31))
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix);
+
+	if (pix)
+	{
+	    d = *dst;
+	    *dst = core_combine_over_u_pixel_avx2 (pix, d);
+	}
+
+	w--;
+	dst++;
+    }
+
+    BILINEAR_START_FOUR_PIXELS ();
+
+    while (w >= 8)
+    {
+	__m256i ymm_src;
+
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (pix1);
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (pix2);
+
+	ymm_src = _mm256_inserti128_si256 (_mm256_castsi128_si256 (pix1),
+					   pix2, 1);
+
+	if (!is_zero_256 (ymm_src))
+	{
+	    if (is_opaque_256 (ymm_src))
+	    {
+		save_256_aligned ((__m256i *)dst, ymm_src);
+	    }
+	    else
+	    {
+		__m256i src_lo, src_hi, dst_lo, dst_hi;
+		__m256i alpha_lo, alpha_hi;
+
+		unpack_256_2x256 (ymm_src, &src_lo, &src_hi);
+		unpack_256_2x256 (load_256_aligned ((__m256i *)dst),
+				  &dst_lo, &dst_hi);
+
+		expand_alpha_2x256 (src_lo, src_hi, &alpha_lo, &alpha_hi);
+		over_2x256 (&src_lo, &src_hi, &alpha_lo, &alpha_hi,
+			    &dst_lo, &dst_hi);
+
+		save_256_aligned ((__m256i *)dst,
+				  pack_2x256_256 (dst_lo, dst_hi));
+	    }
+	}
+
+	w -= 8;
+	dst += 8;
+    }
+
+    while (w)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix);
+
+	if (pix)
+	{
+	    d = *dst;
+	    *dst = core_combine_over_u_pixel_avx2 (pix, d);
+	}
+
+	w--;
+	dst++;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_cover_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_pad_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_none_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_normal_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+/* The half float format, converted with F16C. Pixels are r, g, b, a in
+ * memory, and the conversions give exactly what the C ones in
+ * pixman-private.h give.
+ */
+static force_inline __m256i
+float_to_unorm8_1x256 (__m256 f)
+{
+    __m256i u;
+
+    f = _mm256_max_ps (f, _mm256_setzero_ps ());
+    f = _mm256_min_ps (f, _mm256_set1_ps (1.f));
+    u = _mm256_cvttps_epi32 (_mm256_mul_ps (f, _mm256_set1_ps (256.f)));
+
+    return _mm256_sub_epi32 (u, _mm256_srli_epi32 (u, 8));
+}
+
+static void
+convert_f16161616_to_8888_avx2 (uint32_t *dst, const uint32_t *src, int w)
+{
+    while (w >= 4)
+    {
+	__m256 lo = _mm256_cvtph_ps (_mm_loadu_si128 ((__m128i *)src + 0));
+	__m256 hi = _mm256_cvtph_ps (_mm_loadu_si128 ((__m128i *)src + 1));
+	__m256i d;
+
+	/* Pixels 0, 2 in the low lane and 1, 3 in the high one */
+	d = _mm256_packs_epi32 (float_to_unorm8_1x256 (lo),
+				float_to_unorm8_1x256 (hi));
+
+	/* r, g, b, a to b, g, r, a */
+	d = _mm256_shufflehi_epi16 (
+	    _mm256_shufflelo_epi16 (d, _MM_SHUFFLE (3, 0, 1, 2)),
+	    _MM_SHUFFLE (3, 0, 1, 2));
+	d = _mm256_permute4x64_epi64 (d, _MM_SHUFFLE (3, 1, 2, 0));
+
+	_mm_storeu_si128 ((__m128i *)dst,
+			  _mm_packus_epi16 (_mm256_castsi256_si128 (d),
+					    _mm256_extracti128_si256 (d, 1)));
+
+	src += 8;
+	dst += 4;
+	w -= 4;
+    }
+
+    while (w--)
+    {
+	*dst++ = convert_f16161616_to_8888 (((uint64_t)src[1] << 32) | src[0]);
+	src += 2;
+    }
+}
+
+static void
+convert_8888_to_f16161616_avx2 (uint32_t       *dst,
+				const uint32_t *src,
+				uint32_t        alpha,
+				int             w)
+{
+    /* b, g, r, a to r, g, b, a */
+    __m128i swap = _mm_setr_epi8 (2, 1, 0, 3, 6, 5, 4, 7,
+				  10, 9, 8, 11, 14, 13, 12, 15);
+    __m128i xmm_alpha = _mm_set1_epi32 (alpha);
+    __m256 scale = _mm256_set1_ps (1.f / 255.f);
+
+    while (w >= 4)
+    {
+	__m128i s = _mm_shuffle_epi8 (
+	    _mm_or_si128 (_mm_loadu_si128 ((__m128i *)src), xmm_alpha), swap);
+	__m256 lo, hi;
+
+	lo = _mm256_mul_ps (
+	    _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (s)), scale);
+	hi = _mm256_mul_ps (
+	    _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (_mm_srli_si128 (s, 8))),
+	    scale);
+
+	_mm_storeu_si128 ((__m128i *)dst + 0,
+			  _mm256_cvtps_ph (lo, _MM_FROUND_TO_NEAREST_INT));
+	_mm_storeu_si128 ((__m128i *)dst + 1,
+			  _mm256_cvtps_ph (hi, _MM_FROUND_TO_NEAREST_INT));
+
+	src += 4;
+	dst += 8;
+	w -= 4;
+    }
+
+    while (w--)
+    {
+	uint64_t p = convert_8888_to_f16161616 (*src++ | alpha);
+
+	dst[0] = p;
+	dst[1] = p >> 32;
+	dst += 2;
+    }
+}
+
+static void
+avx2_composite_src_f16161616_8888 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 2);
+
+    while (height--)
+    {
+	convert_f16161616_to_8888_avx2 (dst_line, src_line, width);
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+static void
+avx2_composite_over_f16161616_8888 (pixman_implementation_t *imp,
+				    pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    uint32_t    buffer[64];
+    int dst_stride, src_stride;
+    int32_t w, n;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 2);
+
+    while (height--)
+    {
+	for (w = 0; w < width; w += n)
+	{
+	    n = MIN (width - w, 64);
+
+	    convert_f16161616_to_8888_avx2 (buffer, src_line + 2 * w, n);
+	    core_combine_over_u_avx2 (dst_line + w, buffer, NULL, n);
+	}
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+static void
+avx2_composite_src_8888_f16161616 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    uint32_t    alpha = 0;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 2);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    if (PIXMAN_FORMAT_A (src_image->bits.format) == 0)
+	alpha = 0xff000000;
+
+    while (height--)
+    {
+	convert_8888_to_f16161616_avx2 (dst_line, src_line, alpha, width);
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+/* Converts sixteen pixels of BT.601 YUV to x8r8g8b8, with the same
+ * arithmetic as convert_yuv_to_8888 () and the SSE2 version: y holds
+ * sixteen luma samples and uv eight interleaved U, V pairs.
+ */
+static force_inline void
+yuv_to_8888_avx2 (uint32_t *dst, __m128i y8, __m128i uv8)
+{
+    /* Pairs of 16 bit remainders, for (Y, V) and (Y, U) */
+    __m256i c_r = _mm256_set1_epi32 (0x9a2e2b27);
+    __m256i c_gv = _mm256_set1_epi32 (0x2f0e2b27);
+    __m256i c_gu = _mm256_set1_epi32 (0x9b820000);
+    __m256i c_b = _mm256_set1_epi32 (0x06a22b27);
+    __m256i y, uv, u, v, yv_lo, yv_hi, yu_lo, yu_hi, r, g, b, br, ga, bg, ra;
+    __m256i lo, hi;
+
+    y = _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (y8), _mm256_set1_epi16 (16));
+
+    /* Each U, V pair is shared by two pixels */
+    uv = _mm256_inserti128_si256 (
+	_mm256_castsi128_si256 (_mm_unpacklo_epi16 (uv8, uv8)),
+	_mm_unpackhi_epi16 (uv8, uv8), 1);
+    u = _mm256_sub_epi16 (_mm256_and_si256 (uv, _mm256_set1_epi16 (0x00ff)),
+			  _mm256_set1_epi16 (128));
+    v = _mm256_sub_epi16 (_mm256_srli_epi16 (uv, 8), _mm256_set1_epi16 (128));
+
+    yv_lo = _mm256_unpacklo_epi16 (y, v);
+    yv_hi = _mm256_unpackhi_epi16 (y, v);
+    yu_lo = _mm256_unpacklo_epi16 (y, u);
+    yu_hi = _mm256_unpackhi_epi16 (y, u);
+
+    r = _mm256_packs_epi32 (
+	_mm256_srai_epi32 (_mm256_madd_epi16 (yv_lo, c_r), 16),
+	_mm256_srai_epi32 (_mm256_madd_epi16 (yv_hi, c_r), 16));
+    g = _mm256_packs_epi32 (
+	_mm256_srai_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (yv_lo, c_gv),
+					     _mm256_madd_epi16 (yu_lo, c_gu)), 16),
+	_mm256_srai_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (yv_hi, c_gv),
+					     _mm256_madd_epi16 (yu_hi, c_gu)), 16));
+    b = _mm256_packs_epi32 (
+	_mm256_srai_epi32 (_mm256_madd_epi16 (yu_lo, c_b), 16),
+	_mm256_srai_epi32 (_mm256_madd_epi16 (yu_hi, c_b), 16));
+
+    r = _mm256_add_epi16 (r, _mm256_add_epi16 (y, _mm256_add_epi16 (v, v)));
+    g = _mm256_add_epi16 (g, _mm256_sub_epi16 (y, v));
+    b = _mm256_add_epi16 (b, _mm256_add_epi16 (y, _mm256_add_epi16 (u, u)));
+
+    br = _mm256_packus_epi16 (b, r);
+    ga = _mm256_packus_epi16 (g, _mm256_set1_epi16 (0xff));
+    bg = _mm256_unpacklo_epi8 (br, ga);
+    ra = _mm256_unpackhi_epi8 (br, ga);
+
+    /* Pixels 0-3 and 8-11, and 4-7 and 12-15 */
+    lo = _mm256_unpacklo_epi16 (bg, ra);
+    hi = _mm256_unpackhi_epi16 (bg, ra);
+
+    _mm256_storeu_si256 ((__m256i *)(dst + 0), _mm256_permute2x128_si256 (lo, hi, 0x20));
+    _mm256_storeu_si256 ((__m256i *)(dst + 8), _mm256_permute2x128_si256 (lo, hi, 0x31));
+}
+
+static force_inline void
+fetch_yuv_row_avx2 (uint32_t *           dst,
+		    bits_image_t *       image,
+		    pixman_format_code_t format,
+		    int                  x,
+		    int                  line,
+		    int                  width)
+{
+    const uint8_t *y_line, *u_line, *v_line;
+
+    yuv_get_lines (image, line, &y_line, &u_line, &v_line);
+
+    /* Pixels with even x start a chroma pair */
+    if (width && (x & 1))
+    {
+	*dst++ = yuv_fetch_pixel (format, y_line, u_line, v_line, x++);
+	width--;
+    }
+
+    while (width >= 16)
+    {
+	__m128i y, uv;
+
+	if (format == PIXMAN_yuy2)
+	{
+	    __m128i p0 = _mm_loadu_si128 ((__m128i *)(y_line + x * 2));
+	    __m128i p1 = _mm_loadu_si128 ((__m128i *)(y_line + x * 2 + 16));
+	    __m128i ff = _mm_set1_epi16 (0x00ff);
+
+	    y = _mm_packus_epi16 (_mm_and_si128 (p0, ff), _mm_and_si128 (p1, ff));
+	    uv = _mm_packus_epi16 (_mm_srli_epi16 (p0, 8), _mm_srli_epi16 (p1, 8));
+	}
+	else if (format == PIXMAN_nv12)
+	{
+	    y = _mm_loadu_si128 ((__m128i *)(y_line + x));
+	    uv = _mm_loadu_si128 ((__m128i *)(u_line + x));
+	}
+	else
+	{
+	    y = _mm_loadu_si128 ((__m128i *)(y_line + x));
+	    uv = _mm_unpacklo_epi8 (
+		_mm_loadl_epi64 ((__m128i *)(u_line + (x >> 1))),
+		_mm_loadl_epi64 ((__m128i *)(v_line + (x >> 1))));
+	}
+
+	yuv_to_8888_avx2 (dst, y, uv);
+
+	dst += 16;
+	x += 16;
+	width -= 16;
+    }
+
+    while (width--)
+	*dst++ = yuv_fetch_pixel (format, y_line, u_line, v_line, x++);
+}
+
+static void
+avx2_fetch_yuv_row (uint32_t *     dst,
+		    bits_image_t * image,
+		    int            x,
+		    int            line,
+		    int            width)
+{
+    switch (image->format)
+    {
+    case PIXMAN_yuy2:
+	fetch_yuv_row_avx2 (dst, image, PIXMAN_yuy2, x, line, width);
+	break;
+
+    case PIXMAN_nv12:
+	fetch_yuv_row_avx2 (dst, image, PIXMAN_nv12, x, line, width);
+	break;
+
+    default:
+	fetch_yuv_row_avx2 (dst, image, PIXMAN_yv12, x, line, width);
+	break;
+    }
+}
+
+FAST_YUV (avx2_yuv_8888, avx2_fetch_yuv_row,
+	  scaled_bilinear_scanline_avx2_8888_8888_SRC)
+
+static const pixman_fast_path_t avx2_fast_paths[] =
+{
+    /* PIXMAN_OP_OVER */
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, a8r8g8b8, avx2_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, x8r8g8b8, avx2_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, a8b8g8r8, avx2_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, x8b8g8r8, avx2_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, a8r8g8b8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, x8r8g8b8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, a8b8g8r8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, x8b8g8r8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8r8g8b8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8r8g8b8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8b8g8r8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8b8g8r8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, solid, a8r8g8b8, avx2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, solid, x8r8g8b8, avx2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, solid, a8b8g8r8, avx2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, solid, x8b8g8r8, avx2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, null, x8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, null, x8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16_float, a8r8g8b8, avx2_composite_over_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16_float, x8r8g8b8, avx2_composite_over_f16161616_8888),
+
+    /* PIXMAN_OP_ADD */
+    PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, avx2_composite_add_8_8),
+    PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, avx2_composite_add_8888_8888),
+    PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, avx2_composite_add_8888_8888),
+
+    /* PIXMAN_OP_SRC */
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, a8r8g8b8, avx2_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, a8b8g8r8, avx2_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, a8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, a8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, x8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, x8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, x8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, x8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, r5g6b5, null, r5g6b5, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, b5g6r5, null, b5g6r5, avx2_composite_copy_area),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16_float, a8r8g8b8, avx2_composite_src_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16_float, x8r8g8b8, avx2_composite_src_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, a16b16g16r16_float, avx2_composite_src_8888_f16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, a16b16g16r16_float, avx2_composite_src_8888_f16161616),
+
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, avx2_8888_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, avx2_8888_8888),
+
+    YUV_FAST_PATHS (x8r8g8b8, avx2_yuv_8888),
+    YUV_FAST_PATHS (a8r8g8b8, avx2_yuv_8888),
+
+    { PIXMAN_OP_NONE },
+};
+
+/*
+ * Iterators
+ */
+
+static uint32_t *
+avx2_fetch_x8r8g8b8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    int w = iter->width;
+    uint32_t *dst = iter->buffer;
+    uint32_t *src = (uint32_t *)iter->bits;
+
+    iter->bits += iter->stride;
+
+    while (w && ((uintptr_t)dst) & 31)
+    {
+	*dst++ = (*src++) | 0xff000000;
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	save_256_aligned (
+	    (__m256i *)dst, _mm256_or_si256 (
+		load_256_unaligned ((__m256i *)src), mask_ff000000));
+
+	dst += 8;
+	src += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	*dst++ = (*src++) | 0xff000000;
+	w--;
+    }
+
+    return iter->buffer;
+}
+
+static uint32_t *
+avx2_fetch_r5g6b5 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    int w = iter->width;
+    uint32_t *dst = iter->buffer;
+    uint16_t *src = (uint16_t *)iter->bits;
+
+    iter->bits += iter->stride;
+
+    while (w && ((uintptr_t)dst) & 31)
+    {
+	uint16_t s = *src++;
+
+	*dst++ = convert_0565_to_8888 (s);
+	w--;
+    }
+
+    while (w >= 16)
+    {
+	__m256i lo, hi;
+	__m256i s = load_256_unaligned ((__m256i *)src);
+
+	lo = _mm256_cvtepu16_epi32 (_mm256_castsi256_si128 (s));
+	hi = _mm256_cvtepu16_epi32 (_mm256_extracti128_si256 (s, 1));
+
+	lo = unpack_565_to_8888 (lo);
+	hi = unpack_565_to_8888 (hi);
+
+	save_256_aligned ((__m256i *)(dst + 0), _mm256_or_si256 (lo, mask_ff000000));
+	save_256_aligned ((__m256i *)(dst + 8), _mm256_or_si256 (hi, mask_ff000000));
+
+	dst += 16;
+	src += 16;
+	w -= 16;
+    }
+
+    while (w)
+    {
+	uint16_t s = *src++;
+
+	*dst++ = convert_0565_to_8888 (s);
+	w--;
+    }
+
+    return iter->buffer;
+}
+
+static uint32_t *
+avx2_fetch_a8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    int w = iter->width;
+    uint32_t *dst = iter->buffer;
+    uint8_t *src = iter->bits;
+
+    iter->bits += iter->stride;
+
+    while (w && (((uintptr_t)dst) & 31))
+    {
+        *dst++ = *(src++) << 24;
+        w--;
+    }
+
+    while (w >= 16)
+    {
+	__m128i s = _mm_loadu_si128 ((__m128i *)src);
+	__m256i lo, hi;
+
+	lo = _mm256_slli_epi32 (_mm256_cvtepu8_epi32 (s), 24);
+	hi = _mm256_slli_epi32 (
+	    _mm256_cvtepu8_epi32 (_mm_unpackhi_epi64 (s, s)), 24);
+
+	save_256_aligned ((__m256i *)(dst + 0), lo);
+	save_256_aligned ((__m256i *)(dst + 8), hi);
+
+	dst += 16;
+	src += 16;
+	w -= 16;
+    }
+
+    while (w)
+    {
+	*dst++ = *(src++) << 24;
+	w--;
+    }
+
+    return iter->buffer;
+}
+
+static void
+fetch_f16161616_float_avx2 (argb_t *dst, const uint32_t *src, int w)
+{
+    while (w >= 2)
+    {
+	__m256 f = _mm256_cvtph_ps (_mm_loadu_si128 ((__m128i *)src));
+
+	/* r, g, b, a to a, r, g, b */
+	_mm256_storeu_ps ((float *)dst,
+			  _mm256_permute_ps (f, _MM_SHUFFLE (2, 1, 0, 3)));
+
+	src += 4;
+	dst += 2;
+	w -= 2;
+    }
+
+    if (w)
+    {
+	dst->a = half_to_float (src[1] >> 16);
+	dst->r = half_to_float (src[0]);
+	dst->g = half_to_float (src[0] >> 16);
+	dst->b = half_to_float (src[1]);
+    }
+}
+
+static void
+store_f16161616_float_avx2 (uint32_t *dst, const argb_t *src, int w)
+{
+    while (w >= 2)
+    {
+	__m256 f = _mm256_loadu_ps ((float *)src);
+
+	/* a, r, g, b to r, g, b, a */
+	f = _mm256_permute_ps (f, _MM_SHUFFLE (0, 3, 2, 1));
+	_mm_storeu_si128 ((__m128i *)dst,
+			  _mm256_cvtps_ph (f, _MM_FROUND_TO_NEAREST_INT));
+
+	src += 2;
+	dst += 4;
+	w -= 2;
+    }
+
+    if (w)
+    {
+	dst[0] = float_to_half (src->r) | (float_to_half (src->g) << 16);
+	dst[1] = float_to_half (src->b) | (float_to_half (src->a) << 16);
+    }
+}
+
+static uint32_t *
+avx2_fetch_a16b16g16r16_float_float (pixman_iter_t *iter, const uint32_t *mask)
+{
+    fetch_f16161616_float_avx2 (
+	(argb_t *)iter->buffer, (uint32_t *)iter->bits, iter->width);
+
+    iter->bits += iter->stride;
+
+    return iter->buffer;
+}
+
+static uint32_t *
+avx2_fetch_yuv (pixman_iter_t *iter, const uint32_t *mask)
+{
+    avx2_fetch_yuv_row (iter->buffer, &iter->image->bits,
+			iter->x, iter->y++, iter->width);
+
+    return iter->buffer;
+}
+
+static uint32_t *
+avx2_dest_get_a16b16g16r16_float_float (pixman_iter_t *iter, const uint32_t *mask)
+{
+    fetch_f16161616_float_avx2 (
+	(argb_t *)iter->buffer, (uint32_t *)iter->bits, iter->width);
+
+    return iter->buffer;
+}
+
+static void
+avx2_write_back_a16b16g16r16_float_float (pixman_iter_t *iter)
+{
+    store_f16161616_float_avx2 (
+	(uint32_t *)iter->bits, (argb_t *)iter->buffer, iter->width);
+
+    iter->bits += iter->stride;
+}
+
+#define IMAGE_FLAGS							\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_ID_TRANSFORM |		\
+     FAST_PATH_BITS_IMAGE | FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
+
+#define WIDE_IMAGE_FLAGS	(IMAGE_FLAGS & ~FAST_PATH_NARROW_FORMAT)
+#define WIDE_DEST_FLAGS		(FAST_PATH_NO_ACCESSORS | FAST_PATH_NO_ALPHA_MAP)
+
+/* The passes of the separable convolution scaler, see pixman-bits-image.c */
+static void
+avx2_convolve_row (int16_t *        dst,
+		   const uint32_t * src,
+		   const int32_t *  offsets,
+		   const int16_t ** weights,
+		   int              n_taps,
+		   int              width)
+{
+    /* Interleaves the channels of pixels 0 and 1, and of 2 and 3 */
+    const __m128i pairs = _mm_setr_epi8 (0, 4, 1, 5, 2, 6, 3, 7,
+					 8, 12, 9, 13, 10, 14, 11, 15);
+    int k, i;
+
+    for (k = 0; k < width; ++k)
+    {
+	const uint32_t *s = src + offsets[k];
+	const int16_t *w = weights[k];
+	__m256i acc = _mm256_setzero_si256 ();
+	__m128i sum;
+
+	for (i = 0; i < n_taps; i += 4)
+	{
+	    __m128i p = _mm_loadu_si128 ((const __m128i *)(s + i));
+	    __m256i q = _mm256_cvtepu8_epi16 (_mm_shuffle_epi8 (p, pairs));
+
+	    acc = _mm256_add_epi32 (
+		acc, _mm256_madd_epi16 (q, _mm256_loadu_si256 ((const __m256i *)w)));
+
+	    w += 16;
+	}
+
+	sum = _mm_add_epi32 (_mm256_castsi256_si128 (acc),
+			     _mm256_extracti128_si256 (acc, 1));
+	sum = _mm_srai_epi32 (_mm_add_epi32 (sum, _mm_set1_epi32 (0x80)), 8);
+
+	_mm_storel_epi64 ((__m128i *)(dst + k * 4), _mm_packs_epi32 (sum, sum));
+    }
+}
+
+static void
+avx2_convolve_column (uint32_t *       dst,
+		      const int16_t ** rows,
+		      const int16_t *  weights,
+		      int              n_taps,
+		      int              width)
+{
+    const __m256i round = _mm256_set1_epi32 (1 << 19);
+    int k = 0, i;
+
+    for (; k + 8 <= width; k += 8)
+    {
+	__m256i s0 = round, s1 = round, s2 = round, s3 = round;
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    __m256i w = _mm256_broadcastsi128_si256 (
+		_mm_loadu_si128 ((const __m128i *)(weights + i * 4)));
+	    const int16_t *a = rows[i] + k * 4;
+	    const int16_t *b = rows[i + 1] + k * 4;
+	    __m256i a0 = _mm256_loadu_si256 ((const __m256i *)(a + 0));
+	    __m256i a1 = _mm256_loadu_si256 ((const __m256i *)(a + 16));
+	    __m256i b0 = _mm256_loadu_si256 ((const __m256i *)(b + 0));
+	    __m256i b1 = _mm256_loadu_si256 ((const __m256i *)(b + 16));
+
+	    /* Pixels 0 and 2, 1 and 3, 4 and 6, 5 and 7 */
+	    s0 = _mm256_add_epi32 (s0, _mm256_madd_epi16 (_mm256_unpacklo_epi16 (a0, b0), w));
+	    s1 = _mm256_add_epi32 (s1, _mm256_madd_epi16 (_mm256_unpackhi_epi16 (a0, b0), w));
+	    s2 = _mm256_add_epi32 (s2, _mm256_madd_epi16 (_mm256_unpacklo_epi16 (a1, b1), w));
+	    s3 = _mm256_add_epi32 (s3, _mm256_madd_epi16 (_mm256_unpackhi_epi16 (a1, b1), w));
+	}
+
+	s0 = _mm256_packs_epi32 (_mm256_srai_epi32 (s0, 20), _mm256_srai_epi32 (s1, 20));
+	s2 = _mm256_packs_epi32 (_mm256_srai_epi32 (s2, 20), _mm256_srai_epi32 (s3, 20));
+
+	/* The lanes hold pixels 0, 1, 4, 5 and 2, 3, 6, 7 */
+	s0 = _mm256_permute4x64_epi64 (_mm256_packus_epi16 (s0, s2),
+				       _MM_SHUFFLE (3, 1, 2, 0));
+
+	_mm256_storeu_si256 ((__m256i *)(dst + k), s0);
+    }
+
+    for (; k < width; ++k)
+    {
+	__m128i s0 = _mm256_castsi256_si128 (round);
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    __m128i w = _mm_loadu_si128 ((const __m128i *)(weights + i * 4));
+	    __m128i a = _mm_loadl_epi64 ((const __m128i *)(rows[i] + k * 4));
+	    __m128i b = _mm_loadl_epi64 ((const __m128i *)(rows[i + 1] + k * 4));
+
+	    s0 = _mm_add_epi32 (s0, _mm_madd_epi16 (_mm_unpacklo_epi16 (a, b), w));
+	}
+
+	s0 = _mm_srai_epi32 (s0, 20);
+	s0 = _mm_packs_epi32 (s0, s0);
+
+	dst[k] = _mm_cvtsi128_si32 (_mm_packus_epi16 (s0, s0));
+    }
+}
+
+static void
+avx2_separable_scaler_init (pixman_iter_t *iter, const pixman_iter_info_t *info)
+{
+    _pixman_separable_scaler_iter_init (
+	iter, avx2_convolve_row, avx2_convolve_column);
+}
+
+/* Radial gradients with a LUT, two groups of four pixels at a time with
+ * exactly the same operations as radial_lut_pixel() in
+ * pixman-radial-gradient.c.
+ */
+static force_inline __m256i
+gradient_lut_8x256 (const uint32_t *lut, pixman_repeat_t repeat, __m256i pos)
+{
+    __m256i one = _mm256_set1_epi32 (0x10000);
+    __m256i outside = _mm256_setzero_si256 ();
+
+    switch (repeat)
+    {
+    case PIXMAN_REPEAT_NORMAL:
+	pos = _mm256_and_si256 (pos, _mm256_set1_epi32 (0xffff));
+	break;
+
+    case PIXMAN_REPEAT_REFLECT:
+	pos = _mm256_and_si256 (pos, _mm256_set1_epi32 (0x1ffff));
+	pos = _mm256_min_epi32 (
+	    pos, _mm256_sub_epi32 (_mm256_slli_epi32 (one, 1), pos));
+	break;
+
+    case PIXMAN_REPEAT_PAD:
+	pos = _mm256_min_epi32 (_mm256_max_epi32 (pos, outside), one);
+	break;
+
+    default:
+	outside = _mm256_or_si256 (_mm256_srai_epi32 (pos, 31),
+				   _mm256_cmpgt_epi32 (pos, one));
+	pos = _mm256_andnot_si256 (outside, pos);
+	break;
+    }
+
+    pos = _mm256_add_epi32 (
+	pos, _mm256_set1_epi32 (1 << (15 - GRADIENT_LUT_BITS)));
+    pos = _mm256_srli_epi32 (pos, 16 - GRADIENT_LUT_BITS);
+
+    return _mm256_andnot_si256 (
+	outside, _mm256_i32gather_epi32 ((const int *)lut, pos, 4));
+}
+
+static force_inline __m256
+radial_is_valid_8x256 (const radial_affine_t *r, pixman_repeat_t repeat,
+		       __m256 t)
+{
+    if (repeat == PIXMAN_REPEAT_NONE)
+    {
+	return _mm256_and_ps (_mm256_cmp_ps (t, _mm256_setzero_ps (), _CMP_GE_OQ),
+			      _mm256_cmp_ps (t, _mm256_set1_ps (1.f), _CMP_LE_OQ));
+    }
+    else
+    {
+	return _mm256_cmp_ps (_mm256_mul_ps (t, _mm256_set1_ps (r->dr)),
+			      _mm256_set1_ps (r->mindr), _CMP_GE_OQ);
+    }
+}
+
+static uint32_t *
+avx2_radial_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const uint32_t *lut = iter->image->gradient.lut;
+    pixman_repeat_t repeat = iter->image->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    __m256 k = _mm256_setr_ps (0, 1, 2, 3, 0, 1, 2, 3);
+    __m256 kk = _mm256_setr_ps (0, 0, 1, 3, 0, 0, 1, 3);
+    radial_affine_t r;
+    int i;
+
+    if (!_pixman_radial_gradient_get_affine (iter->image, iter->x, iter->y, &r))
+	return _pixman_radial_gradient_get_scanline_narrow (iter, mask);
+
+    for (i = 0; i < width; i += 8)
+    {
+	float b0, db0, c0, dc0, ddc0;
+	float b1, db1, c1, dc1, ddc1;
+	__m256 b, c, t, valid;
+	__m256i colors;
+
+	radial_affine_next_group (&r, &b0, &db0, &c0, &dc0, &ddc0);
+	radial_affine_next_group (&r, &b1, &db1, &c1, &dc1, &ddc1);
+
+	b = _mm256_add_ps (
+	    _mm256_setr_ps (b0, b0, b0, b0, b1, b1, b1, b1),
+	    _mm256_mul_ps (
+		k, _mm256_setr_ps (db0, db0, db0, db0, db1, db1, db1, db1)));
+	c = _mm256_add_ps (
+	    _mm256_setr_ps (c0, c0, c0, c0, c1, c1, c1, c1),
+	    _mm256_add_ps (
+		_mm256_mul_ps (
+		    k, _mm256_setr_ps (dc0, dc0, dc0, dc0, dc1, dc1, dc1, dc1)),
+		_mm256_mul_ps (
+		    kk, _mm256_setr_ps (ddc0, ddc0, ddc0, ddc0,
+					ddc1, ddc1, ddc1, ddc1))));
+
+	if (r.a == 0)
+	{
+	    t = _mm256_div_ps (_mm256_mul_ps (_mm256_set1_ps (0.5f), c), b);
+	    valid = _mm256_and_ps (
+		_mm256_cmp_ps (b, _mm256_setzero_ps (), _CMP_NEQ_UQ),
+		radial_is_valid_8x256 (&r, repeat, t));
+	}
+	else
+	{
+	    __m256 discr, sqrtdiscr, t1, valid0, valid1;
+
+	    discr = _mm256_sub_ps (_mm256_mul_ps (b, b),
+				   _mm256_mul_ps (_mm256_set1_ps (r.a), c));
+	    valid = _mm256_cmp_ps (discr, _mm256_setzero_ps (), _CMP_GE_OQ);
+	    sqrtdiscr = _mm256_sqrt_ps (
+		_mm256_max_ps (discr, _mm256_setzero_ps ()));
+
+	    t = _mm256_mul_ps (_mm256_add_ps (b, sqrtdiscr),
+			       _mm256_set1_ps (r.inva));
+	    t1 = _mm256_mul_ps (_mm256_sub_ps (b, sqrtdiscr),
+				_mm256_set1_ps (r.inva));
+
+	    /* The bigger solution if it's valid, otherwise the other one */
+	    valid0 = _mm256_and_ps (valid, radial_is_valid_8x256 (&r, repeat, t));
+	    valid1 = _mm256_and_ps (valid, radial_is_valid_8x256 (&r, repeat, t1));
+	    t = _mm256_blendv_ps (t1, t, valid0);
+	    valid = _mm256_or_ps (valid0, valid1);
+	}
+
+	t = _mm256_min_ps (_mm256_max_ps (t, _mm256_set1_ps (-16384.f)),
+			   _mm256_set1_ps (16384.f));
+	colors = gradient_lut_8x256 (
+	    lut, repeat,
+	    _mm256_cvttps_epi32 (_mm256_mul_ps (t, _mm256_set1_ps (65536.f))));
+	colors = _mm256_and_si256 (colors, _mm256_castps_si256 (valid));
+
+	if (i + 8 <= width)
+	{
+	    _mm256_storeu_si256 ((__m256i *)(buffer + i), colors);
+	}
+	else
+	{
+	    uint32_t last[8];
+
+	    _mm256_storeu_si256 ((__m256i *)last, colors);
+	    memcpy (buffer + i, last, (width - i) * sizeof (uint32_t));
+	}
+    }
+
+    iter->y++;
+
+    return iter->buffer;
+}
+
+static void
+avx2_radial_gradient_iter_init (pixman_iter_t *iter,
+				const pixman_iter_info_t *info)
+{
+    _pixman_radial_gradient_iter_init (iter->image, iter);
+
+    /* Only the colors from the LUT are computed in single precision */
+    if (iter->image->gradient.lut)
+	iter->get_scanline = avx2_radial_get_scanline;
+}
+
+/* Conical gradients with a LUT, two groups of four pixels at a time with
+ * exactly the same operations as conical_lut_pixel() in
+ * pixman-conical-gradient.c.
+ */
+static force_inline __m256
+conical_atan2_8x256 (__m256 y, __m256 x)
+{
+    __m256 sign = _mm256_set1_ps (-0.f);
+    __m256 ax = _mm256_andnot_ps (sign, x);
+    __m256 ay = _mm256_andnot_ps (sign, y);
+    __m256 mx = _mm256_max_ps (ay, ax);
+    __m256 a, s, r;
+
+    a = _mm256_and_ps (_mm256_div_ps (_mm256_min_ps (ay, ax), mx),
+		       _mm256_cmp_ps (mx, _mm256_setzero_ps (), _CMP_NEQ_UQ));
+    s = _mm256_mul_ps (a, a);
+
+    r = _mm256_add_ps (_mm256_set1_ps (CONICAL_ATAN_A7),
+		       _mm256_mul_ps (s, _mm256_set1_ps (CONICAL_ATAN_A9)));
+    r = _mm256_add_ps (_mm256_set1_ps (CONICAL_ATAN_A5), _mm256_mul_ps (s, r));
+    r = _mm256_add_ps (_mm256_set1_ps (CONICAL_ATAN_A3), _mm256_mul_ps (s, r));
+    r = _mm256_add_ps (_mm256_set1_ps (CONICAL_ATAN_A1), _mm256_mul_ps (s, r));
+    r = _mm256_mul_ps (a, r);
+
+    r = _mm256_blendv_ps (r, _mm256_sub_ps (_mm256_set1_ps (0.25f), r),
+			  _mm256_cmp_ps (ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_ps (r, _mm256_sub_ps (_mm256_set1_ps (0.5f), r),
+			  _mm256_cmp_ps (x, _mm256_setzero_ps (), _CMP_LT_OQ));
+
+    return _mm256_xor_ps (
+	r, _mm256_and_ps (_mm256_cmp_ps (y, _mm256_setzero_ps (), _CMP_LT_OQ),
+			  sign));
+}
+
+static uint32_t *
+avx2_conical_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const uint32_t *lut = iter->image->gradient.lut;
+    pixman_repeat_t repeat = iter->image->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    __m256 k = _mm256_setr_ps (0, 1, 2, 3, 0, 1, 2, 3);
+    __m256 one = _mm256_set1_ps (1.f);
+    conical_affine_t r;
+    int i;
+
+    if (!_pixman_conical_gradient_get_affine (iter->image, iter->x, iter->y, &r))
+	return _pixman_conical_gradient_get_scanline_narrow (iter, mask);
+
+    for (i = 0; i < width; i += 8)
+    {
+	float x0, y0, dx0, dy0;
+	float x1, y1, dx1, dy1;
+	__m256 x, y, t;
+	__m256i colors;
+
+	conical_affine_next_group (&r, &x0, &y0, &dx0, &dy0);
+	conical_affine_next_group (&r, &x1, &y1, &dx1, &dy1);
+
+	x = _mm256_add_ps (
+	    _mm256_setr_ps (x0, x0, x0, x0, x1, x1, x1, x1),
+	    _mm256_mul_ps (
+		k, _mm256_setr_ps (dx0, dx0, dx0, dx0, dx1, dx1, dx1, dx1)));
+	y = _mm256_add_ps (
+	    _mm256_setr_ps (y0, y0, y0, y0, y1, y1, y1, y1),
+	    _mm256_mul_ps (
+		k, _mm256_setr_ps (dy0, dy0, dy0, dy0, dy1, dy1, dy1, dy1)));
+
+	t = _mm256_add_ps (conical_atan2_8x256 (y, x), _mm256_set1_ps (r.angle));
+	t = _mm256_add_ps (
+	    t, _mm256_and_ps (
+		_mm256_cmp_ps (t, _mm256_setzero_ps (), _CMP_LT_OQ), one));
+	t = _mm256_sub_ps (
+	    t, _mm256_and_ps (_mm256_cmp_ps (t, one, _CMP_GE_OQ), one));
+
+	colors = gradient_lut_8x256 (
+	    lut, repeat, _mm256_cvttps_epi32 (
+		_mm256_mul_ps (_mm256_sub_ps (one, t),
+			       _mm256_set1_ps (65536.f))));
+
+	if (i + 8 <= width)
+	{
+	    _mm256_storeu_si256 ((__m256i *)(buffer + i), colors);
+	}
+	else
+	{
+	    uint32_t last[8];
+
+	    _mm256_storeu_si256 ((__m256i *)last, colors);
+	    memcpy (buffer + i, last, (width - i) * sizeof (uint32_t));
+	}
+    }
+
+    iter->y++;
+
+    return iter->buffer;
+}
+
+static void
+avx2_conical_gradient_iter_init (pixman_iter_t *iter,
+				 const pixman_iter_info_t *info)
+{
+    _pixman_conical_gradient_iter_init (iter->image, iter);
+
+    /* Only the colors from the LUT are computed in single precision */
+    if (iter->image->gradient.lut)
+	iter->get_scanline = avx2_conical_get_scanline;
+}
+
+static const pixman_iter_info_t avx2_iters[] =
+{
+    { PIXMAN_x8r8g8b8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, avx2_fetch_x8r8g8b8, NULL
+    },
+    { PIXMAN_r5g6b5, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, avx2_fetch_r5g6b5, NULL
+    },
+    { PIXMAN_a8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, avx2_fetch_a8, NULL
+    },
+    { PIXMAN_yuy2, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, avx2_fetch_yuv, NULL
+    },
+    { PIXMAN_yv12, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, avx2_fetch_yuv, NULL
+    },
+    { PIXMAN_i420, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, avx2_fetch_yuv, NULL
+    },
+    { PIXMAN_nv12, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, avx2_fetch_yuv, NULL
+    },
+    { PIXMAN_a16b16g16r16_float, WIDE_IMAGE_FLAGS, ITER_WIDE | ITER_SRC,
+      _pixman_iter_init_bits_stride, avx2_fetch_a16b16g16r16_float_float, NULL
+    },
+    { PIXMAN_a16b16g16r16_float, WIDE_DEST_FLAGS, ITER_WIDE | ITER_DEST,
+      _pixman_iter_init_bits_stride,
+      avx2_dest_get_a16b16g16r16_float_float,
+      avx2_write_back_a16b16g16r16_float_float
+    },
+    { PIXMAN_radial_gradient, 0, ITER_NARROW | ITER_SRC,
+      avx2_radial_gradient_iter_init, NULL, NULL
+    },
+    { PIXMAN_conical_gradient, 0, ITER_NARROW | ITER_SRC,
+      avx2_conical_gradient_iter_init, NULL, NULL
+    },
+    { PIXMAN_any, FAST_PATH_SEPARABLE_SCALE_FLAGS, ITER_NARROW | ITER_SRC,
+      avx2_separable_scaler_init, NULL, NULL
+    },
+    { PIXMAN_null },
+};
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+pixman_implementation_t *
+_pixman_implementation_create_avx2 (pixman_implementation_t *fallback)
+{
+    pixman_implementation_t *imp = _pixman_implementation_create (fallback, avx2_fast_paths);
+
+    imp->name = "avx2";
+
+    /* AVX2 constants */
+    mask_0080 = _mm256_set1_epi16 (0x0080);
+    mask_00ff = _mm256_set1_epi16 (0x00ff);
+    mask_0101 = _mm256_set1_epi16 (0x0101);
+    mask_ff000000 = _mm256_set1_epi32 (0xff000000);
+    mask_red   = _mm256_set1_epi32 (0x00f80000);
+    mask_green = _mm256_set1_epi32 (0x0000fc00);
+    mask_blue  = _mm256_set1_epi32 (0x000000f8);
+    mask_565_fix_rb = _mm256_set1_epi32 (0x00e000e0);
+    mask_565_fix_g = _mm256_set1_epi32 (0x0000c000);
+
+    /* Set up function pointers */
+    imp->combine_32[PIXMAN_OP_OVER] = avx2_combine_over_u;
+    imp->combine_32[PIXMAN_OP_OVER_REVERSE] = avx2_combine_over_reverse_u;
+    imp->combine_32[PIXMAN_OP_IN] = avx2_combine_in_u;
+    imp->combine_32[PIXMAN_OP_IN_REVERSE] = avx2_combine_in_reverse_u;
+    imp->combine_32[PIXMAN_OP_OUT] = avx2_combine_out_u;
+    imp->combine_32[PIXMAN_OP_OUT_REVERSE] = avx2_combine_out_reverse_u;
+    imp->combine_32[PIXMAN_OP_ADD] = avx2_combine_add_u;
+
+    imp->combine_32_ca[PIXMAN_OP_SRC] = avx2_combine_src_ca;
+    imp->combine_32_ca[PIXMAN_OP_OVER] = avx2_combine_over_ca;
+    imp->combine_32_ca[PIXMAN_OP_ADD] = avx2_combine_add_ca;
+
+    imp->combine_float[PIXMAN_OP_CLEAR] = avx2_combine_clear_u_float;
+    imp->combine_float[PIXMAN_OP_SRC] = avx2_combine_src_u_float;
+    imp->combine_float[PIXMAN_OP_DST] = avx2_combine_dst_u_float;
+    imp->combine_float[PIXMAN_OP_OVER] = avx2_combine_over_u_float;
+    imp->combine_float[PIXMAN_OP_OVER_REVERSE] = avx2_combine_over_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_IN] = avx2_combine_in_u_float;
+    imp->combine_float[PIXMAN_OP_IN_REVERSE] = avx2_combine_in_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_OUT] = avx2_combine_out_u_float;
+    imp->combine_float[PIXMAN_OP_OUT_REVERSE] = avx2_combine_out_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_ATOP] = avx2_combine_atop_u_float;
+    imp->combine_float[PIXMAN_OP_ATOP_REVERSE] = avx2_combine_atop_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_XOR] = avx2_combine_xor_u_float;
+    imp->combine_float[PIXMAN_OP_ADD] = avx2_combine_add_u_float;
+    imp->combine_float[PIXMAN_OP_SATURATE] = avx2_combine_saturate_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_CLEAR] = avx2_combine_disjoint_clear_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_SRC] = avx2_combine_disjoint_src_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_DST] = avx2_combine_disjoint_dst_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OVER] = avx2_combine_disjoint_over_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OVER_REVERSE] = avx2_combine_disjoint_over_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_IN] = avx2_combine_disjoint_in_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_IN_REVERSE] = avx2_combine_disjoint_in_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OUT] = avx2_combine_disjoint_out_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OUT_REVERSE] = avx2_combine_disjoint_out_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_ATOP] = avx2_combine_disjoint_atop_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_ATOP_REVERSE] = avx2_combine_disjoint_atop_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_XOR] = avx2_combine_disjoint_xor_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_CLEAR] = avx2_combine_conjoint_clear_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_SRC] = avx2_combine_conjoint_src_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_DST] = avx2_combine_conjoint_dst_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OVER] = avx2_combine_conjoint_over_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OVER_REVERSE] = avx2_combine_conjoint_over_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_IN] = avx2_combine_conjoint_in_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_IN_REVERSE] = avx2_combine_conjoint_in_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OUT] = avx2_combine_conjoint_out_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OUT_REVERSE] = avx2_combine_conjoint_out_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_ATOP] = avx2_combine_conjoint_atop_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_ATOP_REVERSE] = avx2_combine_conjoint_atop_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_XOR] = avx2_combine_conjoint_xor_u_float;
+    imp->combine_float[PIXMAN_OP_MULTIPLY] = avx2_combine_multiply_u_float;
+    imp->combine_float[PIXMAN_OP_SCREEN] = avx2_combine_screen_u_float;
+    imp->combine_float[PIXMAN_OP_OVERLAY] = avx2_combine_overlay_u_float;
+    imp->combine_float[PIXMAN_OP_DARKEN] = avx2_combine_darken_u_float;
+    imp->combine_float[PIXMAN_OP_LIGHTEN] = avx2_combine_lighten_u_float;
+    imp->combine_float[PIXMAN_OP_HARD_LIGHT] = avx2_combine_hard_light_u_float;
+    imp->combine_float[PIXMAN_OP_DIFFERENCE] = avx2_combine_difference_u_float;
+    imp->combine_float[PIXMAN_OP_EXCLUSION] = avx2_combine_exclusion_u_float;
+
+    imp->combine_float_ca[PIXMAN_OP_CLEAR] = avx2_combine_clear_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_SRC] = avx2_combine_src_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DST] = avx2_combine_dst_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OVER] = avx2_combine_over_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OVER_REVERSE] = avx2_combine_over_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_IN] = avx2_combine_in_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_IN_REVERSE] = avx2_combine_in_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OUT] = avx2_combine_out_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OUT_REVERSE] = avx2_combine_out_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_ATOP] = avx2_combine_atop_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_ATOP_REVERSE] = avx2_combine_atop_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_XOR] = avx2_combine_xor_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_ADD] = avx2_combine_add_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_SATURATE] = avx2_combine_saturate_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_CLEAR] = avx2_combine_disjoint_clear_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_SRC] = avx2_combine_disjoint_src_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_DST] = avx2_combine_disjoint_dst_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OVER] = avx2_combine_disjoint_over_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OVER_REVERSE] = avx2_combine_disjoint_over_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_IN] = avx2_combine_disjoint_in_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_IN_REVERSE] = avx2_combine_disjoint_in_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OUT] = avx2_combine_disjoint_out_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OUT_REVERSE] = avx2_combine_disjoint_out_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_ATOP] = avx2_combine_disjoint_atop_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_ATOP_REVERSE] = avx2_combine_disjoint_atop_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_XOR] = avx2_combine_disjoint_xor_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_CLEAR] = avx2_combine_conjoint_clear_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_SRC] = avx2_combine_conjoint_src_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_DST] = avx2_combine_conjoint_dst_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OVER] = avx2_combine_conjoint_over_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OVER_REVERSE] = avx2_combine_conjoint_over_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_IN] = avx2_combine_conjoint_in_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_IN_REVERSE] = avx2_combine_conjoint_in_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OUT] = avx2_combine_conjoint_out_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OUT_REVERSE] = avx2_combine_conjoint_out_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_ATOP] = avx2_combine_conjoint_atop_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_ATOP_REVERSE] = avx2_combine_conjoint_atop_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_XOR] = avx2_combine_conjoint_xor_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_MULTIPLY] = avx2_combine_multiply_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_SCREEN] = avx2_combine_screen_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OVERLAY] = avx2_combine_overlay_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DARKEN] = avx2_combine_darken_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_LIGHTEN] = avx2_combine_lighten_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_HARD_LIGHT] = avx2_combine_hard_light_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DIFFERENCE] = avx2_combine_difference_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_EXCLUSION] = avx2_combine_exclusion_ca_float;
+
+    imp->blt = avx2_blt;
+    imp->fill = avx2_fill;
+    imp->glyphs = avx2_glyphs;
+
+    imp->iter_info = avx2_iters;
+
+    return imp;
+}
@@ -1486,37 +1486,426 @@ static const fetcher_info_t fetcher_info[] =
 
 static void
 bits_image_property_changed (pixman_image_t *image)
-{
-    _pixman_bits_image_setup_accessors (&image->bits);
-}
-
-void
-_pixman_bits_image_src_iter_init (pixman_image_t *image, pixman_iter_t *iter)
 {
     pixman_format_code_t format = image->common.extended_format_code;
     uint32_t flags = image->common.flags;
     const fetcher_info_t *info;
 
+    _pixman_bits_image_setup_accessors (&image->bits);
+
+    /* The scanline fetchers only depend on the format and flags of
+     * the image, so choose them once here rather than every time an
+     * iterator is initialized.
+     */
     for (info = fetcher_info; info->format != PIXMAN_null; ++info)
     {
 	if ((info->format == format || info->format == PIXMAN_any)	&&
 	    (info->flags & flags) == info->flags)
 	{
-	    if (iter->iter_flags & ITER_NARROW)
-	    {
-		iter->get_scanline = info->get_scanline_32;
-	    }
-	    else
-	    {
-		iter->data = info->get_scanline_32;
-		iter->get_scanline = info->get_scanline_float;
-	    }
+	    image->bits.get_scanline_32 = info->get_scanline_32;
+	    image->bits.get_scanline_float = info->get_scanline_float;
 	    return;
 	}
     }
 
     /* Just in case we somehow didn't find a scanline function */
-    iter->get_scanline = _pixman_iter_get_scanline_noop;
+    image->bits.get_scanline_32 = _pixman_iter_get_scanline_noop;
+    image->bits.get_scanline_float = _pixman_iter_get_scanline_noop;
+}
+
+/* Two-pass separable convolution for scale transformations
+ *
+ * When the transformation only scales and translates, all pixels of a
+ * destination scanline use the same source rows, and all pixels of a
+ * destination column use the same source columns. The convolution can
+ * then be done in two passes: every source row that is needed is filtered
+ * horizontally once, into a ring of intermediate rows, and each scanline
+ * is a vertical filter over cheight of those. That takes cwidth + cheight
+ * multiplications per pixel rather than cwidth * cheight.
+ *
+ * The results can differ by 1 from those of the two-dimensional filter,
+ * which rounds the product of the horizontal and vertical weight of
+ * every tap, so images only use the scaler when their separable
+ * precision is PIXMAN_SEPARABLE_TWO_PASS.
+ *
+ * Both passes are 16 x 16 -> 32 bit multiply-adds. The weights are
+ * rounded to 14 bits and the intermediate rows hold four int16_t per
+ * pixel, in the order b, g, r, a, with 6 fractional bits. The weights of
+ * each phase are stored as groups of eight int16_t, w0 w1 w0 w1 w0 w1 w0 w1
+ * for each pair of taps, and the number of taps is padded with zero
+ * weights to a multiple of four horizontally and of two vertically.
+ *
+ * Implementations provide the passes:
+ *
+ *   convolve_row: for each destination pixel k, the sum of the n_taps
+ *   source pixels starting at src[offsets[k]], weighted by weights[k],
+ *   rounded to 6 fractional bits and saturated to int16_t, into the
+ *   four int16_t of dst at 4 * k.
+ *
+ *   convolve_column: for each destination pixel k, the sum of pixel k of
+ *   the n_taps rows, weighted by the group of weights, rounded to an
+ *   integer and clamped to [0, 255], into dst[k].
+ *
+ * Sums can't overflow, because weights whose absolute values add up to
+ * more than 2.0 are not accepted, so every implementation has to give
+ * exactly the results of the C version in pixman-fast-path.c.
+ */
+#define SEPARABLE_WEIGHT_BITS	14
+#define MAX_SEPARABLE_PHASES	(1 << 8)
+#define MAX_SEPARABLE_SPAN	(1 << 24)
+
+typedef struct
+{
+    pixman_convolve_row_func_t		convolve_row;
+    pixman_convolve_column_func_t	convolve_column;
+
+    int			width;
+    int			cheight;
+    int			n_x_taps;
+    int			n_y_taps;
+    int			y_off;
+    int			y_phase_shift;
+    const int16_t *	y_weights;
+
+    /* The source columns used by the scanlines */
+    int32_t		span_x;
+    int			span_width;
+    pixman_bool_t	direct;
+    uint32_t *		span;
+    uint32_t *		row;
+    int32_t *		offsets;
+    const int16_t **	weights;
+
+    /* Horizontally filtered rows, tagged with their source row */
+    int32_t *		tags;
+    int16_t *		ring;
+    int			ring_stride;
+    const int16_t *	zero_row;
+    const int16_t **	rows;
+} separable_scaler_t;
+
+/* Converts the n_taps weights of each of the n_phases phases in params
+ * to the layout described above, with n_padded taps per phase. Returns
+ * FALSE if the weights are too large.
+ */
+static pixman_bool_t
+convert_separable_weights (int16_t *              dst,
+			   const pixman_fixed_t * params,
+			   int                    n_phases,
+			   int                    n_taps,
+			   int                    n_padded)
+{
+    int p, i, j;
+
+    for (p = 0; p < n_phases; ++p)
+    {
+	int32_t total = 0;
+
+	for (i = 0; i < n_padded; ++i)
+	{
+	    int32_t w = 0;
+
+	    if (i < n_taps)
+	    {
+		pixman_fixed_t f = params[p * n_taps + i];
+
+		if (f <= -2 * pixman_fixed_1 || f >= 2 * pixman_fixed_1 - 2)
+		    return FALSE;
+
+		w = (f + (1 << (15 - SEPARABLE_WEIGHT_BITS))) >>
+		    (16 - SEPARABLE_WEIGHT_BITS);
+	    }
+
+	    total += w < 0 ? -w : w;
+
+	    for (j = 0; j < 4; ++j)
+		dst[(i / 2) * 8 + j * 2 + (i & 1)] = w;
+	}
+
+	if (total > (2 << SEPARABLE_WEIGHT_BITS))
+	    return FALSE;
+
+	dst += n_padded * 4;
+    }
+
+    return TRUE;
+}
+
+/* Returns the source pixels of row y at span_x ... span_x + span_width */
+static const uint32_t *
+separable_scaler_fetch_span (separable_scaler_t *s,
+			     pixman_image_t *    image,
+			     int                 y)
+{
+    bits_image_t *bits = &image->bits;
+    int32_t x = s->span_x;
+    int n = s->span_width;
+    int i;
+
+    if (x >= 0 && x + n <= bits->width)
+    {
+	if (s->direct)
+	    return bits->bits + y * bits->rowstride + x;
+
+	bits->fetch_scanline_32 (image, x, y, n, s->span, NULL);
+    }
+    else if (image->common.repeat == PIXMAN_REPEAT_NONE)
+    {
+	int32_t x1 = MAX (x, 0);
+	int32_t x2 = MIN (x + n, bits->width);
+
+	memset (s->span, 0, n * sizeof (uint32_t));
+
+	if (x1 < x2)
+	    bits->fetch_scanline_32 (image, x1, y, x2 - x1, s->span + (x1 - x), NULL);
+    }
+    else
+    {
+	bits->fetch_scanline_32 (image, 0, y, bits->width, s->row, NULL);
+
+	for (i = 0; i < n; ++i)
+	{
+	    int rx = x + i;
+
+	    repeat (image->common.repeat, &rx, bits->width);
+
+	    s->span[i] = s->row[rx];
+	}
+    }
+
+    return s->span;
+}
+
+/* Returns source row y, filtered horizontally */
+static const int16_t *
+separable_scaler_get_row (separable_scaler_t *s,
+			  pixman_image_t *    image,
+			  int32_t             y)
+{
+    int slot = MOD (y, s->cheight);
+    int16_t *row = s->ring + slot * s->ring_stride;
+    int ry = y;
+
+    if (s->tags[slot] == y)
+	return row;
+
+    if (!repeat (image->common.repeat, &ry, image->bits.height))
+	return s->zero_row;
+
+    s->convolve_row (row, separable_scaler_fetch_span (s, image, ry),
+		     s->offsets, s->weights, s->n_x_taps, s->width);
+
+    s->tags[slot] = y;
+
+    return row;
+}
+
+static uint32_t *
+separable_scaler_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    separable_scaler_t *s = iter->data;
+    pixman_image_t *image = iter->image;
+    pixman_fixed_t y;
+    pixman_vector_t v;
+    int32_t y1;
+    int py, i;
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y++) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (!pixman_transform_point_3d (image->common.transform, &v))
+	return iter->buffer;
+
+    /* Round to the middle of the closest phase, exactly as
+     * bits_image_fetch_separable_convolution_affine() does.
+     */
+    y = ((v.vector[1] >> s->y_phase_shift) << s->y_phase_shift) +
+	((1 << s->y_phase_shift) >> 1);
+    py = (y & 0xffff) >> s->y_phase_shift;
+    y1 = pixman_fixed_to_int (y - pixman_fixed_e - s->y_off);
+
+    for (i = 0; i < s->cheight; ++i)
+	s->rows[i] = separable_scaler_get_row (s, image, y1 + i);
+    for (; i < s->n_y_taps; ++i)
+	s->rows[i] = s->zero_row;
+
+    s->convolve_column (iter->buffer, s->rows,
+			s->y_weights + py * s->n_y_taps * 4,
+			s->n_y_taps, iter->width);
+
+    return iter->buffer;
+}
+
+static void
+separable_scaler_fini (pixman_iter_t *iter)
+{
+    free (iter->data);
+}
+
+/* Carves n bytes, rounded up to keep 16 byte alignment, out of *p */
+static void *
+carve (uint8_t **p, size_t n)
+{
+    void *result = *p;
+
+    *p += (n + 15) & ~15;
+
+    return result;
+}
+
+void
+_pixman_separable_scaler_iter_init (pixman_iter_t *                iter,
+				    pixman_convolve_row_func_t     convolve_row,
+				    pixman_convolve_column_func_t  convolve_column)
+{
+    pixman_image_t *image = iter->image;
+    pixman_fixed_t *params = image->common.filter_params;
+    int cwidth = pixman_fixed_to_int (params[0]);
+    int cheight = pixman_fixed_to_int (params[1]);
+    int x_phase_bits = pixman_fixed_to_int (params[2]);
+    int y_phase_bits = pixman_fixed_to_int (params[3]);
+    int x_phase_shift = 16 - x_phase_bits;
+    int x_off = ((cwidth << 16) - pixman_fixed_1) >> 1;
+    int n_x_taps = (cwidth + 3) & ~3;
+    int n_y_taps = (cheight + 1) & ~1;
+    int width = iter->width;
+    int ring_stride = ((width + 3) & ~3) * 4;
+    int32_t x1_first, x1_last, span_width;
+    const int16_t *x_weights;
+    separable_scaler_t *s;
+    pixman_fixed_t vx, ux;
+    int64_t vx_last;
+    pixman_vector_t v;
+    uint8_t *p;
+    size_t size;
+    int k;
+
+    if (cwidth <= 0 || cheight <= 0				||
+	x_phase_bits < 0 || y_phase_bits < 0			||
+	(1 << x_phase_bits) > MAX_SEPARABLE_PHASES		||
+	(1 << y_phase_bits) > MAX_SEPARABLE_PHASES)
+    {
+	goto fallback;
+    }
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (!pixman_transform_point_3d (image->common.transform, &v))
+	goto fallback;
+
+    ux = image->common.transform->matrix[0][0];
+    vx = v.vector[0];
+
+#define FIRST_X(vx)							\
+    pixman_fixed_to_int (((((vx) >> x_phase_shift) << x_phase_shift) +	\
+			  ((1 << x_phase_shift) >> 1)) -		\
+			 pixman_fixed_e - x_off)
+
+    /* The first column used moves monotonically across the scanline */
+    vx_last = vx + (int64_t)(width - 1) * ux;
+    if (vx_last < INT32_MIN || vx_last > INT32_MAX)
+	goto fallback;
+
+    x1_first = FIRST_X (vx);
+    x1_last = FIRST_X ((pixman_fixed_t)vx_last);
+
+    span_width = MAX (x1_first, x1_last) - MIN (x1_first, x1_last) + n_x_taps;
+    if (span_width > MAX_SEPARABLE_SPAN)
+	goto fallback;
+
+    size =
+	((sizeof (separable_scaler_t) + 15) & ~15)			+
+	((width * sizeof (int32_t) + 15) & ~15)				+
+	((width * sizeof (int16_t *) + 15) & ~15)			+
+	((n_y_taps * sizeof (int16_t *) + 15) & ~15)			+
+	((cheight * sizeof (int32_t) + 15) & ~15)			+
+	(((size_t)span_width * sizeof (uint32_t) + 15) & ~15)		+
+	(((size_t)image->bits.width * sizeof (uint32_t) + 15) & ~15)	+
+	((size_t)(1 << x_phase_bits) * n_x_taps * 4 * sizeof (int16_t))	+
+	((size_t)(1 << y_phase_bits) * n_y_taps * 4 * sizeof (int16_t))	+
+	((size_t)(cheight + 1) * ring_stride * sizeof (int16_t));
+
+    if (!(p = malloc (size)))
+	goto fallback;
+
+    s = carve (&p, sizeof (separable_scaler_t));
+    s->offsets = carve (&p, width * sizeof (int32_t));
+    s->weights = carve (&p, width * sizeof (int16_t *));
+    s->rows = carve (&p, n_y_taps * sizeof (int16_t *));
+    s->tags = carve (&p, cheight * sizeof (int32_t));
+    s->span = carve (&p, span_width * sizeof (uint32_t));
+    s->row = carve (&p, image->bits.width * sizeof (uint32_t));
+    x_weights = carve (&p, (1 << x_phase_bits) * n_x_taps * 4 * sizeof (int16_t));
+    s->y_weights = carve (&p, (1 << y_phase_bits) * n_y_taps * 4 * sizeof (int16_t));
+    s->ring = carve (&p, cheight * ring_stride * sizeof (int16_t));
+    s->zero_row = carve (&p, ring_stride * sizeof (int16_t));
+
+    if (!convert_separable_weights ((int16_t *)x_weights, params + 4,
+				    1 << x_phase_bits, cwidth, n_x_taps) ||
+	!convert_separable_weights ((int16_t *)s->y_weights,
+				    params + 4 + (1 << x_phase_bits) * cwidth,
+				    1 << y_phase_bits, cheight, n_y_taps))
+    {
+	free (s);
+	goto fallback;
+    }
+
+    s->convolve_row = convolve_row;
+    s->convolve_column = convolve_column;
+    s->width = width;
+    s->cheight = cheight;
+    s->n_x_taps = n_x_taps;
+    s->n_y_taps = n_y_taps;
+    s->y_off = ((cheight << 16) - pixman_fixed_1) >> 1;
+    s->y_phase_shift = 16 - y_phase_bits;
+    s->span_x = MIN (x1_first, x1_last);
+    s->span_width = span_width;
+    s->direct =
+	image->bits.format == PIXMAN_a8r8g8b8 &&
+	(image->common.flags & FAST_PATH_NO_ACCESSORS);
+    s->ring_stride = ring_stride;
+
+    for (k = 0; k < width; ++k)
+    {
+	int px = (vx & 0xffff) >> x_phase_shift;
+
+	s->offsets[k] = FIRST_X (vx) - s->span_x;
+	s->weights[k] = x_weights + px * n_x_taps * 4;
+
+	vx += ux;
+    }
+
+#undef FIRST_X
+
+    for (k = 0; k < cheight; ++k)
+	s->tags[k] = INT32_MIN;
+
+    memset ((int16_t *)s->zero_row, 0, ring_stride * sizeof (int16_t));
+
+    iter->data = s;
+    iter->get_scanline = separable_scaler_get_scanline;
+    iter->fini = separable_scaler_fini;
+    return;
+
+fallback:
+    _pixman_bits_image_src_iter_init (image, iter);
+}
+
+void
+_pixman_bits_image_src_iter_init (pixman_image_t *image, pixman_iter_t *iter)
+{
+    if (iter->iter_flags & ITER_NARROW)
+    {
+	iter->get_scanline = image->bits.get_scanline_32;
+    }
+    else
+    {
+	iter->data = image->bits.get_scanline_32;
+	iter->get_scanline = image->bits.get_scanline_float;
+    }
 }
 
 static uint32_t *
@@ -1706,6 +2095,57 @@ create_bits (pixman_format_code_t format,
 	return malloc (buf_size);
 }
 
+/* Find the planes of planar YUV images created with a single buffer.
+ * The chroma planes follow the luma plane, with half its stride, or
+ * for nv12 the same stride. For yv12 the V plane comes first.
+ */
+static void
+init_planes (bits_image_t *image)
+{
+    uint32_t *bits = image->bits;
+    int stride = image->rowstride;
+    int offset0, offset1;
+
+    if (stride < 0)
+    {
+	offset0 = ((-stride) >> 1) * ((image->height - 1) >> 1) - stride;
+	offset1 = offset0 + ((-stride) >> 1) * ((image->height) >> 1);
+    }
+    else
+    {
+	offset0 = stride * image->height;
+	offset1 = offset0 + (offset0 >> 2);
+    }
+
+    image->planes[0] = (uint8_t *)bits;
+    image->plane_strides[0] = stride * (int) sizeof (uint32_t);
+
+    switch (image->format)
+    {
+    case PIXMAN_nv12:
+	image->planes[1] = (uint8_t *)(bits + offset0);
+	image->plane_strides[1] = stride * (int) sizeof (uint32_t);
+	break;
+
+    case PIXMAN_i420:
+	image->planes[1] = (uint8_t *)(bits + offset0);
+	image->planes[2] = (uint8_t *)(bits + offset1);
+	image->plane_strides[1] = (stride >> 1) * (int) sizeof (uint32_t);
+	image->plane_strides[2] = (stride >> 1) * (int) sizeof (uint32_t);
+	break;
+
+    case PIXMAN_yv12:
+	image->planes[1] = (uint8_t *)(bits + offset1);
+	image->planes[2] = (uint8_t *)(bits + offset0);
+	image->plane_strides[1] = (stride >> 1) * (int) sizeof (uint32_t);
+	image->plane_strides[2] = (stride >> 1) * (int) sizeof (uint32_t);
+	break;
+
+    default:
+	break;
+    }
+}
+
 pixman_bool_t
 _pixman_bits_image_init (pixman_image_t *     image,
                          pixman_format_code_t format,
@@ -1741,6 +2181,15 @@ _pixman_bits_image_init (pixman_image_t *     image,
     image->bits.write_func = NULL;
     image->bits.rowstride = rowstride;
     image->bits.indexed = NULL;
+    image->bits.dither = PIXMAN_DITHER_NONE;
+    image->bits.dither_offset_x = 0;
+    image->bits.dither_offset_y = 0;
+    image->bits.separable_precision = PIXMAN_SEPARABLE_PRECISE;
+
+    memset (image->bits.planes, 0, sizeof (image->bits.planes));
+    memset (image->bits.plane_strides, 0, sizeof (image->bits.plane_strides));
+    if (PIXMAN_FORMAT_BPP (format) == 12)
+	init_planes (&image->bits);
 
     image->common.property_changed = bits_image_property_changed;
 
@@ -1795,6 +2244,57 @@ pixman_image_create_bits (pixman_format_code_t format,
 }
 
 
+/* Planar YUV images whose planes are in separate buffers. planes[0] is
+ * the luma plane, and planes[1] and planes[2] are the U and V planes,
+ * or for nv12 planes[1] is the interleaved UV plane. Strides are in
+ * bytes; the luma stride must be a multiple of 4. The planes are not
+ * freed with the image.
+ */
+PIXMAN_EXPORT pixman_image_t *
+pixman_image_create_planar (pixman_format_code_t format,
+			    int                  width,
+			    int                  height,
+			    uint8_t * const *    planes,
+			    const int *          strides)
+{
+    pixman_image_t *image;
+    int n_planes, i;
+
+    if (format == PIXMAN_nv12)
+	n_planes = 2;
+    else if (format == PIXMAN_i420 || format == PIXMAN_yv12)
+	n_planes = 3;
+    else
+	n_planes = 0;
+
+    return_val_if_fail (n_planes != 0, NULL);
+    return_val_if_fail ((strides[0] % sizeof (uint32_t)) == 0, NULL);
+
+    for (i = 0; i < n_planes; ++i)
+	return_val_if_fail (planes[i] != NULL, NULL);
+
+    image = _pixman_image_allocate ();
+
+    if (!image)
+	return NULL;
+
+    if (!_pixman_bits_image_init (image, format, width, height,
+				  (uint32_t *)planes[0],
+				  strides[0] / (int) sizeof (uint32_t), FALSE))
+    {
+	free (image);
+	return NULL;
+    }
+
+    for (i = 0; i < n_planes; ++i)
+    {
+	image->bits.planes[i] = planes[i];
+	image->bits.plane_strides[i] = strides[i];
+    }
+
+    return image;
+}
+
 /* If bits is NULL, a buffer will be allocated and _not_ initialized */
 PIXMAN_EXPORT pixman_image_t *
 pixman_image_create_bits_no_clear (pixman_format_code_t format,
@@ -224,3 +224,46 @@
 #    error "Unknown thread local support for this system. Pixman will not work with multiple threads. Define PIXMAN_NO_TLS to acknowledge and accept this limitation and compile pixman without thread-safety support."
 
 #endif
+
+/* Locks for short critical sections in objects that can be used from
+ * several threads at once. A thread that waits for a lock yields to the
+ * others, so that it doesn't keep a preempted owner from running. A lock
+ * is initialized to 0.
+ */
+#if defined(PIXMAN_NO_TLS)
+
+typedef int pixman_spinlock_t;
+#   define PIXMAN_SPIN_LOCK(lock)	((void) (lock))
+#   define PIXMAN_SPIN_UNLOCK(lock)	((void) (lock))
+
+#elif defined(_WIN32)
+
+#   include <windows.h>
+typedef volatile LONG pixman_spinlock_t;
+#   define PIXMAN_SPIN_LOCK(lock)					\
+    do									\
+    {									\
+	while (InterlockedExchange ((lock), 1))				\
+	    SwitchToThread ();						\
+    } while (0)
+#   define PIXMAN_SPIN_UNLOCK(lock)					\
+    InterlockedExchange ((lock), 0)
+
+#elif defined(__GNUC__)
+
+#   include <sched.h>
+typedef volatile int pixman_spinlock_t;
+#   define PIXMAN_SPIN_LOCK(lock)					\
+    do									\
+    {									\
+	while (__sync_lock_test_and_set ((lock), 1))			\
+	    sched_yield ();						\
+    } while (0)
+#   define PIXMAN_SPIN_UNLOCK(lock)					\
+    __sync_lock_release (lock)
+
+#else
+
+#    error "Unknown atomic operations for this system. The glyph cache will not work with multiple threads. Define PIXMAN_NO_TLS to acknowledge and accept this limitation and compile pixman without thread-safety support."
+
+#endif
@@ -50,8 +50,132 @@ coordinates_to_parameter (double x, double y, double angle)
 				      */
 }
 
-static uint32_t *
-conical_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
+/* The position of the center of the first pixel of row y starting at x,
+ * relative to the center of the gradient, and the step from one pixel
+ * to the next. Returns FALSE if the transformation is projective.
+ */
+pixman_bool_t
+_pixman_conical_gradient_get_affine (pixman_image_t   *image,
+				     int               x,
+				     int               y,
+				     conical_affine_t *affine)
+{
+    conical_gradient_t *conical = (conical_gradient_t *)image;
+    double cx = 1.;
+    double cy = 0.;
+    double rx = x + 0.5;
+    double ry = y + 0.5;
+
+    if (image->common.transform)
+    {
+	pixman_vector_t v;
+
+	/* reference point is the center of the pixel */
+	v.vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
+	v.vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
+	v.vector[2] = pixman_fixed_1;
+
+	if (!pixman_transform_point_3d (image->common.transform, &v)	||
+	    image->common.transform->matrix[2][0] != 0			||
+	    v.vector[2] != pixman_fixed_1)
+	{
+	    return FALSE;
+	}
+
+	cx = image->common.transform->matrix[0][0] / 65536.;
+	cy = image->common.transform->matrix[1][0] / 65536.;
+
+	rx = v.vector[0] / 65536.;
+	ry = v.vector[1] / 65536.;
+    }
+
+    affine->x = rx - conical->center.x / 65536.;
+    affine->y = ry - conical->center.y / 65536.;
+    affine->dx = cx;
+    affine->dy = cy;
+    affine->angle = conical->angle * (1 / (2 * M_PI));
+
+    return TRUE;
+}
+
+/* atan2 (y, x) in turns, with the polynomial from pixman-private.h. The
+ * SIMD implementations do exactly the same operations.
+ */
+static force_inline float
+conical_atan2 (float y, float x)
+{
+    float ax = fabsf (x);
+    float ay = fabsf (y);
+    float mn = ay < ax ? ay : ax;
+    float mx = ay > ax ? ay : ax;
+    float a, s, r;
+
+    a = mx != 0 ? mn / mx : 0;
+    s = a * a;
+    r = a * (CONICAL_ATAN_A1 + s * (CONICAL_ATAN_A3 + s * (
+		 CONICAL_ATAN_A5 + s * (CONICAL_ATAN_A7 + s * CONICAL_ATAN_A9))));
+
+    if (ay > ax)
+	r = 0.25f - r;
+    if (x < 0)
+	r = 0.5f - r;
+    if (y < 0)
+	r = -r;
+
+    return r;
+}
+
+/* Like coordinates_to_parameter (), but in single precision and with
+ * the color from the LUT.
+ */
+static force_inline uint32_t
+conical_lut_pixel (const conical_affine_t *r,
+		   const uint32_t         *lut,
+		   pixman_repeat_t         repeat,
+		   float                   x,
+		   float                   y)
+{
+    float t = conical_atan2 (y, x) + r->angle;
+
+    if (t < 0)
+	t += 1.f;
+    if (t >= 1)
+	t -= 1.f;
+
+    return gradient_lut_pixel (lut, repeat, (int32_t)((1.f - t) * 65536.f));
+}
+
+static void
+conical_get_scanline_lut (pixman_iter_t    *iter,
+			  const uint32_t   *mask,
+			  conical_affine_t *r)
+{
+    const uint32_t *lut = iter->image->gradient.lut;
+    pixman_repeat_t repeat = iter->image->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    int i, k;
+
+    for (i = 0; i < width; i += 4)
+    {
+	float x, y, dx, dy;
+
+	conical_affine_next_group (r, &x, &y, &dx, &dy);
+
+	for (k = 0; k < 4 && i + k < width; ++k)
+	{
+	    if (!mask || *mask++)
+	    {
+		buffer[i + k] = conical_lut_pixel (
+		    r, lut, repeat, x + (float)k * dx, y + (float)k * dy);
+	    }
+	}
+    }
+}
+
+uint32_t *
+_pixman_conical_gradient_get_scanline_narrow (pixman_iter_t  *iter,
+					      const uint32_t *mask)
 {
     pixman_image_t *image = iter->image;
     int x = iter->x;
@@ -70,6 +194,16 @@ conical_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
     double rx = x + 0.5;
     double ry = y + 0.5;
     double rz = 1.;
+    conical_affine_t lut_affine;
+
+    if (gradient->lut &&
+	_pixman_conical_gradient_get_affine (image, x, y, &lut_affine))
+    {
+	conical_get_scanline_lut (iter, mask, &lut_affine);
+
+	iter->y++;
+	return iter->buffer;
+    }
 
     _pixman_gradient_walker_init (&walker, gradient, image->common.repeat);
 
@@ -163,7 +297,7 @@ conical_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
 static uint32_t *
 conical_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
 {
-    uint32_t *buffer = conical_get_scanline_narrow (iter, NULL);
+    uint32_t *buffer = _pixman_conical_gradient_get_scanline_narrow (iter, NULL);
 
     pixman_expand_to_float (
 	(argb_t *)buffer, buffer, PIXMAN_a8r8g8b8, iter->width);
@@ -175,7 +309,7 @@ void
 _pixman_conical_gradient_iter_init (pixman_image_t *image, pixman_iter_t *iter)
 {
     if (iter->iter_flags & ITER_NARROW)
-	iter->get_scanline = conical_get_scanline_narrow;
+	iter->get_scanline = _pixman_conical_gradient_get_scanline_narrow;
     else
 	iter->get_scanline = conical_get_scanline_wide;
 }
@@ -0,0 +1,531 @@
+/* WARNING: This file is generated by make-dither.pl.
+ * Please edit that file instead of this one.
+ */
+
+#include <stdint.h>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pixman-private.h"
+
+const uint8_t dither_bayer_8[4096] =
+{
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	1, 129, 33, 161, 9, 137, 41, 169, 1, 129, 33, 161, 9, 137, 41, 169, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	193, 65, 225, 97, 201, 73, 233, 105, 193, 65, 225, 97, 201, 73, 233, 105, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	49, 177, 17, 145, 57, 185, 25, 153, 49, 177, 17, 145, 57, 185, 25, 153, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	241, 113, 209, 81, 249, 121, 217, 89, 241, 113, 209, 81, 249, 121, 217, 89, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	13, 141, 45, 173, 5, 133, 37, 165, 13, 141, 45, 173, 5, 133, 37, 165, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	205, 77, 237, 109, 197, 69, 229, 101, 205, 77, 237, 109, 197, 69, 229, 101, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	61, 189, 29, 157, 53, 181, 21, 149, 61, 189, 29, 157, 53, 181, 21, 149, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+	253, 125, 221, 93, 245, 117, 213, 85, 253, 125, 221, 93, 245, 117, 213, 85, 
+};
+
+const uint8_t dither_blue_noise_64[4096] =
+{
+	66, 170, 89, 224, 128, 241, 197, 49, 87, 22, 127, 173, 213, 134, 36, 186, 
+	123, 45, 181, 248, 57, 220, 176, 106, 202, 59, 138, 170, 23, 153, 102, 230, 
+	55, 29, 213, 109, 23, 189, 53, 215, 20, 179, 205, 85, 110, 199, 143, 32, 
+	94, 59, 231, 194, 26, 222, 170, 10, 154, 104, 194, 145, 60, 203, 178, 8, 
+	147, 216, 11, 60, 162, 30, 112, 139, 238, 185, 226, 56, 9, 240, 82, 222, 
+	157, 209, 140, 20, 98, 132, 43, 237, 160, 13, 211, 94, 236, 66, 130, 209, 
+	78, 125, 245, 47, 154, 122, 99, 162, 71, 136, 4, 156, 221, 18, 68, 240, 
+	214, 133, 168, 107, 54, 93, 205, 79, 227, 28, 249, 0, 114, 77, 240, 97, 
+	47, 182, 107, 142, 204, 95, 179, 64, 5, 105, 75, 146, 110, 163, 53, 99, 
+	14, 62, 87, 168, 213, 194, 24, 91, 72, 125, 184, 35, 118, 196, 40, 166, 
+	0, 180, 146, 68, 204, 5, 247, 37, 196, 104, 239, 123, 49, 168, 103, 181, 
+	10, 83, 37, 245, 185, 151, 21, 132, 182, 61, 125, 177, 44, 161, 24, 208, 
+	82, 248, 35, 234, 75, 15, 254, 152, 211, 167, 30, 249, 201, 20, 180, 138, 
+	251, 116, 226, 6, 70, 115, 152, 180, 224, 48, 246, 77, 163, 11, 251, 86, 
+	115, 227, 19, 90, 166, 220, 79, 144, 226, 56, 31, 187, 75, 235, 130, 44, 
+	155, 198, 120, 1, 73, 229, 109, 50, 241, 99, 214, 84, 236, 196, 139, 119, 
+	3, 159, 131, 186, 50, 221, 123, 37, 88, 127, 189, 42, 79, 124, 217, 29, 
+	197, 40, 189, 158, 233, 53, 251, 9, 136, 109, 17, 143, 229, 101, 139, 216, 
+	50, 194, 103, 235, 31, 130, 183, 17, 117, 172, 90, 218, 141, 14, 210, 88, 
+	253, 65, 219, 164, 137, 33, 212, 173, 7, 158, 33, 134, 14, 101, 59, 228, 
+	203, 67, 20, 92, 164, 107, 197, 58, 233, 13, 215, 102, 158, 234, 63, 91, 
+	151, 75, 132, 101, 27, 143, 82, 200, 64, 216, 171, 201, 58, 32, 180, 67, 
+	157, 34, 133, 175, 62, 108, 45, 202, 68, 250, 8, 158, 99, 38, 191, 117, 
+	24, 145, 100, 51, 241, 89, 123, 67, 141, 205, 73, 181, 222, 153, 36, 177, 
+	125, 104, 219, 194, 31, 143, 3, 175, 157, 71, 142, 55, 184, 4, 111, 171, 
+	210, 10, 245, 50, 175, 220, 106, 34, 159, 93, 41, 121, 82, 210, 127, 8, 
+	242, 82, 211, 13, 249, 156, 216, 93, 152, 131, 48, 206, 64, 241, 161, 58, 
+	225, 188, 17, 204, 177, 13, 194, 235, 24, 96, 254, 48, 118, 69, 246, 86, 
+	31, 240, 137, 62, 246, 78, 209, 97, 248, 115, 223, 26, 242, 148, 40, 224, 
+	56, 117, 187, 86, 206, 4, 126, 188, 227, 20, 244, 182, 13, 160, 234, 110, 
+	188, 141, 53, 119, 195, 75, 1, 231, 30, 184, 228, 115, 177, 130, 2, 80, 
+	174, 45, 129, 76, 111, 152, 53, 83, 179, 116, 166, 5, 211, 191, 16, 167, 
+	146, 51, 9, 173, 119, 227, 45, 132, 21, 41, 192, 94, 121, 76, 192, 134, 
+	25, 236, 142, 32, 155, 58, 246, 74, 144, 55, 102, 140, 223, 92, 48, 75, 
+	27, 166, 225, 89, 37, 138, 176, 121, 63, 103, 15, 82, 29, 202, 107, 248, 
+	137, 92, 237, 216, 36, 251, 127, 214, 41, 231, 62, 150, 90, 137, 106, 227, 
+	74, 183, 211, 89, 25, 152, 186, 74, 200, 151, 66, 175, 211, 14, 253, 102, 
+	83, 168, 65, 109, 233, 93, 173, 15, 116, 170, 213, 67, 32, 192, 152, 206, 
+	254, 104, 7, 183, 238, 102, 50, 243, 209, 155, 195, 139, 235, 52, 152, 34, 
+	207, 10, 159, 64, 171, 5, 95, 163, 15, 134, 189, 28, 241, 39, 59, 206, 
+	122, 100, 238, 159, 56, 109, 9, 222, 92, 241, 0, 135, 47, 155, 60, 176, 
+	208, 2, 221, 195, 18, 131, 213, 47, 231, 195, 9, 130, 248, 113, 3, 135, 
+	41, 68, 130, 153, 22, 201, 146, 12, 88, 42, 252, 69, 163, 97, 222, 72, 
+	117, 191, 30, 105, 198, 138, 226, 67, 204, 103, 80, 215, 114, 182, 162, 2, 
+	151, 22, 41, 131, 205, 253, 177, 140, 49, 167, 112, 231, 89, 221, 117, 32, 
+	149, 50, 124, 162, 42, 188, 78, 148, 95, 36, 80, 160, 53, 177, 79, 224, 
+	169, 195, 215, 53, 81, 224, 67, 167, 187, 130, 26, 113, 6, 191, 21, 173, 
+	231, 58, 149, 244, 83, 45, 181, 29, 149, 249, 46, 157, 13, 222, 80, 251, 
+	196, 221, 71, 187, 85, 34, 63, 104, 17, 207, 72, 35, 194, 20, 184, 228, 
+	87, 245, 98, 69, 237, 105, 23, 253, 165, 112, 239, 202, 99, 232, 24, 122, 
+	90, 15, 114, 240, 171, 120, 33, 106, 226, 61, 208, 175, 232, 129, 88, 141, 
+	39, 96, 126, 210, 21, 121, 238, 87, 114, 1, 193, 126, 60, 98, 134, 49, 
+	88, 116, 165, 6, 228, 122, 159, 237, 185, 130, 250, 162, 143, 104, 72, 133, 
+	17, 200, 142, 11, 206, 134, 175, 64, 1, 186, 137, 18, 39, 150, 188, 47, 
+	244, 148, 38, 99, 19, 194, 137, 244, 4, 95, 147, 79, 44, 214, 60, 203, 
+	253, 165, 2, 174, 71, 156, 200, 52, 165, 225, 74, 174, 244, 203, 27, 175, 
+	12, 54, 247, 99, 146, 20, 202, 77, 30, 95, 58, 7, 217, 51, 247, 161, 
+	57, 171, 37, 182, 80, 48, 225, 121, 211, 45, 68, 221, 118, 72, 208, 140, 
+	65, 219, 190, 159, 63, 214, 82, 50, 160, 198, 32, 245, 108, 158, 9, 115, 
+	27, 79, 218, 52, 228, 99, 10, 132, 212, 36, 141, 19, 111, 42, 147, 236, 
+	213, 183, 133, 37, 215, 171, 48, 115, 225, 153, 200, 120, 85, 189, 11, 118, 
+	210, 105, 232, 117, 247, 159, 30, 86, 151, 237, 94, 176, 159, 252, 14, 104, 
+	175, 0, 79, 131, 250, 10, 149, 186, 112, 222, 130, 16, 171, 72, 239, 185, 
+	153, 199, 107, 135, 188, 34, 250, 179, 64, 105, 238, 89, 217, 161, 70, 124, 
+	22, 154, 78, 194, 62, 93, 249, 144, 16, 176, 42, 243, 166, 138, 40, 235, 
+	81, 25, 66, 149, 6, 97, 202, 179, 15, 111, 199, 6, 51, 87, 129, 36, 
+	238, 121, 203, 46, 178, 95, 235, 23, 70, 42, 88, 184, 229, 35, 94, 134, 
+	64, 41, 245, 13, 76, 148, 113, 80, 23, 190, 153, 55, 183, 4, 196, 94, 
+	230, 107, 26, 240, 120, 1, 184, 69, 213, 87, 112, 66, 27, 221, 99, 174, 
+	150, 192, 222, 43, 212, 136, 56, 242, 74, 134, 35, 146, 230, 185, 218, 167, 
+	58, 90, 230, 29, 113, 60, 127, 210, 169, 253, 140, 60, 114, 149, 212, 20, 
+	225, 89, 122, 161, 233, 49, 217, 164, 242, 124, 11, 227, 80, 117, 242, 58, 
+	169, 207, 52, 164, 139, 230, 107, 35, 132, 237, 4, 207, 125, 76, 199, 53, 
+	1, 131, 95, 168, 76, 188, 109, 28, 163, 209, 247, 61, 116, 25, 70, 142, 
+	198, 20, 160, 138, 223, 201, 40, 145, 98, 2, 196, 219, 12, 189, 54, 108, 
+	168, 194, 31, 180, 97, 204, 3, 138, 37, 94, 201, 45, 136, 172, 38, 141, 
+	7, 127, 88, 219, 22, 80, 203, 161, 55, 190, 147, 170, 240, 16, 143, 251, 
+	74, 229, 21, 116, 250, 16, 223, 130, 50, 93, 180, 79, 162, 211, 100, 5, 
+	244, 108, 187, 74, 7, 173, 84, 20, 228, 121, 77, 39, 159, 84, 248, 142, 
+	0, 240, 57, 141, 20, 70, 106, 193, 58, 218, 158, 108, 251, 21, 204, 79, 
+	185, 248, 34, 179, 59, 150, 15, 226, 120, 28, 92, 41, 103, 183, 36, 114, 
+	165, 204, 60, 182, 38, 156, 68, 171, 233, 25, 123, 9, 195, 42, 232, 122, 
+	155, 37, 55, 251, 100, 154, 239, 184, 54, 150, 176, 103, 232, 124, 36, 205, 
+	69, 128, 86, 220, 189, 252, 130, 172, 234, 77, 28, 181, 66, 98, 226, 114, 
+	66, 149, 102, 201, 118, 246, 97, 181, 74, 254, 201, 62, 154, 224, 84, 195, 
+	24, 104, 147, 236, 126, 91, 216, 2, 105, 199, 146, 224, 89, 135, 60, 178, 
+	76, 222, 132, 208, 29, 125, 65, 113, 218, 28, 247, 62, 198, 22, 179, 98, 
+	165, 212, 38, 114, 152, 48, 27, 88, 10, 117, 140, 199, 0, 165, 146, 44, 
+	218, 12, 230, 76, 26, 172, 45, 141, 6, 111, 138, 232, 10, 119, 54, 136, 
+	239, 47, 83, 8, 207, 55, 139, 185, 75, 254, 58, 34, 158, 245, 12, 204, 
+	96, 22, 163, 81, 182, 44, 199, 9, 92, 205, 129, 11, 147, 76, 217, 53, 
+	18, 148, 232, 7, 76, 169, 226, 200, 155, 246, 51, 216, 88, 239, 24, 196, 
+	170, 124, 53, 159, 135, 211, 68, 193, 221, 167, 25, 81, 191, 162, 212, 4, 
+	157, 216, 174, 111, 189, 29, 243, 117, 40, 161, 98, 191, 115, 71, 167, 39, 
+	235, 187, 111, 3, 231, 151, 247, 138, 166, 72, 47, 170, 229, 110, 137, 253, 
+	120, 193, 94, 183, 243, 101, 122, 61, 35, 97, 170, 128, 39, 110, 133, 77, 
+	97, 33, 186, 242, 2, 95, 237, 29, 90, 52, 210, 103, 44, 244, 67, 94, 
+	115, 31, 63, 231, 150, 98, 168, 17, 208, 132, 9, 230, 21, 217, 103, 126, 
+	146, 62, 219, 136, 56, 104, 84, 33, 190, 117, 242, 95, 193, 40, 4, 173, 
+	72, 32, 63, 139, 45, 19, 215, 143, 184, 223, 12, 71, 229, 180, 55, 254, 
+	212, 144, 82, 199, 112, 42, 131, 160, 119, 246, 144, 176, 128, 30, 142, 178, 
+	248, 194, 132, 12, 77, 46, 224, 65, 89, 237, 172, 81, 142, 185, 51, 252, 
+	18, 86, 36, 200, 169, 20, 208, 60, 225, 3, 144, 23, 69, 158, 221, 90, 
+	202, 235, 112, 219, 157, 190, 75, 3, 112, 81, 192, 153, 19, 206, 161, 8, 
+	115, 235, 23, 61, 150, 218, 181, 77, 11, 187, 66, 15, 234, 79, 200, 18, 
+	52, 84, 164, 205, 251, 123, 194, 141, 180, 49, 119, 61, 206, 32, 91, 171, 
+	203, 153, 242, 95, 124, 238, 177, 110, 156, 83, 214, 174, 237, 105, 56, 129, 
+	153, 8, 176, 26, 59, 127, 232, 165, 252, 46, 131, 239, 102, 80, 140, 43, 
+	66, 178, 104, 167, 249, 17, 53, 204, 228, 39, 96, 215, 113, 164, 226, 103, 
+	127, 233, 42, 107, 20, 161, 31, 106, 3, 218, 29, 248, 127, 158, 223, 0, 
+	73, 116, 179, 9, 72, 38, 141, 16, 254, 44, 131, 31, 120, 205, 16, 246, 
+	44, 83, 132, 250, 100, 203, 37, 92, 147, 25, 209, 60, 33, 124, 242, 201, 
+	151, 4, 210, 39, 124, 91, 145, 104, 166, 127, 152, 194, 51, 1, 63, 153, 
+	190, 8, 148, 185, 90, 220, 72, 244, 154, 197, 100, 167, 10, 106, 58, 138, 
+	234, 33, 56, 198, 161, 219, 87, 196, 65, 184, 91, 197, 48, 79, 168, 189, 
+	107, 215, 194, 73, 168, 12, 118, 212, 68, 186, 115, 168, 224, 182, 18, 93, 
+	231, 133, 85, 227, 67, 195, 237, 3, 61, 251, 19, 81, 241, 137, 208, 33, 
+	80, 214, 67, 239, 49, 137, 202, 53, 85, 133, 63, 188, 79, 240, 197, 177, 
+	99, 215, 144, 245, 100, 132, 53, 228, 113, 162, 11, 244, 154, 220, 139, 28, 
+	63, 159, 20, 43, 145, 238, 54, 172, 16, 240, 86, 3, 145, 74, 51, 192, 
+	33, 57, 189, 158, 21, 174, 36, 122, 211, 89, 176, 35, 115, 182, 96, 253, 
+	162, 109, 28, 121, 170, 6, 112, 181, 15, 235, 39, 220, 19, 134, 43, 24, 
+	77, 125, 17, 69, 29, 190, 2, 147, 34, 209, 136, 104, 60, 2, 96, 229, 
+	120, 241, 93, 223, 184, 86, 134, 224, 107, 154, 49, 201, 103, 247, 164, 117, 
+	98, 252, 12, 113, 136, 215, 80, 154, 186, 48, 140, 225, 159, 70, 22, 130, 
+	53, 227, 142, 209, 78, 249, 40, 160, 210, 116, 144, 96, 157, 207, 119, 166, 
+	248, 188, 155, 211, 121, 234, 169, 92, 242, 73, 25, 227, 186, 127, 199, 43, 
+	179, 9, 140, 115, 64, 1, 199, 39, 77, 192, 128, 219, 32, 133, 13, 219, 
+	147, 174, 75, 234, 93, 52, 246, 110, 13, 236, 101, 6, 193, 46, 233, 200, 
+	5, 183, 92, 18, 186, 146, 218, 91, 65, 28, 171, 254, 52, 84, 224, 63, 
+	5, 93, 46, 174, 81, 38, 108, 61, 186, 122, 173, 82, 35, 247, 70, 146, 
+	84, 209, 37, 193, 159, 243, 121, 150, 24, 251, 10, 68, 178, 84, 204, 63, 
+	125, 27, 209, 41, 195, 169, 23, 71, 204, 127, 65, 214, 85, 123, 150, 103, 
+	169, 66, 244, 45, 106, 60, 21, 124, 241, 198, 76, 3, 179, 26, 106, 149, 
+	198, 232, 113, 11, 250, 151, 222, 206, 14, 46, 213, 143, 165, 107, 15, 234, 
+	161, 59, 254, 102, 21, 52, 93, 230, 184, 98, 163, 116, 235, 155, 43, 186, 
+	226, 89, 118, 155, 7, 126, 229, 143, 166, 27, 178, 146, 242, 18, 210, 77, 
+	30, 128, 156, 205, 135, 232, 193, 156, 46, 138, 108, 212, 126, 193, 237, 39, 
+	128, 57, 215, 139, 192, 54, 24, 132, 154, 252, 100, 7, 57, 217, 178, 116, 
+	26, 128, 174, 76, 219, 202, 165, 69, 43, 137, 228, 56, 17, 96, 243, 2, 
+	162, 52, 181, 247, 62, 97, 211, 49, 85, 254, 42, 105, 59, 167, 39, 250, 
+	187, 225, 14, 81, 173, 0, 73, 101, 179, 14, 231, 56, 154, 90, 68, 169, 
+	16, 180, 75, 30, 97, 122, 78, 180, 91, 66, 185, 234, 129, 88, 36, 198, 
+	93, 226, 6, 148, 114, 34, 128, 5, 216, 82, 29, 182, 213, 145, 113, 71, 
+	132, 237, 23, 78, 141, 186, 26, 109, 191, 121, 208, 11, 187, 113, 139, 92, 
+	54, 118, 100, 38, 214, 112, 252, 35, 220, 85, 165, 34, 246, 11, 119, 209, 
+	249, 91, 148, 230, 169, 238, 198, 8, 227, 37, 115, 28, 206, 154, 249, 68, 
+	167, 46, 190, 238, 58, 172, 249, 188, 108, 155, 202, 123, 65, 32, 188, 216, 
+	16, 97, 201, 112, 218, 44, 243, 157, 16, 67, 153, 231, 78, 202, 220, 2, 
+	149, 199, 166, 241, 57, 131, 162, 197, 62, 123, 205, 102, 142, 218, 49, 156, 
+	107, 36, 197, 0, 66, 43, 136, 107, 158, 203, 144, 170, 76, 50, 0, 136, 
+	214, 109, 80, 134, 16, 98, 75, 140, 54, 240, 12, 100, 172, 254, 86, 46, 
+	143, 177, 39, 154, 0, 171, 80, 134, 205, 238, 95, 48, 130, 24, 64, 173, 
+	236, 26, 70, 140, 187, 27, 83, 9, 144, 244, 22, 67, 180, 83, 196, 22, 
+	71, 133, 221, 117, 155, 207, 28, 242, 49, 84, 11, 244, 101, 187, 119, 234, 
+	20, 152, 31, 211, 179, 231, 24, 219, 36, 177, 74, 230, 135, 5, 155, 206, 
+	117, 232, 69, 251, 125, 101, 228, 60, 34, 169, 4, 145, 180, 248, 101, 125, 
+	46, 88, 208, 7, 97, 235, 207, 109, 172, 48, 191, 116, 2, 238, 126, 169, 
+	243, 186, 54, 86, 250, 103, 74, 177, 218, 129, 61, 213, 26, 227, 163, 86, 
+	59, 195, 241, 119, 65, 151, 105, 196, 120, 92, 150, 33, 55, 222, 102, 62, 
+	217, 10, 91, 190, 49, 211, 14, 182, 126, 107, 196, 223, 85, 40, 160, 227, 
+	189, 145, 251, 124, 175, 50, 153, 37, 221, 94, 137, 229, 154, 39, 61, 101, 
+	7, 150, 31, 172, 15, 190, 148, 4, 94, 162, 193, 113, 138, 70, 40, 204, 
+	103, 174, 45, 91, 7, 207, 48, 163, 0, 249, 189, 212, 121, 164, 185, 31, 
+	147, 171, 130, 27, 160, 71, 146, 87, 250, 51, 73, 23, 118, 211, 7, 76, 
+	22, 104, 58, 34, 223, 72, 129, 242, 16, 68, 207, 30, 87, 176, 222, 202, 
+	83, 217, 112, 234, 133, 52, 229, 122, 39, 253, 17, 47, 182, 154, 15, 250, 
+	128, 10, 139, 164, 252, 126, 85, 226, 70, 135, 19, 63, 88, 17, 247, 81, 
+	109, 54, 238, 207, 106, 241, 196, 26, 214, 140, 230, 176, 153, 59, 186, 121, 
+	215, 168, 198, 151, 115, 12, 195, 83, 183, 114, 167, 57, 248, 111, 144, 26, 
+	128, 59, 195, 76, 35, 99, 200, 65, 183, 140, 75, 236, 85, 221, 108, 178, 
+	72, 224, 208, 57, 189, 32, 143, 181, 40, 208, 114, 173, 236, 137, 50, 201, 
+	225, 33, 183, 64, 5, 133, 43, 111, 161, 8, 101, 44, 245, 94, 139, 239, 
+	43, 85, 1, 243, 90, 212, 160, 55, 145, 217, 5, 128, 198, 13, 51, 184, 
+	253, 157, 16, 143, 178, 247, 155, 22, 224, 100, 203, 126, 30, 200, 55, 144, 
+	35, 95, 25, 111, 78, 233, 12, 109, 239, 93, 152, 37, 217, 103, 159, 6, 
+	166, 87, 120, 154, 96, 226, 176, 61, 191, 80, 203, 129, 13, 197, 30, 68, 
+	158, 229, 135, 65, 179, 22, 102, 254, 25, 96, 237, 76, 162, 97, 225, 75, 
+	105, 42, 232, 93, 216, 7, 82, 114, 164, 54, 9, 173, 96, 135, 7, 234, 
+	197, 160, 244, 176, 148, 50, 202, 169, 58, 22, 197, 77, 12, 190, 71, 128, 
+	57, 247, 19, 216, 193, 25, 85, 246, 122, 33, 233, 172, 74, 223, 108, 182, 
+	19, 100, 189, 45, 125, 233, 40, 120, 178, 47, 192, 147, 40, 208, 133, 167, 
+	1, 207, 172, 67, 121, 49, 138, 212, 33, 246, 148, 223, 62, 243, 165, 80, 
+	116, 63, 129, 4, 220, 100, 125, 72, 213, 139, 253, 177, 125, 43, 241, 204, 
+	108, 187, 143, 45, 71, 168, 147, 14, 214, 149, 59, 111, 157, 48, 143, 253, 
+	119, 206, 29, 225, 169, 73, 204, 138, 221, 69, 118, 20, 231, 65, 27, 243, 
+	117, 55, 134, 24, 201, 166, 239, 69, 193, 87, 112, 22, 191, 35, 104, 184, 
+	21, 229, 44, 88, 197, 23, 244, 153, 3, 118, 49, 99, 222, 147, 91, 27, 
+	155, 1, 84, 229, 125, 239, 105, 43, 179, 97, 1, 247, 22, 210, 83, 7, 
+	156, 60, 87, 141, 105, 18, 156, 85, 8, 163, 244, 88, 180, 111, 192, 84, 
+	148, 236, 193, 98, 229, 17, 101, 177, 3, 136, 208, 74, 152, 123, 215, 51, 
+	151, 209, 142, 182, 66, 163, 38, 90, 233, 192, 30, 165, 62, 8, 174, 229, 
+	71, 199, 112, 164, 25, 58, 205, 135, 64, 226, 198, 124, 176, 100, 192, 38, 
+	235, 178, 212, 4, 250, 197, 55, 239, 109, 37, 198, 130, 5, 157, 47, 218, 
+	19, 73, 33, 158, 80, 143, 41, 123, 59, 237, 40, 168, 252, 86, 0, 239, 
+	75, 98, 12, 252, 109, 223, 133, 181, 56, 105, 217, 82, 246, 197, 120, 52, 
+	135, 251, 38, 210, 91, 174, 6, 254, 88, 159, 34, 79, 51, 231, 131, 69, 
+	96, 123, 46, 161, 66, 122, 28, 174, 212, 142, 55, 223, 71, 252, 136, 101, 
+	170, 187, 113, 212, 52, 252, 190, 221, 155, 184, 106, 14, 54, 196, 136, 163, 
+	201, 37, 126, 158, 50, 17, 76, 206, 11, 161, 127, 18, 141, 103, 31, 214, 
+	178, 13, 129, 65, 236, 140, 192, 119, 21, 188, 139, 242, 152, 26, 168, 221, 
+	148, 23, 240, 102, 188, 151, 225, 95, 70, 189, 23, 99, 173, 33, 200, 10, 
+	61, 246, 129, 4, 172, 105, 12, 78, 27, 89, 213, 128, 227, 100, 30, 64, 
+	110, 175, 234, 83, 202, 173, 116, 247, 142, 70, 230, 188, 51, 170, 239, 86, 
+	47, 99, 187, 156, 17, 108, 40, 78, 218, 52, 104, 12, 213, 114, 57, 9, 
+	205, 185, 75, 219, 18, 87, 42, 134, 0, 247, 120, 150, 211, 90, 123, 228, 
+	156, 38, 86, 233, 68, 136, 203, 118, 242, 146, 49, 173, 72, 149, 184, 243, 
+	10, 218, 57, 27, 138, 232, 44, 92, 31, 175, 43, 97, 207, 74, 6, 160, 
+	199, 240, 77, 221, 51, 201, 160, 231, 133, 169, 203, 65, 91, 191, 251, 84, 
+	110, 41, 127, 143, 56, 244, 198, 160, 108, 171, 62, 234, 8, 49, 183, 73, 
+	110, 217, 146, 188, 30, 223, 45, 175, 62, 193, 5, 246, 25, 220, 41, 127, 
+	89, 150, 119, 185, 99, 13, 162, 219, 195, 114, 239, 14, 123, 228, 144, 113, 
+	18, 124, 32, 144, 94, 249, 67, 29, 94, 5, 236, 127, 177, 38, 136, 157, 
+	232, 174, 6, 204, 167, 117, 14, 228, 47, 203, 29, 85, 165, 130, 238, 27, 
+	196, 15, 55, 104, 164, 81, 151, 18, 228, 111, 84, 141, 118, 201, 77, 168, 
+	210, 21, 72, 245, 208, 55, 132, 66, 5, 151, 77, 184, 157, 33, 63, 217, 
+	170, 61, 207, 174, 2, 120, 181, 150, 209, 116, 44, 157, 23, 218, 73, 18, 
+	52, 95, 248, 66, 101, 36, 183, 71, 92, 137, 220, 106, 195, 63, 149, 96, 
+	171, 134, 204, 240, 9, 122, 250, 93, 135, 35, 215, 162, 57, 98, 3, 253, 
+	47, 194, 165, 36, 147, 83, 182, 251, 102, 216, 137, 53, 246, 106, 187, 90, 
+	253, 139, 102, 238, 71, 196, 19, 56, 242, 73, 189, 86, 245, 108, 170, 202, 
+	224, 122, 150, 27, 230, 209, 149, 124, 252, 11, 175, 41, 245, 14, 213, 44, 
+	253, 70, 90, 37, 177, 213, 54, 161, 206, 69, 178, 15, 235, 192, 153, 110, 
+	140, 92, 229, 111, 1, 223, 118, 23, 166, 46, 19, 205, 82, 0, 225, 43, 
+	11, 163, 25, 47, 132, 225, 105, 140, 172, 32, 224, 144, 56, 0, 131, 89, 
+	34, 190, 79, 176, 131, 86, 50, 21, 194, 153, 59, 120, 146, 82, 113, 162, 
+	1, 122, 222, 148, 109, 75, 28, 191, 7, 121, 248, 87, 45, 129, 31, 232, 
+	60, 15, 129, 68, 190, 157, 41, 201, 90, 241, 110, 163, 125, 177, 142, 114, 
+	209, 87, 191, 216, 155, 82, 41, 206, 90, 128, 14, 113, 210, 182, 236, 59, 
+	164, 15, 219, 57, 2, 243, 163, 220, 102, 78, 233, 208, 24, 188, 231, 65, 
+	202, 179, 25, 59, 195, 234, 144, 103, 230, 52, 149, 107, 222, 181, 74, 205, 
+	158, 214, 175, 249, 50, 99, 238, 73, 178, 135, 64, 230, 32, 56, 199, 73, 
+	227, 129, 63, 110, 13, 237, 186, 6, 248, 54, 198, 165, 78, 41, 150, 105, 
+	228, 115, 142, 199, 109, 185, 68, 119, 39, 180, 3, 96, 166, 50, 131, 30, 
+	142, 96, 245, 166, 5, 128, 45, 180, 78, 168, 31, 200, 18, 164, 95, 8, 
+	106, 42, 84, 19, 203, 137, 10, 126, 31, 220, 14, 185, 89, 248, 157, 29, 
+	51, 180, 245, 36, 175, 118, 69, 164, 110, 152, 233, 28, 101, 250, 11, 197, 
+	74, 46, 254, 87, 40, 133, 25, 200, 245, 145, 126, 69, 249, 106, 217, 83, 
+	235, 47, 116, 79, 215, 94, 249, 21, 214, 131, 241, 67, 119, 54, 250, 135, 
+	183, 237, 147, 120, 169, 78, 227, 192, 55, 156, 103, 145, 213, 8, 98, 118, 
+	166, 2, 96, 148, 214, 51, 139, 210, 38, 82, 133, 64, 216, 173, 136, 32, 
+	126, 183, 9, 167, 210, 232, 151, 89, 17, 57, 227, 199, 28, 148, 6, 181, 
+	158, 19, 200, 152, 29, 175, 57, 151, 107, 1, 88, 185, 149, 219, 34, 199, 
+	64, 23, 223, 56, 215, 38, 149, 110, 254, 81, 206, 44, 71, 134, 191, 236, 
+	81, 137, 205, 70, 17, 250, 93, 24, 230, 179, 4, 192, 119, 48, 87, 209, 
+	231, 97, 145, 67, 19, 102, 47, 172, 215, 98, 159, 43, 178, 73, 207, 119, 
+	61, 220, 131, 67, 240, 111, 207, 73, 193, 228, 48, 212, 13, 101, 160, 83, 
+	125, 171, 91, 111, 3, 181, 94, 24, 167, 6, 181, 117, 243, 171, 58, 23, 
+	196, 46, 233, 108, 156, 191, 121, 167, 62, 106, 247, 156, 21, 236, 152, 61, 
+	163, 26, 200, 226, 124, 190, 241, 69, 123, 187, 8, 112, 132, 240, 91, 38, 
+	252, 100, 7, 183, 42, 138, 10, 170, 35, 145, 115, 172, 135, 72, 226, 4, 
+	245, 44, 206, 160, 249, 64, 235, 197, 70, 135, 233, 35, 16, 92, 217, 151, 
+	252, 123, 26, 183, 42, 78, 8, 220, 147, 203, 41, 95, 70, 195, 108, 2, 
+	243, 79, 112, 34, 156, 81, 1, 145, 32, 253, 81, 222, 53, 193, 13, 170, 
+	141, 191, 84, 161, 225, 81, 236, 126, 92, 254, 61, 28, 243, 46, 176, 114, 
+	190, 145, 16, 77, 124, 141, 42, 116, 216, 48, 85, 164, 224, 129, 39, 110, 
+};
@@ -650,6 +650,381 @@ fast_composite_src_x888_8888 (pixman_implementation_t *imp,
     }
 }
 
+/* 64 bpp pixels are accessed as pairs of 32 bit words because a row
+ * stride only needs to be a multiple of four bytes.
+ */
+static force_inline uint64_t
+fetch_64 (const uint32_t *p)
+{
+#ifdef WORDS_BIGENDIAN
+    return ((uint64_t)p[0] << 32) | p[1];
+#else
+    return ((uint64_t)p[1] << 32) | p[0];
+#endif
+}
+
+static force_inline void
+store_64 (uint32_t *p, uint64_t v)
+{
+#ifdef WORDS_BIGENDIAN
+    p[0] = v >> 32;
+    p[1] = v;
+#else
+    p[0] = v;
+    p[1] = v >> 32;
+#endif
+}
+
+static force_inline uint32_t
+convert_wide_to_8888 (uint64_t p, pixman_format_code_t format)
+{
+    if (format == PIXMAN_a16b16g16r16_float)
+	return convert_f16161616_to_8888 (p);
+    else if (format == PIXMAN_x16b16g16r16)
+	return convert_16161616_to_8888 (p) | 0xff000000;
+    else
+	return convert_16161616_to_8888 (p);
+}
+
+static force_inline uint64_t
+convert_8888_to_wide (uint32_t s, pixman_format_code_t format)
+{
+    if (format == PIXMAN_a16b16g16r16_float)
+	return convert_8888_to_f16161616 (s);
+    else
+	return convert_8888_to_16161616 (s);
+}
+
+static force_inline void
+fast_composite_wide_8888 (pixman_composite_info_t *info,
+			  pixman_format_code_t     src_format)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src, s;
+    int dst_stride, src_stride;
+    int32_t w;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 2);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w--)
+	{
+	    s = convert_wide_to_8888 (fetch_64 (src), src_format);
+	    src += 2;
+
+	    if (op == PIXMAN_OP_SRC || (s >> 24) == 0xff)
+		*dst = s;
+	    else if (s)
+		*dst = over (s, *dst);
+	    dst++;
+	}
+    }
+}
+
+static force_inline void
+fast_composite_8888_wide (pixman_composite_info_t *info,
+			  pixman_format_code_t     dest_format)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    uint32_t    alpha = 0;
+    int dst_stride, src_stride;
+    int32_t w;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 2);
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    if (PIXMAN_FORMAT_A (src_image->bits.format) == 0)
+	alpha = 0xff000000;
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w--)
+	{
+	    store_64 (dst, convert_8888_to_wide (*src++ | alpha, dest_format));
+	    dst += 2;
+	}
+    }
+}
+
+static void
+fast_composite_src_16161616_8888 (pixman_implementation_t *imp,
+				  pixman_composite_info_t *info)
+{
+    fast_composite_wide_8888 (info, PIXMAN_a16b16g16r16);
+}
+
+static void
+fast_composite_src_x16161616_8888 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    fast_composite_wide_8888 (info, PIXMAN_x16b16g16r16);
+}
+
+static void
+fast_composite_src_f16161616_8888 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    fast_composite_wide_8888 (info, PIXMAN_a16b16g16r16_float);
+}
+
+static void
+fast_composite_over_16161616_8888 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    fast_composite_wide_8888 (info, PIXMAN_a16b16g16r16);
+}
+
+static void
+fast_composite_over_f16161616_8888 (pixman_implementation_t *imp,
+				    pixman_composite_info_t *info)
+{
+    fast_composite_wide_8888 (info, PIXMAN_a16b16g16r16_float);
+}
+
+static void
+fast_composite_src_8888_16161616 (pixman_implementation_t *imp,
+				  pixman_composite_info_t *info)
+{
+    fast_composite_8888_wide (info, PIXMAN_a16b16g16r16);
+}
+
+static void
+fast_composite_src_8888_f16161616 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    fast_composite_8888_wide (info, PIXMAN_a16b16g16r16_float);
+}
+
+/* a8r8g8b8_sRGB is not a narrow format, so without these it would go
+ * through argb_t in the general implementation. Here pixels are
+ * linearized to 16 bits per channel through srgb_to_linear[] and
+ * encoded again through linear_to_srgb[].
+ */
+static force_inline uint64_t
+fetch_linear (uint32_t s, pixman_format_code_t format)
+{
+    if (format == PIXMAN_a8r8g8b8_sRGB)
+	return convert_srgb_to_16161616 (s);
+    else if (format == PIXMAN_x8r8g8b8)
+	return convert_8888_to_16161616 (s | 0xff000000);
+    else
+	return convert_8888_to_16161616 (s);
+}
+
+static force_inline uint32_t
+store_linear (uint64_t p, pixman_format_code_t format)
+{
+    if (format == PIXMAN_a8r8g8b8_sRGB)
+	return convert_16161616_to_srgb (p);
+    else
+	return round_16161616_to_8888 (p);
+}
+
+static force_inline void
+fast_composite_srgb (pixman_composite_info_t *info,
+		     pixman_format_code_t     src_format,
+		     pixman_format_code_t     dest_format)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src, s;
+    int dst_stride, src_stride;
+    int32_t w;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    if (src_format == PIXMAN_x8r8g8b8 && op == PIXMAN_OP_OVER)
+	op = PIXMAN_OP_SRC;
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w--)
+	{
+	    s = *src++;
+
+	    if (op == PIXMAN_OP_SRC || (op == PIXMAN_OP_OVER && (s >> 24) == 0xff))
+	    {
+		if (src_format == dest_format)
+		    *dst = s;
+		else
+		    *dst = store_linear (fetch_linear (s, src_format), dest_format);
+	    }
+	    else if (s)
+	    {
+		uint64_t d = fetch_linear (*dst, dest_format);
+
+		if (op == PIXMAN_OP_OVER)
+		    d = over_16161616 (fetch_linear (s, src_format), d);
+		else
+		    d = add_16161616 (fetch_linear (s, src_format), d);
+
+		*dst = store_linear (d, dest_format);
+	    }
+	    dst++;
+	}
+    }
+}
+
+static void
+fast_composite_src_srgb_8888 (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8_sRGB, PIXMAN_a8r8g8b8);
+}
+
+static void
+fast_composite_src_8888_srgb (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8, PIXMAN_a8r8g8b8_sRGB);
+}
+
+static void
+fast_composite_src_x888_srgb (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_x8r8g8b8, PIXMAN_a8r8g8b8_sRGB);
+}
+
+static void
+fast_composite_over_srgb_8888 (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8_sRGB, PIXMAN_a8r8g8b8);
+}
+
+static void
+fast_composite_over_8888_srgb (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8, PIXMAN_a8r8g8b8_sRGB);
+}
+
+static void
+fast_composite_over_srgb_srgb (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8_sRGB, PIXMAN_a8r8g8b8_sRGB);
+}
+
+static void
+fast_composite_add_srgb_8888 (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8_sRGB, PIXMAN_a8r8g8b8);
+}
+
+static void
+fast_composite_add_8888_srgb (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8, PIXMAN_a8r8g8b8_sRGB);
+}
+
+static void
+fast_composite_add_srgb_srgb (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    fast_composite_srgb (info, PIXMAN_a8r8g8b8_sRGB, PIXMAN_a8r8g8b8_sRGB);
+}
+
+/* Solid sources, which are linear, with an optional a8 mask */
+static force_inline void
+fast_composite_srgb_solid (pixman_implementation_t *imp,
+			   pixman_composite_info_t *info,
+			   pixman_bool_t            use_mask)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint8_t     *mask_line = NULL, *mask = NULL;
+    uint32_t     src_srgb, m;
+    uint64_t     s;
+    pixman_bool_t opaque;
+    int dst_stride, mask_stride = 0;
+    int32_t w;
+
+    s = _pixman_image_get_solid_16161616 (imp, src_image);
+    src_srgb = convert_16161616_to_srgb (s);
+    opaque = (s >> 48) == 0xffff;
+
+    if (s == 0)
+	return;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    if (use_mask)
+	PIXMAN_IMAGE_GET_LINE (mask_image, mask_x, mask_y, uint8_t, mask_stride, mask_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	mask = mask_line;
+	mask_line += mask_stride;
+	w = width;
+
+	while (w--)
+	{
+	    m = use_mask ? *mask++ : 0xff;
+
+	    if (m == 0xff && op == PIXMAN_OP_OVER && opaque)
+	    {
+		*dst = src_srgb;
+	    }
+	    else if (m)
+	    {
+		uint64_t d = convert_srgb_to_16161616 (*dst);
+		uint64_t sm = (m == 0xff) ? s : in_16161616 (s, m * 257);
+
+		if (op == PIXMAN_OP_OVER)
+		    d = over_16161616 (sm, d);
+		else
+		    d = add_16161616 (sm, d);
+
+		*dst = convert_16161616_to_srgb (d);
+	    }
+	    dst++;
+	}
+    }
+}
+
+static void
+fast_composite_srgb_n (pixman_implementation_t *imp,
+		       pixman_composite_info_t *info)
+{
+    fast_composite_srgb_solid (imp, info, FALSE);
+}
+
+static void
+fast_composite_srgb_n_8 (pixman_implementation_t *imp,
+			 pixman_composite_info_t *info)
+{
+    fast_composite_srgb_solid (imp, info, TRUE);
+}
+
 #if 0
 static void
 fast_composite_over_8888_0888 (pixman_implementation_t *imp,
@@ -768,6 +1143,72 @@ fast_composite_src_x888_0565 (pixman_implementation_t *imp,
     }
 }
 
+/* Dithered destinations: every pixel is stored, like the general
+ * implementation does, since dithering can change pixels that the
+ * composite leaves alone.
+ */
+static void
+fast_composite_over_8888_0565_dither (pixman_implementation_t *imp,
+                                      pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint16_t    *dst_line, *dst;
+    uint32_t    *src_line, *src, s, d;
+    const uint8_t *row;
+    int dst_stride, src_stride;
+    int32_t w, x, y = dest_y;
+
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint16_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	row = dither_row (&dest_image->bits, y++);
+	x = dest_x + dest_image->bits.dither_offset_x;
+	w = width;
+
+	while (w--)
+	{
+	    s = *src++;
+	    d = over (s, convert_0565_to_0888 (*dst));
+	    *dst++ = dither_8888_to_0565 (d, row[x++ & 63]);
+	}
+    }
+}
+
+static void
+fast_composite_src_x888_0565_dither (pixman_implementation_t *imp,
+                                     pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint16_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    const uint8_t *row;
+    int dst_stride, src_stride;
+    int32_t w, x, y = dest_y;
+
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint16_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	row = dither_row (&dest_image->bits, y++);
+	x = dest_x + dest_image->bits.dither_offset_x;
+	w = width;
+
+	while (w--)
+	    *dst++ = dither_8888_to_0565 (*src++, row[x++ & 63]);
+    }
+}
+
 static void
 fast_composite_add_8_8 (pixman_implementation_t *imp,
 			pixman_composite_info_t *info)
@@ -1197,6 +1638,20 @@ fast_composite_src_memcpy (pixman_implementation_t *imp,
     uint8_t    *dst;
     uint8_t    *src;
 
+    /* Large copies go to the blt of the toplevel implementation, which
+     * can bypass the cache.
+     */
+    if (_pixman_use_streaming_stores (width, height, bpp * 8) &&
+	_pixman_implementation_blt (imp->toplevel,
+				    src_image->bits.bits, dest_image->bits.bits,
+				    src_image->bits.rowstride,
+				    dest_image->bits.rowstride,
+				    bpp * 8, bpp * 8,
+				    src_x, src_y, dest_x, dest_y, width, height))
+    {
+	return;
+    }
+
     src_stride = src_image->bits.rowstride * 4;
     dst_stride = dest_image->bits.rowstride * 4;
 
@@ -1233,6 +1688,43 @@ FAST_NEAREST (8888_565_none, 8888, 0565, uint32_t, uint16_t, OVER, NONE)
 FAST_NEAREST (8888_565_pad, 8888, 0565, uint32_t, uint16_t, OVER, PAD)
 FAST_NEAREST (8888_565_normal, 8888, 0565, uint32_t, uint16_t, OVER, NORMAL)
 
+static void
+fast_fetch_yuv_row (uint32_t *     dst,
+		    bits_image_t * image,
+		    int            x,
+		    int            line,
+		    int            width)
+{
+    image->fetch_scanline_32 ((pixman_image_t *)image, x, line, width, dst, NULL);
+}
+
+static force_inline void
+scaled_bilinear_scanline_8888_8888_SRC (uint32_t *       dst,
+					const uint32_t * mask,
+					const uint32_t * src_top,
+					const uint32_t * src_bottom,
+					int32_t          w,
+					int              wt,
+					int              wb,
+					pixman_fixed_t   vx,
+					pixman_fixed_t   unit_x,
+					pixman_fixed_t   max_vx,
+					pixman_bool_t    zero_src)
+{
+    while (--w >= 0)
+    {
+	int x = pixman_fixed_to_int (vx);
+
+	*dst++ = bilinear_interpolation (src_top[x], src_top[x + 1],
+					 src_bottom[x], src_bottom[x + 1],
+					 pixman_fixed_to_bilinear_weight (vx), wb);
+	vx += unit_x;
+    }
+}
+
+FAST_YUV (yuv_8888, fast_fetch_yuv_row,
+	  scaled_bilinear_scanline_8888_8888_SRC)
+
 #define REPEAT_MIN_WIDTH    32
 
 static void
@@ -1880,12 +2372,27 @@ static const pixman_fast_path_t c_fast_paths[] =
     PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, a8b8g8r8, fast_composite_over_8888_8888),
     PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, x8b8g8r8, fast_composite_over_8888_8888),
     PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, b5g6r5, fast_composite_over_8888_0565),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16, a8r8g8b8, fast_composite_over_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16, x8r8g8b8, fast_composite_over_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16_float, a8r8g8b8, fast_composite_over_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16_float, x8r8g8b8, fast_composite_over_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8, fast_composite_over_srgb_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a8r8g8b8_sRGB, x8r8g8b8, fast_composite_over_srgb_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8_sRGB, fast_composite_over_8888_srgb),
+    PIXMAN_WIDE_FAST_PATH (OVER, x8r8g8b8, a8r8g8b8_sRGB, fast_composite_src_x888_srgb),
+    PIXMAN_WIDE_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8_sRGB, fast_composite_over_srgb_srgb),
+    PIXMAN_WIDE_DEST_FAST_PATH (OVER, solid, null, a8r8g8b8_sRGB, fast_composite_srgb_n),
+    PIXMAN_WIDE_DEST_FAST_PATH (OVER, solid, a8, a8r8g8b8_sRGB, fast_composite_srgb_n_8),
     PIXMAN_STD_FAST_PATH (ADD, r5g6b5, null, r5g6b5, fast_composite_add_0565_0565),
     PIXMAN_STD_FAST_PATH (ADD, b5g6r5, null, b5g6r5, fast_composite_add_0565_0565),
     PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, fast_composite_add_8888_8888),
     PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, fast_composite_add_8888_8888),
     PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, fast_composite_add_8_8),
     PIXMAN_STD_FAST_PATH (ADD, a1, null, a1, fast_composite_add_1_1),
+    PIXMAN_WIDE_FAST_PATH (ADD, a8r8g8b8_sRGB, a8r8g8b8, fast_composite_add_srgb_8888),
+    PIXMAN_WIDE_FAST_PATH (ADD, a8r8g8b8, a8r8g8b8_sRGB, fast_composite_add_8888_srgb),
+    PIXMAN_WIDE_FAST_PATH (ADD, a8r8g8b8_sRGB, a8r8g8b8_sRGB, fast_composite_add_srgb_srgb),
+    PIXMAN_WIDE_DEST_FAST_PATH (ADD, solid, a8, a8r8g8b8_sRGB, fast_composite_srgb_n_8),
     PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8r8g8b8, a8r8g8b8, fast_composite_add_n_8888_8888_ca),
     PIXMAN_STD_FAST_PATH (ADD, solid, a8, a8, fast_composite_add_n_8_8),
     PIXMAN_STD_FAST_PATH (SRC, solid, null, a8r8g8b8, fast_composite_solid_fill),
@@ -1913,10 +2420,37 @@ static const pixman_fast_path_t c_fast_paths[] =
     PIXMAN_STD_FAST_PATH (SRC, x1r5g5b5, null, x1r5g5b5, fast_composite_src_memcpy),
     PIXMAN_STD_FAST_PATH (SRC, a1r5g5b5, null, x1r5g5b5, fast_composite_src_memcpy),
     PIXMAN_STD_FAST_PATH (SRC, a8, null, a8, fast_composite_src_memcpy),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16, a16b16g16r16, fast_composite_src_memcpy),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16, x16b16g16r16, fast_composite_src_memcpy),
+    PIXMAN_WIDE_FAST_PATH (SRC, x16b16g16r16, x16b16g16r16, fast_composite_src_memcpy),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16_float, a16b16g16r16_float, fast_composite_src_memcpy),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16, a8r8g8b8, fast_composite_src_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16, x8r8g8b8, fast_composite_src_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, x16b16g16r16, a8r8g8b8, fast_composite_src_x16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, x16b16g16r16, x8r8g8b8, fast_composite_src_x16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16_float, a8r8g8b8, fast_composite_src_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16_float, x8r8g8b8, fast_composite_src_f16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, a16b16g16r16, fast_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, a16b16g16r16, fast_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, x16b16g16r16, fast_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, x16b16g16r16, fast_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, a16b16g16r16_float, fast_composite_src_8888_f16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, a16b16g16r16_float, fast_composite_src_8888_f16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8_sRGB, a8r8g8b8_sRGB, fast_composite_src_memcpy),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8_sRGB, a8r8g8b8, fast_composite_src_srgb_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8_sRGB, x8r8g8b8, fast_composite_src_srgb_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8_sRGB, fast_composite_src_8888_srgb),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, a8r8g8b8_sRGB, fast_composite_src_x888_srgb),
     PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, r5g6b5, fast_composite_src_x888_0565),
     PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, r5g6b5, fast_composite_src_x888_0565),
     PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, b5g6r5, fast_composite_src_x888_0565),
     PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, b5g6r5, fast_composite_src_x888_0565),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, null, r5g6b5, fast_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, null, r5g6b5, fast_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, null, b5g6r5, fast_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, null, b5g6r5, fast_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, null, r5g6b5, fast_composite_over_8888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, null, b5g6r5, fast_composite_over_8888_0565_dither),
     PIXMAN_STD_FAST_PATH (IN, a8, null, a8, fast_composite_in_8_8),
     PIXMAN_STD_FAST_PATH (IN, solid, a8, a8, fast_composite_in_n_8_8),
 
@@ -1947,6 +2481,9 @@ static const pixman_fast_path_t c_fast_paths[] =
 
     SIMPLE_NEAREST_FAST_PATH (OVER, a8r8g8b8, r5g6b5, 8888_565),
 
+    YUV_FAST_PATHS (x8r8g8b8, yuv_8888),
+    YUV_FAST_PATHS (a8r8g8b8, yuv_8888),
+
 #define NEAREST_FAST_PATH(op,s,d)		\
     {   PIXMAN_OP_ ## op,			\
 	PIXMAN_ ## s, SCALED_NEAREST_FLAGS,	\
@@ -2199,12 +2736,184 @@ fast_path_fill (pixman_implementation_t *imp,
     return TRUE;
 }
 
+/* Glyph runs, see pixman-glyph.c. Each box is composited exactly like
+ * fast_composite_over_n_8_8888 or fast_composite_over_n_8888_8888_ca
+ * would composite it.
+ */
+static pixman_bool_t
+fast_path_glyphs (pixman_implementation_t  *imp,
+                  pixman_op_t               op,
+                  uint32_t                  src,
+                  int                       dest_stride,
+                  const pixman_glyph_box_t *boxes,
+                  int                       n_boxes)
+{
+    uint32_t srca = src >> 24;
+    int i, w, h;
+
+    if (op != PIXMAN_OP_OVER)
+	return FALSE;
+
+    if (src == 0)
+	return TRUE;
+
+    for (i = 0; i < n_boxes; ++i)
+    {
+	const pixman_glyph_box_t *box = &boxes[i];
+	const uint8_t *mask_line = box->mask;
+	uint32_t *dst_line = box->dest;
+
+	for (h = box->height; h--; )
+	{
+	    uint32_t *dst = dst_line;
+
+	    if (box->component_alpha)
+	    {
+		const uint32_t *mask = (const uint32_t *)mask_line;
+
+		for (w = box->width; w--; dst++)
+		{
+		    uint32_t ma = *mask++;
+
+		    if (ma == 0xffffffff)
+		    {
+			*dst = (srca == 0xff) ? src : over (src, *dst);
+		    }
+		    else if (ma)
+		    {
+			uint32_t d = *dst, s = src;
+
+			UN8x4_MUL_UN8x4 (s, ma);
+			UN8x4_MUL_UN8 (ma, srca);
+			ma = ~ma;
+			UN8x4_MUL_UN8x4_ADD_UN8x4 (d, ma, s);
+
+			*dst = d;
+		    }
+		}
+	    }
+	    else
+	    {
+		const uint8_t *mask = mask_line;
+
+		for (w = box->width; w--; dst++)
+		{
+		    uint32_t m = *mask++;
+
+		    if (m == 0xff)
+			*dst = (srca == 0xff) ? src : over (src, *dst);
+		    else if (m)
+			*dst = over (in (src, m), *dst);
+		}
+	    }
+
+	    mask_line += box->mask_stride;
+	    dst_line += dest_stride;
+	}
+    }
+
+    return TRUE;
+}
+
+/* The passes of the separable convolution scaler, see pixman-bits-image.c.
+ * These define the results that the SIMD versions must reproduce.
+ */
+static void
+fast_convolve_row (int16_t *        dst,
+		   const uint32_t * src,
+		   const int32_t *  offsets,
+		   const int16_t ** weights,
+		   int              n_taps,
+		   int              width)
+{
+    int k, i, c;
+
+    for (k = 0; k < width; ++k)
+    {
+	const uint32_t *s = src + offsets[k];
+	const int16_t *w = weights[k];
+	int32_t sum[4] = { 0, 0, 0, 0 };
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    for (c = 0; c < 4; ++c)
+	    {
+		sum[c] += (int32_t)((s[i] >> (c * 8)) & 0xff) * w[0];
+		sum[c] += (int32_t)((s[i + 1] >> (c * 8)) & 0xff) * w[1];
+	    }
+
+	    w += 8;
+	}
+
+	for (c = 0; c < 4; ++c)
+	{
+	    int32_t v = (sum[c] + 0x80) >> 8;
+
+	    *dst++ = CLIP (v, INT16_MIN, INT16_MAX);
+	}
+    }
+}
+
+static void
+fast_convolve_column (uint32_t *       dst,
+		      const int16_t ** rows,
+		      const int16_t *  weights,
+		      int              n_taps,
+		      int              width)
+{
+    int k, i, c;
+
+    for (k = 0; k < width; ++k)
+    {
+	uint32_t pixel = 0;
+
+	for (c = 0; c < 4; ++c)
+	{
+	    const int16_t *w = weights;
+	    int32_t sum = 0, v;
+
+	    for (i = 0; i < n_taps; i += 2)
+	    {
+		sum += rows[i][k * 4 + c] * w[0];
+		sum += rows[i + 1][k * 4 + c] * w[1];
+
+		w += 8;
+	    }
+
+	    v = (sum + (1 << 19)) >> 20;
+
+	    pixel |= (uint32_t)CLIP (v, 0, 0xff) << (c * 8);
+	}
+
+	dst[k] = pixel;
+    }
+}
+
+static void
+fast_separable_scaler_init (pixman_iter_t *iter, const pixman_iter_info_t *info)
+{
+    _pixman_separable_scaler_iter_init (
+	iter, fast_convolve_row, fast_convolve_column);
+}
+
+static const pixman_iter_info_t fast_iters[] =
+{
+    { PIXMAN_any, FAST_PATH_SEPARABLE_SCALE_FLAGS, ITER_NARROW | ITER_SRC,
+      fast_separable_scaler_init, NULL, NULL
+    },
+    { PIXMAN_null },
+};
+
 pixman_implementation_t *
 _pixman_implementation_create_fast_path (pixman_implementation_t *fallback)
 {
     pixman_implementation_t *imp = _pixman_implementation_create (fallback, c_fast_paths);
 
+    imp->name = "fast";
+
     imp->fill = fast_path_fill;
+    imp->glyphs = fast_path_glyphs;
+    imp->iter_info = fast_iters;
 
     return imp;
 }
@@ -215,25 +215,23 @@ integral (pixman_kernel_t kernel1, double x1,
     }
 }
 
-static pixman_fixed_t *
-create_1d_filter (int             *width,
-		  pixman_kernel_t  reconstruct,
-		  pixman_kernel_t  sample,
-		  double           scale,
-		  int              n_phases)
+static int
+filter_width (pixman_kernel_t reconstruct, pixman_kernel_t sample, double scale)
+{
+    return ceil (scale * filters[sample].width + filters[reconstruct].width);
+}
+
+static void
+compute_1d_filter (pixman_fixed_t  *p,
+		   int              width,
+		   pixman_kernel_t  reconstruct,
+		   pixman_kernel_t  sample,
+		   double           scale,
+		   int              n_phases)
 {
-    pixman_fixed_t *params, *p;
     double step;
-    double size;
     int i;
 
-    size = scale * filters[sample].width + filters[reconstruct].width;
-    *width = ceil (size);
-
-    p = params = malloc (*width * n_phases * sizeof (pixman_fixed_t));
-    if (!params)
-        return NULL;
-
     step = 1.0 / n_phases;
 
     for (i = 0; i < n_phases; ++i)
@@ -248,8 +246,8 @@ create_1d_filter (int             *width,
 	 * and sample positions.
 	 */
 
-	x1 = ceil (frac - *width / 2.0 - 0.5);
-        x2 = x1 + *width;
+	x1 = ceil (frac - width / 2.0 - 0.5);
+        x2 = x1 + width;
 
 	total = 0;
         for (x = x1; x < x2; ++x)
@@ -277,7 +275,7 @@ create_1d_filter (int             *width,
         }
 
 	/* Normalize */
-	p -= *width;
+	p -= width;
         total = 1 / total;
         new_total = 0;
 	for (x = x1; x < x2; ++x)
@@ -288,9 +286,248 @@ create_1d_filter (int             *width,
 	    *p++ = t;
 	}
 
-	if (new_total != pixman_fixed_1)
-	    *(p - *width / 2) += (pixman_fixed_1 - new_total);
+	/* Put the rounding error on a tap near the middle. A filter
+	 * of width 1 has only the one tap, and IMPULSE sampling of an
+	 * IMPULSE has none.
+	 */
+	if (width && new_total != pixman_fixed_1)
+	    *(p - MAX (width / 2, 1)) += (pixman_fixed_1 - new_total);
     }
+}
+
+/* Computing a filter integrates the kernels numerically for every
+ * tap, which can cost more than the resize it is used for, and
+ * callers tend to ask for the same few filters over and over. So
+ * the filters computed most recently are kept, with their values on
+ * the heap. The cache is shared by all threads and takes at most
+ * KERNEL_CACHE_SIZE bytes; the least recently used filters are freed
+ * to make room for new ones. Filters are computed without holding the
+ * lock.
+ */
+#define N_CACHED_KERNELS	8
+#define KERNEL_CACHE_SIZE	(64 * 1024)
+
+typedef struct
+{
+    uint32_t		stamp;		/* 0 if the entry is unused */
+    pixman_kernel_t	reconstruct;
+    pixman_kernel_t	sample;
+    double		scale;
+    int			n_phases;
+    int			n_values;
+    pixman_fixed_t *	values;
+} cached_kernel_t;
+
+typedef struct
+{
+    pixman_spinlock_t	lock;
+    uint32_t		clock;
+    size_t		size;
+    uint32_t		n_hits;
+    cached_kernel_t	kernels[N_CACHED_KERNELS];
+} kernel_cache_t;
+
+static kernel_cache_t kernel_cache;
+
+static void
+free_cached_kernel (kernel_cache_t *cache, cached_kernel_t *k)
+{
+    cache->size -= k->n_values * sizeof (pixman_fixed_t);
+    free (k->values);
+
+    k->stamp = 0;
+    k->values = NULL;
+}
+
+static cached_kernel_t *
+least_recently_used (kernel_cache_t *cache, pixman_bool_t used_only)
+{
+    cached_kernel_t *oldest = NULL;
+    int i;
+
+    for (i = 0; i < N_CACHED_KERNELS; ++i)
+    {
+	cached_kernel_t *k = &cache->kernels[i];
+
+	if (used_only && !k->stamp)
+	    continue;
+
+	if (!oldest || k->stamp < oldest->stamp)
+	    oldest = k;
+    }
+
+    return oldest;
+}
+
+/* Looks the filter up and copies its values to p. The cache must be
+ * locked.
+ */
+static pixman_bool_t
+lookup_kernel (kernel_cache_t  *cache,
+	       pixman_fixed_t  *p,
+	       pixman_kernel_t  reconstruct,
+	       pixman_kernel_t  sample,
+	       double           scale,
+	       int              n_phases,
+	       int              n_values)
+{
+    int i;
+
+    if (++cache->clock == 0)
+    {
+	/* Don't let the stamps wrap around */
+	for (i = 0; i < N_CACHED_KERNELS; ++i)
+	{
+	    if (cache->kernels[i].stamp)
+		cache->kernels[i].stamp = 1;
+	}
+
+	cache->clock = 2;
+    }
+
+    for (i = 0; i < N_CACHED_KERNELS; ++i)
+    {
+	cached_kernel_t *k = &cache->kernels[i];
+
+	if (k->stamp			&&
+	    k->reconstruct == reconstruct	&&
+	    k->sample == sample		&&
+	    k->scale == scale		&&
+	    k->n_phases == n_phases	&&
+	    k->n_values == n_values)
+	{
+	    k->stamp = cache->clock;
+	    cache->n_hits++;
+	    memcpy (p, k->values, n_values * sizeof (pixman_fixed_t));
+	    return TRUE;
+	}
+    }
+
+    return FALSE;
+}
+
+static void
+get_1d_filter (pixman_fixed_t  *p,
+	       int              width,
+	       pixman_kernel_t  reconstruct,
+	       pixman_kernel_t  sample,
+	       double           scale,
+	       int              n_phases)
+{
+    kernel_cache_t *cache = &kernel_cache;
+    int n_values = width * n_phases;
+    size_t size = n_values * sizeof (pixman_fixed_t);
+    cached_kernel_t *entry;
+    pixman_fixed_t *values;
+    pixman_bool_t found;
+
+    if (size > KERNEL_CACHE_SIZE)
+    {
+	compute_1d_filter (p, width, reconstruct, sample, scale, n_phases);
+	return;
+    }
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    found = lookup_kernel (
+	cache, p, reconstruct, sample, scale, n_phases, n_values);
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
+
+    if (found)
+	return;
+
+    compute_1d_filter (p, width, reconstruct, sample, scale, n_phases);
+
+    if (!(values = malloc (size)))
+	return;
+
+    memcpy (values, p, size);
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+
+    /* Another thread may have added the filter in the meantime */
+    if (lookup_kernel (cache, p, reconstruct, sample, scale, n_phases, n_values))
+    {
+	PIXMAN_SPIN_UNLOCK (&cache->lock);
+	free (values);
+	return;
+    }
+
+    /* Make room for the new filter */
+    entry = least_recently_used (cache, FALSE);
+    if (entry->stamp)
+	free_cached_kernel (cache, entry);
+
+    while (cache->size + size > KERNEL_CACHE_SIZE)
+	free_cached_kernel (cache, least_recently_used (cache, TRUE));
+
+    entry->stamp = cache->clock;
+    entry->reconstruct = reconstruct;
+    entry->sample = sample;
+    entry->scale = scale;
+    entry->n_phases = n_phases;
+    entry->n_values = n_values;
+    entry->values = values;
+    cache->size += size;
+
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
+}
+
+/* This function is exported for the sake of the test suite and not part
+ * of the ABI.
+ */
+PIXMAN_EXPORT uint32_t
+_pixman_internal_only_get_kernel_cache_hits (void)
+{
+    uint32_t n_hits;
+
+    PIXMAN_SPIN_LOCK (&kernel_cache.lock);
+    n_hits = kernel_cache.n_hits;
+    PIXMAN_SPIN_UNLOCK (&kernel_cache.lock);
+
+    return n_hits;
+}
+
+static pixman_fixed_t *
+create_separable_convolution (int             *n_values,
+			      int              extra,
+			      pixman_fixed_t   scale_x,
+			      pixman_fixed_t   scale_y,
+			      pixman_kernel_t  reconstruct_x,
+			      pixman_kernel_t  reconstruct_y,
+			      pixman_kernel_t  sample_x,
+			      pixman_kernel_t  sample_y,
+			      int              subsample_bits_x,
+			      int              subsample_bits_y)
+{
+    double sx = fabs (pixman_fixed_to_double (scale_x));
+    double sy = fabs (pixman_fixed_to_double (scale_y));
+    pixman_fixed_t *params;
+    int subsample_x, subsample_y;
+    int width, height;
+
+    subsample_x = (1 << subsample_bits_x);
+    subsample_y = (1 << subsample_bits_y);
+
+    width = filter_width (reconstruct_x, sample_x, sx);
+    height = filter_width (reconstruct_y, sample_y, sy);
+
+    *n_values = 4 + width * subsample_x + height * subsample_y;
+
+    params = malloc (extra + *n_values * sizeof (pixman_fixed_t));
+    if (!params)
+        return NULL;
+
+    params = (pixman_fixed_t *)((uint8_t *)params + extra);
+
+    params[0] = pixman_int_to_fixed (width);
+    params[1] = pixman_int_to_fixed (height);
+    params[2] = pixman_int_to_fixed (subsample_bits_x);
+    params[3] = pixman_int_to_fixed (subsample_bits_y);
+
+    get_1d_filter (params + 4, width,
+		   reconstruct_x, sample_x, sx, subsample_x);
+    get_1d_filter (params + 4 + width * subsample_x, height,
+		   reconstruct_y, sample_y, sy, subsample_y);
 
     return params;
 }
@@ -309,40 +546,82 @@ pixman_filter_create_separable_convolution (int             *n_values,
 					    int              subsample_bits_x,
 					    int	             subsample_bits_y)
 {
-    double sx = fabs (pixman_fixed_to_double (scale_x));
-    double sy = fabs (pixman_fixed_to_double (scale_y));
-    pixman_fixed_t *horz = NULL, *vert = NULL, *params = NULL;
-    int subsample_x, subsample_y;
-    int width, height;
+    return create_separable_convolution (
+	n_values, 0, scale_x, scale_y, reconstruct_x, reconstruct_y,
+	sample_x, sample_y, subsample_bits_x, subsample_bits_y);
+}
 
-    subsample_x = (1 << subsample_bits_x);
-    subsample_y = (1 << subsample_bits_y);
+/* A SEPARABLE_CONVOLUTION filter that can be set on any number of
+ * images. The parameters are stored right after the struct.
+ */
+struct pixman_separable_filter_t
+{
+    int32_t		ref_count;
+    int			n_params;
+    pixman_fixed_t *	params;
+};
 
-    horz = create_1d_filter (&width, reconstruct_x, sample_x, sx, subsample_x);
-    vert = create_1d_filter (&height, reconstruct_y, sample_y, sy, subsample_y);
+/* Keep the parameters aligned after the struct */
+typedef int separable_filter_alignment_assertion[
+    sizeof (struct pixman_separable_filter_t) % sizeof (pixman_fixed_t) == 0 ? 1 : -1];
+
+PIXMAN_EXPORT pixman_separable_filter_t *
+pixman_separable_filter_create (pixman_fixed_t   scale_x,
+				pixman_fixed_t   scale_y,
+				pixman_kernel_t  reconstruct_x,
+				pixman_kernel_t  reconstruct_y,
+				pixman_kernel_t  sample_x,
+				pixman_kernel_t  sample_y,
+				int              subsample_bits_x,
+				int              subsample_bits_y)
+{
+    pixman_separable_filter_t *filter;
+    pixman_fixed_t *params;
+    int n_params;
+
+    params = create_separable_convolution (
+	&n_params, sizeof (pixman_separable_filter_t),
+	scale_x, scale_y, reconstruct_x, reconstruct_y,
+	sample_x, sample_y, subsample_bits_x, subsample_bits_y);
 
-    if (!horz || !vert)
-        goto out;
-    
-    *n_values = 4 + width * subsample_x + height * subsample_y;
-    
-    params = malloc (*n_values * sizeof (pixman_fixed_t));
     if (!params)
-        goto out;
+	return NULL;
 
-    params[0] = pixman_int_to_fixed (width);
-    params[1] = pixman_int_to_fixed (height);
-    params[2] = pixman_int_to_fixed (subsample_bits_x);
-    params[3] = pixman_int_to_fixed (subsample_bits_y);
+    filter = (pixman_separable_filter_t *)params - 1;
+    filter->ref_count = 1;
+    filter->n_params = n_params;
+    filter->params = params;
+
+    return filter;
+}
 
-    memcpy (params + 4, horz,
-	    width * subsample_x * sizeof (pixman_fixed_t));
-    memcpy (params + 4 + width * subsample_x, vert,
-	    height * subsample_y * sizeof (pixman_fixed_t));
+PIXMAN_EXPORT pixman_separable_filter_t *
+pixman_separable_filter_ref (pixman_separable_filter_t *filter)
+{
+    filter->ref_count++;
 
-out:
-    free (horz);
-    free (vert);
+    return filter;
+}
 
-    return params;
+/* returns TRUE when the filter is freed */
+PIXMAN_EXPORT pixman_bool_t
+pixman_separable_filter_unref (pixman_separable_filter_t *filter)
+{
+    if (--filter->ref_count == 0)
+    {
+	free (filter);
+	return TRUE;
+    }
+
+    return FALSE;
+}
+
+PIXMAN_EXPORT const pixman_fixed_t *
+pixman_separable_filter_get_params (pixman_separable_filter_t *filter,
+				    int                       *n_params)
+{
+    if (n_params)
+	*n_params = filter->n_params;
+
+    return filter->params;
 }
@@ -37,44 +37,41 @@
 #include <string.h>
 #include "pixman-private.h"
 
-static pixman_bool_t
-general_src_iter_init (pixman_implementation_t *imp, pixman_iter_t *iter)
+static void
+general_iter_init (pixman_iter_t *iter, const pixman_iter_info_t *info)
 {
     pixman_image_t *image = iter->image;
 
-    if (image->type == LINEAR)
-	_pixman_linear_gradient_iter_init (image, iter);
-    else if (image->type == RADIAL)
-	_pixman_radial_gradient_iter_init (image, iter);
-    else if (image->type == CONICAL)
-	_pixman_conical_gradient_iter_init (image, iter);
-    else if (image->type == BITS)
-	_pixman_bits_image_src_iter_init (image, iter);
-    else if (image->type == SOLID)
-        _pixman_log_error (FUNC, "Solid image not handled by noop");
-    else         
-	_pixman_log_error (FUNC, "Pixman bug: unknown image type\n");
-
-    return TRUE;
-}
-
-static pixman_bool_t
-general_dest_iter_init (pixman_implementation_t *imp, pixman_iter_t *iter)
-{
-    if (iter->image->type == BITS)
+    if ((iter->iter_flags & ITER_SRC) == ITER_SRC)
     {
-	_pixman_bits_image_dest_iter_init (iter->image, iter);
-
-	return TRUE;
+	if (image->type == LINEAR)
+	    _pixman_linear_gradient_iter_init (image, iter);
+	else if (image->type == RADIAL)
+	    _pixman_radial_gradient_iter_init (image, iter);
+	else if (image->type == CONICAL)
+	    _pixman_conical_gradient_iter_init (image, iter);
+	else if (image->type == BITS)
+	    _pixman_bits_image_src_iter_init (image, iter);
+	else if (image->type == SOLID)
+	    _pixman_log_error (FUNC, "Solid image not handled by noop");
+	else         
+	    _pixman_log_error (FUNC, "Pixman bug: unknown image type\n");
     }
     else
     {
-	_pixman_log_error (FUNC, "Trying to write to a non-writable image");
-
-	return FALSE;
+	if (image->type == BITS)
+	    _pixman_bits_image_dest_iter_init (image, iter);
+	else
+	    _pixman_log_error (FUNC, "Trying to write to a non-writable image");
     }
 }
 
+static const pixman_iter_info_t general_iters[] =
+{
+    { PIXMAN_any, 0, 0, general_iter_init, NULL, NULL },
+    { PIXMAN_null },
+};
+
 typedef struct op_info_t op_info_t;
 struct op_info_t
 {
@@ -105,6 +102,90 @@ static const op_info_t op_flags[PIXMAN_N_OPERATORS] =
 
 #define SCANLINE_BUFFER_LENGTH 8192
 
+/* When the source or the mask is rotated, every destination scanline
+ * samples a line that runs diagonally across the image, so compositing
+ * full-width scanlines one after the other touches new cache lines all
+ * the time. In that case the destination is processed in tiles, so that
+ * consecutive scanlines sample neighbouring parts of the image.
+ *
+ * This gives exactly the same results, because for affine transformations
+ * the fetchers (including the bilinear and nearest affine ones) compute
+ * the position of the first pixel of each span from the transformation
+ * and then step by a whole destination pixel at a time.
+ */
+#define TILE_WIDTH	64
+#define TILE_HEIGHT	64
+
+static pixman_bool_t
+is_rotated (pixman_image_t *image, uint32_t flags)
+{
+    return
+	image					&&
+	image->common.type == BITS		&&
+	(flags & FAST_PATH_AFFINE_TRANSFORM)	&&
+	!(flags & FAST_PATH_SCALE_TRANSFORM);
+}
+
+typedef struct
+{
+    pixman_combine_32_func_t	compose;
+    iter_flags_t		src_iter_flags;
+    iter_flags_t		mask_iter_flags;
+    iter_flags_t		dest_iter_flags;
+    uint8_t *			src_buffer;
+    uint8_t *			mask_buffer;
+    uint8_t *			dest_buffer;
+} general_state_t;
+
+static void
+general_composite_tile (pixman_implementation_t *imp,
+			pixman_composite_info_t *info,
+			pixman_image_t          *mask_image,
+			const general_state_t   *state,
+			int                      x,
+			int                      y,
+			int                      width,
+			int                      height)
+{
+    pixman_iter_t src_iter, mask_iter, dest_iter;
+    int i;
+
+    _pixman_implementation_iter_init (
+	imp->toplevel, &src_iter, info->src_image,
+	info->src_x + x, info->src_y + y, width, height,
+	state->src_buffer, state->src_iter_flags, info->src_flags);
+
+    _pixman_implementation_iter_init (
+	imp->toplevel, &mask_iter, mask_image,
+	info->mask_x + x, info->mask_y + y, width, height,
+	state->mask_buffer, state->mask_iter_flags, info->mask_flags);
+
+    _pixman_implementation_iter_init (
+	imp->toplevel, &dest_iter, info->dest_image,
+	info->dest_x + x, info->dest_y + y, width, height,
+	state->dest_buffer, state->dest_iter_flags, info->dest_flags);
+
+    for (i = 0; i < height; ++i)
+    {
+	uint32_t *s, *m, *d;
+
+	m = mask_iter.get_scanline (&mask_iter, NULL);
+	s = src_iter.get_scanline (&src_iter, m);
+	d = dest_iter.get_scanline (&dest_iter, NULL);
+
+	state->compose (imp->toplevel, info->op, d, s, m, width);
+
+	dest_iter.write_back (&dest_iter);
+    }
+
+    if (src_iter.fini)
+	src_iter.fini (&src_iter);
+    if (mask_iter.fini)
+	mask_iter.fini (&mask_iter);
+    if (dest_iter.fini)
+	dest_iter.fini (&dest_iter);
+}
+
 static void
 general_composite_rect  (pixman_implementation_t *imp,
                          pixman_composite_info_t *info)
@@ -112,56 +193,34 @@ general_composite_rect  (pixman_implementation_t *imp,
     PIXMAN_COMPOSITE_ARGS (info);
     uint64_t stack_scanline_buffer[(SCANLINE_BUFFER_LENGTH * 3 + 7) / 8];
     uint8_t *scanline_buffer = (uint8_t *) stack_scanline_buffer;
-    uint8_t *src_buffer, *mask_buffer, *dest_buffer;
-    pixman_iter_t src_iter, mask_iter, dest_iter;
-    pixman_combine_32_func_t compose;
+    general_state_t state;
     pixman_bool_t component_alpha;
-    iter_flags_t narrow, src_iter_flags;
+    iter_flags_t width_flag;
+    pixman_bool_t narrow;
+    int tile_width, tile_height;
     int Bpp;
-    int i;
+    int x, y;
 
     if ((src_image->common.flags & FAST_PATH_NARROW_FORMAT)		    &&
 	(!mask_image || mask_image->common.flags & FAST_PATH_NARROW_FORMAT) &&
 	(dest_image->common.flags & FAST_PATH_NARROW_FORMAT))
     {
-	narrow = ITER_NARROW;
+	narrow = TRUE;
+	width_flag = ITER_NARROW;
 	Bpp = 4;
     }
     else
     {
-	narrow = 0;
+	narrow = FALSE;
+	width_flag = ITER_WIDE;
 	Bpp = 16;
     }
 
-    if (width * Bpp > SCANLINE_BUFFER_LENGTH)
-    {
-	scanline_buffer = pixman_malloc_abc (width, 3, Bpp);
-
-	if (!scanline_buffer)
-	    return;
-    }
-
-    src_buffer = scanline_buffer;
-    mask_buffer = src_buffer + width * Bpp;
-    dest_buffer = mask_buffer + width * Bpp;
-
-    if (!narrow)
-    {
-	/* To make sure there aren't any NANs in the buffers */
-	memset (src_buffer, 0, width * Bpp);
-	memset (mask_buffer, 0, width * Bpp);
-	memset (dest_buffer, 0, width * Bpp);
-    }
-    
     /* src iter */
-    src_iter_flags = narrow | op_flags[op].src;
-
-    _pixman_implementation_src_iter_init (imp->toplevel, &src_iter, src_image,
-					  src_x, src_y, width, height,
-					  src_buffer, src_iter_flags, info->src_flags);
+    state.src_iter_flags = width_flag | op_flags[op].src | ITER_SRC;
 
     /* mask iter */
-    if ((src_iter_flags & (ITER_IGNORE_ALPHA | ITER_IGNORE_RGB)) ==
+    if ((state.src_iter_flags & (ITER_IGNORE_ALPHA | ITER_IGNORE_RGB)) ==
 	(ITER_IGNORE_ALPHA | ITER_IGNORE_RGB))
     {
 	/* If it doesn't matter what the source is, then it doesn't matter
@@ -169,6 +228,13 @@ general_composite_rect  (pixman_implementation_t *imp,
 	 */
 	mask_image = NULL;
     }
+    else if (info->mask_flags & FAST_PATH_IS_OPAQUE)
+    {
+	/* An opaque mask has no effect; pixman_image_composite32() looks
+	 * these up as PIXMAN_null, and only passes on the opaque flag.
+	 */
+	mask_image = NULL;
+    }
 
     component_alpha =
         mask_image			      &&
@@ -176,32 +242,59 @@ general_composite_rect  (pixman_implementation_t *imp,
         mask_image->common.component_alpha    &&
         PIXMAN_FORMAT_RGB (mask_image->bits.format);
 
-    _pixman_implementation_src_iter_init (
-	imp->toplevel, &mask_iter, mask_image, mask_x, mask_y, width, height,
-	mask_buffer, narrow | (component_alpha? 0 : ITER_IGNORE_RGB), info->mask_flags);
+    state.mask_iter_flags =
+	width_flag | ITER_SRC | (component_alpha? 0 : ITER_IGNORE_RGB);
 
     /* dest iter */
-    _pixman_implementation_dest_iter_init (
-	imp->toplevel, &dest_iter, dest_image, dest_x, dest_y, width, height,
-	dest_buffer, narrow | op_flags[op].dst, info->dest_flags);
+    state.dest_iter_flags = width_flag | op_flags[op].dst | ITER_DEST;
 
-    compose = _pixman_implementation_lookup_combiner (
+    state.compose = _pixman_implementation_lookup_combiner (
 	imp->toplevel, op, component_alpha, narrow);
 
-    if (!compose)
+    if (!state.compose)
 	return;
 
-    for (i = 0; i < height; ++i)
+    tile_width = width;
+    tile_height = height;
+
+    if (width > TILE_WIDTH &&
+	(is_rotated (src_image, info->src_flags) ||
+	 is_rotated (mask_image, info->mask_flags)))
     {
-	uint32_t *s, *m, *d;
+	tile_width = TILE_WIDTH;
+	tile_height = TILE_HEIGHT;
+    }
 
-	m = mask_iter.get_scanline (&mask_iter, NULL);
-	s = src_iter.get_scanline (&src_iter, m);
-	d = dest_iter.get_scanline (&dest_iter, NULL);
+    if (tile_width * Bpp > SCANLINE_BUFFER_LENGTH)
+    {
+	scanline_buffer = pixman_malloc_abc (tile_width, 3, Bpp);
 
-	compose (imp->toplevel, op, d, s, m, width);
+	if (!scanline_buffer)
+	    return;
+    }
 
-	dest_iter.write_back (&dest_iter);
+    state.src_buffer = scanline_buffer;
+    state.mask_buffer = state.src_buffer + tile_width * Bpp;
+    state.dest_buffer = state.mask_buffer + tile_width * Bpp;
+
+    if (!narrow)
+    {
+	/* To make sure there aren't any NANs in the buffers */
+	memset (state.src_buffer, 0, tile_width * Bpp);
+	memset (state.mask_buffer, 0, tile_width * Bpp);
+	memset (state.dest_buffer, 0, tile_width * Bpp);
+    }
+
+    for (y = 0; y < height; y += tile_height)
+    {
+	int h = MIN (tile_height, height - y);
+
+	for (x = 0; x < width; x += tile_width)
+	{
+	    int w = MIN (tile_width, width - x);
+
+	    general_composite_tile (imp, info, mask_image, &state, x, y, w, h);
+	}
     }
 
     if (scanline_buffer != (uint8_t *) stack_scanline_buffer)
@@ -219,11 +312,12 @@ _pixman_implementation_create_general (void)
 {
     pixman_implementation_t *imp = _pixman_implementation_create (NULL, general_fast_path);
 
+    imp->name = "general";
+
     _pixman_setup_combiner_functions_32 (imp);
     _pixman_setup_combiner_functions_float (imp);
 
-    imp->src_iter_init = general_src_iter_init;
-    imp->dest_iter_init = general_dest_iter_init;
+    imp->iter_info = general_iters;
 
     return imp;
 }
@@ -33,47 +33,187 @@
 
 typedef struct glyph_metrics_t glyph_metrics_t;
 typedef struct glyph_t glyph_t;
+typedef struct glyph_shard_t glyph_shard_t;
+typedef struct atlas_shelf_t atlas_shelf_t;
+typedef struct atlas_page_t atlas_page_t;
 
 #define TOMBSTONE ((glyph_t *)0x1)
 
-/* XXX: These numbers are arbitrary---we've never done any measurements.
+/* Glyphs are spread over the shards by hash. Each shard has a lock of
+ * its own and a table that grows as needed, so lookups from different
+ * threads rarely wait for each other.
  */
-#define N_GLYPHS_HIGH_WATER  (16384)
-#define N_GLYPHS_LOW_WATER   (8192)
-#define HASH_SIZE (2 * N_GLYPHS_HIGH_WATER)
-#define HASH_MASK (HASH_SIZE - 1)
+#define N_SHARDS		16
+#define SHARD_SHIFT		28
+#define MIN_TABLE_SIZE		64
+
+/* XXX: This number is arbitrary---we've never done any measurements.
+ */
+#define DEFAULT_BUDGET		(16 * 1024 * 1024)
+
+/* In atlas mode, glyphs of the same format share pages of this size.
+ * Glyph heights are rounded up to a multiple of ATLAS_SHELF_ROUND so
+ * that glyphs of similar heights can share a shelf. Larger glyphs get
+ * an image of their own.
+ */
+#define ATLAS_PAGE_SIZE		512
+#define ATLAS_SHELF_ROUND	4
+#define ATLAS_MAX_SHELVES	(ATLAS_PAGE_SIZE / ATLAS_SHELF_ROUND)
+#define ATLAS_MAX_GLYPH_SIZE	128
+#define ATLAS_ALIGN		64
+
+/* Glyphs can have variants for this many horizontal subpixel phases */
+#define MAX_PHASES		16
 
 struct glyph_t
 {
     void *		font_key;
     void *		glyph_key;
+    int			phase;		/* the subpixel variant */
+    unsigned int	hash;
+    pixman_bool_t	used;		/* looked up since the last eviction */
     int			origin_x;
     int			origin_y;
-    pixman_image_t *	image;
-    pixman_link_t	mru_link;
+    int			x;		/* position in image */
+    int			y;
+    int			width;
+    int			height;
+    pixman_image_t *	image;		/* the glyph's own image or its page */
+    atlas_page_t *	page;
+    pixman_link_t	page_link;
+    pixman_bool_t	retired;	/* evicted while the cache was frozen */
+    glyph_t *		next_removed;
 };
 
-struct pixman_glyph_cache_t
+struct glyph_shard_t
 {
+    pixman_spinlock_t	lock;
     int			n_glyphs;
     int			n_tombstones;
+    int			size;		/* a power of two, or 0 */
+    int			hand;		/* where eviction goes on */
+    uint64_t		n_hits;
+    uint64_t		n_misses;
+    glyph_t **		glyphs;
+};
+
+struct atlas_shelf_t
+{
+    int			y;
+    int			height;
+    int			x;		/* where the next glyph goes */
+};
+
+struct atlas_page_t
+{
+    pixman_format_code_t format;
+    pixman_image_t *	image;
+    int			n_glyphs;
+    pixman_bool_t	retired;	/* evicted while the cache was frozen */
+    int			top;		/* where the next shelf goes */
+    int			n_shelves;
+    atlas_shelf_t	shelves[ATLAS_MAX_SHELVES];
+    pixman_list_t	glyphs;
+    pixman_link_t	link;
+};
+
+/* The lock of the cache protects the freeze count, the atlas pages and
+ * the size. It is taken before the lock of a shard, never after.
+ */
+struct pixman_glyph_cache_t
+{
+    pixman_spinlock_t	lock;
     int			freeze_count;
-    pixman_list_t	mru;
-    glyph_t *		glyphs[HASH_SIZE];
+    pixman_bool_t	atlas;
+    uint64_t		budget;
+    uint64_t		size;		/* bytes of glyphs and pages in use */
+    uint64_t		n_evictions;
+    int			victim_shard;
+    int			n_phases;
+    pixman_glyph_render_func_t render;
+    void *		render_data;
+    glyph_t *		removed;	/* to be freed when thawed */
+    pixman_list_t	pages;
+    glyph_shard_t	shards[N_SHARDS];
 };
 
+static uint64_t
+image_size (pixman_image_t *image)
+{
+    return (uint64_t)image->bits.rowstride * sizeof (uint32_t) *
+	image->bits.height;
+}
+
 static void
-free_glyph (glyph_t *glyph)
+free_page (pixman_glyph_cache_t *cache,
+	   atlas_page_t         *page)
 {
-    pixman_list_unlink (&glyph->mru_link);
-    pixman_image_unref (glyph->image);
+    if (!page->retired)
+    {
+	cache->size -= image_size (page->image);
+	pixman_list_unlink (&page->link);
+    }
+
+    pixman_image_unref (page->image);
+    free (page);
+}
+
+/* The glyph must not be in a shard, and the cache must be locked */
+static void
+free_glyph (pixman_glyph_cache_t *cache,
+	    glyph_t              *glyph)
+{
+    atlas_page_t *page = glyph->page;
+
+    if (page)
+    {
+	if (!glyph->retired)
+	    pixman_list_unlink (&glyph->page_link);
+	if (--page->n_glyphs == 0)
+	    free_page (cache, page);
+    }
+    else
+    {
+	if (!glyph->retired)
+	    cache->size -= image_size (glyph->image);
+	pixman_image_unref (glyph->image);
+    }
+
     free (glyph);
 }
 
+/* Frees a glyph that was taken out of its shard. While the cache is
+ * frozen, other threads may still use the glyph, so instead it is
+ * retired: it no longer counts towards the size of the cache and is
+ * freed when the cache is thawed. The cache must be locked.
+ */
+static void
+release_glyph (pixman_glyph_cache_t *cache,
+	       glyph_t              *glyph)
+{
+    if (cache->freeze_count == 0)
+    {
+	free_glyph (cache, glyph);
+	return;
+    }
+
+    /* A glyph on a page keeps the page alive, but a page only counts
+     * towards the size until it is retired.
+     */
+    if (glyph->page)
+	pixman_list_unlink (&glyph->page_link);
+    else
+	cache->size -= image_size (glyph->image);
+
+    glyph->retired = TRUE;
+    glyph->next_removed = cache->removed;
+    cache->removed = glyph;
+}
+
 static unsigned int
-hash (const void *font_key, const void *glyph_key)
+hash (const void *font_key, const void *glyph_key, int phase)
 {
-    size_t key = (size_t)font_key + (size_t)glyph_key;
+    size_t key = (size_t)font_key + (size_t)glyph_key + (size_t)phase * 0x9e3779b9;
 
     /* This hash function is based on one found on Thomas Wang's
      * web page at
@@ -91,20 +231,31 @@ hash (const void *font_key, const void *glyph_key)
     return key;
 }
 
+static glyph_shard_t *
+get_shard (pixman_glyph_cache_t *cache, unsigned int h)
+{
+    return &cache->shards[(h >> SHARD_SHIFT) & (N_SHARDS - 1)];
+}
+
 static glyph_t *
-lookup_glyph (pixman_glyph_cache_t *cache,
-	      void                 *font_key,
-	      void                 *glyph_key)
+lookup_glyph (glyph_shard_t *shard,
+	      unsigned int   h,
+	      void          *font_key,
+	      void          *glyph_key,
+	      int            phase)
 {
-    unsigned idx;
+    unsigned idx = h;
     glyph_t *g;
 
-    idx = hash (font_key, glyph_key);
-    while ((g = cache->glyphs[idx++ & HASH_MASK]))
+    if (!shard->size)
+	return NULL;
+
+    while ((g = shard->glyphs[idx++ & (shard->size - 1)]))
     {
 	if (g != TOMBSTONE			&&
 	    g->font_key == font_key		&&
-	    g->glyph_key == glyph_key)
+	    g->glyph_key == glyph_key		&&
+	    g->phase == phase)
 	{
 	    return g;
 	}
@@ -114,72 +265,223 @@ lookup_glyph (pixman_glyph_cache_t *cache,
 }
 
 static void
-insert_glyph (pixman_glyph_cache_t *cache,
-	      glyph_t              *glyph)
+insert_glyph_unchecked (glyph_shard_t *shard,
+			glyph_t       *glyph)
 {
-    unsigned idx;
+    unsigned idx = glyph->hash;
     glyph_t **loc;
 
-    idx = hash (glyph->font_key, glyph->glyph_key);
-
-    /* Note: we assume that there is room in the table. If there isn't,
-     * this will be an infinite loop.
-     */
     do
     {
-	loc = &cache->glyphs[idx++ & HASH_MASK];
+	loc = &shard->glyphs[idx++ & (shard->size - 1)];
     } while (*loc && *loc != TOMBSTONE);
 
     if (*loc == TOMBSTONE)
-	cache->n_tombstones--;
-    cache->n_glyphs++;
+	shard->n_tombstones--;
+    shard->n_glyphs++;
 
     *loc = glyph;
 }
 
+/* Rehashes into a new table that is at most a quarter full, which also
+ * gets rid of the tombstones.
+ */
+static pixman_bool_t
+resize_table (glyph_shard_t *shard)
+{
+    glyph_t **old_glyphs = shard->glyphs;
+    int old_size = shard->size;
+    int size = MIN_TABLE_SIZE;
+    int i;
+
+    while (size < 4 * (shard->n_glyphs + 1))
+	size *= 2;
+
+    if (!(shard->glyphs = calloc (size, sizeof (glyph_t *))))
+    {
+	shard->glyphs = old_glyphs;
+	return FALSE;
+    }
+
+    shard->size = size;
+    shard->hand = 0;
+    shard->n_glyphs = 0;
+    shard->n_tombstones = 0;
+
+    for (i = 0; i < old_size; ++i)
+    {
+	if (old_glyphs[i] && old_glyphs[i] != TOMBSTONE)
+	    insert_glyph_unchecked (shard, old_glyphs[i]);
+    }
+
+    free (old_glyphs);
+
+    return TRUE;
+}
+
+static pixman_bool_t
+insert_glyph (glyph_shard_t *shard,
+	      glyph_t       *glyph)
+{
+    /* Keep at least half of the table empty */
+    if (2 * (shard->n_glyphs + shard->n_tombstones + 1) > shard->size)
+    {
+	if (!resize_table (shard))
+	    return FALSE;
+    }
+
+    insert_glyph_unchecked (shard, glyph);
+
+    return TRUE;
+}
+
 static void
-remove_glyph (pixman_glyph_cache_t *cache,
-	      glyph_t              *glyph)
+remove_glyph (glyph_shard_t *shard,
+	      glyph_t       *glyph)
 {
+    unsigned mask = shard->size - 1;
     unsigned idx;
 
-    idx = hash (glyph->font_key, glyph->glyph_key);
-    while (cache->glyphs[idx & HASH_MASK] != glyph)
+    idx = glyph->hash;
+    while (shard->glyphs[idx & mask] != glyph)
 	idx++;
 
-    cache->glyphs[idx & HASH_MASK] = TOMBSTONE;
-    cache->n_tombstones++;
-    cache->n_glyphs--;
+    shard->glyphs[idx & mask] = TOMBSTONE;
+    shard->n_tombstones++;
+    shard->n_glyphs--;
 
     /* Eliminate tombstones if possible */
-    if (cache->glyphs[(idx + 1) & HASH_MASK] == NULL)
+    if (shard->glyphs[(idx + 1) & mask] == NULL)
     {
-	while (cache->glyphs[idx & HASH_MASK] == TOMBSTONE)
+	while (shard->glyphs[idx & mask] == TOMBSTONE)
 	{
-	    cache->glyphs[idx & HASH_MASK] = NULL;
-	    cache->n_tombstones--;
+	    shard->glyphs[idx & mask] = NULL;
+	    shard->n_tombstones--;
 	    idx--;
 	}
     }
 }
 
-static void
-clear_table (pixman_glyph_cache_t *cache)
+/* Removes every glyph on the page, which frees the page. While the
+ * cache is frozen, the page is retired along with its glyphs, so no new
+ * glyphs go on it. The cache must be locked.
+ */
+static int
+evict_page (pixman_glyph_cache_t *cache,
+	    atlas_page_t         *page)
+{
+    pixman_bool_t last;
+    int n_glyphs = 0;
+
+    if (cache->freeze_count > 0)
+    {
+	cache->size -= image_size (page->image);
+	pixman_list_unlink (&page->link);
+	page->retired = TRUE;
+    }
+
+    /* Freeing the last glyph frees the page, so don't look at the page
+     * after that.
+     */
+    do
+    {
+	glyph_t *glyph = CONTAINER_OF (glyph_t, page_link, page->glyphs.head);
+	glyph_shard_t *shard = get_shard (cache, glyph->hash);
+
+	last = glyph->page_link.next == (pixman_link_t *)&page->glyphs;
+
+	PIXMAN_SPIN_LOCK (&shard->lock);
+	remove_glyph (shard, glyph);
+	PIXMAN_SPIN_UNLOCK (&shard->lock);
+
+	release_glyph (cache, glyph);
+	n_glyphs++;
+    } while (!last);
+
+    return n_glyphs;
+}
+
+/* The clock algorithm: glyphs that were looked up since the hand last
+ * passed them get another chance.
+ */
+static glyph_t *
+next_victim (glyph_shard_t *shard)
 {
     int i;
 
-    for (i = 0; i < HASH_SIZE; ++i)
+    for (i = 0; i < 2 * shard->size; ++i)
     {
-	glyph_t *glyph = cache->glyphs[i];
+	glyph_t *glyph = shard->glyphs[shard->hand];
+
+	shard->hand = (shard->hand + 1) & (shard->size - 1);
 
 	if (glyph && glyph != TOMBSTONE)
-	    free_glyph (glyph);
+	{
+	    if (!glyph->used)
+		return glyph;
 
-	cache->glyphs[i] = NULL;
+	    glyph->used = FALSE;
+	}
     }
 
-    cache->n_glyphs = 0;
-    cache->n_tombstones = 0;
+    return NULL;
+}
+
+/* Evicts glyphs, taking one from each shard in turn, until the cache is
+ * no bigger than target. Atlas pages go as a whole. The cache must be
+ * locked.
+ */
+static void
+evict (pixman_glyph_cache_t *cache, uint64_t target)
+{
+    int n_empty = 0;
+
+    while (cache->size > target && n_empty < N_SHARDS)
+    {
+	glyph_shard_t *shard = &cache->shards[cache->victim_shard];
+	glyph_t *glyph;
+
+	cache->victim_shard = (cache->victim_shard + 1) & (N_SHARDS - 1);
+
+	PIXMAN_SPIN_LOCK (&shard->lock);
+	if ((glyph = next_victim (shard)) && !glyph->page)
+	    remove_glyph (shard, glyph);
+	PIXMAN_SPIN_UNLOCK (&shard->lock);
+
+	if (!glyph)
+	{
+	    n_empty++;
+	    continue;
+	}
+
+	n_empty = 0;
+
+	if (glyph->page)
+	{
+	    cache->n_evictions += evict_page (cache, glyph->page);
+	}
+	else
+	{
+	    release_glyph (cache, glyph);
+	    cache->n_evictions++;
+	}
+    }
+}
+
+static int
+count_glyphs (pixman_glyph_cache_t *cache)
+{
+    int n_glyphs = 0;
+    int i;
+
+    for (i = 0; i < N_SHARDS; ++i)
+    {
+	PIXMAN_SPIN_LOCK (&cache->shards[i].lock);
+	n_glyphs += cache->shards[i].n_glyphs;
+	PIXMAN_SPIN_UNLOCK (&cache->shards[i].lock);
+    }
+
+    return n_glyphs;
 }
 
 PIXMAN_EXPORT pixman_glyph_cache_t *
@@ -187,15 +489,13 @@ pixman_glyph_cache_create (void)
 {
     pixman_glyph_cache_t *cache;
 
-    if (!(cache = malloc (sizeof *cache)))
+    if (!(cache = calloc (1, sizeof *cache)))
 	return NULL;
 
-    memset (cache->glyphs, 0, sizeof (cache->glyphs));
-    cache->n_glyphs = 0;
-    cache->n_tombstones = 0;
-    cache->freeze_count = 0;
+    cache->budget = DEFAULT_BUDGET;
+    cache->n_phases = 1;
 
-    pixman_list_init (&cache->mru);
+    pixman_list_init (&cache->pages);
 
     return cache;
 }
@@ -203,41 +503,139 @@ pixman_glyph_cache_create (void)
 PIXMAN_EXPORT void
 pixman_glyph_cache_destroy (pixman_glyph_cache_t *cache)
 {
+    int i, j;
+
     return_if_fail (cache->freeze_count == 0);
 
-    clear_table (cache);
+    for (i = 0; i < N_SHARDS; ++i)
+    {
+	glyph_shard_t *shard = &cache->shards[i];
+
+	for (j = 0; j < shard->size; ++j)
+	{
+	    glyph_t *glyph = shard->glyphs[j];
+
+	    if (glyph && glyph != TOMBSTONE)
+		free_glyph (cache, glyph);
+	}
+
+	free (shard->glyphs);
+    }
 
     free (cache);
 }
 
+/* In atlas mode, the cache packs glyphs of the same format into shared
+ * pages instead of giving each glyph an image of its own, and evicts a
+ * whole page at a time. This can only be changed while the cache is
+ * empty.
+ */
+PIXMAN_EXPORT void
+pixman_glyph_cache_set_atlas (pixman_glyph_cache_t *cache,
+			      pixman_bool_t         atlas)
+{
+    return_if_fail (count_glyphs (cache) == 0);
+
+    cache->atlas = !!atlas;
+}
+
+/* When the cache takes more than n_bytes of memory for the glyph images,
+ * glyphs that haven't been looked up recently are evicted until it takes
+ * no more than half of that. This is checked when glyphs are inserted and
+ * when the cache is thawed. Glyphs that are evicted while the cache is
+ * frozen don't count towards the size, but their memory is only freed
+ * when the cache is thawed.
+ */
+PIXMAN_EXPORT void
+pixman_glyph_cache_set_budget (pixman_glyph_cache_t *cache,
+			       uint64_t              n_bytes)
+{
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    cache->budget = n_bytes;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
+}
+
+PIXMAN_EXPORT void
+pixman_glyph_cache_get_stats (pixman_glyph_cache_t       *cache,
+			      pixman_glyph_cache_stats_t *stats)
+{
+    int i;
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    stats->size = cache->size;
+    stats->n_evictions = cache->n_evictions;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
+
+    stats->n_glyphs = 0;
+    stats->n_hits = 0;
+    stats->n_misses = 0;
+
+    for (i = 0; i < N_SHARDS; ++i)
+    {
+	glyph_shard_t *shard = &cache->shards[i];
+
+	PIXMAN_SPIN_LOCK (&shard->lock);
+	stats->n_glyphs += shard->n_glyphs;
+	stats->n_hits += shard->n_hits;
+	stats->n_misses += shard->n_misses;
+	PIXMAN_SPIN_UNLOCK (&shard->lock);
+    }
+}
+
+/* Glyphs that were looked up or inserted stay valid until the cache is
+ * thawed as often as it was frozen, by any number of threads.
+ */
 PIXMAN_EXPORT void
 pixman_glyph_cache_freeze (pixman_glyph_cache_t  *cache)
 {
+    PIXMAN_SPIN_LOCK (&cache->lock);
     cache->freeze_count++;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
 }
 
 PIXMAN_EXPORT void
 pixman_glyph_cache_thaw (pixman_glyph_cache_t  *cache)
 {
-    if (--cache->freeze_count == 0					&&
-	cache->n_glyphs + cache->n_tombstones > N_GLYPHS_HIGH_WATER)
-    {
-	if (cache->n_tombstones > N_GLYPHS_HIGH_WATER)
-	{
-	    /* More than half the entries are
-	     * tombstones. Just dump the whole table.
-	     */
-	    clear_table (cache);
-	}
+    PIXMAN_SPIN_LOCK (&cache->lock);
 
-	while (cache->n_glyphs > N_GLYPHS_LOW_WATER)
+    if (--cache->freeze_count == 0)
+    {
+	while (cache->removed)
 	{
-	    glyph_t *glyph = CONTAINER_OF (glyph_t, mru_link, cache->mru.tail);
+	    glyph_t *glyph = cache->removed;
 
-	    remove_glyph (cache, glyph);
-	    free_glyph (glyph);
+	    cache->removed = glyph->next_removed;
+	    free_glyph (cache, glyph);
 	}
+
+	if (cache->size > cache->budget)
+	    evict (cache, cache->budget / 2);
     }
+
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
+}
+
+/* Glyphs can have variants that are shifted right by a fraction of a
+ * pixel, for n_phases evenly spaced phases. pixman_glyph_resolve_fixed()
+ * picks the variants for glyphs at fixed point positions and, if they
+ * are not in the cache yet, calls render to make them. Without render,
+ * the cache makes them from phase 0 with a bilinear filter. This can
+ * only be changed while the cache is empty.
+ */
+PIXMAN_EXPORT void
+pixman_glyph_cache_set_subpixel (pixman_glyph_cache_t      *cache,
+				 int                        n_phases,
+				 pixman_glyph_render_func_t render,
+				 void                      *data)
+{
+    return_if_fail (count_glyphs (cache) == 0);
+    return_if_fail (n_phases >= 1 && n_phases <= MAX_PHASES);
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    cache->n_phases = n_phases;
+    cache->render = render;
+    cache->render_data = data;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
 }
 
 PIXMAN_EXPORT const void *
@@ -245,7 +643,191 @@ pixman_glyph_cache_lookup (pixman_glyph_cache_t  *cache,
 			   void                  *font_key,
 			   void                  *glyph_key)
 {
-    return lookup_glyph (cache, font_key, glyph_key);
+    return pixman_glyph_cache_lookup_phase (cache, font_key, glyph_key, 0);
+}
+
+PIXMAN_EXPORT const void *
+pixman_glyph_cache_lookup_phase (pixman_glyph_cache_t  *cache,
+				 void                  *font_key,
+				 void                  *glyph_key,
+				 int                    phase)
+{
+    unsigned int h = hash (font_key, glyph_key, phase);
+    glyph_shard_t *shard = get_shard (cache, h);
+    glyph_t *glyph;
+
+    PIXMAN_SPIN_LOCK (&shard->lock);
+
+    if ((glyph = lookup_glyph (shard, h, font_key, glyph_key, phase)))
+    {
+	glyph->used = TRUE;
+	shard->n_hits++;
+    }
+    else
+    {
+	shard->n_misses++;
+    }
+
+    PIXMAN_SPIN_UNLOCK (&shard->lock);
+
+    return glyph;
+}
+
+static void
+free_page_memory (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static atlas_page_t *
+create_page (pixman_format_code_t format)
+{
+    int stride = ATLAS_PAGE_SIZE * PIXMAN_FORMAT_BPP (format) / 8;
+    atlas_page_t *page;
+    uint8_t *memory;
+    uint32_t *bits;
+
+    if (!(page = malloc (sizeof *page)))
+	return NULL;
+
+    /* Rows start on a cache line */
+    stride = (stride + ATLAS_ALIGN - 1) & ~(ATLAS_ALIGN - 1);
+    if (!(memory = calloc (stride * ATLAS_PAGE_SIZE + ATLAS_ALIGN - 1, 1)))
+    {
+	free (page);
+	return NULL;
+    }
+
+    bits = (uint32_t *)(memory + ((ATLAS_ALIGN - (uintptr_t)memory) &
+				  (ATLAS_ALIGN - 1)));
+
+    if (!(page->image = pixman_image_create_bits (
+	      format, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, bits, stride)))
+    {
+	free (memory);
+	free (page);
+	return NULL;
+    }
+
+    pixman_image_set_destroy_function (page->image, free_page_memory, memory);
+
+    if (PIXMAN_FORMAT_A   (format) != 0	&&
+	PIXMAN_FORMAT_RGB (format) != 0)
+    {
+	pixman_image_set_component_alpha (page->image, TRUE);
+    }
+
+    _pixman_image_validate (page->image);
+
+    page->format = format;
+    page->n_glyphs = 0;
+    page->retired = FALSE;
+    page->top = 0;
+    page->n_shelves = 0;
+    pixman_list_init (&page->glyphs);
+
+    return page;
+}
+
+/* Glyphs start on a 32 bit boundary within the rows of a page */
+static int
+page_alignment (pixman_format_code_t format)
+{
+    int align = 1;
+
+    while ((align * PIXMAN_FORMAT_BPP (format)) & 31)
+	align <<= 1;
+
+    return align;
+}
+
+/* Finds room for a glyph on the lowest shelf that is tall enough, but
+ * not more than twice as tall as needed, or on a new shelf.
+ */
+static pixman_bool_t
+page_allocate (atlas_page_t *page, int width, int height, int *x, int *y)
+{
+    int align = page_alignment (page->format);
+    atlas_shelf_t *best = NULL;
+    int i;
+
+    width = (width + align - 1) & ~(align - 1);
+    height = (height + ATLAS_SHELF_ROUND - 1) & ~(ATLAS_SHELF_ROUND - 1);
+
+    for (i = 0; i < page->n_shelves; ++i)
+    {
+	atlas_shelf_t *shelf = &page->shelves[i];
+
+	if (shelf->height >= height			&&
+	    shelf->height <= 2 * height			&&
+	    shelf->x + width <= ATLAS_PAGE_SIZE		&&
+	    (!best || shelf->height < best->height))
+	{
+	    best = shelf;
+	}
+    }
+
+    if (!best)
+    {
+	if (page->top + height > ATLAS_PAGE_SIZE)
+	    return FALSE;
+
+	best = &page->shelves[page->n_shelves++];
+	best->y = page->top;
+	best->height = height;
+	best->x = 0;
+
+	page->top += height;
+    }
+
+    *x = best->x;
+    *y = best->y;
+
+    best->x += width;
+
+    return TRUE;
+}
+
+/* The cache must be locked */
+static pixman_bool_t
+atlas_insert (pixman_glyph_cache_t *cache, glyph_t *glyph,
+	      pixman_format_code_t format)
+{
+    atlas_page_t *page;
+    pixman_link_t *link;
+
+    for (link = cache->pages.head;
+	 link != (pixman_link_t *)&cache->pages;
+	 link = link->next)
+    {
+	page = CONTAINER_OF (atlas_page_t, link, link);
+
+	if (page->format == format &&
+	    page_allocate (page, glyph->width, glyph->height,
+			   &glyph->x, &glyph->y))
+	{
+	    goto found;
+	}
+    }
+
+    if (!(page = create_page (format)))
+	return FALSE;
+
+    pixman_list_prepend (&cache->pages, &page->link);
+    cache->size += image_size (page->image);
+
+    page_allocate (page, glyph->width, glyph->height, &glyph->x, &glyph->y);
+
+found:
+    glyph->page = page;
+    glyph->image = page->image;
+
+    /* The glyph keeps the page alive, but it only goes on the list of
+     * the page once it is in a shard, where eviction can find it.
+     */
+    page->n_glyphs++;
+
+    return TRUE;
 }
 
 PIXMAN_EXPORT const void *
@@ -256,63 +838,334 @@ pixman_glyph_cache_insert (pixman_glyph_cache_t  *cache,
 			   int                    origin_y,
 			   pixman_image_t        *image)
 {
-    glyph_t *glyph;
+    return pixman_glyph_cache_insert_phase (cache, font_key, glyph_key, 0,
+					    origin_x, origin_y, image);
+}
+
+PIXMAN_EXPORT const void *
+pixman_glyph_cache_insert_phase (pixman_glyph_cache_t  *cache,
+				 void                  *font_key,
+				 void                  *glyph_key,
+				 int                    phase,
+				 int			origin_x,
+				 int                    origin_y,
+				 pixman_image_t        *image)
+{
+    glyph_t *glyph, *existing;
+    glyph_shard_t *shard;
     int32_t width, height;
+    pixman_bool_t frozen, inserted;
+    int n_phases;
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    frozen = cache->freeze_count > 0;
+    n_phases = cache->n_phases;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
 
-    return_val_if_fail (cache->freeze_count > 0, NULL);
+    return_val_if_fail (frozen, NULL);
     return_val_if_fail (image->type == BITS, NULL);
+    return_val_if_fail (phase >= 0 && phase < n_phases, NULL);
 
     width = image->bits.width;
     height = image->bits.height;
 
-    if (cache->n_glyphs >= HASH_SIZE)
-	return NULL;
-
     if (!(glyph = malloc (sizeof *glyph)))
 	return NULL;
 
     glyph->font_key = font_key;
     glyph->glyph_key = glyph_key;
+    glyph->phase = phase;
+    glyph->hash = hash (font_key, glyph_key, phase);
+    glyph->used = TRUE;
     glyph->origin_x = origin_x;
     glyph->origin_y = origin_y;
+    glyph->x = 0;
+    glyph->y = 0;
+    glyph->width = width;
+    glyph->height = height;
+    glyph->page = NULL;
+    glyph->retired = FALSE;
+
+    if (cache->atlas						&&
+	width > 0 && width <= ATLAS_MAX_GLYPH_SIZE		&&
+	height > 0 && height <= ATLAS_MAX_GLYPH_SIZE		&&
+	PIXMAN_FORMAT_BPP (image->bits.format) != 12)
+    {
+	PIXMAN_SPIN_LOCK (&cache->lock);
+	inserted = atlas_insert (cache, glyph, image->bits.format);
+	PIXMAN_SPIN_UNLOCK (&cache->lock);
 
-    if (!(glyph->image = pixman_image_create_bits (
-	      image->bits.format, width, height, NULL, -1)))
+	if (!inserted)
+	{
+	    free (glyph);
+	    return NULL;
+	}
+    }
+    else
     {
-	free (glyph);
-	return NULL;
+	if (!(glyph->image = pixman_image_create_bits (
+		  image->bits.format, width, height, NULL, -1)))
+	{
+	    free (glyph);
+	    return NULL;
+	}
+
+	if (PIXMAN_FORMAT_A   (glyph->image->bits.format) != 0	&&
+	    PIXMAN_FORMAT_RGB (glyph->image->bits.format) != 0)
+	{
+	    pixman_image_set_component_alpha (glyph->image, TRUE);
+	}
+
+	PIXMAN_SPIN_LOCK (&cache->lock);
+	cache->size += image_size (glyph->image);
+	PIXMAN_SPIN_UNLOCK (&cache->lock);
     }
 
+    /* The cache is frozen, so the page can't go away while the glyph
+     * is copied into it.
+     */
     pixman_image_composite32 (PIXMAN_OP_SRC,
-			      image, NULL, glyph->image, 0, 0, 0, 0, 0, 0,
-			      width, height);
+			      image, NULL, glyph->image, 0, 0, 0, 0,
+			      glyph->x, glyph->y, width, height);
 
-    if (PIXMAN_FORMAT_A   (glyph->image->bits.format) != 0	&&
-	PIXMAN_FORMAT_RGB (glyph->image->bits.format) != 0)
+    _pixman_image_validate (glyph->image);
+
+    shard = get_shard (cache, glyph->hash);
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    PIXMAN_SPIN_LOCK (&shard->lock);
+
+    /* Another thread may have inserted the same glyph in the meantime */
+    if ((existing = lookup_glyph (shard, glyph->hash,
+				  font_key, glyph_key, phase)))
+	inserted = FALSE;
+    else
+	inserted = insert_glyph (shard, glyph);
+
+    PIXMAN_SPIN_UNLOCK (&shard->lock);
+
+    if (!inserted)
     {
-	pixman_image_set_component_alpha (glyph->image, TRUE);
+	/* A glyph on a page isn't on the list of the page yet */
+	if (glyph->page)
+	    glyph->retired = TRUE;
+	free_glyph (cache, glyph);
+	PIXMAN_SPIN_UNLOCK (&cache->lock);
+
+	return existing;
     }
 
-    pixman_list_prepend (&cache->mru, &glyph->mru_link);
+    if (glyph->page)
+    {
+	atlas_page_t *page = glyph->page;
 
-    _pixman_image_validate (glyph->image);
-    insert_glyph (cache, glyph);
+	/* The page may have been evicted while the glyph was copied */
+	if (page->retired)
+	{
+	    page->retired = FALSE;
+	    pixman_list_prepend (&cache->pages, &page->link);
+	    cache->size += image_size (page->image);
+	}
+
+	pixman_list_prepend (&page->glyphs, &glyph->page_link);
+    }
+
+    /* Threads can keep the cache frozen between them for a long time,
+     * so don't wait for the thaw to keep to the budget.
+     */
+    if (cache->size > cache->budget)
+	evict (cache, cache->budget / 2);
+
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
 
     return glyph;
 }
 
+static void
+remove_phase (pixman_glyph_cache_t  *cache,
+	      void                  *font_key,
+	      void                  *glyph_key,
+	      int                    phase)
+{
+    unsigned int h = hash (font_key, glyph_key, phase);
+    glyph_shard_t *shard = get_shard (cache, h);
+    glyph_t *glyph;
+
+    PIXMAN_SPIN_LOCK (&shard->lock);
+    if ((glyph = lookup_glyph (shard, h, font_key, glyph_key, phase)))
+	remove_glyph (shard, glyph);
+    PIXMAN_SPIN_UNLOCK (&shard->lock);
+
+    if (glyph)
+    {
+	PIXMAN_SPIN_LOCK (&cache->lock);
+	release_glyph (cache, glyph);
+	PIXMAN_SPIN_UNLOCK (&cache->lock);
+    }
+}
+
+/* Removes the glyph along with all its subpixel variants */
 PIXMAN_EXPORT void
 pixman_glyph_cache_remove (pixman_glyph_cache_t  *cache,
 			   void                  *font_key,
 			   void                  *glyph_key)
 {
-    glyph_t *glyph;
+    int n_phases, phase;
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    n_phases = cache->n_phases;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
 
-    if ((glyph = lookup_glyph (cache, font_key, glyph_key)))
+    for (phase = 0; phase < n_phases; ++phase)
+	remove_phase (cache, font_key, glyph_key, phase);
+}
+
+/* Makes the variant of a phase 0 glyph for the phase by shifting it
+ * right with a bilinear filter, into an image one pixel wider.
+ */
+static const void *
+make_variant (pixman_glyph_cache_t *cache,
+	      const glyph_t        *base,
+	      int                   phase,
+	      int                   n_phases)
+{
+    pixman_format_code_t format = base->image->bits.format;
+    int stride = base->image->bits.rowstride * sizeof (uint32_t);
+    pixman_image_t *view, *image;
+    pixman_transform_t transform;
+    const void *variant = NULL;
+    uint8_t *bits;
+
+    /* Glyphs in atlas pages start on a 32 bit boundary */
+    bits = (uint8_t *)base->image->bits.bits + base->y * stride +
+	base->x * PIXMAN_FORMAT_BPP (format) / 8;
+
+    view = pixman_image_create_bits (
+	format, base->width, base->height, (uint32_t *)bits, stride);
+    image = pixman_image_create_bits (
+	format, base->width + 1, base->height, NULL, -1);
+
+    if (view && image)
+    {
+	pixman_transform_init_translate (
+	    &transform, - pixman_int_to_fixed (phase) / n_phases, 0);
+	pixman_image_set_transform (view, &transform);
+	pixman_image_set_filter (view, PIXMAN_FILTER_BILINEAR, NULL, 0);
+
+	pixman_image_composite32 (PIXMAN_OP_SRC, view, NULL, image,
+				  0, 0, 0, 0, 0, 0,
+				  base->width + 1, base->height);
+
+	variant = pixman_glyph_cache_insert_phase (
+	    cache, base->font_key, base->glyph_key, phase,
+	    base->origin_x, base->origin_y, image);
+    }
+
+    if (view)
+	pixman_image_unref (view);
+    if (image)
+	pixman_image_unref (image);
+
+    return variant;
+}
+
+static const void *
+get_variant (pixman_glyph_cache_t       *cache,
+	     const glyph_t              *glyph,
+	     int                         phase,
+	     int                         n_phases,
+	     pixman_glyph_render_func_t  render,
+	     void                       *render_data)
+{
+    const void *variant;
+    const glyph_t *base;
+
+    if (glyph->phase == phase)
+	return glyph;
+
+    if ((variant = pixman_glyph_cache_lookup_phase (
+	     cache, glyph->font_key, glyph->glyph_key, phase)))
+    {
+	return variant;
+    }
+
+    if (render)
+    {
+	pixman_image_t *image;
+	int origin_x, origin_y;
+
+	if (!(image = render (glyph->font_key, glyph->glyph_key,
+			      phase, n_phases, &origin_x, &origin_y,
+			      render_data)))
+	{
+	    return NULL;
+	}
+
+	variant = pixman_glyph_cache_insert_phase (
+	    cache, glyph->font_key, glyph->glyph_key, phase,
+	    origin_x, origin_y, image);
+
+	pixman_image_unref (image);
+
+	return variant;
+    }
+
+    if (glyph->phase == 0)
+	base = glyph;
+    else if (!(base = pixman_glyph_cache_lookup (
+		   cache, glyph->font_key, glyph->glyph_key)))
+	return NULL;
+
+    return make_variant (cache, base, phase, n_phases);
+}
+
+static int
+floor_div (int64_t a, int b)
+{
+    return a >= 0 ? a / b : - ((- a + b - 1) / b);
+}
+
+/* Snaps glyphs at fixed point positions to the nearest subpixel phase
+ * horizontally and to the nearest pixel vertically, and picks the
+ * variants of the glyphs for their phases, making the variants that
+ * aren't in the cache yet. The cache must be frozen. A glyph whose
+ * variant can't be made is used as it is, at the nearest pixel.
+ */
+PIXMAN_EXPORT void
+pixman_glyph_resolve_fixed (pixman_glyph_cache_t       *cache,
+			    int                         n_glyphs,
+			    const pixman_glyph_fixed_t *glyphs,
+			    pixman_glyph_t             *resolved)
+{
+    pixman_glyph_render_func_t render;
+    void *render_data;
+    int n_phases, i;
+
+    PIXMAN_SPIN_LOCK (&cache->lock);
+    n_phases = cache->n_phases;
+    render = cache->render;
+    render_data = cache->render_data;
+    PIXMAN_SPIN_UNLOCK (&cache->lock);
+
+    for (i = 0; i < n_glyphs; ++i)
     {
-	remove_glyph (cache, glyph);
+	const glyph_t *glyph = glyphs[i].glyph;
+	int64_t p;
+	int phase;
+
+	/* The position in units of 1 / n_phases pixel */
+	p = ((int64_t)glyphs[i].x * n_phases + pixman_fixed_1 / 2) >> 16;
+
+	resolved[i].x = floor_div (p, n_phases);
+	resolved[i].y = pixman_fixed_to_int (glyphs[i].y + pixman_fixed_1 / 2);
+	phase = p - (int64_t)resolved[i].x * n_phases;
 
-	free_glyph (glyph);
+	if (!(resolved[i].glyph = get_variant (cache, glyph, phase, n_phases,
+					       render, render_data)))
+	{
+	    resolved[i].x = floor_div (p - glyph->phase + n_phases / 2, n_phases);
+	    resolved[i].glyph = glyph;
+	}
     }
 }
 
@@ -334,8 +1187,8 @@ pixman_glyph_get_extents (pixman_glyph_cache_t *cache,
 
 	x1 = glyphs[i].x - glyph->origin_x;
 	y1 = glyphs[i].y - glyph->origin_y;
-	x2 = glyphs[i].x - glyph->origin_x + glyph->image->bits.width;
-	y2 = glyphs[i].y - glyph->origin_y + glyph->image->bits.height;
+	x2 = glyphs[i].x - glyph->origin_x + glyph->width;
+	y2 = glyphs[i].y - glyph->origin_y + glyph->height;
 
 	if (x1 < extents->x1)
 	    extents->x1 = x1;
@@ -391,6 +1244,287 @@ box32_intersect (pixman_box32_t *dest,
     return dest->x2 > dest->x1 && dest->y2 > dest->y1;
 }
 
+/* Glyph runs
+ *
+ * A solid source composited with OVER through a8 or component alpha
+ * a8r8g8b8 glyphs onto a 32 bpp destination is by far the most common
+ * way text is drawn. Instead of a composite call per glyph and clip
+ * box, the glyphs are clipped to bands of GLYPH_BAND_HEIGHT scanlines
+ * and each band is handed to the glyphs hook of the implementation in
+ * one go, so that the whole run is a single pass over the destination.
+ * Within a band the glyphs keep their order, so overlapping glyphs
+ * come out exactly as they would one by one.
+ */
+#define GLYPH_BAND_HEIGHT	16
+#define N_STACK_GLYPHS		64
+#define N_GLYPH_BOXES		64
+
+typedef struct
+{
+    pixman_box32_t	box;
+    const glyph_t *	glyph;
+    int			index;
+} run_glyph_t;
+
+static int
+compare_run_glyphs (const void *p1, const void *p2)
+{
+    const run_glyph_t *g1 = p1, *g2 = p2;
+
+    if (g1->box.y1 != g2->box.y1)
+	return g1->box.y1 < g2->box.y1 ? -1 : 1;
+
+    return g1->index - g2->index;
+}
+
+/* Whether no two glyphs overlap, going by a quick test that text laid
+ * out in lines, left to right, passes: each glyph must be to the right
+ * of the glyphs before it on its line and below all earlier lines.
+ */
+static pixman_bool_t
+run_is_disjoint (const run_glyph_t *run, int n_glyphs)
+{
+    int32_t line_top = INT32_MIN, line_right = INT32_MIN, bottom = INT32_MIN;
+    int i;
+
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	const pixman_box32_t *box = &run[i].box;
+
+	if (box->y1 >= bottom)
+	    line_top = bottom;
+	else if (box->x1 < line_right || box->y1 < line_top)
+	    return FALSE;
+
+	line_right = box->x2;
+	bottom = MAX (bottom, box->y2);
+    }
+
+    return TRUE;
+}
+
+/* Composites the glyphs, positioned at (off_x, off_y) in the destination,
+ * within the region if the images and glyphs allow it. If mask_format is
+ * not PIXMAN_null, all glyphs must have that format and must not overlap,
+ * so that compositing them one by one is the same as compositing through
+ * a mask that they were added to. Returns FALSE, with nothing drawn, if
+ * the run has to take the general path.
+ */
+static pixman_bool_t
+composite_glyph_run (pixman_image_t        *src,
+		     pixman_image_t        *dest,
+		     pixman_region32_t     *region,
+		     pixman_format_code_t   mask_format,
+		     int                    off_x,
+		     int                    off_y,
+		     int                    n_glyphs,
+		     const pixman_glyph_t  *glyphs)
+{
+    run_glyph_t stack_run[N_STACK_GLYPHS];
+    const run_glyph_t *stack_active[N_STACK_GLYPHS];
+    pixman_glyph_box_t boxes[N_GLYPH_BOXES];
+    run_glyph_t *run = stack_run;
+    const run_glyph_t **active = stack_active;
+    pixman_box32_t *extents = pixman_region32_extents (region);
+    pixman_box32_t *rects;
+    pixman_implementation_t *imp = get_implementation ();
+    pixman_bool_t result = FALSE;
+    int n_run = 0, n_active = 0, next = 0, n_rects, i;
+    uint32_t color;
+    int32_t y;
+
+    if (src->common.extended_format_code != PIXMAN_solid		||
+	(src->common.flags & FAST_PATH_STANDARD_FLAGS) !=
+	FAST_PATH_STANDARD_FLAGS)
+    {
+	return FALSE;
+    }
+
+    if ((dest->common.extended_format_code != PIXMAN_a8r8g8b8	&&
+	 dest->common.extended_format_code != PIXMAN_x8r8g8b8)	||
+	(dest->common.flags & FAST_PATH_STD_DEST_FLAGS) !=
+	FAST_PATH_STD_DEST_FLAGS)
+    {
+	return FALSE;
+    }
+
+    if (n_glyphs > N_STACK_GLYPHS)
+    {
+	run = pixman_malloc_ab (n_glyphs, sizeof *run);
+	active = pixman_malloc_ab (n_glyphs, sizeof *active);
+
+	if (!run || !active)
+	    goto out;
+    }
+
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	const glyph_t *glyph = glyphs[i].glyph;
+	pixman_format_code_t format = glyph->image->bits.format;
+	run_glyph_t *g = &run[n_run];
+
+	if (format == PIXMAN_a8)
+	{
+	    if (glyph->image->common.flags & FAST_PATH_COMPONENT_ALPHA)
+		goto out;
+	}
+	else if (format == PIXMAN_a8r8g8b8)
+	{
+	    if (!(glyph->image->common.flags & FAST_PATH_COMPONENT_ALPHA))
+		goto out;
+	}
+	else
+	{
+	    goto out;
+	}
+
+	if (mask_format != PIXMAN_null && format != mask_format)
+	    goto out;
+
+	g->box.x1 = off_x + glyphs[i].x - glyph->origin_x;
+	g->box.y1 = off_y + glyphs[i].y - glyph->origin_y;
+	g->box.x2 = g->box.x1 + glyph->width;
+	g->box.y2 = g->box.y1 + glyph->height;
+	g->glyph = glyph;
+	g->index = i;
+
+	n_run++;
+    }
+
+    if (mask_format != PIXMAN_null && !run_is_disjoint (run, n_run))
+	goto out;
+
+    /* Text usually comes sorted already */
+    for (i = 1; i < n_run; ++i)
+    {
+	if (run[i].box.y1 < run[i - 1].box.y1)
+	{
+	    qsort (run, n_run, sizeof *run, compare_run_glyphs);
+	    break;
+	}
+    }
+
+    color = _pixman_image_get_solid (imp, src, dest->bits.format);
+    rects = pixman_region32_rectangles (region, &n_rects);
+
+    /* The hook depends only on the operator, so once it is known to be
+     * there, nothing below can fail and the run is drawn completely.
+     */
+    if (!_pixman_implementation_glyphs (
+	    imp, PIXMAN_OP_OVER, color, dest->bits.rowstride, boxes, 0))
+    {
+	goto out;
+    }
+
+    y = extents->y1;
+    while (y < extents->y2)
+    {
+	int32_t band_y2;
+	int n_boxes = 0, j, k;
+
+	/* Drop the glyphs that ended above the band */
+	for (j = 0, k = 0; j < n_active; ++j)
+	{
+	    if (active[j]->box.y2 > y)
+		active[k++] = active[j];
+	}
+	n_active = k;
+
+	/* Skip ahead if nothing is left until the next glyph */
+	if (n_active == 0)
+	{
+	    while (next < n_run && run[next].box.y2 <= y)
+		next++;
+
+	    if (next == n_run)
+		break;
+
+	    y = MAX (y, run[next].box.y1);
+	    if (y >= extents->y2)
+		break;
+	}
+
+	band_y2 = MIN (y + GLYPH_BAND_HEIGHT, extents->y2);
+
+	/* Add the glyphs that start in the band, in the order of the run */
+	while (next < n_run && run[next].box.y1 < band_y2)
+	{
+	    const run_glyph_t *g = &run[next++];
+
+	    if (g->box.y2 <= y)
+		continue;
+
+	    for (j = n_active; j > 0 && active[j - 1]->index > g->index; --j)
+		active[j] = active[j - 1];
+
+	    active[j] = g;
+	    n_active++;
+	}
+
+	for (j = 0; j < n_active; ++j)
+	{
+	    const run_glyph_t *g = active[j];
+	    pixman_image_t *image = g->glyph->image;
+	    int bpp = PIXMAN_FORMAT_BPP (image->bits.format);
+
+	    for (k = 0; k < n_rects; ++k)
+	    {
+		pixman_box32_t band, box;
+		pixman_glyph_box_t *b;
+
+		band.x1 = rects[k].x1;
+		band.x2 = rects[k].x2;
+		band.y1 = MAX (rects[k].y1, y);
+		band.y2 = MIN (rects[k].y2, band_y2);
+
+		if (!box32_intersect (&box, &band, &g->box))
+		    continue;
+
+		/* Boxes are drawn in order, so a full array can be
+		 * drawn before the rest of the band.
+		 */
+		if (n_boxes == N_GLYPH_BOXES)
+		{
+		    _pixman_implementation_glyphs (
+			imp, PIXMAN_OP_OVER, color, dest->bits.rowstride,
+			boxes, n_boxes);
+		    n_boxes = 0;
+		}
+
+		b = &boxes[n_boxes++];
+		b->mask = (uint8_t *)image->bits.bits +
+		    (box.y1 - g->box.y1 + g->glyph->y) * image->bits.rowstride * 4 +
+		    (box.x1 - g->box.x1 + g->glyph->x) * (bpp / 8);
+		b->mask_stride = image->bits.rowstride * 4;
+		b->component_alpha = (bpp == 32);
+		b->dest = dest->bits.bits +
+		    box.y1 * dest->bits.rowstride + box.x1;
+		b->width = box.x2 - box.x1;
+		b->height = box.y2 - box.y1;
+	    }
+	}
+
+	if (n_boxes)
+	{
+	    _pixman_implementation_glyphs (
+		imp, PIXMAN_OP_OVER, color, dest->bits.rowstride,
+		boxes, n_boxes);
+	}
+
+	y = band_y2;
+    }
+
+    result = TRUE;
+
+out:
+    if (run != stack_run)
+	free (run);
+    if (active != stack_active)
+	free (active);
+
+    return result;
+}
+
 PIXMAN_EXPORT void
 pixman_composite_glyphs_no_mask (pixman_op_t            op,
 				 pixman_image_t        *src,
@@ -429,6 +1563,13 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
 	goto out;
     }
 
+    if (op == PIXMAN_OP_OVER &&
+	composite_glyph_run (src, dest, &region, PIXMAN_null,
+			     dest_x, dest_y, n_glyphs, glyphs))
+    {
+	goto out;
+    }
+
     info.op = op;
     info.src_image = src;
     info.dest_image = dest;
@@ -447,8 +1588,8 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
 
 	glyph_box.x1 = dest_x + glyphs[i].x - glyph->origin_x;
 	glyph_box.y1 = dest_y + glyphs[i].y - glyph->origin_y;
-	glyph_box.x2 = glyph_box.x1 + glyph->image->bits.width;
-	glyph_box.y2 = glyph_box.y1 + glyph->image->bits.height;
+	glyph_box.x2 = glyph_box.x1 + glyph->width;
+	glyph_box.y2 = glyph_box.y1 + glyph->height;
 	
 	pbox = pixman_region32_rectangles (&region, &n);
 	
@@ -477,8 +1618,8 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
 
 		info.src_x = src_x + composite_box.x1 - dest_x;
 		info.src_y = src_y + composite_box.y1 - dest_y;
-		info.mask_x = composite_box.x1 - (dest_x + glyphs[i].x - glyph->origin_x);
-		info.mask_y = composite_box.y1 - (dest_y + glyphs[i].y - glyph->origin_y);
+		info.mask_x = composite_box.x1 - glyph_box.x1 + glyph->x;
+		info.mask_y = composite_box.y1 - glyph_box.y1 + glyph->y;
 		info.dest_x = composite_box.x1;
 		info.dest_y = composite_box.y1;
 		info.width = composite_box.x2 - composite_box.x1;
@@ -491,7 +1632,6 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
 
 	    pbox++;
 	}
-	pixman_list_move_to_front (&cache->mru, &glyph->mru_link);
     }
 
 out:
@@ -589,13 +1729,13 @@ add_glyphs (pixman_glyph_cache_t *cache,
 
 	glyph_box.x1 = glyphs[i].x - glyph->origin_x + off_x;
 	glyph_box.y1 = glyphs[i].y - glyph->origin_y + off_y;
-	glyph_box.x2 = glyph_box.x1 + glyph->image->bits.width;
-	glyph_box.y2 = glyph_box.y1 + glyph->image->bits.height;
+	glyph_box.x2 = glyph_box.x1 + glyph->width;
+	glyph_box.y2 = glyph_box.y1 + glyph->height;
 	
 	if (box32_intersect (&composite_box, &glyph_box, &dest_box))
 	{
-	    int src_x = composite_box.x1 - glyph_box.x1;
-	    int src_y = composite_box.y1 - glyph_box.y1;
+	    int src_x = composite_box.x1 - glyph_box.x1 + glyph->x;
+	    int src_y = composite_box.y1 - glyph_box.y1 + glyph->y;
 
 	    if (white_src)
 		info.mask_image = glyph_img;
@@ -610,8 +1750,6 @@ add_glyphs (pixman_glyph_cache_t *cache,
 	    info.height = composite_box.y2 - composite_box.y1;
 
 	    func (implementation, &info);
-
-	    pixman_list_move_to_front (&cache->mru, &glyph->mru_link);
 	}
     }
 
@@ -655,6 +1793,31 @@ pixman_composite_glyphs (pixman_op_t            op,
 {
     pixman_image_t *mask;
 
+    /* Glyphs that don't overlap can skip the mask */
+    if (op == PIXMAN_OP_OVER &&
+	(mask_format == PIXMAN_a8 || mask_format == PIXMAN_a8r8g8b8))
+    {
+	pixman_region32_t region;
+	pixman_bool_t done;
+
+	_pixman_image_validate (src);
+	_pixman_image_validate (dest);
+
+	pixman_region32_init (&region);
+
+	done = !_pixman_compute_composite_region32 (
+	    &region, src, NULL, dest,
+	    src_x, src_y, 0, 0, dest_x, dest_y, width, height)	||
+	    composite_glyph_run (src, dest, &region, mask_format,
+				 dest_x - mask_x, dest_y - mask_y,
+				 n_glyphs, glyphs);
+
+	pixman_region32_fini (&region);
+
+	if (done)
+	    return;
+    }
+
     if (!(mask = pixman_image_create_bits (mask_format, width, height, NULL, -1)))
 	return;
 
@@ -674,3 +1837,71 @@ pixman_composite_glyphs (pixman_op_t            op,
 
     pixman_image_unref (mask);
 }
+
+PIXMAN_EXPORT void
+pixman_composite_glyphs_fixed (pixman_op_t                 op,
+			       pixman_image_t             *src,
+			       pixman_image_t             *dest,
+			       pixman_format_code_t        mask_format,
+			       int32_t                     src_x,
+			       int32_t                     src_y,
+			       int32_t                     mask_x,
+			       int32_t                     mask_y,
+			       int32_t                     dest_x,
+			       int32_t                     dest_y,
+			       int32_t                     width,
+			       int32_t                     height,
+			       pixman_glyph_cache_t       *cache,
+			       int                         n_glyphs,
+			       const pixman_glyph_fixed_t *glyphs)
+{
+    pixman_glyph_t stack_glyphs[N_STACK_GLYPHS];
+    pixman_glyph_t *resolved = stack_glyphs;
+
+    if (n_glyphs > N_STACK_GLYPHS &&
+	!(resolved = pixman_malloc_ab (n_glyphs, sizeof *resolved)))
+    {
+	return;
+    }
+
+    pixman_glyph_resolve_fixed (cache, n_glyphs, glyphs, resolved);
+
+    pixman_composite_glyphs (op, src, dest, mask_format,
+			     src_x, src_y, mask_x, mask_y,
+			     dest_x, dest_y, width, height,
+			     cache, n_glyphs, resolved);
+
+    if (resolved != stack_glyphs)
+	free (resolved);
+}
+
+PIXMAN_EXPORT void
+pixman_composite_glyphs_no_mask_fixed (pixman_op_t                 op,
+				       pixman_image_t             *src,
+				       pixman_image_t             *dest,
+				       int32_t                     src_x,
+				       int32_t                     src_y,
+				       int32_t                     dest_x,
+				       int32_t                     dest_y,
+				       pixman_glyph_cache_t       *cache,
+				       int                         n_glyphs,
+				       const pixman_glyph_fixed_t *glyphs)
+{
+    pixman_glyph_t stack_glyphs[N_STACK_GLYPHS];
+    pixman_glyph_t *resolved = stack_glyphs;
+
+    if (n_glyphs > N_STACK_GLYPHS &&
+	!(resolved = pixman_malloc_ab (n_glyphs, sizeof *resolved)))
+    {
+	return;
+    }
+
+    pixman_glyph_resolve_fixed (cache, n_glyphs, glyphs, resolved);
+
+    pixman_composite_glyphs_no_mask (op, src, dest, src_x, src_y,
+				     dest_x, dest_y, cache,
+				     n_glyphs, resolved);
+
+    if (resolved != stack_glyphs)
+	free (resolved);
+}
@@ -170,3 +170,33 @@ _pixman_gradient_walker_pixel (pixman_gradient_walker_t *walker,
     return (color | (t1 & 0xff00ff) | (t2 & 0xff00));
 }
 
+/* The colors of the LUT come from the walker, so they are exact at the
+ * positions of the table.
+ */
+uint32_t *
+_pixman_gradient_create_lut (gradient_t *gradient)
+{
+    pixman_gradient_walker_t walker;
+    uint32_t *lut;
+    int i;
+
+    for (i = 0; i < gradient->n_stops; ++i)
+    {
+	if (gradient->stops[i].x < 0 || gradient->stops[i].x > pixman_fixed_1)
+	    return NULL;
+    }
+
+    lut = pixman_malloc_ab (GRADIENT_LUT_SIZE + 1, sizeof (uint32_t));
+    if (!lut)
+	return NULL;
+
+    _pixman_gradient_walker_init (&walker, gradient, gradient->common.repeat);
+
+    for (i = 0; i <= GRADIENT_LUT_SIZE; ++i)
+    {
+	lut[i] = _pixman_gradient_walker_pixel (
+	    &walker, i << (16 - GRADIENT_LUT_BITS));
+    }
+
+    return lut;
+}
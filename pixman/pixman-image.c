@@ -73,6 +73,12 @@ gradient_property_changed (pixman_image_t *image)
 	end->color = stops[n - 1].color;
 	break;
     }
+
+    /* The colors at the ends of the LUT depend on the repeat */
+    free (gradient->lut);
+    gradient->lut = NULL;
+    if (gradient->precision == PIXMAN_GRADIENT_LUT)
+	gradient->lut = _pixman_gradient_create_lut (gradient);
 }
 
 pixman_bool_t
@@ -100,6 +106,8 @@ _pixman_init_gradient (gradient_t *                  gradient,
     gradient->stops += 1;
     memcpy (gradient->stops, stops, n_stops * sizeof (pixman_gradient_stop_t));
     gradient->n_stops = n_stops;
+    gradient->precision = PIXMAN_GRADIENT_PRECISE;
+    gradient->lut = NULL;
 
     gradient->common.property_changed = gradient_property_changed;
 
@@ -121,6 +129,7 @@ _pixman_image_init (pixman_image_t *image)
     common->filter = PIXMAN_FILTER_NEAREST;
     common->filter_params = NULL;
     common->n_filter_params = 0;
+    common->filter_object = NULL;
     common->alpha_map = NULL;
     common->component_alpha = FALSE;
     common->ref_count = 1;
@@ -129,6 +138,20 @@ _pixman_image_init (pixman_image_t *image)
     common->destroy_func = NULL;
     common->destroy_data = NULL;
     common->dirty = TRUE;
+    common->iter_imp = NULL;
+    common->n_cached_iters = -1;
+}
+
+static void
+release_filter_params (image_common_t *common)
+{
+    if (common->filter_object)
+	pixman_separable_filter_unref (common->filter_object);
+    else
+	free (common->filter_params);
+
+    common->filter_params = NULL;
+    common->filter_object = NULL;
 }
 
 pixman_bool_t
@@ -146,7 +169,7 @@ _pixman_image_fini (pixman_image_t *image)
 	pixman_region32_fini (&common->clip_region);
 
 	free (common->transform);
-	free (common->filter_params);
+	release_filter_params (common);
 
 	if (common->alpha_map)
 	    pixman_image_unref ((pixman_image_t *)common->alpha_map);
@@ -161,6 +184,8 @@ _pixman_image_fini (pixman_image_t *image)
 		free (image->gradient.stops - 1);
 	    }
 
+	    free (image->gradient.lut);
+
 	    /* This will trigger if someone adds a property_changed
 	     * method to the linear/radial/conical gradient overwriting
 	     * the general one.
@@ -420,7 +445,9 @@ compute_image_info (pixman_image_t *image)
     else
 	flags |= FAST_PATH_UNIFIED_ALPHA;
 
-    flags |= (FAST_PATH_NO_ACCESSORS | FAST_PATH_NARROW_FORMAT);
+    flags |= (FAST_PATH_NO_ACCESSORS	|
+	      FAST_PATH_NARROW_FORMAT	|
+	      FAST_PATH_NO_DITHER);
 
     /* Type specific checks */
     switch (image->type)
@@ -460,10 +487,19 @@ compute_image_info (pixman_image_t *image)
 
 	if (PIXMAN_FORMAT_IS_WIDE (image->bits.format))
 	    flags &= ~FAST_PATH_NARROW_FORMAT;
+
+	if (image->bits.dither != PIXMAN_DITHER_NONE		&&
+	    format_can_dither (image->bits.format))
+	{
+	    flags &= ~FAST_PATH_NO_DITHER;
+	}
+
+	if (image->bits.separable_precision == PIXMAN_SEPARABLE_TWO_PASS)
+	    flags |= FAST_PATH_SEPARABLE_TWO_PASS;
 	break;
 
     case RADIAL:
-	code = PIXMAN_unknown;
+	code = PIXMAN_radial_gradient;
 
 	/*
 	 * As explained in pixman-radial-gradient.c, every point of
@@ -479,7 +515,10 @@ compute_image_info (pixman_image_t *image)
 
     case CONICAL:
     case LINEAR:
-	code = PIXMAN_unknown;
+	if (image->type == LINEAR)
+	    code = PIXMAN_linear_gradient;
+	else if (image->type == CONICAL)
+	    code = PIXMAN_conical_gradient;
 
 	if (image->common.repeat != PIXMAN_REPEAT_NONE)
 	{
@@ -502,8 +541,10 @@ compute_image_info (pixman_image_t *image)
 	break;
     }
 
-    /* Alpha map */
-    if (!image->common.alpha_map)
+    /* Alpha maps are only supported for BITS images, so it's always
+     * safe to ignore their presence for non-BITS images
+     */
+    if (!image->common.alpha_map || image->type != BITS)
     {
 	flags |= FAST_PATH_NO_ALPHA_MAP;
     }
@@ -546,6 +587,8 @@ _pixman_image_validate (pixman_image_t *image)
 	if (image->common.property_changed)
 	    image->common.property_changed (image);
 
+	_pixman_implementation_cache_iters (get_implementation (), image);
+
 	image->common.dirty = FALSE;
     }
 
@@ -710,8 +753,7 @@ pixman_image_set_filter (pixman_image_t *      image,
 
     common->filter = filter;
 
-    if (common->filter_params)
-	free (common->filter_params);
+    release_filter_params (common);
 
     common->filter_params = new_params;
     common->n_filter_params = n_params;
@@ -720,6 +762,82 @@ pixman_image_set_filter (pixman_image_t *      image,
     return TRUE;
 }
 
+PIXMAN_EXPORT pixman_bool_t
+pixman_image_set_separable_filter (pixman_image_t            *image,
+				   pixman_separable_filter_t *filter)
+{
+    image_common_t *common = (image_common_t *)image;
+    const pixman_fixed_t *params;
+    int n_params;
+
+    if (common->filter_object == filter)
+	return TRUE;
+
+    params = pixman_separable_filter_get_params (filter, &n_params);
+
+    pixman_separable_filter_ref (filter);
+    release_filter_params (common);
+
+    common->filter = PIXMAN_FILTER_SEPARABLE_CONVOLUTION;
+    common->filter_params = (pixman_fixed_t *)params;
+    common->n_filter_params = n_params;
+    common->filter_object = filter;
+
+    image_property_changed (image);
+    return TRUE;
+}
+
+PIXMAN_EXPORT void
+pixman_image_set_dither (pixman_image_t *image,
+			 pixman_dither_t dither)
+{
+    if (image->type != BITS || image->bits.dither == dither)
+	return;
+
+    image->bits.dither = dither;
+
+    image_property_changed (image);
+}
+
+PIXMAN_EXPORT void
+pixman_image_set_dither_offset (pixman_image_t *image,
+				int             offset_x,
+				int             offset_y)
+{
+    if (image->type != BITS)
+	return;
+
+    image->bits.dither_offset_x = offset_x;
+    image->bits.dither_offset_y = offset_y;
+}
+
+PIXMAN_EXPORT void
+pixman_image_set_gradient_precision (pixman_image_t              *image,
+				     pixman_gradient_precision_t  precision)
+{
+    if ((image->type != LINEAR && image->type != RADIAL &&
+	 image->type != CONICAL) || image->gradient.precision == precision)
+    {
+	return;
+    }
+
+    image->gradient.precision = precision;
+
+    image_property_changed (image);
+}
+
+PIXMAN_EXPORT void
+pixman_image_set_separable_precision (pixman_image_t               *image,
+				      pixman_separable_precision_t  precision)
+{
+    if (image->type != BITS || image->bits.separable_precision == precision)
+	return;
+
+    image->bits.separable_precision = precision;
+
+    image_property_changed (image);
+}
+
 PIXMAN_EXPORT void
 pixman_image_set_source_clipping (pixman_image_t *image,
                                   pixman_bool_t   clip_sources)
@@ -918,12 +1036,15 @@ _pixman_image_get_solid (pixman_implementation_t *imp,
 	pixman_iter_t iter;
 
     otherwise:
-	_pixman_implementation_src_iter_init (
+	_pixman_implementation_iter_init (
 	    imp, &iter, image, 0, 0, 1, 1,
 	    (uint8_t *)&result,
-	    ITER_NARROW, image->common.flags);
+	    ITER_NARROW | ITER_SRC, image->common.flags);
 	
 	result = *iter.get_scanline (&iter, NULL);
+
+	if (iter.fini)
+	    iter.fini (&iter);
     }
 
     /* If necessary, convert RGB <--> BGR. */
@@ -938,3 +1059,25 @@ _pixman_image_get_solid (pixman_implementation_t *imp,
 
     return result;
 }
+
+/* The color of a solid source with 16 bits per channel, laid out like
+ * a16b16g16r16 pixels. Solid fills keep their full precision.
+ */
+uint64_t
+_pixman_image_get_solid_16161616 (pixman_implementation_t *imp,
+				  pixman_image_t *         image)
+{
+    if (image->type == SOLID)
+    {
+	const pixman_color_t *color = &image->solid.color;
+
+	return
+	    ((uint64_t)color->alpha << 48) |
+	    ((uint64_t)color->blue  << 32) |
+	    ((uint64_t)color->green << 16) |
+	    ((uint64_t)color->red   <<  0);
+    }
+
+    return convert_8888_to_16161616 (
+	_pixman_image_get_solid (imp, image, PIXMAN_a8r8g8b8));
+}
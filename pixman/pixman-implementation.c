@@ -27,6 +27,211 @@
 #include <stdlib.h>
 #include "pixman-private.h"
 
+/* The dispatch index
+ *
+ * Looking up a fast path used to mean walking every fast path table in
+ * the fallback chain until one matched. The index instead gives each
+ * operator a number of buckets, selected by a hash of the three formats,
+ * and each bucket lists (in chain order) the fast paths that could
+ * possibly match a composite landing in it. Entries with PIXMAN_OP_any
+ * or PIXMAN_any formats are listed in every bucket they could match.
+ *
+ * Since the candidates keep their relative order, the first one that
+ * matches is exactly the fast path the linear walk would have found;
+ * the flags and the formats (buckets can collide) are still checked in
+ * full.
+ */
+#define DISPATCH_BUCKET_BITS	5
+#define N_DISPATCH_BUCKETS	(1 << DISPATCH_BUCKET_BITS)
+#define N_DISPATCH_LISTS	(PIXMAN_N_OPERATORS * N_DISPATCH_BUCKETS)
+#define MAX_DISPATCH_ENTRIES	0xffff
+
+typedef struct
+{
+    pixman_implementation_t *	imp;
+    const pixman_fast_path_t *	fast_path;
+} dispatch_entry_t;
+
+struct pixman_dispatch_index_t
+{
+    dispatch_entry_t *	entries;
+    uint16_t *		candidates;
+    uint32_t		lists[N_DISPATCH_LISTS + 1];
+};
+
+static force_inline uint32_t
+hash_formats (pixman_format_code_t src_format,
+	      pixman_format_code_t mask_format,
+	      pixman_format_code_t dest_format)
+{
+    uint32_t h;
+
+    h = src_format * 0x9e3779b1;
+    h = (h ^ mask_format) * 0x85ebca6b;
+    h = (h ^ dest_format) * 0xc2b2ae35;
+
+    return h ^ (h >> 16);
+}
+
+static force_inline int
+dispatch_list (pixman_op_t          op,
+	       pixman_format_code_t src_format,
+	       pixman_format_code_t mask_format,
+	       pixman_format_code_t dest_format)
+{
+    uint32_t h = hash_formats (src_format, mask_format, dest_format);
+
+    return op * N_DISPATCH_BUCKETS + (h & (N_DISPATCH_BUCKETS - 1));
+}
+
+static force_inline pixman_bool_t
+fast_path_matches (const pixman_fast_path_t *info,
+		   pixman_op_t               op,
+		   pixman_format_code_t      src_format,
+		   uint32_t                  src_flags,
+		   pixman_format_code_t      mask_format,
+		   uint32_t                  mask_flags,
+		   pixman_format_code_t      dest_format,
+		   uint32_t                  dest_flags)
+{
+    return
+	(info->op == op || info->op == PIXMAN_OP_any)		&&
+	/* Formats */
+	((info->src_format == src_format) ||
+	 (info->src_format == PIXMAN_any))			&&
+	((info->mask_format == mask_format) ||
+	 (info->mask_format == PIXMAN_any))			&&
+	((info->dest_format == dest_format) ||
+	 (info->dest_format == PIXMAN_any))			&&
+	/* Flags */
+	(info->src_flags & src_flags) == info->src_flags	&&
+	(info->mask_flags & mask_flags) == info->mask_flags	&&
+	(info->dest_flags & dest_flags) == info->dest_flags;
+}
+
+/* Calls add() for each list that @info has to appear in */
+static void
+for_each_dispatch_list (const pixman_fast_path_t *info,
+			void (* add) (pixman_dispatch_index_t *index,
+				      int list, int entry),
+			pixman_dispatch_index_t *index,
+			int entry)
+{
+    int first_op, last_op, op, b;
+
+    if (info->op == PIXMAN_OP_any)
+    {
+	first_op = 0;
+	last_op = PIXMAN_N_OPERATORS - 1;
+    }
+    else
+    {
+	first_op = last_op = info->op;
+    }
+
+    for (op = first_op; op <= last_op; ++op)
+    {
+	if (info->src_format == PIXMAN_any	||
+	    info->mask_format == PIXMAN_any	||
+	    info->dest_format == PIXMAN_any)
+	{
+	    for (b = 0; b < N_DISPATCH_BUCKETS; ++b)
+		add (index, op * N_DISPATCH_BUCKETS + b, entry);
+	}
+	else
+	{
+	    add (index, dispatch_list (op, info->src_format,
+				       info->mask_format,
+				       info->dest_format), entry);
+	}
+    }
+}
+
+static void
+count_candidate (pixman_dispatch_index_t *index, int list, int entry)
+{
+    index->lists[list + 1]++;
+}
+
+static void
+store_candidate (pixman_dispatch_index_t *index, int list, int entry)
+{
+    /* lists[list] is used as the fill pointer and restored afterwards */
+    index->candidates[index->lists[list]++] = entry;
+}
+
+static void
+dispatch_index_free (pixman_dispatch_index_t *index)
+{
+    if (index)
+    {
+	free (index->entries);
+	free (index->candidates);
+	free (index);
+    }
+}
+
+static pixman_dispatch_index_t *
+dispatch_index_create (pixman_implementation_t *toplevel)
+{
+    pixman_dispatch_index_t *index;
+    pixman_implementation_t *imp;
+    const pixman_fast_path_t *info;
+    int n_entries, i;
+
+    n_entries = 0;
+    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    {
+	for (info = imp->fast_paths; info->op != PIXMAN_OP_NONE; ++info)
+	    n_entries++;
+    }
+
+    if (n_entries > MAX_DISPATCH_ENTRIES)
+	return NULL;
+
+    if (!(index = calloc (1, sizeof *index)))
+	return NULL;
+
+    if (!(index->entries = malloc (n_entries * sizeof (dispatch_entry_t))))
+	goto fail;
+
+    i = 0;
+    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    {
+	for (info = imp->fast_paths; info->op != PIXMAN_OP_NONE; ++info)
+	{
+	    index->entries[i].imp = imp;
+	    index->entries[i].fast_path = info;
+
+	    for_each_dispatch_list (info, count_candidate, index, i);
+	    i++;
+	}
+    }
+
+    for (i = 0; i < N_DISPATCH_LISTS; ++i)
+	index->lists[i + 1] += index->lists[i];
+
+    index->candidates = malloc (
+	(index->lists[N_DISPATCH_LISTS] + 1) * sizeof (uint16_t));
+    if (!index->candidates)
+	goto fail;
+
+    for (i = 0; i < n_entries; ++i)
+	for_each_dispatch_list (index->entries[i].fast_path,
+				store_candidate, index, i);
+
+    /* Each fill pointer now points at the start of the next list */
+    for (i = N_DISPATCH_LISTS; i > 0; --i)
+	index->lists[i] = index->lists[i - 1];
+    index->lists[0] = 0;
+
+    return index;
+
+fail:
+    dispatch_index_free (index);
+    return NULL;
+}
+
 pixman_implementation_t *
 _pixman_implementation_create (pixman_implementation_t *fallback,
 			       const pixman_fast_path_t *fast_paths)
@@ -47,24 +252,137 @@ _pixman_implementation_create (pixman_implementation_t *fallback,
 	/* Make sure the whole fallback chain has the right toplevel */
 	for (d = imp; d != NULL; d = d->fallback)
 	    d->toplevel = imp;
+
+	/* Lookups always start at the toplevel, so the index of the
+	 * implementation we are stacking on top of is no longer needed.
+	 * If the index can't be built, lookups fall back to walking the
+	 * fast path tables.
+	 */
+	if (fallback)
+	{
+	    dispatch_index_free (fallback->dispatch_index);
+	    fallback->dispatch_index = NULL;
+	}
+
+	imp->dispatch_index = dispatch_index_create (imp);
     }
 
     return imp;
 }
 
-#define N_CACHED_FAST_PATHS 8
+/* The fast path cache
+ *
+ * A thread local, set associative cache of recent lookups. The set is
+ * chosen by a hash of the whole key, and each set is kept in most
+ * recently used order. Entries remember the chain they were looked up
+ * in, since pixman_set_implementations() can switch chains at any time.
+ */
+#define FAST_PATH_CACHE_SET_BITS	5
+#define N_FAST_PATH_CACHE_SETS		(1 << FAST_PATH_CACHE_SET_BITS)
+#define N_FAST_PATH_CACHE_WAYS		4
 
 typedef struct
 {
     struct
     {
+	pixman_implementation_t *	toplevel;
 	pixman_implementation_t *	imp;
 	pixman_fast_path_t		fast_path;
-    } cache [N_CACHED_FAST_PATHS];
+    } cache [N_FAST_PATH_CACHE_SETS][N_FAST_PATH_CACHE_WAYS];
 } cache_t;
 
 PIXMAN_DEFINE_THREAD_LOCAL (cache_t, fast_path_cache);
 
+static force_inline int
+fast_path_cache_set (pixman_op_t          op,
+		     pixman_format_code_t src_format,
+		     uint32_t             src_flags,
+		     pixman_format_code_t mask_format,
+		     uint32_t             mask_flags,
+		     pixman_format_code_t dest_format,
+		     uint32_t             dest_flags)
+{
+    uint32_t h = hash_formats (src_format, mask_format, dest_format);
+
+    h = (h ^ op) * 0x9e3779b1;
+    h = (h ^ src_flags) * 0x85ebca6b;
+    h = (h ^ mask_flags) * 0xc2b2ae35;
+    h = (h ^ dest_flags) * 0x9e3779b1;
+
+    return h >> (32 - FAST_PATH_CACHE_SET_BITS);
+}
+
+static pixman_bool_t
+lookup_linear (pixman_implementation_t  *toplevel,
+	       pixman_op_t               op,
+	       pixman_format_code_t      src_format,
+	       uint32_t                  src_flags,
+	       pixman_format_code_t      mask_format,
+	       uint32_t                  mask_flags,
+	       pixman_format_code_t      dest_format,
+	       uint32_t                  dest_flags,
+	       pixman_implementation_t **out_imp,
+	       pixman_composite_func_t  *out_func)
+{
+    pixman_implementation_t *imp;
+
+    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    {
+	const pixman_fast_path_t *info = imp->fast_paths;
+
+	while (info->op != PIXMAN_OP_NONE)
+	{
+	    if (fast_path_matches (info, op,
+				   src_format, src_flags,
+				   mask_format, mask_flags,
+				   dest_format, dest_flags))
+	    {
+		*out_imp = imp;
+		*out_func = info->func;
+		return TRUE;
+	    }
+
+	    ++info;
+	}
+    }
+
+    return FALSE;
+}
+
+static pixman_bool_t
+lookup_indexed (const pixman_dispatch_index_t *index,
+		pixman_op_t                    op,
+		pixman_format_code_t           src_format,
+		uint32_t                       src_flags,
+		pixman_format_code_t           mask_format,
+		uint32_t                       mask_flags,
+		pixman_format_code_t           dest_format,
+		uint32_t                       dest_flags,
+		pixman_implementation_t      **out_imp,
+		pixman_composite_func_t       *out_func)
+{
+    int list = dispatch_list (op, src_format, mask_format, dest_format);
+    const uint16_t *c = index->candidates + index->lists[list];
+    const uint16_t *end = index->candidates + index->lists[list + 1];
+
+    while (c < end)
+    {
+	const dispatch_entry_t *entry = &index->entries[*c++];
+
+	if (fast_path_matches (entry->fast_path, op,
+			       src_format, src_flags,
+			       mask_format, mask_flags,
+			       dest_format, dest_flags))
+	{
+	    *out_imp = entry->imp;
+	    *out_func = entry->fast_path->func;
+	    return TRUE;
+	}
+    }
+
+    return FALSE;
+}
+
 pixman_bool_t
 _pixman_implementation_lookup_composite (pixman_implementation_t  *toplevel,
 					 pixman_op_t               op,
@@ -77,16 +395,17 @@ _pixman_implementation_lookup_composite (pixman_implementation_t  *toplevel,
 					 pixman_implementation_t **out_imp,
 					 pixman_composite_func_t  *out_func)
 {
-    pixman_implementation_t *imp;
     cache_t *cache;
-    int i;
+    int set, i;
 
     /* Check cache for fast paths */
     cache = PIXMAN_GET_THREAD_LOCAL (fast_path_cache);
+    set = fast_path_cache_set (op, src_format, src_flags,
+			       mask_format, mask_flags, dest_format, dest_flags);
 
-    for (i = 0; i < N_CACHED_FAST_PATHS; ++i)
+    for (i = 0; i < N_FAST_PATH_CACHE_WAYS; ++i)
     {
-	const pixman_fast_path_t *info = &(cache->cache[i].fast_path);
+	const pixman_fast_path_t *info = &(cache->cache[set][i].fast_path);
 
 	/* Note that we check for equality here, not whether
 	 * the cached fast path matches. This is to prevent
@@ -94,6 +413,7 @@ _pixman_implementation_lookup_composite (pixman_implementation_t  *toplevel,
 	 * when a more specific one would work.
 	 */
 	if (info->op == op			&&
+	    cache->cache[set][i].toplevel == toplevel &&
 	    info->src_format == src_format	&&
 	    info->mask_format == mask_format	&&
 	    info->dest_format == dest_format	&&
@@ -102,63 +422,52 @@ _pixman_implementation_lookup_composite (pixman_implementation_t  *toplevel,
 	    info->dest_flags == dest_flags	&&
 	    info->func)
 	{
-	    *out_imp = cache->cache[i].imp;
-	    *out_func = cache->cache[i].fast_path.func;
+	    *out_imp = cache->cache[set][i].imp;
+	    *out_func = cache->cache[set][i].fast_path.func;
 
 	    goto update_cache;
 	}
     }
 
-    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    if (toplevel->dispatch_index && (unsigned)op < PIXMAN_N_OPERATORS)
     {
-	const pixman_fast_path_t *info = imp->fast_paths;
-
-	while (info->op != PIXMAN_OP_NONE)
+	if (!lookup_indexed (toplevel->dispatch_index, op,
+			     src_format, src_flags,
+			     mask_format, mask_flags,
+			     dest_format, dest_flags,
+			     out_imp, out_func))
 	{
-	    if ((info->op == op || info->op == PIXMAN_OP_any)		&&
-		/* Formats */
-		((info->src_format == src_format) ||
-		 (info->src_format == PIXMAN_any))			&&
-		((info->mask_format == mask_format) ||
-		 (info->mask_format == PIXMAN_any))			&&
-		((info->dest_format == dest_format) ||
-		 (info->dest_format == PIXMAN_any))			&&
-		/* Flags */
-		(info->src_flags & src_flags) == info->src_flags	&&
-		(info->mask_flags & mask_flags) == info->mask_flags	&&
-		(info->dest_flags & dest_flags) == info->dest_flags)
-	    {
-		*out_imp = imp;
-		*out_func = info->func;
-
-		/* Set i to the last spot in the cache so that the
-		 * move-to-front code below will work
-		 */
-		i = N_CACHED_FAST_PATHS - 1;
-
-		goto update_cache;
-	    }
-
-	    ++info;
+	    return FALSE;
 	}
     }
-    return FALSE;
+    else if (!lookup_linear (toplevel, op,
+			     src_format, src_flags,
+			     mask_format, mask_flags,
+			     dest_format, dest_flags,
+			     out_imp, out_func))
+    {
+	return FALSE;
+    }
+
+    /* Evict the least recently used way of the set */
+    i = N_FAST_PATH_CACHE_WAYS - 1;
 
 update_cache:
     if (i)
     {
 	while (i--)
-	    cache->cache[i + 1] = cache->cache[i];
-
-	cache->cache[0].imp = *out_imp;
-	cache->cache[0].fast_path.op = op;
-	cache->cache[0].fast_path.src_format = src_format;
-	cache->cache[0].fast_path.src_flags = src_flags;
-	cache->cache[0].fast_path.mask_format = mask_format;
-	cache->cache[0].fast_path.mask_flags = mask_flags;
-	cache->cache[0].fast_path.dest_format = dest_format;
-	cache->cache[0].fast_path.dest_flags = dest_flags;
-	cache->cache[0].fast_path.func = *out_func;
+	    cache->cache[set][i + 1] = cache->cache[set][i];
+
+	cache->cache[set][0].toplevel = toplevel;
+	cache->cache[set][0].imp = *out_imp;
+	cache->cache[set][0].fast_path.op = op;
+	cache->cache[set][0].fast_path.src_format = src_format;
+	cache->cache[set][0].fast_path.src_flags = src_flags;
+	cache->cache[set][0].fast_path.mask_format = mask_format;
+	cache->cache[set][0].fast_path.mask_flags = mask_flags;
+	cache->cache[set][0].fast_path.dest_format = dest_format;
+	cache->cache[set][0].fast_path.dest_flags = dest_flags;
+	cache->cache[set][0].fast_path.func = *out_func;
     }
 
     return TRUE;
@@ -259,30 +568,20 @@ _pixman_implementation_fill (pixman_implementation_t *imp,
 }
 
 pixman_bool_t
-_pixman_implementation_src_iter_init (pixman_implementation_t	*imp,
-				      pixman_iter_t             *iter,
-				      pixman_image_t		*image,
-				      int			 x,
-				      int			 y,
-				      int			 width,
-				      int			 height,
-				      uint8_t			*buffer,
-				      iter_flags_t		 iter_flags,
-				      uint32_t                   image_flags)
+_pixman_implementation_glyphs (pixman_implementation_t  *imp,
+                               pixman_op_t               op,
+                               uint32_t                  src,
+                               int                       dest_stride,
+                               const pixman_glyph_box_t *boxes,
+                               int                       n_boxes)
 {
-    iter->image = image;
-    iter->buffer = (uint32_t *)buffer;
-    iter->x = x;
-    iter->y = y;
-    iter->width = width;
-    iter->height = height;
-    iter->iter_flags = iter_flags;
-    iter->image_flags = image_flags;
-
     while (imp)
     {
-	if (imp->src_iter_init && (*imp->src_iter_init) (imp, iter))
+	if (imp->glyphs &&
+	    ((*imp->glyphs) (imp, op, src, dest_stride, boxes, n_boxes)))
+	{
 	    return TRUE;
+	}
 
 	imp = imp->fallback;
     }
@@ -290,18 +589,91 @@ _pixman_implementation_src_iter_init (pixman_implementation_t	*imp,
     return FALSE;
 }
 
-pixman_bool_t
-_pixman_implementation_dest_iter_init (pixman_implementation_t	*imp,
-				       pixman_iter_t            *iter,
-				       pixman_image_t		*image,
-				       int			 x,
-				       int			 y,
-				       int			 width,
-				       int			 height,
-				       uint8_t			*buffer,
-				       iter_flags_t		 iter_flags,
-				       uint32_t                  image_flags)
+static uint32_t *
+get_scanline_null (pixman_iter_t *iter, const uint32_t *mask)
+{
+    return NULL;
+}
+
+/* Flags that a composite operation may add to the flags of an image,
+ * depending on the area being composited.
+ */
+#define COMPOSITE_IMAGE_FLAGS						\
+    (FAST_PATH_SAMPLES_COVER_CLIP_NEAREST	|			\
+     FAST_PATH_SAMPLES_COVER_CLIP_BILINEAR	|			\
+     FAST_PATH_IS_OPAQUE)
+
+static force_inline pixman_bool_t
+iter_info_matches (const pixman_iter_info_t *info,
+		   pixman_format_code_t      format,
+		   uint32_t                  image_flags,
+		   iter_flags_t              iter_flags)
+{
+    return
+	(info->format == PIXMAN_any || info->format == format)	&&
+	(info->image_flags & image_flags) == info->image_flags	&&
+	(info->iter_flags & iter_flags) == info->iter_flags;
+}
+
+void
+_pixman_implementation_cache_iters (pixman_implementation_t *imp,
+				    pixman_image_t          *image)
+{
+    pixman_format_code_t format = image->common.extended_format_code;
+    uint32_t image_flags = image->common.flags | COMPOSITE_IMAGE_FLAGS;
+    image_common_t *common = &image->common;
+    int n = 0;
+
+    common->iter_imp = imp;
+
+    for (; imp != NULL; imp = imp->fallback)
+    {
+	const pixman_iter_info_t *info;
+
+	if (!imp->iter_info)
+	    continue;
+
+	for (info = imp->iter_info; info->format != PIXMAN_null; ++info)
+	{
+	    if (!iter_info_matches (info, format, image_flags, info->iter_flags))
+		continue;
+
+	    if (n == N_CACHED_ITERS)
+	    {
+		common->n_cached_iters = -1;
+		return;
+	    }
+
+	    common->cached_iters[n++] = info;
+
+	    /* Nothing after an entry that matches everything can be chosen */
+	    if (info->image_flags == 0 && info->iter_flags == 0 &&
+		info->format == PIXMAN_any)
+	    {
+		common->n_cached_iters = n;
+		return;
+	    }
+	}
+    }
+
+    common->n_cached_iters = n;
+}
+
+void
+_pixman_implementation_iter_init (pixman_implementation_t *imp,
+				  pixman_iter_t           *iter,
+				  pixman_image_t          *image,
+				  int                      x,
+				  int                      y,
+				  int                      width,
+				  int                      height,
+				  uint8_t                 *buffer,
+				  iter_flags_t             iter_flags,
+				  uint32_t                 image_flags)
 {
+    const pixman_iter_info_t *info;
+    pixman_format_code_t format;
+
     iter->image = image;
     iter->buffer = (uint32_t *)buffer;
     iter->x = x;
@@ -310,13 +682,92 @@ _pixman_implementation_dest_iter_init (pixman_implementation_t	*imp,
     iter->height = height;
     iter->iter_flags = iter_flags;
     iter->image_flags = image_flags;
+    iter->fini = NULL;
 
-    while (imp)
+    if (!image)
+    {
+	iter->get_scanline = get_scanline_null;
+	return;
+    }
+
+    format = image->common.extended_format_code;
+
+    /* Only the iterators that _pixman_image_validate() found to be
+     * possible for this image need to be considered.
+     */
+    if (image->common.iter_imp == imp		&&
+	image->common.n_cached_iters >= 0	&&
+	!image->common.dirty			&&
+	(image_flags & ~(image->common.flags | COMPOSITE_IMAGE_FLAGS)) == 0)
     {
-	if (imp->dest_iter_init && (*imp->dest_iter_init) (imp, iter))
+	int i;
+
+	for (i = 0; i < image->common.n_cached_iters; ++i)
+	{
+	    info = image->common.cached_iters[i];
+
+	    if (iter_info_matches (info, format, image_flags, iter_flags))
+		goto found;
+	}
+    }
+    else
+    {
+	for (; imp != NULL; imp = imp->fallback)
+	{
+	    if (!imp->iter_info)
+		continue;
+
+	    for (info = imp->iter_info; info->format != PIXMAN_null; ++info)
+	    {
+		if (iter_info_matches (info, format, image_flags, iter_flags))
+		    goto found;
+	    }
+	}
+    }
+
+    /* The general implementation handles everything, so this
+     * shouldn't happen
+     */
+    _pixman_log_error (FUNC, "No iterator found\n");
+    iter->get_scanline = _pixman_iter_get_scanline_noop;
+    iter->write_back = NULL;
+    return;
+
+found:
+    iter->get_scanline = info->get_scanline;
+    iter->write_back = info->write_back;
+
+    if (info->initializer)
+	info->initializer (iter, info);
+}
+
+/* Runtime selection of the implementation chain
+ *
+ * While a chain is being built, these hold the name of the topmost
+ * implementation that may be used and a list of implementations that
+ * must be left out, as passed to pixman_set_implementations().
+ */
+static const char *	selected_top;
+static const char *	selected_exclude;
+static pixman_bool_t	selected_top_reached;
+
+/* Whether @name appears in @list, a list of names separated by spaces
+ * or commas.
+ */
+static pixman_bool_t
+name_in_list (const char *name, const char *list)
+{
+    size_t name_len = strlen (name);
+
+    while (*list)
+    {
+	size_t len = strcspn (list, " ,");
+
+	if (len == name_len && strncmp (name, list, len) == 0)
 	    return TRUE;
 
-	imp = imp->fallback;
+	list += len;
+	list += strspn (list, " ,");
     }
 
     return FALSE;
@@ -327,37 +778,34 @@ _pixman_disabled (const char *name)
 {
     const char *env;
 
-    if ((env = getenv ("PIXMAN_DISABLE")))
-    {
-	do
-	{
-	    const char *end;
-	    int len;
+    /* Everything above the selected implementation is disabled */
+    if (selected_top_reached)
+	return TRUE;
 
-	    if ((end = strchr (env, ' ')))
-		len = end - env;
-	    else
-		len = strlen (env);
+    if (selected_top && strcmp (name, selected_top) == 0)
+	selected_top_reached = TRUE;
 
-	    if (strlen (name) == len && strncmp (name, env, len) == 0)
-	    {
-		printf ("pixman: Disabled %s implementation\n", name);
-		return TRUE;
-	    }
+    if (selected_exclude && name_in_list (name, selected_exclude))
+	return TRUE;
 
-	    env += len;
-	}
-	while (*env++);
+    if ((env = getenv ("PIXMAN_DISABLE")) && name_in_list (name, env))
+    {
+	printf ("pixman: Disabled %s implementation\n", name);
+	return TRUE;
     }
 
     return FALSE;
 }
 
 pixman_implementation_t *
-_pixman_choose_implementation (void)
+_pixman_select_implementation (const char *top, const char *exclude)
 {
     pixman_implementation_t *imp;
 
+    selected_top = top;
+    selected_exclude = exclude;
+    selected_top_reached = top && strcmp (top, "general") == 0;
+
     imp = _pixman_implementation_create_general();
 
     if (!_pixman_disabled ("fast"))
@@ -370,5 +818,30 @@ _pixman_choose_implementation (void)
 
     imp = _pixman_implementation_create_noop (imp);
 
+    selected_top = NULL;
+    selected_exclude = NULL;
+    selected_top_reached = FALSE;
+
     return imp;
 }
+
+pixman_implementation_t *
+_pixman_choose_implementation (void)
+{
+    return _pixman_select_implementation (NULL, NULL);
+}
+
+void
+_pixman_implementation_destroy (pixman_implementation_t *imp)
+{
+    dispatch_index_free (imp->dispatch_index);
+
+    while (imp)
+    {
+	pixman_implementation_t *fallback = imp->fallback;
+
+	free (imp);
+
+	imp = fallback;
+    }
+}
@@ -26,6 +26,7 @@
 #ifndef PIXMAN_FAST_PATH_H__
 #define PIXMAN_FAST_PATH_H__
 
+#include <stdlib.h>
 #include "pixman-private.h"
 
 #define PIXMAN_REPEAT_COVER -1
@@ -1299,4 +1300,430 @@ fast_composite_scaled_bilinear ## scale_func_name (pixman_implementation_t *imp,
     SIMPLE_BILINEAR_SOLID_MASK_FAST_PATH_PAD (op,s,d,func),		\
     SIMPLE_BILINEAR_SOLID_MASK_FAST_PATH_NORMAL (op,s,d,func)
 
+/*
+ * Composites from the YUV formats to x8r8g8b8 and a8r8g8b8, unscaled,
+ * and scaled with COVER or PAD repeat. The part of each source row that
+ * a destination row samples is converted with fetch_row, and converted
+ * rows are cached, since when scaling up neighbouring destination rows
+ * use the same source rows. YUV sources are opaque, so OVER is reduced
+ * to SRC before fast paths are looked up.
+ */
+typedef void (* yuv_fetch_row_t) (uint32_t *     dst,
+				  bits_image_t * image,
+				  int            x,
+				  int            line,
+				  int            width);
+
+typedef void (* yuv_bilinear_scanline_t) (uint32_t *       dst,
+					  const uint32_t * mask,
+					  const uint32_t * src_top,
+					  const uint32_t * src_bottom,
+					  int32_t          w,
+					  int              wt,
+					  int              wb,
+					  pixman_fixed_t   vx,
+					  pixman_fixed_t   unit_x,
+					  pixman_fixed_t   max_vx,
+					  pixman_bool_t    zero_src);
+
+#define YUV_STACK_ROW_SIZE	1024
+
+static force_inline void
+yuv_get_lines (bits_image_t *   image,
+	       int              line,
+	       const uint8_t ** y_line,
+	       const uint8_t ** u_line,
+	       const uint8_t ** v_line)
+{
+    if (image->format == PIXMAN_yuy2)
+    {
+	*y_line = (const uint8_t *)(image->bits + image->rowstride * line);
+	*u_line = *v_line = NULL;
+    }
+    else
+    {
+	*y_line = PLANE_LINE (image, 0, line);
+	*u_line = PLANE_LINE (image, 1, line);
+	*v_line = image->format == PIXMAN_nv12 ?
+	    NULL : PLANE_LINE (image, 2, line);
+    }
+}
+
+static force_inline uint32_t
+yuv_fetch_pixel (pixman_format_code_t format,
+		 const uint8_t *      y_line,
+		 const uint8_t *      u_line,
+		 const uint8_t *      v_line,
+		 int                  x)
+{
+    if (format == PIXMAN_yuy2)
+    {
+	return convert_yuv_to_8888 (y_line[x << 1],
+				    y_line[((x << 1) & -4) + 1],
+				    y_line[((x << 1) & -4) + 3]);
+    }
+    else if (format == PIXMAN_nv12)
+    {
+	return convert_yuv_to_8888 (y_line[x],
+				    u_line[(x & ~1) + 0],
+				    u_line[(x & ~1) + 1]);
+    }
+    else
+    {
+	return convert_yuv_to_8888 (y_line[x], u_line[x >> 1], v_line[x >> 1]);
+    }
+}
+
+static force_inline void
+yuv_composite_src (pixman_composite_info_t *info,
+		   yuv_fetch_row_t          fetch_row)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t *dst_line;
+    int dst_stride;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    while (--height >= 0)
+    {
+	fetch_row (dst_line, &src_image->bits, src_x, src_y++, width);
+
+	dst_line += dst_stride;
+    }
+}
+
+/* The source columns that have to be converted for a destination row:
+ * those sampled by the 'width' pixels starting at vx, plus 'extra' to
+ * the right, and the edge pixels when there is padding.
+ */
+static force_inline void
+yuv_get_span (bits_image_t * image,
+	      pixman_fixed_t vx,
+	      pixman_fixed_t unit_x,
+	      int            width,
+	      int            left_pad,
+	      int            right_pad,
+	      int            extra,
+	      int *          x0,
+	      int *          n)
+{
+    int first_x = image->width, last_x = -1;
+
+    if (width > 0)
+    {
+	int64_t last = vx + (int64_t)unit_x * (width - 1);
+
+	first_x = pixman_fixed_to_int (unit_x < 0 ? last : vx);
+	last_x = pixman_fixed_to_int (unit_x < 0 ? vx : last) + extra;
+    }
+
+    if (left_pad > 0)
+	first_x = 0;
+    if (right_pad > 0 || last_x > image->width - 1)
+	last_x = image->width - 1;
+    if (first_x > last_x)
+	first_x = last_x = (left_pad > 0) ? 0 : image->width - 1;
+
+    *x0 = first_x;
+    *n = last_x - first_x + 1;
+}
+
+static force_inline void
+yuv_composite_scaled_nearest (pixman_composite_info_t *info,
+			      yuv_fetch_row_t          fetch_row)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    bits_image_t *src = &src_image->bits;
+    uint32_t stack_row[YUV_STACK_ROW_SIZE];
+    uint32_t *row = stack_row;
+    uint32_t *dst_line, *dst;
+    int dst_stride, row_y = -1;
+    int32_t left_pad = 0, right_pad = 0;
+    int x0, n, i;
+    pixman_vector_t v;
+    pixman_fixed_t vx, vy, unit_x, unit_y;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    v.vector[0] = pixman_int_to_fixed (src_x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (src_y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (!pixman_transform_point_3d (src_image->common.transform, &v))
+	return;
+
+    unit_x = src_image->common.transform->matrix[0][0];
+    unit_y = src_image->common.transform->matrix[1][1];
+
+    vx = v.vector[0] - pixman_fixed_e;
+    vy = v.vector[1] - pixman_fixed_e;
+
+    /* PAD fast paths require a positive unit_x, and COVER ones don't
+     * have any padding.
+     */
+    if (unit_x > 0)
+    {
+	pad_repeat_get_scanline_bounds (src->width, vx, unit_x,
+					&width, &left_pad, &right_pad);
+	vx += left_pad * unit_x;
+    }
+
+    /* Without horizontal scaling, rows are converted in place */
+    if (unit_x == pixman_fixed_1 && !left_pad && !right_pad)
+    {
+	while (--height >= 0)
+	{
+	    int y = pixman_fixed_to_int (vy);
+
+	    repeat (PIXMAN_REPEAT_PAD, &y, src->height);
+	    fetch_row (dst_line, src, pixman_fixed_to_int (vx), y, width);
+
+	    dst_line += dst_stride;
+	    vy += unit_y;
+	}
+
+	return;
+    }
+
+    yuv_get_span (src, vx, unit_x, width, left_pad, right_pad, 0, &x0, &n);
+
+    if (n > YUV_STACK_ROW_SIZE)
+    {
+	if (!(row = pixman_malloc_ab (n, sizeof (uint32_t))))
+	    return;
+    }
+
+    while (--height >= 0)
+    {
+	pixman_fixed_t x = vx - pixman_int_to_fixed (x0);
+	int y = pixman_fixed_to_int (vy);
+
+	repeat (PIXMAN_REPEAT_PAD, &y, src->height);
+	if (y != row_y)
+	{
+	    fetch_row (row, src, x0, y, n);
+	    row_y = y;
+	}
+
+	dst = dst_line;
+	dst_line += dst_stride;
+	vy += unit_y;
+
+	for (i = 0; i < left_pad; ++i)
+	    *dst++ = row[0];
+
+	for (i = 0; i < width; ++i)
+	{
+	    *dst++ = row[pixman_fixed_to_int (x)];
+	    x += unit_x;
+	}
+
+	for (i = 0; i < right_pad; ++i)
+	    *dst++ = row[n - 1];
+    }
+
+    if (row != stack_row)
+	free (row);
+}
+
+/* Returns the cached row for source line y, converting it into a slot
+ * other than the one holding line 'keep' if necessary. The rows have an
+ * extra pixel at the end, so that the right neighbour of the last pixel
+ * can be read when its weight is zero.
+ */
+static force_inline const uint32_t *
+yuv_get_cached_row (bits_image_t *  image,
+		    yuv_fetch_row_t fetch_row,
+		    uint32_t *      rows[2],
+		    int             row_y[2],
+		    int             y,
+		    int             keep,
+		    int             x0,
+		    int             n)
+{
+    int slot;
+
+    if (row_y[0] == y)
+	return rows[0];
+    if (row_y[1] == y)
+	return rows[1];
+
+    slot = (row_y[0] == keep) ? 1 : 0;
+
+    fetch_row (rows[slot], image, x0, y, n);
+    rows[slot][n] = rows[slot][n - 1];
+    row_y[slot] = y;
+
+    return rows[slot];
+}
+
+static force_inline void
+yuv_composite_scaled_bilinear (pixman_composite_info_t *info,
+			       yuv_fetch_row_t          fetch_row,
+			       yuv_bilinear_scanline_t  scanline_func)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    bits_image_t *src = &src_image->bits;
+    uint32_t stack_rows[2 * (YUV_STACK_ROW_SIZE + 1)];
+    uint32_t *rows[2];
+    int row_y[2] = { -1, -1 };
+    uint32_t *dst_line, *dst;
+    int dst_stride;
+    int32_t left_pad = 0, left_tz = 0, right_tz = 0, right_pad = 0;
+    int x0, n;
+    pixman_vector_t v;
+    pixman_fixed_t vx, vy, unit_x, unit_y;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    v.vector[0] = pixman_int_to_fixed (src_x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (src_y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (!pixman_transform_point_3d (src_image->common.transform, &v))
+	return;
+
+    unit_x = src_image->common.transform->matrix[0][0];
+    unit_y = src_image->common.transform->matrix[1][1];
+
+    vx = v.vector[0] - pixman_fixed_1 / 2;
+    vy = v.vector[1] - pixman_fixed_1 / 2;
+
+    /* With PAD repeat the transition zones interpolate between copies
+     * of the edge pixels, so they can be handled as padding.
+     */
+    if (unit_x > 0)
+    {
+	bilinear_pad_repeat_get_scanline_bounds (src->width, vx, unit_x,
+						 &left_pad, &left_tz, &width,
+						 &right_tz, &right_pad);
+	left_pad += left_tz;
+	right_pad += right_tz;
+	vx += left_pad * unit_x;
+    }
+
+    yuv_get_span (src, vx, unit_x, width, left_pad, right_pad, 1, &x0, &n);
+
+    rows[0] = stack_rows;
+    if (n > YUV_STACK_ROW_SIZE)
+    {
+	if (!(rows[0] = pixman_malloc_ab (2 * (n + 1), sizeof (uint32_t))))
+	    return;
+    }
+    rows[1] = rows[0] + n + 1;
+
+    while (--height >= 0)
+    {
+	const uint32_t *top, *bottom;
+	uint32_t buf1[2], buf2[2];
+	int y1, y2, weight1, weight2;
+
+	y1 = pixman_fixed_to_int (vy);
+	weight2 = pixman_fixed_to_bilinear_weight (vy);
+	if (weight2)
+	{
+	    y2 = y1 + 1;
+	    weight1 = BILINEAR_INTERPOLATION_RANGE - weight2;
+	}
+	else
+	{
+	    y2 = y1;
+	    weight1 = weight2 = BILINEAR_INTERPOLATION_RANGE / 2;
+	}
+	vy += unit_y;
+
+	repeat (PIXMAN_REPEAT_PAD, &y1, src->height);
+	repeat (PIXMAN_REPEAT_PAD, &y2, src->height);
+
+	top = yuv_get_cached_row (src, fetch_row, rows, row_y,
+				  y1, y2, x0, n);
+	bottom = yuv_get_cached_row (src, fetch_row, rows, row_y,
+				     y2, y1, x0, n);
+
+	dst = dst_line;
+	dst_line += dst_stride;
+
+	if (left_pad > 0)
+	{
+	    buf1[0] = buf1[1] = top[0];
+	    buf2[0] = buf2[1] = bottom[0];
+	    scanline_func (dst, NULL, buf1, buf2, left_pad,
+			   weight1, weight2, 0, 0, 0, FALSE);
+	    dst += left_pad;
+	}
+
+	if (width > 0)
+	{
+	    scanline_func (dst, NULL, top, bottom, width,
+			   weight1, weight2, vx - pixman_int_to_fixed (x0),
+			   unit_x, 0, FALSE);
+	    dst += width;
+	}
+
+	if (right_pad > 0)
+	{
+	    buf1[0] = buf1[1] = top[n - 1];
+	    buf2[0] = buf2[1] = bottom[n - 1];
+	    scanline_func (dst, NULL, buf1, buf2, right_pad,
+			   weight1, weight2, 0, 0, 0, FALSE);
+	}
+    }
+
+    if (rows[0] != stack_rows)
+	free (rows[0]);
+}
+
+/* Defines the composite functions for the YUV fast paths, given a
+ * function converting rows of YUV to x8r8g8b8 and a bilinear scanline
+ * function for SRC.
+ */
+#define FAST_YUV(name, fetch_row, bilinear_scanline)			\
+static void								\
+fast_composite_src_ ## name (pixman_implementation_t *imp,		\
+			     pixman_composite_info_t *info)		\
+{									\
+    yuv_composite_src (info, fetch_row);				\
+}									\
+									\
+static void								\
+fast_composite_scaled_nearest_ ## name ## _cover_SRC (			\
+    pixman_implementation_t *imp, pixman_composite_info_t *info)	\
+{									\
+    yuv_composite_scaled_nearest (info, fetch_row);			\
+}									\
+									\
+static void								\
+fast_composite_scaled_nearest_ ## name ## _pad_SRC (			\
+    pixman_implementation_t *imp, pixman_composite_info_t *info)	\
+{									\
+    yuv_composite_scaled_nearest (info, fetch_row);			\
+}									\
+									\
+static void								\
+fast_composite_scaled_bilinear_ ## name ## _cover_SRC (			\
+    pixman_implementation_t *imp, pixman_composite_info_t *info)	\
+{									\
+    yuv_composite_scaled_bilinear (info, fetch_row, bilinear_scanline);	\
+}									\
+									\
+static void								\
+fast_composite_scaled_bilinear_ ## name ## _pad_SRC (			\
+    pixman_implementation_t *imp, pixman_composite_info_t *info)	\
+{									\
+    yuv_composite_scaled_bilinear (info, fetch_row, bilinear_scanline);	\
+}
+
+#define YUV_FAST_PATHS_FORMAT(s,d,func)					\
+    PIXMAN_STD_FAST_PATH (SRC, s, null, d, fast_composite_src_ ## func),	\
+    SIMPLE_NEAREST_FAST_PATH_COVER (SRC, s, d, func),			\
+    SIMPLE_NEAREST_FAST_PATH_PAD (SRC, s, d, func),			\
+    SIMPLE_BILINEAR_FAST_PATH_COVER (SRC, s, d, func),			\
+    SIMPLE_BILINEAR_FAST_PATH_PAD (SRC, s, d, func)
+
+#define YUV_FAST_PATHS(d,func)						\
+    YUV_FAST_PATHS_FORMAT (yuy2, d, func),				\
+    YUV_FAST_PATHS_FORMAT (yv12, d, func),				\
+    YUV_FAST_PATHS_FORMAT (i420, d, func),				\
+    YUV_FAST_PATHS_FORMAT (nv12, d, func)
+
 #endif
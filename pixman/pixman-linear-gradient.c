@@ -88,9 +88,101 @@ linear_gradient_is_horizontal (pixman_image_t *image,
     return FALSE;
 }
 
-static uint32_t *
-linear_get_scanline_narrow (pixman_iter_t  *iter,
-			    const uint32_t *mask)
+/* The position of the center of pixel (x, y) in gradient space, and the
+ * step from one pixel to the next in a row.
+ */
+static pixman_bool_t
+linear_get_vectors (pixman_image_t  *image,
+		    int              x,
+		    int              y,
+		    pixman_vector_t *v,
+		    pixman_vector_t *unit)
+{
+    /* reference point is the center of the pixel */
+    v->vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
+    v->vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
+    v->vector[2] = pixman_fixed_1;
+
+    if (image->common.transform)
+    {
+	if (!pixman_transform_point_3d (image->common.transform, v))
+	    return FALSE;
+
+	unit->vector[0] = image->common.transform->matrix[0][0];
+	unit->vector[1] = image->common.transform->matrix[1][0];
+	unit->vector[2] = image->common.transform->matrix[2][0];
+    }
+    else
+    {
+	unit->vector[0] = pixman_fixed_1;
+	unit->vector[1] = 0;
+	unit->vector[2] = 0;
+    }
+
+    return TRUE;
+}
+
+/* When the transformation is affine along the row, the parameter of
+ * pixel x + i of row y is t + (pixman_fixed_32_32_t)(inc * i). Returns
+ * FALSE when it isn't, or when the row can't be transformed.
+ */
+pixman_bool_t
+_pixman_linear_gradient_get_affine (pixman_image_t       *image,
+				    int                   x,
+				    int                   y,
+				    pixman_fixed_32_32_t *t,
+				    double               *inc)
+{
+    linear_gradient_t *linear = (linear_gradient_t *)image;
+    pixman_vector_t v, unit;
+    pixman_fixed_32_32_t l;
+    pixman_fixed_48_16_t dx, dy;
+
+    if (!linear_get_vectors (image, x, y, &v, &unit))
+	return FALSE;
+
+    dx = linear->p2.x - linear->p1.x;
+    dy = linear->p2.y - linear->p1.y;
+
+    l = dx * dx + dy * dy;
+
+    if (l != 0 && unit.vector[2] != 0)
+	return FALSE;
+
+    if (l == 0 || v.vector[2] == 0)
+    {
+	*t = 0;
+	*inc = 0;
+    }
+    else
+    {
+	double invden, v2;
+
+	invden = pixman_fixed_1 * (double) pixman_fixed_1 /
+	    (l * (double) v.vector[2]);
+	v2 = v.vector[2] * (1. / pixman_fixed_1);
+	*t = ((dx * v.vector[0] + dy * v.vector[1]) - 
+	      (dx * linear->p1.x + dy * linear->p1.y) * v2) * invden;
+	*inc = (dx * unit.vector[0] + dy * unit.vector[1]) * invden;
+    }
+
+    return TRUE;
+}
+
+static force_inline uint32_t
+linear_pixel (gradient_t               *gradient,
+	      pixman_gradient_walker_t *walker,
+	      pixman_fixed_48_16_t      t)
+{
+    if (gradient->lut)
+	return gradient_lut_pixel (gradient->lut, gradient->common.repeat, t);
+    else
+	return _pixman_gradient_walker_pixel (walker, t);
+}
+
+uint32_t *
+_pixman_linear_gradient_get_scanline_narrow (pixman_iter_t  *iter,
+					     const uint32_t *mask)
 {
     pixman_image_t *image  = iter->image;
     int             x      = iter->x;
@@ -105,64 +197,23 @@ linear_get_scanline_narrow (pixman_iter_t  *iter,
     linear_gradient_t *linear = (linear_gradient_t *)image;
     uint32_t *end = buffer + width;
     pixman_gradient_walker_t walker;
+    pixman_fixed_32_32_t t;
+    double inc;
 
     _pixman_gradient_walker_init (&walker, gradient, image->common.repeat);
 
-    /* reference point is the center of the pixel */
-    v.vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
-    v.vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
-    v.vector[2] = pixman_fixed_1;
-
-    if (image->common.transform)
-    {
-	if (!pixman_transform_point_3d (image->common.transform, &v))
-	    return iter->buffer;
-
-	unit.vector[0] = image->common.transform->matrix[0][0];
-	unit.vector[1] = image->common.transform->matrix[1][0];
-	unit.vector[2] = image->common.transform->matrix[2][0];
-    }
-    else
-    {
-	unit.vector[0] = pixman_fixed_1;
-	unit.vector[1] = 0;
-	unit.vector[2] = 0;
-    }
-
-    dx = linear->p2.x - linear->p1.x;
-    dy = linear->p2.y - linear->p1.y;
-
-    l = dx * dx + dy * dy;
-
-    if (l == 0 || unit.vector[2] == 0)
+    if (_pixman_linear_gradient_get_affine (image, x, y, &t, &inc))
     {
 	/* affine transformation only */
-        pixman_fixed_32_32_t t, next_inc;
-	double inc;
+        pixman_fixed_32_32_t next_inc;
 
-	if (l == 0 || v.vector[2] == 0)
-	{
-	    t = 0;
-	    inc = 0;
-	}
-	else
-	{
-	    double invden, v2;
-
-	    invden = pixman_fixed_1 * (double) pixman_fixed_1 /
-		(l * (double) v.vector[2]);
-	    v2 = v.vector[2] * (1. / pixman_fixed_1);
-	    t = ((dx * v.vector[0] + dy * v.vector[1]) - 
-		 (dx * linear->p1.x + dy * linear->p1.y) * v2) * invden;
-	    inc = (dx * unit.vector[0] + dy * unit.vector[1]) * invden;
-	}
 	next_inc = 0;
 
 	if (((pixman_fixed_32_32_t )(inc * width)) == 0)
 	{
 	    register uint32_t color;
 
-	    color = _pixman_gradient_walker_pixel (&walker, t);
+	    color = linear_pixel (gradient, &walker, t);
 	    while (buffer < end)
 		*buffer++ = color;
 	}
@@ -174,10 +225,7 @@ linear_get_scanline_narrow (pixman_iter_t  *iter,
 	    while (buffer < end)
 	    {
 		if (!mask || *mask++)
-		{
-		    *buffer = _pixman_gradient_walker_pixel (&walker,
-							     t + next_inc);
-		}
+		    *buffer = linear_pixel (gradient, &walker, t + next_inc);
 		i++;
 		next_inc = inc * i;
 		buffer++;
@@ -189,6 +237,14 @@ linear_get_scanline_narrow (pixman_iter_t  *iter,
 	/* projective transformation */
         double t;
 
+	if (!linear_get_vectors (image, x, y, &v, &unit))
+	    return iter->buffer;
+
+	dx = linear->p2.x - linear->p1.x;
+	dy = linear->p2.y - linear->p1.y;
+
+	l = dx * dx + dy * dy;
+
 	t = 0;
 
 	while (buffer < end)
@@ -206,7 +262,7 @@ linear_get_scanline_narrow (pixman_iter_t  *iter,
 			 (dx * linear->p1.x + dy * linear->p1.y) * v2) * invden;
 		}
 
-		*buffer = _pixman_gradient_walker_pixel (&walker, t);
+		*buffer = linear_pixel (gradient, &walker, t);
 	    }
 
 	    ++buffer;
@@ -225,7 +281,7 @@ linear_get_scanline_narrow (pixman_iter_t  *iter,
 static uint32_t *
 linear_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
 {
-    uint32_t *buffer = linear_get_scanline_narrow (iter, NULL);
+    uint32_t *buffer = _pixman_linear_gradient_get_scanline_narrow (iter, NULL);
 
     pixman_expand_to_float (
 	(argb_t *)buffer, buffer, PIXMAN_a8r8g8b8, iter->width);
@@ -240,7 +296,7 @@ _pixman_linear_gradient_iter_init (pixman_image_t *image, pixman_iter_t  *iter)
 	    iter->image, iter->x, iter->y, iter->width, iter->height))
     {
 	if (iter->iter_flags & ITER_NARROW)
-	    linear_get_scanline_narrow (iter, NULL);
+	    _pixman_linear_gradient_get_scanline_narrow (iter, NULL);
 	else
 	    linear_get_scanline_wide (iter, NULL);
 
@@ -249,7 +305,7 @@ _pixman_linear_gradient_iter_init (pixman_image_t *image, pixman_iter_t  *iter)
     else
     {
 	if (iter->iter_flags & ITER_NARROW)
-	    iter->get_scanline = linear_get_scanline_narrow;
+	    iter->get_scanline = _pixman_linear_gradient_get_scanline_narrow;
 	else
 	    iter->get_scanline = linear_get_scanline_wide;
     }
@@ -87,6 +87,16 @@ typedef enum
 
 typedef void (*property_changed_func_t) (pixman_image_t *image);
 
+typedef struct pixman_iter_t pixman_iter_t;
+typedef uint32_t *(* pixman_iter_get_scanline_t) (pixman_iter_t *iter, const uint32_t *mask);
+typedef void      (* pixman_iter_write_back_t)   (pixman_iter_t *iter);
+typedef void	  (* pixman_iter_fini_t)	 (pixman_iter_t *iter);
+
+typedef struct pixman_implementation_t pixman_implementation_t;
+typedef struct pixman_iter_info_t pixman_iter_info_t;
+
+#define N_CACHED_ITERS 8
+
 struct image_common
 {
     image_type_t                type;
@@ -105,6 +115,7 @@ struct image_common
     pixman_filter_t             filter;
     pixman_fixed_t *            filter_params;
     int                         n_filter_params;
+    pixman_separable_filter_t * filter_object;	    /* Owns filter_params if set */
     bits_image_t *              alpha_map;
     int                         alpha_origin_x;
     int                         alpha_origin_y;
@@ -116,6 +127,15 @@ struct image_common
 
     uint32_t			flags;
     pixman_format_code_t	extended_format_code;
+
+    /* The iterators that could be chosen for this image, in the order
+     * they would be tried. Computed by _pixman_image_validate(); if
+     * there are more than N_CACHED_ITERS candidates, n_cached_iters
+     * is -1 and the implementations are searched instead.
+     */
+    pixman_implementation_t *	iter_imp;
+    int				n_cached_iters;
+    const pixman_iter_info_t *	cached_iters[N_CACHED_ITERS];
 };
 
 struct solid_fill
@@ -132,6 +152,13 @@ struct gradient
     image_common_t	    common;
     int                     n_stops;
     pixman_gradient_stop_t *stops;
+
+    /* With PIXMAN_GRADIENT_LUT, the colors at GRADIENT_LUT_SIZE + 1
+     * evenly spaced positions from 0 to 1. NULL if the gradient doesn't
+     * use one.
+     */
+    pixman_gradient_precision_t precision;
+    uint32_t *                  lut;
 };
 
 struct linear_gradient
@@ -161,6 +188,44 @@ struct radial_gradient
     double     mindr;
 };
 
+/* With a LUT, radial gradients are evaluated in single precision in
+ * groups of four pixels. The terms of the quadratic for the first pixel
+ * of each group are stepped exactly, so the error doesn't build up along
+ * the row, and the SIMD implementations can give exactly the same
+ * results as the C code.
+ */
+typedef struct
+{
+    /* For the first pixel of the next group, in 32.32 fixed point */
+    pixman_fixed_32_32_t b, db;
+    pixman_fixed_32_32_t c, dc, ddc;
+
+    /* Scaled like the terms in single precision */
+    float		 a, inva;
+    float		 dr, mindr;
+} radial_affine_t;
+
+#define RADIAL_TERM_SCALE (1. / 4294967296.)
+
+static force_inline void
+radial_affine_next_group (radial_affine_t *r,
+			  float           *b,
+			  float           *db,
+			  float           *c,
+			  float           *dc,
+			  float           *ddc)
+{
+    *b = r->b * RADIAL_TERM_SCALE;
+    *db = r->db * RADIAL_TERM_SCALE;
+    *c = r->c * RADIAL_TERM_SCALE;
+    *dc = r->dc * RADIAL_TERM_SCALE;
+    *ddc = r->ddc * RADIAL_TERM_SCALE;
+
+    r->b += 4 * r->db;
+    r->c += 4 * r->dc + 6 * r->ddc;
+    r->dc += 4 * r->ddc;
+}
+
 struct conical_gradient
 {
     gradient_t           common;
@@ -168,6 +233,47 @@ struct conical_gradient
     double		 angle;
 };
 
+/* With a LUT, conical gradients are evaluated in single precision in
+ * groups of four pixels, like radial gradients, with a polynomial
+ * approximation of atan2 (). The coordinates of the first pixel of each
+ * group are stepped in double precision.
+ */
+typedef struct
+{
+    /* For the first pixel of the next group, relative to the center */
+    double		 x, y;
+    double		 dx, dy;
+
+    /* The angle of the gradient, in turns */
+    float		 angle;
+} conical_affine_t;
+
+static force_inline void
+conical_affine_next_group (conical_affine_t *r,
+			   float            *x,
+			   float            *y,
+			   float            *dx,
+			   float            *dy)
+{
+    *x = r->x;
+    *y = r->y;
+    *dx = r->dx;
+    *dy = r->dy;
+
+    r->x += 4 * r->dx;
+    r->y += 4 * r->dy;
+}
+
+/* The coefficients of atan (a) = a·(A1 + a²·(A3 + a²·(A5 + a²·(A7 + a²·A9))))
+ * on [0, 1] from Abramowitz and Stegun 4.4.49, divided by 2π to give
+ * turns. The error is below 1.2e-5 radians.
+ */
+#define CONICAL_ATAN_A1		 0.15913361632952103f
+#define CONICAL_ATAN_A3		-0.05256879812578149f
+#define CONICAL_ATAN_A5		 0.02867033060351712f
+#define CONICAL_ATAN_A7		-0.013549337770242326f
+#define CONICAL_ATAN_A9		 0.0033160091548139485f
+
 struct bits_image
 {
     image_common_t             common;
@@ -179,14 +285,36 @@ struct bits_image
     uint32_t *                 free_me;
     int                        rowstride;  /* in number of uint32_t's */
 
+    /* Planar YUV formats: luma, then the U and V planes, or for nv12
+     * the interleaved UV plane. Chroma is subsampled 2x2.
+     */
+    uint8_t *                  planes[3];
+    int                        plane_strides[3];  /* in bytes */
+
+    /* Ordered dithering of stores to formats with fewer than 8 bits
+     * in a channel. The offset moves the origin of the matrix.
+     */
+    pixman_dither_t            dither;
+    int                        dither_offset_x;
+    int                        dither_offset_y;
+
+    pixman_separable_precision_t separable_precision;
+
     fetch_scanline_t           fetch_scanline_32;
     fetch_pixel_32_t	       fetch_pixel_32;
     store_scanline_t           store_scanline_32;
 
+    /* The store of the format, when store_scanline_32 dithers */
+    store_scanline_t           store_scanline_undithered_32;
+
     fetch_scanline_t	       fetch_scanline_float;
     fetch_pixel_float_t	       fetch_pixel_float;
     store_scanline_t           store_scanline_float;
 
+    /* Source iterator scanline functions for the current flags */
+    pixman_iter_get_scanline_t get_scanline_32;
+    pixman_iter_get_scanline_t get_scanline_float;
+
     /* Used for indirect access to the bits */
     pixman_read_memory_func_t  read_func;
     pixman_write_memory_func_t write_func;
@@ -204,13 +332,10 @@ union pixman_image
     solid_fill_t       solid;
 };
 
-typedef struct pixman_iter_t pixman_iter_t;
-typedef uint32_t *(* pixman_iter_get_scanline_t) (pixman_iter_t *iter, const uint32_t *mask);
-typedef void      (* pixman_iter_write_back_t)   (pixman_iter_t *iter);
-
 typedef enum
 {
     ITER_NARROW =		(1 << 0),
+    ITER_WIDE =			(1 << 1),
 
     /* "Localized alpha" is when the alpha channel is used only to compute
      * the alpha value of the destination. This means that the computation
@@ -227,9 +352,15 @@ typedef enum
      * we can treat it as if it were ARGB, which means in some cases we can
      * avoid copying it to a temporary buffer.
      */
-    ITER_LOCALIZED_ALPHA =	(1 << 1),
-    ITER_IGNORE_ALPHA =		(1 << 2),
-    ITER_IGNORE_RGB =		(1 << 3)
+    ITER_LOCALIZED_ALPHA =	(1 << 2),
+    ITER_IGNORE_ALPHA =		(1 << 3),
+    ITER_IGNORE_RGB =		(1 << 4),
+
+    /* These indicate whether the iterator is for a source
+     * or a destination image
+     */
+    ITER_SRC =			(1 << 5),
+    ITER_DEST =			(1 << 6)
 } iter_flags_t;
 
 struct pixman_iter_t
@@ -246,6 +377,7 @@ struct pixman_iter_t
     /* These function pointers are initialized by the implementation */
     pixman_iter_get_scanline_t	get_scanline;
     pixman_iter_write_back_t	write_back;
+    pixman_iter_fini_t		fini;	/* if not NULL, called when done */
 
     /* These fields are scratch data that implementations can use */
     void *			data;
@@ -253,6 +385,26 @@ struct pixman_iter_t
     int				stride;
 };
 
+typedef void (* pixman_iter_initializer_t) (pixman_iter_t            *iter,
+					    const pixman_iter_info_t *info);
+
+/* An iterator is chosen by walking the iter_info tables of the
+ * implementations, and picking the first entry whose format is the
+ * format of the image (or PIXMAN_any) and whose image and iterator
+ * flags are all set. The get_scanline and write_back functions of
+ * the entry are then copied into the iterator, and the initializer,
+ * if any, is called to set up the rest.
+ */
+struct pixman_iter_info_t
+{
+    pixman_format_code_t	format;
+    uint32_t			image_flags;
+    iter_flags_t		iter_flags;
+    pixman_iter_initializer_t	initializer;
+    pixman_iter_get_scanline_t	get_scanline;
+    pixman_iter_write_back_t	write_back;
+};
+
 void
 _pixman_bits_image_setup_accessors (bits_image_t *image);
 
@@ -262,15 +414,66 @@ _pixman_bits_image_src_iter_init (pixman_image_t *image, pixman_iter_t *iter);
 void
 _pixman_bits_image_dest_iter_init (pixman_image_t *image, pixman_iter_t *iter);
 
+/* The passes of the separable convolution scaler in pixman-bits-image.c.
+ * See there for the layout of the arguments.
+ */
+typedef void (* pixman_convolve_row_func_t) (int16_t *		dst,
+					      const uint32_t *	src,
+					      const int32_t *	offsets,
+					      const int16_t **	weights,
+					      int		n_taps,
+					      int		width);
+typedef void (* pixman_convolve_column_func_t) (uint32_t *	  dst,
+						 const int16_t ** rows,
+						 const int16_t *  weights,
+						 int		  n_taps,
+						 int		  width);
+
+void
+_pixman_separable_scaler_iter_init (pixman_iter_t *                iter,
+				    pixman_convolve_row_func_t     convolve_row,
+				    pixman_convolve_column_func_t  convolve_column);
+
 void
 _pixman_linear_gradient_iter_init (pixman_image_t *image, pixman_iter_t  *iter);
 
+pixman_bool_t
+_pixman_linear_gradient_get_affine (pixman_image_t       *image,
+				    int                   x,
+				    int                   y,
+				    pixman_fixed_32_32_t *t,
+				    double               *inc);
+
+uint32_t *
+_pixman_linear_gradient_get_scanline_narrow (pixman_iter_t  *iter,
+					     const uint32_t *mask);
+
 void
 _pixman_radial_gradient_iter_init (pixman_image_t *image, pixman_iter_t *iter);
 
+pixman_bool_t
+_pixman_radial_gradient_get_affine (pixman_image_t  *image,
+				    int              x,
+				    int              y,
+				    radial_affine_t *affine);
+
+uint32_t *
+_pixman_radial_gradient_get_scanline_narrow (pixman_iter_t  *iter,
+					     const uint32_t *mask);
+
 void
 _pixman_conical_gradient_iter_init (pixman_image_t *image, pixman_iter_t *iter);
 
+pixman_bool_t
+_pixman_conical_gradient_get_affine (pixman_image_t   *image,
+				     int               x,
+				     int               y,
+				     conical_affine_t *affine);
+
+uint32_t *
+_pixman_conical_gradient_get_scanline_narrow (pixman_iter_t  *iter,
+					      const uint32_t *mask);
+
 void
 _pixman_image_init (pixman_image_t *image);
 
@@ -345,6 +548,48 @@ uint32_t
 _pixman_gradient_walker_pixel (pixman_gradient_walker_t *walker,
                                pixman_fixed_48_16_t      x);
 
+#define GRADIENT_LUT_BITS	10
+#define GRADIENT_LUT_SIZE	(1 << GRADIENT_LUT_BITS)
+
+uint32_t *
+_pixman_gradient_create_lut (gradient_t *gradient);
+
+/* The color of the gradient at pos from its LUT, the nearest of the
+ * colors in the table after applying the repeat.
+ */
+static force_inline uint32_t
+gradient_lut_pixel (const uint32_t *      lut,
+		    pixman_repeat_t       repeat,
+		    pixman_fixed_48_16_t  pos)
+{
+    switch (repeat)
+    {
+    case PIXMAN_REPEAT_NORMAL:
+	pos &= 0xffff;
+	break;
+
+    case PIXMAN_REPEAT_REFLECT:
+	pos &= 0x1ffff;
+	if (pos > 0x10000)
+	    pos = 0x20000 - pos;
+	break;
+
+    case PIXMAN_REPEAT_PAD:
+	if (pos < 0)
+	    pos = 0;
+	else if (pos > 0x10000)
+	    pos = 0x10000;
+	break;
+
+    default:
+	if (pos < 0 || pos > 0x10000)
+	    return 0;
+	break;
+    }
+
+    return lut[(pos + (1 << (15 - GRADIENT_LUT_BITS))) >> (16 - GRADIENT_LUT_BITS)];
+}
+
 /*
  * Edges
  */
@@ -379,7 +624,7 @@ pixman_rasterize_edges_accessors (pixman_image_t *image,
 /*
  * Implementations
  */
-typedef struct pixman_implementation_t pixman_implementation_t;
+typedef struct pixman_dispatch_index_t pixman_dispatch_index_t;
 
 typedef struct
 {
@@ -453,9 +698,29 @@ typedef pixman_bool_t (*pixman_fill_func_t) (pixman_implementation_t *imp,
 					     int                      width,
 					     int                      height,
 					     uint32_t                 filler);
-typedef pixman_bool_t (*pixman_iter_init_func_t) (pixman_implementation_t *imp,
-						  pixman_iter_t           *iter);
 
+/* One glyph clipped to a band of the destination. The mask holds a8
+ * coverage, or a8r8g8b8 coverage if component_alpha is set.
+ */
+typedef struct
+{
+    const uint8_t *		mask;
+    int				mask_stride;	/* in bytes */
+    pixman_bool_t		component_alpha;
+    uint32_t *			dest;
+    int				width;
+    int				height;
+} pixman_glyph_box_t;
+
+/* Composites a solid color through the glyph boxes, in order, onto a
+ * 32 bpp destination. The stride is in uint32_t's.
+ */
+typedef pixman_bool_t (*pixman_glyphs_func_t) (pixman_implementation_t *imp,
+					       pixman_op_t              op,
+					       uint32_t                 src,
+					       int                      dest_stride,
+					       const pixman_glyph_box_t *boxes,
+					       int                      n_boxes);
 void _pixman_setup_combiner_functions_32 (pixman_implementation_t *imp);
 void _pixman_setup_combiner_functions_float (pixman_implementation_t *imp);
 
@@ -473,14 +738,16 @@ typedef struct
 
 struct pixman_implementation_t
 {
+    const char *		name;
     pixman_implementation_t *	toplevel;
     pixman_implementation_t *	fallback;
     const pixman_fast_path_t *	fast_paths;
+    pixman_dispatch_index_t *	dispatch_index;
 
     pixman_blt_func_t		blt;
     pixman_fill_func_t		fill;
-    pixman_iter_init_func_t     src_iter_init;
-    pixman_iter_init_func_t     dest_iter_init;
+    pixman_glyphs_func_t	glyphs;
+    const pixman_iter_info_t *	iter_info;
 
     pixman_combine_32_func_t	combine_32[PIXMAN_N_OPERATORS];
     pixman_combine_32_func_t	combine_32_ca[PIXMAN_N_OPERATORS];
@@ -493,6 +760,10 @@ _pixman_image_get_solid (pixman_implementation_t *imp,
 			 pixman_image_t *         image,
                          pixman_format_code_t     format);
 
+uint64_t
+_pixman_image_get_solid_16161616 (pixman_implementation_t *imp,
+				  pixman_image_t *         image);
+
 pixman_implementation_t *
 _pixman_implementation_create (pixman_implementation_t *fallback,
 			       const pixman_fast_path_t *fast_paths);
@@ -542,28 +813,28 @@ _pixman_implementation_fill (pixman_implementation_t *imp,
                              uint32_t                 filler);
 
 pixman_bool_t
-_pixman_implementation_src_iter_init (pixman_implementation_t       *imp,
-				      pixman_iter_t                 *iter,
-				      pixman_image_t                *image,
-				      int                            x,
-				      int                            y,
-				      int                            width,
-				      int                            height,
-				      uint8_t                       *buffer,
-				      iter_flags_t                   flags,
-				      uint32_t                       image_flags);
+_pixman_implementation_glyphs (pixman_implementation_t  *imp,
+                               pixman_op_t               op,
+                               uint32_t                  src,
+                               int                       dest_stride,
+                               const pixman_glyph_box_t *boxes,
+                               int                       n_boxes);
 
-pixman_bool_t
-_pixman_implementation_dest_iter_init (pixman_implementation_t       *imp,
-				       pixman_iter_t                 *iter,
-				       pixman_image_t                *image,
-				       int                            x,
-				       int                            y,
-				       int                            width,
-				       int                            height,
-				       uint8_t                       *buffer,
-				       iter_flags_t                   flags,
-				       uint32_t                       image_flags);
+void
+_pixman_implementation_iter_init (pixman_implementation_t       *imp,
+                                  pixman_iter_t                 *iter,
+                                  pixman_image_t                *image,
+                                  int                            x,
+                                  int                            y,
+                                  int                            width,
+                                  int                            height,
+                                  uint8_t                       *buffer,
+                                  iter_flags_t                   flags,
+                                  uint32_t                       image_flags);
+
+void
+_pixman_implementation_cache_iters (pixman_implementation_t *imp,
+				    pixman_image_t          *image);
 
 /* Specific implementations */
 pixman_implementation_t *
@@ -585,6 +856,16 @@ pixman_implementation_t *
 _pixman_implementation_create_sse2 (pixman_implementation_t *fallback);
 #endif
 
+#ifdef USE_SSSE3
+pixman_implementation_t *
+_pixman_implementation_create_ssse3 (pixman_implementation_t *fallback);
+#endif
+
+#ifdef USE_AVX2
+pixman_implementation_t *
+_pixman_implementation_create_avx2 (pixman_implementation_t *fallback);
+#endif
+
 #ifdef USE_ARM_SIMD
 pixman_implementation_t *
 _pixman_implementation_create_arm_simd (pixman_implementation_t *fallback);
@@ -623,6 +904,12 @@ _pixman_mips_get_implementations (pixman_implementation_t *imp);
 pixman_implementation_t *
 _pixman_choose_implementation (void);
 
+pixman_implementation_t *
+_pixman_select_implementation (const char *top, const char *exclude);
+
+void
+_pixman_implementation_destroy (pixman_implementation_t *imp);
+
 pixman_bool_t
 _pixman_disabled (const char *name);
 
@@ -646,6 +933,9 @@ _pixman_compute_composite_region32 (pixman_region32_t * region,
 uint32_t *
 _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
 
+void
+_pixman_iter_init_bits_stride (pixman_iter_t *iter, const pixman_iter_info_t *info);
+
 /* These "formats" all have depth 0, so they
  * will never clash with any real ones
  */
@@ -655,6 +945,9 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
 #define PIXMAN_rpixbuf		PIXMAN_FORMAT (0, 3, 0, 0, 0, 0)
 #define PIXMAN_unknown		PIXMAN_FORMAT (0, 4, 0, 0, 0, 0)
 #define PIXMAN_any		PIXMAN_FORMAT (0, 5, 0, 0, 0, 0)
+#define PIXMAN_linear_gradient	PIXMAN_FORMAT (0, 6, 0, 0, 0, 0)
+#define PIXMAN_radial_gradient	PIXMAN_FORMAT (0, 7, 0, 0, 0, 0)
+#define PIXMAN_conical_gradient	PIXMAN_FORMAT (0, 8, 0, 0, 0, 0)
 
 #define PIXMAN_OP_any		(PIXMAN_N_OPERATORS + 1)
 
@@ -685,6 +978,8 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
 #define FAST_PATH_SAMPLES_COVER_CLIP_BILINEAR	(1 << 24)
 #define FAST_PATH_BITS_IMAGE			(1 << 25)
 #define FAST_PATH_SEPARABLE_CONVOLUTION_FILTER  (1 << 26)
+#define FAST_PATH_NO_DITHER			(1 << 27)
+#define FAST_PATH_SEPARABLE_TWO_PASS		(1 << 28)
 
 #define FAST_PATH_PAD_REPEAT						\
     (FAST_PATH_NO_NONE_REPEAT		|				\
@@ -706,6 +1001,14 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
      FAST_PATH_NO_NORMAL_REPEAT		|				\
      FAST_PATH_NO_PAD_REPEAT)
 
+#define FAST_PATH_SEPARABLE_SCALE_FLAGS					\
+    (FAST_PATH_NO_ALPHA_MAP		|				\
+     FAST_PATH_BITS_IMAGE		|				\
+     FAST_PATH_HAS_TRANSFORM		|				\
+     FAST_PATH_SCALE_TRANSFORM		|				\
+     FAST_PATH_SEPARABLE_CONVOLUTION_FILTER |				\
+     FAST_PATH_SEPARABLE_TWO_PASS)
+
 #define FAST_PATH_STANDARD_FLAGS					\
     (FAST_PATH_NO_CONVOLUTION_FILTER	|				\
      FAST_PATH_NO_ACCESSORS		|				\
@@ -715,7 +1018,8 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
 #define FAST_PATH_STD_DEST_FLAGS					\
     (FAST_PATH_NO_ACCESSORS		|				\
      FAST_PATH_NO_ALPHA_MAP		|				\
-     FAST_PATH_NARROW_FORMAT)
+     FAST_PATH_NARROW_FORMAT		|				\
+     FAST_PATH_NO_DITHER)
 
 #define SOURCE_FLAGS(format)						\
     (FAST_PATH_STANDARD_FLAGS |						\
@@ -751,6 +1055,50 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
 	    dest, FAST_PATH_STD_DEST_FLAGS,				\
 	    func) }
 
+/* Fast paths for destinations whose stores are dithered. They also
+ * match destinations that aren't dithered, so in a table they must come
+ * after the standard fast paths for the same formats.
+ */
+#define FAST_PATH_DITHER_DEST_FLAGS					\
+    (FAST_PATH_STD_DEST_FLAGS & ~FAST_PATH_NO_DITHER)
+
+#define PIXMAN_DITHER_FAST_PATH(op, src, mask, dest, func)		\
+    { FAST_PATH (							\
+	    op,								\
+	    src,  SOURCE_FLAGS (src),					\
+	    mask, MASK_FLAGS (mask, FAST_PATH_UNIFIED_ALPHA),		\
+	    dest, FAST_PATH_DITHER_DEST_FLAGS,				\
+	    func) }
+
+/* Fast paths that read or write 64 bpp pixels directly instead of
+ * going through argb_t. The wide image isn't a narrow format, so it
+ * only needs the flags that the standard paths require apart from that.
+ */
+#define FAST_PATH_WIDE_SOURCE_FLAGS					\
+    ((FAST_PATH_STANDARD_FLAGS & ~FAST_PATH_NARROW_FORMAT)	|	\
+     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST			|	\
+     FAST_PATH_NEAREST_FILTER					|	\
+     FAST_PATH_ID_TRANSFORM)
+
+#define FAST_PATH_WIDE_DEST_FLAGS					\
+    (FAST_PATH_STD_DEST_FLAGS & ~FAST_PATH_NARROW_FORMAT)
+
+#define PIXMAN_WIDE_FAST_PATH(op, src, dest, func)			\
+    { FAST_PATH (							\
+	    op,								\
+	    src,  FAST_PATH_WIDE_SOURCE_FLAGS,				\
+	    null, 0,							\
+	    dest, FAST_PATH_WIDE_DEST_FLAGS,				\
+	    func) }
+
+#define PIXMAN_WIDE_DEST_FAST_PATH(op, src, mask, dest, func)		\
+    { FAST_PATH (							\
+	    op,								\
+	    src,  SOURCE_FLAGS (src),					\
+	    mask, MASK_FLAGS (mask, FAST_PATH_UNIFIED_ALPHA),		\
+	    dest, FAST_PATH_WIDE_DEST_FLAGS,				\
+	    func) }
+
 extern pixman_implementation_t *global_implementation;
 
 static force_inline pixman_implementation_t *
@@ -763,12 +1111,31 @@ get_implementation (void)
     return global_implementation;
 }
 
+extern int _pixman_streaming_threshold;
+
+/* Whether a fill or copy writing width x height pixels of bpp bits is
+ * large enough that it should use non-temporal stores, so that it
+ * doesn't evict everything else from the caches.
+ */
+static force_inline pixman_bool_t
+_pixman_use_streaming_stores (int width, int height, int bpp)
+{
+    return _pixman_streaming_threshold > 0 &&
+	(uint64_t)width * height * bpp >= (uint64_t)_pixman_streaming_threshold * 8;
+}
+
 /* This function is exported for the sake of the test suite and not part
  * of the ABI.
  */
 PIXMAN_EXPORT pixman_implementation_t *
 _pixman_internal_only_get_implementation (void);
 
+/* The number of filters this thread found in the kernel cache, also
+ * for the test suite only.
+ */
+PIXMAN_EXPORT uint32_t
+_pixman_internal_only_get_kernel_cache_hits (void);
+
 /* Memory allocation helpers */
 void *
 pixman_malloc_ab (unsigned int n, unsigned int b);
@@ -985,9 +1352,378 @@ unorm_to_unorm (uint32_t val, int from_bits, int to_bits)
     return result;
 }
 
+static force_inline uint16_t
+float_to_unorm (float f, int n_bits)
+{
+    uint32_t u;
+
+    if (f > 1.0)
+	f = 1.0;
+    if (f < 0.0)
+	f = 0.0;
+
+    u = f * (1 << n_bits);
+    u -= (u >> n_bits);
+
+    return u;
+}
+
+static force_inline float
+unorm_to_float (uint16_t u, int n_bits)
+{
+    uint32_t m = ((1 << n_bits) - 1);
+
+    return (u & m) * (1.f / (float)m);
+}
+
+/* Unlike float_to_unorm(), this rounds to nearest, so 16 bit channels
+ * survive a trip through float unchanged, and 8 bit values c become
+ * c * 257 exactly.
+ */
+static force_inline uint32_t
+float_to_unorm16 (float f)
+{
+    if (!(f > 0.0f))
+	return 0;
+    if (f > 1.0f)
+	f = 1.0f;
+
+    return (uint32_t)(f * 65535.f + 0.5f);
+}
+
 uint16_t pixman_float_to_unorm (float f, int n_bits);
 float pixman_unorm_to_float (uint16_t u, int n_bits);
 
+/* IEEE half float conversions. Like the F16C instructions, they round
+ * to nearest even, handle denormals and turn NaNs into quiet NaNs.
+ */
+static force_inline float
+half_to_float (uint16_t h)
+{
+    union { float f; uint32_t u; } v;
+    uint32_t sign = (h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+
+    if (exp == 0x1f)
+    {
+	v.u = sign | 0x7f800000 | (mant << 13) | (mant ? 0x400000 : 0);
+    }
+    else if (exp == 0)
+    {
+	v.f = mant * (1.f / (1 << 24));
+	v.u |= sign;
+    }
+    else
+    {
+	v.u = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+
+    return v.f;
+}
+
+static force_inline uint16_t
+float_to_half (float f)
+{
+    union { float f; uint32_t u; } v;
+    uint32_t sign, abs;
+
+    v.f = f;
+    sign = (v.u >> 16) & 0x8000;
+    abs = v.u & 0x7fffffff;
+
+    if (abs >= 0x47800000)
+    {
+	/* Too large, infinity or NaN */
+	if (abs > 0x7f800000)
+	    return sign | 0x7e00 | ((abs >> 13) & 0x3ff);
+	else
+	    return sign | 0x7c00;
+    }
+    else if (abs < 0x38800000)
+    {
+	/* Denormal or zero. Adding 0.5 makes the FPU shift the
+	 * mantissa into place and round it.
+	 */
+	v.u = abs;
+	v.f += 0.5f;
+
+	return sign | (v.u - 0x3f000000);
+    }
+    else
+    {
+	/* Rebias the exponent and round to nearest even */
+	abs += ((uint32_t)(15 - 127) << 23) + 0xfff + ((abs >> 13) & 1);
+
+	return sign | (abs >> 13);
+    }
+}
+
+/* Conversions between the 64 bpp formats and a8r8g8b8. They give the
+ * same results as going through argb_t like the general implementation.
+ */
+static force_inline uint32_t
+convert_unorm16_to_unorm8 (uint32_t u)
+{
+    return float_to_unorm (unorm_to_float (u, 16), 8);
+}
+
+static force_inline uint32_t
+convert_half_to_unorm8 (uint32_t h)
+{
+    return float_to_unorm (half_to_float (h), 8);
+}
+
+static force_inline uint32_t
+convert_16161616_to_8888 (uint64_t p)
+{
+    return
+	(convert_unorm16_to_unorm8 ((p >> 48) & 0xffff) << 24) |
+	(convert_unorm16_to_unorm8 ((p >>  0) & 0xffff) << 16) |
+	(convert_unorm16_to_unorm8 ((p >> 16) & 0xffff) <<  8) |
+	(convert_unorm16_to_unorm8 ((p >> 32) & 0xffff) <<  0);
+}
+
+static force_inline uint32_t
+convert_f16161616_to_8888 (uint64_t p)
+{
+    return
+	(convert_half_to_unorm8 ((p >> 48) & 0xffff) << 24) |
+	(convert_half_to_unorm8 ((p >>  0) & 0xffff) << 16) |
+	(convert_half_to_unorm8 ((p >> 16) & 0xffff) <<  8) |
+	(convert_half_to_unorm8 ((p >> 32) & 0xffff) <<  0);
+}
+
+static force_inline uint64_t
+convert_unorm8_to_unorm16 (uint32_t u)
+{
+    return (u & 0xff) * 257;
+}
+
+static force_inline uint64_t
+convert_8888_to_16161616 (uint32_t s)
+{
+    return
+	(convert_unorm8_to_unorm16 (s >> 24) << 48) |
+	(convert_unorm8_to_unorm16 (s >>  0) << 32) |
+	(convert_unorm8_to_unorm16 (s >>  8) << 16) |
+	(convert_unorm8_to_unorm16 (s >> 16) <<  0);
+}
+
+static force_inline uint64_t
+convert_8888_to_f16161616 (uint32_t s)
+{
+    return
+	((uint64_t)float_to_half (unorm_to_float (s >> 24, 8)) << 48) |
+	((uint64_t)float_to_half (unorm_to_float (s >>  0, 8)) << 32) |
+	((uint64_t)float_to_half (unorm_to_float (s >>  8, 8)) << 16) |
+	((uint64_t)float_to_half (unorm_to_float (s >> 16, 8)) <<  0);
+}
+
+/* sRGB tables, generated by make-srgb.pl. Linear values have 16 bits,
+ * and linear_to_srgb[] is indexed by the top 12 of them. Every sRGB
+ * value survives a trip through both tables unchanged.
+ */
+extern const uint8_t linear_to_srgb[4096];
+extern const uint16_t srgb_to_linear[256];
+
+/* x * y / 65535, rounded to nearest */
+static force_inline uint32_t
+mul_un16 (uint32_t x, uint32_t y)
+{
+    uint32_t t = x * y + 0x8000;
+
+    return (t + (t >> 16)) >> 16;
+}
+
+/* u / 257, rounded to nearest */
+static force_inline uint32_t
+un16_to_un8 (uint32_t u)
+{
+    return (u * 255 + 0x807f) >> 16;
+}
+
+/* The sRGB fast paths composite with 16 bit linear channels, laid out
+ * like a16b16g16r16 pixels.
+ */
+static force_inline uint64_t
+convert_srgb_to_16161616 (uint32_t s)
+{
+    return
+	(convert_unorm8_to_unorm16 (s >> 24) << 48) |
+	((uint64_t)srgb_to_linear[(s >>  0) & 0xff] << 32) |
+	((uint64_t)srgb_to_linear[(s >>  8) & 0xff] << 16) |
+	((uint64_t)srgb_to_linear[(s >> 16) & 0xff] <<  0);
+}
+
+static force_inline uint32_t
+convert_16161616_to_srgb (uint64_t p)
+{
+    return
+	(un16_to_un8 ((p >> 48) & 0xffff) << 24) |
+	(linear_to_srgb[(p >>  4) & 0xfff] << 16) |
+	(linear_to_srgb[(p >> 20) & 0xfff] <<  8) |
+	(linear_to_srgb[(p >> 36) & 0xfff] <<  0);
+}
+
+static force_inline uint32_t
+round_16161616_to_8888 (uint64_t p)
+{
+    return
+	(un16_to_un8 ((p >> 48) & 0xffff) << 24) |
+	(un16_to_un8 ((p >>  0) & 0xffff) << 16) |
+	(un16_to_un8 ((p >> 16) & 0xffff) <<  8) |
+	(un16_to_un8 ((p >> 32) & 0xffff) <<  0);
+}
+
+static force_inline uint64_t
+in_16161616 (uint64_t s, uint32_t m)
+{
+    uint64_t r = 0;
+    int i;
+
+    for (i = 0; i < 64; i += 16)
+	r |= (uint64_t)mul_un16 ((s >> i) & 0xffff, m) << i;
+
+    return r;
+}
+
+/* Ordered dither matrices, generated by make-dither.pl. Both are tables
+ * of 64 x 64 thresholds in [0, 254]; the 8 x 8 Bayer matrix is repeated.
+ */
+extern const uint8_t dither_bayer_8[4096];
+extern const uint8_t dither_blue_noise_64[4096];
+
+/* Whether stores to the format drop bits that dithering can make up for */
+static force_inline pixman_bool_t
+format_can_dither (pixman_format_code_t format)
+{
+    int type = PIXMAN_FORMAT_TYPE (format);
+    int a = PIXMAN_FORMAT_A (format);
+    int r = PIXMAN_FORMAT_R (format);
+    int g = PIXMAN_FORMAT_G (format);
+    int b = PIXMAN_FORMAT_B (format);
+
+    if (PIXMAN_FORMAT_IS_WIDE (format))
+	return FALSE;
+
+    if (type != PIXMAN_TYPE_A && type != PIXMAN_TYPE_ARGB	&&
+	type != PIXMAN_TYPE_ABGR && type != PIXMAN_TYPE_BGRA	&&
+	type != PIXMAN_TYPE_RGBA)
+    {
+	return FALSE;
+    }
+
+    return (a && a < 8) || (r && r < 8) || (g && g < 8) || (b && b < 8);
+}
+
+/* The thresholds of the matrix row for destination row y. Column x
+ * uses the one at (x + image->dither_offset_x) & 63.
+ */
+static force_inline const uint8_t *
+dither_row (const bits_image_t *image, int y)
+{
+    const uint8_t *matrix;
+
+    if (image->dither == PIXMAN_DITHER_FAST ||
+	image->dither == PIXMAN_DITHER_ORDERED_BAYER_8)
+    {
+	matrix = dither_bayer_8;
+    }
+    else
+    {
+	matrix = dither_blue_noise_64;
+    }
+
+    return matrix + ((y + image->dither_offset_y) & 63) * 64;
+}
+
+/* Reduces the 8 bit channel c to bits bits as
+ * (c * (2^bits - 1) + t) / 255, so that averaged over the thresholds t
+ * of a matrix the result is c * (2^bits - 1) / 255. 0 and 255 stay
+ * exact. The result is in the top bits of the 8, where the truncating
+ * conversions to the format keep it as it is.
+ */
+static force_inline uint32_t
+dither_channel (uint32_t c, uint32_t t, int bits)
+{
+    return ((c * ((1 << bits) - 1) + t) / 255) << (8 - bits);
+}
+
+static force_inline uint16_t
+dither_8888_to_0565 (uint32_t s, uint32_t t)
+{
+    return convert_8888_to_0565 (
+	(dither_channel ((s >> 16) & 0xff, t, 5) << 16) |
+	(dither_channel ((s >>  8) & 0xff, t, 6) <<  8) |
+	(dither_channel ((s >>  0) & 0xff, t, 5) <<  0));
+}
+
+static force_inline uint64_t
+over_16161616 (uint64_t s, uint64_t d)
+{
+    uint32_t ia = 0xffff - (s >> 48);
+    uint64_t r = 0;
+    int i;
+
+    for (i = 0; i < 64; i += 16)
+    {
+	uint32_t c = ((s >> i) & 0xffff) + mul_un16 ((d >> i) & 0xffff, ia);
+
+	r |= (uint64_t)MIN (c, 0xffff) << i;
+    }
+
+    return r;
+}
+
+static force_inline uint64_t
+add_16161616 (uint64_t s, uint64_t d)
+{
+    uint64_t r = 0;
+    int i;
+
+    for (i = 0; i < 64; i += 16)
+    {
+	uint32_t c = ((s >> i) & 0xffff) + ((d >> i) & 0xffff);
+
+	r |= (uint64_t)MIN (c, 0xffff) << i;
+    }
+
+    return r;
+}
+
+/* BT.601 video range YUV to x8r8g8b8, in 16.16 fixed point. The SIMD
+ * fetchers split each coefficient into a 16 bit high and low part and
+ * give the same results.
+ */
+static force_inline uint32_t
+convert_yuv_to_8888 (uint8_t y8, uint8_t u8, uint8_t v8)
+{
+    int16_t y = y8 - 16;
+    int16_t u = u8 - 128;
+    int16_t v = v8 - 128;
+    int32_t r, g, b;
+
+    /* R = 1.164(Y - 16) + 1.596(V - 128) */
+    r = 0x012b27 * y + 0x019a2e * v;
+    /* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
+    g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
+    /* B = 1.164(Y - 16) + 2.018(U - 128) */
+    b = 0x012b27 * y + 0x0206a2 * u;
+
+    return 0xff000000 |
+	(r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
+	(g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
+	(b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+}
+
+/* Rows of the planes of yv12, i420 and nv12 images. Chroma planes
+ * have one row for every two luma rows.
+ */
+#define PLANE_LINE(image, plane, line)					\
+    ((image)->planes[plane] + (plane ? (line) >> 1 : (line)) *		\
+     (image)->plane_strides[plane])
+
 /*
  * Various debugging code
  */
@@ -155,8 +155,224 @@ radial_compute_color (double                    a,
     return 0;
 }
 
-static uint32_t *
-radial_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
+/* The center of pixel (x, y) in gradient space, and the step from one
+ * pixel to the next in a row.
+ */
+static pixman_bool_t
+radial_get_vectors (pixman_image_t  *image,
+		    int              x,
+		    int              y,
+		    pixman_vector_t *v,
+		    pixman_vector_t *unit)
+{
+    /* reference point is the center of the pixel */
+    v->vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
+    v->vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
+    v->vector[2] = pixman_fixed_1;
+
+    if (image->common.transform)
+    {
+	if (!pixman_transform_point_3d (image->common.transform, v))
+	    return FALSE;
+
+	unit->vector[0] = image->common.transform->matrix[0][0];
+	unit->vector[1] = image->common.transform->matrix[1][0];
+	unit->vector[2] = image->common.transform->matrix[2][0];
+    }
+    else
+    {
+	unit->vector[0] = pixman_fixed_1;
+	unit->vector[1] = 0;
+	unit->vector[2] = 0;
+    }
+
+    return TRUE;
+}
+
+/* The terms of the quadratic for the pixel at v, and how they change
+ * from one pixel to the next, for an affine transformation.
+ */
+static void
+radial_get_terms (radial_gradient_t *radial,
+		  pixman_vector_t   *v,
+		  pixman_vector_t   *unit,
+		  radial_affine_t   *affine)
+{
+    /*
+     * Given:
+     *
+     * t = (B ± ⎷(B² - A·C)) / A
+     *
+     * where
+     *
+     * A = cdx² + cdy² - dr²
+     * B = pdx·cdx + pdy·cdy + r₁·dr
+     * C = pdx² + pdy² - r₁²
+     * det = B² - A·C
+     *
+     * Since we have an affine transformation, we know that (pdx, pdy)
+     * increase linearly with each pixel,
+     *
+     * pdx = pdx₀ + n·ux,
+     * pdy = pdy₀ + n·uy,
+     *
+     * we can then express B, C and det through multiple differentiation.
+     */
+
+    /* warning: this computation may overflow */
+    v->vector[0] -= radial->c1.x;
+    v->vector[1] -= radial->c1.y;
+
+    /*
+     * B and C are computed and updated exactly.
+     * If fdot was used instead of dot, in the worst case it would
+     * lose 11 bits of precision in each of the multiplication and
+     * summing up would zero out all the bit that were preserved,
+     * thus making the result 0 instead of the correct one.
+     * This would mean a worst case of unbound relative error or
+     * about 2^10 absolute error
+     */
+    affine->b = dot (v->vector[0], v->vector[1], radial->c1.radius,
+		     radial->delta.x, radial->delta.y, radial->delta.radius);
+    affine->db = dot (unit->vector[0], unit->vector[1], 0,
+		      radial->delta.x, radial->delta.y, 0);
+
+    affine->c = dot (v->vector[0], v->vector[1],
+		     -((pixman_fixed_48_16_t) radial->c1.radius),
+		     v->vector[0], v->vector[1], radial->c1.radius);
+    affine->dc = dot (2 * (pixman_fixed_48_16_t) v->vector[0] + unit->vector[0],
+		      2 * (pixman_fixed_48_16_t) v->vector[1] + unit->vector[1],
+		      0,
+		      unit->vector[0], unit->vector[1], 0);
+    affine->ddc = 2 * dot (unit->vector[0], unit->vector[1], 0,
+			   unit->vector[0], unit->vector[1], 0);
+
+    affine->a = radial->a * RADIAL_TERM_SCALE;
+    affine->inva = affine->a != 0 ? 1.f / affine->a : 0;
+    affine->dr = radial->delta.radius;
+    affine->mindr = -(float) radial->c1.radius;
+}
+
+/* The terms for the first pixel of row y starting at x. Returns FALSE
+ * if the transformation is projective.
+ */
+pixman_bool_t
+_pixman_radial_gradient_get_affine (pixman_image_t  *image,
+				    int              x,
+				    int              y,
+				    radial_affine_t *affine)
+{
+    pixman_vector_t v, unit;
+
+    if (!radial_get_vectors (image, x, y, &v, &unit) ||
+	unit.vector[2] != 0 || v.vector[2] != pixman_fixed_1)
+    {
+	return FALSE;
+    }
+
+    radial_get_terms ((radial_gradient_t *)image, &v, &unit, affine);
+
+    return TRUE;
+}
+
+/* Whether t, as a fraction of the gradient, is a valid solution */
+static force_inline pixman_bool_t
+radial_is_valid (const radial_affine_t *r, pixman_repeat_t repeat, float t)
+{
+    if (repeat == PIXMAN_REPEAT_NONE)
+	return 0 <= t && t <= 1;
+    else
+	return t * r->dr >= r->mindr;
+}
+
+/* The color from the LUT for the terms b and c of a pixel, like
+ * radial_compute_color() but in single precision. The SIMD
+ * implementations do exactly the same operations.
+ */
+static force_inline uint32_t
+radial_lut_pixel (const radial_affine_t *r,
+		  const uint32_t        *lut,
+		  pixman_repeat_t        repeat,
+		  float                  b,
+		  float                  c)
+{
+    float t;
+
+    if (r->a == 0)
+    {
+	if (b == 0)
+	    return 0;
+
+	t = 0.5f * c / b;
+
+	if (!radial_is_valid (r, repeat, t))
+	    return 0;
+    }
+    else
+    {
+	float discr = b * b - r->a * c;
+	float sqrtdiscr, t1;
+
+	if (!(discr >= 0))
+	    return 0;
+
+	sqrtdiscr = sqrtf (discr);
+	t = (b + sqrtdiscr) * r->inva;
+	t1 = (b - sqrtdiscr) * r->inva;
+
+	if (!radial_is_valid (r, repeat, t))
+	{
+	    if (!radial_is_valid (r, repeat, t1))
+		return 0;
+
+	    t = t1;
+	}
+    }
+
+    /* Positions that far out all fit in the table, and they must fit
+     * in 32 bits.
+     */
+    if (t < -16384.f)
+	t = -16384.f;
+    else if (t > 16384.f)
+	t = 16384.f;
+
+    return gradient_lut_pixel (lut, repeat, (int32_t)(t * 65536.f));
+}
+
+static void
+radial_get_scanline_lut (pixman_iter_t   *iter,
+			 const uint32_t  *mask,
+			 radial_affine_t *r)
+{
+    static const float kk[4] = { 0, 0, 1, 3 };
+    const uint32_t *lut = iter->image->gradient.lut;
+    pixman_repeat_t repeat = iter->image->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    int i, k;
+
+    for (i = 0; i < width; i += 4)
+    {
+	float b, db, c, dc, ddc;
+
+	radial_affine_next_group (r, &b, &db, &c, &dc, &ddc);
+
+	for (k = 0; k < 4 && i + k < width; ++k)
+	{
+	    if (!mask || *mask++)
+	    {
+		buffer[i + k] = radial_lut_pixel (
+		    r, lut, repeat,
+		    b + (float)k * db, c + ((float)k * dc + kk[k] * ddc));
+	    }
+	}
+    }
+}
+
+uint32_t *
+_pixman_radial_gradient_get_scanline_narrow (pixman_iter_t  *iter,
+					     const uint32_t *mask)
 {
     /*
      * Implementation of radial gradients following the PDF specification.
@@ -251,80 +467,31 @@ radial_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
     pixman_gradient_walker_t walker;
     pixman_vector_t v, unit;
 
-    /* reference point is the center of the pixel */
-    v.vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
-    v.vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
-    v.vector[2] = pixman_fixed_1;
+    if (!radial_get_vectors (image, x, y, &v, &unit))
+	return iter->buffer;
 
     _pixman_gradient_walker_init (&walker, gradient, image->common.repeat);
 
-    if (image->common.transform)
-    {
-	if (!pixman_transform_point_3d (image->common.transform, &v))
-	    return iter->buffer;
-
-	unit.vector[0] = image->common.transform->matrix[0][0];
-	unit.vector[1] = image->common.transform->matrix[1][0];
-	unit.vector[2] = image->common.transform->matrix[2][0];
-    }
-    else
-    {
-	unit.vector[0] = pixman_fixed_1;
-	unit.vector[1] = 0;
-	unit.vector[2] = 0;
-    }
-
     if (unit.vector[2] == 0 && v.vector[2] == pixman_fixed_1)
     {
-	/*
-	 * Given:
-	 *
-	 * t = (B ± ⎷(B² - A·C)) / A
-	 *
-	 * where
-	 *
-	 * A = cdx² + cdy² - dr²
-	 * B = pdx·cdx + pdy·cdy + r₁·dr
-	 * C = pdx² + pdy² - r₁²
-	 * det = B² - A·C
-	 *
-	 * Since we have an affine transformation, we know that (pdx, pdy)
-	 * increase linearly with each pixel,
-	 *
-	 * pdx = pdx₀ + n·ux,
-	 * pdy = pdy₀ + n·uy,
-	 *
-	 * we can then express B, C and det through multiple differentiation.
-	 */
+	radial_affine_t affine;
 	pixman_fixed_32_32_t b, db, c, dc, ddc;
 
-	/* warning: this computation may overflow */
-	v.vector[0] -= radial->c1.x;
-	v.vector[1] -= radial->c1.y;
+	radial_get_terms (radial, &v, &unit, &affine);
 
-	/*
-	 * B and C are computed and updated exactly.
-	 * If fdot was used instead of dot, in the worst case it would
-	 * lose 11 bits of precision in each of the multiplication and
-	 * summing up would zero out all the bit that were preserved,
-	 * thus making the result 0 instead of the correct one.
-	 * This would mean a worst case of unbound relative error or
-	 * about 2^10 absolute error
-	 */
-	b = dot (v.vector[0], v.vector[1], radial->c1.radius,
-		 radial->delta.x, radial->delta.y, radial->delta.radius);
-	db = dot (unit.vector[0], unit.vector[1], 0,
-		  radial->delta.x, radial->delta.y, 0);
-
-	c = dot (v.vector[0], v.vector[1],
-		 -((pixman_fixed_48_16_t) radial->c1.radius),
-		 v.vector[0], v.vector[1], radial->c1.radius);
-	dc = dot (2 * (pixman_fixed_48_16_t) v.vector[0] + unit.vector[0],
-		  2 * (pixman_fixed_48_16_t) v.vector[1] + unit.vector[1],
-		  0,
-		  unit.vector[0], unit.vector[1], 0);
-	ddc = 2 * dot (unit.vector[0], unit.vector[1], 0,
-		       unit.vector[0], unit.vector[1], 0);
+	if (gradient->lut)
+	{
+	    radial_get_scanline_lut (iter, mask, &affine);
+
+	    iter->y++;
+	    return iter->buffer;
+	}
+
+	b = affine.b;
+	db = affine.db;
+	c = affine.c;
+	dc = affine.dc;
+	ddc = affine.ddc;
 
 	while (buffer < end)
 	{
@@ -403,7 +570,7 @@ radial_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
 static uint32_t *
 radial_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
 {
-    uint32_t *buffer = radial_get_scanline_narrow (iter, NULL);
+    uint32_t *buffer = _pixman_radial_gradient_get_scanline_narrow (iter, NULL);
 
     pixman_expand_to_float (
 	(argb_t *)buffer, buffer, PIXMAN_a8r8g8b8, iter->width);
@@ -415,7 +582,7 @@ void
 _pixman_radial_gradient_iter_init (pixman_image_t *image, pixman_iter_t *iter)
 {
     if (iter->iter_flags & ITER_NARROW)
-	iter->get_scanline = radial_get_scanline_narrow;
+	iter->get_scanline = _pixman_radial_gradient_get_scanline_narrow;
     else
 	iter->get_scanline = radial_get_scanline_wide;
 }
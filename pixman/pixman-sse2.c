@@ -32,6 +32,8 @@
 
 #include <xmmintrin.h> /* for _mm_shuffle_pi16 and _MM_SHUFFLE */
 #include <emmintrin.h> /* for SSE2 intrinsics */
+#include <float.h>
+#include <math.h>
 #include "pixman-private.h"
 #include "pixman-combine32.h"
 #include "pixman-inlines.h"
@@ -56,6 +58,10 @@ static __m128i mask_565_fix_g;
 static __m128i mask_565_rb;
 static __m128i mask_565_pack_multiplier;
 
+static __m128i mask_0001;
+static __m128i mask_dither_565_scale;
+static __m128i mask_dither_565_shift;
+
 static force_inline __m128i
 unpack_32_1x128 (uint32_t data)
 {
@@ -388,6 +394,21 @@ save_128_aligned (__m128i* dst,
     _mm_store_si128 (dst, data);
 }
 
+/* save 4 pixels on a 16-byte boundary aligned address, bypassing the
+ * cache when streaming is set. The caller has to issue an sfence when
+ * it is done with streaming stores.
+ */
+static force_inline void
+save_128_aligned_nt (__m128i*      dst,
+                     __m128i       data,
+                     pixman_bool_t streaming)
+{
+    if (streaming)
+	_mm_stream_si128 (dst, data);
+    else
+	_mm_store_si128 (dst, data);
+}
+
 /* save 4 pixels on a unaligned address */
 static force_inline void
 save_128_unaligned (__m128i* dst,
@@ -2365,6 +2386,374 @@ sse2_combine_add_ca (pixman_implementation_t *imp,
     }
 }
 
+/*
+ * Float combiners for the wide pipeline. They do the operations of the
+ * ones in pixman-combine-float.c in the same order, so they give the
+ * same results, and leave the other operators to them.
+ */
+typedef enum
+{
+    ZERO,
+    ONE,
+    SRC_ALPHA,
+    DEST_ALPHA,
+    INV_SA,
+    INV_DA,
+    SA_OVER_DA,
+    DA_OVER_SA,
+    INV_SA_OVER_DA,
+    INV_DA_OVER_SA,
+    ONE_MINUS_SA_OVER_DA,
+    ONE_MINUS_DA_OVER_SA,
+    ONE_MINUS_INV_DA_OVER_SA,
+    ONE_MINUS_INV_SA_OVER_DA
+} combine_factor_t;
+
+typedef __m128 (* combine_channel_sse2_t) (__m128 sa, __m128 s,
+					   __m128 da, __m128 d);
+
+static force_inline __m128
+select_ps (__m128 m, __m128 a, __m128 b)
+{
+    return _mm_or_ps (_mm_and_ps (m, a), _mm_andnot_ps (m, b));
+}
+
+static force_inline __m128
+splat_alpha_ps (__m128 v)
+{
+    return _mm_shuffle_ps (v, v, _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+/* IS_ZERO() in pixman-combine-float.c */
+static force_inline __m128
+is_zero_ps (__m128 f)
+{
+    return _mm_and_ps (_mm_cmpgt_ps (f, _mm_set1_ps (-FLT_MIN)),
+		       _mm_cmplt_ps (f, _mm_set1_ps (FLT_MIN)));
+}
+
+static force_inline __m128
+clamp_ps (__m128 f)
+{
+    __m128 one = _mm_set1_ps (1.0f);
+
+    f = select_ps (_mm_cmpgt_ps (f, one), one, f);
+
+    return _mm_andnot_ps (_mm_cmplt_ps (f, _mm_setzero_ps ()), f);
+}
+
+/* The C code doesn't divide where the divisor is zero. Neither must
+ * this, in case division by zero traps, so those lanes divide by one
+ * and their results are thrown away.
+ */
+static force_inline __m128
+divisor_ps (__m128 f, __m128 zero)
+{
+    return select_ps (zero, _mm_set1_ps (1.0f), f);
+}
+
+static force_inline __m128
+get_factor_sse2 (combine_factor_t factor, __m128 sa, __m128 da)
+{
+    __m128 one = _mm_set1_ps (1.0f);
+    __m128 zero = _mm_setzero_ps ();
+    __m128 f = zero, z;
+
+    switch (factor)
+    {
+    case ZERO:
+	f = zero;
+	break;
+
+    case ONE:
+	f = one;
+	break;
+
+    case SRC_ALPHA:
+	f = sa;
+	break;
+
+    case DEST_ALPHA:
+	f = da;
+	break;
+
+    case INV_SA:
+	f = _mm_sub_ps (one, sa);
+	break;
+
+    case INV_DA:
+	f = _mm_sub_ps (one, da);
+	break;
+
+    case SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = clamp_ps (_mm_div_ps (sa, divisor_ps (da, z)));
+	f = select_ps (z, one, f);
+	break;
+
+    case DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = clamp_ps (_mm_div_ps (da, divisor_ps (sa, z)));
+	f = select_ps (z, one, f);
+	break;
+
+    case INV_SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = clamp_ps (_mm_div_ps (_mm_sub_ps (one, sa), divisor_ps (da, z)));
+	f = select_ps (z, one, f);
+	break;
+
+    case INV_DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = clamp_ps (_mm_div_ps (_mm_sub_ps (one, da), divisor_ps (sa, z)));
+	f = select_ps (z, one, f);
+	break;
+
+    case ONE_MINUS_SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = _mm_sub_ps (one, _mm_div_ps (sa, divisor_ps (da, z)));
+	f = _mm_andnot_ps (z, clamp_ps (f));
+	break;
+
+    case ONE_MINUS_DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = _mm_sub_ps (one, _mm_div_ps (da, divisor_ps (sa, z)));
+	f = _mm_andnot_ps (z, clamp_ps (f));
+	break;
+
+    case ONE_MINUS_INV_DA_OVER_SA:
+	z = is_zero_ps (sa);
+	f = _mm_div_ps (_mm_sub_ps (one, da), divisor_ps (sa, z));
+	f = _mm_andnot_ps (z, clamp_ps (_mm_sub_ps (one, f)));
+	break;
+
+    case ONE_MINUS_INV_SA_OVER_DA:
+	z = is_zero_ps (da);
+	f = _mm_div_ps (_mm_sub_ps (one, sa), divisor_ps (da, z));
+	f = _mm_andnot_ps (z, clamp_ps (_mm_sub_ps (one, f)));
+	break;
+    }
+
+    return f;
+}
+
+static force_inline void
+combine_float_inner_sse2 (pixman_bool_t component,
+			  float *dest, const float *src, const float *mask,
+			  int n_pixels,
+			  combine_channel_sse2_t combine_a,
+			  combine_channel_sse2_t combine_c)
+{
+    __m128 alpha = _mm_castsi128_ps (_mm_set_epi32 (0, 0, 0, -1));
+    int i;
+
+    for (i = 0; i < 4 * n_pixels; i += 4)
+    {
+	__m128 s = _mm_loadu_ps (src + i);
+	__m128 d = _mm_loadu_ps (dest + i);
+	__m128 sa, da, result;
+
+	if (!mask)
+	{
+	    sa = splat_alpha_ps (s);
+	}
+	else if (component)
+	{
+	    __m128 m = _mm_loadu_ps (mask + i);
+
+	    sa = _mm_mul_ps (m, splat_alpha_ps (s));
+	    s = _mm_mul_ps (s, m);
+	}
+	else
+	{
+	    s = _mm_mul_ps (s, splat_alpha_ps (_mm_loadu_ps (mask + i)));
+	    sa = splat_alpha_ps (s);
+	}
+
+	da = splat_alpha_ps (d);
+
+	result = combine_c (sa, s, da, d);
+	if (combine_a != combine_c)
+	    result = select_ps (alpha, combine_a (sa, s, da, d), result);
+
+	_mm_storeu_ps (dest + i, result);
+    }
+}
+
+#define MAKE_COMBINER_SSE2(name, component, combine_a, combine_c)	\
+    static void								\
+    sse2_combine_ ## name ## _float (pixman_implementation_t *imp,	\
+				     pixman_op_t              op,	\
+				     float                   *dest,	\
+				     const float             *src,	\
+				     const float             *mask,	\
+				     int                      n_pixels)	\
+    {									\
+	combine_float_inner_sse2 (component, dest, src, mask, n_pixels,	\
+				  combine_a, combine_c);		\
+    }
+
+#define MAKE_COMBINERS_SSE2(name, combine_a, combine_c)			\
+    MAKE_COMBINER_SSE2 (name ## _ca, TRUE, combine_a, combine_c)	\
+    MAKE_COMBINER_SSE2 (name ## _u, FALSE, combine_a, combine_c)
+
+#define MAKE_PD_COMBINERS_SSE2(name, a, b)				\
+    static force_inline __m128						\
+    pd_combine_ ## name ## _sse2 (__m128 sa, __m128 s,			\
+				  __m128 da, __m128 d)			\
+    {									\
+	__m128 fa = get_factor_sse2 (a, sa, da);			\
+	__m128 fb = get_factor_sse2 (b, sa, da);			\
+									\
+	return _mm_min_ps (_mm_set1_ps (1.0f),				\
+			   _mm_add_ps (_mm_mul_ps (s, fa),		\
+				       _mm_mul_ps (d, fb)));		\
+    }									\
+									\
+    MAKE_COMBINERS_SSE2 (name, pd_combine_ ## name ## _sse2,		\
+			 pd_combine_ ## name ## _sse2)
+
+MAKE_PD_COMBINERS_SSE2 (clear,			ZERO,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (src,			ONE,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (dst,			ZERO,				ONE)
+MAKE_PD_COMBINERS_SSE2 (over,			ONE,				INV_SA)
+MAKE_PD_COMBINERS_SSE2 (over_reverse,		INV_DA,				ONE)
+MAKE_PD_COMBINERS_SSE2 (in,			DEST_ALPHA,			ZERO)
+MAKE_PD_COMBINERS_SSE2 (in_reverse,		ZERO,				SRC_ALPHA)
+MAKE_PD_COMBINERS_SSE2 (out,			INV_DA,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (out_reverse,		ZERO,				INV_SA)
+MAKE_PD_COMBINERS_SSE2 (atop,			DEST_ALPHA,			INV_SA)
+MAKE_PD_COMBINERS_SSE2 (atop_reverse,		INV_DA,				SRC_ALPHA)
+MAKE_PD_COMBINERS_SSE2 (xor,			INV_DA,				INV_SA)
+MAKE_PD_COMBINERS_SSE2 (add,			ONE,				ONE)
+
+MAKE_PD_COMBINERS_SSE2 (saturate,		INV_DA_OVER_SA,			ONE)
+
+MAKE_PD_COMBINERS_SSE2 (disjoint_clear,		ZERO,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (disjoint_src,		ONE,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (disjoint_dst,		ZERO,				ONE)
+MAKE_PD_COMBINERS_SSE2 (disjoint_over,		ONE,				INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (disjoint_over_reverse,	INV_DA_OVER_SA,			ONE)
+MAKE_PD_COMBINERS_SSE2 (disjoint_in,		ONE_MINUS_INV_DA_OVER_SA,	ZERO)
+MAKE_PD_COMBINERS_SSE2 (disjoint_in_reverse,	ZERO,				ONE_MINUS_INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (disjoint_out,		INV_DA_OVER_SA,			ZERO)
+MAKE_PD_COMBINERS_SSE2 (disjoint_out_reverse,	ZERO,				INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (disjoint_atop,		ONE_MINUS_INV_DA_OVER_SA,	INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (disjoint_atop_reverse,	INV_DA_OVER_SA,			ONE_MINUS_INV_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (disjoint_xor,		INV_DA_OVER_SA,			INV_SA_OVER_DA)
+
+MAKE_PD_COMBINERS_SSE2 (conjoint_clear,		ZERO,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (conjoint_src,		ONE,				ZERO)
+MAKE_PD_COMBINERS_SSE2 (conjoint_dst,		ZERO,				ONE)
+MAKE_PD_COMBINERS_SSE2 (conjoint_over,		ONE,				ONE_MINUS_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (conjoint_over_reverse,	ONE_MINUS_DA_OVER_SA,		ONE)
+MAKE_PD_COMBINERS_SSE2 (conjoint_in,		DA_OVER_SA,			ZERO)
+MAKE_PD_COMBINERS_SSE2 (conjoint_in_reverse,	ZERO,				SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (conjoint_out,		ONE_MINUS_DA_OVER_SA,		ZERO)
+MAKE_PD_COMBINERS_SSE2 (conjoint_out_reverse,	ZERO,				ONE_MINUS_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (conjoint_atop,		DA_OVER_SA,			ONE_MINUS_SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (conjoint_atop_reverse,	ONE_MINUS_DA_OVER_SA,		SA_OVER_DA)
+MAKE_PD_COMBINERS_SSE2 (conjoint_xor,		ONE_MINUS_DA_OVER_SA,		ONE_MINUS_SA_OVER_DA)
+
+#define MAKE_SEPARABLE_PDF_COMBINERS_SSE2(name)				\
+    static force_inline __m128						\
+    combine_ ## name ## _a_sse2 (__m128 sa, __m128 s,			\
+				 __m128 da, __m128 d)			\
+    {									\
+	return _mm_sub_ps (_mm_add_ps (da, sa), _mm_mul_ps (da, sa));	\
+    }									\
+									\
+    static force_inline __m128						\
+    combine_ ## name ## _c_sse2 (__m128 sa, __m128 s,			\
+				 __m128 da, __m128 d)			\
+    {									\
+	__m128 one = _mm_set1_ps (1.0f);				\
+	__m128 f = _mm_add_ps (_mm_mul_ps (_mm_sub_ps (one, sa), d),	\
+			       _mm_mul_ps (_mm_sub_ps (one, da), s));	\
+									\
+	return _mm_add_ps (f, blend_ ## name ## _sse2 (sa, s, da, d));	\
+    }									\
+									\
+    MAKE_COMBINERS_SSE2 (name, combine_ ## name ## _a_sse2,		\
+			 combine_ ## name ## _c_sse2)
+
+static force_inline __m128
+blend_multiply_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    return _mm_mul_ps (d, s);
+}
+
+static force_inline __m128
+blend_screen_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    return _mm_sub_ps (_mm_add_ps (_mm_mul_ps (d, sa), _mm_mul_ps (s, da)),
+		       _mm_mul_ps (s, d));
+}
+
+static force_inline __m128
+blend_overlay_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two = _mm_set1_ps (2.0f);
+    __m128 lo = _mm_mul_ps (_mm_mul_ps (two, s), d);
+    __m128 hi = _mm_sub_ps (
+	_mm_mul_ps (sa, da),
+	_mm_mul_ps (_mm_mul_ps (two, _mm_sub_ps (da, d)), _mm_sub_ps (sa, s)));
+
+    return select_ps (_mm_cmplt_ps (_mm_mul_ps (two, d), da), lo, hi);
+}
+
+static force_inline __m128
+blend_darken_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    return _mm_min_ps (_mm_mul_ps (d, sa), _mm_mul_ps (s, da));
+}
+
+static force_inline __m128
+blend_lighten_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    return _mm_max_ps (_mm_mul_ps (s, da), _mm_mul_ps (d, sa));
+}
+
+static force_inline __m128
+blend_hard_light_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two = _mm_set1_ps (2.0f);
+    __m128 lo = _mm_mul_ps (_mm_mul_ps (two, s), d);
+    __m128 hi = _mm_sub_ps (
+	_mm_mul_ps (sa, da),
+	_mm_mul_ps (_mm_mul_ps (two, _mm_sub_ps (da, d)), _mm_sub_ps (sa, s)));
+
+    return select_ps (_mm_cmplt_ps (_mm_mul_ps (two, s), sa), lo, hi);
+}
+
+static force_inline __m128
+blend_difference_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 dsa = _mm_mul_ps (d, sa);
+    __m128 sda = _mm_mul_ps (s, da);
+
+    return select_ps (_mm_cmplt_ps (sda, dsa),
+		      _mm_sub_ps (dsa, sda), _mm_sub_ps (sda, dsa));
+}
+
+static force_inline __m128
+blend_exclusion_sse2 (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two = _mm_set1_ps (2.0f);
+
+    return _mm_sub_ps (_mm_add_ps (_mm_mul_ps (s, da), _mm_mul_ps (d, sa)),
+		       _mm_mul_ps (_mm_mul_ps (two, d), s));
+}
+
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (multiply)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (screen)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (overlay)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (darken)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (lighten)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (hard_light)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (difference)
+MAKE_SEPARABLE_PDF_COMBINERS_SSE2 (exclusion)
+
 static force_inline __m128i
 create_mask_16_128 (uint16_t mask)
 {
@@ -3188,6 +3577,210 @@ sse2_composite_over_8888_0565 (pixman_implementation_t *imp,
 
 }
 
+/* Dithers two unpacked pixels to 565, with the threshold of each pixel
+ * in all four of its channels. See dither_channel(); x / 255 is
+ * (x + 1) * 257 >> 16 for the x that occur here. The results are left in
+ * the top bits of the channels, for pack_565_4x128_128().
+ */
+static force_inline __m128i
+dither_0565_1x128 (__m128i data, __m128i t)
+{
+    data = _mm_add_epi16 (_mm_mullo_epi16 (data, mask_dither_565_scale), t);
+    data = _mm_mulhi_epu16 (_mm_add_epi16 (data, mask_0001), mask_0101);
+
+    return _mm_mullo_epi16 (data, mask_dither_565_shift);
+}
+
+static force_inline void
+dither_0565_4x128 (const uint8_t *thresholds,
+                   __m128i* data0, __m128i* data1,
+                   __m128i* data2, __m128i* data3)
+{
+    __m128i t = _mm_loadl_epi64 ((__m128i *)thresholds);
+    __m128i t_lo, t_hi;
+
+    t = _mm_unpacklo_epi8 (t, t);
+    t_lo = _mm_unpacklo_epi16 (t, t);
+    t_hi = _mm_unpackhi_epi16 (t, t);
+
+    *data0 = dither_0565_1x128 (*data0, _mm_unpacklo_epi8 (t_lo, _mm_setzero_si128 ()));
+    *data1 = dither_0565_1x128 (*data1, _mm_unpackhi_epi8 (t_lo, _mm_setzero_si128 ()));
+    *data2 = dither_0565_1x128 (*data2, _mm_unpacklo_epi8 (t_hi, _mm_setzero_si128 ()));
+    *data3 = dither_0565_1x128 (*data3, _mm_unpackhi_epi8 (t_hi, _mm_setzero_si128 ()));
+}
+
+/* The thresholds of a row twice over, so that eight of them starting at
+ * any column can be loaded at once.
+ */
+static force_inline void
+get_dither_thresholds (pixman_image_t *image, int y, uint8_t *thresholds)
+{
+    const uint8_t *row = dither_row (&image->bits, y);
+
+    memcpy (thresholds, row, 64);
+    memcpy (thresholds + 64, row, 64);
+}
+
+static void
+sse2_composite_src_x888_0565_dither (pixman_implementation_t *imp,
+                                     pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint16_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    uint8_t thresholds[128];
+    int dst_stride, src_stride;
+    int32_t w, x, y = dest_y;
+
+    __m128i xmm_src, xmm_src0, xmm_src1, xmm_src2, xmm_src3;
+
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint16_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	get_dither_thresholds (dest_image, y++, thresholds);
+	x = (dest_x + dest_image->bits.dither_offset_x) & 63;
+	w = width;
+
+	while (w && (uintptr_t)dst & 15)
+	{
+	    *dst++ = dither_8888_to_0565 (*src++, thresholds[x]);
+	    x = (x + 1) & 63;
+	    w--;
+	}
+
+	while (w >= 8)
+	{
+	    xmm_src = load_128_unaligned ((__m128i*) src);
+	    unpack_128_2x128 (xmm_src, &xmm_src0, &xmm_src1);
+	    xmm_src = load_128_unaligned ((__m128i*) (src + 4));
+	    unpack_128_2x128 (xmm_src, &xmm_src2, &xmm_src3);
+
+	    dither_0565_4x128 (thresholds + x,
+			       &xmm_src0, &xmm_src1, &xmm_src2, &xmm_src3);
+
+	    save_128_aligned (
+		(__m128i*)dst, pack_565_4x128_128 (
+		    &xmm_src0, &xmm_src1, &xmm_src2, &xmm_src3));
+
+	    x = (x + 8) & 63;
+	    w -= 8;
+	    src += 8;
+	    dst += 8;
+	}
+
+	while (w--)
+	{
+	    *dst++ = dither_8888_to_0565 (*src++, thresholds[x]);
+	    x = (x + 1) & 63;
+	}
+    }
+}
+
+static force_inline uint32_t
+composite_over_8888_0565pixel_8888 (uint32_t src, uint16_t dst)
+{
+    __m128i ms;
+
+    ms = unpack_32_1x128 (src);
+    return pack_1x128_32 (
+	over_1x128 (ms, expand_alpha_1x128 (ms), expand565_16_1x128 (dst)));
+}
+
+/* Unlike sse2_composite_over_8888_0565(), this stores every pixel, since
+ * dithering can change pixels that OVER leaves alone.
+ */
+static void
+sse2_composite_over_8888_0565_dither (pixman_implementation_t *imp,
+                                      pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint16_t    *dst_line, *dst;
+    uint32_t    *src_line, *src, s;
+    uint8_t thresholds[128];
+    int dst_stride, src_stride;
+    int32_t w, x, y = dest_y;
+
+    __m128i xmm_alpha_lo, xmm_alpha_hi;
+    __m128i xmm_src, xmm_src_lo, xmm_src_hi;
+    __m128i xmm_dst, xmm_dst0, xmm_dst1, xmm_dst2, xmm_dst3;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint16_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	src = src_line;
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+	get_dither_thresholds (dest_image, y++, thresholds);
+	x = (dest_x + dest_image->bits.dither_offset_x) & 63;
+	w = width;
+
+	while (w && ((uintptr_t)dst & 15))
+	{
+	    s = composite_over_8888_0565pixel_8888 (*src++, *dst);
+	    *dst++ = dither_8888_to_0565 (s, thresholds[x]);
+	    x = (x + 1) & 63;
+	    w--;
+	}
+
+	while (w >= 8)
+	{
+	    xmm_src = load_128_unaligned ((__m128i*) src);
+	    xmm_dst = load_128_aligned ((__m128i*) dst);
+
+	    unpack_128_2x128 (xmm_src, &xmm_src_lo, &xmm_src_hi);
+	    unpack_565_128_4x128 (xmm_dst,
+				  &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3);
+	    expand_alpha_2x128 (xmm_src_lo, xmm_src_hi,
+				&xmm_alpha_lo, &xmm_alpha_hi);
+
+	    xmm_src = load_128_unaligned ((__m128i*) (src + 4));
+
+	    over_2x128 (&xmm_src_lo, &xmm_src_hi,
+			&xmm_alpha_lo, &xmm_alpha_hi,
+			&xmm_dst0, &xmm_dst1);
+
+	    unpack_128_2x128 (xmm_src, &xmm_src_lo, &xmm_src_hi);
+	    expand_alpha_2x128 (xmm_src_lo, xmm_src_hi,
+				&xmm_alpha_lo, &xmm_alpha_hi);
+
+	    over_2x128 (&xmm_src_lo, &xmm_src_hi,
+			&xmm_alpha_lo, &xmm_alpha_hi,
+			&xmm_dst2, &xmm_dst3);
+
+	    dither_0565_4x128 (thresholds + x,
+			       &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3);
+
+	    save_128_aligned (
+		(__m128i*)dst, pack_565_4x128_128 (
+		    &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3));
+
+	    x = (x + 8) & 63;
+	    w -= 8;
+	    dst += 8;
+	    src += 8;
+	}
+
+	while (w--)
+	{
+	    s = composite_over_8888_0565pixel_8888 (*src++, *dst);
+	    *dst++ = dither_8888_to_0565 (s, thresholds[x]);
+	    x = (x + 1) & 63;
+	}
+    }
+}
+
 static void
 sse2_composite_over_n_8_8888 (pixman_implementation_t *imp,
                               pixman_composite_info_t *info)
@@ -3309,75 +3902,29 @@ sse2_composite_over_n_8_8888 (pixman_implementation_t *imp,
 
 }
 
-#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
-__attribute__((__force_align_arg_pointer__))
-#endif
-static pixman_bool_t
-sse2_fill (pixman_implementation_t *imp,
-           uint32_t *               bits,
-           int                      stride,
-           int                      bpp,
-           int                      x,
-           int                      y,
-           int                      width,
-           int                      height,
-           uint32_t		    filler)
+static force_inline void
+sse2_fill_lines (uint8_t *     byte_line,
+                 int           stride,
+                 int           byte_width,
+                 int           height,
+                 uint32_t      filler,
+                 pixman_bool_t streaming)
 {
-    uint32_t byte_width;
-    uint8_t *byte_line;
-
-    __m128i xmm_def;
+    __m128i xmm_def = create_mask_2x32_128 (filler, filler);
 
-    if (bpp == 8)
+    while (height--)
     {
-	uint8_t b;
-	uint16_t w;
+	int w;
+	uint8_t *d = byte_line;
+	byte_line += stride;
+	w = byte_width;
 
-	stride = stride * (int) sizeof (uint32_t) / 1;
-	byte_line = (uint8_t *)(((uint8_t *)bits) + stride * y + x);
-	byte_width = width;
-	stride *= 1;
-
-	b = filler & 0xff;
-	w = (b << 8) | b;
-	filler = (w << 16) | w;
-    }
-    else if (bpp == 16)
-    {
-	stride = stride * (int) sizeof (uint32_t) / 2;
-	byte_line = (uint8_t *)(((uint16_t *)bits) + stride * y + x);
-	byte_width = 2 * width;
-	stride *= 2;
-
-        filler = (filler & 0xffff) * 0x00010001;
-    }
-    else if (bpp == 32)
-    {
-	stride = stride * (int) sizeof (uint32_t) / 4;
-	byte_line = (uint8_t *)(((uint32_t *)bits) + stride * y + x);
-	byte_width = 4 * width;
-	stride *= 4;
-    }
-    else
-    {
-	return FALSE;
-    }
-
-    xmm_def = create_mask_2x32_128 (filler, filler);
-
-    while (height--)
-    {
-	int w;
-	uint8_t *d = byte_line;
-	byte_line += stride;
-	w = byte_width;
-
-	if (w >= 1 && ((uintptr_t)d & 1))
-	{
-	    *(uint8_t *)d = filler;
-	    w -= 1;
-	    d += 1;
-	}
+	if (w >= 1 && ((uintptr_t)d & 1))
+	{
+	    *(uint8_t *)d = filler;
+	    w -= 1;
+	    d += 1;
+	}
 
 	while (w >= 2 && ((uintptr_t)d & 3))
 	{
@@ -3396,14 +3943,14 @@ sse2_fill (pixman_implementation_t *imp,
 
 	while (w >= 128)
 	{
-	    save_128_aligned ((__m128i*)(d),     xmm_def);
-	    save_128_aligned ((__m128i*)(d + 16),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 32),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 48),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 64),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 80),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 96),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 112), xmm_def);
+	    save_128_aligned_nt ((__m128i*)(d),       xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 16),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 32),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 48),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 64),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 80),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 96),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 112), xmm_def, streaming);
 
 	    d += 128;
 	    w -= 128;
@@ -3411,10 +3958,10 @@ sse2_fill (pixman_implementation_t *imp,
 
 	if (w >= 64)
 	{
-	    save_128_aligned ((__m128i*)(d),     xmm_def);
-	    save_128_aligned ((__m128i*)(d + 16),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 32),  xmm_def);
-	    save_128_aligned ((__m128i*)(d + 48),  xmm_def);
+	    save_128_aligned_nt ((__m128i*)(d),       xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 16),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 32),  xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 48),  xmm_def, streaming);
 
 	    d += 64;
 	    w -= 64;
@@ -3422,8 +3969,8 @@ sse2_fill (pixman_implementation_t *imp,
 
 	if (w >= 32)
 	{
-	    save_128_aligned ((__m128i*)(d),     xmm_def);
-	    save_128_aligned ((__m128i*)(d + 16),  xmm_def);
+	    save_128_aligned_nt ((__m128i*)(d),       xmm_def, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 16),  xmm_def, streaming);
 
 	    d += 32;
 	    w -= 32;
@@ -3431,7 +3978,7 @@ sse2_fill (pixman_implementation_t *imp,
 
 	if (w >= 16)
 	{
-	    save_128_aligned ((__m128i*)(d),     xmm_def);
+	    save_128_aligned_nt ((__m128i*)(d),       xmm_def, streaming);
 
 	    d += 16;
 	    w -= 16;
@@ -3459,6 +4006,244 @@ sse2_fill (pixman_implementation_t *imp,
 	    d += 1;
 	}
     }
+}
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+static pixman_bool_t
+sse2_fill (pixman_implementation_t *imp,
+           uint32_t *               bits,
+           int                      stride,
+           int                      bpp,
+           int                      x,
+           int                      y,
+           int                      width,
+           int                      height,
+           uint32_t		    filler)
+{
+    uint32_t byte_width;
+    uint8_t *byte_line;
+
+    if (bpp == 8)
+    {
+	uint8_t b;
+	uint16_t w;
+
+	stride = stride * (int) sizeof (uint32_t) / 1;
+	byte_line = (uint8_t *)(((uint8_t *)bits) + stride * y + x);
+	byte_width = width;
+	stride *= 1;
+
+	b = filler & 0xff;
+	w = (b << 8) | b;
+	filler = (w << 16) | w;
+    }
+    else if (bpp == 16)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 2;
+	byte_line = (uint8_t *)(((uint16_t *)bits) + stride * y + x);
+	byte_width = 2 * width;
+	stride *= 2;
+
+        filler = (filler & 0xffff) * 0x00010001;
+    }
+    else if (bpp == 32)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 4;
+	byte_line = (uint8_t *)(((uint32_t *)bits) + stride * y + x);
+	byte_width = 4 * width;
+	stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    if (_pixman_use_streaming_stores (width, height, bpp))
+    {
+	sse2_fill_lines (byte_line, stride, byte_width, height, filler, TRUE);
+	_mm_sfence ();
+    }
+    else
+    {
+	sse2_fill_lines (byte_line, stride, byte_width, height, filler, FALSE);
+    }
+
+    return TRUE;
+}
+
+/* Glyph rows are short and start anywhere, so instead of aligning the
+ * destination first, like sse2_composite_over_n_8_8888 and
+ * sse2_composite_over_n_8888_8888_ca do, these use unaligned accesses
+ * and only the last few pixels are done one at a time.
+ */
+static force_inline void
+sse2_glyph_over_n_8_line (uint32_t *     dst,
+                          const uint8_t *mask,
+                          int            w,
+                          uint32_t       srca,
+                          __m128i        xmm_src,
+                          __m128i        xmm_alpha,
+                          __m128i        xmm_def)
+{
+    __m128i xmm_dst, xmm_dst_lo, xmm_dst_hi;
+    __m128i xmm_mask, xmm_mask_lo, xmm_mask_hi;
+    uint32_t m;
+
+    while (w >= 4)
+    {
+	memcpy (&m, mask, sizeof (uint32_t));
+
+	if (srca == 0xff && m == 0xffffffff)
+	{
+	    save_128_unaligned ((__m128i*)dst, xmm_def);
+	}
+	else if (m)
+	{
+	    xmm_dst = load_128_unaligned ((__m128i*)dst);
+	    xmm_mask = unpack_32_1x128 (m);
+	    xmm_mask = _mm_unpacklo_epi8 (xmm_mask, _mm_setzero_si128 ());
+
+	    unpack_128_2x128 (xmm_dst, &xmm_dst_lo, &xmm_dst_hi);
+	    unpack_128_2x128 (xmm_mask, &xmm_mask_lo, &xmm_mask_hi);
+
+	    expand_alpha_rev_2x128 (xmm_mask_lo, xmm_mask_hi,
+				    &xmm_mask_lo, &xmm_mask_hi);
+
+	    in_over_2x128 (&xmm_src, &xmm_src,
+			   &xmm_alpha, &xmm_alpha,
+			   &xmm_mask_lo, &xmm_mask_hi,
+			   &xmm_dst_lo, &xmm_dst_hi);
+
+	    save_128_unaligned (
+		(__m128i*)dst, pack_2x128_128 (xmm_dst_lo, xmm_dst_hi));
+	}
+
+	w -= 4;
+	dst += 4;
+	mask += 4;
+    }
+
+    while (w--)
+    {
+	uint8_t a = *mask++;
+
+	if (a)
+	{
+	    xmm_mask = expand_pixel_8_1x128 (a);
+	    xmm_dst = unpack_32_1x128 (*dst);
+
+	    *dst = pack_1x128_32 (
+		in_over_1x128 (&xmm_src, &xmm_alpha, &xmm_mask, &xmm_dst));
+	}
+
+	dst++;
+    }
+}
+
+static force_inline void
+sse2_glyph_over_n_8888_ca_line (uint32_t *      dst,
+                                const uint32_t *mask,
+                                int             w,
+                                __m128i         xmm_src,
+                                __m128i         xmm_alpha)
+{
+    __m128i xmm_dst, xmm_dst_lo, xmm_dst_hi;
+    __m128i xmm_mask, xmm_mask_lo, xmm_mask_hi;
+
+    while (w >= 4)
+    {
+	xmm_mask = load_128_unaligned ((__m128i*)mask);
+
+	if (_mm_movemask_epi8 (
+		_mm_cmpeq_epi32 (xmm_mask, _mm_setzero_si128 ())) != 0xffff)
+	{
+	    xmm_dst = load_128_unaligned ((__m128i*)dst);
+
+	    unpack_128_2x128 (xmm_mask, &xmm_mask_lo, &xmm_mask_hi);
+	    unpack_128_2x128 (xmm_dst, &xmm_dst_lo, &xmm_dst_hi);
+
+	    in_over_2x128 (&xmm_src, &xmm_src,
+			   &xmm_alpha, &xmm_alpha,
+			   &xmm_mask_lo, &xmm_mask_hi,
+			   &xmm_dst_lo, &xmm_dst_hi);
+
+	    save_128_unaligned (
+		(__m128i*)dst, pack_2x128_128 (xmm_dst_lo, xmm_dst_hi));
+	}
+
+	w -= 4;
+	dst += 4;
+	mask += 4;
+    }
+
+    while (w--)
+    {
+	uint32_t m = *mask++;
+
+	if (m)
+	{
+	    xmm_mask = unpack_32_1x128 (m);
+	    xmm_dst = unpack_32_1x128 (*dst);
+
+	    *dst = pack_1x128_32 (
+		in_over_1x128 (&xmm_src, &xmm_alpha, &xmm_mask, &xmm_dst));
+	}
+
+	dst++;
+    }
+}
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+static pixman_bool_t
+sse2_glyphs (pixman_implementation_t  *imp,
+             pixman_op_t               op,
+             uint32_t                  src,
+             int                       dest_stride,
+             const pixman_glyph_box_t *boxes,
+             int                       n_boxes)
+{
+    __m128i xmm_src, xmm_alpha, xmm_def;
+    uint32_t srca = src >> 24;
+    int i, h;
+
+    if (op != PIXMAN_OP_OVER)
+	return FALSE;
+
+    if (src == 0)
+	return TRUE;
+
+    xmm_def = create_mask_2x32_128 (src, src);
+    xmm_src = expand_pixel_32_1x128 (src);
+    xmm_alpha = expand_alpha_1x128 (xmm_src);
+
+    for (i = 0; i < n_boxes; ++i)
+    {
+	const pixman_glyph_box_t *box = &boxes[i];
+	const uint8_t *mask_line = box->mask;
+	uint32_t *dst_line = box->dest;
+
+	for (h = box->height; h--; )
+	{
+	    if (box->component_alpha)
+	    {
+		sse2_glyph_over_n_8888_ca_line (
+		    dst_line, (const uint32_t *)mask_line, box->width,
+		    xmm_src, xmm_alpha);
+	    }
+	    else
+	    {
+		sse2_glyph_over_n_8_line (dst_line, mask_line, box->width,
+					  srca, xmm_src, xmm_alpha, xmm_def);
+	    }
+
+	    mask_line += box->mask_stride;
+	    dst_line += dest_stride;
+	}
+    }
 
     return TRUE;
 }
@@ -4526,53 +5311,15 @@ sse2_composite_add_8888_8888 (pixman_implementation_t *imp,
 
 }
 
-static pixman_bool_t
-sse2_blt (pixman_implementation_t *imp,
-          uint32_t *               src_bits,
-          uint32_t *               dst_bits,
-          int                      src_stride,
-          int                      dst_stride,
-          int                      src_bpp,
-          int                      dst_bpp,
-          int                      src_x,
-          int                      src_y,
-          int                      dest_x,
-          int                      dest_y,
-          int                      width,
-          int                      height)
+static force_inline void
+sse2_blt_lines (uint8_t *     src_bytes,
+                uint8_t *     dst_bytes,
+                int           src_stride,
+                int           dst_stride,
+                int           byte_width,
+                int           height,
+                pixman_bool_t streaming)
 {
-    uint8_t *   src_bytes;
-    uint8_t *   dst_bytes;
-    int byte_width;
-
-    if (src_bpp != dst_bpp)
-	return FALSE;
-
-    if (src_bpp == 16)
-    {
-	src_stride = src_stride * (int) sizeof (uint32_t) / 2;
-	dst_stride = dst_stride * (int) sizeof (uint32_t) / 2;
-	src_bytes =(uint8_t *)(((uint16_t *)src_bits) + src_stride * (src_y) + (src_x));
-	dst_bytes = (uint8_t *)(((uint16_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
-	byte_width = 2 * width;
-	src_stride *= 2;
-	dst_stride *= 2;
-    }
-    else if (src_bpp == 32)
-    {
-	src_stride = src_stride * (int) sizeof (uint32_t) / 4;
-	dst_stride = dst_stride * (int) sizeof (uint32_t) / 4;
-	src_bytes = (uint8_t *)(((uint32_t *)src_bits) + src_stride * (src_y) + (src_x));
-	dst_bytes = (uint8_t *)(((uint32_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
-	byte_width = 4 * width;
-	src_stride *= 4;
-	dst_stride *= 4;
-    }
-    else
-    {
-	return FALSE;
-    }
-
     while (height--)
     {
 	int w;
@@ -4608,10 +5355,10 @@ sse2_blt (pixman_implementation_t *imp,
 	    xmm2 = load_128_unaligned ((__m128i*)(s + 32));
 	    xmm3 = load_128_unaligned ((__m128i*)(s + 48));
 
-	    save_128_aligned ((__m128i*)(d),    xmm0);
-	    save_128_aligned ((__m128i*)(d + 16), xmm1);
-	    save_128_aligned ((__m128i*)(d + 32), xmm2);
-	    save_128_aligned ((__m128i*)(d + 48), xmm3);
+	    save_128_aligned_nt ((__m128i*)(d),      xmm0, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 16), xmm1, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 32), xmm2, streaming);
+	    save_128_aligned_nt ((__m128i*)(d + 48), xmm3, streaming);
 
 	    s += 64;
 	    d += 64;
@@ -4620,7 +5367,8 @@ sse2_blt (pixman_implementation_t *imp,
 
 	while (w >= 16)
 	{
-	    save_128_aligned ((__m128i*)d, load_128_unaligned ((__m128i*)s) );
+	    save_128_aligned_nt ((__m128i*)d, load_128_unaligned ((__m128i*)s),
+				 streaming);
 
 	    w -= 16;
 	    d += 16;
@@ -4644,6 +5392,66 @@ sse2_blt (pixman_implementation_t *imp,
 	    d += 2;
 	}
     }
+}
+
+static pixman_bool_t
+sse2_blt (pixman_implementation_t *imp,
+          uint32_t *               src_bits,
+          uint32_t *               dst_bits,
+          int                      src_stride,
+          int                      dst_stride,
+          int                      src_bpp,
+          int                      dst_bpp,
+          int                      src_x,
+          int                      src_y,
+          int                      dest_x,
+          int                      dest_y,
+          int                      width,
+          int                      height)
+{
+    uint8_t *   src_bytes;
+    uint8_t *   dst_bytes;
+    int byte_width;
+
+    if (src_bpp != dst_bpp)
+	return FALSE;
+
+    if (src_bpp == 16)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 2;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 2;
+	src_bytes =(uint8_t *)(((uint16_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint16_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 2 * width;
+	src_stride *= 2;
+	dst_stride *= 2;
+    }
+    else if (src_bpp == 32)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 4;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 4;
+	src_bytes = (uint8_t *)(((uint32_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint32_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 4 * width;
+	src_stride *= 4;
+	dst_stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    if (_pixman_use_streaming_stores (width, height, dst_bpp))
+    {
+	sse2_blt_lines (src_bytes, dst_bytes, src_stride, dst_stride,
+			byte_width, height, TRUE);
+	_mm_sfence ();
+    }
+    else
+    {
+	sse2_blt_lines (src_bytes, dst_bytes, src_stride, dst_stride,
+			byte_width, height, FALSE);
+    }
 
     return TRUE;
 }
@@ -5786,201 +6594,786 @@ FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_8_8888_normal_OVER,
 			       uint32_t, uint8_t, uint32_t,
 			       NORMAL, FLAG_HAVE_NON_SOLID_MASK)
 
-static const pixman_fast_path_t sse2_fast_paths[] =
+/* The 16 bit per channel formats. Pixels are r, g, b, a in memory, and
+ * the conversions give exactly what the C ones in pixman-private.h give.
+ */
+static force_inline __m128i
+unorm16_to_unorm8_1x128 (__m128i c)
 {
-    /* PIXMAN_OP_OVER */
-    PIXMAN_STD_FAST_PATH (OVER, solid, a8, r5g6b5, sse2_composite_over_n_8_0565),
-    PIXMAN_STD_FAST_PATH (OVER, solid, a8, b5g6r5, sse2_composite_over_n_8_0565),
-    PIXMAN_STD_FAST_PATH (OVER, solid, null, a8r8g8b8, sse2_composite_over_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, solid, null, x8r8g8b8, sse2_composite_over_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, solid, null, r5g6b5, sse2_composite_over_n_0565),
-    PIXMAN_STD_FAST_PATH (OVER, solid, null, b5g6r5, sse2_composite_over_n_0565),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, a8r8g8b8, sse2_composite_over_8888_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, x8r8g8b8, sse2_composite_over_8888_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, a8b8g8r8, sse2_composite_over_8888_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, x8b8g8r8, sse2_composite_over_8888_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, r5g6b5, sse2_composite_over_8888_0565),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, b5g6r5, sse2_composite_over_8888_0565),
-    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8r8g8b8, sse2_composite_over_n_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8r8g8b8, sse2_composite_over_n_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8b8g8r8, sse2_composite_over_n_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8b8g8r8, sse2_composite_over_n_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, a8r8g8b8, sse2_composite_over_8888_8888_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, a8, x8r8g8b8, sse2_composite_over_8888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, a8, a8r8g8b8, sse2_composite_over_8888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, a8, x8b8g8r8, sse2_composite_over_8888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, a8, a8b8g8r8, sse2_composite_over_8888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, a8, x8r8g8b8, sse2_composite_over_x888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, a8, a8r8g8b8, sse2_composite_over_x888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, a8, x8b8g8r8, sse2_composite_over_x888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, a8, a8b8g8r8, sse2_composite_over_x888_8_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, solid, a8r8g8b8, sse2_composite_over_x888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, solid, x8r8g8b8, sse2_composite_over_x888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, solid, a8b8g8r8, sse2_composite_over_x888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, solid, x8b8g8r8, sse2_composite_over_x888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, solid, a8r8g8b8, sse2_composite_over_8888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, solid, x8r8g8b8, sse2_composite_over_8888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, solid, a8b8g8r8, sse2_composite_over_8888_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, solid, x8b8g8r8, sse2_composite_over_8888_n_8888),
-    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8r8g8b8, a8r8g8b8, sse2_composite_over_n_8888_8888_ca),
-    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8r8g8b8, x8r8g8b8, sse2_composite_over_n_8888_8888_ca),
-    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8b8g8r8, a8b8g8r8, sse2_composite_over_n_8888_8888_ca),
-    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8b8g8r8, x8b8g8r8, sse2_composite_over_n_8888_8888_ca),
-    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8r8g8b8, r5g6b5, sse2_composite_over_n_8888_0565_ca),
-    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8b8g8r8, b5g6r5, sse2_composite_over_n_8888_0565_ca),
-    PIXMAN_STD_FAST_PATH (OVER, pixbuf, pixbuf, a8r8g8b8, sse2_composite_over_pixbuf_8888),
-    PIXMAN_STD_FAST_PATH (OVER, pixbuf, pixbuf, x8r8g8b8, sse2_composite_over_pixbuf_8888),
-    PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, a8b8g8r8, sse2_composite_over_pixbuf_8888),
-    PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, x8b8g8r8, sse2_composite_over_pixbuf_8888),
-    PIXMAN_STD_FAST_PATH (OVER, pixbuf, pixbuf, r5g6b5, sse2_composite_over_pixbuf_0565),
-    PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, b5g6r5, sse2_composite_over_pixbuf_0565),
-    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
-    
-    /* PIXMAN_OP_OVER_REVERSE */
-    PIXMAN_STD_FAST_PATH (OVER_REVERSE, solid, null, a8r8g8b8, sse2_composite_over_reverse_n_8888),
-    PIXMAN_STD_FAST_PATH (OVER_REVERSE, solid, null, a8b8g8r8, sse2_composite_over_reverse_n_8888),
-
-    /* PIXMAN_OP_ADD */
-    PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8r8g8b8, a8r8g8b8, sse2_composite_add_n_8888_8888_ca),
-    PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, sse2_composite_add_8_8),
-    PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, sse2_composite_add_8888_8888),
-    PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, sse2_composite_add_8888_8888),
-    PIXMAN_STD_FAST_PATH (ADD, solid, a8, a8, sse2_composite_add_n_8_8),
-    PIXMAN_STD_FAST_PATH (ADD, solid, null, a8, sse2_composite_add_n_8),
-
-    /* PIXMAN_OP_SRC */
-    PIXMAN_STD_FAST_PATH (SRC, solid, a8, a8r8g8b8, sse2_composite_src_n_8_8888),
-    PIXMAN_STD_FAST_PATH (SRC, solid, a8, x8r8g8b8, sse2_composite_src_n_8_8888),
-    PIXMAN_STD_FAST_PATH (SRC, solid, a8, a8b8g8r8, sse2_composite_src_n_8_8888),
-    PIXMAN_STD_FAST_PATH (SRC, solid, a8, x8b8g8r8, sse2_composite_src_n_8_8888),
-    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, r5g6b5, sse2_composite_src_x888_0565),
-    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, b5g6r5, sse2_composite_src_x888_0565),
-    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, r5g6b5, sse2_composite_src_x888_0565),
-    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, b5g6r5, sse2_composite_src_x888_0565),
-    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, a8r8g8b8, sse2_composite_src_x888_8888),
-    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, a8b8g8r8, sse2_composite_src_x888_8888),
-    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, a8r8g8b8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, a8b8g8r8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, r5g6b5, null, r5g6b5, sse2_composite_copy_area),
-    PIXMAN_STD_FAST_PATH (SRC, b5g6r5, null, b5g6r5, sse2_composite_copy_area),
+    __m128 f = _mm_mul_ps (_mm_cvtepi32_ps (c), _mm_set1_ps (1.f / 65535.f));
+    __m128i u;
 
-    /* PIXMAN_OP_IN */
-    PIXMAN_STD_FAST_PATH (IN, a8, null, a8, sse2_composite_in_8_8),
-    PIXMAN_STD_FAST_PATH (IN, solid, a8, a8, sse2_composite_in_n_8_8),
-    PIXMAN_STD_FAST_PATH (IN, solid, null, a8, sse2_composite_in_n_8),
-
-    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
-    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+    f = _mm_min_ps (_mm_max_ps (f, _mm_setzero_ps ()), _mm_set1_ps (1.f));
+    u = _mm_cvttps_epi32 (_mm_mul_ps (f, _mm_set1_ps (256.f)));
 
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_n_8888),
-    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_n_8888),
+    return _mm_sub_epi32 (u, _mm_srli_epi32 (u, 8));
+}
 
-    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, sse2_8888_8888),
+static void
+convert_16161616_to_8888_sse2 (uint32_t       *dst,
+			       const uint32_t *src,
+			       uint32_t        alpha,
+			       int             w)
+{
+    __m128i xmm_alpha = _mm_set1_epi32 (alpha);
+    __m128i zero = _mm_setzero_si128 ();
 
-    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
-    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+    while (w >= 4)
+    {
+	__m128i s0 = load_128_unaligned ((__m128i *)src + 0);
+	__m128i s1 = load_128_unaligned ((__m128i *)src + 1);
+	__m128i lo, hi;
 
-    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8_8888),
-    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8_8888),
-    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8_8888),
-    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8_8888),
+	lo = _mm_packs_epi32 (
+	    unorm16_to_unorm8_1x128 (_mm_unpacklo_epi16 (s0, zero)),
+	    unorm16_to_unorm8_1x128 (_mm_unpackhi_epi16 (s0, zero)));
+	hi = _mm_packs_epi32 (
+	    unorm16_to_unorm8_1x128 (_mm_unpacklo_epi16 (s1, zero)),
+	    unorm16_to_unorm8_1x128 (_mm_unpackhi_epi16 (s1, zero)));
 
-    { PIXMAN_OP_NONE },
-};
+	/* r, g, b, a to b, g, r, a */
+	lo = _mm_shufflehi_epi16 (
+	    _mm_shufflelo_epi16 (lo, _MM_SHUFFLE (3, 0, 1, 2)),
+	    _MM_SHUFFLE (3, 0, 1, 2));
+	hi = _mm_shufflehi_epi16 (
+	    _mm_shufflelo_epi16 (hi, _MM_SHUFFLE (3, 0, 1, 2)),
+	    _MM_SHUFFLE (3, 0, 1, 2));
 
-static uint32_t *
-sse2_fetch_x8r8g8b8 (pixman_iter_t *iter, const uint32_t *mask)
-{
-    int w = iter->width;
-    __m128i ff000000 = mask_ff000000;
-    uint32_t *dst = iter->buffer;
-    uint32_t *src = (uint32_t *)iter->bits;
+	save_128_unaligned ((__m128i *)dst,
+			    _mm_or_si128 (_mm_packus_epi16 (lo, hi), xmm_alpha));
 
-    iter->bits += iter->stride;
+	src += 8;
+	dst += 4;
+	w -= 4;
+    }
 
-    while (w && ((uintptr_t)dst) & 0x0f)
+    while (w--)
     {
-	*dst++ = (*src++) | 0xff000000;
-	w--;
+	uint64_t p = ((uint64_t)src[1] << 32) | src[0];
+
+	*dst++ = convert_16161616_to_8888 (p) | alpha;
+	src += 2;
     }
+}
+
+static void
+convert_8888_to_16161616_sse2 (uint32_t       *dst,
+			       const uint32_t *src,
+			       uint32_t        alpha,
+			       int             w)
+{
+    __m128i xmm_alpha = _mm_set1_epi32 (alpha);
 
     while (w >= 4)
     {
-	save_128_aligned (
-	    (__m128i *)dst, _mm_or_si128 (
-		load_128_unaligned ((__m128i *)src), ff000000));
+	__m128i s = _mm_or_si128 (
+	    load_128_unaligned ((__m128i *)src), xmm_alpha);
+	__m128i lo = _mm_unpacklo_epi8 (s, s);
+	__m128i hi = _mm_unpackhi_epi8 (s, s);
+
+	/* c * 257 is c in both bytes; b, g, r, a to r, g, b, a */
+	lo = _mm_shufflehi_epi16 (
+	    _mm_shufflelo_epi16 (lo, _MM_SHUFFLE (3, 0, 1, 2)),
+	    _MM_SHUFFLE (3, 0, 1, 2));
+	hi = _mm_shufflehi_epi16 (
+	    _mm_shufflelo_epi16 (hi, _MM_SHUFFLE (3, 0, 1, 2)),
+	    _MM_SHUFFLE (3, 0, 1, 2));
+
+	save_128_unaligned ((__m128i *)dst + 0, lo);
+	save_128_unaligned ((__m128i *)dst + 1, hi);
 
-	dst += 4;
 	src += 4;
+	dst += 8;
 	w -= 4;
     }
 
-    while (w)
+    while (w--)
     {
-	*dst++ = (*src++) | 0xff000000;
-	w--;
-    }
+	uint64_t p = convert_8888_to_16161616 (*src++ | alpha);
 
-    return iter->buffer;
+	dst[0] = p;
+	dst[1] = p >> 32;
+	dst += 2;
+    }
 }
 
-static uint32_t *
-sse2_fetch_r5g6b5 (pixman_iter_t *iter, const uint32_t *mask)
+static void
+sse2_composite_src_16161616_8888 (pixman_implementation_t *imp,
+				  pixman_composite_info_t *info)
 {
-    int w = iter->width;
-    uint32_t *dst = iter->buffer;
-    uint16_t *src = (uint16_t *)iter->bits;
-    __m128i ff000000 = mask_ff000000;
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    uint32_t    alpha = 0;
+    int dst_stride, src_stride;
 
-    iter->bits += iter->stride;
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 2);
 
-    while (w && ((uintptr_t)dst) & 0x0f)
+    if (PIXMAN_FORMAT_A (src_image->bits.format) == 0)
+	alpha = 0xff000000;
+
+    while (height--)
     {
-	uint16_t s = *src++;
+	convert_16161616_to_8888_sse2 (dst_line, src_line, alpha, width);
 
-	*dst++ = convert_0565_to_8888 (s);
-	w--;
+	dst_line += dst_stride;
+	src_line += src_stride;
     }
+}
 
-    while (w >= 8)
-    {
-	__m128i lo, hi, s;
+static void
+sse2_composite_over_16161616_8888 (pixman_implementation_t *imp,
+				   pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    uint32_t    buffer[64];
+    int dst_stride, src_stride;
+    int32_t w, n;
 
-	s = _mm_loadu_si128 ((__m128i *)src);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 2);
 
-	lo = unpack_565_to_8888 (_mm_unpacklo_epi16 (s, _mm_setzero_si128 ()));
+    while (height--)
+    {
+	for (w = 0; w < width; w += n)
+	{
+	    n = MIN (width - w, 64);
+
+	    convert_16161616_to_8888_sse2 (buffer, src_line + 2 * w, 0, n);
+	    core_combine_over_u_sse2_no_mask (dst_line + w, buffer, n);
+	}
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+static void
+sse2_composite_src_8888_16161616 (pixman_implementation_t *imp,
+				  pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    uint32_t    alpha = 0;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 2);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    if (PIXMAN_FORMAT_A (src_image->bits.format) == 0)
+	alpha = 0xff000000;
+
+    while (height--)
+    {
+	convert_8888_to_16161616_sse2 (dst_line, src_line, alpha, width);
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+/* OVER to a8r8g8b8_sRGB. The table lookups that linearize and encode
+ * pixels are done one channel at a time, and the arithmetic on the 16 bit
+ * linear channels two pixels at a time. The results are the same as
+ * those of the C fast paths.
+ */
+static force_inline __m128i
+mul_un16_sse2 (__m128i x, __m128i y)
+{
+    __m128i lo = _mm_mullo_epi16 (x, y);
+    __m128i hi = _mm_mulhi_epu16 (x, y);
+    __m128i bias = _mm_set1_epi32 (0x8000);
+    __m128i t0 = _mm_add_epi32 (_mm_unpacklo_epi16 (lo, hi), bias);
+    __m128i t1 = _mm_add_epi32 (_mm_unpackhi_epi16 (lo, hi), bias);
+
+    t0 = _mm_add_epi32 (t0, _mm_srli_epi32 (t0, 16));
+    t1 = _mm_add_epi32 (t1, _mm_srli_epi32 (t1, 16));
+
+    /* The arithmetic shifts keep the top halves in range of packs */
+    return _mm_packs_epi32 (_mm_srai_epi32 (t0, 16), _mm_srai_epi32 (t1, 16));
+}
+
+static force_inline __m128i
+over_16161616_sse2 (__m128i s, __m128i d)
+{
+    __m128i ia = _mm_shufflehi_epi16 (
+	_mm_shufflelo_epi16 (s, _MM_SHUFFLE (3, 3, 3, 3)),
+	_MM_SHUFFLE (3, 3, 3, 3));
+
+    ia = _mm_xor_si128 (ia, mask_ffff);
+
+    return _mm_adds_epu16 (s, mul_un16_sse2 (d, ia));
+}
+
+static force_inline __m128i
+load_16161616x2 (uint64_t p0, uint64_t p1)
+{
+    uint64_t p[2];
+
+    p[0] = p0;
+    p[1] = p1;
+
+    return _mm_loadu_si128 ((__m128i *)p);
+}
+
+static force_inline void
+store_srgb_x2 (uint32_t *dst, __m128i v)
+{
+    uint64_t p[2];
+
+    _mm_storeu_si128 ((__m128i *)p, v);
+
+    dst[0] = convert_16161616_to_srgb (p[0]);
+    dst[1] = convert_16161616_to_srgb (p[1]);
+}
+
+static force_inline uint64_t
+fetch_linear (uint32_t s, pixman_format_code_t format)
+{
+    if (format == PIXMAN_a8r8g8b8_sRGB)
+	return convert_srgb_to_16161616 (s);
+    else
+	return convert_8888_to_16161616 (s);
+}
+
+static force_inline uint32_t
+convert_to_srgb (uint32_t s, pixman_format_code_t format)
+{
+    if (format == PIXMAN_a8r8g8b8_sRGB)
+	return s;
+    else
+	return convert_16161616_to_srgb (convert_8888_to_16161616 (s));
+}
+
+static force_inline void
+sse2_composite_over_srgb (pixman_composite_info_t *info,
+			  pixman_format_code_t     src_format)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int dst_stride, src_stride;
+    int32_t w;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w >= 2)
+	{
+	    uint32_t s0 = src[0];
+	    uint32_t s1 = src[1];
+
+	    if ((s0 & s1) >> 24 == 0xff)
+	    {
+		dst[0] = convert_to_srgb (s0, src_format);
+		dst[1] = convert_to_srgb (s1, src_format);
+	    }
+	    else if (s0 | s1)
+	    {
+		__m128i xmm_src = load_16161616x2 (
+		    fetch_linear (s0, src_format), fetch_linear (s1, src_format));
+		__m128i xmm_dst = load_16161616x2 (
+		    convert_srgb_to_16161616 (dst[0]),
+		    convert_srgb_to_16161616 (dst[1]));
+
+		store_srgb_x2 (dst, over_16161616_sse2 (xmm_src, xmm_dst));
+	    }
+
+	    src += 2;
+	    dst += 2;
+	    w -= 2;
+	}
+
+	if (w)
+	{
+	    uint32_t s = *src;
+
+	    if ((s >> 24) == 0xff)
+	    {
+		*dst = convert_to_srgb (s, src_format);
+	    }
+	    else if (s)
+	    {
+		*dst = convert_16161616_to_srgb (
+		    over_16161616 (fetch_linear (s, src_format),
+				   convert_srgb_to_16161616 (*dst)));
+	    }
+	}
+    }
+}
+
+static void
+sse2_composite_over_8888_srgb (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    sse2_composite_over_srgb (info, PIXMAN_a8r8g8b8);
+}
+
+static void
+sse2_composite_over_srgb_srgb (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    sse2_composite_over_srgb (info, PIXMAN_a8r8g8b8_sRGB);
+}
+
+static void
+sse2_composite_over_n_8_srgb (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint8_t     *mask_line, *mask;
+    uint32_t     src_srgb;
+    uint64_t     s;
+    pixman_bool_t opaque;
+    __m128i      xmm_src;
+    int dst_stride, mask_stride;
+    int32_t w;
+
+    s = _pixman_image_get_solid_16161616 (imp, src_image);
+    if (s == 0)
+	return;
+
+    src_srgb = convert_16161616_to_srgb (s);
+    opaque = (s >> 48) == 0xffff;
+    xmm_src = load_16161616x2 (s, s);
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	mask_image, mask_x, mask_y, uint8_t, mask_stride, mask_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	mask = mask_line;
+	mask_line += mask_stride;
+	w = width;
+
+	while (w >= 2)
+	{
+	    uint32_t m0 = mask[0];
+	    uint32_t m1 = mask[1];
+
+	    if ((m0 & m1) == 0xff && opaque)
+	    {
+		dst[0] = src_srgb;
+		dst[1] = src_srgb;
+	    }
+	    else if (m0 | m1)
+	    {
+		__m128i xmm_mask = _mm_unpacklo_epi64 (
+		    _mm_set1_epi16 (m0 * 257), _mm_set1_epi16 (m1 * 257));
+		__m128i xmm_dst = load_16161616x2 (
+		    convert_srgb_to_16161616 (dst[0]),
+		    convert_srgb_to_16161616 (dst[1]));
+
+		/* mul_un16 () leaves the source unchanged where m is 0xff */
+		store_srgb_x2 (dst, over_16161616_sse2 (
+				   mul_un16_sse2 (xmm_src, xmm_mask), xmm_dst));
+	    }
+
+	    mask += 2;
+	    dst += 2;
+	    w -= 2;
+	}
+
+	if (w)
+	{
+	    uint32_t m = *mask;
+
+	    if (m == 0xff && opaque)
+	    {
+		*dst = src_srgb;
+	    }
+	    else if (m)
+	    {
+		*dst = convert_16161616_to_srgb (
+		    over_16161616 (in_16161616 (s, m * 257),
+				   convert_srgb_to_16161616 (*dst)));
+	    }
+	}
+    }
+}
+
+/* Converts eight pixels of BT.601 YUV to x8r8g8b8, with the same
+ * arithmetic as convert_yuv_to_8888 (). The low halves of y and uv hold
+ * eight luma samples and four interleaved U, V pairs. Each coefficient
+ * is split into a multiple of 0x10000 and a signed 16 bit remainder, so
+ * that the remainders can go through pmaddwd.
+ */
+static force_inline void
+yuv_to_8888_sse2 (uint32_t *dst, __m128i y, __m128i uv)
+{
+    __m128i zero = _mm_setzero_si128 ();
+    __m128i c_r = _mm_set_epi16 (-26066, 11047, -26066, 11047,
+				 -26066, 11047, -26066, 11047);
+    __m128i c_gv = _mm_set_epi16 (12046, 11047, 12046, 11047,
+				  12046, 11047, 12046, 11047);
+    __m128i c_gu = _mm_set_epi16 (-25726, 0, -25726, 0,
+				  -25726, 0, -25726, 0);
+    __m128i c_b = _mm_set_epi16 (1698, 11047, 1698, 11047,
+				 1698, 11047, 1698, 11047);
+    __m128i u, v, yv_lo, yv_hi, yu_lo, yu_hi, r, g, b, br, ga, bg, ra;
+
+    y = _mm_sub_epi16 (_mm_unpacklo_epi8 (y, zero), _mm_set1_epi16 (16));
+
+    /* Each U, V pair is shared by two pixels */
+    uv = _mm_unpacklo_epi16 (uv, uv);
+    u = _mm_sub_epi16 (_mm_and_si128 (uv, _mm_set1_epi16 (0x00ff)),
+		       _mm_set1_epi16 (128));
+    v = _mm_sub_epi16 (_mm_srli_epi16 (uv, 8), _mm_set1_epi16 (128));
+
+    yv_lo = _mm_unpacklo_epi16 (y, v);
+    yv_hi = _mm_unpackhi_epi16 (y, v);
+    yu_lo = _mm_unpacklo_epi16 (y, u);
+    yu_hi = _mm_unpackhi_epi16 (y, u);
+
+    r = _mm_packs_epi32 (
+	_mm_srai_epi32 (_mm_madd_epi16 (yv_lo, c_r), 16),
+	_mm_srai_epi32 (_mm_madd_epi16 (yv_hi, c_r), 16));
+    g = _mm_packs_epi32 (
+	_mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (yv_lo, c_gv),
+				       _mm_madd_epi16 (yu_lo, c_gu)), 16),
+	_mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (yv_hi, c_gv),
+				       _mm_madd_epi16 (yu_hi, c_gu)), 16));
+    b = _mm_packs_epi32 (
+	_mm_srai_epi32 (_mm_madd_epi16 (yu_lo, c_b), 16),
+	_mm_srai_epi32 (_mm_madd_epi16 (yu_hi, c_b), 16));
+
+    /* The multiples of 0x10000: R = Y + 2V, G = Y - V, B = Y + 2U */
+    r = _mm_add_epi16 (r, _mm_add_epi16 (y, _mm_add_epi16 (v, v)));
+    g = _mm_add_epi16 (g, _mm_sub_epi16 (y, v));
+    b = _mm_add_epi16 (b, _mm_add_epi16 (y, _mm_add_epi16 (u, u)));
+
+    /* Saturation does the clamping */
+    br = _mm_packus_epi16 (b, r);
+    ga = _mm_packus_epi16 (g, _mm_set1_epi16 (0xff));
+    bg = _mm_unpacklo_epi8 (br, ga);
+    ra = _mm_unpackhi_epi8 (br, ga);
+
+    _mm_storeu_si128 ((__m128i *)(dst + 0), _mm_unpacklo_epi16 (bg, ra));
+    _mm_storeu_si128 ((__m128i *)(dst + 4), _mm_unpackhi_epi16 (bg, ra));
+}
+
+static force_inline void
+fetch_yuv_row_sse2 (uint32_t *           dst,
+		    bits_image_t *       image,
+		    pixman_format_code_t format,
+		    int                  x,
+		    int                  line,
+		    int                  width)
+{
+    const uint8_t *y_line, *u_line, *v_line;
+
+    yuv_get_lines (image, line, &y_line, &u_line, &v_line);
+
+    /* Pixels with even x start a chroma pair */
+    if (width && (x & 1))
+    {
+	*dst++ = yuv_fetch_pixel (format, y_line, u_line, v_line, x++);
+	width--;
+    }
+
+    while (width >= 16)
+    {
+	__m128i y, uv;
+
+	if (format == PIXMAN_yuy2)
+	{
+	    __m128i p0 = _mm_loadu_si128 ((__m128i *)(y_line + x * 2));
+	    __m128i p1 = _mm_loadu_si128 ((__m128i *)(y_line + x * 2 + 16));
+	    __m128i ff = _mm_set1_epi16 (0x00ff);
+
+	    y = _mm_packus_epi16 (_mm_and_si128 (p0, ff), _mm_and_si128 (p1, ff));
+	    uv = _mm_packus_epi16 (_mm_srli_epi16 (p0, 8), _mm_srli_epi16 (p1, 8));
+	}
+	else if (format == PIXMAN_nv12)
+	{
+	    y = _mm_loadu_si128 ((__m128i *)(y_line + x));
+	    uv = _mm_loadu_si128 ((__m128i *)(u_line + x));
+	}
+	else
+	{
+	    y = _mm_loadu_si128 ((__m128i *)(y_line + x));
+	    uv = _mm_unpacklo_epi8 (
+		_mm_loadl_epi64 ((__m128i *)(u_line + (x >> 1))),
+		_mm_loadl_epi64 ((__m128i *)(v_line + (x >> 1))));
+	}
+
+	yuv_to_8888_sse2 (dst, y, uv);
+	yuv_to_8888_sse2 (dst + 8, _mm_srli_si128 (y, 8), _mm_srli_si128 (uv, 8));
+
+	dst += 16;
+	x += 16;
+	width -= 16;
+    }
+
+    while (width--)
+	*dst++ = yuv_fetch_pixel (format, y_line, u_line, v_line, x++);
+}
+
+static void
+sse2_fetch_yuv_row (uint32_t *     dst,
+		    bits_image_t * image,
+		    int            x,
+		    int            line,
+		    int            width)
+{
+    switch (image->format)
+    {
+    case PIXMAN_yuy2:
+	fetch_yuv_row_sse2 (dst, image, PIXMAN_yuy2, x, line, width);
+	break;
+
+    case PIXMAN_nv12:
+	fetch_yuv_row_sse2 (dst, image, PIXMAN_nv12, x, line, width);
+	break;
+
+    default:
+	fetch_yuv_row_sse2 (dst, image, PIXMAN_yv12, x, line, width);
+	break;
+    }
+}
+
+FAST_YUV (sse2_yuv_8888, sse2_fetch_yuv_row,
+	  scaled_bilinear_scanline_sse2_8888_8888_SRC)
+
+static const pixman_fast_path_t sse2_fast_paths[] =
+{
+    /* PIXMAN_OP_OVER */
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, r5g6b5, sse2_composite_over_n_8_0565),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, b5g6r5, sse2_composite_over_n_8_0565),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, a8r8g8b8, sse2_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, x8r8g8b8, sse2_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, r5g6b5, sse2_composite_over_n_0565),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, b5g6r5, sse2_composite_over_n_0565),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, a8r8g8b8, sse2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, x8r8g8b8, sse2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, a8b8g8r8, sse2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, x8b8g8r8, sse2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, r5g6b5, sse2_composite_over_8888_0565),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, b5g6r5, sse2_composite_over_8888_0565),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16, a8r8g8b8, sse2_composite_over_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a16b16g16r16, x8r8g8b8, sse2_composite_over_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8_sRGB, sse2_composite_over_8888_srgb),
+    PIXMAN_WIDE_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8_sRGB, sse2_composite_over_srgb_srgb),
+    PIXMAN_WIDE_DEST_FAST_PATH (OVER, solid, a8, a8r8g8b8_sRGB, sse2_composite_over_n_8_srgb),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8r8g8b8, sse2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8r8g8b8, sse2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8b8g8r8, sse2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8b8g8r8, sse2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, a8r8g8b8, sse2_composite_over_8888_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, a8, x8r8g8b8, sse2_composite_over_8888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, a8, a8r8g8b8, sse2_composite_over_8888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, a8, x8b8g8r8, sse2_composite_over_8888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, a8, a8b8g8r8, sse2_composite_over_8888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, a8, x8r8g8b8, sse2_composite_over_x888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, a8, a8r8g8b8, sse2_composite_over_x888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, a8, x8b8g8r8, sse2_composite_over_x888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, a8, a8b8g8r8, sse2_composite_over_x888_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, solid, a8r8g8b8, sse2_composite_over_x888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, solid, x8r8g8b8, sse2_composite_over_x888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, solid, a8b8g8r8, sse2_composite_over_x888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, solid, x8b8g8r8, sse2_composite_over_x888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, solid, a8r8g8b8, sse2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, solid, x8r8g8b8, sse2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, solid, a8b8g8r8, sse2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, solid, x8b8g8r8, sse2_composite_over_8888_n_8888),
+    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8r8g8b8, a8r8g8b8, sse2_composite_over_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8r8g8b8, x8r8g8b8, sse2_composite_over_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8b8g8r8, a8b8g8r8, sse2_composite_over_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8b8g8r8, x8b8g8r8, sse2_composite_over_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8r8g8b8, r5g6b5, sse2_composite_over_n_8888_0565_ca),
+    PIXMAN_STD_FAST_PATH_CA (OVER, solid, a8b8g8r8, b5g6r5, sse2_composite_over_n_8888_0565_ca),
+    PIXMAN_STD_FAST_PATH (OVER, pixbuf, pixbuf, a8r8g8b8, sse2_composite_over_pixbuf_8888),
+    PIXMAN_STD_FAST_PATH (OVER, pixbuf, pixbuf, x8r8g8b8, sse2_composite_over_pixbuf_8888),
+    PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, a8b8g8r8, sse2_composite_over_pixbuf_8888),
+    PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, x8b8g8r8, sse2_composite_over_pixbuf_8888),
+    PIXMAN_STD_FAST_PATH (OVER, pixbuf, pixbuf, r5g6b5, sse2_composite_over_pixbuf_0565),
+    PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, b5g6r5, sse2_composite_over_pixbuf_0565),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
+    
+    /* PIXMAN_OP_OVER_REVERSE */
+    PIXMAN_STD_FAST_PATH (OVER_REVERSE, solid, null, a8r8g8b8, sse2_composite_over_reverse_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER_REVERSE, solid, null, a8b8g8r8, sse2_composite_over_reverse_n_8888),
+
+    /* PIXMAN_OP_ADD */
+    PIXMAN_STD_FAST_PATH_CA (ADD, solid, a8r8g8b8, a8r8g8b8, sse2_composite_add_n_8888_8888_ca),
+    PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, sse2_composite_add_8_8),
+    PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, sse2_composite_add_8888_8888),
+    PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, sse2_composite_add_8888_8888),
+    PIXMAN_STD_FAST_PATH (ADD, solid, a8, a8, sse2_composite_add_n_8_8),
+    PIXMAN_STD_FAST_PATH (ADD, solid, null, a8, sse2_composite_add_n_8),
+
+    /* PIXMAN_OP_SRC */
+    PIXMAN_STD_FAST_PATH (SRC, solid, a8, a8r8g8b8, sse2_composite_src_n_8_8888),
+    PIXMAN_STD_FAST_PATH (SRC, solid, a8, x8r8g8b8, sse2_composite_src_n_8_8888),
+    PIXMAN_STD_FAST_PATH (SRC, solid, a8, a8b8g8r8, sse2_composite_src_n_8_8888),
+    PIXMAN_STD_FAST_PATH (SRC, solid, a8, x8b8g8r8, sse2_composite_src_n_8_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, r5g6b5, sse2_composite_src_x888_0565),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, b5g6r5, sse2_composite_src_x888_0565),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, r5g6b5, sse2_composite_src_x888_0565),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, b5g6r5, sse2_composite_src_x888_0565),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, null, r5g6b5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, null, b5g6r5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, null, r5g6b5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, null, b5g6r5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, null, r5g6b5, sse2_composite_over_8888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, null, b5g6r5, sse2_composite_over_8888_0565_dither),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, a8r8g8b8, sse2_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, a8b8g8r8, sse2_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, a8r8g8b8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, a8b8g8r8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, r5g6b5, null, r5g6b5, sse2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, b5g6r5, null, b5g6r5, sse2_composite_copy_area),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16, a8r8g8b8, sse2_composite_src_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a16b16g16r16, x8r8g8b8, sse2_composite_src_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, x16b16g16r16, a8r8g8b8, sse2_composite_src_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, x16b16g16r16, x8r8g8b8, sse2_composite_src_16161616_8888),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, a16b16g16r16, sse2_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, a16b16g16r16, sse2_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, a8r8g8b8, x16b16g16r16, sse2_composite_src_8888_16161616),
+    PIXMAN_WIDE_FAST_PATH (SRC, x8r8g8b8, x16b16g16r16, sse2_composite_src_8888_16161616),
+
+    /* PIXMAN_OP_IN */
+    PIXMAN_STD_FAST_PATH (IN, a8, null, a8, sse2_composite_in_8_8),
+    PIXMAN_STD_FAST_PATH (IN, solid, a8, a8, sse2_composite_in_n_8_8),
+    PIXMAN_STD_FAST_PATH (IN, solid, null, a8, sse2_composite_in_n_8),
+
+    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_COVER (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NONE (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_PAD (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH_NORMAL (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_n_8888),
+    SIMPLE_NEAREST_SOLID_MASK_FAST_PATH_NORMAL (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_n_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, sse2_8888_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8888),
+
+    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, sse2_8888_8_8888),
+    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, sse2_8888_8_8888),
+    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, sse2_8888_8_8888),
+    SIMPLE_BILINEAR_A8_MASK_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, sse2_8888_8_8888),
+
+    YUV_FAST_PATHS (x8r8g8b8, sse2_yuv_8888),
+    YUV_FAST_PATHS (a8r8g8b8, sse2_yuv_8888),
+
+    { PIXMAN_OP_NONE },
+};
+
+static uint32_t *
+sse2_fetch_x8r8g8b8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    int w = iter->width;
+    __m128i ff000000 = mask_ff000000;
+    uint32_t *dst = iter->buffer;
+    uint32_t *src = (uint32_t *)iter->bits;
+
+    iter->bits += iter->stride;
+
+    while (w && ((uintptr_t)dst) & 0x0f)
+    {
+	*dst++ = (*src++) | 0xff000000;
+	w--;
+    }
+
+    while (w >= 4)
+    {
+	save_128_aligned (
+	    (__m128i *)dst, _mm_or_si128 (
+		load_128_unaligned ((__m128i *)src), ff000000));
+
+	dst += 4;
+	src += 4;
+	w -= 4;
+    }
+
+    while (w)
+    {
+	*dst++ = (*src++) | 0xff000000;
+	w--;
+    }
+
+    return iter->buffer;
+}
+
+static uint32_t *
+sse2_fetch_r5g6b5 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    int w = iter->width;
+    uint32_t *dst = iter->buffer;
+    uint16_t *src = (uint16_t *)iter->bits;
+    __m128i ff000000 = mask_ff000000;
+
+    iter->bits += iter->stride;
+
+    while (w && ((uintptr_t)dst) & 0x0f)
+    {
+	uint16_t s = *src++;
+
+	*dst++ = convert_0565_to_8888 (s);
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m128i lo, hi, s;
+
+	s = _mm_loadu_si128 ((__m128i *)src);
+
+	lo = unpack_565_to_8888 (_mm_unpacklo_epi16 (s, _mm_setzero_si128 ()));
 	hi = unpack_565_to_8888 (_mm_unpackhi_epi16 (s, _mm_setzero_si128 ()));
 
 	save_128_aligned ((__m128i *)(dst + 0), _mm_or_si128 (lo, ff000000));
@@ -6048,53 +7441,725 @@ sse2_fetch_a8 (pixman_iter_t *iter, const uint32_t *mask)
     return iter->buffer;
 }
 
-typedef struct
+static void
+fetch_16161616_float_sse2 (argb_t         *dst,
+			   const uint32_t *src,
+			   pixman_bool_t   opaque,
+			   int             w)
+{
+    __m128 scale = _mm_set1_ps (1.f / 65535.f);
+    __m128i zero = _mm_setzero_si128 ();
+
+    while (w >= 2)
+    {
+	__m128i s = load_128_unaligned ((__m128i *)src);
+	__m128 lo, hi;
+
+	/* r, g, b, a to a, r, g, b */
+	s = _mm_shufflehi_epi16 (
+	    _mm_shufflelo_epi16 (s, _MM_SHUFFLE (2, 1, 0, 3)),
+	    _MM_SHUFFLE (2, 1, 0, 3));
+
+	lo = _mm_mul_ps (_mm_cvtepi32_ps (_mm_unpacklo_epi16 (s, zero)), scale);
+	hi = _mm_mul_ps (_mm_cvtepi32_ps (_mm_unpackhi_epi16 (s, zero)), scale);
+
+	_mm_storeu_ps ((float *)(dst + 0), lo);
+	_mm_storeu_ps ((float *)(dst + 1), hi);
+
+	if (opaque)
+	{
+	    dst[0].a = 1.0f;
+	    dst[1].a = 1.0f;
+	}
+
+	src += 4;
+	dst += 2;
+	w -= 2;
+    }
+
+    if (w)
+    {
+	dst->a = opaque ? 1.0f : unorm_to_float (src[1] >> 16, 16);
+	dst->r = unorm_to_float (src[0], 16);
+	dst->g = unorm_to_float (src[0] >> 16, 16);
+	dst->b = unorm_to_float (src[1], 16);
+    }
+}
+
+static force_inline __m128i
+float_to_unorm16_1x128 (__m128 f)
 {
-    pixman_format_code_t	format;
-    pixman_iter_get_scanline_t	get_scanline;
-} fetcher_info_t;
+    f = _mm_min_ps (_mm_max_ps (f, _mm_setzero_ps ()), _mm_set1_ps (1.f));
+    f = _mm_add_ps (_mm_mul_ps (f, _mm_set1_ps (65535.f)), _mm_set1_ps (0.5f));
 
-static const fetcher_info_t fetchers[] =
+    /* Bias to signed so _mm_packs_epi32() doesn't saturate */
+    return _mm_sub_epi32 (_mm_cvttps_epi32 (f), _mm_set1_epi32 (0x8000));
+}
+
+static void
+store_16161616_float_sse2 (uint32_t     *dst,
+			   const argb_t *src,
+			   uint64_t      mask,
+			   int           w)
 {
-    { PIXMAN_x8r8g8b8,		sse2_fetch_x8r8g8b8 },
-    { PIXMAN_r5g6b5,		sse2_fetch_r5g6b5 },
-    { PIXMAN_a8,		sse2_fetch_a8 },
-    { PIXMAN_null }
-};
+    __m128i xmm_mask = _mm_set_epi32 (mask >> 32, mask, mask >> 32, mask);
 
-static pixman_bool_t
-sse2_src_iter_init (pixman_implementation_t *imp, pixman_iter_t *iter)
+    while (w >= 2)
+    {
+	__m128i d = _mm_packs_epi32 (
+	    float_to_unorm16_1x128 (_mm_loadu_ps ((float *)(src + 0))),
+	    float_to_unorm16_1x128 (_mm_loadu_ps ((float *)(src + 1))));
+
+	/* a, r, g, b to r, g, b, a */
+	d = _mm_xor_si128 (d, _mm_set1_epi16 (0x8000));
+	d = _mm_shufflehi_epi16 (
+	    _mm_shufflelo_epi16 (d, _MM_SHUFFLE (0, 3, 2, 1)),
+	    _MM_SHUFFLE (0, 3, 2, 1));
+
+	save_128_unaligned ((__m128i *)dst, _mm_and_si128 (d, xmm_mask));
+
+	src += 2;
+	dst += 4;
+	w -= 2;
+    }
+
+    if (w)
+    {
+	uint64_t p =
+	    ((uint64_t)float_to_unorm16 (src->a) << 48) |
+	    ((uint64_t)float_to_unorm16 (src->b) << 32) |
+	    ((uint64_t)float_to_unorm16 (src->g) << 16) |
+	    ((uint64_t)float_to_unorm16 (src->r) <<  0);
+
+	p &= mask;
+	dst[0] = p;
+	dst[1] = p >> 32;
+    }
+}
+
+static uint32_t *
+sse2_fetch_a16b16g16r16_float (pixman_iter_t *iter, const uint32_t *mask)
+{
+    fetch_16161616_float_sse2 ((argb_t *)iter->buffer, (uint32_t *)iter->bits,
+			       FALSE, iter->width);
+
+    iter->bits += iter->stride;
+
+    return iter->buffer;
+}
+
+static uint32_t *
+sse2_fetch_x16b16g16r16_float (pixman_iter_t *iter, const uint32_t *mask)
+{
+    fetch_16161616_float_sse2 ((argb_t *)iter->buffer, (uint32_t *)iter->bits,
+			       TRUE, iter->width);
+
+    iter->bits += iter->stride;
+
+    return iter->buffer;
+}
+
+static uint32_t *
+sse2_fetch_yuv (pixman_iter_t *iter, const uint32_t *mask)
+{
+    sse2_fetch_yuv_row (iter->buffer, &iter->image->bits,
+			iter->x, iter->y++, iter->width);
+
+    return iter->buffer;
+}
+
+static uint32_t *
+sse2_dest_get_a16b16g16r16_float (pixman_iter_t *iter, const uint32_t *mask)
 {
-    pixman_image_t *image = iter->image;
+    fetch_16161616_float_sse2 ((argb_t *)iter->buffer, (uint32_t *)iter->bits,
+			       FALSE, iter->width);
 
-#define FLAGS								\
+    return iter->buffer;
+}
+
+static uint32_t *
+sse2_dest_get_x16b16g16r16_float (pixman_iter_t *iter, const uint32_t *mask)
+{
+    fetch_16161616_float_sse2 ((argb_t *)iter->buffer, (uint32_t *)iter->bits,
+			       TRUE, iter->width);
+
+    return iter->buffer;
+}
+
+static void
+sse2_write_back_a16b16g16r16_float (pixman_iter_t *iter)
+{
+    store_16161616_float_sse2 ((uint32_t *)iter->bits, (argb_t *)iter->buffer,
+			       0xffffffffffffffffULL, iter->width);
+
+    iter->bits += iter->stride;
+}
+
+static void
+sse2_write_back_x16b16g16r16_float (pixman_iter_t *iter)
+{
+    store_16161616_float_sse2 ((uint32_t *)iter->bits, (argb_t *)iter->buffer,
+			       0xffffffffffffULL, iter->width);
+
+    iter->bits += iter->stride;
+}
+
+#define IMAGE_FLAGS							\
     (FAST_PATH_STANDARD_FLAGS | FAST_PATH_ID_TRANSFORM |		\
      FAST_PATH_BITS_IMAGE | FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
 
-    if ((iter->iter_flags & ITER_NARROW)			&&
-	(iter->image_flags & FLAGS) == FLAGS)
+#define WIDE_IMAGE_FLAGS	(IMAGE_FLAGS & ~FAST_PATH_NARROW_FORMAT)
+#define WIDE_DEST_FLAGS		(FAST_PATH_NO_ACCESSORS | FAST_PATH_NO_ALPHA_MAP)
+
+/* The passes of the separable convolution scaler, see pixman-bits-image.c */
+static void
+sse2_convolve_row (int16_t *        dst,
+		   const uint32_t * src,
+		   const int32_t *  offsets,
+		   const int16_t ** weights,
+		   int              n_taps,
+		   int              width)
+{
+    __m128i zero = _mm_setzero_si128 ();
+    int k, i;
+
+    for (k = 0; k < width; ++k)
     {
-	const fetcher_info_t *f;
+	const uint32_t *s = src + offsets[k];
+	const __m128i *w = (const __m128i *)weights[k];
+	__m128i sum = _mm_set1_epi32 (0x80);
 
-	for (f = &fetchers[0]; f->format != PIXMAN_null; f++)
+	for (i = 0; i < n_taps; i += 4)
 	{
-	    if (image->common.extended_format_code == f->format)
-	    {
-		uint8_t *b = (uint8_t *)image->bits.bits;
-		int s = image->bits.rowstride * 4;
+	    __m128i p = _mm_loadu_si128 ((const __m128i *)(s + i));
+	    __m128i q = _mm_srli_si128 (p, 4);
 
-		iter->bits = b + s * iter->y + iter->x * PIXMAN_FORMAT_BPP (f->format) / 8;
-		iter->stride = s;
+	    /* Interleave the channels of pixels 0 and 1, and of 2 and 3 */
+	    __m128i p01 = _mm_unpacklo_epi8 (_mm_unpacklo_epi8 (p, q), zero);
+	    __m128i p23 = _mm_unpacklo_epi8 (_mm_unpackhi_epi8 (p, q), zero);
 
-		iter->get_scanline = f->get_scanline;
-		return TRUE;
-	    }
+	    sum = _mm_add_epi32 (sum, _mm_madd_epi16 (p01, _mm_loadu_si128 (w + 0)));
+	    sum = _mm_add_epi32 (sum, _mm_madd_epi16 (p23, _mm_loadu_si128 (w + 1)));
+
+	    w += 2;
+	}
+
+	sum = _mm_srai_epi32 (sum, 8);
+	_mm_storel_epi64 ((__m128i *)(dst + k * 4), _mm_packs_epi32 (sum, sum));
+    }
+}
+
+static void
+sse2_convolve_column (uint32_t *       dst,
+		      const int16_t ** rows,
+		      const int16_t *  weights,
+		      int              n_taps,
+		      int              width)
+{
+    __m128i round = _mm_set1_epi32 (1 << 19);
+    int k = 0, i;
+
+    for (; k + 4 <= width; k += 4)
+    {
+	__m128i s0 = round, s1 = round, s2 = round, s3 = round;
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    __m128i w = _mm_loadu_si128 ((const __m128i *)(weights + i * 4));
+	    const int16_t *a = rows[i] + k * 4;
+	    const int16_t *b = rows[i + 1] + k * 4;
+	    __m128i a0 = _mm_loadu_si128 ((const __m128i *)(a + 0));
+	    __m128i a1 = _mm_loadu_si128 ((const __m128i *)(a + 8));
+	    __m128i b0 = _mm_loadu_si128 ((const __m128i *)(b + 0));
+	    __m128i b1 = _mm_loadu_si128 ((const __m128i *)(b + 8));
+
+	    s0 = _mm_add_epi32 (s0, _mm_madd_epi16 (_mm_unpacklo_epi16 (a0, b0), w));
+	    s1 = _mm_add_epi32 (s1, _mm_madd_epi16 (_mm_unpackhi_epi16 (a0, b0), w));
+	    s2 = _mm_add_epi32 (s2, _mm_madd_epi16 (_mm_unpacklo_epi16 (a1, b1), w));
+	    s3 = _mm_add_epi32 (s3, _mm_madd_epi16 (_mm_unpackhi_epi16 (a1, b1), w));
+	}
+
+	s0 = _mm_packs_epi32 (_mm_srai_epi32 (s0, 20), _mm_srai_epi32 (s1, 20));
+	s2 = _mm_packs_epi32 (_mm_srai_epi32 (s2, 20), _mm_srai_epi32 (s3, 20));
+
+	_mm_storeu_si128 ((__m128i *)(dst + k), _mm_packus_epi16 (s0, s2));
+    }
+
+    for (; k < width; ++k)
+    {
+	__m128i s0 = round;
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    __m128i w = _mm_loadu_si128 ((const __m128i *)(weights + i * 4));
+	    __m128i a = _mm_loadl_epi64 ((const __m128i *)(rows[i] + k * 4));
+	    __m128i b = _mm_loadl_epi64 ((const __m128i *)(rows[i + 1] + k * 4));
+
+	    s0 = _mm_add_epi32 (s0, _mm_madd_epi16 (_mm_unpacklo_epi16 (a, b), w));
+	}
+
+	s0 = _mm_srai_epi32 (s0, 20);
+	s0 = _mm_packs_epi32 (s0, s0);
+
+	dst[k] = _mm_cvtsi128_si32 (_mm_packus_epi16 (s0, s0));
+    }
+}
+
+static void
+sse2_separable_scaler_init (pixman_iter_t *iter, const pixman_iter_info_t *info)
+{
+    _pixman_separable_scaler_iter_init (
+	iter, sse2_convolve_row, sse2_convolve_column);
+}
+
+/* Linear gradients, for rows where the transformation is affine. The
+ * positions are computed four at a time exactly like
+ * _pixman_linear_gradient_get_scanline_narrow() computes them, and
+ * then either looked up in the LUT of the gradient, or interpolated
+ * like _pixman_gradient_walker_pixel() does when all four are in the
+ * current interval of the walker.
+ */
+static force_inline __m128i
+linear_positions_4x128 (__m128i t, __m128d inc, int i)
+{
+    __m128i p01 = _mm_cvttpd_epi32 (_mm_mul_pd (inc, _mm_set_pd (i + 1, i)));
+    __m128i p23 = _mm_cvttpd_epi32 (_mm_mul_pd (inc, _mm_set_pd (i + 3, i + 2)));
+
+    return _mm_add_epi32 (t, _mm_unpacklo_epi64 (p01, p23));
+}
+
+static force_inline __m128i
+gradient_lut_4x128 (const uint32_t *lut, pixman_repeat_t repeat, __m128i pos)
+{
+    __m128i one = _mm_set1_epi32 (0x10000);
+    __m128i outside = _mm_setzero_si128 ();
+    __m128i m;
+    uint32_t idx[4];
+
+    switch (repeat)
+    {
+    case PIXMAN_REPEAT_NORMAL:
+	pos = _mm_and_si128 (pos, _mm_set1_epi32 (0xffff));
+	break;
+
+    case PIXMAN_REPEAT_REFLECT:
+	pos = _mm_and_si128 (pos, _mm_set1_epi32 (0x1ffff));
+	m = _mm_cmpgt_epi32 (pos, one);
+	pos = _mm_or_si128 (
+	    _mm_andnot_si128 (m, pos),
+	    _mm_and_si128 (m, _mm_sub_epi32 (_mm_slli_epi32 (one, 1), pos)));
+	break;
+
+    case PIXMAN_REPEAT_PAD:
+	pos = _mm_andnot_si128 (_mm_srai_epi32 (pos, 31), pos);
+	m = _mm_cmpgt_epi32 (pos, one);
+	pos = _mm_or_si128 (_mm_andnot_si128 (m, pos), _mm_and_si128 (m, one));
+	break;
+
+    default:
+	outside = _mm_or_si128 (_mm_srai_epi32 (pos, 31),
+				_mm_cmpgt_epi32 (pos, one));
+	pos = _mm_andnot_si128 (outside, pos);
+	break;
+    }
+
+    pos = _mm_add_epi32 (pos, _mm_set1_epi32 (1 << (15 - GRADIENT_LUT_BITS)));
+    pos = _mm_srli_epi32 (pos, 16 - GRADIENT_LUT_BITS);
+    _mm_storeu_si128 ((__m128i *)idx, pos);
+
+    return _mm_andnot_si128 (
+	outside, _mm_set_epi32 (lut[idx[3]], lut[idx[2]], lut[idx[1]], lut[idx[0]]));
+}
+
+/* Whether all four positions are in the current interval of the walker */
+static force_inline pixman_bool_t
+gradient_walker_contains_4x128 (pixman_gradient_walker_t *walker, __m128i pos)
+{
+    __m128i below = _mm_cmplt_epi32 (pos, _mm_set1_epi32 (walker->left_x));
+    __m128i inside = _mm_cmplt_epi32 (pos, _mm_set1_epi32 (walker->right_x));
+
+    return !walker->need_reset &&
+	_mm_movemask_epi8 (_mm_andnot_si128 (below, inside)) == 0xffff;
+}
+
+static force_inline __m128i
+gradient_interpolate_1x128 (__m128i left, __m128i right, __m128i dist)
+{
+    __m128i c;
+
+    c = _mm_add_epi16 (
+	_mm_mullo_epi16 (left, _mm_sub_epi16 (_mm_set1_epi16 (256), dist)),
+	_mm_mullo_epi16 (right, dist));
+    c = _mm_srli_epi16 (c, 8);
+
+    return pix_multiply_1x128 (c, _mm_or_si128 (expand_alpha_1x128 (c),
+						 mask_alpha));
+}
+
+static force_inline __m128i
+gradient_walker_4x128 (pixman_gradient_walker_t *walker, __m128i pos)
+{
+    __m128i left = expand_pixel_32_1x128 (
+	(walker->left_ag << 8) | walker->left_rb);
+    __m128i right = expand_pixel_32_1x128 (
+	(walker->right_ag << 8) | walker->right_rb);
+    __m128i stepper = _mm_set1_epi32 (walker->stepper);
+    __m128i d02, d13, dist;
+
+    pos = _mm_sub_epi32 (pos, _mm_set1_epi32 (walker->left_x));
+
+    /* The distances are at most 256, so they fit in 16 bits */
+    d02 = _mm_srli_epi64 (_mm_mul_epu32 (pos, stepper), 16);
+    d13 = _mm_srli_epi64 (_mm_mul_epu32 (_mm_srli_epi64 (pos, 32), stepper), 16);
+    dist = _mm_unpacklo_epi32 (_mm_shuffle_epi32 (d02, _MM_SHUFFLE (3, 1, 2, 0)),
+			       _mm_shuffle_epi32 (d13, _MM_SHUFFLE (3, 1, 2, 0)));
+    dist = _mm_packs_epi32 (dist, dist);
+    dist = _mm_unpacklo_epi16 (dist, dist);
+
+    return _mm_packus_epi16 (
+	gradient_interpolate_1x128 (left, right, _mm_unpacklo_epi32 (dist, dist)),
+	gradient_interpolate_1x128 (left, right, _mm_unpackhi_epi32 (dist, dist)));
+}
+
+static uint32_t *
+sse2_linear_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    gradient_t *gradient = (gradient_t *)iter->image;
+    pixman_repeat_t repeat = gradient->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    pixman_gradient_walker_t walker;
+    pixman_fixed_32_32_t t;
+    double inc;
+    __m128d vinc;
+    __m128i vt;
+    int i;
+
+    /* Constant rows, and positions that don't fit in 32 bits, are
+     * left to the C code.
+     */
+    if (!_pixman_linear_gradient_get_affine (
+	    iter->image, iter->x, iter->y, &t, &inc)		||
+	(pixman_fixed_32_32_t)(inc * width) == 0		||
+	t < -0x40000000 || t > 0x40000000			||
+	!(fabs (inc) * width <= 0x40000000))
+    {
+	return _pixman_linear_gradient_get_scanline_narrow (iter, mask);
+    }
+
+    _pixman_gradient_walker_init (&walker, gradient, repeat);
+
+    vt = _mm_set1_epi32 ((int32_t)t);
+    vinc = _mm_set1_pd (inc);
+
+    for (i = 0; i + 4 <= width; i += 4)
+    {
+	__m128i pos = linear_positions_4x128 (vt, vinc, i);
+
+	if (gradient->lut)
+	{
+	    save_128_unaligned ((__m128i *)(buffer + i),
+				gradient_lut_4x128 (gradient->lut, repeat, pos));
+	}
+	else if (gradient_walker_contains_4x128 (&walker, pos))
+	{
+	    save_128_unaligned ((__m128i *)(buffer + i),
+				gradient_walker_4x128 (&walker, pos));
+	}
+	else
+	{
+	    int32_t p[4];
+	    int k;
+
+	    save_128_unaligned ((__m128i *)p, pos);
+
+	    for (k = 0; k < 4; ++k)
+		buffer[i + k] = _pixman_gradient_walker_pixel (&walker, p[k]);
+	}
+    }
+
+    for (; i < width; ++i)
+    {
+	pixman_fixed_32_32_t pos = t + (pixman_fixed_32_32_t)(inc * i);
+
+	if (gradient->lut)
+	    buffer[i] = gradient_lut_pixel (gradient->lut, repeat, pos);
+	else
+	    buffer[i] = _pixman_gradient_walker_pixel (&walker, pos);
+    }
+
+    iter->y++;
+
+    return iter->buffer;
+}
+
+static void
+sse2_linear_gradient_iter_init (pixman_iter_t *iter,
+				const pixman_iter_info_t *info)
+{
+    _pixman_linear_gradient_iter_init (iter->image, iter);
+
+    /* Horizontal gradients are computed once in the initializer */
+    if (iter->get_scanline == _pixman_linear_gradient_get_scanline_narrow)
+	iter->get_scanline = sse2_linear_get_scanline;
+}
+
+/* Radial gradients with a LUT, four pixels at a time with exactly the
+ * same operations as radial_lut_pixel() in pixman-radial-gradient.c.
+ */
+static force_inline __m128
+radial_is_valid_4x128 (const radial_affine_t *r, pixman_repeat_t repeat,
+		       __m128 t)
+{
+    if (repeat == PIXMAN_REPEAT_NONE)
+    {
+	return _mm_and_ps (_mm_cmpge_ps (t, _mm_setzero_ps ()),
+			   _mm_cmple_ps (t, _mm_set1_ps (1.f)));
+    }
+    else
+    {
+	return _mm_cmpge_ps (_mm_mul_ps (t, _mm_set1_ps (r->dr)),
+			     _mm_set1_ps (r->mindr));
+    }
+}
+
+static uint32_t *
+sse2_radial_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const uint32_t *lut = iter->image->gradient.lut;
+    pixman_repeat_t repeat = iter->image->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    __m128 k = _mm_set_ps (3, 2, 1, 0);
+    __m128 kk = _mm_set_ps (3, 1, 0, 0);
+    radial_affine_t r;
+    int i;
+
+    if (!_pixman_radial_gradient_get_affine (iter->image, iter->x, iter->y, &r))
+	return _pixman_radial_gradient_get_scanline_narrow (iter, mask);
+
+    for (i = 0; i < width; i += 4)
+    {
+	float b0, db, c0, dc, ddc;
+	__m128 b, c, t, valid;
+	__m128i colors;
+
+	radial_affine_next_group (&r, &b0, &db, &c0, &dc, &ddc);
+
+	b = _mm_add_ps (_mm_set1_ps (b0), _mm_mul_ps (k, _mm_set1_ps (db)));
+	c = _mm_add_ps (_mm_set1_ps (c0),
+			_mm_add_ps (_mm_mul_ps (k, _mm_set1_ps (dc)),
+				    _mm_mul_ps (kk, _mm_set1_ps (ddc))));
+
+	if (r.a == 0)
+	{
+	    t = _mm_div_ps (_mm_mul_ps (_mm_set1_ps (0.5f), c), b);
+	    valid = _mm_and_ps (_mm_cmpneq_ps (b, _mm_setzero_ps ()),
+				radial_is_valid_4x128 (&r, repeat, t));
+	}
+	else
+	{
+	    __m128 discr, sqrtdiscr, t1, valid0, valid1;
+
+	    discr = _mm_sub_ps (_mm_mul_ps (b, b),
+				_mm_mul_ps (_mm_set1_ps (r.a), c));
+	    valid = _mm_cmpge_ps (discr, _mm_setzero_ps ());
+	    sqrtdiscr = _mm_sqrt_ps (_mm_max_ps (discr, _mm_setzero_ps ()));
+
+	    t = _mm_mul_ps (_mm_add_ps (b, sqrtdiscr), _mm_set1_ps (r.inva));
+	    t1 = _mm_mul_ps (_mm_sub_ps (b, sqrtdiscr), _mm_set1_ps (r.inva));
+
+	    /* The bigger solution if it's valid, otherwise the other one */
+	    valid0 = _mm_and_ps (valid, radial_is_valid_4x128 (&r, repeat, t));
+	    valid1 = _mm_and_ps (valid, radial_is_valid_4x128 (&r, repeat, t1));
+	    t = _mm_or_ps (_mm_and_ps (valid0, t), _mm_andnot_ps (valid0, t1));
+	    valid = _mm_or_ps (valid0, valid1);
+	}
+
+	t = _mm_min_ps (_mm_max_ps (t, _mm_set1_ps (-16384.f)),
+			_mm_set1_ps (16384.f));
+	colors = gradient_lut_4x128 (
+	    lut, repeat, _mm_cvttps_epi32 (_mm_mul_ps (t, _mm_set1_ps (65536.f))));
+	colors = _mm_and_si128 (colors, _mm_castps_si128 (valid));
+
+	if (i + 4 <= width)
+	{
+	    save_128_unaligned ((__m128i *)(buffer + i), colors);
+	}
+	else
+	{
+	    uint32_t last[4];
+
+	    save_128_unaligned ((__m128i *)last, colors);
+	    memcpy (buffer + i, last, (width - i) * sizeof (uint32_t));
+	}
+    }
+
+    iter->y++;
+
+    return iter->buffer;
+}
+
+static void
+sse2_radial_gradient_iter_init (pixman_iter_t *iter,
+				const pixman_iter_info_t *info)
+{
+    _pixman_radial_gradient_iter_init (iter->image, iter);
+
+    /* Only the colors from the LUT are computed in single precision */
+    if (iter->image->gradient.lut)
+	iter->get_scanline = sse2_radial_get_scanline;
+}
+
+/* Conical gradients with a LUT, four pixels at a time with exactly the
+ * same operations as conical_lut_pixel() in pixman-conical-gradient.c.
+ */
+static force_inline __m128
+conical_atan2_4x128 (__m128 y, __m128 x)
+{
+    __m128 sign = _mm_set1_ps (-0.f);
+    __m128 ax = _mm_andnot_ps (sign, x);
+    __m128 ay = _mm_andnot_ps (sign, y);
+    __m128 mx = _mm_max_ps (ay, ax);
+    __m128 a, s, r, m;
+
+    a = _mm_and_ps (_mm_div_ps (_mm_min_ps (ay, ax), mx),
+		    _mm_cmpneq_ps (mx, _mm_setzero_ps ()));
+    s = _mm_mul_ps (a, a);
+
+    r = _mm_add_ps (_mm_set1_ps (CONICAL_ATAN_A7),
+		    _mm_mul_ps (s, _mm_set1_ps (CONICAL_ATAN_A9)));
+    r = _mm_add_ps (_mm_set1_ps (CONICAL_ATAN_A5), _mm_mul_ps (s, r));
+    r = _mm_add_ps (_mm_set1_ps (CONICAL_ATAN_A3), _mm_mul_ps (s, r));
+    r = _mm_add_ps (_mm_set1_ps (CONICAL_ATAN_A1), _mm_mul_ps (s, r));
+    r = _mm_mul_ps (a, r);
+
+    m = _mm_cmpgt_ps (ay, ax);
+    r = _mm_or_ps (_mm_andnot_ps (m, r),
+		   _mm_and_ps (m, _mm_sub_ps (_mm_set1_ps (0.25f), r)));
+    m = _mm_cmplt_ps (x, _mm_setzero_ps ());
+    r = _mm_or_ps (_mm_andnot_ps (m, r),
+		   _mm_and_ps (m, _mm_sub_ps (_mm_set1_ps (0.5f), r)));
+    m = _mm_cmplt_ps (y, _mm_setzero_ps ());
+
+    return _mm_xor_ps (r, _mm_and_ps (m, sign));
+}
+
+static uint32_t *
+sse2_conical_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const uint32_t *lut = iter->image->gradient.lut;
+    pixman_repeat_t repeat = iter->image->common.repeat;
+    uint32_t *buffer = iter->buffer;
+    int width = iter->width;
+    __m128 k = _mm_set_ps (3, 2, 1, 0);
+    __m128 one = _mm_set1_ps (1.f);
+    conical_affine_t r;
+    int i;
+
+    if (!_pixman_conical_gradient_get_affine (iter->image, iter->x, iter->y, &r))
+	return _pixman_conical_gradient_get_scanline_narrow (iter, mask);
+
+    for (i = 0; i < width; i += 4)
+    {
+	float x0, y0, dx, dy;
+	__m128 x, y, t;
+	__m128i colors;
+
+	conical_affine_next_group (&r, &x0, &y0, &dx, &dy);
+
+	x = _mm_add_ps (_mm_set1_ps (x0), _mm_mul_ps (k, _mm_set1_ps (dx)));
+	y = _mm_add_ps (_mm_set1_ps (y0), _mm_mul_ps (k, _mm_set1_ps (dy)));
+
+	t = _mm_add_ps (conical_atan2_4x128 (y, x), _mm_set1_ps (r.angle));
+	t = _mm_add_ps (t, _mm_and_ps (_mm_cmplt_ps (t, _mm_setzero_ps ()), one));
+	t = _mm_sub_ps (t, _mm_and_ps (_mm_cmpge_ps (t, one), one));
+
+	colors = gradient_lut_4x128 (
+	    lut, repeat, _mm_cvttps_epi32 (
+		_mm_mul_ps (_mm_sub_ps (one, t), _mm_set1_ps (65536.f))));
+
+	if (i + 4 <= width)
+	{
+	    save_128_unaligned ((__m128i *)(buffer + i), colors);
+	}
+	else
+	{
+	    uint32_t last[4];
+
+	    save_128_unaligned ((__m128i *)last, colors);
+	    memcpy (buffer + i, last, (width - i) * sizeof (uint32_t));
 	}
     }
 
-    return FALSE;
+    iter->y++;
+
+    return iter->buffer;
+}
+
+static void
+sse2_conical_gradient_iter_init (pixman_iter_t *iter,
+				 const pixman_iter_info_t *info)
+{
+    _pixman_conical_gradient_iter_init (iter->image, iter);
+
+    /* Only the colors from the LUT are computed in single precision */
+    if (iter->image->gradient.lut)
+	iter->get_scanline = sse2_conical_get_scanline;
 }
 
+static const pixman_iter_info_t sse2_iters[] =
+{
+    { PIXMAN_x8r8g8b8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, sse2_fetch_x8r8g8b8, NULL
+    },
+    { PIXMAN_r5g6b5, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, sse2_fetch_r5g6b5, NULL
+    },
+    { PIXMAN_a8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, sse2_fetch_a8, NULL
+    },
+    { PIXMAN_yuy2, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, sse2_fetch_yuv, NULL
+    },
+    { PIXMAN_yv12, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, sse2_fetch_yuv, NULL
+    },
+    { PIXMAN_i420, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, sse2_fetch_yuv, NULL
+    },
+    { PIXMAN_nv12, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      NULL, sse2_fetch_yuv, NULL
+    },
+    { PIXMAN_a16b16g16r16, WIDE_IMAGE_FLAGS, ITER_WIDE | ITER_SRC,
+      _pixman_iter_init_bits_stride, sse2_fetch_a16b16g16r16_float, NULL
+    },
+    { PIXMAN_x16b16g16r16, WIDE_IMAGE_FLAGS, ITER_WIDE | ITER_SRC,
+      _pixman_iter_init_bits_stride, sse2_fetch_x16b16g16r16_float, NULL
+    },
+    { PIXMAN_a16b16g16r16, WIDE_DEST_FLAGS, ITER_WIDE | ITER_DEST,
+      _pixman_iter_init_bits_stride,
+      sse2_dest_get_a16b16g16r16_float, sse2_write_back_a16b16g16r16_float
+    },
+    { PIXMAN_x16b16g16r16, WIDE_DEST_FLAGS, ITER_WIDE | ITER_DEST,
+      _pixman_iter_init_bits_stride,
+      sse2_dest_get_x16b16g16r16_float, sse2_write_back_x16b16g16r16_float
+    },
+    { PIXMAN_linear_gradient, 0, ITER_NARROW | ITER_SRC,
+      sse2_linear_gradient_iter_init, NULL, NULL
+    },
+    { PIXMAN_radial_gradient, 0, ITER_NARROW | ITER_SRC,
+      sse2_radial_gradient_iter_init, NULL, NULL
+    },
+    { PIXMAN_conical_gradient, 0, ITER_NARROW | ITER_SRC,
+      sse2_conical_gradient_iter_init, NULL, NULL
+    },
+    { PIXMAN_any, FAST_PATH_SEPARABLE_SCALE_FLAGS, ITER_NARROW | ITER_SRC,
+      sse2_separable_scaler_init, NULL, NULL
+    },
+    { PIXMAN_null },
+};
+
 #if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
 __attribute__((__force_align_arg_pointer__))
 #endif
@@ -6103,6 +8168,8 @@ _pixman_implementation_create_sse2 (pixman_implementation_t *fallback)
 {
     pixman_implementation_t *imp = _pixman_implementation_create (fallback, sse2_fast_paths);
 
+    imp->name = "sse2";
+
     /* SSE2 constants */
     mask_565_r  = create_mask_2x32_128 (0x00f80000, 0x00f80000);
     mask_565_g1 = create_mask_2x32_128 (0x00070000, 0x00070000);
@@ -6121,6 +8188,9 @@ _pixman_implementation_create_sse2 (pixman_implementation_t *fallback)
     mask_alpha = create_mask_2x32_128 (0x00ff0000, 0x00000000);
     mask_565_rb = create_mask_2x32_128 (0x00f800f8, 0x00f800f8);
     mask_565_pack_multiplier = create_mask_2x32_128 (0x20000004, 0x20000004);
+    mask_0001 = create_mask_16_128 (0x0001);
+    mask_dither_565_scale = create_mask_2x32_128 (0x0000001f, 0x003f001f);
+    mask_dither_565_shift = create_mask_2x32_128 (0x00000008, 0x00040008);
 
     /* Set up function pointers */
     imp->combine_32[PIXMAN_OP_OVER] = sse2_combine_over_u;
@@ -6148,10 +8218,105 @@ _pixman_implementation_create_sse2 (pixman_implementation_t *fallback)
     imp->combine_32_ca[PIXMAN_OP_XOR] = sse2_combine_xor_ca;
     imp->combine_32_ca[PIXMAN_OP_ADD] = sse2_combine_add_ca;
 
+    imp->combine_float[PIXMAN_OP_CLEAR] = sse2_combine_clear_u_float;
+    imp->combine_float[PIXMAN_OP_SRC] = sse2_combine_src_u_float;
+    imp->combine_float[PIXMAN_OP_DST] = sse2_combine_dst_u_float;
+    imp->combine_float[PIXMAN_OP_OVER] = sse2_combine_over_u_float;
+    imp->combine_float[PIXMAN_OP_OVER_REVERSE] = sse2_combine_over_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_IN] = sse2_combine_in_u_float;
+    imp->combine_float[PIXMAN_OP_IN_REVERSE] = sse2_combine_in_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_OUT] = sse2_combine_out_u_float;
+    imp->combine_float[PIXMAN_OP_OUT_REVERSE] = sse2_combine_out_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_ATOP] = sse2_combine_atop_u_float;
+    imp->combine_float[PIXMAN_OP_ATOP_REVERSE] = sse2_combine_atop_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_XOR] = sse2_combine_xor_u_float;
+    imp->combine_float[PIXMAN_OP_ADD] = sse2_combine_add_u_float;
+    imp->combine_float[PIXMAN_OP_SATURATE] = sse2_combine_saturate_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_CLEAR] = sse2_combine_disjoint_clear_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_SRC] = sse2_combine_disjoint_src_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_DST] = sse2_combine_disjoint_dst_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OVER] = sse2_combine_disjoint_over_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OVER_REVERSE] = sse2_combine_disjoint_over_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_IN] = sse2_combine_disjoint_in_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_IN_REVERSE] = sse2_combine_disjoint_in_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OUT] = sse2_combine_disjoint_out_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_OUT_REVERSE] = sse2_combine_disjoint_out_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_ATOP] = sse2_combine_disjoint_atop_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_ATOP_REVERSE] = sse2_combine_disjoint_atop_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_DISJOINT_XOR] = sse2_combine_disjoint_xor_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_CLEAR] = sse2_combine_conjoint_clear_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_SRC] = sse2_combine_conjoint_src_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_DST] = sse2_combine_conjoint_dst_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OVER] = sse2_combine_conjoint_over_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OVER_REVERSE] = sse2_combine_conjoint_over_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_IN] = sse2_combine_conjoint_in_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_IN_REVERSE] = sse2_combine_conjoint_in_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OUT] = sse2_combine_conjoint_out_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_OUT_REVERSE] = sse2_combine_conjoint_out_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_ATOP] = sse2_combine_conjoint_atop_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_ATOP_REVERSE] = sse2_combine_conjoint_atop_reverse_u_float;
+    imp->combine_float[PIXMAN_OP_CONJOINT_XOR] = sse2_combine_conjoint_xor_u_float;
+    imp->combine_float[PIXMAN_OP_MULTIPLY] = sse2_combine_multiply_u_float;
+    imp->combine_float[PIXMAN_OP_SCREEN] = sse2_combine_screen_u_float;
+    imp->combine_float[PIXMAN_OP_OVERLAY] = sse2_combine_overlay_u_float;
+    imp->combine_float[PIXMAN_OP_DARKEN] = sse2_combine_darken_u_float;
+    imp->combine_float[PIXMAN_OP_LIGHTEN] = sse2_combine_lighten_u_float;
+    imp->combine_float[PIXMAN_OP_HARD_LIGHT] = sse2_combine_hard_light_u_float;
+    imp->combine_float[PIXMAN_OP_DIFFERENCE] = sse2_combine_difference_u_float;
+    imp->combine_float[PIXMAN_OP_EXCLUSION] = sse2_combine_exclusion_u_float;
+
+    imp->combine_float_ca[PIXMAN_OP_CLEAR] = sse2_combine_clear_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_SRC] = sse2_combine_src_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DST] = sse2_combine_dst_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OVER] = sse2_combine_over_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OVER_REVERSE] = sse2_combine_over_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_IN] = sse2_combine_in_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_IN_REVERSE] = sse2_combine_in_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OUT] = sse2_combine_out_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OUT_REVERSE] = sse2_combine_out_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_ATOP] = sse2_combine_atop_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_ATOP_REVERSE] = sse2_combine_atop_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_XOR] = sse2_combine_xor_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_ADD] = sse2_combine_add_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_SATURATE] = sse2_combine_saturate_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_CLEAR] = sse2_combine_disjoint_clear_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_SRC] = sse2_combine_disjoint_src_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_DST] = sse2_combine_disjoint_dst_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OVER] = sse2_combine_disjoint_over_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OVER_REVERSE] = sse2_combine_disjoint_over_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_IN] = sse2_combine_disjoint_in_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_IN_REVERSE] = sse2_combine_disjoint_in_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OUT] = sse2_combine_disjoint_out_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_OUT_REVERSE] = sse2_combine_disjoint_out_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_ATOP] = sse2_combine_disjoint_atop_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_ATOP_REVERSE] = sse2_combine_disjoint_atop_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DISJOINT_XOR] = sse2_combine_disjoint_xor_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_CLEAR] = sse2_combine_conjoint_clear_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_SRC] = sse2_combine_conjoint_src_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_DST] = sse2_combine_conjoint_dst_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OVER] = sse2_combine_conjoint_over_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OVER_REVERSE] = sse2_combine_conjoint_over_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_IN] = sse2_combine_conjoint_in_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_IN_REVERSE] = sse2_combine_conjoint_in_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OUT] = sse2_combine_conjoint_out_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_OUT_REVERSE] = sse2_combine_conjoint_out_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_ATOP] = sse2_combine_conjoint_atop_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_ATOP_REVERSE] = sse2_combine_conjoint_atop_reverse_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_CONJOINT_XOR] = sse2_combine_conjoint_xor_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_MULTIPLY] = sse2_combine_multiply_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_SCREEN] = sse2_combine_screen_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_OVERLAY] = sse2_combine_overlay_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DARKEN] = sse2_combine_darken_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_LIGHTEN] = sse2_combine_lighten_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_HARD_LIGHT] = sse2_combine_hard_light_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_DIFFERENCE] = sse2_combine_difference_ca_float;
+    imp->combine_float_ca[PIXMAN_OP_EXCLUSION] = sse2_combine_exclusion_ca_float;
+
     imp->blt = sse2_blt;
     imp->fill = sse2_fill;
+    imp->glyphs = sse2_glyphs;
 
-    imp->src_iter_init = sse2_src_iter_init;
+    imp->iter_info = sse2_iters;
 
     return imp;
 }
@@ -0,0 +1,652 @@
+/*
+ * Copyright © 2008 Rodrigo Kumpera
+ * Copyright © 2008 André Tupinambá
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of Red Hat not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  Red Hat makes no representations about the
+ * suitability of this software for any purpose.  It is provided "as is"
+ * without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN
+ * AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING
+ * OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+ * SOFTWARE.
+ *
+ * Based on pixman-sse2.c. This file only contains the operations that
+ * benefit from pshufb, palignr and pmaddubsw; everything else is left
+ * to the SSE2 implementation below it.
+ */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <tmmintrin.h> /* for SSSE3 intrinsics */
+#include "pixman-private.h"
+#include "pixman-combine32.h"
+#include "pixman-inlines.h"
+
+/* Swaps the red and blue channels of a8r8g8b8 <-> a8b8g8r8 */
+static __m128i mask_swap_rb;
+/* Unpacks four r8g8b8 pixels (12 bytes) into four 32 bit pixels */
+static __m128i mask_unpack_0888;
+/* As mask_unpack_0888, but also swaps the red and blue channels */
+static __m128i mask_unpack_0888_rev;
+/* Interleaves the left and right pixels of a 2x1 block for pmaddwd */
+static __m128i mask_interleave_lr;
+
+static __m128i mask_ff000000;
+static __m128i mask_565_r;
+static __m128i mask_565_g;
+static __m128i mask_565_mul_rb;
+static __m128i mask_565_mul_g;
+static __m128i mask_ff00;
+
+static force_inline uint32_t
+swap_rb_pixel (uint32_t s)
+{
+    return (s & 0xff00ff00) | ((s >> 16) & 0xff) | ((s & 0xff) << 16);
+}
+
+static force_inline uint32_t
+fetch_0888_pixel (const uint8_t *s)
+{
+    return s[0] | (s[1] << 8) | (s[2] << 16);
+}
+
+static force_inline uint32_t
+fetch_0888_rev_pixel (const uint8_t *s)
+{
+    return s[2] | (s[1] << 8) | (s[0] << 16);
+}
+
+/* Copies a scanline of 32 bpp pixels, swapping the red and blue
+ * channels and or-ing in @alpha.
+ */
+static force_inline void
+ssse3_swizzle_8888 (uint32_t *       dst,
+		    const uint32_t * src,
+		    int              w,
+		    uint32_t         alpha)
+{
+    __m128i xmm_alpha = _mm_set1_epi32 (alpha);
+
+    while (w && ((uintptr_t)dst & 15))
+    {
+	*dst++ = swap_rb_pixel (*src++) | alpha;
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m128i s0 = _mm_loadu_si128 ((__m128i *)(src + 0));
+	__m128i s1 = _mm_loadu_si128 ((__m128i *)(src + 4));
+
+	s0 = _mm_or_si128 (_mm_shuffle_epi8 (s0, mask_swap_rb), xmm_alpha);
+	s1 = _mm_or_si128 (_mm_shuffle_epi8 (s1, mask_swap_rb), xmm_alpha);
+
+	_mm_store_si128 ((__m128i *)(dst + 0), s0);
+	_mm_store_si128 ((__m128i *)(dst + 4), s1);
+
+	dst += 8;
+	src += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	*dst++ = swap_rb_pixel (*src++) | alpha;
+	w--;
+    }
+}
+
+/* Expands a scanline of 24 bpp pixels to 32 bpp with an opaque alpha.
+ * If @rev is set the red and blue channels are swapped on the way.
+ */
+static force_inline void
+ssse3_unpack_0888_8888 (uint32_t *      dst,
+			const uint8_t * src,
+			int             w,
+			pixman_bool_t   rev)
+{
+    __m128i shuffle = rev ? mask_unpack_0888_rev : mask_unpack_0888;
+
+    while (w && ((uintptr_t)dst & 15))
+    {
+	*dst++ = 0xff000000 |
+	    (rev ? fetch_0888_rev_pixel (src) : fetch_0888_pixel (src));
+	src += 3;
+	w--;
+    }
+
+    while (w >= 16)
+    {
+	__m128i s0 = _mm_loadu_si128 ((__m128i *)(src + 0));
+	__m128i s1 = _mm_loadu_si128 ((__m128i *)(src + 16));
+	__m128i s2 = _mm_loadu_si128 ((__m128i *)(src + 32));
+	__m128i p0, p1, p2, p3;
+
+	/* pixel 4n starts at byte 12n */
+	p0 = s0;
+	p1 = _mm_alignr_epi8 (s1, s0, 12);
+	p2 = _mm_alignr_epi8 (s2, s1, 8);
+	p3 = _mm_srli_si128 (s2, 4);
+
+	p0 = _mm_or_si128 (_mm_shuffle_epi8 (p0, shuffle), mask_ff000000);
+	p1 = _mm_or_si128 (_mm_shuffle_epi8 (p1, shuffle), mask_ff000000);
+	p2 = _mm_or_si128 (_mm_shuffle_epi8 (p2, shuffle), mask_ff000000);
+	p3 = _mm_or_si128 (_mm_shuffle_epi8 (p3, shuffle), mask_ff000000);
+
+	_mm_store_si128 ((__m128i *)(dst + 0), p0);
+	_mm_store_si128 ((__m128i *)(dst + 4), p1);
+	_mm_store_si128 ((__m128i *)(dst + 8), p2);
+	_mm_store_si128 ((__m128i *)(dst + 12), p3);
+
+	dst += 16;
+	src += 48;
+	w -= 16;
+    }
+
+    while (w)
+    {
+	*dst++ = 0xff000000 |
+	    (rev ? fetch_0888_rev_pixel (src) : fetch_0888_pixel (src));
+	src += 3;
+	w--;
+    }
+}
+
+/* Expands eight r5g6b5 pixels to a8r8g8b8. Each channel is widened with
+ * a single high multiply, using (x << 3) | (x >> 2) == (x * 33) >> 2 for
+ * five bit values and (x << 2) | (x >> 4) == (x * 65) >> 4 for six bits,
+ * which matches convert_0565_to_8888() exactly.
+ */
+static force_inline void
+unpack_565_to_8888_2x128 (__m128i s, __m128i *lo, __m128i *hi)
+{
+    __m128i r, g, b, gb, ar;
+
+    r = _mm_mulhi_epu16 (_mm_and_si128 (s, mask_565_r), mask_565_mul_rb);
+    g = _mm_mulhi_epu16 (_mm_and_si128 (s, mask_565_g), mask_565_mul_g);
+    b = _mm_mulhi_epu16 (_mm_slli_epi16 (s, 11), mask_565_mul_rb);
+
+    gb = _mm_or_si128 (_mm_slli_epi16 (g, 8), b);
+    ar = _mm_or_si128 (r, mask_ff00);
+
+    *lo = _mm_unpacklo_epi16 (gb, ar);
+    *hi = _mm_unpackhi_epi16 (gb, ar);
+}
+
+/*
+ * Composite functions
+ */
+
+static void
+ssse3_composite_src_swap_8888 (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *src_line;
+    int dst_stride, src_stride;
+    uint32_t alpha;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    /* x888 sources need their alpha filled in when the destination has one */
+    if (PIXMAN_FORMAT_A (src_image->bits.format) == 0 &&
+	PIXMAN_FORMAT_A (dest_image->bits.format) != 0)
+	alpha = 0xff000000;
+    else
+	alpha = 0;
+
+    while (height--)
+    {
+	ssse3_swizzle_8888 (dst_line, src_line, width, alpha);
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+static void
+ssse3_composite_src_0888_8888 (pixman_implementation_t *imp,
+			       pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line;
+    uint8_t     *src_line;
+    int dst_stride, src_stride;
+    pixman_bool_t rev;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint8_t, src_stride, src_line, 3);
+
+    /* r8g8b8 -> a8r8g8b8 and b8g8r8 -> a8b8g8r8 keep the byte order */
+    rev = PIXMAN_FORMAT_TYPE (src_image->bits.format) !=
+	PIXMAN_FORMAT_TYPE (dest_image->bits.format);
+
+    while (height--)
+    {
+	ssse3_unpack_0888_8888 (dst_line, src_line, width, rev);
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+    }
+}
+
+/*
+ * Bilinear scaling
+ *
+ * The vertical pass uses pmaddubsw on interleaved top and bottom bytes,
+ * which needs both weights to fit in a signed byte, and the horizontal
+ * pass pairs up the left and right channels with a single pshufb. The
+ * arithmetic is otherwise that of the SSE2 scanlines, so the results are
+ * identical.
+ */
+
+#if BILINEAR_INTERPOLATION_BITS < 8
+
+#define BMSK ((1 << BILINEAR_INTERPOLATION_BITS) - 1)
+
+#define BILINEAR_DECLARE_VARIABLES						\
+    const __m128i xmm_wtb = _mm_set1_epi16 ((int16_t)((wb << 8) | wt));	\
+    const __m128i xmm_xorc7 = _mm_set_epi16 (0, BMSK, 0, BMSK, 0, BMSK, 0, BMSK);\
+    const __m128i xmm_addc7 = _mm_set_epi16 (0, 1, 0, 1, 0, 1, 0, 1);		\
+    const __m128i xmm_ux = _mm_set1_epi16 ((int16_t)unit_x);			\
+    __m128i xmm_x = _mm_set1_epi16 ((int16_t)vx)
+
+/* Leaves the unpacked, unshifted result in @a */
+#define BILINEAR_INTERPOLATE_ONE_PIXEL_32(a)					\
+do {										\
+    __m128i xmm_wh;								\
+    /* fetch 2x2 pixel block into sse registers */				\
+    __m128i tltr = _mm_loadl_epi64 (						\
+			    (__m128i *)&src_top[pixman_fixed_to_int (vx)]);	\
+    __m128i blbr = _mm_loadl_epi64 (						\
+			    (__m128i *)&src_bottom[pixman_fixed_to_int (vx)]);	\
+    vx += unit_x;								\
+    /* vertical interpolation */						\
+    a = _mm_maddubs_epi16 (_mm_unpacklo_epi8 (tltr, blbr), xmm_wtb);		\
+    /* calculate horizontal weights */						\
+    xmm_wh = _mm_add_epi16 (xmm_addc7, _mm_xor_si128 (xmm_xorc7,		\
+		_mm_srli_epi16 (xmm_x, 16 - BILINEAR_INTERPOLATION_BITS)));	\
+    xmm_x = _mm_add_epi16 (xmm_x, xmm_ux);					\
+    /* horizontal interpolation */						\
+    a = _mm_madd_epi16 (_mm_shuffle_epi8 (a, mask_interleave_lr), xmm_wh);	\
+    a = _mm_srli_epi32 (a, BILINEAR_INTERPOLATION_BITS * 2);			\
+} while (0)
+
+#define BILINEAR_INTERPOLATE_ONE_PIXEL(pix)					\
+do {										\
+    __m128i a;									\
+    BILINEAR_INTERPOLATE_ONE_PIXEL_32 (a);					\
+    a = _mm_packs_epi32 (a, a);							\
+    a = _mm_packus_epi16 (a, a);						\
+    pix = _mm_cvtsi128_si32 (a);						\
+} while (0)
+
+#define BILINEAR_INTERPOLATE_FOUR_PIXELS(pix)					\
+do {										\
+    __m128i a0, a1, a2, a3;							\
+    BILINEAR_INTERPOLATE_ONE_PIXEL_32 (a0);					\
+    BILINEAR_INTERPOLATE_ONE_PIXEL_32 (a1);					\
+    BILINEAR_INTERPOLATE_ONE_PIXEL_32 (a2);					\
+    BILINEAR_INTERPOLATE_ONE_PIXEL_32 (a3);					\
+    pix = _mm_packus_epi16 (_mm_packs_epi32 (a0, a1),				\
+			    _mm_packs_epi32 (a2, a3));				\
+} while (0)
+
+static force_inline void
+scaled_bilinear_scanline_ssse3_8888_8888_SRC (uint32_t *       dst,
+					      const uint32_t * mask,
+					      const uint32_t * src_top,
+					      const uint32_t * src_bottom,
+					      int32_t          w,
+					      int              wt,
+					      int              wb,
+					      pixman_fixed_t   vx,
+					      pixman_fixed_t   unit_x,
+					      pixman_fixed_t   max_vx,
+					      pixman_bool_t    zero_src)
+{
+    BILINEAR_DECLARE_VARIABLES;
+    __m128i pix4;
+    uint32_t pix;
+
+    while (w >= 4)
+    {
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (pix4);
+	_mm_storeu_si128 ((__m128i *)dst, pix4);
+
+	dst += 4;
+	w -= 4;
+    }
+
+    while (w)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix);
+	*dst++ = pix;
+	w--;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_cover_SRC,
+			       scaled_bilinear_scanline_ssse3_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_pad_SRC,
+			       scaled_bilinear_scanline_ssse3_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_none_SRC,
+			       scaled_bilinear_scanline_ssse3_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_normal_SRC,
+			       scaled_bilinear_scanline_ssse3_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+static force_inline uint32_t
+ssse3_over_pixel (uint32_t src, uint32_t dst)
+{
+    uint32_t ia = ~src >> 24;
+
+    if (ia == 0)
+	return src;
+    else if (src)
+	UN8x4_MUL_UN8_ADD_UN8x4 (dst, ia, src);
+
+    return dst;
+}
+
+static force_inline void
+scaled_bilinear_scanline_ssse3_8888_8888_OVER (uint32_t *       dst,
+					       const uint32_t * mask,
+					       const uint32_t * src_top,
+					       const uint32_t * src_bottom,
+					       int32_t          w,
+					       int              wt,
+					       int              wb,
+					       pixman_fixed_t   vx,
+					       pixman_fixed_t   unit_x,
+					       pixman_fixed_t   max_vx,
+					       pixman_bool_t    zero_src)
+{
+    BILINEAR_DECLARE_VARIABLES;
+    const __m128i xmm_00ff = _mm_set1_epi16 (0x00ff);
+    const __m128i xmm_0080 = _mm_set1_epi16 (0x0080);
+    const __m128i xmm_0101 = _mm_set1_epi16 (0x0101);
+    const __m128i xmm_alpha_shuffle = _mm_set_epi8 (
+	-1, 15, -1, 15, -1, 15, -1, 15, -1, 11, -1, 11, -1, 11, -1, 11);
+    const __m128i xmm_alpha_shuffle_lo = _mm_set_epi8 (
+	-1, 7, -1, 7, -1, 7, -1, 7, -1, 3, -1, 3, -1, 3, -1, 3);
+    __m128i xmm_src;
+    uint32_t pix;
+
+    while (w >= 4)
+    {
+	BILINEAR_INTERPOLATE_FOUR_PIXELS (xmm_src);
+
+	if (_mm_movemask_epi8 (
+		_mm_cmpeq_epi8 (xmm_src, _mm_setzero_si128 ())) != 0xffff)
+	{
+	    if ((_mm_movemask_epi8 (
+		     _mm_cmpeq_epi8 (xmm_src, mask_ff000000)) & 0x8888) == 0x8888)
+	    {
+		_mm_storeu_si128 ((__m128i *)dst, xmm_src);
+	    }
+	    else
+	    {
+		__m128i d = _mm_loadu_si128 ((__m128i *)dst);
+		__m128i d_lo = _mm_unpacklo_epi8 (d, _mm_setzero_si128 ());
+		__m128i d_hi = _mm_unpackhi_epi8 (d, _mm_setzero_si128 ());
+		/* pshufb spreads each alpha byte over its pixel's channels */
+		__m128i a_lo = _mm_xor_si128 (
+		    _mm_shuffle_epi8 (xmm_src, xmm_alpha_shuffle_lo), xmm_00ff);
+		__m128i a_hi = _mm_xor_si128 (
+		    _mm_shuffle_epi8 (xmm_src, xmm_alpha_shuffle), xmm_00ff);
+
+		d_lo = _mm_mulhi_epu16 (_mm_adds_epu16 (
+		    _mm_mullo_epi16 (d_lo, a_lo), xmm_0080), xmm_0101);
+		d_hi = _mm_mulhi_epu16 (_mm_adds_epu16 (
+		    _mm_mullo_epi16 (d_hi, a_hi), xmm_0080), xmm_0101);
+
+		_mm_storeu_si128 ((__m128i *)dst, _mm_adds_epu8 (
+		    xmm_src, _mm_packus_epi16 (d_lo, d_hi)));
+	    }
+	}
+
+	dst += 4;
+	w -= 4;
+    }
+
+    while (w)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix);
+
+	if (pix)
+	    *dst = ssse3_over_pixel (pix, *dst);
+
+	dst++;
+	w--;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_cover_OVER,
+			       scaled_bilinear_scanline_ssse3_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_pad_OVER,
+			       scaled_bilinear_scanline_ssse3_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_none_OVER,
+			       scaled_bilinear_scanline_ssse3_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (ssse3_8888_8888_normal_OVER,
+			       scaled_bilinear_scanline_ssse3_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+#endif /* BILINEAR_INTERPOLATION_BITS < 8 */
+
+static const pixman_fast_path_t ssse3_fast_paths[] =
+{
+    /* PIXMAN_OP_SRC */
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, a8b8g8r8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, x8b8g8r8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, a8b8g8r8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, x8b8g8r8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, a8r8g8b8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, x8r8g8b8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, a8r8g8b8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, x8r8g8b8, ssse3_composite_src_swap_8888),
+    PIXMAN_STD_FAST_PATH (SRC, r8g8b8, null, a8r8g8b8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, r8g8b8, null, x8r8g8b8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, r8g8b8, null, a8b8g8r8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, r8g8b8, null, x8b8g8r8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, b8g8r8, null, a8r8g8b8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, b8g8r8, null, x8r8g8b8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, b8g8r8, null, a8b8g8r8, ssse3_composite_src_0888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, b8g8r8, null, x8b8g8r8, ssse3_composite_src_0888_8888),
+
+#if BILINEAR_INTERPOLATION_BITS < 8
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, ssse3_8888_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, ssse3_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, ssse3_8888_8888),
+#endif
+
+    { PIXMAN_OP_NONE },
+};
+
+/*
+ * Iterators
+ */
+
+static uint32_t *
+ssse3_fetch_a8b8g8r8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    uint32_t *src = (uint32_t *)iter->bits;
+
+    iter->bits += iter->stride;
+
+    ssse3_swizzle_8888 (iter->buffer, src, iter->width, 0);
+
+    return iter->buffer;
+}
+
+static uint32_t *
+ssse3_fetch_x8b8g8r8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    uint32_t *src = (uint32_t *)iter->bits;
+
+    iter->bits += iter->stride;
+
+    ssse3_swizzle_8888 (iter->buffer, src, iter->width, 0xff000000);
+
+    return iter->buffer;
+}
+
+static uint32_t *
+ssse3_fetch_r8g8b8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    uint8_t *src = iter->bits;
+
+    iter->bits += iter->stride;
+
+    ssse3_unpack_0888_8888 (iter->buffer, src, iter->width, FALSE);
+
+    return iter->buffer;
+}
+
+static uint32_t *
+ssse3_fetch_b8g8r8 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    uint8_t *src = iter->bits;
+
+    iter->bits += iter->stride;
+
+    ssse3_unpack_0888_8888 (iter->buffer, src, iter->width, TRUE);
+
+    return iter->buffer;
+}
+
+static uint32_t *
+ssse3_fetch_r5g6b5 (pixman_iter_t *iter, const uint32_t *mask)
+{
+    int w = iter->width;
+    uint32_t *dst = iter->buffer;
+    uint16_t *src = (uint16_t *)iter->bits;
+
+    iter->bits += iter->stride;
+
+    while (w && ((uintptr_t)dst) & 15)
+    {
+	uint16_t s = *src++;
+
+	*dst++ = convert_0565_to_8888 (s);
+	w--;
+    }
+
+    while (w >= 8)
+    {
+	__m128i lo, hi;
+
+	unpack_565_to_8888_2x128 (_mm_loadu_si128 ((__m128i *)src), &lo, &hi);
+
+	_mm_store_si128 ((__m128i *)(dst + 0), lo);
+	_mm_store_si128 ((__m128i *)(dst + 4), hi);
+
+	dst += 8;
+	src += 8;
+	w -= 8;
+    }
+
+    while (w)
+    {
+	uint16_t s = *src++;
+
+	*dst++ = convert_0565_to_8888 (s);
+	w--;
+    }
+
+    return iter->buffer;
+}
+
+#define IMAGE_FLAGS							\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_ID_TRANSFORM |		\
+     FAST_PATH_BITS_IMAGE | FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
+
+static const pixman_iter_info_t ssse3_iters[] =
+{
+    { PIXMAN_a8b8g8r8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, ssse3_fetch_a8b8g8r8, NULL
+    },
+    { PIXMAN_x8b8g8r8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, ssse3_fetch_x8b8g8r8, NULL
+    },
+    { PIXMAN_r8g8b8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, ssse3_fetch_r8g8b8, NULL
+    },
+    { PIXMAN_b8g8r8, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, ssse3_fetch_b8g8r8, NULL
+    },
+    { PIXMAN_r5g6b5, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,
+      _pixman_iter_init_bits_stride, ssse3_fetch_r5g6b5, NULL
+    },
+    { PIXMAN_null },
+};
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+pixman_implementation_t *
+_pixman_implementation_create_ssse3 (pixman_implementation_t *fallback)
+{
+    pixman_implementation_t *imp = _pixman_implementation_create (fallback, ssse3_fast_paths);
+
+    imp->name = "ssse3";
+
+    /* SSSE3 constants */
+    mask_swap_rb = _mm_set_epi8 (15, 12, 13, 14, 11, 8, 9, 10,
+				 7, 4, 5, 6, 3, 0, 1, 2);
+    mask_unpack_0888 = _mm_set_epi8 (-1, 11, 10, 9, -1, 8, 7, 6,
+				     -1, 5, 4, 3, -1, 2, 1, 0);
+    mask_unpack_0888_rev = _mm_set_epi8 (-1, 9, 10, 11, -1, 6, 7, 8,
+					 -1, 3, 4, 5, -1, 0, 1, 2);
+    mask_interleave_lr = _mm_set_epi8 (15, 14, 7, 6, 13, 12, 5, 4,
+				       11, 10, 3, 2, 9, 8, 1, 0);
+    mask_ff000000 = _mm_set1_epi32 (0xff000000);
+    mask_565_r = _mm_set1_epi16 ((int16_t)0xf800);
+    mask_565_g = _mm_set1_epi16 (0x07e0);
+    mask_565_mul_rb = _mm_set1_epi16 (33 << 3);
+    mask_565_mul_g = _mm_set1_epi16 (65 << 7);
+    mask_ff00 = _mm_set1_epi16 ((int16_t)0xff00);
+
+    imp->iter_info = ssse3_iters;
+
+    return imp;
+}
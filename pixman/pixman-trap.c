@@ -709,3 +709,518 @@ pixman_add_triangles (pixman_image_t          *image,
 	free (traps);
     }
 }
+
+/*
+ * Polygons are rasterized a pixel row at a time. The edges that cross
+ * the row are kept in an active edge table, and each of them adds the
+ * signed height and area it covers to the cells of the pixels it goes
+ * through. Sweeping the cells of the row from left to right then gives
+ * the exact area coverage of every pixel, and the spans between cells
+ * are covered by the winding of the edges to their left.
+ *
+ * Coordinates are in 24.8 fixed point, so the area of a pixel is 256 x
+ * 256, and cells hold twice the area like they do in FreeType.
+ */
+#define POLY_SHIFT	8
+#define POLY_ONE	(1 << POLY_SHIFT)
+#define POLY_FULL	(POLY_ONE * POLY_ONE * 2)
+
+#define N_STACK_CELLS	256
+
+typedef struct
+{
+    int32_t	x1, y1;
+    int32_t	x2, y2;
+    int		dir;
+} poly_edge_t;
+
+typedef struct
+{
+    int		x;
+    int		cover;
+    int		area;
+} poly_cell_t;
+
+typedef struct
+{
+    poly_cell_t *	cells;
+    int			n_cells;
+    int			size;
+    pixman_bool_t	failed;
+    poly_cell_t		stack_cells[N_STACK_CELLS];
+} poly_row_t;
+
+static int
+compare_poly_edges (const void *a, const void *b)
+{
+    const poly_edge_t *ea = a, *eb = b;
+
+    return (ea->y1 > eb->y1) - (ea->y1 < eb->y1);
+}
+
+static int
+compare_poly_cells (const void *a, const void *b)
+{
+    const poly_cell_t *ca = a, *cb = b;
+
+    return (ca->x > cb->x) - (ca->x < cb->x);
+}
+
+static force_inline int32_t
+poly_coord (pixman_fixed_t v)
+{
+    return (int32_t)(((int64_t)v + (1 << (15 - POLY_SHIFT))) >> (16 - POLY_SHIFT));
+}
+
+static void
+add_cell (poly_row_t *row, int x, int cover, int area)
+{
+    poly_cell_t *cell;
+
+    /* An edge goes through its cells in order */
+    if (row->n_cells && row->cells[row->n_cells - 1].x == x)
+    {
+	cell = &row->cells[row->n_cells - 1];
+	cell->cover += cover;
+	cell->area += area;
+	return;
+    }
+
+    if (row->n_cells == row->size)
+    {
+	poly_cell_t *cells = pixman_malloc_ab (row->size * 2, sizeof (poly_cell_t));
+
+	if (!cells)
+	{
+	    row->failed = TRUE;
+	    return;
+	}
+
+	memcpy (cells, row->cells, row->n_cells * sizeof (poly_cell_t));
+	if (row->cells != row->stack_cells)
+	    free (row->cells);
+
+	row->cells = cells;
+	row->size *= 2;
+    }
+
+    cell = &row->cells[row->n_cells++];
+    cell->x = x;
+    cell->cover = cover;
+    cell->area = area;
+}
+
+static force_inline void
+floor_div_mod (int a, int b, int *q, int *r)
+{
+    *q = a / b;
+    *r = a % b;
+
+    if (*r < 0)
+    {
+	*q -= 1;
+	*r += b;
+    }
+}
+
+/* Add a segment that lies within one pixel row, with y relative to the
+ * top of the row.
+ */
+static void
+render_segment (poly_row_t *row, int32_t x1, int y1, int32_t x2, int y2)
+{
+    int ex1 = x1 >> POLY_SHIFT, ex2 = x2 >> POLY_SHIFT;
+    int fx1 = x1 & (POLY_ONE - 1), fx2 = x2 & (POLY_ONE - 1);
+    int dx, dy, first, incr, delta, mod, lift, rem;
+
+    dy = y2 - y1;
+    if (dy == 0)
+	return;
+
+    if (ex1 == ex2)
+    {
+	add_cell (row, ex1, dy, (fx1 + fx2) * dy);
+	return;
+    }
+
+    /* Split the segment where it crosses the pixel columns */
+    dx = x2 - x1;
+    if (dx > 0)
+    {
+	floor_div_mod ((POLY_ONE - fx1) * dy, dx, &delta, &mod);
+	first = POLY_ONE;
+	incr = 1;
+    }
+    else
+    {
+	dx = -dx;
+	floor_div_mod (fx1 * dy, dx, &delta, &mod);
+	first = 0;
+	incr = -1;
+    }
+
+    add_cell (row, ex1, delta, (fx1 + first) * delta);
+    y1 += delta;
+    ex1 += incr;
+
+    if (ex1 != ex2)
+    {
+	floor_div_mod (POLY_ONE * dy, dx, &lift, &rem);
+	mod -= dx;
+
+	do
+	{
+	    delta = lift;
+	    mod += rem;
+	    if (mod >= 0)
+	    {
+		mod -= dx;
+		delta++;
+	    }
+
+	    add_cell (row, ex1, delta, POLY_ONE * delta);
+	    y1 += delta;
+	    ex1 += incr;
+	}
+	while (ex1 != ex2);
+    }
+
+    delta = y2 - y1;
+    add_cell (row, ex2, delta, (fx2 + POLY_ONE - first) * delta);
+}
+
+static force_inline int32_t
+edge_x_at (const poly_edge_t *e, int32_t y)
+{
+    return e->x1 + (int32_t)((int64_t)(y - e->y1) * (e->x2 - e->x1) /
+			     (e->y2 - e->y1));
+}
+
+static void
+render_edge (poly_row_t *row, const poly_edge_t *e, int32_t top)
+{
+    int32_t y1 = MAX (e->y1, top);
+    int32_t y2 = MIN (e->y2, top + POLY_ONE);
+    int32_t x1, x2;
+
+    if (y1 >= y2)
+	return;
+
+    x1 = edge_x_at (e, y1);
+    x2 = edge_x_at (e, y2);
+
+    if (e->dir > 0)
+	render_segment (row, x1, y1 - top, x2, y2 - top);
+    else
+	render_segment (row, x2, y2 - top, x1, y1 - top);
+}
+
+static force_inline int
+poly_coverage (int area, pixman_fill_rule_t fill_rule)
+{
+    if (area < 0)
+	area = -area;
+
+    if (fill_rule == PIXMAN_FILL_RULE_EVEN_ODD)
+    {
+	area &= 2 * POLY_FULL - 1;
+	if (area > POLY_FULL)
+	    area = 2 * POLY_FULL - area;
+    }
+
+    area = (area + POLY_ONE) >> (POLY_SHIFT + 1);
+
+    return area > 0xff ? 0xff : area;
+}
+
+/* Sort the cells of the row and turn them into coverage in mask, which
+ * is the part of the row from x1 to x2. The span of the row that was
+ * written is returned in lo and hi, which start out equal.
+ */
+static void
+sweep_row (poly_row_t *row, pixman_fill_rule_t fill_rule, uint8_t *mask,
+	   int x1, int x2, int *lo, int *hi)
+{
+    poly_cell_t *cells = row->cells;
+    int n_cells = row->n_cells;
+    int cover = 0;
+    int i, j;
+
+    if (n_cells > 16)
+    {
+	qsort (cells, n_cells, sizeof (poly_cell_t), compare_poly_cells);
+    }
+    else
+    {
+	for (i = 1; i < n_cells; ++i)
+	{
+	    poly_cell_t tmp = cells[i];
+
+	    for (j = i; j > 0 && cells[j - 1].x > tmp.x; --j)
+		cells[j] = cells[j - 1];
+	    cells[j] = tmp;
+	}
+    }
+
+    i = 0;
+    while (i < n_cells)
+    {
+	int x = cells[i].x, area = 0;
+	int next, alpha;
+
+	do
+	{
+	    cover += cells[i].cover;
+	    area += cells[i].area;
+	}
+	while (++i < n_cells && cells[i].x == x);
+
+	if (x >= x2)
+	    break;
+
+	if (x >= x1)
+	{
+	    if (*lo == *hi)
+		*lo = x;
+	    else if (x > *hi)
+		memset (mask + *hi - x1, 0, x - *hi);
+
+	    mask[x - x1] = poly_coverage (cover * 2 * POLY_ONE - area, fill_rule);
+	    *hi = x + 1;
+	}
+
+	/* The pixels up to the next cell are covered by the winding */
+	if (cover && (alpha = poly_coverage (cover * 2 * POLY_ONE, fill_rule)))
+	{
+	    next = i < n_cells ? MIN (cells[i].x, x2) : x2;
+	    x = MAX (x + 1, x1);
+
+	    if (x < next)
+	    {
+		if (*lo == *hi)
+		    *lo = x;
+		else if (x > *hi)
+		    memset (mask + *hi - x1, 0, x - *hi);
+
+		memset (mask + x - x1, alpha, next - x);
+		*hi = next;
+	    }
+	}
+    }
+}
+
+/*
+ * pixman_composite_polygon()
+ *
+ * The polygon is made of n_contours closed contours, the i'th of which
+ * has n_points[i] points, all of them one after the other in points.
+ * Like the trapezoids of pixman_composite_trapezoids(), it is
+ * conceptually rendered to an infinitely big mask whose (0, 0) is
+ * aligned with (x_src, y_src) in the source and (x_dst, y_dst) in the
+ * destination. The coverage of each pixel is the exact area of it that
+ * is inside the polygon according to fill_rule.
+ *
+ * Instead of a mask of the size of the polygon, only one row of coverage
+ * is kept, and each row is composited as soon as it is done.
+ */
+PIXMAN_EXPORT void
+pixman_composite_polygon (pixman_op_t			op,
+			  pixman_image_t *		src,
+			  pixman_image_t *		dst,
+			  pixman_fill_rule_t		fill_rule,
+			  int				x_src,
+			  int				y_src,
+			  int				x_dst,
+			  int				y_dst,
+			  int				n_contours,
+			  const int *			n_points,
+			  const pixman_point_fixed_t *	points)
+{
+    poly_edge_t *edges;
+    poly_edge_t **active;
+    poly_row_t row;
+    pixman_image_t *mask = NULL;
+    pixman_box32_t box;
+    pixman_bool_t bounded;
+    int n_edges, n_total, n_active, next;
+    int y, y1, y2;
+    int i, j;
+
+    return_if_fail (dst->type == BITS);
+
+    if (n_contours <= 0)
+	return;
+
+    n_total = 0;
+    for (i = 0; i < n_contours; ++i)
+    {
+	return_if_fail (n_points[i] >= 0);
+
+	n_total += n_points[i];
+    }
+
+    if (n_total == 0)
+	return;
+
+    if (!(edges = pixman_malloc_ab (n_total, sizeof (poly_edge_t) +
+				    sizeof (poly_edge_t *))))
+    {
+	return;
+    }
+    active = (poly_edge_t **)(edges + n_total);
+
+    n_edges = 0;
+    for (i = 0; i < n_contours; ++i)
+    {
+	const pixman_point_fixed_t *p = points;
+
+	for (j = 0; j < n_points[i]; ++j)
+	{
+	    const pixman_point_fixed_t *q = &p[(j + 1) % n_points[i]];
+	    poly_edge_t *e = &edges[n_edges];
+
+	    e->x1 = poly_coord (p[j].x);
+	    e->y1 = poly_coord (p[j].y);
+	    e->x2 = poly_coord (q->x);
+	    e->y2 = poly_coord (q->y);
+	    e->dir = 1;
+
+	    /* Horizontal edges don't cover anything */
+	    if (e->y1 == e->y2)
+		continue;
+
+	    if (e->y1 > e->y2)
+	    {
+		int32_t t;
+
+		t = e->x1; e->x1 = e->x2; e->x2 = t;
+		t = e->y1; e->y1 = e->y2; e->y2 = t;
+		e->dir = -1;
+	    }
+
+	    n_edges++;
+	}
+
+	points += n_points[i];
+    }
+
+    _pixman_image_validate (src);
+    _pixman_image_validate (dst);
+
+    /* The part of the destination that can change, in mask coordinates */
+    box.x1 = 0;
+    box.y1 = 0;
+    box.x2 = dst->bits.width;
+    box.y2 = dst->bits.height;
+
+    if (dst->common.have_clip_region)
+    {
+	const pixman_box32_t *extents =
+	    pixman_region32_extents (&dst->common.clip_region);
+
+	box.x1 = MAX (box.x1, extents->x1);
+	box.y1 = MAX (box.y1, extents->y1);
+	box.x2 = MIN (box.x2, extents->x2);
+	box.y2 = MIN (box.y2, extents->y2);
+    }
+
+    box.x1 -= x_dst;
+    box.y1 -= y_dst;
+    box.x2 -= x_dst;
+    box.y2 -= y_dst;
+
+    /* When a zero source has an effect, the whole destination is
+     * composited, not just the rows and spans that the polygon covers.
+     */
+    bounded = zero_src_has_no_effect[op];
+
+    y1 = box.y1;
+    y2 = box.y2;
+
+    qsort (edges, n_edges, sizeof (poly_edge_t), compare_poly_edges);
+
+    if (bounded)
+    {
+	int32_t bottom = INT32_MIN;
+
+	if (n_edges == 0)
+	    goto out;
+
+	for (i = 0; i < n_edges; ++i)
+	    bottom = MAX (bottom, edges[i].y2);
+
+	y1 = MAX (y1, edges[0].y1 >> POLY_SHIFT);
+	y2 = MIN (y2, (bottom + POLY_ONE - 1) >> POLY_SHIFT);
+    }
+
+    if (box.x1 >= box.x2 || y1 >= y2)
+	goto out;
+
+    if (!(mask = pixman_image_create_bits (
+	      PIXMAN_a8, box.x2 - box.x1, 1, NULL, -1)))
+    {
+	goto out;
+    }
+
+    row.cells = row.stack_cells;
+    row.size = N_STACK_CELLS;
+    row.failed = FALSE;
+
+    n_active = 0;
+    next = 0;
+
+    for (y = y1; y < y2; ++y)
+    {
+	int32_t top = y * POLY_ONE;
+	uint8_t *bits = (uint8_t *)mask->bits.bits;
+	int lo, hi;
+
+	/* Update the active edge table */
+	while (next < n_edges && edges[next].y1 < top + POLY_ONE)
+	    active[n_active++] = &edges[next++];
+
+	for (i = 0, j = 0; i < n_active; ++i)
+	{
+	    if (active[i]->y2 > top)
+		active[j++] = active[i];
+	}
+	n_active = j;
+
+	row.n_cells = 0;
+	for (i = 0; i < n_active; ++i)
+	    render_edge (&row, active[i], top);
+
+	if (row.failed)
+	    break;
+
+	if (!bounded)
+	    memset (bits, 0, box.x2 - box.x1);
+
+	lo = hi = 0;
+	sweep_row (&row, fill_rule, bits, box.x1, box.x2, &lo, &hi);
+
+	if (!bounded)
+	{
+	    lo = box.x1;
+	    hi = box.x2;
+	}
+
+	if (lo < hi)
+	{
+	    pixman_image_composite32 (op, src, mask, dst,
+				      x_src + lo, y_src + y,
+				      lo - box.x1, 0,
+				      x_dst + lo, y_dst + y,
+				      hi - lo, 1);
+	}
+    }
+
+    if (row.cells != row.stack_cells)
+	free (row.cells);
+
+out:
+    if (mask)
+	pixman_image_unref (mask);
+
+    free (edges);
+}
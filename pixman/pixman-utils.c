@@ -71,30 +71,6 @@ pixman_malloc_abc (unsigned int a,
 	return malloc (a * b * c);
 }
 
-static force_inline uint16_t
-float_to_unorm (float f, int n_bits)
-{
-    uint32_t u;
-
-    if (f > 1.0)
-	f = 1.0;
-    if (f < 0.0)
-	f = 0.0;
-
-    u = f * (1 << n_bits);
-    u -= (u >> n_bits);
-
-    return u;
-}
-
-static force_inline float
-unorm_to_float (uint16_t u, int n_bits)
-{
-    uint32_t m = ((1 << n_bits) - 1);
-
-    return (u & m) * (1.f / (float)m);
-}
-
 /*
  * This function expands images from a8r8g8b8 to argb_t.  To preserve
  * precision, it needs to know from which source format the a8r8g8b8 pixels
@@ -214,6 +190,17 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask)
     return iter->buffer;
 }
 
+void
+_pixman_iter_init_bits_stride (pixman_iter_t *iter, const pixman_iter_info_t *info)
+{
+    pixman_image_t *image = iter->image;
+    uint8_t *b = (uint8_t *)image->bits.bits;
+    int s = image->bits.rowstride * 4;
+
+    iter->bits = b + s * iter->y + iter->x * PIXMAN_FORMAT_BPP (info->format) / 8;
+    iter->stride = s;
+}
+
 #define N_TMP_BOXES (16)
 
 pixman_bool_t
@@ -25,7 +25,8 @@
 
 #include "pixman-private.h"
 
-#if defined(USE_X86_MMX) || defined (USE_SSE2)
+#if defined(USE_X86_MMX) || defined (USE_SSE2) || defined (USE_SSSE3) || \
+    defined (USE_AVX2)
 
 /* The CPU detection code needs to be in a file not compiled with
  * "-mmmx -msse", as gcc would generate CMOV instructions otherwise
@@ -39,7 +40,9 @@ typedef enum
     X86_MMX_EXTENSIONS		= (1 << 1),
     X86_SSE			= (1 << 2) | X86_MMX_EXTENSIONS,
     X86_SSE2			= (1 << 3),
-    X86_CMOV			= (1 << 4)
+    X86_CMOV			= (1 << 4),
+    X86_AVX2			= (1 << 5),
+    X86_SSSE3			= (1 << 6)
 } cpu_features_t;
 
 #ifdef HAVE_GETISAX
@@ -50,20 +53,33 @@ static cpu_features_t
 detect_cpu_features (void)
 {
     cpu_features_t features = 0;
-    unsigned int result = 0;
+    unsigned int result[2] = { 0, 0 };
 
-    if (getisax (&result, 1))
+    if (getisax (result, 2))
     {
-	if (result & AV_386_CMOV)
+	if (result[0] & AV_386_CMOV)
 	    features |= X86_CMOV;
-	if (result & AV_386_MMX)
+	if (result[0] & AV_386_MMX)
 	    features |= X86_MMX;
-	if (result & AV_386_AMD_MMX)
+	if (result[0] & AV_386_AMD_MMX)
 	    features |= X86_MMX_EXTENSIONS;
-	if (result & AV_386_SSE)
+	if (result[0] & AV_386_SSE)
 	    features |= X86_SSE;
-	if (result & AV_386_SSE2)
+	if (result[0] & AV_386_SSE2)
 	    features |= X86_SSE2;
+#ifdef AV_386_SSSE3
+	if (result[0] & AV_386_SSSE3)
+	    features |= X86_SSSE3;
+#endif
+#ifdef AV_386_2_AVX2
+	if (result[1] & AV_386_2_AVX2)
+	    features |= X86_AVX2;
+#endif
+#ifdef AV_386_2_F16C
+	/* The AVX2 implementation uses F16C as well */
+	if (!(result[1] & AV_386_2_F16C))
+	    features &= ~X86_AVX2;
+#endif
     }
 
     return features;
@@ -71,6 +87,10 @@ detect_cpu_features (void)
 
 #else
 
+#if defined (_MSC_VER)
+#include <intrin.h> /* for __cpuidex and _xgetbv */
+#endif
+
 #define _PIXMAN_X86_64							\
     (defined(__amd64__) || defined(__x86_64__) || defined(_M_AMD64))
 
@@ -116,7 +136,7 @@ pixman_cpuid (uint32_t feature,
     __asm__ volatile (
         "cpuid"				"\n\t"
 	: "=a" (*a), "=b" (*b), "=c" (*c), "=d" (*d)
-	: "a" (feature));
+	: "a" (feature), "c" (0));
 #else
     /* On x86-32 we need to be careful about the handling of %ebx
      * and %esp. We can't declare either one as clobbered
@@ -131,13 +151,13 @@ pixman_cpuid (uint32_t feature,
 	"cpuid"				"\n\t"
 	"xchg %%ebx, %1"		"\n\t"
 	: "=a" (*a), "=r" (*b), "=c" (*c), "=d" (*d)
-	: "a" (feature));
+	: "a" (feature), "c" (0));
 #endif
 
 #elif defined (_MSC_VER)
     int info[4];
 
-    __cpuid (info, feature);
+    __cpuidex (info, feature, 0);
 
     *a = info[0];
     *b = info[1];
@@ -148,6 +168,30 @@ pixman_cpuid (uint32_t feature,
 #endif
 }
 
+/* Returns the low 32 bits of the XCR0 register, which tells us which
+ * register states the operating system saves on context switches.
+ * Only call this when CPUID reports OSXSAVE.
+ */
+static uint32_t
+pixman_xgetbv (void)
+{
+#if defined (__GNUC__)
+    uint32_t lo, hi;
+
+    /* xgetbv, spelled out for assemblers that don't know it */
+    __asm__ volatile (
+	".byte 0x0f, 0x01, 0xd0"	"\n\t"
+	: "=a" (lo), "=d" (hi)
+	: "c" (0));
+
+    return lo;
+#elif defined (_MSC_VER)
+    return (uint32_t)_xgetbv (0);
+#else
+#error Unknown compiler
+#endif
+}
+
 static cpu_features_t
 detect_cpu_features (void)
 {
@@ -167,6 +211,27 @@ detect_cpu_features (void)
 	features |= X86_SSE;
     if (d & (1 << 26))
 	features |= X86_SSE2;
+    if (c & (1 << 9))
+	features |= X86_SSSE3;
+
+    /* AVX2 needs the OS to preserve the upper halves of the ymm
+     * registers (OSXSAVE set and XCR0 bits 1 and 2), not just the
+     * CPUID bit in leaf 7. The AVX2 implementation also converts half
+     * floats with F16C, which every AVX2 processor has.
+     */
+    if ((c & (1 << 27)) && (c & (1 << 28)) && (c & (1 << 29)) &&
+	(pixman_xgetbv () & 0x6) == 0x6)
+    {
+	uint32_t max_leaf;
+
+	pixman_cpuid (0x00, &max_leaf, &b, &c, &d);
+	if (max_leaf >= 0x07)
+	{
+	    pixman_cpuid (0x07, &a, &b, &c, &d);
+	    if (b & (1 << 5))
+		features |= X86_AVX2;
+	}
+    }
 
     /* Check for AMD specific features */
     if ((features & X86_MMX) && !(features & X86_SSE))
@@ -222,6 +287,8 @@ _pixman_x86_get_implementations (pixman_implementation_t *imp)
 {
 #define MMX_BITS  (X86_MMX | X86_MMX_EXTENSIONS)
 #define SSE2_BITS (X86_MMX | X86_MMX_EXTENSIONS | X86_SSE | X86_SSE2)
+#define SSSE3_BITS (X86_MMX | X86_MMX_EXTENSIONS | X86_SSE | X86_SSE2 | X86_SSSE3)
+#define AVX2_BITS (X86_MMX | X86_MMX_EXTENSIONS | X86_SSE | X86_SSE2 | X86_AVX2)
 
 #ifdef USE_X86_MMX
     if (!_pixman_disabled ("mmx") && have_feature (MMX_BITS))
@@ -233,5 +300,15 @@ _pixman_x86_get_implementations (pixman_implementation_t *imp)
 	imp = _pixman_implementation_create_sse2 (imp);
 #endif
 
+#ifdef USE_SSSE3
+    if (!_pixman_disabled ("ssse3") && have_feature (SSSE3_BITS))
+	imp = _pixman_implementation_create_ssse3 (imp);
+#endif
+
+#ifdef USE_AVX2
+    if (!_pixman_disabled ("avx2") && have_feature (AVX2_BITS))
+	imp = _pixman_implementation_create_avx2 (imp);
+#endif
+
     return imp;
 }
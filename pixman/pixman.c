@@ -548,66 +548,486 @@ analyze_extent (pixman_image_t       *image,
 }
 
 /*
- * Work around GCC bug causing crashes in Mozilla with SSE2
- *
- * When using -msse, gcc generates movdqa instructions assuming that
- * the stack is 16 byte aligned. Unfortunately some applications, such
- * as Mozilla and Mono, end up aligning the stack to 4 bytes, which
- * causes the movdqa instructions to fail.
- *
- * The __force_align_arg_pointer__ makes gcc generate a prologue that
- * realigns the stack pointer to 16 bytes.
- *
- * On x86-64 this is not necessary because the standard ABI already
- * calls for a 16 byte aligned stack.
+ * Implementation selection
+ */
+
+/* Every chain that has been switched to. Chains are never freed, so
+ * composites still running on one that was switched away from, and the
+ * caches that remember pointers into them, stay valid.
+ */
+static pixman_implementation_t **	chains;
+static int				n_chains;
+
+static pixman_bool_t
+same_chain (pixman_implementation_t *a, pixman_implementation_t *b)
+{
+    while (a && b && strcmp (a->name, b->name) == 0)
+    {
+	a = a->fallback;
+	b = b->fallback;
+    }
+
+    return !a && !b;
+}
+
+PIXMAN_EXPORT int
+pixman_get_implementations (const char **names, int n_names)
+{
+    pixman_implementation_t *imp;
+    int n = 0;
+
+    for (imp = get_implementation (); imp != NULL; imp = imp->fallback)
+    {
+	if (n < n_names)
+	    names[n] = imp->name;
+	n++;
+    }
+
+    return n;
+}
+
+PIXMAN_EXPORT pixman_bool_t
+pixman_set_implementations (const char *top, const char *exclude)
+{
+    pixman_implementation_t *imp, *chain, **new_chains;
+    int i;
+
+    if (n_chains == 0)
+    {
+	if (!(chains = malloc (sizeof (pixman_implementation_t *))))
+	    return FALSE;
+
+	chains[n_chains++] = get_implementation ();
+    }
+
+    chain = _pixman_select_implementation (top, exclude);
+
+    if (top)
+    {
+	for (imp = chain; imp != NULL; imp = imp->fallback)
+	{
+	    if (strcmp (imp->name, top) == 0)
+		break;
+	}
+
+	if (!imp)
+	{
+	    _pixman_implementation_destroy (chain);
+	    return FALSE;
+	}
+    }
+
+    for (i = 0; i < n_chains; ++i)
+    {
+	if (same_chain (chain, chains[i]))
+	{
+	    _pixman_implementation_destroy (chain);
+
+	    global_implementation = chains[i];
+	    return TRUE;
+	}
+    }
+
+    new_chains = pixman_malloc_ab (n_chains + 1, sizeof (pixman_implementation_t *));
+    if (!new_chains)
+    {
+	_pixman_implementation_destroy (chain);
+	return FALSE;
+    }
+
+    memcpy (new_chains, chains, n_chains * sizeof (pixman_implementation_t *));
+    free (chains);
+
+    chains = new_chains;
+    chains[n_chains++] = chain;
+
+    global_implementation = chain;
+    return TRUE;
+}
+
+static pixman_composite_trace_func_t	composite_trace;
+static void *				composite_trace_data;
+
+PIXMAN_EXPORT pixman_bool_t
+pixman_lookup_composite_path (pixman_composite_path_t *path)
+{
+    pixman_implementation_t *imp;
+    pixman_composite_func_t func;
+
+    if (!_pixman_implementation_lookup_composite (
+	    get_implementation (), path->op,
+	    path->src_format, path->src_flags,
+	    path->mask_format, path->mask_flags,
+	    path->dest_format, path->dest_flags,
+	    &imp, &func))
+    {
+	return FALSE;
+    }
+
+    path->implementation = imp->name;
+    path->func = (void (*) (void))func;
+
+    return TRUE;
+}
+
+PIXMAN_EXPORT void
+pixman_set_composite_trace (pixman_composite_trace_func_t func, void *data)
+{
+    composite_trace = func;
+    composite_trace_data = data;
+}
+
+static void
+trace_composite (const pixman_composite_info_t *info,
+		 pixman_format_code_t           src_format,
+		 pixman_format_code_t           mask_format,
+		 pixman_format_code_t           dest_format,
+		 pixman_implementation_t *      imp,
+		 pixman_composite_func_t        func)
+{
+    pixman_composite_path_t path;
+
+    path.op = info->op;
+    path.src_format = src_format;
+    path.src_flags = info->src_flags;
+    path.mask_format = mask_format;
+    path.mask_flags = info->mask_flags;
+    path.dest_format = dest_format;
+    path.dest_flags = info->dest_flags;
+    path.implementation = imp->name;
+    path.func = (void (*) (void))func;
+
+    composite_trace (&path, composite_trace_data);
+}
+
+/*
+ * Streaming stores
  *
- * See https://bugs.freedesktop.org/show_bug.cgi?id=15693
+ * Fills and copies bigger than the last level cache gain nothing from
+ * leaving the destination in the cache, so above this many bytes the
+ * SIMD implementations write it with non-temporal stores.
+ */
+#define DEFAULT_STREAMING_THRESHOLD	(8 * 1024 * 1024)
+
+int _pixman_streaming_threshold = DEFAULT_STREAMING_THRESHOLD;
+
+PIXMAN_EXPORT void
+pixman_set_streaming_threshold (int n_bytes)
+{
+    _pixman_streaming_threshold = n_bytes;
+}
+
+/*
+ * Parallel compositing
+ */
+#define DEFAULT_PARALLEL_THRESHOLD	(256 * 256)
+#define MIN_BAND_HEIGHT			16
+#define JOBS_PER_THREAD			4
+
+static pixman_run_jobs_func_t	run_jobs;
+static void *			run_jobs_data;
+static int			n_pool_threads;
+static int			parallel_threshold = DEFAULT_PARALLEL_THRESHOLD;
+
+PIXMAN_EXPORT void
+pixman_set_thread_pool (pixman_run_jobs_func_t run_jobs_func,
+			void *                 pool_data,
+			int                    n_threads,
+			int                    threshold)
+{
+    if (!run_jobs_func || n_threads < 2)
+    {
+	run_jobs_func = NULL;
+	pool_data = NULL;
+	n_threads = 0;
+    }
+
+    run_jobs = run_jobs_func;
+    run_jobs_data = pool_data;
+    n_pool_threads = n_threads;
+    parallel_threshold = threshold > 0 ? threshold : DEFAULT_PARALLEL_THRESHOLD;
+}
+
+typedef struct
+{
+    pixman_implementation_t *		imp;
+    pixman_composite_func_t		func;
+    const pixman_composite_info_t *	info;
+    const pixman_box32_t *		boxes;
+    int					n_boxes;
+    int32_t				src_dx, src_dy;
+    int32_t				mask_dx, mask_dy;
+    int32_t				y;
+    int32_t				band_height;
+} composite_bands_t;
+
+/* Composites the part of the boxes that falls within band number 'job'.
+ * Bands are disjoint sets of destination rows, so jobs never write to the
+ * same pixels. The composite functions compute their starting positions
+ * from info->src_x/src_y directly, so splitting a box like this gives
+ * exactly the same result as compositing it in one go.
  */
 #if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
 __attribute__((__force_align_arg_pointer__))
 #endif
-PIXMAN_EXPORT void
-pixman_image_composite32 (pixman_op_t      op,
-                          pixman_image_t * src,
-                          pixman_image_t * mask,
-                          pixman_image_t * dest,
-                          int32_t          src_x,
-                          int32_t          src_y,
-                          int32_t          mask_x,
-                          int32_t          mask_y,
-                          int32_t          dest_x,
-                          int32_t          dest_y,
-                          int32_t          width,
-                          int32_t          height)
+static void
+composite_band (void *data, int job)
 {
-    pixman_format_code_t src_format, mask_format, dest_format;
-    uint32_t src_flags, mask_flags, dest_flags;
-    pixman_region32_t region;
-    pixman_box32_t extents;
-    pixman_implementation_t *imp;
-    pixman_composite_func_t func;
+    composite_bands_t *bands = data;
+    pixman_composite_info_t info = *bands->info;
+    const pixman_box32_t *pbox = bands->boxes;
+    int32_t y1 = bands->y + job * bands->band_height;
+    int32_t y2 = y1 + bands->band_height;
+    int n = bands->n_boxes;
+
+    while (n-- && pbox->y1 < y2)
+    {
+	int32_t by1 = MAX (pbox->y1, y1);
+	int32_t by2 = MIN (pbox->y2, y2);
+
+	if (by1 < by2)
+	{
+	    info.src_x = pbox->x1 + bands->src_dx;
+	    info.src_y = by1 + bands->src_dy;
+	    info.mask_x = pbox->x1 + bands->mask_dx;
+	    info.mask_y = by1 + bands->mask_dy;
+	    info.dest_x = pbox->x1;
+	    info.dest_y = by1;
+	    info.width = pbox->x2 - pbox->x1;
+	    info.height = by2 - by1;
 
+	    bands->func (bands->imp, &info);
+	}
+
+	pbox++;
+    }
+}
+
+/* The addresses [start, end) that hold the pixels of a bits image */
+static void
+get_bits_range (const bits_image_t *image, uintptr_t *start, uintptr_t *end)
+{
+    uintptr_t bits = (uintptr_t)image->bits;
+    intptr_t stride = (intptr_t)image->rowstride * 4;
+    intptr_t last_row = stride * (image->height - 1);
+    uintptr_t row_size =
+	((uintptr_t)image->width * PIXMAN_FORMAT_BPP (image->format) + 7) / 8;
+
+    if (stride >= 0)
+    {
+	*start = bits;
+	*end = bits + last_row + row_size;
+    }
+    else
+    {
+	*start = bits + last_row;
+	*end = bits + row_size;
+    }
+}
+
+/* A view into the middle of another image shares memory with it
+ * without having the same bits pointer.
+ */
+static pixman_bool_t
+bits_overlap (const bits_image_t *a, const bits_image_t *b)
+{
+    uintptr_t a_start, a_end, b_start, b_end;
+
+    get_bits_range (a, &a_start, &a_end);
+    get_bits_range (b, &b_start, &b_end);
+
+    return a_start < b_end && b_start < a_end;
+}
+
+static pixman_bool_t
+can_composite_in_parallel (const pixman_composite_info_t *info)
+{
+    pixman_image_t *dest = info->dest_image;
+    pixman_image_t *src = info->src_image;
+    pixman_image_t *mask = info->mask_image;
+
+    /* Accessors may not be thread safe, and reading from the
+     * destination while other threads write to it is not either.
+     */
+    if (!(dest->common.flags & FAST_PATH_NO_ACCESSORS))
+	return FALSE;
+
+    if (src->type == BITS &&
+	(!(src->common.flags & FAST_PATH_NO_ACCESSORS) ||
+	 bits_overlap (&src->bits, &dest->bits)))
+    {
+	return FALSE;
+    }
+
+    if (mask && mask->type == BITS &&
+	(!(mask->common.flags & FAST_PATH_NO_ACCESSORS) ||
+	 bits_overlap (&mask->bits, &dest->bits)))
+    {
+	return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Runs 'func' on each of the boxes, which are in destination space
+ * and sorted in y-x order like region rectangles. 'info' must have
+ * everything but the positions and sizes filled in.
+ */
+static void
+composite_boxes (pixman_implementation_t *imp,
+		 pixman_composite_func_t  func,
+		 pixman_composite_info_t *info,
+		 const pixman_box32_t *   pbox,
+		 int                      n,
+		 int32_t                  src_dx,
+		 int32_t                  src_dy,
+		 int32_t                  mask_dx,
+		 int32_t                  mask_dy)
+{
+    if (run_jobs && n > 0)
+    {
+	int32_t y1 = pbox[0].y1;
+	int32_t y2 = pbox[n - 1].y2;
+	int64_t area = 0;
+	int i;
+
+	for (i = 0; i < n; ++i)
+	{
+	    area += (int64_t)(pbox[i].x2 - pbox[i].x1) *
+		(pbox[i].y2 - pbox[i].y1);
+	}
+
+	if (area >= parallel_threshold && can_composite_in_parallel (info))
+	{
+	    int n_jobs = n_pool_threads * JOBS_PER_THREAD;
+	    composite_bands_t bands;
+
+	    if (n_jobs > (y2 - y1) / MIN_BAND_HEIGHT)
+		n_jobs = (y2 - y1) / MIN_BAND_HEIGHT;
+
+	    if (n_jobs > 1)
+	    {
+		bands.imp = imp;
+		bands.func = func;
+		bands.info = info;
+		bands.boxes = pbox;
+		bands.n_boxes = n;
+		bands.src_dx = src_dx;
+		bands.src_dy = src_dy;
+		bands.mask_dx = mask_dx;
+		bands.mask_dy = mask_dy;
+		bands.y = y1;
+		bands.band_height = (y2 - y1 + n_jobs - 1) / n_jobs;
+
+		run_jobs (run_jobs_data, n_jobs, composite_band, &bands);
+		return;
+	    }
+	}
+    }
+
+    while (n--)
+    {
+	info->src_x = pbox->x1 + src_dx;
+	info->src_y = pbox->y1 + src_dy;
+	info->mask_x = pbox->x1 + mask_dx;
+	info->mask_y = pbox->y1 + mask_dy;
+	info->dest_x = pbox->x1;
+	info->dest_y = pbox->y1;
+	info->width = pbox->x2 - pbox->x1;
+	info->height = pbox->y2 - pbox->y1;
+
+	func (imp, info);
+
+	pbox++;
+    }
+}
+
+/* The parts of a composite operation that don't depend on the
+ * rectangle being composited, along with the result of the last fast
+ * path lookup so that a batch of composites with the same images
+ * usually only looks up the composite function once.
+ */
+typedef struct
+{
+    pixman_op_t			op;
+    pixman_image_t *		src;
+    pixman_image_t *		mask;
+    pixman_image_t *		dest;
+    pixman_format_code_t	src_format;
+    pixman_format_code_t	mask_format;
+    pixman_format_code_t	dest_format;
+    uint32_t			src_flags;
+    uint32_t			mask_flags;
+    uint32_t			dest_flags;
+
+    pixman_implementation_t *	imp;
+    pixman_composite_func_t	func;
+    pixman_op_t			func_op;
+    pixman_format_code_t	func_src_format;
+    pixman_format_code_t	func_mask_format;
+    uint32_t			func_src_flags;
+    uint32_t			func_mask_flags;
+} composite_state_t;
+
+static void
+composite_state_init (composite_state_t *state,
+		      pixman_op_t        op,
+		      pixman_image_t *   src,
+		      pixman_image_t *   mask,
+		      pixman_image_t *   dest)
+{
     _pixman_image_validate (src);
     if (mask)
 	_pixman_image_validate (mask);
     _pixman_image_validate (dest);
 
-    src_format = src->common.extended_format_code;
-    src_flags = src->common.flags;
+    state->op = op;
+    state->src = src;
+    state->mask = mask;
+    state->dest = dest;
+
+    state->src_format = src->common.extended_format_code;
+    state->src_flags = src->common.flags;
 
     if (mask && !(mask->common.flags & FAST_PATH_IS_OPAQUE))
     {
-	mask_format = mask->common.extended_format_code;
-	mask_flags = mask->common.flags;
+	state->mask_format = mask->common.extended_format_code;
+	state->mask_flags = mask->common.flags;
     }
     else
     {
-	mask_format = PIXMAN_null;
-	mask_flags = FAST_PATH_IS_OPAQUE;
+	state->mask_format = PIXMAN_null;
+	state->mask_flags = FAST_PATH_IS_OPAQUE;
     }
 
-    dest_format = dest->common.extended_format_code;
-    dest_flags = dest->common.flags;
+    state->dest_format = dest->common.extended_format_code;
+    state->dest_flags = dest->common.flags;
+
+    state->func = NULL;
+}
+
+static void
+composite_rect (composite_state_t *state,
+		int32_t            src_x,
+		int32_t            src_y,
+		int32_t            mask_x,
+		int32_t            mask_y,
+		int32_t            dest_x,
+		int32_t            dest_y,
+		int32_t            width,
+		int32_t            height)
+{
+    pixman_image_t *src = state->src;
+    pixman_image_t *mask = state->mask;
+    pixman_image_t *dest = state->dest;
+    pixman_format_code_t src_format = state->src_format;
+    pixman_format_code_t mask_format = state->mask_format;
+    uint32_t src_flags = state->src_flags;
+    uint32_t mask_flags = state->mask_flags;
+    uint32_t dest_flags = state->dest_flags;
+    pixman_region32_t region;
+    pixman_box32_t extents;
+    pixman_op_t op;
 
     /* Check for pixbufs */
     if ((mask_format == PIXMAN_a8r8g8b8 || mask_format == PIXMAN_a8b8g8r8) &&
@@ -676,12 +1096,32 @@ pixman_image_composite32 (pixman_op_t      op,
      * if the src or dest are opaque. The output operator should be
      * mathematically equivalent to the source.
      */
-    op = optimize_operator (op, src_flags, mask_flags, dest_flags);
+    op = optimize_operator (state->op, src_flags, mask_flags, dest_flags);
+
+    if (!state->func				||
+	op != state->func_op			||
+	src_format != state->func_src_format	||
+	src_flags != state->func_src_flags	||
+	mask_format != state->func_mask_format	||
+	mask_flags != state->func_mask_flags)
+    {
+	if (!_pixman_implementation_lookup_composite (
+		get_implementation (), op,
+		src_format, src_flags, mask_format, mask_flags,
+		state->dest_format, dest_flags,
+		&state->imp, &state->func))
+	{
+	    state->func = NULL;
+	    goto out;
+	}
+
+	state->func_op = op;
+	state->func_src_format = src_format;
+	state->func_src_flags = src_flags;
+	state->func_mask_format = mask_format;
+	state->func_mask_flags = mask_flags;
+    }
 
-    if (_pixman_implementation_lookup_composite (
-	    get_implementation (), op,
-	    src_format, src_flags, mask_format, mask_flags, dest_format, dest_flags,
-	    &imp, &func))
     {
 	pixman_composite_info_t info;
 	const pixman_box32_t *pbox;
@@ -697,27 +1137,89 @@ pixman_image_composite32 (pixman_op_t      op,
 
 	pbox = pixman_region32_rectangles (&region, &n);
 
-	while (n--)
+	if (composite_trace)
 	{
-	    info.src_x = pbox->x1 + src_x - dest_x;
-	    info.src_y = pbox->y1 + src_y - dest_y;
-	    info.mask_x = pbox->x1 + mask_x - dest_x;
-	    info.mask_y = pbox->y1 + mask_y - dest_y;
-	    info.dest_x = pbox->x1;
-	    info.dest_y = pbox->y1;
-	    info.width = pbox->x2 - pbox->x1;
-	    info.height = pbox->y2 - pbox->y1;
-
-	    func (imp, &info);
-
-	    pbox++;
+	    trace_composite (&info, src_format, mask_format,
+			     state->dest_format, state->imp, state->func);
 	}
+
+	composite_boxes (state->imp, state->func, &info, pbox, n,
+			 src_x - dest_x, src_y - dest_y,
+			 mask_x - dest_x, mask_y - dest_y);
     }
 
 out:
     pixman_region32_fini (&region);
 }
 
+/*
+ * Work around GCC bug causing crashes in Mozilla with SSE2
+ *
+ * When using -msse, gcc generates movdqa instructions assuming that
+ * the stack is 16 byte aligned. Unfortunately some applications, such
+ * as Mozilla and Mono, end up aligning the stack to 4 bytes, which
+ * causes the movdqa instructions to fail.
+ *
+ * The __force_align_arg_pointer__ makes gcc generate a prologue that
+ * realigns the stack pointer to 16 bytes.
+ *
+ * On x86-64 this is not necessary because the standard ABI already
+ * calls for a 16 byte aligned stack.
+ *
+ * See https://bugs.freedesktop.org/show_bug.cgi?id=15693
+ */
+#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+PIXMAN_EXPORT void
+pixman_image_composite32 (pixman_op_t      op,
+                          pixman_image_t * src,
+                          pixman_image_t * mask,
+                          pixman_image_t * dest,
+                          int32_t          src_x,
+                          int32_t          src_y,
+                          int32_t          mask_x,
+                          int32_t          mask_y,
+                          int32_t          dest_x,
+                          int32_t          dest_y,
+                          int32_t          width,
+                          int32_t          height)
+{
+    composite_state_t state;
+
+    composite_state_init (&state, op, src, mask, dest);
+
+    composite_rect (&state,
+		    src_x, src_y, mask_x, mask_y, dest_x, dest_y,
+		    width, height);
+}
+
+#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+PIXMAN_EXPORT void
+pixman_composite_batch (pixman_op_t                    op,
+			pixman_image_t *               src,
+			pixman_image_t *               mask,
+			pixman_image_t *               dest,
+			int                            n_rects,
+			const pixman_composite_rect_t *rects)
+{
+    composite_state_t state;
+    int i;
+
+    composite_state_init (&state, op, src, mask, dest);
+
+    for (i = 0; i < n_rects; ++i)
+    {
+	const pixman_composite_rect_t *r = &rects[i];
+
+	composite_rect (&state,
+			r->src_x, r->src_y, r->mask_x, r->mask_y,
+			r->dest_x, r->dest_y, r->width, r->height);
+    }
+}
+
 PIXMAN_EXPORT void
 pixman_image_composite (pixman_op_t      op,
                         pixman_image_t * src,
@@ -1020,6 +1522,10 @@ pixman_format_supported_source (pixman_format_code_t format)
 {
     switch (format)
     {
+    /* 64 bpp formats */
+    case PIXMAN_a16b16g16r16:
+    case PIXMAN_x16b16g16r16:
+    case PIXMAN_a16b16g16r16_float:
     /* 32 bpp formats */
     case PIXMAN_a2b10g10r10:
     case PIXMAN_x2b10g10r10:
@@ -1077,6 +1583,8 @@ pixman_format_supported_source (pixman_format_code_t format)
     /* YUV formats */
     case PIXMAN_yuy2:
     case PIXMAN_yv12:
+    case PIXMAN_i420:
+    case PIXMAN_nv12:
 	return TRUE;
 
     default:
@@ -1099,8 +1607,11 @@ PIXMAN_EXPORT pixman_bool_t
 pixman_format_supported_destination (pixman_format_code_t format)
 {
     /* YUV formats cannot be written to at the moment */
-    if (format == PIXMAN_yuy2 || format == PIXMAN_yv12)
+    if (format == PIXMAN_yuy2 || format == PIXMAN_yv12 ||
+	format == PIXMAN_i420 || format == PIXMAN_nv12)
+    {
 	return FALSE;
+    }
 
     return pixman_format_supported_source (format);
 }
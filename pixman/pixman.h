@@ -316,6 +316,38 @@ typedef enum
     PIXMAN_FILTER_SEPARABLE_CONVOLUTION
 } pixman_filter_t;
 
+typedef enum
+{
+    PIXMAN_DITHER_NONE,
+    PIXMAN_DITHER_FAST,
+    PIXMAN_DITHER_GOOD,
+    PIXMAN_DITHER_BEST,
+    PIXMAN_DITHER_ORDERED_BAYER_8,
+    PIXMAN_DITHER_ORDERED_BLUE_NOISE_64
+} pixman_dither_t;
+
+/* PIXMAN_GRADIENT_LUT looks colors up in a table of 1025 colors from 0
+ * to 1 instead of interpolating between the stops for every pixel. It is
+ * only used when all stops are between 0 and 1.
+ */
+typedef enum
+{
+    PIXMAN_GRADIENT_PRECISE,
+    PIXMAN_GRADIENT_LUT
+} pixman_gradient_precision_t;
+
+/* PIXMAN_SEPARABLE_TWO_PASS convolves scaled images that have a
+ * SEPARABLE_CONVOLUTION filter first along the rows and then along the
+ * columns. This is much faster for large filters, but the results can
+ * differ by 1 from PIXMAN_SEPARABLE_PRECISE, which applies the whole
+ * two-dimensional filter to every pixel.
+ */
+typedef enum
+{
+    PIXMAN_SEPARABLE_PRECISE,
+    PIXMAN_SEPARABLE_TWO_PASS
+} pixman_separable_precision_t;
+
 typedef enum
 {
     PIXMAN_OP_CLEAR			= 0x00,
@@ -654,12 +686,28 @@ struct pixman_indexed
 					 ((g) << 4) |	  \
 					 ((b)))
 
-#define PIXMAN_FORMAT_BPP(f)	(((f) >> 24)       )
-#define PIXMAN_FORMAT_TYPE(f)	(((f) >> 16) & 0xff)
-#define PIXMAN_FORMAT_A(f)	(((f) >> 12) & 0x0f)
-#define PIXMAN_FORMAT_R(f)	(((f) >>  8) & 0x0f)
-#define PIXMAN_FORMAT_G(f)	(((f) >>  4) & 0x0f)
-#define PIXMAN_FORMAT_B(f)	(((f)      ) & 0x0f)
+/* Formats with channels wider than 15 bits store the bpp and the
+ * channel sizes in bytes, which is flagged by the two bits above the
+ * type.
+ */
+#define PIXMAN_FORMAT_BYTE(bpp,type,a,r,g,b)	\
+	((((bpp) >> 3) << 24) |			\
+	 (3 << 22) | ((type) << 16) |		\
+	 (((a) >> 3) << 12) |			\
+	 (((r) >> 3) << 8) |			\
+	 (((g) >> 3) << 4) |			\
+	 (((b) >> 3)))
+
+#define PIXMAN_FORMAT_RESHIFT(val, ofs, num)				\
+	((((val) >> (ofs)) & ((1 << (num)) - 1)) << (((val) >> 22) & 3))
+
+#define PIXMAN_FORMAT_BPP(f)	PIXMAN_FORMAT_RESHIFT(f, 24, 8)
+#define PIXMAN_FORMAT_SHIFT(f)	((uint32_t)(((f) >> 22) & 3))
+#define PIXMAN_FORMAT_TYPE(f)	(((f) >> 16) & 0x3f)
+#define PIXMAN_FORMAT_A(f)	PIXMAN_FORMAT_RESHIFT(f, 12, 4)
+#define PIXMAN_FORMAT_R(f)	PIXMAN_FORMAT_RESHIFT(f, 8, 4)
+#define PIXMAN_FORMAT_G(f)	PIXMAN_FORMAT_RESHIFT(f, 4, 4)
+#define PIXMAN_FORMAT_B(f)	PIXMAN_FORMAT_RESHIFT(f, 0, 4)
 #define PIXMAN_FORMAT_RGB(f)	(((f)      ) & 0xfff)
 #define PIXMAN_FORMAT_VIS(f)	(((f)      ) & 0xffff)
 #define PIXMAN_FORMAT_DEPTH(f)	(PIXMAN_FORMAT_A(f) +	\
@@ -678,12 +726,16 @@ struct pixman_indexed
 #define PIXMAN_TYPE_BGRA	8
 #define PIXMAN_TYPE_RGBA	9
 #define PIXMAN_TYPE_ARGB_SRGB	10
+#define PIXMAN_TYPE_ABGR_FLOAT	11
+#define PIXMAN_TYPE_NV12	12
+#define PIXMAN_TYPE_I420	13
 
 #define PIXMAN_FORMAT_COLOR(f)				\
 	(PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_ARGB ||	\
 	 PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_ABGR ||	\
 	 PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_BGRA ||	\
-	 PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_RGBA)
+	 PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_RGBA ||	\
+	 PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_ABGR_FLOAT)
 
 /* 32bpp formats */
 typedef enum {
@@ -701,6 +753,15 @@ typedef enum {
     PIXMAN_x2b10g10r10 = PIXMAN_FORMAT(32,PIXMAN_TYPE_ABGR,0,10,10,10),
     PIXMAN_a2b10g10r10 = PIXMAN_FORMAT(32,PIXMAN_TYPE_ABGR,2,10,10,10),
 
+/* 64bpp formats */
+    /* The channels are stored in the order of the name, from the most
+     * to the least significant bits of a 64 bit pixel, and the float
+     * format uses IEEE half floats.
+     */
+    PIXMAN_a16b16g16r16 =	PIXMAN_FORMAT_BYTE(64,PIXMAN_TYPE_ABGR,16,16,16,16),
+    PIXMAN_x16b16g16r16 =	PIXMAN_FORMAT_BYTE(64,PIXMAN_TYPE_ABGR,0,16,16,16),
+    PIXMAN_a16b16g16r16_float =	PIXMAN_FORMAT_BYTE(64,PIXMAN_TYPE_ABGR_FLOAT,16,16,16,16),
+
 /* sRGB formats */
     PIXMAN_a8r8g8b8_sRGB = PIXMAN_FORMAT(32,PIXMAN_TYPE_ARGB_SRGB,8,8,8,8),
 
@@ -753,7 +814,9 @@ typedef enum {
 
 /* YUV formats */
     PIXMAN_yuy2 =	 PIXMAN_FORMAT(16,PIXMAN_TYPE_YUY2,0,0,0,0),
-    PIXMAN_yv12 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_YV12,0,0,0,0)
+    PIXMAN_yv12 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_YV12,0,0,0,0),
+    PIXMAN_nv12 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_NV12,0,0,0,0),
+    PIXMAN_i420 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_I420,0,0,0,0)
 } pixman_format_code_t;
 
 /* Querying supported format values. */
@@ -786,6 +849,11 @@ pixman_image_t *pixman_image_create_bits_no_clear    (pixman_format_code_t forma
 						      int                  height,
 						      uint32_t *           bits,
 						      int                  rowstride_bytes);
+pixman_image_t *pixman_image_create_planar          (pixman_format_code_t format,
+						      int                  width,
+						      int                  height,
+						      uint8_t * const *    planes,
+						      const int *          strides);
 
 /* Destructor */
 pixman_image_t *pixman_image_ref                     (pixman_image_t               *image);
@@ -811,6 +879,15 @@ pixman_bool_t   pixman_image_set_filter              (pixman_image_t
 						      pixman_filter_t               filter,
 						      const pixman_fixed_t         *filter_params,
 						      int                           n_filter_params);
+void            pixman_image_set_dither              (pixman_image_t               *image,
+						      pixman_dither_t               dither);
+void            pixman_image_set_dither_offset       (pixman_image_t               *image,
+						      int                           offset_x,
+						      int                           offset_y);
+void            pixman_image_set_gradient_precision  (pixman_image_t               *image,
+						      pixman_gradient_precision_t   precision);
+void            pixman_image_set_separable_precision (pixman_image_t               *image,
+						      pixman_separable_precision_t  precision);
 void		pixman_image_set_source_clipping     (pixman_image_t		   *image,
 						      pixman_bool_t                 source_clipping);
 void            pixman_image_set_alpha_map           (pixman_image_t               *image,
@@ -858,6 +935,32 @@ pixman_filter_create_separable_convolution (int             *n_values,
 					    int              subsample_bits_x,
 					    int              subsample_bits_y);
 
+/* A SEPARABLE_CONVOLUTION filter that can be set on any number of
+ * images without copying its parameters. The images keep a reference
+ * to the filter.
+ */
+typedef struct pixman_separable_filter_t pixman_separable_filter_t;
+
+pixman_separable_filter_t *
+pixman_separable_filter_create (pixman_fixed_t   scale_x,
+				pixman_fixed_t   scale_y,
+				pixman_kernel_t  reconstruct_x,
+				pixman_kernel_t  reconstruct_y,
+				pixman_kernel_t  sample_x,
+				pixman_kernel_t  sample_y,
+				int              subsample_bits_x,
+				int              subsample_bits_y);
+pixman_separable_filter_t *
+pixman_separable_filter_ref        (pixman_separable_filter_t *filter);
+pixman_bool_t
+pixman_separable_filter_unref      (pixman_separable_filter_t *filter);
+const pixman_fixed_t *
+pixman_separable_filter_get_params (pixman_separable_filter_t *filter,
+				    int                       *n_params);
+pixman_bool_t
+pixman_image_set_separable_filter  (pixman_image_t            *image,
+				    pixman_separable_filter_t *filter);
+
 pixman_bool_t	pixman_image_fill_rectangles	     (pixman_op_t		    op,
 						      pixman_image_t		   *image,
 						      const pixman_color_t	   *color,
@@ -907,6 +1010,136 @@ void          pixman_image_composite32        (pixman_op_t        op,
 					       int32_t            width,
 					       int32_t            height);
 
+/* Composites each of the rectangles with the same operator and images.
+ * This gives the same result as calling pixman_image_composite32() for
+ * each rectangle in turn, but the images are only analyzed once.
+ */
+typedef struct pixman_composite_rect pixman_composite_rect_t;
+
+struct pixman_composite_rect
+{
+    int32_t		src_x, src_y;
+    int32_t		mask_x, mask_y;
+    int32_t		dest_x, dest_y;
+    int32_t		width, height;
+};
+
+void          pixman_composite_batch          (pixman_op_t                    op,
+					       pixman_image_t                *src,
+					       pixman_image_t                *mask,
+					       pixman_image_t                *dest,
+					       int                            n_rects,
+					       const pixman_composite_rect_t *rects);
+
+/*
+ * Streaming stores
+ *
+ * Fills and copies that write at least n_bytes bytes of destination in
+ * a single call bypass the CPU caches where the hardware allows it. This
+ * is faster for destinations that don't fit in the cache anyway and keeps
+ * the rest of the working set cached, but it is slower when the
+ * destination is read again soon after. A value of zero or less turns
+ * streaming stores off; the default is 8 MB. Like pixman_set_thread_pool(),
+ * this function is not thread safe.
+ */
+void          pixman_set_streaming_threshold  (int                n_bytes);
+
+/*
+ * Parallel compositing
+ *
+ * pixman never creates threads itself. An application that wants large
+ * composites spread over several cores registers a function that calls
+ * job_func (job_data, i) for each i in [0, n_jobs), possibly concurrently,
+ * and returns once all of the calls have finished. Composites covering at
+ * least 'threshold' destination pixels are then split into bands of rows
+ * that are handed out as jobs; smaller ones run on the calling thread.
+ *
+ * Passing a NULL run_jobs function or fewer than two threads turns
+ * parallel compositing off again, which is the default. A threshold of
+ * zero or less selects a default value. This function is not thread safe
+ * and must not be called while other threads are compositing.
+ */
+typedef void (* pixman_job_func_t)      (void              *job_data,
+					 int                job);
+typedef void (* pixman_run_jobs_func_t) (void              *pool_data,
+					 int                n_jobs,
+					 pixman_job_func_t  job_func,
+					 void              *job_data);
+
+void          pixman_set_thread_pool          (pixman_run_jobs_func_t run_jobs,
+					       void              *pool_data,
+					       int                n_threads,
+					       int                threshold);
+
+/*
+ * Implementation selection
+ *
+ * pixman stacks a number of implementations ("general", "fast", "mmx",
+ * "sse2", "ssse3", "avx2", "arm-simd", "arm-iwmmxt", "arm-neon", "vmx",
+ * "loongson-mmi", "mips-dspr2") on top of each other, depending on what
+ * the CPU supports, with "noop" always on top. Each composite is handled
+ * by the topmost implementation that has a fast path for it.
+ *
+ * pixman_get_implementations() stores the names of at most n_names
+ * implementations of the chain in use, topmost first, and returns the
+ * length of the whole chain.
+ *
+ * pixman_set_implementations() switches to a chain that has no
+ * implementations above 'top' and none of the ones in 'exclude', a list
+ * separated by spaces or commas. Either may be NULL; passing NULL for
+ * both goes back to the default chain. Implementations listed in the
+ * PIXMAN_DISABLE environment variable stay disabled in any case. If 'top'
+ * is not available, nothing changes and FALSE is returned. Composites
+ * that are running on other threads finish on the old chain, but this
+ * function must not be called from several threads at once.
+ */
+int           pixman_get_implementations      (const char       **names,
+					       int                n_names);
+pixman_bool_t pixman_set_implementations      (const char        *top,
+					       const char        *exclude);
+
+/*
+ * Composite paths
+ *
+ * A composite path describes a composite the way pixman looks it up:
+ * the operator after simplification, the formats, which include some
+ * internal pseudo formats for solid images and the like, and flags
+ * describing the images and the part of them that is used. The flags are
+ * internal to pixman and only meaningful to pixman_lookup_composite_path()
+ * in the same version of the library.
+ *
+ * pixman_lookup_composite_path() fills in the name of the implementation
+ * and the function that the current chain uses for the op, formats and
+ * flags in 'path'.
+ *
+ * pixman_set_composite_trace() registers a function that is called with
+ * the path of every composite, from the thread doing it, just before it
+ * is run. A composite whose implementation is "general" is not handled
+ * by any fast path. Passing NULL turns tracing off again, which is the
+ * default. This function is not thread safe.
+ */
+typedef struct pixman_composite_path pixman_composite_path_t;
+struct pixman_composite_path
+{
+    pixman_op_t			op;
+    pixman_format_code_t	src_format;
+    uint32_t			src_flags;
+    pixman_format_code_t	mask_format;
+    uint32_t			mask_flags;
+    pixman_format_code_t	dest_format;
+    uint32_t			dest_flags;
+
+    const char *		implementation;
+    void		     (* func) (void);
+};
+
+typedef void (* pixman_composite_trace_func_t) (const pixman_composite_path_t *path,
+						void                          *data);
+
+pixman_bool_t pixman_lookup_composite_path    (pixman_composite_path_t *path);
+void          pixman_set_composite_trace      (pixman_composite_trace_func_t func,
+					       void              *data);
+
 /* Executive Summary: This function is a no-op that only exists
  * for historical reasons.
  *
@@ -937,8 +1170,46 @@ typedef struct
     const void *glyph;
 } pixman_glyph_t;
 
+/* A glyph at a fixed point position, see pixman_glyph_resolve_fixed() */
+typedef struct
+{
+    pixman_fixed_t	x, y;
+    const void *	glyph;
+} pixman_glyph_fixed_t;
+
+/* Renders the variant of a glyph that is shifted right by
+ * phase / n_phases of a pixel. The cache copies the returned image and
+ * then drops the reference to it. NULL means there is no such variant.
+ */
+typedef pixman_image_t *(* pixman_glyph_render_func_t) (void *font_key,
+							 void *glyph_key,
+							 int   phase,
+							 int   n_phases,
+							 int  *origin_x,
+							 int  *origin_y,
+							 void *data);
+
+typedef struct
+{
+    int		n_glyphs;
+    uint64_t	size;		/* bytes */
+    uint64_t	n_hits;
+    uint64_t	n_misses;
+    uint64_t	n_evictions;
+} pixman_glyph_cache_stats_t;
+
 pixman_glyph_cache_t *pixman_glyph_cache_create       (void);
 void                  pixman_glyph_cache_destroy      (pixman_glyph_cache_t *cache);
+void                  pixman_glyph_cache_set_atlas    (pixman_glyph_cache_t *cache,
+						       pixman_bool_t         atlas);
+void                  pixman_glyph_cache_set_budget   (pixman_glyph_cache_t *cache,
+						       uint64_t              n_bytes);
+void                  pixman_glyph_cache_get_stats    (pixman_glyph_cache_t *cache,
+						       pixman_glyph_cache_stats_t *stats);
+void                  pixman_glyph_cache_set_subpixel (pixman_glyph_cache_t *cache,
+						       int                   n_phases,
+						       pixman_glyph_render_func_t render,
+						       void                 *data);
 void                  pixman_glyph_cache_freeze       (pixman_glyph_cache_t *cache);
 void                  pixman_glyph_cache_thaw         (pixman_glyph_cache_t *cache);
 const void *          pixman_glyph_cache_lookup       (pixman_glyph_cache_t *cache,
@@ -950,9 +1221,24 @@ const void *          pixman_glyph_cache_insert       (pixman_glyph_cache_t *cac
 						       int		     origin_x,
 						       int                   origin_y,
 						       pixman_image_t       *glyph_image);
+const void *          pixman_glyph_cache_lookup_phase (pixman_glyph_cache_t *cache,
+						       void                 *font_key,
+						       void                 *glyph_key,
+						       int                   phase);
+const void *          pixman_glyph_cache_insert_phase (pixman_glyph_cache_t *cache,
+						       void                 *font_key,
+						       void                 *glyph_key,
+						       int                   phase,
+						       int		     origin_x,
+						       int                   origin_y,
+						       pixman_image_t       *glyph_image);
 void                  pixman_glyph_cache_remove       (pixman_glyph_cache_t *cache,
 						       void                 *font_key,
 						       void                 *glyph_key);
+void                  pixman_glyph_resolve_fixed      (pixman_glyph_cache_t *cache,
+						       int                   n_glyphs,
+						       const pixman_glyph_fixed_t *glyphs,
+						       pixman_glyph_t       *resolved);
 void                  pixman_glyph_get_extents        (pixman_glyph_cache_t *cache,
 						       int                   n_glyphs,
 						       pixman_glyph_t       *glyphs,
@@ -985,6 +1271,31 @@ void                  pixman_composite_glyphs_no_mask (pixman_op_t           op,
 						       pixman_glyph_cache_t *cache,
 						       int		     n_glyphs,
 						       const pixman_glyph_t *glyphs);
+void                  pixman_composite_glyphs_fixed   (pixman_op_t           op,
+						       pixman_image_t       *src,
+						       pixman_image_t       *dest,
+						       pixman_format_code_t  mask_format,
+						       int32_t               src_x,
+						       int32_t               src_y,
+						       int32_t		     mask_x,
+						       int32_t		     mask_y,
+						       int32_t               dest_x,
+						       int32_t               dest_y,
+						       int32_t		     width,
+						       int32_t		     height,
+						       pixman_glyph_cache_t *cache,
+						       int		     n_glyphs,
+						       const pixman_glyph_fixed_t *glyphs);
+void                  pixman_composite_glyphs_no_mask_fixed (pixman_op_t     op,
+						       pixman_image_t       *src,
+						       pixman_image_t       *dest,
+						       int32_t               src_x,
+						       int32_t               src_y,
+						       int32_t               dest_x,
+						       int32_t               dest_y,
+						       pixman_glyph_cache_t *cache,
+						       int		     n_glyphs,
+						       const pixman_glyph_fixed_t *glyphs);
 
 /*
  * Trapezoids
@@ -1106,6 +1417,27 @@ void	      pixman_add_triangles       (pixman_image_t              *image,
 					  int	                       n_tris,
 					  const pixman_triangle_t     *tris);
 
+/*
+ * Polygons
+ */
+typedef enum
+{
+    PIXMAN_FILL_RULE_WINDING,
+    PIXMAN_FILL_RULE_EVEN_ODD
+} pixman_fill_rule_t;
+
+void          pixman_composite_polygon   (pixman_op_t                  op,
+					  pixman_image_t              *src,
+					  pixman_image_t              *dst,
+					  pixman_fill_rule_t           fill_rule,
+					  int                          x_src,
+					  int                          y_src,
+					  int                          x_dst,
+					  int                          y_dst,
+					  int                          n_contours,
+					  const int                   *n_points,
+					  const pixman_point_fixed_t  *points);
+
 PIXMAN_END_DECLS
 
 #endif /* PIXMAN_H__ */
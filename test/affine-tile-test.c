@@ -0,0 +1,134 @@
+/*
+ * Check that compositing a rotated image onto a wide destination, which
+ * the general implementation does in tiles, gives exactly the same
+ * results as compositing every destination pixel on its own.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "utils.h"
+
+#define MAX_SRC_WIDTH	96
+#define MAX_SRC_HEIGHT	96
+#define MIN_DST_WIDTH	65
+#define MAX_DST_WIDTH	200
+#define MAX_DST_HEIGHT	80
+#define N_TESTS		150
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+};
+
+static const pixman_filter_t filters[] =
+{
+    PIXMAN_FILTER_NEAREST,
+    PIXMAN_FILTER_BILINEAR,
+};
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+    PIXMAN_REPEAT_REFLECT,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_bool_t
+test_tiles (int testnum)
+{
+    pixman_image_t *src, *mask, *dest1, *dest2;
+    pixman_transform_t t;
+    pixman_op_t op;
+    double angle;
+    int width, height, x, y;
+    pixman_bool_t ok;
+
+    prng_srand (testnum);
+
+    src = make_random_image (RANDOM_ELT (formats),
+			     prng_rand_n (MAX_SRC_WIDTH) + 1,
+			     prng_rand_n (MAX_SRC_HEIGHT) + 1, FALSE);
+
+    angle = prng_rand_n (3600) * (2 * M_PI / 3600);
+    pixman_transform_init_rotate (&t,
+				  pixman_double_to_fixed (cos (angle)),
+				  pixman_double_to_fixed (sin (angle)));
+    pixman_transform_translate (&t, NULL,
+				pixman_int_to_fixed (prng_rand_n (64)) - pixman_fixed_1 * 32,
+				pixman_int_to_fixed (prng_rand_n (64)) - pixman_fixed_1 * 32);
+    if (prng_rand_n (2))
+    {
+	pixman_transform_scale (&t, NULL,
+				pixman_fixed_1 / 2 + prng_rand_n (pixman_fixed_1),
+				pixman_fixed_1 / 2 + prng_rand_n (pixman_fixed_1));
+    }
+
+    pixman_image_set_transform (src, &t);
+    pixman_image_set_filter (src, RANDOM_ELT (filters), NULL, 0);
+    pixman_image_set_repeat (src, RANDOM_ELT (repeats));
+
+    width = MIN_DST_WIDTH + prng_rand_n (MAX_DST_WIDTH - MIN_DST_WIDTH + 1);
+    height = prng_rand_n (MAX_DST_HEIGHT) + 1;
+
+    mask = NULL;
+    if (prng_rand_n (3) == 0)
+	mask = make_random_image (PIXMAN_a8, width, height, FALSE);
+
+    dest1 = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+    dest2 = clone_image (dest1);
+
+    op = RANDOM_ELT (ops);
+
+    pixman_image_composite32 (op, src, mask, dest1,
+			      0, 0, 0, 0, 0, 0, width, height);
+
+    for (y = 0; y < height; ++y)
+    {
+	for (x = 0; x < width; ++x)
+	{
+	    pixman_image_composite32 (op, src, mask, dest2,
+				      x, y, x, y, x, y, 1, 1);
+	}
+    }
+
+    ok = compare_images (dest1, dest2, 0);
+    if (!ok)
+	printf ("test %d: tiled composite differs (%s)\n",
+		testnum, operator_name (op));
+
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (dest1);
+    pixman_image_unref (dest2);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_tiles (i))
+	    n_failed++;
+    }
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Check that pixman_composite_batch() gives the same results as calling
+ * pixman_image_composite32() for each rectangle in turn.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define WIDTH		64
+#define HEIGHT		64
+#define MAX_RECTS	32
+#define N_TESTS		2000
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_OUT_REVERSE,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_bool_t
+test_batch (int testnum)
+{
+    pixman_composite_rect_t rects[MAX_RECTS];
+    pixman_image_t *src, *mask, *dest1, *dest2;
+    pixman_format_code_t dest_format;
+    pixman_op_t op;
+    pixman_bool_t ok;
+    int i, n_rects;
+
+    prng_srand (testnum);
+
+    src = make_random_image (RANDOM_ELT (formats), WIDTH, HEIGHT, FALSE);
+    if (prng_rand_n (2))
+	pixman_image_set_repeat (src, PIXMAN_REPEAT_NORMAL);
+
+    mask = NULL;
+    if (prng_rand_n (3) == 0)
+	mask = make_random_image (PIXMAN_a8, WIDTH, HEIGHT, FALSE);
+
+    dest_format = RANDOM_ELT (formats);
+    dest1 = make_random_image (dest_format, WIDTH, HEIGHT, FALSE);
+    dest2 = clone_image (dest1);
+
+    if (prng_rand_n (2))
+    {
+	pixman_region32_t clip;
+
+	pixman_region32_init_rect (&clip, 5, 5, WIDTH / 2, HEIGHT);
+	pixman_region32_union_rect (&clip, &clip, 0, HEIGHT / 2, WIDTH, 10);
+	pixman_image_set_clip_region32 (dest1, &clip);
+	pixman_image_set_clip_region32 (dest2, &clip);
+	pixman_region32_fini (&clip);
+    }
+
+    op = RANDOM_ELT (ops);
+    n_rects = prng_rand_n (MAX_RECTS + 1);
+
+    /* Some rectangles will stick out of the images or overlap */
+    for (i = 0; i < n_rects; ++i)
+    {
+	rects[i].src_x = prng_rand_n (WIDTH + 16) - 8;
+	rects[i].src_y = prng_rand_n (HEIGHT + 16) - 8;
+	rects[i].mask_x = prng_rand_n (WIDTH);
+	rects[i].mask_y = prng_rand_n (HEIGHT);
+	rects[i].dest_x = prng_rand_n (WIDTH + 16) - 8;
+	rects[i].dest_y = prng_rand_n (HEIGHT + 16) - 8;
+	rects[i].width = prng_rand_n (WIDTH / 2);
+	rects[i].height = prng_rand_n (HEIGHT / 2);
+    }
+
+    for (i = 0; i < n_rects; ++i)
+    {
+	pixman_image_composite32 (op, src, mask, dest1,
+				  rects[i].src_x, rects[i].src_y,
+				  rects[i].mask_x, rects[i].mask_y,
+				  rects[i].dest_x, rects[i].dest_y,
+				  rects[i].width, rects[i].height);
+    }
+
+    pixman_composite_batch (op, src, mask, dest2, n_rects, rects);
+
+    ok = compare_images (dest1, dest2, 0);
+    if (!ok)
+	printf ("test %d: batch differs (%s)\n", testnum, operator_name (op));
+
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (dest1);
+    pixman_image_unref (dest2);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_batch (i))
+	    n_failed++;
+    }
+
+    return n_failed ? 1 : 0;
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <float.h>
 #include "utils.h"
 #include <sys/types.h>
 #include "pixman-private.h"
@@ -88,6 +90,25 @@ random_floats (argb_t *argb, int width)
     }
 }
 
+/* Colors from 0 to 1 with alpha at least as large, which is what the
+ * combiners usually see.
+ */
+static void
+random_colors (argb_t *argb, int width)
+{
+    int i;
+
+    for (i = 0; i < width; ++i)
+    {
+	argb_t *p = argb + i;
+
+	p->a = prng_rand_n (1001) / 1000.0f;
+	p->r = p->a * (prng_rand_n (1001) / 1000.0f);
+	p->g = p->a * (prng_rand_n (1001) / 1000.0f);
+	p->b = p->a * (prng_rand_n (1001) / 1000.0f);
+    }
+}
+
 #define WIDTH	512
 
 static pixman_combine_float_func_t
@@ -110,6 +131,83 @@ lookup_combiner (pixman_implementation_t *imp, pixman_op_t op,
     return f;
 }
 
+/* Only when float arithmetic is done in single precision, one
+ * operation at a time, can the SIMD combiners give exactly the results
+ * of the C ones.
+ */
+#if FLT_EVAL_METHOD == 0 && !defined (__FP_FAST_FMAF)
+#define EXACT_FLOAT	TRUE
+#else
+#define EXACT_FLOAT	FALSE
+#endif
+
+static pixman_bool_t
+same_float (float a, float b)
+{
+    /* NaN payloads can depend on the order of operands */
+    if (a != a && b != b)
+	return TRUE;
+
+    return memcmp (&a, &b, sizeof (float)) == 0;
+}
+
+/* The float combiners of every implementation must give the same results
+ * as the C ones in the general implementation.
+ */
+static pixman_bool_t
+compare_combiners (pixman_implementation_t *impl, pixman_op_t op,
+		   pixman_bool_t component_alpha, pixman_bool_t use_mask,
+		   const argb_t *src, const argb_t *mask, const argb_t *dest,
+		   int width)
+{
+    pixman_combine_float_func_t reference, f;
+    pixman_implementation_t *imp;
+    argb_t expected[WIDTH], result[WIDTH];
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    for (imp = impl; imp->fallback; imp = imp->fallback)
+	;
+    reference = lookup_combiner (imp, op, component_alpha);
+
+    memcpy (expected, dest, sizeof (expected));
+    reference (imp, op, (float *)expected, (float *)src,
+	       use_mask ? (float *)mask : NULL, width);
+
+    for (imp = impl; imp->fallback; imp = imp->fallback)
+    {
+	f = component_alpha ? imp->combine_float_ca[op] : imp->combine_float[op];
+	if (!f)
+	    continue;
+
+	memcpy (result, dest, sizeof (result));
+	f (imp, op, (float *)result, (float *)src,
+	   use_mask ? (float *)mask : NULL, width);
+
+	for (i = 0; i < WIDTH; ++i)
+	{
+	    if (!same_float (expected[i].a, result[i].a) ||
+		!same_float (expected[i].r, result[i].r) ||
+		!same_float (expected[i].g, result[i].g) ||
+		!same_float (expected[i].b, result[i].b))
+	    {
+		printf ("%s: %s%s%s differs at %d: "
+			"%g %g %g %g instead of %g %g %g %g\n",
+			imp->name, operator_name (op),
+			component_alpha ? " ca" : "",
+			use_mask ? " with mask" : "", i,
+			result[i].a, result[i].r, result[i].g, result[i].b,
+			expected[i].a, expected[i].r, expected[i].g,
+			expected[i].b);
+		ok = FALSE;
+		break;
+	    }
+	}
+    }
+
+    return ok;
+}
+
 int
 main ()
 {
@@ -117,7 +215,7 @@ main ()
     argb_t *src_bytes = malloc (WIDTH * sizeof (argb_t));
     argb_t *mask_bytes = malloc (WIDTH * sizeof (argb_t));
     argb_t *dest_bytes = malloc (WIDTH * sizeof (argb_t));
-    int i;
+    int i, n_failed = 0;
 
     enable_divbyzero_exceptions();
     
@@ -144,8 +242,35 @@ main ()
 		      (float *)mask_bytes,
 		      (float *)src_bytes,
 		      WIDTH);
+
+	    if (!EXACT_FLOAT)
+		continue;
+
+	    random_floats (src_bytes, WIDTH);
+	    random_floats (mask_bytes, WIDTH);
+	    random_floats (dest_bytes, WIDTH);
+
+	    if (!compare_combiners (impl, op, ca, TRUE,
+				    src_bytes, mask_bytes, dest_bytes, WIDTH))
+	    {
+		n_failed++;
+	    }
+
+	    random_colors (src_bytes, WIDTH);
+	    random_colors (mask_bytes, WIDTH);
+	    random_colors (dest_bytes, WIDTH);
+
+	    /* An odd width, so the pixels beyond it must be left alone */
+	    if (!compare_combiners (impl, op, ca, TRUE,
+				    src_bytes, mask_bytes, dest_bytes, WIDTH) ||
+		!compare_combiners (impl, op, ca, FALSE,
+				    src_bytes, mask_bytes, dest_bytes,
+				    WIDTH - 1))
+	    {
+		n_failed++;
+	    }
 	}
     }	
 
-    return 0;
+    return n_failed ? 1 : 0;
 }
@@ -0,0 +1,212 @@
+/*
+ * Check dithered stores: every implementation must give exactly the
+ * same results as the general implementation, which dithers in the
+ * store of the destination. Also check that over a whole matrix the
+ * dithered values average out to the undithered color.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	80
+#define MAX_HEIGHT	12
+#define MAX_IMPS	32
+#define N_TESTS		3000
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_r5g6b5,
+    PIXMAN_b5g6r5,
+    PIXMAN_a4r4g4b4,
+    PIXMAN_x4r4g4b4,
+    PIXMAN_a1r5g5b5,
+    PIXMAN_x1r5g5b5,
+    PIXMAN_r3g3b2,
+    PIXMAN_a4,
+};
+
+static const pixman_format_code_t src_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a8b8g8r8,
+    PIXMAN_x8b8g8r8,
+};
+
+static const pixman_dither_t modes[] =
+{
+    PIXMAN_DITHER_FAST,
+    PIXMAN_DITHER_GOOD,
+    PIXMAN_DITHER_BEST,
+    PIXMAN_DITHER_ORDERED_BAYER_8,
+    PIXMAN_DITHER_ORDERED_BLUE_NOISE_64,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_image_t *
+clone_dithered (pixman_image_t *image, pixman_dither_t dither, int ox, int oy)
+{
+    pixman_image_t *clone = clone_image (image);
+
+    pixman_image_set_dither (clone, dither);
+    pixman_image_set_dither_offset (clone, ox, oy);
+
+    return clone;
+}
+
+static pixman_bool_t
+test_composite (int testnum, const char **imps, int n_imps)
+{
+    pixman_format_code_t src_format, dest_format;
+    pixman_image_t *src, *reference, *dest;
+    int width, height, dest_x, dest_y, ox, oy, i;
+    pixman_dither_t dither;
+    pixman_bool_t ok = TRUE;
+    pixman_op_t op;
+
+    prng_srand (testnum);
+
+    op = prng_rand_n (2) ? PIXMAN_OP_SRC : PIXMAN_OP_OVER;
+    src_format = RANDOM_ELT (src_formats);
+    dest_format = RANDOM_ELT (dest_formats);
+    dither = RANDOM_ELT (modes);
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+    dest_x = prng_rand_n (8);
+    dest_y = prng_rand_n (8);
+    ox = prng_rand_n (2) ? prng_rand_n (200) - 100 : 0;
+    oy = prng_rand_n (2) ? prng_rand_n (200) - 100 : 0;
+
+    /* Mostly the fast path formats */
+    if (prng_rand_n (2))
+    {
+	dest_format = (src_format == PIXMAN_a8r8g8b8 ||
+		       src_format == PIXMAN_x8r8g8b8) ?
+	    PIXMAN_r5g6b5 : PIXMAN_b5g6r5;
+    }
+
+    src = make_random_image (src_format, width, height, TRUE);
+    dest = make_random_image (dest_format,
+			      dest_x + width, dest_y + height, TRUE);
+    reference = clone_dithered (dest, dither, ox, oy);
+
+    pixman_set_implementations ("general", NULL);
+    pixman_image_composite32 (op, src, NULL, reference,
+			      0, 0, 0, 0, dest_x, dest_y, width, height);
+
+    for (i = 0; i < n_imps && ok; ++i)
+    {
+	pixman_image_t *d = clone_dithered (dest, dither, ox, oy);
+
+	pixman_set_implementations (imps[i], NULL);
+	pixman_image_composite32 (op, src, NULL, d,
+				  0, 0, 0, 0, dest_x, dest_y, width, height);
+
+	if (!compare_images (reference, d, 0))
+	{
+	    printf ("test %d: %s differs from general (%s, %s -> %s, dither %d)\n",
+		    testnum, imps[i], operator_name (op),
+		    format_name (src_format), format_name (dest_format), dither);
+	    ok = FALSE;
+	}
+
+	pixman_image_unref (d);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (reference);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+/* A solid color dithered over one whole matrix must average to the color,
+ * for every 8 bit value of the red, green and blue channels.
+ */
+static pixman_bool_t
+test_average (pixman_dither_t dither)
+{
+    pixman_image_t *src, *dest;
+    pixman_bool_t ok = TRUE;
+    int c, i;
+
+    src = make_random_image (PIXMAN_x8r8g8b8, 64, 64, FALSE);
+    dest = make_random_image (PIXMAN_r5g6b5, 64, 64, FALSE);
+    pixman_image_set_dither (dest, dither);
+
+    for (c = 0; c < 256; ++c)
+    {
+	uint32_t *s = pixman_image_get_data (src);
+	uint16_t *d = (uint16_t *)pixman_image_get_data (dest);
+	double r = 0, g = 0, b = 0;
+
+	for (i = 0; i < 64 * 64; ++i)
+	    s[i] = c * 0x010101;
+
+	pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+				  0, 0, 0, 0, 0, 0, 64, 64);
+
+	for (i = 0; i < 64 * 64; ++i)
+	{
+	    r += d[i] >> 11;
+	    g += (d[i] >> 5) & 0x3f;
+	    b += d[i] & 0x1f;
+	}
+
+	r = r / (64 * 64) - c * 31 / 255.0;
+	g = g / (64 * 64) - c * 63 / 255.0;
+	b = b / (64 * 64) - c * 31 / 255.0;
+
+	if (r < -0.02 || r > 0.02 || g < -0.02 || g > 0.02 ||
+	    b < -0.02 || b > 0.02)
+	{
+	    printf ("dither %d: the average of %d is off by %f %f %f\n",
+		    dither, c, r, g, b);
+	    ok = FALSE;
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *imps[ARRAY_LENGTH (candidates) + 1];
+    int n_names, n_imps = 0;
+    int i, j, n_failed = 0;
+
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		imps[n_imps++] = candidates[i];
+	}
+    }
+
+    prng_srand (0);
+
+    if (!test_average (PIXMAN_DITHER_ORDERED_BAYER_8))
+	n_failed++;
+    if (!test_average (PIXMAN_DITHER_ORDERED_BLUE_NOISE_64))
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i, imps, n_imps))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,283 @@
+/*
+ * Check that separable convolution filters come out the same whether
+ * they are computed or found in the kernel cache, that the filters of
+ * large downscales are found there too, and that a filter
+ * object set on several images filters them like its parameters do.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+#include "pixman-private.h"
+
+#define N_FILTERS	24
+#define N_ROUNDS	4
+#define WIDTH		40
+#define HEIGHT		30
+
+typedef struct
+{
+    pixman_fixed_t	scale_x, scale_y;
+    pixman_kernel_t	kernels[4];
+    int			bits_x, bits_y;
+} filter_spec_t;
+
+static pixman_fixed_t *
+create_filter (const filter_spec_t *f, int *n_values)
+{
+    return pixman_filter_create_separable_convolution (
+	n_values, f->scale_x, f->scale_y,
+	f->kernels[0], f->kernels[1], f->kernels[2], f->kernels[3],
+	f->bits_x, f->bits_y);
+}
+
+static void
+random_spec (filter_spec_t *f)
+{
+    int i;
+
+    /* A few large filters, which push others out of the cache */
+    if (prng_rand_n (6) == 0)
+	f->scale_x = pixman_double_to_fixed (10 + prng_rand_n (20));
+    else
+	f->scale_x = pixman_double_to_fixed (0.5 + prng_rand_n (80) / 10.0);
+
+    f->scale_y = prng_rand_n (2) ? f->scale_x : pixman_fixed_1 * 2;
+
+    for (i = 0; i < 4; ++i)
+	f->kernels[i] = prng_rand_n (PIXMAN_KERNEL_LANCZOS3_STRETCHED + 1);
+
+    f->bits_x = prng_rand_n (5);
+    f->bits_y = prng_rand_n (5);
+}
+
+static pixman_bool_t
+test_kernel_cache (void)
+{
+    filter_spec_t specs[N_FILTERS];
+    pixman_fixed_t *first[N_FILTERS];
+    int n_first[N_FILTERS];
+    pixman_bool_t ok = TRUE;
+    int i, j;
+
+    prng_srand (0);
+
+    for (i = 0; i < N_FILTERS; ++i)
+    {
+	random_spec (&specs[i]);
+	first[i] = create_filter (&specs[i], &n_first[i]);
+    }
+
+    /* There are more filters than cache entries, so in later rounds
+     * some are found in the cache and some are computed again.
+     */
+    for (j = 0; j < N_ROUNDS * N_FILTERS; ++j)
+    {
+	pixman_fixed_t *params;
+	int n;
+
+	i = prng_rand_n (prng_rand_n (2) ? 4 : N_FILTERS);
+	params = create_filter (&specs[i], &n);
+
+	if (n != n_first[i] ||
+	    memcmp (params, first[i], n * sizeof (pixman_fixed_t)) != 0)
+	{
+	    printf ("filter %d is different the second time\n", i);
+	    ok = FALSE;
+	}
+
+	free (params);
+    }
+
+    for (i = 0; i < N_FILTERS; ++i)
+	free (first[i]);
+
+    return ok;
+}
+
+/* Downscales by 4 with LANCZOS3 and CUBIC, which are too large for a
+ * cache with a fixed number of values per filter.
+ */
+static pixman_bool_t
+test_large_filters (void)
+{
+    static const filter_spec_t specs[] =
+    {
+	{ pixman_fixed_1 * 4, pixman_fixed_1 * 4,
+	  { PIXMAN_KERNEL_BOX, PIXMAN_KERNEL_BOX,
+	    PIXMAN_KERNEL_LANCZOS3, PIXMAN_KERNEL_LANCZOS3 },
+	  4, 4 },
+	{ pixman_fixed_1 * 4, pixman_fixed_1 * 4,
+	  { PIXMAN_KERNEL_BOX, PIXMAN_KERNEL_BOX,
+	    PIXMAN_KERNEL_CUBIC, PIXMAN_KERNEL_CUBIC },
+	  4, 4 },
+    };
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    for (i = 0; i < ARRAY_LENGTH (specs); ++i)
+    {
+	pixman_fixed_t *first, *second;
+	uint32_t hits;
+	int n_first, n_second;
+
+	first = create_filter (&specs[i], &n_first);
+	hits = _pixman_internal_only_get_kernel_cache_hits ();
+	second = create_filter (&specs[i], &n_second);
+
+	/* 25 x 16 and 17 x 16 values, in each direction */
+	if (n_first != 4 + 2 * (i ? 17 : 25) * 16)
+	{
+	    printf ("large filter %d has %d values\n", i, n_first);
+	    ok = FALSE;
+	}
+
+	/* One hit in each direction */
+	if (_pixman_internal_only_get_kernel_cache_hits () != hits + 2)
+	{
+	    printf ("large filter %d was not found in the cache\n", i);
+	    ok = FALSE;
+	}
+
+	if (n_first != n_second ||
+	    memcmp (first, second, n_first * sizeof (pixman_fixed_t)) != 0)
+	{
+	    printf ("large filter %d is different the second time\n", i);
+	    ok = FALSE;
+	}
+
+	free (first);
+	free (second);
+    }
+
+    return ok;
+}
+
+static pixman_image_t *
+make_image (uint32_t *bits)
+{
+    pixman_transform_t t;
+    pixman_image_t *image;
+
+    image = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, WIDTH, HEIGHT, bits, WIDTH * 4);
+
+    pixman_transform_init_scale (&t, pixman_double_to_fixed (2.5),
+				 pixman_double_to_fixed (1.5));
+    pixman_image_set_transform (image, &t);
+    pixman_image_set_repeat (image, PIXMAN_REPEAT_PAD);
+
+    return image;
+}
+
+static uint32_t *
+scale (pixman_image_t *src)
+{
+    uint32_t *bits = malloc (WIDTH * HEIGHT * 4);
+    pixman_image_t *dest;
+
+    memset (bits, 0, WIDTH * HEIGHT * 4);
+    dest = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, WIDTH, HEIGHT, bits, WIDTH * 4);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+			      0, 0, 0, 0, 0, 0, WIDTH, HEIGHT);
+
+    pixman_image_unref (dest);
+
+    return bits;
+}
+
+static pixman_bool_t
+test_filter_object (void)
+{
+    static const filter_spec_t spec =
+    {
+	pixman_fixed_1 * 5 / 2, pixman_fixed_1 * 3 / 2,
+	{ PIXMAN_KERNEL_LINEAR, PIXMAN_KERNEL_CUBIC,
+	  PIXMAN_KERNEL_BOX, PIXMAN_KERNEL_LANCZOS2 },
+	3, 2
+    };
+    pixman_separable_filter_t *filter;
+    pixman_image_t *reference, *images[2];
+    uint32_t *src_bits, *expected, *result;
+    const pixman_fixed_t *object_params;
+    pixman_fixed_t *params;
+    pixman_bool_t ok = TRUE;
+    int n, n_object, i;
+
+    prng_srand (1);
+    src_bits = (uint32_t *)make_random_bytes (WIDTH * HEIGHT * 4);
+
+    params = create_filter (&spec, &n);
+    filter = pixman_separable_filter_create (
+	spec.scale_x, spec.scale_y,
+	spec.kernels[0], spec.kernels[1], spec.kernels[2], spec.kernels[3],
+	spec.bits_x, spec.bits_y);
+
+    object_params = pixman_separable_filter_get_params (filter, &n_object);
+    if (n != n_object ||
+	memcmp (params, object_params, n * sizeof (pixman_fixed_t)) != 0)
+    {
+	printf ("filter object has different parameters\n");
+	ok = FALSE;
+    }
+
+    reference = make_image (src_bits);
+    pixman_image_set_filter (reference, PIXMAN_FILTER_SEPARABLE_CONVOLUTION,
+			     params, n);
+    expected = scale (reference);
+
+    for (i = 0; i < 2; ++i)
+    {
+	images[i] = make_image (src_bits);
+	pixman_image_set_separable_filter (images[i], filter);
+    }
+
+    /* The images keep the filter alive */
+    if (pixman_separable_filter_unref (filter))
+    {
+	printf ("filter freed while images use it\n");
+	ok = FALSE;
+    }
+
+    for (i = 0; i < 2; ++i)
+    {
+	result = scale (images[i]);
+	if (memcmp (expected, result, WIDTH * HEIGHT * 4) != 0)
+	{
+	    printf ("image %d is filtered differently\n", i);
+	    ok = FALSE;
+	}
+	free (result);
+    }
+
+    /* Replacing the filter releases it */
+    pixman_image_set_filter (images[0], PIXMAN_FILTER_NEAREST, NULL, 0);
+    pixman_image_unref (images[0]);
+    pixman_image_unref (images[1]);
+    pixman_image_unref (reference);
+
+    free (params);
+    free (expected);
+    fence_free (src_bits);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int n_failed = 0;
+
+    if (!test_kernel_cache ())
+	n_failed++;
+
+    if (!test_large_filters ())
+	n_failed++;
+
+    if (!test_filter_object ())
+	n_failed++;
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Check the atlas mode of the glyph cache: glyphs packed into shared
+ * pages must composite exactly like glyphs with an image of their own,
+ * and evicting whole pages must leave the remaining glyphs intact.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_GLYPHS	40
+#define N_TESTS		1000
+#define N_EVICT_GLYPHS	20000
+#define EVICT_BUDGET	(1024 * 1024)
+
+static const pixman_format_code_t glyph_formats[] =
+{
+    PIXMAN_a8,
+    PIXMAN_a8,
+    PIXMAN_a8r8g8b8,
+    PIXMAN_a4,
+    PIXMAN_a1,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_r8g8b8,
+};
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_op_t operators[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_IN,
+    PIXMAN_OP_OUT_REVERSE,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+#define KEY(i) ((void *)(uintptr_t)((i) + 1))
+
+static void
+composite (pixman_bool_t with_mask, pixman_op_t op, pixman_image_t *src,
+	   pixman_image_t *dest, pixman_format_code_t mask_format,
+	   pixman_glyph_cache_t *cache, int n_glyphs, pixman_glyph_t *glyphs)
+{
+    int width = pixman_image_get_width (dest);
+    int height = pixman_image_get_height (dest);
+
+    if (with_mask)
+    {
+	pixman_composite_glyphs (op, src, dest, mask_format,
+				 0, 0, 0, 0, 0, 0, width, height,
+				 cache, n_glyphs, glyphs);
+    }
+    else
+    {
+	pixman_composite_glyphs_no_mask (op, src, dest, 0, 0, 0, 0,
+					 cache, n_glyphs, glyphs);
+    }
+}
+
+static pixman_bool_t
+test_glyphs (int testnum)
+{
+    pixman_image_t *images[MAX_GLYPHS];
+    pixman_glyph_t plain[4 * MAX_GLYPHS], packed[4 * MAX_GLYPHS];
+    pixman_glyph_cache_t *plain_cache, *atlas_cache;
+    pixman_image_t *src, *dest, *reference;
+    pixman_format_code_t mask_format;
+    pixman_box32_t e1, e2;
+    pixman_bool_t with_mask, ok = TRUE;
+    int n_glyphs, n_runs, i;
+    pixman_op_t op;
+
+    prng_srand (testnum);
+
+    plain_cache = pixman_glyph_cache_create ();
+    atlas_cache = pixman_glyph_cache_create ();
+    pixman_glyph_cache_set_atlas (atlas_cache, TRUE);
+
+    pixman_glyph_cache_freeze (plain_cache);
+    pixman_glyph_cache_freeze (atlas_cache);
+
+    n_glyphs = prng_rand_n (MAX_GLYPHS) + 1;
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	pixman_format_code_t format = RANDOM_ELT (glyph_formats);
+	int max_size = prng_rand_n (16) ? 40 : 160;
+
+	/* Glyphs of mixed formats need a mask of a common format */
+	if (i && prng_rand_n (4))
+	    format = pixman_image_get_format (images[0]);
+
+	images[i] = make_random_image (format, prng_rand_n (max_size) + 1,
+				       prng_rand_n (max_size) + 1, FALSE);
+
+	pixman_glyph_cache_insert (plain_cache, KEY (i), KEY (i), 5, 8, images[i]);
+	pixman_glyph_cache_insert (atlas_cache, KEY (i), KEY (i), 5, 8, images[i]);
+    }
+
+    n_runs = prng_rand_n (4 * MAX_GLYPHS) + 1;
+    for (i = 0; i < n_runs; ++i)
+    {
+	int g = prng_rand_n (n_glyphs);
+
+	plain[i].x = packed[i].x = prng_rand_n (160) - 16;
+	plain[i].y = packed[i].y = prng_rand_n (80) - 16;
+	plain[i].glyph = pixman_glyph_cache_lookup (plain_cache, KEY (g), KEY (g));
+	packed[i].glyph = pixman_glyph_cache_lookup (atlas_cache, KEY (g), KEY (g));
+    }
+
+    pixman_glyph_get_extents (plain_cache, n_runs, plain, &e1);
+    pixman_glyph_get_extents (atlas_cache, n_runs, packed, &e2);
+    mask_format = pixman_glyph_get_mask_format (plain_cache, n_runs, plain);
+
+    if (memcmp (&e1, &e2, sizeof (e1)) != 0 ||
+	mask_format != pixman_glyph_get_mask_format (atlas_cache, n_runs, packed))
+    {
+	printf ("test %d: extents or mask format differ\n", testnum);
+	ok = FALSE;
+    }
+
+    src = make_random_image (PIXMAN_a8r8g8b8, 200, 100, FALSE);
+    dest = make_random_image (RANDOM_ELT (dest_formats), 160, 80, FALSE);
+    reference = clone_image (dest);
+    op = RANDOM_ELT (operators);
+    with_mask = prng_rand_n (2);
+
+    composite (with_mask, op, src, reference, mask_format,
+	       plain_cache, n_runs, plain);
+    composite (with_mask, op, src, dest, mask_format,
+	       atlas_cache, n_runs, packed);
+
+    if (!compare_images (reference, dest, 0))
+    {
+	printf ("test %d: atlas glyphs differ (%s, %s, %s)\n", testnum,
+		with_mask ? "mask" : "no mask", operator_name (op),
+		format_name (pixman_image_get_format (dest)));
+	ok = FALSE;
+    }
+
+    pixman_glyph_cache_thaw (plain_cache);
+    pixman_glyph_cache_thaw (atlas_cache);
+
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	pixman_glyph_cache_remove (plain_cache, KEY (i), KEY (i));
+	pixman_glyph_cache_remove (atlas_cache, KEY (i), KEY (i));
+	pixman_image_unref (images[i]);
+    }
+
+    pixman_glyph_cache_destroy (plain_cache);
+    pixman_glyph_cache_destroy (atlas_cache);
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+    pixman_image_unref (reference);
+
+    return ok;
+}
+
+static uint8_t
+glyph_value (int i, int x, int y)
+{
+    return (i * 7 + x * 3 + y) & 0xff;
+}
+
+/* Fill an atlas cache with more glyphs than fit in its budget, so that
+ * thawing it evicts pages, and check what is left.
+ */
+static pixman_bool_t
+test_eviction (void)
+{
+    static const pixman_color_t white = { 0xffff, 0xffff, 0xffff, 0xffff };
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_glyph_cache_stats_t stats;
+    pixman_image_t *image, *src, *dest;
+    pixman_bool_t ok = TRUE;
+    int i, x, y, n_left = 0;
+
+    pixman_glyph_cache_set_atlas (cache, TRUE);
+    pixman_glyph_cache_set_budget (cache, EVICT_BUDGET);
+    pixman_glyph_cache_freeze (cache);
+
+    image = pixman_image_create_bits (PIXMAN_a8, 8, 12, NULL, -1);
+    for (i = 0; i < N_EVICT_GLYPHS; ++i)
+    {
+	uint8_t *bits = (uint8_t *)pixman_image_get_data (image);
+	int stride = pixman_image_get_stride (image);
+
+	for (y = 0; y < 12; ++y)
+	{
+	    for (x = 0; x < 8; ++x)
+		bits[y * stride + x] = glyph_value (i, x, y);
+	}
+
+	if (!pixman_glyph_cache_insert (cache, KEY (i), KEY (i), 0, 0, image))
+	{
+	    printf ("insertion of glyph %d failed\n", i);
+	    ok = FALSE;
+	    break;
+	}
+    }
+    pixman_image_unref (image);
+
+    pixman_glyph_cache_thaw (cache);
+
+    src = pixman_image_create_solid_fill (&white);
+    dest = pixman_image_create_bits (PIXMAN_a8, 8, 12, NULL, -1);
+
+    pixman_glyph_cache_freeze (cache);
+
+    for (i = 0; i < N_EVICT_GLYPHS && ok; ++i)
+    {
+	uint8_t *bits = (uint8_t *)pixman_image_get_data (dest);
+	int stride = pixman_image_get_stride (dest);
+	pixman_glyph_t glyph;
+
+	if (!(glyph.glyph = pixman_glyph_cache_lookup (cache, KEY (i), KEY (i))))
+	    continue;
+
+	n_left++;
+	glyph.x = glyph.y = 0;
+
+	pixman_composite_glyphs (PIXMAN_OP_SRC, src, dest, PIXMAN_a8,
+				 0, 0, 0, 0, 0, 0, 8, 12, cache, 1, &glyph);
+
+	for (y = 0; y < 12 && ok; ++y)
+	{
+	    for (x = 0; x < 8 && ok; ++x)
+	    {
+		if (bits[y * stride + x] != glyph_value (i, x, y))
+		{
+		    printf ("glyph %d is wrong after eviction\n", i);
+		    ok = FALSE;
+		}
+	    }
+	}
+    }
+
+    pixman_glyph_cache_thaw (cache);
+
+    /* Enough pages were evicted to get to half the budget */
+    pixman_glyph_cache_get_stats (cache, &stats);
+    if (n_left == 0 || stats.n_glyphs != n_left		||
+	stats.n_evictions != N_EVICT_GLYPHS - n_left	||
+	stats.size > EVICT_BUDGET / 2)
+    {
+	printf ("eviction kept %d glyphs in %d bytes\n", n_left,
+		(int)stats.size);
+	ok = FALSE;
+    }
+
+    pixman_glyph_cache_destroy (cache);
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    if (!test_eviction ())
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_glyphs (i))
+	    n_failed++;
+    }
+
+    return n_failed ? 1 : 0;
+}
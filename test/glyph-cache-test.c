@@ -0,0 +1,321 @@
+/*
+ * Check the bookkeeping of the glyph cache: it grows past any fixed
+ * number of glyphs, keeps to its budget in bytes, also when freezes
+ * overlap so that it is never thawed, and counts hits, misses and
+ * evictions. Also use one cache from several threads at once, each of
+ * them checking the glyphs it gets.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "utils.h"
+
+#define N_GROWTH_GLYPHS	50000
+#define N_KEYS		2000
+#define N_RUNS		64
+#define N_LOOKUPS	300
+#define THREAD_BUDGET	(64 * 1024)
+#define N_FROZEN_GLYPHS	40000
+#define FROZEN_BUDGET	(1024 * 1024)
+
+#define KEY(i) ((void *)(uintptr_t)((i) + 1))
+
+static uint8_t
+glyph_value (int i, int x, int y)
+{
+    return (i * 7 + x * 3 + y) & 0xff;
+}
+
+static int
+glyph_width (int i)
+{
+    return 4 + i % 13;
+}
+
+static int
+glyph_height (int i)
+{
+    return 6 + i % 9;
+}
+
+static pixman_image_t *
+make_glyph (int i)
+{
+    int width = glyph_width (i), height = glyph_height (i);
+    pixman_image_t *image;
+    uint8_t *bits;
+    int stride, x, y;
+
+    image = pixman_image_create_bits (PIXMAN_a8, width, height, NULL, -1);
+    bits = (uint8_t *)pixman_image_get_data (image);
+    stride = pixman_image_get_stride (image);
+
+    for (y = 0; y < height; ++y)
+    {
+	for (x = 0; x < width; ++x)
+	    bits[y * stride + x] = glyph_value (i, x, y);
+    }
+
+    return image;
+}
+
+static pixman_bool_t
+check_stats (const char *what, pixman_glyph_cache_t *cache,
+	     int n_glyphs, int size, int n_hits, int n_misses)
+{
+    pixman_glyph_cache_stats_t stats;
+
+    pixman_glyph_cache_get_stats (cache, &stats);
+
+    if (stats.n_glyphs != n_glyphs		||
+	stats.n_hits != (uint64_t)n_hits	||
+	stats.n_misses != (uint64_t)n_misses	||
+	stats.size != (uint64_t)size)
+    {
+	printf ("%s: %d glyphs in %d bytes, %d hits, %d misses\n", what,
+		stats.n_glyphs, (int)stats.size,
+		(int)stats.n_hits, (int)stats.n_misses);
+	return FALSE;
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+test_bookkeeping (void)
+{
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_glyph_cache_stats_t stats;
+    pixman_image_t *image;
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    pixman_glyph_cache_freeze (cache);
+
+    image = make_glyph (0);
+    pixman_glyph_cache_lookup (cache, KEY (0), KEY (0));
+    pixman_glyph_cache_insert (cache, KEY (0), KEY (0), 0, 0, image);
+    pixman_glyph_cache_lookup (cache, KEY (0), KEY (0));
+    pixman_glyph_cache_lookup (cache, KEY (0), KEY (0));
+    pixman_image_unref (image);
+
+    /* The a8 glyph is 4 x 6 */
+    ok &= check_stats ("insert", cache, 1, 24, 2, 1);
+
+    /* While the cache is frozen, the glyph is only freed later, but it
+     * no longer counts towards the size.
+     */
+    pixman_glyph_cache_remove (cache, KEY (0), KEY (0));
+
+    ok &= check_stats ("remove", cache, 0, 0, 2, 1);
+
+    /* More glyphs than the old fixed size table could hold */
+    image = pixman_image_create_bits (PIXMAN_a8, 1, 1, NULL, -1);
+    for (i = 0; i < N_GROWTH_GLYPHS; ++i)
+	pixman_glyph_cache_insert (cache, KEY (i), KEY (i), 0, 0, image);
+    pixman_image_unref (image);
+
+    pixman_glyph_cache_thaw (cache);
+
+    for (i = 0; i < N_GROWTH_GLYPHS; ++i)
+	pixman_glyph_cache_lookup (cache, KEY (i), KEY (i));
+
+    ok &= check_stats ("growth", cache, N_GROWTH_GLYPHS, 4 * N_GROWTH_GLYPHS,
+		       N_GROWTH_GLYPHS + 2, 1);
+
+    /* Now they no longer fit */
+    pixman_glyph_cache_set_budget (cache, 1000);
+    pixman_glyph_cache_freeze (cache);
+    pixman_glyph_cache_thaw (cache);
+
+    pixman_glyph_cache_get_stats (cache, &stats);
+    if (stats.size > 500 || stats.n_glyphs == 0	||
+	stats.n_evictions != (uint64_t)(N_GROWTH_GLYPHS - stats.n_glyphs))
+    {
+	printf ("budget: %d glyphs in %d bytes, %d evictions\n",
+		stats.n_glyphs, (int)stats.size, (int)stats.n_evictions);
+	ok = FALSE;
+    }
+
+    pixman_glyph_cache_destroy (cache);
+
+    return ok;
+}
+
+/* Two users of the cache whose freezes overlap, so that it is never
+ * thawed while glyphs are inserted. It must keep to its budget anyway.
+ */
+static pixman_bool_t
+test_overlapping_freezes (pixman_bool_t atlas)
+{
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_glyph_cache_stats_t stats;
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    pixman_glyph_cache_set_atlas (cache, atlas);
+    pixman_glyph_cache_set_budget (cache, FROZEN_BUDGET);
+
+    pixman_glyph_cache_freeze (cache);
+
+    for (i = 0; i < N_FROZEN_GLYPHS && ok; ++i)
+    {
+	pixman_image_t *image;
+
+	/* The other user freezes the cache before this one thaws it */
+	if (i % 100 == 0)
+	{
+	    pixman_glyph_cache_freeze (cache);
+	    pixman_glyph_cache_thaw (cache);
+	}
+
+	image = make_glyph (i);
+	if (!pixman_glyph_cache_insert (cache, KEY (i), KEY (i), 0, 0, image))
+	{
+	    printf ("frozen: glyph %d was not inserted\n", i);
+	    ok = FALSE;
+	}
+	pixman_image_unref (image);
+
+	pixman_glyph_cache_get_stats (cache, &stats);
+	if (stats.size > FROZEN_BUDGET)
+	{
+	    printf ("frozen%s: %d bytes after %d glyphs\n",
+		    atlas ? " atlas" : "", (int)stats.size, i + 1);
+	    ok = FALSE;
+	}
+    }
+
+    pixman_glyph_cache_thaw (cache);
+
+    pixman_glyph_cache_get_stats (cache, &stats);
+    if (stats.n_evictions == 0 ||
+	stats.n_evictions + stats.n_glyphs != N_FROZEN_GLYPHS)
+    {
+	printf ("frozen%s: %d glyphs, %d evictions\n", atlas ? " atlas" : "",
+		stats.n_glyphs, (int)stats.n_evictions);
+	ok = FALSE;
+    }
+
+    pixman_glyph_cache_destroy (cache);
+
+    return ok;
+}
+
+/* A run of glyphs looked up and inserted while the cache is frozen, with
+ * each of them composited and checked right away, and some removed.
+ */
+static pixman_bool_t
+test_run (pixman_glyph_cache_t *cache, int run)
+{
+    static const pixman_color_t white = { 0xffff, 0xffff, 0xffff, 0xffff };
+    pixman_image_t *src, *dest;
+    pixman_bool_t ok = TRUE;
+    uint8_t *bits;
+    int stride, i, x, y;
+
+    prng_srand (run);
+
+    src = pixman_image_create_solid_fill (&white);
+    dest = pixman_image_create_bits (PIXMAN_a8, 16, 16, NULL, -1);
+    bits = (uint8_t *)pixman_image_get_data (dest);
+    stride = pixman_image_get_stride (dest);
+
+    pixman_glyph_cache_freeze (cache);
+
+    for (i = 0; i < N_LOOKUPS && ok; ++i)
+    {
+	int k = prng_rand_n (N_KEYS);
+	pixman_glyph_t glyph;
+
+	if (!(glyph.glyph = pixman_glyph_cache_lookup (cache, KEY (k), KEY (k))))
+	{
+	    pixman_image_t *image = make_glyph (k);
+
+	    glyph.glyph =
+		pixman_glyph_cache_insert (cache, KEY (k), KEY (k), 0, 0, image);
+	    pixman_image_unref (image);
+	}
+
+	glyph.x = glyph.y = 0;
+
+	pixman_composite_glyphs (PIXMAN_OP_SRC, src, dest, PIXMAN_a8,
+				 0, 0, 0, 0, 0, 0,
+				 glyph_width (k), glyph_height (k),
+				 cache, 1, &glyph);
+
+	for (y = 0; y < glyph_height (k) && ok; ++y)
+	{
+	    for (x = 0; x < glyph_width (k) && ok; ++x)
+	    {
+		if (bits[y * stride + x] != glyph_value (k, x, y))
+		{
+		    printf ("run %d: glyph %d is wrong\n", run, k);
+		    ok = FALSE;
+		}
+	    }
+	}
+
+	/* Other threads may be using it */
+	if (prng_rand_n (50) == 0)
+	    pixman_glyph_cache_remove (cache, KEY (k), KEY (k));
+    }
+
+    pixman_glyph_cache_thaw (cache);
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+static pixman_bool_t
+test_threads (pixman_bool_t atlas)
+{
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_glyph_cache_stats_t stats;
+    int i, n_failed = 0;
+
+    pixman_glyph_cache_set_atlas (cache, atlas);
+    pixman_glyph_cache_set_budget (cache, THREAD_BUDGET);
+
+#ifdef USE_OPENMP
+#   pragma omp parallel for default(none) shared(cache) reduction(+:n_failed)
+#endif
+    for (i = 0; i < N_RUNS; ++i)
+    {
+	if (!test_run (cache, i))
+	    n_failed++;
+    }
+
+    /* Every lookup was either a hit or a miss */
+    pixman_glyph_cache_get_stats (cache, &stats);
+    if (stats.n_hits + stats.n_misses != N_RUNS * N_LOOKUPS)
+    {
+	printf ("%d hits and %d misses\n",
+		(int)stats.n_hits, (int)stats.n_misses);
+	n_failed++;
+    }
+
+    pixman_glyph_cache_destroy (cache);
+
+    return n_failed == 0;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int n_failed = 0;
+
+    if (!test_bookkeeping ())
+	n_failed++;
+    if (!test_overlapping_freezes (FALSE))
+	n_failed++;
+    if (!test_overlapping_freezes (TRUE))
+	n_failed++;
+    if (!test_threads (FALSE))
+	n_failed++;
+    if (!test_threads (TRUE))
+	n_failed++;
+
+    return n_failed ? 1 : 0;
+}
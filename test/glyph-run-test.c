@@ -0,0 +1,252 @@
+/*
+ * Check glyph runs: a solid source composited with OVER through a8 and
+ * component alpha a8r8g8b8 glyphs onto a 32 bpp destination is done a
+ * band at a time by the implementations. Every implementation must give
+ * exactly the same results as the general implementation, which
+ * composites the glyphs one by one, or through a mask.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_GLYPHS	24
+#define MAX_RUN		200
+#define MAX_IMPS	32
+#define N_TESTS		2000
+
+#define KEY(i) ((void *)(uintptr_t)((i) + 1))
+
+static const pixman_format_code_t glyph_formats[] =
+{
+    PIXMAN_a8,
+    PIXMAN_a8,
+    PIXMAN_a8r8g8b8,
+};
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_image_t *
+make_source (void)
+{
+    static const uint16_t alphas[] = { 0x0000, 0x8000, 0xffff };
+    pixman_color_t color;
+
+    color.alpha = prng_rand_n (2) ? RANDOM_ELT (alphas) : prng_rand_n (0x10000);
+    color.red = prng_rand_n (color.alpha + 1);
+    color.green = prng_rand_n (color.alpha + 1);
+    color.blue = prng_rand_n (color.alpha + 1);
+
+    /* Solid images that are bits images */
+    if (prng_rand_n (4) == 0)
+    {
+	pixman_image_t *image = make_random_image (PIXMAN_a8r8g8b8, 1, 1, FALSE);
+	uint32_t *bits = pixman_image_get_data (image);
+
+	*bits = ((color.alpha >> 8) << 24) | ((color.red >> 8) << 16) |
+	    ((color.green >> 8) << 8) | (color.blue >> 8);
+	pixman_image_set_repeat (image, PIXMAN_REPEAT_NORMAL);
+
+	return image;
+    }
+
+    return pixman_image_create_solid_fill (&color);
+}
+
+/* Half of the runs are laid out in lines, left to right, so that they
+ * can skip the mask.
+ */
+static int
+make_run (const void **cached, int n_glyphs, pixman_glyph_t *run)
+{
+    int n_run = prng_rand_n (MAX_RUN) + 1;
+    pixman_bool_t lines = prng_rand_n (2);
+    int x = prng_rand_n (20) - 10, y = prng_rand_n (20);
+    int i;
+
+    for (i = 0; i < n_run; ++i)
+    {
+	int g = prng_rand_n (n_glyphs);
+
+	run[i].glyph = cached[g];
+
+	if (lines)
+	{
+	    if (x > 150)
+	    {
+		x = prng_rand_n (20) - 10;
+		y += 72;
+	    }
+
+	    run[i].x = x;
+	    run[i].y = y;
+	    x += 48;
+	}
+	else
+	{
+	    run[i].x = prng_rand_n (200) - 20;
+	    run[i].y = prng_rand_n (120) - 20;
+	}
+    }
+
+    return n_run;
+}
+
+static void
+make_clip (pixman_region32_t *region)
+{
+    int i, n_rects = prng_rand_n (4) + 1;
+
+    pixman_region32_init (region);
+
+    for (i = 0; i < n_rects; ++i)
+    {
+	pixman_region32_union_rect (region, region,
+				    prng_rand_n (160), prng_rand_n (100),
+				    prng_rand_n (80) + 1, prng_rand_n (60) + 1);
+    }
+}
+
+static void
+composite (pixman_bool_t with_mask, pixman_image_t *src,
+	   pixman_image_t *dest, pixman_format_code_t mask_format,
+	   pixman_glyph_cache_t *cache, int n_run, pixman_glyph_t *run)
+{
+    if (with_mask)
+    {
+	pixman_composite_glyphs (PIXMAN_OP_OVER, src, dest, mask_format,
+				 0, 0, 5, 3, 10, 6, 150, 90,
+				 cache, n_run, run);
+    }
+    else
+    {
+	pixman_composite_glyphs_no_mask (PIXMAN_OP_OVER, src, dest,
+					 0, 0, 3, 2, cache, n_run, run);
+    }
+}
+
+static pixman_bool_t
+test_run (int testnum, const char **imps, int n_imps)
+{
+    pixman_image_t *images[MAX_GLYPHS];
+    const void *cached[MAX_GLYPHS];
+    pixman_glyph_t run[MAX_RUN];
+    pixman_glyph_cache_t *cache;
+    pixman_image_t *src, *dest, *reference;
+    pixman_format_code_t format, mask_format;
+    pixman_region32_t clip;
+    pixman_bool_t with_mask, clipped, ok = TRUE;
+    int n_glyphs, n_run, i;
+
+    prng_srand (testnum);
+
+    cache = pixman_glyph_cache_create ();
+    pixman_glyph_cache_set_atlas (cache, prng_rand_n (2));
+    pixman_glyph_cache_freeze (cache);
+
+    /* Mostly runs of one format */
+    format = RANDOM_ELT (glyph_formats);
+    n_glyphs = prng_rand_n (MAX_GLYPHS) + 1;
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	if (prng_rand_n (8) == 0)
+	    format = RANDOM_ELT (glyph_formats);
+
+	/* Empty and full coverage take shortcuts */
+	images[i] = make_random_image (format, prng_rand_n (40) + 1,
+				       prng_rand_n (40) + 1, TRUE);
+	cached[i] = pixman_glyph_cache_insert (cache, KEY (i), KEY (i),
+					       prng_rand_n (8), prng_rand_n (30),
+					       images[i]);
+    }
+
+    n_run = make_run (cached, n_glyphs, run);
+    mask_format = pixman_glyph_get_mask_format (cache, n_run, run);
+    with_mask = prng_rand_n (2);
+
+    src = make_source ();
+    dest = make_random_image (RANDOM_ELT (dest_formats),
+			      prng_rand_n (200) + 1, prng_rand_n (120) + 1, TRUE);
+    reference = clone_image (dest);
+
+    if ((clipped = (prng_rand_n (4) == 0)))
+    {
+	make_clip (&clip);
+	pixman_image_set_clip_region32 (reference, &clip);
+    }
+
+    pixman_set_implementations ("general", NULL);
+    composite (with_mask, src, reference, mask_format, cache, n_run, run);
+
+    for (i = 0; i < n_imps && ok; ++i)
+    {
+	pixman_image_t *d = clone_image (dest);
+
+	if (clipped)
+	    pixman_image_set_clip_region32 (d, &clip);
+
+	pixman_set_implementations (imps[i], NULL);
+	composite (with_mask, src, d, mask_format, cache, n_run, run);
+
+	if (!compare_images (reference, d, 0))
+	{
+	    printf ("test %d: %s differs from general (%s, %s, %d glyphs)\n",
+		    testnum, imps[i], with_mask ? "mask" : "no mask",
+		    format_name (pixman_image_get_format (dest)), n_run);
+	    ok = FALSE;
+	}
+
+	pixman_image_unref (d);
+    }
+
+    if (clipped)
+	pixman_region32_fini (&clip);
+
+    pixman_glyph_cache_thaw (cache);
+    pixman_glyph_cache_destroy (cache);
+
+    for (i = 0; i < n_glyphs; ++i)
+	pixman_image_unref (images[i]);
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+    pixman_image_unref (reference);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *imps[ARRAY_LENGTH (candidates) + 1];
+    int n_names, n_imps = 0;
+    int i, j, n_failed = 0;
+
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		imps[n_imps++] = candidates[i];
+	}
+    }
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_run (i, imps, n_imps))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,349 @@
+/*
+ * Check subpixel variants of glyphs: positions are snapped to the right
+ * phase, variants are made once, either by the cache with a bilinear
+ * shift or by the render callback of the client, and the glyphs come
+ * out where they should.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define N_PHASES	4
+#define WIDTH		7
+#define HEIGHT		9
+#define ORIGIN_X	2
+#define ORIGIN_Y	6
+
+#define KEY(i) ((void *)(uintptr_t)((i) + 1))
+
+static pixman_image_t *
+make_glyph (pixman_format_code_t format, int seed)
+{
+    pixman_image_t *image = pixman_image_create_bits (format, WIDTH, HEIGHT,
+						      NULL, -1);
+
+    prng_srand (seed);
+    prng_randmemset (pixman_image_get_data (image),
+		     pixman_image_get_stride (image) * HEIGHT, 0);
+
+    return image;
+}
+
+static pixman_image_t *
+make_dest (void)
+{
+    pixman_image_t *dest = pixman_image_create_bits (PIXMAN_a8r8g8b8,
+						     40, 30, NULL, -1);
+
+    memset (pixman_image_get_data (dest), 0x40,
+	    pixman_image_get_stride (dest) * 30);
+
+    return dest;
+}
+
+/* What the cache should make of the glyph for the phase */
+static pixman_image_t *
+shift_glyph (pixman_image_t *glyph, int phase)
+{
+    pixman_format_code_t format = pixman_image_get_format (glyph);
+    pixman_image_t *image;
+    pixman_transform_t t;
+
+    image = pixman_image_create_bits (format, WIDTH + 1, HEIGHT, NULL, -1);
+
+    pixman_transform_init_translate (
+	&t, - pixman_int_to_fixed (phase) / N_PHASES, 0);
+    pixman_image_set_transform (glyph, &t);
+    pixman_image_set_filter (glyph, PIXMAN_FILTER_BILINEAR, NULL, 0);
+    pixman_image_composite32 (PIXMAN_OP_SRC, glyph, NULL, image,
+			      0, 0, 0, 0, 0, 0, WIDTH + 1, HEIGHT);
+    pixman_image_set_transform (glyph, NULL);
+    pixman_image_set_filter (glyph, PIXMAN_FILTER_NEAREST, NULL, 0);
+
+    /* The cache uses 32 bpp glyphs as component alpha */
+    if (format == PIXMAN_a8r8g8b8)
+	pixman_image_set_component_alpha (image, TRUE);
+
+    return image;
+}
+
+static int n_rendered;
+
+static pixman_image_t *
+render (void *font_key, void *glyph_key, int phase, int n_phases,
+	int *origin_x, int *origin_y, void *data)
+{
+    pixman_image_t *image;
+
+    if (n_phases != N_PHASES || font_key != data)
+	return NULL;
+
+    /* Phase 3 can't be rendered */
+    if (phase == 3)
+	return NULL;
+
+    n_rendered++;
+
+    image = pixman_image_create_bits (PIXMAN_a8, 1, 1, NULL, -1);
+    *(uint8_t *)pixman_image_get_data (image) = phase * 50 + 10;
+    *origin_x = 0;
+    *origin_y = 0;
+
+    return image;
+}
+
+static pixman_bool_t
+test_snapping (void)
+{
+    static const struct
+    {
+	double	x, y;
+	int	ix, iy, phase;
+    } positions[] =
+    {
+	{ 10.0,    5.0,   10, 5, 0 },
+	{ 10.25,   5.49,  10, 5, 1 },
+	{ 10.6,    5.5,   10, 6, 2 },
+	{ 10.9,    4.6,   11, 5, 0 },
+	{ -0.3,   -0.3,   -1, 0, 3 },
+	{ -1.2,   -1.5,   -2, -1, 3 },
+	{ 3.74,    0.0,    3, 0, 3 },
+    };
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_image_t *image = make_glyph (PIXMAN_a8, 1);
+    pixman_glyph_fixed_t glyph;
+    pixman_glyph_t resolved;
+    const void *variants[N_PHASES];
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    pixman_glyph_cache_set_subpixel (cache, N_PHASES, NULL, NULL);
+    pixman_glyph_cache_freeze (cache);
+
+    glyph.glyph = pixman_glyph_cache_insert (cache, KEY (0), KEY (0),
+					     ORIGIN_X, ORIGIN_Y, image);
+
+    for (i = 0; i < N_PHASES; ++i)
+    {
+	glyph.x = pixman_double_to_fixed (i / (double)N_PHASES);
+	glyph.y = 0;
+	pixman_glyph_resolve_fixed (cache, 1, &glyph, &resolved);
+	variants[i] = resolved.glyph;
+
+	if (variants[i] != pixman_glyph_cache_lookup_phase (
+		cache, KEY (0), KEY (0), i))
+	{
+	    printf ("phase %d is not in the cache\n", i);
+	    ok = FALSE;
+	}
+    }
+
+    for (i = 0; i < ARRAY_LENGTH (positions); ++i)
+    {
+	glyph.x = pixman_double_to_fixed (positions[i].x);
+	glyph.y = pixman_double_to_fixed (positions[i].y);
+	pixman_glyph_resolve_fixed (cache, 1, &glyph, &resolved);
+
+	if (resolved.x != positions[i].ix			||
+	    resolved.y != positions[i].iy			||
+	    resolved.glyph != variants[positions[i].phase])
+	{
+	    printf ("%f, %f snapped to %d, %d\n", positions[i].x,
+		    positions[i].y, resolved.x, resolved.y);
+	    ok = FALSE;
+	}
+    }
+
+    pixman_glyph_cache_thaw (cache);
+    pixman_image_unref (image);
+
+    /* Removing the glyph removes its variants */
+    pixman_glyph_cache_remove (cache, KEY (0), KEY (0));
+    for (i = 0; i < N_PHASES; ++i)
+    {
+	if (pixman_glyph_cache_lookup_phase (cache, KEY (0), KEY (0), i))
+	{
+	    printf ("phase %d was not removed\n", i);
+	    ok = FALSE;
+	}
+    }
+
+    pixman_glyph_cache_destroy (cache);
+
+    return ok;
+}
+
+/* The variants made by the cache are the glyph shifted with a bilinear
+ * filter, and glyphs at fixed point positions composite like them.
+ */
+static pixman_bool_t
+test_variants (pixman_bool_t atlas, pixman_format_code_t format)
+{
+    static const pixman_color_t color = { 0x8000, 0x4000, 0xc000, 0xc000 };
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_image_t *src = pixman_image_create_solid_fill (&color);
+    pixman_image_t *images[3];
+    pixman_glyph_fixed_t glyphs[3];
+    pixman_glyph_cache_stats_t stats;
+    pixman_bool_t ok = TRUE;
+    int phase, i;
+
+    pixman_glyph_cache_set_atlas (cache, atlas);
+    pixman_glyph_cache_set_subpixel (cache, N_PHASES, NULL, NULL);
+    pixman_glyph_cache_freeze (cache);
+
+    for (i = 0; i < 3; ++i)
+    {
+	images[i] = make_glyph (format, i + 2);
+	glyphs[i].glyph = pixman_glyph_cache_insert (
+	    cache, KEY (i), KEY (i), ORIGIN_X, ORIGIN_Y, images[i]);
+    }
+
+    for (phase = 0; phase < N_PHASES; ++phase)
+    {
+	pixman_image_t *dest = make_dest ();
+	pixman_image_t *reference = make_dest ();
+
+	for (i = 0; i < 3; ++i)
+	{
+	    pixman_image_t *shifted = shift_glyph (images[i], phase);
+
+	    glyphs[i].x = pixman_int_to_fixed (3 + 11 * i) +
+		phase * pixman_fixed_1 / N_PHASES;
+	    glyphs[i].y = pixman_int_to_fixed (5 + 7 * i);
+
+	    pixman_image_composite32 (PIXMAN_OP_OVER, src, shifted, reference,
+				      0, 0, 0, 0,
+				      3 + 11 * i - ORIGIN_X, 5 + 7 * i - ORIGIN_Y,
+				      WIDTH + 1, HEIGHT);
+	    pixman_image_unref (shifted);
+	}
+
+	pixman_composite_glyphs_no_mask_fixed (PIXMAN_OP_OVER, src, dest,
+					       0, 0, 0, 0, cache, 3, glyphs);
+
+	if (!compare_images (reference, dest, 0))
+	{
+	    printf ("%s %s glyphs at phase %d differ\n",
+		    atlas ? "atlas" : "plain", format_name (format), phase);
+	    ok = FALSE;
+	}
+
+	pixman_image_unref (dest);
+	pixman_image_unref (reference);
+    }
+
+    pixman_glyph_cache_thaw (cache);
+
+    /* Each variant was made once */
+    pixman_glyph_cache_get_stats (cache, &stats);
+    if (stats.n_glyphs != 3 * N_PHASES)
+    {
+	printf ("%d glyphs in the cache\n", stats.n_glyphs);
+	ok = FALSE;
+    }
+
+    for (i = 0; i < 3; ++i)
+	pixman_image_unref (images[i]);
+
+    pixman_image_unref (src);
+    pixman_glyph_cache_destroy (cache);
+
+    return ok;
+}
+
+/* Variants made by the client, through the mask path */
+static pixman_bool_t
+test_render (void)
+{
+    static const pixman_color_t white = { 0xffff, 0xffff, 0xffff, 0xffff };
+    pixman_glyph_cache_t *cache = pixman_glyph_cache_create ();
+    pixman_image_t *src = pixman_image_create_solid_fill (&white);
+    pixman_image_t *image = pixman_image_create_bits (PIXMAN_a8, 1, 1,
+						      NULL, -1);
+    pixman_image_t *dest;
+    pixman_glyph_fixed_t glyphs[N_PHASES];
+    pixman_bool_t ok = TRUE;
+    uint8_t *bits;
+    int stride, i, k;
+
+    pixman_glyph_cache_set_subpixel (cache, N_PHASES, render, KEY (0));
+    pixman_glyph_cache_freeze (cache);
+
+    /* Phase 0 is the glyph as inserted */
+    *(uint8_t *)pixman_image_get_data (image) = 10;
+    glyphs[0].glyph = pixman_glyph_cache_insert (cache, KEY (0), KEY (0),
+						 0, 0, image);
+    pixman_image_unref (image);
+
+    dest = pixman_image_create_bits (PIXMAN_a8, 16, 4, NULL, -1);
+    bits = (uint8_t *)pixman_image_get_data (dest);
+    stride = pixman_image_get_stride (dest);
+
+    for (k = 0; k < 2; ++k)
+    {
+	memset (bits, 0, stride * 4);
+
+	for (i = 0; i < N_PHASES; ++i)
+	{
+	    glyphs[i].glyph = glyphs[0].glyph;
+	    glyphs[i].x = pixman_int_to_fixed (3 * i) +
+		i * pixman_fixed_1 / N_PHASES;
+	    glyphs[i].y = pixman_int_to_fixed (2 * (i & 1));
+	}
+
+	pixman_composite_glyphs_fixed (PIXMAN_OP_ADD, src, dest, PIXMAN_a8,
+				       0, 0, 0, 0, 0, 0, 16, 4,
+				       cache, N_PHASES, glyphs);
+
+	/* Phase 3 can't be rendered, so phase 0 goes to the nearest pixel */
+	for (i = 0; i < N_PHASES; ++i)
+	{
+	    int x = 3 * i + (i == 3), y = 2 * (i & 1);
+	    int value = (i == 3) ? 10 : i * 50 + 10;
+
+	    if (bits[y * stride + x] != value)
+	    {
+		printf ("rendered phase %d is wrong: %d\n", i,
+			bits[y * stride + x]);
+		ok = FALSE;
+	    }
+	}
+    }
+
+    /* Phases 1 and 2 were rendered once, phase 3 is tried each time */
+    if (n_rendered != 2)
+    {
+	printf ("%d variants rendered\n", n_rendered);
+	ok = FALSE;
+    }
+
+    pixman_glyph_cache_thaw (cache);
+    pixman_glyph_cache_destroy (cache);
+    pixman_image_unref (dest);
+    pixman_image_unref (src);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int n_failed = 0;
+
+    if (!test_snapping ())
+	n_failed++;
+    if (!test_variants (FALSE, PIXMAN_a8))
+	n_failed++;
+    if (!test_variants (TRUE, PIXMAN_a8))
+	n_failed++;
+    if (!test_variants (FALSE, PIXMAN_a8r8g8b8))
+	n_failed++;
+    if (!test_variants (TRUE, PIXMAN_a8r8g8b8))
+	n_failed++;
+    if (!test_render ())
+	n_failed++;
+
+    return n_failed ? 1 : 0;
+}
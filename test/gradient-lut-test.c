@@ -0,0 +1,370 @@
+/*
+ * Check linear, radial and conical gradients: with the default precision every
+ * implementation must give exactly the same results as the general
+ * implementation, and so must they with a lookup table. The colors
+ * from the lookup table must also be close to the precise ones.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	100
+#define MAX_HEIGHT	8
+#define MAX_STOPS	5
+#define MAX_IMPS	32
+#define N_TESTS		3000
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+    PIXMAN_REPEAT_REFLECT,
+};
+
+typedef enum
+{
+    GRADIENT_LINEAR,
+    GRADIENT_RADIAL,
+    GRADIENT_CONICAL,
+    N_GRADIENT_KINDS
+} gradient_kind_t;
+
+static const char *const kind_names[] = { "linear", "radial", "conical" };
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_color_t
+random_color (void)
+{
+    pixman_color_t color;
+
+    color.red = prng_rand_n (0x10000);
+    color.green = prng_rand_n (0x10000);
+    color.blue = prng_rand_n (0x10000);
+    color.alpha = prng_rand_n (4) ? prng_rand_n (0x10000) : 0xffff;
+
+    return color;
+}
+
+/* Stops at least spacing apart and below 1, so that a repeating gradient
+ * has no hard edge, or anywhere in [0, 1] when spacing is 0.
+ */
+static int
+random_stops (pixman_gradient_stop_t *stops, pixman_fixed_t spacing)
+{
+    int n_stops = prng_rand_n (MAX_STOPS) + 1;
+    pixman_fixed_t x = 0;
+    int i;
+
+    if (spacing)
+	n_stops = MIN (n_stops, pixman_fixed_1 / spacing);
+
+    for (i = 0; i < n_stops; ++i)
+    {
+	if (spacing)
+	{
+	    stops[i].x = x;
+	    x += spacing;
+	}
+	else
+	{
+	    stops[i].x = prng_rand_n (pixman_fixed_1 + 1);
+	    if (i && stops[i].x < stops[i - 1].x)
+		stops[i].x = stops[i - 1].x;
+	}
+	stops[i].color = random_color ();
+    }
+
+    return n_stops;
+}
+
+static pixman_image_t *
+make_linear (pixman_gradient_stop_t *stops, int n_stops, int width)
+{
+    pixman_point_fixed_t p1, p2;
+
+    p1.x = pixman_int_to_fixed (prng_rand_n (64) - 32);
+    p1.y = pixman_int_to_fixed (prng_rand_n (64) - 32);
+    p2.x = p1.x + prng_rand_n (pixman_int_to_fixed (4 * width)) - pixman_int_to_fixed (2 * width);
+    p2.y = p1.y + prng_rand_n (pixman_int_to_fixed (64)) - pixman_int_to_fixed (32);
+
+    return pixman_image_create_linear_gradient (&p1, &p2, stops, n_stops);
+}
+
+/* When contained is set, the inner circle is inside the outer one, so
+ * that every point has a color.
+ */
+static pixman_image_t *
+make_radial (pixman_gradient_stop_t *stops, int n_stops, int width,
+	     pixman_bool_t contained)
+{
+    pixman_point_fixed_t inner, outer;
+    pixman_fixed_t r1, r2;
+
+    inner.x = pixman_int_to_fixed (prng_rand_n (2 * width) - width / 2);
+    inner.y = pixman_int_to_fixed (prng_rand_n (32) - 16);
+    r1 = prng_rand_n (pixman_int_to_fixed (width));
+
+    if (contained)
+    {
+	outer.x = inner.x + prng_rand_n (pixman_int_to_fixed (16));
+	outer.y = inner.y + prng_rand_n (pixman_int_to_fixed (16));
+	r2 = r1 + pixman_int_to_fixed (24) + prng_rand_n (pixman_int_to_fixed (width));
+    }
+    else
+    {
+	outer.x = pixman_int_to_fixed (prng_rand_n (2 * width) - width / 2);
+	outer.y = pixman_int_to_fixed (prng_rand_n (32) - 16);
+	r2 = prng_rand_n (pixman_int_to_fixed (width));
+
+	/* Degenerate cases */
+	switch (prng_rand_n (8))
+	{
+	case 0:
+	    outer = inner;
+	    break;
+	case 1:
+	    r2 = r1;
+	    break;
+	}
+    }
+
+    if (prng_rand_n (2))
+	return pixman_image_create_radial_gradient (&inner, &outer, r1, r2,
+						    stops, n_stops);
+    else
+	return pixman_image_create_radial_gradient (&outer, &inner, r2, r1,
+						    stops, n_stops);
+}
+
+static pixman_image_t *
+make_conical (pixman_gradient_stop_t *stops, int n_stops, int width)
+{
+    pixman_point_fixed_t center;
+    pixman_fixed_t angle;
+
+    center.x = pixman_int_to_fixed (prng_rand_n (2 * width) - width / 2);
+    center.y = pixman_int_to_fixed (prng_rand_n (32) - 16);
+    angle = prng_rand_n (pixman_int_to_fixed (720)) - pixman_int_to_fixed (360);
+
+    return pixman_image_create_conical_gradient (&center, angle,
+						 stops, n_stops);
+}
+
+static pixman_image_t *
+make_gradient (gradient_kind_t kind, pixman_gradient_stop_t *stops,
+	       int n_stops, pixman_repeat_t repeat, int width,
+	       pixman_bool_t contained)
+{
+    pixman_transform_t transform;
+    pixman_image_t *image;
+
+    if (kind == GRADIENT_LINEAR)
+	image = make_linear (stops, n_stops, width);
+    else if (kind == GRADIENT_RADIAL)
+	image = make_radial (stops, n_stops, width, contained);
+    else
+	image = make_conical (stops, n_stops, width);
+
+    pixman_image_set_repeat (image, repeat);
+
+    switch (prng_rand_n (4))
+    {
+    case 0:
+	pixman_transform_init_scale (
+	    &transform,
+	    pixman_fixed_1 / 4 + prng_rand_n (pixman_fixed_1 * 4),
+	    pixman_fixed_1 / 4 + prng_rand_n (pixman_fixed_1 * 4));
+	pixman_image_set_transform (image, &transform);
+	break;
+
+    case 1:
+	pixman_transform_init_rotate (
+	    &transform,
+	    prng_rand_n (pixman_fixed_1 * 2) - pixman_fixed_1,
+	    prng_rand_n (pixman_fixed_1 * 2) - pixman_fixed_1);
+	pixman_image_set_transform (image, &transform);
+	break;
+
+    case 2:
+	/* Projective */
+	pixman_transform_init_identity (&transform);
+	transform.matrix[2][0] = prng_rand_n (pixman_fixed_1 / 256);
+	pixman_image_set_transform (image, &transform);
+	break;
+    }
+
+    return image;
+}
+
+static void
+composite (const char *imp, pixman_op_t op, pixman_image_t *src,
+	   pixman_image_t *dest, int x, int y, int width, int height)
+{
+    pixman_set_implementations (imp, NULL);
+    pixman_image_composite32 (op, src, NULL, dest,
+			      x, y, 0, 0, 0, 0, width, height);
+}
+
+static pixman_bool_t
+test_exact (int testnum, const char **imps, int n_imps)
+{
+    pixman_gradient_stop_t stops[MAX_STOPS];
+    pixman_gradient_precision_t precision;
+    pixman_image_t *src, *reference, *dest;
+    int width, height, n_stops, x, y, i;
+    pixman_bool_t ok = TRUE;
+    gradient_kind_t kind;
+    pixman_repeat_t repeat;
+    pixman_op_t op;
+
+    prng_srand (testnum);
+
+    kind = prng_rand_n (N_GRADIENT_KINDS);
+    op = prng_rand_n (2) ? PIXMAN_OP_SRC : PIXMAN_OP_OVER;
+    repeat = RANDOM_ELT (repeats);
+    precision = prng_rand_n (2) ? PIXMAN_GRADIENT_PRECISE : PIXMAN_GRADIENT_LUT;
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+    x = prng_rand_n (200) - 100;
+    y = prng_rand_n (200) - 100;
+
+    n_stops = random_stops (stops, 0);
+    src = make_gradient (kind, stops, n_stops, repeat, width, prng_rand_n (2));
+    pixman_image_set_gradient_precision (src, precision);
+
+    dest = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+    reference = clone_image (dest);
+
+    composite ("general", op, src, reference, x, y, width, height);
+
+    for (i = 0; i < n_imps && ok; ++i)
+    {
+	pixman_image_t *d = clone_image (dest);
+
+	composite (imps[i], op, src, d, x, y, width, height);
+
+	if (!compare_images (reference, d, 0))
+	{
+	    printf ("test %d: %s differs from general (%s %s, repeat %d, %s)\n",
+		    testnum, imps[i], kind_names[kind], operator_name (op), repeat,
+		    precision == PIXMAN_GRADIENT_LUT ? "lut" : "precise");
+	    ok = FALSE;
+	}
+
+	pixman_image_unref (d);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (reference);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+/* With stops far enough apart the nearest color from the table can't be
+ * off by more than a couple of units per channel. Hard edges, like the
+ * end of a gradient that isn't repeated, can move by one entry of the
+ * table, so they are left out. A conical gradient always wraps around
+ * at its angle, which only a repeating gradient makes continuous.
+ */
+static pixman_bool_t
+test_lut_accuracy (int testnum)
+{
+    pixman_gradient_stop_t stops[MAX_STOPS];
+    pixman_image_t *src, *precise, *lut;
+    int width, height, n_stops, i;
+    pixman_bool_t ok = TRUE;
+    gradient_kind_t kind;
+    pixman_repeat_t repeat;
+    uint32_t *p, *l;
+
+    prng_srand (testnum);
+
+    kind = prng_rand_n (N_GRADIENT_KINDS);
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+
+    /* Anything but PIXMAN_REPEAT_NONE, which comes first */
+    repeat = repeats[prng_rand_n (ARRAY_LENGTH (repeats) - 1) + 1];
+    if (kind == GRADIENT_CONICAL)
+	repeat = PIXMAN_REPEAT_NORMAL;
+
+    n_stops = random_stops (stops, pixman_fixed_1 / 4);
+    src = make_gradient (kind, stops, n_stops, repeat, width, TRUE);
+
+    precise = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+    lut = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, precise,
+			      0, 0, 0, 0, 0, 0, width, height);
+    pixman_image_set_gradient_precision (src, PIXMAN_GRADIENT_LUT);
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, lut,
+			      0, 0, 0, 0, 0, 0, width, height);
+
+    p = pixman_image_get_data (precise);
+    l = pixman_image_get_data (lut);
+
+    for (i = 0; i < width * height && ok; ++i)
+    {
+	int shift;
+
+	for (shift = 0; shift < 32; shift += 8)
+	{
+	    int a = (p[i] >> shift) & 0xff;
+	    int b = (l[i] >> shift) & 0xff;
+
+	    if (abs (a - b) > 2)
+	    {
+		printf ("test %d: %s lut color %08x too far from %08x\n",
+			testnum, kind_names[kind], l[i], p[i]);
+		ok = FALSE;
+		break;
+	    }
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (precise);
+    pixman_image_unref (lut);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *imps[ARRAY_LENGTH (candidates) + 1];
+    int n_names, n_imps = 0;
+    int i, j, n_failed = 0;
+
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		imps[n_imps++] = candidates[i];
+	}
+    }
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_exact (i, imps, n_imps))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    for (i = 0; i < N_TESTS / 10; ++i)
+    {
+	if (!test_lut_accuracy (i))
+	    n_failed++;
+    }
+
+    return n_failed ? 1 : 0;
+}
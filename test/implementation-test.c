@@ -0,0 +1,293 @@
+/*
+ * Check that the implementation chain can be inspected and switched at
+ * runtime, that composites give the same results on every chain, and
+ * that tracing reports the implementation that served each composite.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define WIDTH		48
+#define HEIGHT		48
+#define MAX_IMPS	32
+#define N_TESTS		500
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+/* The unused bits of x8r8g8b8 are not defined after a composite */
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+typedef struct
+{
+    int				n_calls;
+    pixman_composite_path_t	last;
+} trace_t;
+
+static void
+trace (const pixman_composite_path_t *path, void *data)
+{
+    trace_t *t = data;
+
+    t->n_calls++;
+    t->last = *path;
+}
+
+static int
+get_chain (const char **names)
+{
+    int n = pixman_get_implementations (names, MAX_IMPS);
+
+    if (n < 2 || n > MAX_IMPS)
+    {
+	printf ("unexpected chain length %d\n", n);
+	exit (1);
+    }
+
+    return n;
+}
+
+static pixman_bool_t
+chain_has (const char *name)
+{
+    const char *names[MAX_IMPS];
+    int i, n = get_chain (names);
+
+    for (i = 0; i < n; ++i)
+    {
+	if (strcmp (names[i], name) == 0)
+	    return TRUE;
+    }
+
+    return FALSE;
+}
+
+static pixman_bool_t
+same_names (const char **a, int n_a, const char **b, int n_b)
+{
+    int i;
+
+    if (n_a != n_b)
+	return FALSE;
+
+    for (i = 0; i < n_a; ++i)
+    {
+	if (strcmp (a[i], b[i]) != 0)
+	    return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Composites with the default chain and with only the general
+ * implementation, and compares the results.
+ */
+static pixman_bool_t
+test_composite (int testnum)
+{
+    pixman_image_t *src, *mask, *dest1, *dest2;
+    pixman_format_code_t dest_format;
+    pixman_op_t op;
+    pixman_bool_t ok;
+    trace_t t;
+
+    prng_srand (testnum);
+
+    src = make_random_image (RANDOM_ELT (formats), WIDTH, HEIGHT, FALSE);
+    mask = NULL;
+    if (prng_rand_n (3) == 0)
+	mask = make_random_image (PIXMAN_a8, WIDTH, HEIGHT, FALSE);
+    dest_format = RANDOM_ELT (dest_formats);
+    dest1 = make_random_image (dest_format, WIDTH, HEIGHT, FALSE);
+    dest2 = clone_image (dest1);
+
+    op = RANDOM_ELT (ops);
+
+    pixman_set_implementations (NULL, NULL);
+    pixman_image_composite32 (op, src, mask, dest1,
+			      0, 0, 0, 0, 0, 0, WIDTH, HEIGHT);
+
+    memset (&t, 0, sizeof t);
+    pixman_set_composite_trace (trace, &t);
+    pixman_set_implementations ("general", NULL);
+    pixman_image_composite32 (op, src, mask, dest2,
+			      0, 0, 0, 0, 0, 0, WIDTH, HEIGHT);
+    pixman_set_composite_trace (NULL, NULL);
+
+    ok = compare_images (dest1, dest2, 0);
+    if (!ok)
+    {
+	printf ("test %d: general implementation differs (%s)\n",
+		testnum, operator_name (op));
+    }
+
+    /* The noop implementation only handles trivial composites */
+    if (t.n_calls != 1 ||
+	(strcmp (t.last.implementation, "general") != 0 &&
+	 strcmp (t.last.implementation, "noop") != 0))
+    {
+	printf ("test %d: wrong trace (%d calls)\n", testnum, t.n_calls);
+	ok = FALSE;
+    }
+
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (dest1);
+    pixman_image_unref (dest2);
+
+    return ok;
+}
+
+static pixman_bool_t
+test_selection (void)
+{
+    const char *initial[MAX_IMPS], *names[MAX_IMPS];
+    pixman_composite_path_t path;
+    pixman_image_t *src, *dest;
+    int n_initial, n;
+    trace_t t;
+
+    n_initial = get_chain (initial);
+    if (strcmp (initial[0], "noop") != 0 ||
+	strcmp (initial[n_initial - 1], "general") != 0)
+    {
+	printf ("chain should go from noop to general\n");
+	return FALSE;
+    }
+
+    if (pixman_set_implementations ("no-such-implementation", NULL))
+    {
+	printf ("selected a nonexistent implementation\n");
+	return FALSE;
+    }
+
+    n = get_chain (names);
+    if (!same_names (initial, n_initial, names, n))
+    {
+	printf ("failed selection changed the chain\n");
+	return FALSE;
+    }
+
+    if (!pixman_set_implementations ("general", NULL))
+    {
+	printf ("could not select the general implementation\n");
+	return FALSE;
+    }
+
+    n = get_chain (names);
+    if (n != 2 || strcmp (names[1], "general") != 0)
+    {
+	printf ("general should be the only implementation below noop\n");
+	return FALSE;
+    }
+
+    if (chain_has ("fast"))
+    {
+	if (!pixman_set_implementations (NULL, "fast") || chain_has ("fast"))
+	{
+	    printf ("could not exclude the fast implementation\n");
+	    return FALSE;
+	}
+
+	if (!pixman_set_implementations ("fast", NULL) ||
+	    get_chain (names) != 3)
+	{
+	    printf ("could not select the fast implementation\n");
+	    return FALSE;
+	}
+    }
+
+    if (!pixman_set_implementations (NULL, NULL))
+    {
+	printf ("could not go back to the default chain\n");
+	return FALSE;
+    }
+
+    n = get_chain (names);
+    if (!same_names (initial, n_initial, names, n))
+    {
+	printf ("default chain is different the second time\n");
+	return FALSE;
+    }
+
+    /* A plain copy is served by a fast path and the trace agrees with
+     * a lookup of the same path.
+     */
+    prng_srand (0);
+    src = make_random_image (PIXMAN_a8r8g8b8, WIDTH, HEIGHT, FALSE);
+    dest = make_random_image (PIXMAN_a8r8g8b8, WIDTH, HEIGHT, FALSE);
+
+    memset (&t, 0, sizeof t);
+    pixman_set_composite_trace (trace, &t);
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+			      0, 0, 0, 0, 0, 0, WIDTH, HEIGHT);
+    pixman_set_composite_trace (NULL, NULL);
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    if (t.n_calls != 1)
+    {
+	printf ("expected one traced composite, got %d\n", t.n_calls);
+	return FALSE;
+    }
+
+    if (n_initial > 2 && strcmp (t.last.implementation, "general") == 0)
+    {
+	printf ("copy was not served by a fast path\n");
+	return FALSE;
+    }
+
+    path = t.last;
+    path.implementation = NULL;
+    path.func = NULL;
+    if (!pixman_lookup_composite_path (&path)			||
+	strcmp (path.implementation, t.last.implementation) != 0	||
+	path.func != t.last.func)
+    {
+	printf ("lookup disagrees with the trace\n");
+	return FALSE;
+    }
+
+    return TRUE;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    if (!test_selection ())
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}
@@ -22,13 +22,21 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "utils.h"
 
-#define SOLID_FLAG 1
-#define CA_FLAG    2
+#define SOLID_FLAG  1
+#define CA_FLAG     2
+#define RADIAL_FLAG 4
+#define LUT_FLAG    8
+#define CONICAL_FLAG 16
+
+/* The flags that describe the kind of source */
+#define SOURCE_KIND_FLAGS						\
+    (SOLID_FLAG | RADIAL_FLAG | CONICAL_FLAG | LUT_FLAG)
 
 #define L1CACHE_SIZE (8 * 1024)
 #define L2CACHE_SIZE (128 * 1024)
@@ -41,8 +49,12 @@
  * do allocate0on-write. */
 #define CACHELINE_LENGTH (32) /* bytes */
 
-#define WIDTH  1920
-#define HEIGHT 1080
+/* The size of the buffers, which can be changed with --size */
+static int bench_width = 1920;
+static int bench_height = 1080;
+
+#define WIDTH  bench_width
+#define HEIGHT bench_height
 #define BUFSIZE (WIDTH * HEIGHT * 4)
 #define XWIDTH 256
 #define XHEIGHT 256
@@ -88,8 +100,134 @@ bench_memcpy ()
     return (double)total / (t2 - t1);
 }
 
-static pixman_bool_t use_scaling = FALSE;
-static pixman_filter_t filter = PIXMAN_FILTER_NEAREST;
+/* Estimate the cost of looking up a fast path that isn't in the cache
+ * by compositing single pixels with many different combinations of
+ * operator and formats. The same composites are done twice: once with
+ * each combination repeated back to back (so the lookup is nearly always
+ * cached), and once cycling through all of them (so it nearly never is).
+ * Returns the difference in nanoseconds per composite.
+ */
+#define LOOKUP_REPEATS 64
+
+double
+bench_lookup (double *cached_ns)
+{
+    static const pixman_op_t ops[] =
+    {
+	PIXMAN_OP_CLEAR, PIXMAN_OP_SRC, PIXMAN_OP_DST, PIXMAN_OP_OVER,
+	PIXMAN_OP_OVER_REVERSE, PIXMAN_OP_IN, PIXMAN_OP_IN_REVERSE,
+	PIXMAN_OP_OUT, PIXMAN_OP_OUT_REVERSE, PIXMAN_OP_ATOP,
+	PIXMAN_OP_ATOP_REVERSE, PIXMAN_OP_XOR, PIXMAN_OP_ADD,
+	PIXMAN_OP_SATURATE,
+    };
+    static const pixman_format_code_t formats[] =
+    {
+	PIXMAN_a8r8g8b8, PIXMAN_x8r8g8b8, PIXMAN_a8b8g8r8,
+	PIXMAN_x8b8g8r8, PIXMAN_r5g6b5, PIXMAN_a8,
+    };
+    pixman_image_t *src_img[ARRAY_LENGTH (formats)];
+    pixman_image_t *dst_img[ARRAY_LENGTH (formats)];
+    pixman_image_t *mask_img;
+    int n_keys = ARRAY_LENGTH (ops) * ARRAY_LENGTH (formats) *
+	ARRAY_LENGTH (formats) * 2;
+    double t1, t2, t3;
+    int i, k, r;
+
+    for (i = 0; i < ARRAY_LENGTH (formats); ++i)
+    {
+	src_img[i] = pixman_image_create_bits (formats[i], 1, 1, src, 4);
+	dst_img[i] = pixman_image_create_bits (formats[i], 1, 1, dst, 4);
+    }
+    mask_img = pixman_image_create_bits (PIXMAN_a8, 1, 1, mask, 4);
+
+#define COMPOSITE_KEY(k)						\
+    pixman_image_composite (						\
+	ops[(k) % ARRAY_LENGTH (ops)],					\
+	src_img[((k) / ARRAY_LENGTH (ops)) % ARRAY_LENGTH (formats)],	\
+	((k) >= n_keys / 2) ? mask_img : NULL,				\
+	dst_img[((k) / (ARRAY_LENGTH (ops) * ARRAY_LENGTH (formats)))	\
+		% ARRAY_LENGTH (formats)],				\
+	0, 0, 0, 0, 0, 0, 1, 1)
+
+    t1 = gettime ();
+    for (k = 0; k < n_keys; ++k)
+    {
+	for (r = 0; r < LOOKUP_REPEATS; ++r)
+	    COMPOSITE_KEY (k);
+    }
+    t2 = gettime ();
+    for (r = 0; r < LOOKUP_REPEATS; ++r)
+    {
+	for (k = 0; k < n_keys; ++k)
+	    COMPOSITE_KEY (k);
+    }
+    t3 = gettime ();
+
+#undef COMPOSITE_KEY
+
+    for (i = 0; i < ARRAY_LENGTH (formats); ++i)
+    {
+	pixman_image_unref (src_img[i]);
+	pixman_image_unref (dst_img[i]);
+    }
+    pixman_image_unref (mask_img);
+
+    *cached_ns = (t2 - t1) * 1e9 / ((double)n_keys * LOOKUP_REPEATS);
+
+    return ((t3 - t2) - (t2 - t1)) * 1e9 / ((double)n_keys * LOOKUP_REPEATS);
+}
+
+typedef enum
+{
+    TRANSFORM_NONE,
+    TRANSFORM_SCALE,
+    TRANSFORM_ROTATE
+} transform_kind_t;
+
+static const char *const transform_names[] = { "none", "scale", "rotate" };
+
+static const char *const repeat_names[] = { "none", "normal", "pad", "reflect" };
+
+static const struct
+{
+    const char *	name;
+    pixman_filter_t	filter;
+} filter_names[] =
+{
+    { "fast",		PIXMAN_FILTER_FAST },
+    { "good",		PIXMAN_FILTER_GOOD },
+    { "best",		PIXMAN_FILTER_BEST },
+    { "nearest",	PIXMAN_FILTER_NEAREST },
+    { "bilinear",	PIXMAN_FILTER_BILINEAR },
+};
+
+typedef enum
+{
+    OUTPUT_TEXT,
+    OUTPUT_CSV,
+    OUTPUT_JSON
+} output_format_t;
+
+/* Everything needed to set up one benchmark */
+typedef struct
+{
+    char		name[96];
+    int			src_fmt;
+    int			src_flags;
+    int			op;
+    int			mask_fmt;
+    int			mask_flags;
+    int			dst_fmt;
+    pixman_repeat_t	repeat;
+    pixman_filter_t	filter;
+    transform_kind_t	transform;
+} bench_case_t;
+
+static output_format_t output_format = OUTPUT_TEXT;
+static const char *label = NULL;
+static const char *implementation = "default";
+static const char *stores = "default";
+static pixman_bool_t compare_streaming = FALSE;
 
 /* nearly 1x scale factor */
 static pixman_transform_t m =
@@ -101,15 +239,103 @@ static pixman_transform_t m =
     }
 };
 
+/* Gradient sources, which have no format of their own */
+static const struct
+{
+    const char *	name;
+    int			flags;
+} gradient_names[] =
+{
+    { "radial",		RADIAL_FLAG },
+    { "radial-lut",	RADIAL_FLAG | LUT_FLAG },
+    { "conical",	CONICAL_FLAG },
+    { "conical-lut",	CONICAL_FLAG | LUT_FLAG },
+};
+
+static const char *
+gradient_name (int flags)
+{
+    int i;
+
+    for (i = 0; i < ARRAY_LENGTH (gradient_names); ++i)
+    {
+	if (gradient_names[i].flags == (flags & SOURCE_KIND_FLAGS))
+	    return gradient_names[i].name;
+    }
+
+    return NULL;
+}
+
+/* A gradient that covers an image of the given size */
+static pixman_image_t *
+create_gradient (int flags, int width, int height)
+{
+    static const pixman_gradient_stop_t stops[] =
+    {
+	{ 0,			   { 0xffff, 0x0000, 0x0000, 0xffff } },
+	{ pixman_fixed_1 / 3,	   { 0x0000, 0xffff, 0x0000, 0x8000 } },
+	{ pixman_fixed_1,	   { 0x0000, 0x0000, 0xffff, 0xffff } },
+    };
+    pixman_point_fixed_t inner, outer;
+    pixman_image_t *image;
+
+    inner.x = pixman_int_to_fixed (width / 2);
+    inner.y = pixman_int_to_fixed (height / 2);
+    outer.x = pixman_int_to_fixed (width / 2 + width / 8);
+    outer.y = inner.y;
+
+    if (flags & CONICAL_FLAG)
+    {
+	image = pixman_image_create_conical_gradient (
+	    &inner, pixman_int_to_fixed (30), stops, ARRAY_LENGTH (stops));
+    }
+    else
+    {
+	image = pixman_image_create_radial_gradient (
+	    &inner, &outer, 0, pixman_int_to_fixed (MAX (width, height)),
+	    stops, ARRAY_LENGTH (stops));
+    }
+
+    if (flags & LUT_FLAG)
+	pixman_image_set_gradient_precision (image, PIXMAN_GRADIENT_LUT);
+
+    return image;
+}
+
 static void
-pixman_image_composite_wrapper (pixman_implementation_t *impl,
-				pixman_composite_info_t *info)
+setup_source (pixman_image_t *image, const bench_case_t *bc)
 {
-    if (use_scaling)
+    pixman_transform_t t;
+
+    pixman_image_set_repeat (image, bc->repeat);
+    pixman_image_set_filter (image, bc->filter, NULL, 0);
+
+    switch (bc->transform)
     {
-        pixman_image_set_filter (info->src_image, filter, NULL, 0);
-        pixman_image_set_transform(info->src_image, &m);
+    case TRANSFORM_NONE:
+	break;
+
+    case TRANSFORM_SCALE:
+	pixman_image_set_transform (image, &m);
+	break;
+
+    case TRANSFORM_ROTATE:
+	/* 10 degrees around the center of the buffer */
+	pixman_transform_init_translate (&t, pixman_int_to_fixed (-WIDTH / 2),
+					 pixman_int_to_fixed (-HEIGHT / 2));
+	pixman_transform_rotate (&t, NULL, pixman_double_to_fixed (0.98480775),
+				 pixman_double_to_fixed (0.17364818));
+	pixman_transform_translate (&t, NULL, pixman_int_to_fixed (WIDTH / 2),
+				    pixman_int_to_fixed (HEIGHT / 2));
+	pixman_image_set_transform (image, &t);
+	break;
     }
+}
+
+static void
+pixman_image_composite_wrapper (pixman_implementation_t *impl,
+				pixman_composite_info_t *info)
+{
     pixman_image_composite (info->op,
 			    info->src_image, info->mask_image, info->dest_image,
 			    info->src_x, info->src_y,
@@ -122,11 +348,6 @@ static void
 pixman_image_composite_empty (pixman_implementation_t *impl,
 			      pixman_composite_info_t *info)
 {
-    if (use_scaling)
-    {
-        pixman_image_set_filter (info->src_image, filter, NULL, 0);
-        pixman_image_set_transform(info->src_image, &m);
-    }
     pixman_image_composite (info->op,
 			    info->src_image, info->mask_image, info->dest_image,
 			    0, 0, 0, 0, 0, 0, 1, 1);
@@ -366,15 +587,142 @@ bench_RT (pixman_op_t              op,
     return pix_cnt;
 }
 
+enum
+{
+    RESULT_L1,
+    RESULT_L2,
+    RESULT_M,
+    RESULT_M_PERCENT,
+    RESULT_HT,
+    RESULT_VT,
+    RESULT_R,
+    RESULT_RT,
+    RESULT_RT_KOPS,
+    N_RESULTS
+};
+
+static const char *const result_names[N_RESULTS] =
+{
+    "L1", "L2", "M", "M_percent", "HT", "VT", "R", "RT", "RT_kops"
+};
+
+static int n_rows;
+
+static const char *
+op_short_name (int op, char *buf)
+{
+    const char *name = operator_name (op) + strlen ("PIXMAN_OP_");
+    int i;
+
+    for (i = 0; name[i] && i < 63; ++i)
+	buf[i] = tolower ((unsigned char)name[i]);
+    buf[i] = 0;
+
+    return buf;
+}
+
+static const char *
+filter_name (pixman_filter_t filter)
+{
+    int i;
+
+    for (i = 0; i < ARRAY_LENGTH (filter_names); ++i)
+    {
+	if (filter_names[i].filter == filter)
+	    return filter_names[i].name;
+    }
+
+    return "unknown";
+}
+
+/* Prints one finished benchmark as a CSV line or a JSON object. When a
+ * label is given the output is meant to be concatenated with that of
+ * other runs, so the CSV header and the brackets and commas of the JSON
+ * array are left to whoever does that.
+ */
+static void
+print_row (const bench_case_t *bc, const double *results)
+{
+    const char *fields[11];
+    char op_name[64];
+    char size[32];
+    int i;
+
+    snprintf (size, sizeof (size), "%dx%d", WIDTH, HEIGHT);
+
+    fields[0] = label ? label : implementation;
+    fields[1] = bc->name;
+    fields[2] = stores;
+    fields[3] = op_short_name (bc->op, op_name);
+    if (bc->src_flags & SOLID_FLAG)
+	fields[4] = "solid";
+    else if (gradient_name (bc->src_flags))
+	fields[4] = gradient_name (bc->src_flags);
+    else
+	fields[4] = format_name (bc->src_fmt);
+    if (bc->mask_fmt == PIXMAN_null)
+	fields[5] = "none";
+    else if (bc->mask_flags & SOLID_FLAG)
+	fields[5] = "solid";
+    else
+	fields[5] = format_name (bc->mask_fmt);
+    fields[6] = format_name (bc->dst_fmt);
+    fields[7] = repeat_names[bc->repeat];
+    fields[8] = filter_name (bc->filter);
+    fields[9] = transform_names[bc->transform];
+    fields[10] = size;
+
+    if (output_format == OUTPUT_CSV)
+    {
+	for (i = 0; i < ARRAY_LENGTH (fields); ++i)
+	    printf ("%s,", fields[i]);
+	printf ("%d", !!(bc->mask_flags & CA_FLAG));
+	for (i = 0; i < N_RESULTS; ++i)
+	    printf (",%.2f", results[i]);
+	printf ("\n");
+    }
+    else
+    {
+	static const char *const keys[] =
+	{
+	    "implementation", "test", "stores", "op", "src", "mask", "dest",
+	    "repeat", "filter", "transform", "size"
+	};
+
+	if (!label)
+	    printf (n_rows ? ",\n" : "[\n");
+
+	printf ("{");
+	for (i = 0; i < ARRAY_LENGTH (fields); ++i)
+	    printf ("\"%s\": \"%s\", ", keys[i], fields[i]);
+	printf ("\"component_alpha\": %s", (bc->mask_flags & CA_FLAG) ? "true" : "false");
+	for (i = 0; i < N_RESULTS; ++i)
+	    printf (", \"%s\": %.2f", result_names[i], results[i]);
+	printf ("}");
+
+	if (label)
+	    printf ("\n");
+    }
+
+    n_rows++;
+    fflush (stdout);
+}
+
+static void
+print_csv_header (void)
+{
+    int i;
+
+    printf ("implementation,test,stores,op,src,mask,dest,repeat,filter,"
+	    "transform,size,component_alpha");
+    for (i = 0; i < N_RESULTS; ++i)
+	printf (",%s", result_names[i]);
+    printf ("\n");
+}
+
 void
-bench_composite (char * testname,
-                 int    src_fmt,
-                 int    src_flags,
-                 int    op,
-                 int    mask_fmt,
-                 int    mask_flags,
-                 int    dst_fmt,
-                 double npix)
+bench_composite (const bench_case_t *bc,
+                 double              npix)
 {
     pixman_image_t *                src_img;
     pixman_image_t *                dst_img;
@@ -385,10 +733,25 @@ bench_composite (char * testname,
     double                          t1, t2, t3, pix_cnt;
     int64_t                         n, l1test_width, nlines;
     double                             bytes_per_pix = 0;
+    double                          results[N_RESULTS];
+    int                             src_fmt = bc->src_fmt;
+    int                             src_flags = bc->src_flags;
+    int                             op = bc->op;
+    int                             mask_fmt = bc->mask_fmt;
+    int                             mask_flags = bc->mask_flags;
+    int                             dst_fmt = bc->dst_fmt;
+    pixman_bool_t                   text = output_format == OUTPUT_TEXT;
 
     pixman_composite_func_t func = pixman_image_composite_wrapper;
 
-    if (!(src_flags & SOLID_FLAG))
+    if (gradient_name (src_flags))
+    {
+        src_img = create_gradient (src_flags, WIDTH, HEIGHT);
+        xsrc_img = create_gradient (src_flags, XWIDTH, XHEIGHT);
+        setup_source (src_img, bc);
+        setup_source (xsrc_img, bc);
+    }
+    else if (!(src_flags & SOLID_FLAG))
     {
         bytes_per_pix += (src_fmt >> 24) / 8.0;
         src_img = pixman_image_create_bits (src_fmt,
@@ -399,6 +762,8 @@ bench_composite (char * testname,
                                              XWIDTH, XHEIGHT,
                                              src,
                                              XWIDTH * 4);
+        setup_source (src_img, bc);
+        setup_source (xsrc_img, bc);
     }
     else
     {
@@ -457,8 +822,11 @@ bench_composite (char * testname,
                                          XWIDTH * 4);
 
 
-    printf ("%24s %c", testname, func != pixman_image_composite_wrapper ?
-            '-' : '=');
+    if (text)
+    {
+	printf ("%24s %c", bc->name, func != pixman_image_composite_wrapper ?
+		'-' : '=');
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -476,9 +844,13 @@ bench_composite (char * testname,
     t2 = gettime ();
     bench_L (op, src_img, mask_img, dst_img, n, func, l1test_width, 1);
     t3 = gettime ();
-    printf ("  L1:%7.2f", (double)n * l1test_width * 1 /
-            ((t3 - t2) - (t2 - t1)) / 1000000.);
-    fflush (stdout);
+    results[RESULT_L1] = (double)n * l1test_width * 1 /
+	((t3 - t2) - (t2 - t1)) / 1000000.;
+    if (text)
+    {
+	printf ("  L1:%7.2f", results[RESULT_L1]);
+	fflush (stdout);
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -495,9 +867,13 @@ bench_composite (char * testname,
     t2 = gettime ();
     bench_L (op, src_img, mask_img, dst_img, n, func, l1test_width, nlines);
     t3 = gettime ();
-    printf ("  L2:%7.2f", (double)n * l1test_width * nlines /
-            ((t3 - t2) - (t2 - t1)) / 1000000.);
-    fflush (stdout);
+    results[RESULT_L2] = (double)n * l1test_width * nlines /
+	((t3 - t2) - (t2 - t1)) / 1000000.;
+    if (text)
+    {
+	printf ("  L2:%7.2f", results[RESULT_L2]);
+	fflush (stdout);
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -510,10 +886,16 @@ bench_composite (char * testname,
     t2 = gettime ();
     bench_M (op, src_img, mask_img, dst_img, n, func);
     t3 = gettime ();
-    printf ("  M:%6.2f (%6.2f%%)",
-        ((double)n * (WIDTH - 64) * HEIGHT / ((t3 - t2) - (t2 - t1))) / 1000000.,
-        ((double)n * (WIDTH - 64) * HEIGHT / ((t3 - t2) - (t2 - t1)) * bytes_per_pix) * (100.0 / bandwidth) );
-    fflush (stdout);
+    results[RESULT_M] =
+	((double)n * (WIDTH - 64) * HEIGHT / ((t3 - t2) - (t2 - t1))) / 1000000.;
+    results[RESULT_M_PERCENT] =
+	((double)n * (WIDTH - 64) * HEIGHT / ((t3 - t2) - (t2 - t1)) * bytes_per_pix) * (100.0 / bandwidth);
+    if (text)
+    {
+	printf ("  M:%6.2f (%6.2f%%)",
+		results[RESULT_M], results[RESULT_M_PERCENT]);
+	fflush (stdout);
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -526,8 +908,12 @@ bench_composite (char * testname,
     t2 = gettime ();
     pix_cnt = bench_HT (op, src_img, mask_img, dst_img, n, func);
     t3 = gettime ();
-    printf ("  HT:%6.2f", (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.);
-    fflush (stdout);
+    results[RESULT_HT] = (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.;
+    if (text)
+    {
+	printf ("  HT:%6.2f", results[RESULT_HT]);
+	fflush (stdout);
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -540,8 +926,12 @@ bench_composite (char * testname,
     t2 = gettime ();
     pix_cnt = bench_VT (op, src_img, mask_img, dst_img, n, func);
     t3 = gettime ();
-    printf ("  VT:%6.2f", (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.);
-    fflush (stdout);
+    results[RESULT_VT] = (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.;
+    if (text)
+    {
+	printf ("  VT:%6.2f", results[RESULT_VT]);
+	fflush (stdout);
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -554,8 +944,12 @@ bench_composite (char * testname,
     t2 = gettime ();
     pix_cnt = bench_R (op, src_img, mask_img, dst_img, n, func, WIDTH, HEIGHT);
     t3 = gettime ();
-    printf ("  R:%6.2f", (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.);
-    fflush (stdout);
+    results[RESULT_R] = (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.;
+    if (text)
+    {
+	printf ("  R:%6.2f", results[RESULT_R]);
+	fflush (stdout);
+    }
 
     memcpy (src, dst, BUFSIZE);
     memcpy (dst, src, BUFSIZE);
@@ -568,7 +962,12 @@ bench_composite (char * testname,
     t2 = gettime ();
     pix_cnt = bench_RT (op, src_img, mask_img, dst_img, n, func, WIDTH, HEIGHT);
     t3 = gettime ();
-    printf ("  RT:%6.2f (%4.0fKops/s)\n", (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000., (double) n / ((t3 - t2) * 1000));
+    results[RESULT_RT] = (double)pix_cnt / ((t3 - t2) - (t2 - t1)) / 1000000.;
+    results[RESULT_RT_KOPS] = (double) n / ((t3 - t2) * 1000);
+    if (text)
+	printf ("  RT:%6.2f (%4.0fKops/s)\n", results[RESULT_RT], results[RESULT_RT_KOPS]);
+    else
+	print_row (bc, results);
 
     if (mask_img) {
 	pixman_image_unref (mask_img);
@@ -707,47 +1106,637 @@ tests_tbl[] =
     { "outrev_n_8888_x888_ca", PIXMAN_a8r8g8b8,    1, PIXMAN_OP_OUT_REV, PIXMAN_a8r8g8b8, 2, PIXMAN_x8r8g8b8 },
     { "outrev_n_8888_8888_ca", PIXMAN_a8r8g8b8,    1, PIXMAN_OP_OUT_REV, PIXMAN_a8r8g8b8, 2, PIXMAN_a8r8g8b8 },
     { "over_reverse_n_8888",   PIXMAN_a8r8g8b8,    0, PIXMAN_OP_OVER_REVERSE, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "src_radial_8888",       PIXMAN_a8r8g8b8,    RADIAL_FLAG, PIXMAN_OP_SRC, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "src_radial-lut_8888",   PIXMAN_a8r8g8b8,    RADIAL_FLAG | LUT_FLAG, PIXMAN_OP_SRC, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "over_radial_8888",      PIXMAN_a8r8g8b8,    RADIAL_FLAG, PIXMAN_OP_OVER, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "over_radial-lut_8888",  PIXMAN_a8r8g8b8,    RADIAL_FLAG | LUT_FLAG, PIXMAN_OP_OVER, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "src_conical_8888",      PIXMAN_a8r8g8b8,    CONICAL_FLAG, PIXMAN_OP_SRC, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "src_conical-lut_8888",  PIXMAN_a8r8g8b8,    CONICAL_FLAG | LUT_FLAG, PIXMAN_OP_SRC, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "over_conical_8888",     PIXMAN_a8r8g8b8,    CONICAL_FLAG, PIXMAN_OP_OVER, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
+    { "over_conical-lut_8888", PIXMAN_a8r8g8b8,    CONICAL_FLAG | LUT_FLAG, PIXMAN_OP_OVER, PIXMAN_null, 0, PIXMAN_a8r8g8b8 },
 };
 
-int
-main (int argc, char *argv[])
+/*
+ * Selecting the tests to run
+ */
+static struct
+{
+    const char *	pattern;
+    pixman_bool_t	have_op, have_src, have_mask, have_dest;
+    int			op;
+    int			src_fmt, src_flags;
+    int			mask_fmt, mask_flags;
+    int			dst_fmt;
+    pixman_bool_t	have_repeat, have_filter, have_transform;
+    pixman_repeat_t	repeat;
+    pixman_filter_t	filter;
+    transform_kind_t	transform;
+    pixman_bool_t	fast_paths;
+    pixman_bool_t	component_alpha;
+    const char *	implementations;
+} selection =
+{
+    NULL,
+    FALSE, FALSE, FALSE, FALSE,
+    PIXMAN_OP_NONE,
+    PIXMAN_null, 0,
+    PIXMAN_null, 0,
+    PIXMAN_null,
+    FALSE, FALSE, FALSE,
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_FILTER_NEAREST,
+    TRANSFORM_NONE,
+    FALSE,
+    FALSE,
+    NULL
+};
+
+static bench_case_t *cases;
+static int n_cases;
+
+/* The names used for formats in the names of the tests */
+static const struct
+{
+    const char *		name;
+    pixman_format_code_t	format;
+} short_format_names[] =
+{
+    { "8888",	PIXMAN_a8r8g8b8 },
+    { "x888",	PIXMAN_x8r8g8b8 },
+    { "0888",	PIXMAN_r8g8b8 },
+    { "0565",	PIXMAN_r5g6b5 },
+    { "1555",	PIXMAN_a1r5g5b5 },
+    { "4444",	PIXMAN_a4r4g4b4 },
+    { "2222",	PIXMAN_a2r2g2b2 },
+    { "2x10",	PIXMAN_x2r10g10b10 },
+    { "2a10",	PIXMAN_a2r10g10b10 },
+    { "8",	PIXMAN_a8 },
+};
+
+static const char *
+short_format_name (int format)
 {
-    double x;
     int i;
-    const char *pattern = NULL;
-    for (i = 1; i < argc; i++)
+
+    for (i = 0; i < ARRAY_LENGTH (short_format_names); ++i)
     {
-	if (argv[i][0] == '-')
+	if (short_format_names[i].format == format)
+	    return short_format_names[i].name;
+    }
+
+    return format_name (format);
+}
+
+/* Whether images of this format can be benchmarked without any further
+ * setup such as a palette.
+ */
+static pixman_bool_t
+is_bench_format (int format)
+{
+    int type = PIXMAN_FORMAT_TYPE (format);
+
+    return PIXMAN_FORMAT_BPP (format) != 0			&&
+	PIXMAN_FORMAT_BPP (format) <= 32			&&
+	type != PIXMAN_TYPE_COLOR && type != PIXMAN_TYPE_GRAY	&&
+	type != PIXMAN_TYPE_YUY2 && type != PIXMAN_TYPE_YV12	&&
+	pixman_format_supported_source (format);
+}
+
+/* Parses "n" or "solid", "none" (masks only), one of the short names
+ * or anything format_from_string() knows about.
+ */
+static pixman_bool_t
+parse_format (const char *s, pixman_bool_t is_mask, int *format, int *flags)
+{
+    int i;
+
+    *flags = 0;
+
+    if (strcmp (s, "n") == 0 || strcmp (s, "solid") == 0)
+    {
+	*format = is_mask ? PIXMAN_a8 : PIXMAN_a8r8g8b8;
+	*flags = SOLID_FLAG;
+	return TRUE;
+    }
+
+    if (is_mask && strcmp (s, "none") == 0)
+    {
+	*format = PIXMAN_null;
+	return TRUE;
+    }
+
+    for (i = 0; i < ARRAY_LENGTH (gradient_names) && !is_mask; ++i)
+    {
+	if (strcmp (gradient_names[i].name, s) == 0)
 	{
-	    if (strchr (argv[i] + 1, 'b'))
-	    {
-		use_scaling = TRUE;
-		filter = PIXMAN_FILTER_BILINEAR;
-	    }
-	    else if (strchr (argv[i] + 1, 'n'))
+	    *format = PIXMAN_a8r8g8b8;
+	    *flags = gradient_names[i].flags;
+	    return TRUE;
+	}
+    }
+
+    for (i = 0; i < ARRAY_LENGTH (short_format_names); ++i)
+    {
+	if (strcmp (short_format_names[i].name, s) == 0)
+	{
+	    *format = short_format_names[i].format;
+	    return TRUE;
+	}
+    }
+
+    *format = format_from_string (s);
+
+    return is_bench_format (*format);
+}
+
+static void
+make_case_name (bench_case_t *bc)
+{
+    char op_name[64];
+    const char *src_name;
+    int n;
+
+    if (bc->src_flags & SOLID_FLAG)
+	src_name = "n";
+    else if (gradient_name (bc->src_flags))
+	src_name = gradient_name (bc->src_flags);
+    else
+	src_name = short_format_name (bc->src_fmt);
+
+    n = snprintf (bc->name, sizeof (bc->name), "%s_%s",
+		  op_short_name (bc->op, op_name), src_name);
+
+    if (bc->mask_fmt != PIXMAN_null)
+    {
+	n += snprintf (bc->name + n, sizeof (bc->name) - n, "_%s",
+		       (bc->mask_flags & SOLID_FLAG) ?
+		       "n" : short_format_name (bc->mask_fmt));
+    }
+
+    n += snprintf (bc->name + n, sizeof (bc->name) - n, "_%s",
+		   short_format_name (bc->dst_fmt));
+
+    if (bc->mask_flags & CA_FLAG)
+	n += snprintf (bc->name + n, sizeof (bc->name) - n, "_ca");
+
+    if (bc->transform == TRANSFORM_ROTATE)
+	n += snprintf (bc->name + n, sizeof (bc->name) - n, "_rotate");
+
+    if (bc->transform != TRANSFORM_NONE)
+    {
+	snprintf (bc->name + n, sizeof (bc->name) - n, "_%s_%s",
+		  filter_name (bc->filter), repeat_names[bc->repeat]);
+    }
+}
+
+static pixman_bool_t
+is_selected (const bench_case_t *bc)
+{
+    if (selection.pattern && strcmp (selection.pattern, "all") != 0 &&
+	strcmp (selection.pattern, bc->name) != 0)
+    {
+	return FALSE;
+    }
+
+    if (selection.have_op && bc->op != selection.op)
+	return FALSE;
+
+    if (selection.have_src &&
+	(bc->src_fmt != selection.src_fmt ||
+	 (bc->src_flags & SOURCE_KIND_FLAGS) != selection.src_flags))
+    {
+	return FALSE;
+    }
+
+    if (selection.have_mask &&
+	(bc->mask_fmt != selection.mask_fmt ||
+	 (bc->mask_flags & SOLID_FLAG) != selection.mask_flags))
+    {
+	return FALSE;
+    }
+
+    if (selection.component_alpha && !(bc->mask_flags & CA_FLAG))
+	return FALSE;
+
+    if (selection.have_dest && bc->dst_fmt != selection.dst_fmt)
+	return FALSE;
+
+    if (selection.have_repeat && bc->repeat != selection.repeat)
+	return FALSE;
+
+    if (selection.have_filter && bc->filter != selection.filter)
+	return FALSE;
+
+    if (selection.have_transform && bc->transform != selection.transform)
+	return FALSE;
+
+    return TRUE;
+}
+
+static void
+add_case (const bench_case_t *bc)
+{
+    int i;
+
+    if (!is_selected (bc))
+	return;
+
+    for (i = 0; i < n_cases; ++i)
+    {
+	if (strcmp (cases[i].name, bc->name) == 0)
+	    return;
+    }
+
+    cases = realloc (cases, (n_cases + 1) * sizeof (bench_case_t));
+    cases[n_cases++] = *bc;
+}
+
+/* Turns a fast path table entry into a benchmark that should end up
+ * using it, as far as that is possible with the images used here.
+ */
+static pixman_bool_t
+case_from_fast_path (const pixman_fast_path_t *info, bench_case_t *bc)
+{
+    uint32_t flags = info->src_flags;
+
+    if (info->op >= PIXMAN_N_OPERATORS)
+	return FALSE;
+
+    if (flags & (FAST_PATH_ROTATE_90_TRANSFORM	|
+		 FAST_PATH_ROTATE_180_TRANSFORM	|
+		 FAST_PATH_ROTATE_270_TRANSFORM))
+    {
+	return FALSE;
+    }
+
+    memset (bc, 0, sizeof (*bc));
+
+    bc->op = info->op;
+
+    if (info->src_format == PIXMAN_solid)
+    {
+	bc->src_fmt = PIXMAN_a8r8g8b8;
+	bc->src_flags = SOLID_FLAG;
+    }
+    else if (is_bench_format (info->src_format))
+    {
+	bc->src_fmt = info->src_format;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    if (info->mask_format == PIXMAN_solid)
+    {
+	bc->mask_fmt = (info->mask_flags & FAST_PATH_COMPONENT_ALPHA) ?
+	    PIXMAN_a8r8g8b8 : PIXMAN_a8;
+	bc->mask_flags = SOLID_FLAG;
+    }
+    else if (info->mask_format == PIXMAN_null ||
+	     is_bench_format (info->mask_format))
+    {
+	bc->mask_fmt = info->mask_format;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    if (info->mask_format != PIXMAN_null &&
+	(info->mask_flags & FAST_PATH_COMPONENT_ALPHA))
+    {
+	bc->mask_flags |= CA_FLAG;
+    }
+
+    if (!is_bench_format (info->dest_format))
+	return FALSE;
+    bc->dst_fmt = info->dest_format;
+
+    bc->filter = (flags & FAST_PATH_BILINEAR_FILTER) ?
+	PIXMAN_FILTER_BILINEAR : PIXMAN_FILTER_NEAREST;
+
+    if (info->src_format != PIXMAN_solid && !(flags & FAST_PATH_ID_TRANSFORM) &&
+	(flags & (FAST_PATH_SCALE_TRANSFORM	|
+		  FAST_PATH_AFFINE_TRANSFORM	|
+		  FAST_PATH_HAS_TRANSFORM	|
+		  FAST_PATH_BILINEAR_FILTER)))
+    {
+	bc->transform = TRANSFORM_SCALE;
+    }
+
+    if ((flags & FAST_PATH_NORMAL_REPEAT) == FAST_PATH_NORMAL_REPEAT)
+	bc->repeat = PIXMAN_REPEAT_NORMAL;
+    else if ((flags & FAST_PATH_PAD_REPEAT) == FAST_PATH_PAD_REPEAT)
+	bc->repeat = PIXMAN_REPEAT_PAD;
+    else if ((flags & FAST_PATH_REFLECT_REPEAT) == FAST_PATH_REFLECT_REPEAT)
+	bc->repeat = PIXMAN_REPEAT_REFLECT;
+    else
+	bc->repeat = PIXMAN_REPEAT_NONE;
+
+    make_case_name (bc);
+
+    return TRUE;
+}
+
+static void
+select_cases (void)
+{
+    int i;
+
+    if (selection.fast_paths)
+    {
+	pixman_implementation_t *imp;
+
+	for (imp = _pixman_internal_only_get_implementation ();
+	     imp != NULL;
+	     imp = imp->fallback)
+	{
+	    const pixman_fast_path_t *info;
+
+	    for (info = imp->fast_paths; info->op != PIXMAN_OP_NONE; ++info)
 	    {
-		use_scaling = TRUE;
-		filter = PIXMAN_FILTER_NEAREST;
+		bench_case_t bc;
+
+		if (case_from_fast_path (info, &bc))
+		    add_case (&bc);
 	    }
 	}
+    }
+    else
+    {
+	for (i = 0; i < ARRAY_LENGTH (tests_tbl); i++)
+	{
+	    bench_case_t bc;
+
+	    snprintf (bc.name, sizeof (bc.name), "%s", tests_tbl[i].testname);
+	    bc.src_fmt = tests_tbl[i].src_fmt;
+	    bc.src_flags = tests_tbl[i].src_flags;
+	    bc.op = tests_tbl[i].op;
+	    bc.mask_fmt = tests_tbl[i].mask_fmt;
+	    bc.mask_flags = tests_tbl[i].mask_flags;
+	    bc.dst_fmt = tests_tbl[i].dst_fmt;
+	    bc.repeat = selection.repeat;
+	    bc.filter = selection.filter;
+	    bc.transform = selection.transform;
+
+	    add_case (&bc);
+	}
+    }
+
+    /* Anything fully described on the command line can be run, even if
+     * it isn't in the list.
+     */
+    if (n_cases == 0 && !selection.pattern &&
+	selection.have_op && selection.have_src && selection.have_dest)
+    {
+	bench_case_t bc;
+
+	bc.op = selection.op;
+	bc.src_fmt = selection.src_fmt;
+	bc.src_flags = selection.src_flags;
+	bc.mask_fmt = selection.mask_fmt;
+	bc.mask_flags = selection.mask_flags;
+	if (selection.component_alpha && bc.mask_fmt != PIXMAN_null)
+	    bc.mask_flags |= CA_FLAG;
+	bc.dst_fmt = selection.dst_fmt;
+	bc.repeat = selection.repeat;
+	bc.filter = selection.filter;
+	bc.transform = selection.transform;
+	make_case_name (&bc);
+
+	add_case (&bc);
+    }
+}
+
+/*
+ * Comparing implementations
+ *
+ * Every implementation is benchmarked with the chain cut off above it,
+ * so that it handles everything it has fast paths for and leaves the
+ * rest to the implementations below.
+ */
+static void
+run_cases (void)
+{
+    int i;
+
+    for (i = 0; i < n_cases; i++)
+    {
+	if (compare_streaming)
+	{
+	    bench_case_t nt = cases[i];
+
+	    stores = "cached";
+	    pixman_set_streaming_threshold (0);
+	    bench_composite (&cases[i], bandwidth/8);
+
+	    if (output_format == OUTPUT_TEXT)
+		snprintf (nt.name, sizeof (nt.name), "%.80s (nt)", cases[i].name);
+
+	    stores = "streaming";
+	    pixman_set_streaming_threshold (1);
+	    bench_composite (&nt, bandwidth/8);
+	}
 	else
 	{
-	    pattern = argv[i];
+	    bench_composite (&cases[i], bandwidth/8);
 	}
     }
+}
 
-    if (!pattern)
+static int
+compare_implementations (void)
+{
+    const char *s = selection.implementations;
+    int ok = TRUE;
+
+    while (*s)
     {
-	printf ("Usage: lowlevel-blt-bench [-b] [-n] pattern\n");
-	printf ("  -n : benchmark nearest scaling\n");
-	printf ("  -b : benchmark bilinear scaling\n");
-	return 1;
+	char name[64];
+	int len = strcspn (s, ",");
+
+	snprintf (name, sizeof (name), "%.*s", len, s);
+
+	if (pixman_set_implementations (name, NULL))
+	{
+	    implementation = name;
+
+	    if (output_format == OUTPUT_TEXT)
+		printf ("--- %s\n", name);
+
+	    run_cases ();
+	}
+	else
+	{
+	    fprintf (stderr, "Implementation '%s' is not available\n", name);
+	    ok = FALSE;
+	}
+
+	s += len;
+	if (*s)
+	    s++;
     }
 
-    src = aligned_malloc (4096, BUFSIZE * 3);
-    memset (src, 0xCC, BUFSIZE * 3);
-    dst = src + (BUFSIZE / 4);
-    mask = dst + (BUFSIZE / 4);
+    implementation = "default";
+    pixman_set_implementations (NULL, NULL);
+
+    return ok ? 0 : 1;
+}
+
+static pixman_bool_t
+parse_long_option (const char *opt)
+{
+    const char *value = strchr (opt, '=');
+    int len = value ? value - opt : strlen (opt);
+    int i;
+
+#define IS_OPTION(name)							\
+    (len == strlen (name) && strncmp (opt, name, len) == 0)
+
+    if (value)
+	value++;
+
+    if (!value)
+    {
+	if (IS_OPTION ("csv"))
+	    output_format = OUTPUT_CSV;
+	else if (IS_OPTION ("json"))
+	    output_format = OUTPUT_JSON;
+	else if (IS_OPTION ("fast-paths"))
+	    selection.fast_paths = TRUE;
+	else if (IS_OPTION ("ca"))
+	    selection.component_alpha = TRUE;
+	else
+	    return FALSE;
+    }
+    else if (IS_OPTION ("op"))
+    {
+	selection.op = operator_from_string (value);
+	selection.have_op = TRUE;
+	return selection.op != PIXMAN_OP_NONE;
+    }
+    else if (IS_OPTION ("src"))
+    {
+	selection.have_src = TRUE;
+	return parse_format (value, FALSE,
+			     &selection.src_fmt, &selection.src_flags);
+    }
+    else if (IS_OPTION ("mask"))
+    {
+	selection.have_mask = TRUE;
+	return parse_format (value, TRUE,
+			     &selection.mask_fmt, &selection.mask_flags);
+    }
+    else if (IS_OPTION ("dest"))
+    {
+	int flags;
+
+	selection.have_dest = TRUE;
+	return parse_format (value, FALSE, &selection.dst_fmt, &flags) &&
+	    flags == 0;
+    }
+    else if (IS_OPTION ("size"))
+    {
+	if (sscanf (value, "%dx%d", &bench_width, &bench_height) != 2 ||
+	    bench_width <= 64 + TILEWIDTH * 2 || bench_height <= TILEWIDTH * 2)
+	{
+	    fprintf (stderr, "The size must be at least %dx%d\n",
+		     64 + TILEWIDTH * 2 + 1, TILEWIDTH * 2 + 1);
+	    return FALSE;
+	}
+    }
+    else if (IS_OPTION ("repeat"))
+    {
+	for (i = 0; i < ARRAY_LENGTH (repeat_names); ++i)
+	{
+	    if (strcmp (repeat_names[i], value) == 0)
+		break;
+	}
+	if (i == ARRAY_LENGTH (repeat_names))
+	    return FALSE;
+
+	selection.repeat = i;
+	selection.have_repeat = TRUE;
+    }
+    else if (IS_OPTION ("filter"))
+    {
+	for (i = 0; i < ARRAY_LENGTH (filter_names); ++i)
+	{
+	    if (strcmp (filter_names[i].name, value) == 0)
+		break;
+	}
+	if (i == ARRAY_LENGTH (filter_names))
+	    return FALSE;
+
+	selection.filter = filter_names[i].filter;
+	selection.have_filter = TRUE;
+    }
+    else if (IS_OPTION ("transform"))
+    {
+	for (i = 0; i < ARRAY_LENGTH (transform_names); ++i)
+	{
+	    if (strcmp (transform_names[i], value) == 0)
+		break;
+	}
+	if (i == ARRAY_LENGTH (transform_names))
+	    return FALSE;
+
+	selection.transform = i;
+	selection.have_transform = TRUE;
+    }
+    else if (IS_OPTION ("impl"))
+    {
+	selection.implementations = value;
+    }
+    else if (IS_OPTION ("label"))
+    {
+	label = value;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+#undef IS_OPTION
+
+    return TRUE;
+}
+
+static void
+usage (void)
+{
+    printf ("Usage: lowlevel-blt-bench [options] [pattern]\n");
+    printf ("  pattern : the name of a test, or 'all'\n");
+    printf ("  -n : benchmark nearest scaling\n");
+    printf ("  -b : benchmark bilinear scaling\n");
+    printf ("  -s : run each test with cached and with streaming stores\n");
+    printf ("  --csv, --json : print the results as CSV or as a JSON array\n");
+    printf ("  --op=OP, --src=FORMAT, --mask=FORMAT, --dest=FORMAT, --ca :\n");
+    printf ("         only run tests with this operator or these images. A\n");
+    printf ("         format may be 'n' for a solid image and the mask 'none'.\n");
+    printf ("         The source may also be 'radial', 'radial-lut', 'conical'\n");
+    printf ("         or 'conical-lut' for a gradient with precise colors or a\n");
+    printf ("         lookup table.\n");
+    printf ("         A test that is fully described but not in the list is\n");
+    printf ("         run anyway\n");
+    printf ("  --repeat=none|normal|pad|reflect, --filter=nearest|bilinear|...,\n");
+    printf ("  --transform=none|scale|rotate : how to set up the source\n");
+    printf ("  --size=WxH : the size of the images (default 1920x1080)\n");
+    printf ("  --fast-paths : instead of the built in list, run one test for\n");
+    printf ("         every entry in the fast path tables of this machine\n");
+    printf ("  --impl=NAME[,NAME...] : run everything once with each of the\n");
+    printf ("         given implementations on top, for example\n");
+    printf ("         --impl=general,fast,sse2,avx2\n");
+    printf ("  --label=NAME : name the implementation in the results and\n");
+    printf ("         leave out the header, for combining the output of\n");
+    printf ("         several runs\n");
+}
+
+static void
+print_intro (void)
+{
+    double x, cached;
 
     printf ("Benchmark for a set of most commonly used functions\n");
     printf ("---\n");
@@ -775,37 +1764,114 @@ main (int argc, char *argv[])
             WIDTH, HEIGHT);
     printf ("RT  - as R, but %dx%d average sized rectangles are copied\n",
             TINYWIDTH, TINYWIDTH);
+    if (compare_streaming)
+    {
+	printf ("(nt) - the same test with fills and copies of any size using\n");
+	printf ("      non-temporal stores where the implementation has them\n");
+    }
     printf ("---\n");
-    bandwidth = x = bench_memcpy ();
+    x = bandwidth;
     printf ("reference memcpy speed = %.1fMB/s (%.1fMP/s for 32bpp fills)\n",
             x / 1000000., x / 4000000);
-    if (use_scaling)
+    x = bench_lookup (&cached);
+    printf ("fast path lookup = %.0fns per uncached lookup (%.0fns per cached 1x1 composite)\n",
+            x, cached);
+    if (selection.transform != TRANSFORM_NONE)
     {
 	printf ("---\n");
-	if (filter == PIXMAN_FILTER_BILINEAR)
-	    printf ("BILINEAR scaling\n");
-	else if (filter == PIXMAN_FILTER_NEAREST)
-	    printf ("NEAREST scaling\n");
+	if (selection.filter == PIXMAN_FILTER_BILINEAR)
+	    printf ("BILINEAR ");
+	else if (selection.filter == PIXMAN_FILTER_NEAREST)
+	    printf ("NEAREST ");
+	else
+	    printf ("UNKNOWN ");
+	if (selection.transform == TRANSFORM_SCALE)
+	    printf ("scaling\n");
 	else
-	    printf ("UNKNOWN scaling\n");
+	    printf ("rotation\n");
     }
     printf ("---\n");
+}
 
-    for (i = 0; i < ARRAY_LENGTH (tests_tbl); i++)
+int
+main (int argc, char *argv[])
+{
+    pixman_bool_t have_selection;
+    int i, ret = 0;
+
+    for (i = 1; i < argc; i++)
     {
-	if (strcmp (pattern, "all") == 0 || strcmp (tests_tbl[i].testname, pattern) == 0)
+	if (strncmp (argv[i], "--", 2) == 0)
+	{
+	    if (!parse_long_option (argv[i] + 2))
+	    {
+		fprintf (stderr, "Invalid option '%s'\n", argv[i]);
+		usage ();
+		return 1;
+	    }
+	}
+	else if (argv[i][0] == '-')
+	{
+	    if (strchr (argv[i] + 1, 'b'))
+	    {
+		selection.transform = TRANSFORM_SCALE;
+		selection.filter = PIXMAN_FILTER_BILINEAR;
+	    }
+	    else if (strchr (argv[i] + 1, 'n'))
+	    {
+		selection.transform = TRANSFORM_SCALE;
+		selection.filter = PIXMAN_FILTER_NEAREST;
+	    }
+	    if (strchr (argv[i] + 1, 's'))
+		compare_streaming = TRUE;
+	}
+	else
 	{
-	    bench_composite (tests_tbl[i].testname,
-			     tests_tbl[i].src_fmt,
-			     tests_tbl[i].src_flags,
-			     tests_tbl[i].op,
-			     tests_tbl[i].mask_fmt,
-			     tests_tbl[i].mask_flags,
-			     tests_tbl[i].dst_fmt,
-			     bandwidth/8);
+	    selection.pattern = argv[i];
 	}
     }
 
+    have_selection = selection.pattern || selection.fast_paths ||
+	selection.have_op || selection.have_src ||
+	selection.have_mask || selection.have_dest;
+
+    if (!have_selection)
+    {
+	usage ();
+	return 1;
+    }
+
+    select_cases ();
+    if (n_cases == 0)
+    {
+	fprintf (stderr, "No tests match\n");
+	return 1;
+    }
+
+    src = aligned_malloc (4096, BUFSIZE * 3);
+    memset (src, 0xCC, BUFSIZE * 3);
+    dst = src + (BUFSIZE / 4);
+    mask = dst + (BUFSIZE / 4);
+
+    bandwidth = bench_memcpy ();
+
+    if (!label)
+    {
+	if (output_format == OUTPUT_TEXT)
+	    print_intro ();
+	else if (output_format == OUTPUT_CSV)
+	    print_csv_header ();
+    }
+
+    if (selection.implementations)
+	ret = compare_implementations ();
+    else
+	run_cases ();
+
+    if (output_format == OUTPUT_JSON && !label)
+	printf (n_rows ? "\n]\n" : "[]\n");
+
+    free (cases);
     free (src);
-    return 0;
+    return ret;
 }
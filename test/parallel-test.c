@@ -0,0 +1,230 @@
+/*
+ * Check that compositing through a thread pool gives exactly the same
+ * results as compositing on the calling thread. The "pool" used here
+ * runs the jobs on the calling thread in reverse order, which is enough
+ * to catch bands that overlap, are missed or depend on each other.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	200
+#define MAX_HEIGHT	200
+#define N_TESTS		3000
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a8b8g8r8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_IN_REVERSE,
+    PIXMAN_OP_XOR,
+};
+
+static const pixman_filter_t filters[] =
+{
+    PIXMAN_FILTER_NEAREST,
+    PIXMAN_FILTER_BILINEAR,
+};
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static int n_runs;
+
+static void
+run_jobs_backwards (void *pool_data, int n_jobs,
+		    pixman_job_func_t job_func, void *job_data)
+{
+    int i;
+
+    for (i = n_jobs - 1; i >= 0; --i)
+	job_func (job_data, i);
+
+    n_runs++;
+}
+
+static pixman_image_t *
+make_source (void)
+{
+    pixman_image_t *image;
+
+    if (prng_rand_n (4) == 0)
+    {
+	pixman_color_t color;
+
+	color.red = prng_rand_n (0x10000);
+	color.green = prng_rand_n (0x10000);
+	color.blue = prng_rand_n (0x10000);
+	color.alpha = prng_rand_n (0x10000);
+
+	return pixman_image_create_solid_fill (&color);
+    }
+
+    image = make_random_image (RANDOM_ELT (formats),
+			       prng_rand_n (MAX_WIDTH) + 1,
+			       prng_rand_n (MAX_HEIGHT) + 1, FALSE);
+    pixman_image_set_repeat (image, RANDOM_ELT (repeats));
+
+    if (prng_rand_n (2))
+    {
+	pixman_transform_t t;
+
+	pixman_transform_init_scale (&t,
+				     pixman_fixed_1 / 2 + prng_rand_n (pixman_fixed_1 * 2),
+				     pixman_fixed_1 / 2 + prng_rand_n (pixman_fixed_1 * 2));
+	pixman_image_set_transform (image, &t);
+	pixman_image_set_filter (image, RANDOM_ELT (filters), NULL, 0);
+    }
+
+    return image;
+}
+
+static pixman_bool_t
+test_composite (int testnum)
+{
+    pixman_image_t *src, *mask, *dest1, *dest2;
+    int width, height;
+    pixman_region32_t clip;
+    pixman_op_t op;
+    int x, y, w, h;
+    pixman_bool_t ok;
+
+    prng_srand (testnum);
+
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+
+    src = make_source ();
+
+    mask = NULL;
+    if (prng_rand_n (3) == 0)
+	mask = make_random_image (PIXMAN_a8, width, height, FALSE);
+
+    dest1 = make_random_image (RANDOM_ELT (formats), width, height, FALSE);
+    dest2 = clone_image (dest1);
+
+    /* A clip with several boxes, so bands have to cut across them */
+    pixman_region32_init_rect (&clip, 0, 0, width / 2 + 1, height / 2 + 1);
+    pixman_region32_union_rect (&clip, &clip,
+				width / 3, height / 3, width, height);
+    pixman_image_set_clip_region32 (dest1, &clip);
+    pixman_image_set_clip_region32 (dest2, &clip);
+    pixman_region32_fini (&clip);
+
+    op = RANDOM_ELT (ops);
+    x = prng_rand_n (width / 2 + 1);
+    y = prng_rand_n (height / 2 + 1);
+    w = prng_rand_n (width) + 1;
+    h = prng_rand_n (height) + 1;
+
+    pixman_set_thread_pool (NULL, NULL, 0, 0);
+    pixman_image_composite32 (op, src, mask, dest1,
+			      x / 2, y / 2, x, y, x, y, w, h);
+
+    pixman_set_thread_pool (run_jobs_backwards, NULL, 4, 1);
+    pixman_image_composite32 (op, src, mask, dest2,
+			      x / 2, y / 2, x, y, x, y, w, h);
+    pixman_set_thread_pool (NULL, NULL, 0, 0);
+
+    ok = compare_images (dest1, dest2, 0);
+    if (!ok)
+	printf ("test %d: parallel composite differs (%s)\n",
+		testnum, operator_name (op));
+
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (dest1);
+    pixman_image_unref (dest2);
+
+    return ok;
+}
+
+/* Scrolls an image up by compositing a view of its lower rows onto
+ * it. The source doesn't have the bits pointer of the destination, but
+ * shares its memory, so the composite must not be split into bands.
+ */
+static void
+scroll (pixman_image_t *image, int dy)
+{
+    int width = pixman_image_get_width (image);
+    int height = pixman_image_get_height (image);
+    int stride = pixman_image_get_stride (image);
+    uint32_t *bits = pixman_image_get_data (image);
+    pixman_image_t *view;
+
+    view = pixman_image_create_bits (pixman_image_get_format (image),
+				     width, height - dy,
+				     bits + dy * stride / 4, stride);
+    pixman_image_composite32 (PIXMAN_OP_SRC, view, NULL, image,
+			      0, 0, 0, 0, 0, 0, width, height - dy);
+    pixman_image_unref (view);
+}
+
+static pixman_bool_t
+test_scroll (void)
+{
+    pixman_image_t *image1, *image2;
+    pixman_bool_t ok;
+
+    prng_srand (0);
+
+    image1 = make_random_image (PIXMAN_a8r8g8b8, 100, 100, FALSE);
+    image2 = clone_image (image1);
+
+    pixman_set_thread_pool (NULL, NULL, 0, 0);
+    scroll (image1, 7);
+
+    pixman_set_thread_pool (run_jobs_backwards, NULL, 4, 1);
+    scroll (image2, 7);
+    pixman_set_thread_pool (NULL, NULL, 0, 0);
+
+    ok = compare_images (image1, image2, 0);
+    if (!ok)
+	printf ("parallel scroll differs\n");
+
+    pixman_image_unref (image1);
+    pixman_image_unref (image2);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i))
+	    n_failed++;
+    }
+
+    if (!test_scroll ())
+	n_failed++;
+
+    if (n_runs == 0)
+    {
+	printf ("the thread pool was never used\n");
+	return 1;
+    }
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,449 @@
+/*
+ * Check pixman_composite_polygon(): the coverage of triangles is the
+ * exact area of each pixel that they cover, both fill rules treat
+ * overlaps and holes as they should, and compositing the polygon a row
+ * at a time gives the same results as compositing through a mask of the
+ * size of the destination.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "utils.h"
+
+#define SIZE		32
+#define N_TRIANGLES	500
+#define N_TESTS		2000
+#define MAX_CONTOURS	4
+#define MAX_POINTS	8
+#define N_TEETH		400
+
+static const pixman_color_t white = { 0xffff, 0xffff, 0xffff, 0xffff };
+
+static const pixman_op_t operators[] =
+{
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_OUT_REVERSE,
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_IN,
+    PIXMAN_OP_CLEAR,
+};
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+/* The coverage of a polygon in an a8 image */
+static pixman_image_t *
+rasterize (pixman_fill_rule_t fill_rule, int x_off, int y_off,
+	   int width, int height, int n_contours, const int *n_points,
+	   const pixman_point_fixed_t *points)
+{
+    pixman_image_t *src = pixman_image_create_solid_fill (&white);
+    pixman_image_t *mask = pixman_image_create_bits (PIXMAN_a8, width, height,
+						     NULL, -1);
+
+    pixman_composite_polygon (PIXMAN_OP_ADD, src, mask, fill_rule,
+			      0, 0, x_off, y_off, n_contours, n_points, points);
+    pixman_image_unref (src);
+
+    return mask;
+}
+
+static uint8_t
+get_alpha (pixman_image_t *image, int x, int y)
+{
+    uint8_t *bits = (uint8_t *)pixman_image_get_data (image);
+
+    return bits[y * pixman_image_get_stride (image) + x];
+}
+
+typedef struct
+{
+    double x, y;
+} point_t;
+
+/* Clip a convex polygon to the half plane where the coordinate selected
+ * by axis, times sign, is at least limit times sign.
+ */
+static int
+clip_polygon (const point_t *in, int n, point_t *out,
+	      int axis, double limit, double sign)
+{
+    int i, n_out = 0;
+
+    for (i = 0; i < n; ++i)
+    {
+	const point_t *p = &in[i], *q = &in[(i + 1) % n];
+	double dp = sign * ((axis ? p->y : p->x) - limit);
+	double dq = sign * ((axis ? q->y : q->x) - limit);
+
+	if (dp >= 0)
+	    out[n_out++] = *p;
+
+	if ((dp >= 0) != (dq >= 0))
+	{
+	    double t = dp / (dp - dq);
+
+	    out[n_out].x = p->x + t * (q->x - p->x);
+	    out[n_out].y = p->y + t * (q->y - p->y);
+	    n_out++;
+	}
+    }
+
+    return n_out;
+}
+
+static double
+pixel_area (const point_t *triangle, int x, int y)
+{
+    point_t a[16], b[16];
+    double area = 0;
+    int i, n;
+
+    n = clip_polygon (triangle, 3, a, 0, x, 1);
+    n = clip_polygon (a, n, b, 0, x + 1, -1);
+    n = clip_polygon (b, n, a, 1, y, 1);
+    n = clip_polygon (a, n, b, 1, y + 1, -1);
+
+    for (i = 0; i < n; ++i)
+    {
+	const point_t *p = &b[i], *q = &b[(i + 1) % n];
+
+	area += p->x * q->y - q->x * p->y;
+    }
+
+    return area < 0 ? -area / 2 : area / 2;
+}
+
+static pixman_bool_t
+test_triangles (void)
+{
+    pixman_bool_t ok = TRUE;
+    int i, x, y;
+
+    for (i = 0; i < N_TRIANGLES && ok; ++i)
+    {
+	pixman_point_fixed_t points[3];
+	point_t triangle[3];
+	pixman_image_t *mask;
+	int n_points = 3;
+	int j;
+
+	prng_srand (i);
+
+	/* On the 1/256 grid the rasterizer works on */
+	for (j = 0; j < 3; ++j)
+	{
+	    points[j].x = (prng_rand_n ((SIZE + 8) * 256) - 4 * 256) << 8;
+	    points[j].y = (prng_rand_n ((SIZE + 8) * 256) - 4 * 256) << 8;
+	    triangle[j].x = pixman_fixed_to_double (points[j].x);
+	    triangle[j].y = pixman_fixed_to_double (points[j].y);
+	}
+
+	mask = rasterize (prng_rand_n (2), 0, 0, SIZE, SIZE, 1, &n_points, points);
+
+	for (y = 0; y < SIZE && ok; ++y)
+	{
+	    for (x = 0; x < SIZE && ok; ++x)
+	    {
+		double expected = pixel_area (triangle, x, y) * 256;
+		int alpha = get_alpha (mask, x, y);
+
+		if (expected > 255)
+		    expected = 255;
+
+		if (alpha < expected - 2 || alpha > expected + 2)
+		{
+		    printf ("triangle %d: coverage of %d, %d is %d, not %f\n",
+			    i, x, y, alpha, expected);
+		    ok = FALSE;
+		}
+	    }
+	}
+
+	pixman_image_unref (mask);
+    }
+
+    return ok;
+}
+
+#define P(x, y) { pixman_int_to_fixed (x), pixman_int_to_fixed (y) }
+
+static pixman_bool_t
+check_alpha (const char *what, pixman_image_t *mask, int x, int y, int alpha)
+{
+    if (get_alpha (mask, x, y) != alpha)
+    {
+	printf ("%s: %d, %d is %d, not %d\n",
+		what, x, y, get_alpha (mask, x, y), alpha);
+	return FALSE;
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+test_fill_rules (void)
+{
+    /* Two overlapping squares, and a square with a hole */
+    static const pixman_point_fixed_t squares[] =
+    {
+	P (2, 2), P (12, 2), P (12, 12), P (2, 12),
+	P (6, 6), P (20, 6), P (20, 20), P (6, 20),
+    };
+    static const pixman_point_fixed_t hole[] =
+    {
+	P (2, 2), P (20, 2), P (20, 20), P (2, 20),
+	P (6, 6), P (6, 12), P (12, 12), P (12, 6),
+    };
+    static const int n_points[] = { 4, 4 };
+    /* A pentagram, whose middle is wound twice */
+    pixman_point_fixed_t star[5];
+    int n_star = 5;
+    pixman_bool_t ok = TRUE;
+    pixman_image_t *mask;
+    int i;
+
+    for (i = 0; i < 5; ++i)
+    {
+	double a = i * 4 * M_PI / 5;
+
+	star[i].x = pixman_double_to_fixed (16 + 14 * sin (a));
+	star[i].y = pixman_double_to_fixed (16 - 14 * cos (a));
+    }
+
+    mask = rasterize (PIXMAN_FILL_RULE_WINDING, 0, 0, SIZE, SIZE,
+		      2, n_points, squares);
+    ok &= check_alpha ("winding squares", mask, 3, 3, 0xff);
+    ok &= check_alpha ("winding squares", mask, 8, 8, 0xff);
+    ok &= check_alpha ("winding squares", mask, 14, 3, 0x00);
+    pixman_image_unref (mask);
+
+    mask = rasterize (PIXMAN_FILL_RULE_EVEN_ODD, 0, 0, SIZE, SIZE,
+		      2, n_points, squares);
+    ok &= check_alpha ("even-odd squares", mask, 3, 3, 0xff);
+    ok &= check_alpha ("even-odd squares", mask, 8, 8, 0x00);
+    ok &= check_alpha ("even-odd squares", mask, 15, 15, 0xff);
+    pixman_image_unref (mask);
+
+    for (i = 0; i < 2; ++i)
+    {
+	mask = rasterize (i, 0, 0, SIZE, SIZE, 2, n_points, hole);
+	ok &= check_alpha ("hole", mask, 3, 3, 0xff);
+	ok &= check_alpha ("hole", mask, 8, 8, 0x00);
+	pixman_image_unref (mask);
+    }
+
+    mask = rasterize (PIXMAN_FILL_RULE_WINDING, 0, 0, SIZE, SIZE,
+		      1, &n_star, star);
+    ok &= check_alpha ("winding star", mask, 16, 16, 0xff);
+    pixman_image_unref (mask);
+
+    mask = rasterize (PIXMAN_FILL_RULE_EVEN_ODD, 0, 0, SIZE, SIZE,
+		      1, &n_star, star);
+    ok &= check_alpha ("even-odd star", mask, 16, 16, 0x00);
+    ok &= check_alpha ("even-odd star", mask, 15, 8, 0xff);
+    pixman_image_unref (mask);
+
+    /* Half pixels are half covered */
+    {
+	static const pixman_point_fixed_t rect[] =
+	{
+	    { pixman_double_to_fixed (4.5), pixman_int_to_fixed (4) },
+	    { pixman_double_to_fixed (9.5), pixman_int_to_fixed (4) },
+	    { pixman_double_to_fixed (9.5), pixman_int_to_fixed (8) },
+	    { pixman_double_to_fixed (4.5), pixman_int_to_fixed (8) },
+	};
+	int n_rect = 4;
+
+	mask = rasterize (PIXMAN_FILL_RULE_WINDING, 0, 0, SIZE, SIZE,
+			  1, &n_rect, rect);
+	ok &= check_alpha ("rectangle", mask, 4, 5, 0x80);
+	ok &= check_alpha ("rectangle", mask, 6, 5, 0xff);
+	ok &= check_alpha ("rectangle", mask, 9, 7, 0x80);
+	ok &= check_alpha ("rectangle", mask, 10, 7, 0x00);
+	ok &= check_alpha ("rectangle", mask, 6, 8, 0x00);
+	pixman_image_unref (mask);
+    }
+
+    return ok;
+}
+
+/* A comb with more teeth than a row has room for on the stack */
+static pixman_bool_t
+test_comb (void)
+{
+    pixman_point_fixed_t points[4 * N_TEETH + 2];
+    pixman_image_t *mask;
+    pixman_bool_t ok = TRUE;
+    int n_points = 4 * N_TEETH + 2;
+    int i;
+
+    for (i = 0; i < N_TEETH; ++i)
+    {
+	points[4 * i + 0].x = pixman_int_to_fixed (2 * i);
+	points[4 * i + 0].y = pixman_int_to_fixed (1);
+	points[4 * i + 1].x = pixman_int_to_fixed (2 * i + 1);
+	points[4 * i + 1].y = pixman_int_to_fixed (1);
+	points[4 * i + 2].x = pixman_int_to_fixed (2 * i + 1);
+	points[4 * i + 2].y = pixman_int_to_fixed (4);
+	points[4 * i + 3].x = pixman_int_to_fixed (2 * i + 2);
+	points[4 * i + 3].y = pixman_int_to_fixed (4);
+    }
+
+    /* Close it along the bottom */
+    points[4 * N_TEETH + 0].x = pixman_int_to_fixed (2 * N_TEETH);
+    points[4 * N_TEETH + 0].y = pixman_int_to_fixed (5);
+    points[4 * N_TEETH + 1].x = 0;
+    points[4 * N_TEETH + 1].y = pixman_int_to_fixed (5);
+
+    mask = rasterize (PIXMAN_FILL_RULE_WINDING, 0, 0, 2 * N_TEETH, 6,
+		      1, &n_points, points);
+
+    for (i = 0; i < 2 * N_TEETH && ok; ++i)
+    {
+	ok &= check_alpha ("comb", mask, i, 2, (i & 1) ? 0x00 : 0xff);
+	ok &= check_alpha ("comb", mask, i, 4, 0xff);
+    }
+
+    pixman_image_unref (mask);
+
+    return ok;
+}
+
+static pixman_image_t *
+make_source (void)
+{
+    pixman_image_t *image;
+
+    if (prng_rand_n (2))
+    {
+	pixman_color_t color;
+
+	color.alpha = prng_rand_n (0x10000);
+	color.red = prng_rand_n (color.alpha + 1);
+	color.green = prng_rand_n (color.alpha + 1);
+	color.blue = prng_rand_n (color.alpha + 1);
+
+	return pixman_image_create_solid_fill (&color);
+    }
+
+    image = make_random_image (PIXMAN_a8r8g8b8, prng_rand_n (40) + 1,
+			       prng_rand_n (40) + 1, FALSE);
+    if (prng_rand_n (2))
+	pixman_image_set_repeat (image, PIXMAN_REPEAT_NORMAL);
+
+    return image;
+}
+
+/* Compositing a row at a time is the same as compositing through the
+ * coverage of the whole polygon.
+ */
+static pixman_bool_t
+test_composite (int testnum)
+{
+    pixman_point_fixed_t points[MAX_CONTOURS * MAX_POINTS];
+    int n_points[MAX_CONTOURS];
+    pixman_image_t *src, *dest, *reference, *mask;
+    pixman_fill_rule_t fill_rule;
+    pixman_region32_t clip;
+    pixman_bool_t clipped, ok = TRUE;
+    int n_contours, n_total, width, height;
+    int x_src, y_src, x_dst, y_dst;
+    pixman_op_t op;
+    int i;
+
+    prng_srand (testnum);
+
+    n_contours = prng_rand_n (MAX_CONTOURS) + 1;
+    n_total = 0;
+    for (i = 0; i < n_contours; ++i)
+    {
+	n_points[i] = prng_rand_n (MAX_POINTS + 1);
+	n_total += n_points[i];
+    }
+
+    for (i = 0; i < n_total; ++i)
+    {
+	points[i].x = prng_rand_n (pixman_int_to_fixed (120)) - pixman_int_to_fixed (20);
+	points[i].y = prng_rand_n (pixman_int_to_fixed (80)) - pixman_int_to_fixed (20);
+    }
+
+    width = prng_rand_n (100) + 1;
+    height = prng_rand_n (60) + 1;
+    x_src = prng_rand_n (20) - 10;
+    y_src = prng_rand_n (20) - 10;
+    x_dst = prng_rand_n (20) - 10;
+    y_dst = prng_rand_n (20) - 10;
+    fill_rule = prng_rand_n (2);
+    op = RANDOM_ELT (operators);
+
+    src = make_source ();
+    dest = make_random_image (RANDOM_ELT (dest_formats), width, height, FALSE);
+    reference = clone_image (dest);
+
+    if ((clipped = (prng_rand_n (4) == 0)))
+    {
+	pixman_region32_init_rect (&clip, prng_rand_n (width), prng_rand_n (height),
+				   prng_rand_n (width) + 1, prng_rand_n (height) + 1);
+	pixman_image_set_clip_region32 (dest, &clip);
+	pixman_image_set_clip_region32 (reference, &clip);
+	pixman_region32_fini (&clip);
+    }
+
+    pixman_composite_polygon (op, src, dest, fill_rule, x_src, y_src,
+			      x_dst, y_dst, n_contours, n_points, points);
+
+    if (n_total)
+    {
+	mask = rasterize (fill_rule, x_dst, y_dst, width, height,
+			  n_contours, n_points, points);
+	pixman_image_composite32 (op, src, mask, reference,
+				  x_src - x_dst, y_src - y_dst, 0, 0, 0, 0,
+				  width, height);
+	pixman_image_unref (mask);
+    }
+
+    if (!compare_images (dest, reference, 0))
+    {
+	printf ("test %d: polygon differs (%s, %s, %s)\n", testnum,
+		operator_name (op), format_name (pixman_image_get_format (dest)),
+		clipped ? "clipped" : "not clipped");
+	ok = FALSE;
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+    pixman_image_unref (reference);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    if (!test_triangles ())
+	n_failed++;
+    if (!test_fill_rules ())
+	n_failed++;
+    if (!test_comb ())
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i))
+	    n_failed++;
+    }
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * Check that scaling with a separable convolution filter gives exactly
+ * the same results with every implementation by default, and that with
+ * PIXMAN_SEPARABLE_TWO_PASS every implementation of the two-pass scaler
+ * gives exactly the same results, which are within TOLERANCE of those
+ * of the general implementation. That computes every destination pixel
+ * from the whole two-dimensional kernel and rounds each product of the
+ * horizontal and vertical weights, so the two passes can't match it
+ * exactly.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_SRC_WIDTH	80
+#define MAX_SRC_HEIGHT	60
+#define MAX_DST_WIDTH	100
+#define MAX_DST_HEIGHT	40
+#define MAX_IMPS	32
+#define TOLERANCE	1
+#define N_TESTS		400
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a8b8g8r8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_kernel_t kernels[] =
+{
+    PIXMAN_KERNEL_IMPULSE,
+    PIXMAN_KERNEL_BOX,
+    PIXMAN_KERNEL_LINEAR,
+    PIXMAN_KERNEL_CUBIC,
+    PIXMAN_KERNEL_GAUSSIAN,
+    PIXMAN_KERNEL_LANCZOS2,
+    PIXMAN_KERNEL_LANCZOS3,
+    PIXMAN_KERNEL_LANCZOS3_STRETCHED,
+};
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+    PIXMAN_REPEAT_REFLECT,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static double
+random_scale (void)
+{
+    /* Mostly downscaling, which is what the scaler is for */
+    if (prng_rand_n (4))
+	return 0.1 + prng_rand_n (900) / 1000.0;
+    else
+	return 1.0 + prng_rand_n (2000) / 1000.0;
+}
+
+static void
+composite (pixman_image_t *src, pixman_image_t *dest,
+	   int dest_x, int dest_y, int width, int height)
+{
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+			      dest_x, dest_y, 0, 0, dest_x, dest_y,
+			      width, height);
+}
+
+static int
+channel_difference (uint32_t a, uint32_t b)
+{
+    int max = 0, i;
+
+    for (i = 0; i < 32; i += 8)
+    {
+	int d = (int)((a >> i) & 0xff) - (int)((b >> i) & 0xff);
+
+	if (d < 0)
+	    d = -d;
+	if (d > max)
+	    max = d;
+    }
+
+    return max;
+}
+
+static pixman_bool_t
+test_scale (int testnum, const char **scalers, int n_scalers)
+{
+    pixman_image_t *src, *reference, *dest, *first = NULL;
+    uint32_t *r, *d;
+    pixman_fixed_t *params;
+    pixman_transform_t t;
+    double sx, sy;
+    int n_params, i, j;
+    int width, height, dest_x, dest_y, w, h;
+    pixman_bool_t ok = TRUE;
+
+    prng_srand (testnum);
+
+    src = make_random_image (RANDOM_ELT (formats),
+			     prng_rand_n (MAX_SRC_WIDTH) + 1,
+			     prng_rand_n (MAX_SRC_HEIGHT) + 1, FALSE);
+
+    sx = random_scale ();
+    sy = random_scale ();
+
+    pixman_transform_init_scale (&t,
+				 pixman_double_to_fixed (1 / sx),
+				 pixman_double_to_fixed (1 / sy));
+    pixman_transform_translate (&t, NULL,
+				prng_rand_n (8 * pixman_fixed_1) - 4 * pixman_fixed_1,
+				prng_rand_n (8 * pixman_fixed_1) - 4 * pixman_fixed_1);
+    pixman_image_set_transform (src, &t);
+    pixman_image_set_repeat (src, RANDOM_ELT (repeats));
+
+    params = pixman_filter_create_separable_convolution (
+	&n_params,
+	pixman_double_to_fixed (sx), pixman_double_to_fixed (sy),
+	RANDOM_ELT (kernels), RANDOM_ELT (kernels),
+	RANDOM_ELT (kernels), RANDOM_ELT (kernels),
+	prng_rand_n (5), prng_rand_n (5));
+
+    pixman_image_set_filter (src, PIXMAN_FILTER_SEPARABLE_CONVOLUTION,
+			     params, n_params);
+    free (params);
+
+    width = prng_rand_n (MAX_DST_WIDTH) + 1;
+    height = prng_rand_n (MAX_DST_HEIGHT) + 1;
+    dest_x = prng_rand_n (width);
+    dest_y = prng_rand_n (height);
+    w = prng_rand_n (width - dest_x) + 1;
+    h = prng_rand_n (height - dest_y) + 1;
+
+    reference = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+    dest = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+
+    pixman_set_implementations ("general", NULL);
+    composite (src, reference, dest_x, dest_y, w, h);
+
+    r = pixman_image_get_data (reference);
+    d = pixman_image_get_data (dest);
+
+    for (i = 0; i < n_scalers && ok; ++i)
+    {
+	pixman_set_implementations (scalers[i], NULL);
+
+	pixman_image_set_separable_precision (src, PIXMAN_SEPARABLE_PRECISE);
+	memcpy (d, r, width * height * 4);
+	composite (src, dest, dest_x, dest_y, w, h);
+
+	if (!compare_images (reference, dest, 0))
+	{
+	    printf ("test %d: %s differs from general\n", testnum, scalers[i]);
+	    ok = FALSE;
+	}
+
+	pixman_image_set_separable_precision (src, PIXMAN_SEPARABLE_TWO_PASS);
+	memcpy (d, r, width * height * 4);
+	composite (src, dest, dest_x, dest_y, w, h);
+
+	if (i == 0)
+	{
+	    first = clone_image (dest);
+	}
+	else if (!compare_images (first, dest, 0))
+	{
+	    printf ("test %d: %s differs from %s\n",
+		    testnum, scalers[i], scalers[0]);
+	    ok = FALSE;
+	}
+
+	for (j = 0; j < width * height; ++j)
+	{
+	    if (channel_difference (r[j], d[j]) > TOLERANCE)
+	    {
+		printf ("test %d: %s: %08x differs too much from %08x at %d, %d\n",
+			testnum, scalers[i], d[j], r[j], j % width, j / width);
+		ok = FALSE;
+		break;
+	    }
+	}
+    }
+
+    if (first)
+	pixman_image_unref (first);
+    pixman_image_unref (src);
+    pixman_image_unref (reference);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *scalers[ARRAY_LENGTH (candidates)];
+    int n_names, n_scalers = 0;
+    int i, j, n_failed = 0;
+
+    /* The implementations that are available and have a scaler */
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		scalers[n_scalers++] = candidates[i];
+	}
+    }
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_scale (i, scalers, n_scalers))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * Check the a8r8g8b8_sRGB fast paths: every implementation must give
+ * the same results, and they must be within a small tolerance of the
+ * general implementation, which goes through argb_t. Also check that
+ * composites which don't change a pixel leave it exactly as it was.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	40
+#define MAX_HEIGHT	12
+#define MAX_IMPS	32
+#define N_TESTS		3000
+
+/* Linear and sRGB values are rounded differently */
+#define TOLERANCE	1
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8_sRGB,
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_image_t *
+make_solid (void)
+{
+    pixman_color_t color;
+
+    color.alpha = prng_rand_n (4) ? prng_rand_n (0x10000) : 0xffff;
+    color.red = prng_rand_n (color.alpha + 1);
+    color.green = prng_rand_n (color.alpha + 1);
+    color.blue = prng_rand_n (color.alpha + 1);
+
+    return pixman_image_create_solid_fill (&color);
+}
+
+static pixman_bool_t
+test_composite (int testnum, const char **imps, int n_imps)
+{
+    pixman_format_code_t src_format, dest_format;
+    pixman_image_t *src, *mask = NULL, *reference, *dest, *first = NULL;
+    int width, height, i;
+    pixman_bool_t ok = TRUE;
+    pixman_op_t op;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (ops);
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+
+    dest_format = RANDOM_ELT (formats);
+    if (dest_format == PIXMAN_a8r8g8b8_sRGB)
+	src_format = RANDOM_ELT (formats);
+    else
+	src_format = PIXMAN_a8r8g8b8_sRGB;
+
+    /* Solid sources, possibly with an a8 mask */
+    if (dest_format == PIXMAN_a8r8g8b8_sRGB && prng_rand_n (3) == 0)
+    {
+	src_format = PIXMAN_solid;
+	src = make_solid ();
+	if (prng_rand_n (4))
+	    mask = make_random_image (PIXMAN_a8, width, height, FALSE);
+    }
+    else
+    {
+	src = make_random_image (src_format, width, height, TRUE);
+    }
+
+    dest = make_random_image (dest_format, width, height, TRUE);
+    reference = clone_image (dest);
+
+    pixman_set_implementations ("general", NULL);
+    pixman_image_composite32 (op, src, mask, reference,
+			      0, 0, 0, 0, 0, 0, width, height);
+
+    for (i = 0; i < n_imps && ok; ++i)
+    {
+	pixman_image_t *d = clone_image (dest);
+
+	pixman_set_implementations (imps[i], NULL);
+	pixman_image_composite32 (op, src, mask, d,
+				  0, 0, 0, 0, 0, 0, width, height);
+
+	if (!compare_images (reference, d, TOLERANCE))
+	{
+	    printf ("test %d: %s differs from general (%s, %s%s -> %s)\n",
+		    testnum, imps[i], operator_name (op),
+		    src_format == PIXMAN_solid ? "solid" : format_name (src_format),
+		    mask ? ", a8" : "", format_name (dest_format));
+	    ok = FALSE;
+	}
+
+	if (!first)
+	{
+	    first = d;
+	}
+	else
+	{
+	    if (!compare_images (first, d, 0))
+	    {
+		printf ("test %d: %s differs from %s (%s, %s%s -> %s)\n",
+			testnum, imps[i], imps[0], operator_name (op),
+			src_format == PIXMAN_solid ? "solid" : format_name (src_format),
+			mask ? ", a8" : "", format_name (dest_format));
+		ok = FALSE;
+	    }
+
+	    pixman_image_unref (d);
+	}
+    }
+
+    if (first)
+	pixman_image_unref (first);
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (reference);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+/* Every sRGB value must come back unchanged where OVER has a transparent
+ * source, and a copy through a8r8g8b8 and back must be stable after the
+ * first trip.
+ */
+static pixman_bool_t
+test_identities (void)
+{
+    pixman_image_t *src, *over, *dest, *linear, *again;
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    prng_srand (0);
+
+    src = make_random_image (PIXMAN_a8r8g8b8_sRGB, 256, 1, FALSE);
+    over = make_random_image (PIXMAN_a8r8g8b8, 256, 1, FALSE);
+
+    /* Transparent pixels next to translucent ones */
+    for (i = 0; i < 256; ++i)
+    {
+	pixman_image_get_data (src)[i] = i * 0x01010101U;
+	pixman_image_get_data (over)[i] = (i & 1) ? 0x40302010 : 0;
+    }
+
+    dest = clone_image (src);
+
+    pixman_set_implementations (NULL, NULL);
+
+    pixman_image_composite32 (PIXMAN_OP_OVER, over, NULL, dest,
+			      0, 0, 0, 0, 0, 0, 256, 1);
+    for (i = 0; i < 256; i += 2)
+    {
+	if (pixman_image_get_data (dest)[i] != pixman_image_get_data (src)[i])
+	{
+	    printf ("transparent OVER changes sRGB pixel %08x\n", i * 0x01010101U);
+	    ok = FALSE;
+	}
+    }
+
+    linear = make_random_image (PIXMAN_a8r8g8b8, 256, 1, FALSE);
+    again = make_random_image (PIXMAN_a8r8g8b8, 256, 1, FALSE);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, linear,
+			      0, 0, 0, 0, 0, 0, 256, 1);
+    pixman_image_composite32 (PIXMAN_OP_SRC, linear, NULL, dest,
+			      0, 0, 0, 0, 0, 0, 256, 1);
+    pixman_image_composite32 (PIXMAN_OP_SRC, dest, NULL, again,
+			      0, 0, 0, 0, 0, 0, 256, 1);
+    if (!compare_images (linear, again, 0))
+    {
+	printf ("sRGB to a8r8g8b8 conversion is not stable\n");
+	ok = FALSE;
+    }
+
+    pixman_image_unref (again);
+    pixman_image_unref (linear);
+    pixman_image_unref (over);
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *imps[ARRAY_LENGTH (candidates) + 1];
+    int n_names, n_imps = 0;
+    int i, j, n_failed = 0;
+
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		imps[n_imps++] = candidates[i];
+	}
+    }
+
+    if (!test_identities ())
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i, imps, n_imps))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Check that fills and copies done with non-temporal stores give the
+ * same results as the ones done with ordinary stores.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	300
+#define MAX_HEIGHT	20
+#define N_TESTS		3000
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a1r5g5b5,
+    PIXMAN_a8,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static void
+run_test (pixman_format_code_t format, int bpp, int stride,
+	  uint32_t *src_bits, uint32_t *dst_bits, int testnum)
+{
+    int x = prng_rand_n (MAX_WIDTH);
+    int y = prng_rand_n (MAX_HEIGHT);
+    int w = prng_rand_n (MAX_WIDTH - x) + 1;
+    int h = prng_rand_n (MAX_HEIGHT - y) + 1;
+
+    switch (testnum % 3)
+    {
+    case 0:
+	pixman_fill (dst_bits, stride / 4, bpp, x, y, w, h, prng_rand ());
+	break;
+
+    case 1:
+	pixman_blt (src_bits, dst_bits, stride / 4, stride / 4, bpp, bpp,
+		    prng_rand_n (MAX_WIDTH - w + 1),
+		    prng_rand_n (MAX_HEIGHT - h + 1), x, y, w, h);
+	break;
+
+    case 2:
+	{
+	    pixman_image_t *src, *dest;
+
+	    src = pixman_image_create_bits (
+		format, MAX_WIDTH, MAX_HEIGHT, src_bits, stride);
+	    dest = pixman_image_create_bits (
+		format, MAX_WIDTH, MAX_HEIGHT, dst_bits, stride);
+
+	    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+				      prng_rand_n (MAX_WIDTH - w + 1),
+				      prng_rand_n (MAX_HEIGHT - h + 1),
+				      0, 0, x, y, w, h);
+
+	    pixman_image_unref (src);
+	    pixman_image_unref (dest);
+	}
+	break;
+    }
+}
+
+static pixman_bool_t
+test_streaming (int testnum)
+{
+    pixman_format_code_t format;
+    uint32_t *src_bits, *dst_bits1, *dst_bits2;
+    int bpp, stride, size;
+    pixman_bool_t ok;
+    uint32_t seed;
+
+    prng_srand (testnum);
+
+    format = RANDOM_ELT (formats);
+    bpp = PIXMAN_FORMAT_BPP (format);
+    stride = ((MAX_WIDTH * bpp / 8) + 3) & ~3;
+    size = stride * MAX_HEIGHT;
+
+    src_bits = (uint32_t *)make_random_bytes (size);
+    dst_bits1 = (uint32_t *)make_random_bytes (size);
+    dst_bits2 = malloc (size);
+    memcpy (dst_bits2, dst_bits1, size);
+
+    seed = prng_rand ();
+
+    prng_srand (seed);
+    pixman_set_streaming_threshold (0);
+    run_test (format, bpp, stride, src_bits, dst_bits1, testnum);
+
+    prng_srand (seed);
+    pixman_set_streaming_threshold (1);
+    run_test (format, bpp, stride, src_bits, dst_bits2, testnum);
+
+    ok = memcmp (dst_bits1, dst_bits2, size) == 0;
+    if (!ok)
+	printf ("test %d: streaming stores give different results\n", testnum);
+
+    fence_free (src_bits);
+    fence_free (dst_bits1);
+    free (dst_bits2);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    int i, n_failed = 0;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_streaming (i))
+	    n_failed++;
+    }
+
+    return n_failed ? 1 : 0;
+}
@@ -1,6 +1,7 @@
 #define _GNU_SOURCE
 
 #include "utils.h"
+#include <ctype.h>
 #include <math.h>
 #include <signal.h>
 #include <stdlib.h>
@@ -433,6 +434,188 @@ make_random_bytes (int n_bytes)
     return bytes;
 }
 
+static void
+free_image_bits (pixman_image_t *image, void *data)
+{
+    fence_free (data);
+}
+
+/* The bits of a pixel that hold its alpha channel */
+static uint32_t
+alpha_bits (pixman_format_code_t format)
+{
+    uint32_t a = PIXMAN_FORMAT_A (format);
+    uint32_t m = (a == 32) ? 0xffffffff : (1u << a) - 1;
+
+    if (PIXMAN_FORMAT_TYPE (format) != PIXMAN_TYPE_BGRA &&
+	PIXMAN_FORMAT_TYPE (format) != PIXMAN_TYPE_RGBA &&
+	PIXMAN_FORMAT_TYPE (format) != PIXMAN_TYPE_A)
+    {
+	/* Alpha is at the top of the pixel */
+	m <<= PIXMAN_FORMAT_BPP (format) - a;
+    }
+
+    return a ? m : 0;
+}
+
+pixman_image_t *
+make_random_image (pixman_format_code_t format,
+		   int                  width,
+		   int                  height,
+		   pixman_bool_t        extremes)
+{
+    int bpp = PIXMAN_FORMAT_BPP (format);
+    int stride = ((width * bpp + 31) / 32) * 4;
+    uint8_t *bits = make_random_bytes (stride * height);
+    pixman_image_t *image;
+    int i;
+
+    if (extremes && bpp == 8)
+    {
+	for (i = 0; i < stride * height; ++i)
+	{
+	    switch (prng_rand_n (4))
+	    {
+	    case 0:
+		bits[i] = 0x00;
+		break;
+	    case 1:
+		bits[i] = 0xff;
+		break;
+	    }
+	}
+    }
+    else if (extremes && bpp == 32)
+    {
+	uint32_t *pixels = (uint32_t *)bits;
+	uint32_t alpha = alpha_bits (format);
+
+	for (i = 0; i < stride / 4 * height; ++i)
+	{
+	    switch (prng_rand_n (4))
+	    {
+	    case 0:
+		pixels[i] = 0;
+		break;
+	    case 1:
+		pixels[i] |= alpha;
+		break;
+	    }
+	}
+    }
+
+    image = pixman_image_create_bits (
+	format, width, height, (uint32_t *)bits, stride);
+    pixman_image_set_destroy_function (image, free_image_bits, bits);
+
+    return image;
+}
+
+pixman_image_t *
+clone_image (pixman_image_t *image)
+{
+    int stride = pixman_image_get_stride (image);
+    int height = pixman_image_get_height (image);
+    uint8_t *bits = fence_malloc (stride * height);
+    pixman_image_t *clone;
+
+    memcpy (bits, pixman_image_get_data (image), stride * height);
+
+    clone = pixman_image_create_bits (pixman_image_get_format (image),
+				      pixman_image_get_width (image),
+				      height, (uint32_t *)bits, stride);
+    pixman_image_set_destroy_function (clone, free_image_bits, bits);
+
+    return clone;
+}
+
+static uint64_t
+read_pixel (const uint8_t *row, int x, int bpp)
+{
+    switch (bpp)
+    {
+    case 8:
+	return row[x];
+    case 16:
+	return ((const uint16_t *)row)[x];
+    case 24:
+	return (row[3 * x] << 16) | (row[3 * x + 1] << 8) | row[3 * x + 2];
+    case 32:
+	return ((const uint32_t *)row)[x];
+    case 64:
+	{
+	    uint64_t p;
+
+	    /* Rows may only be 32 bit aligned */
+	    memcpy (&p, row + 8 * x, 8);
+	    return p;
+	}
+    default:
+	return (row[x * bpp / 8] >> (x * bpp % 8)) & ((1 << bpp) - 1);
+    }
+}
+
+pixman_bool_t
+compare_images (pixman_image_t *a, pixman_image_t *b, int tolerance)
+{
+    pixman_format_code_t format = pixman_image_get_format (a);
+    int bpp = PIXMAN_FORMAT_BPP (format);
+    int depth = PIXMAN_FORMAT_DEPTH (format);
+    int width = pixman_image_get_width (a);
+    int height = pixman_image_get_height (a);
+    uint64_t defined = ~(uint64_t)0;
+    int x, y, i;
+
+    if (pixman_image_get_format (b) != format		||
+	pixman_image_get_width (b) != width		||
+	pixman_image_get_height (b) != height)
+    {
+	return FALSE;
+    }
+
+    /* Mask the unused 'x' part */
+    if (depth != 0 && depth < bpp)
+    {
+	defined = ((uint64_t)1 << depth) - 1;
+
+	if (PIXMAN_FORMAT_TYPE (format) == PIXMAN_TYPE_BGRA ||
+	    PIXMAN_FORMAT_TYPE (format) == PIXMAN_TYPE_RGBA)
+	{
+	    defined <<= bpp - depth;
+	}
+    }
+
+    for (y = 0; y < height; ++y)
+    {
+	const uint8_t *ra = (uint8_t *)pixman_image_get_data (a) +
+	    y * pixman_image_get_stride (a);
+	const uint8_t *rb = (uint8_t *)pixman_image_get_data (b) +
+	    y * pixman_image_get_stride (b);
+
+	for (x = 0; x < width; ++x)
+	{
+	    uint64_t pa = read_pixel (ra, x, bpp) & defined;
+	    uint64_t pb = read_pixel (rb, x, bpp) & defined;
+
+	    if (pa == pb)
+		continue;
+
+	    if (tolerance == 0 || bpp != 32)
+		return FALSE;
+
+	    for (i = 0; i < 32; i += 8)
+	    {
+		int d = (int)((pa >> i) & 0xff) - (int)((pb >> i) & 0xff);
+
+		if (d > tolerance || d < -tolerance)
+		    return FALSE;
+	    }
+	}
+    }
+
+    return TRUE;
+}
+
 void
 a8r8g8b8_to_rgba_np (uint32_t *dst, uint32_t *src, int n_pixels)
 {
@@ -944,6 +1127,11 @@ format_name (pixman_format_code_t format)
 {
     switch (format)
     {
+/* 64bpp formats */
+    case PIXMAN_a16b16g16r16: return "a16b16g16r16";
+    case PIXMAN_x16b16g16r16: return "x16b16g16r16";
+    case PIXMAN_a16b16g16r16_float: return "a16b16g16r16_float";
+
 /* 32bpp formats */
     case PIXMAN_a8r8g8b8: return "a8r8g8b8";
     case PIXMAN_x8r8g8b8: return "x8r8g8b8";
@@ -1013,6 +1201,8 @@ format_name (pixman_format_code_t format)
 /* YUV formats */
     case PIXMAN_yuy2: return "yuy2";
     case PIXMAN_yv12: return "yv12";
+    case PIXMAN_i420: return "i420";
+    case PIXMAN_nv12: return "nv12";
     };
 
     /* Fake formats.
@@ -1032,6 +1222,73 @@ format_name (pixman_format_code_t format)
     return "<unknown format>";
 };
 
+static pixman_bool_t
+names_equal (const char *a, const char *b)
+{
+    while (*a && tolower ((unsigned char)*a) == tolower ((unsigned char)*b))
+    {
+	a++;
+	b++;
+    }
+
+    return *a == *b;
+}
+
+static const pixman_format_code_t format_list[] =
+{
+    PIXMAN_a16b16g16r16, PIXMAN_x16b16g16r16, PIXMAN_a16b16g16r16_float,
+    PIXMAN_a8r8g8b8, PIXMAN_x8r8g8b8, PIXMAN_a8b8g8r8, PIXMAN_x8b8g8r8,
+    PIXMAN_b8g8r8a8, PIXMAN_b8g8r8x8, PIXMAN_r8g8b8a8, PIXMAN_r8g8b8x8,
+    PIXMAN_x14r6g6b6, PIXMAN_x2r10g10b10, PIXMAN_a2r10g10b10,
+    PIXMAN_x2b10g10r10, PIXMAN_a2b10g10r10,
+    PIXMAN_a8r8g8b8_sRGB,
+    PIXMAN_r8g8b8, PIXMAN_b8g8r8,
+    PIXMAN_r5g6b5, PIXMAN_b5g6r5,
+    PIXMAN_a1r5g5b5, PIXMAN_x1r5g5b5, PIXMAN_a1b5g5r5, PIXMAN_x1b5g5r5,
+    PIXMAN_a4r4g4b4, PIXMAN_x4r4g4b4, PIXMAN_a4b4g4r4, PIXMAN_x4b4g4r4,
+    PIXMAN_a8, PIXMAN_r3g3b2, PIXMAN_b2g3r3, PIXMAN_a2r2g2b2, PIXMAN_a2b2g2r2,
+    PIXMAN_c8, PIXMAN_g8, PIXMAN_x4c4, PIXMAN_x4g4, PIXMAN_x4a4,
+    PIXMAN_a4, PIXMAN_r1g2b1, PIXMAN_b1g2r1, PIXMAN_a1r1g1b1, PIXMAN_a1b1g1r1,
+    PIXMAN_c4, PIXMAN_g4,
+    PIXMAN_a1, PIXMAN_g1,
+    PIXMAN_yuy2, PIXMAN_yv12, PIXMAN_i420, PIXMAN_nv12,
+};
+
+pixman_format_code_t
+format_from_string (const char *s)
+{
+    int i;
+
+    for (i = 0; i < ARRAY_LENGTH (format_list); ++i)
+    {
+	if (names_equal (format_name (format_list[i]), s))
+	    return format_list[i];
+    }
+
+    return PIXMAN_null;
+}
+
+pixman_op_t
+operator_from_string (const char *s)
+{
+    static const char prefix[] = "PIXMAN_OP_";
+    int op;
+
+    for (op = PIXMAN_OP_CLEAR; op < PIXMAN_OP_NONE; ++op)
+    {
+	const char *name = operator_name (op);
+
+	if (names_equal (name, s) ||
+	    (strncmp (name, prefix, sizeof (prefix) - 1) == 0 &&
+	     names_equal (name + sizeof (prefix) - 1, s)))
+	{
+	    return op;
+	}
+    }
+
+    return PIXMAN_OP_NONE;
+}
+
 static double
 round_channel (double p, int m)
 {
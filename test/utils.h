@@ -90,6 +90,28 @@ fence_free (void *data);
 uint8_t *
 make_random_bytes (int n_bytes);
 
+/* Create an image with random contents in fence_malloced memory, which
+ * is freed along with the image. With extremes, about a quarter of the
+ * pixels of 8 and 32 bpp formats are made transparent and a quarter
+ * opaque, since composite functions often take shortcuts for those.
+ */
+pixman_image_t *
+make_random_image (pixman_format_code_t format,
+		   int                  width,
+		   int                  height,
+		   pixman_bool_t        extremes);
+
+/* Create a copy of a bits image, with its own fence_malloced memory */
+pixman_image_t *
+clone_image (pixman_image_t *image);
+
+/* Return TRUE if the pixels of the images are the same, apart from the
+ * unused 'x' bits of the format. The channels of 32 bpp formats may
+ * differ by up to tolerance in each byte.
+ */
+pixman_bool_t
+compare_images (pixman_image_t *a, pixman_image_t *b, int tolerance);
+
 /* Return current time in seconds */
 double
 gettime (void);
@@ -183,6 +205,16 @@ operator_name (pixman_op_t op);
 const char *
 format_name (pixman_format_code_t format);
 
+/* The inverses of format_name() and operator_name(). Matching is case
+ * insensitive and the PIXMAN_OP_ prefix of operators is optional.
+ * PIXMAN_null or PIXMAN_OP_NONE is returned for unknown names.
+ */
+pixman_format_code_t
+format_from_string (const char *s);
+
+pixman_op_t
+operator_from_string (const char *s);
+
 typedef struct
 {
     double r, g, b, a;
@@ -0,0 +1,262 @@
+/*
+ * Check the 64 bpp formats: every implementation must give the same
+ * results, and the results must match the general implementation,
+ * which goes through argb_t. The exception is OVER from a 64 bpp
+ * source to a8r8g8b8, which fast paths do with 8 bit channels.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	40
+#define MAX_HEIGHT	12
+#define MAX_IMPS	32
+#define N_TESTS		3000
+
+static const pixman_format_code_t wide_formats[] =
+{
+    PIXMAN_a16b16g16r16,
+    PIXMAN_x16b16g16r16,
+    PIXMAN_a16b16g16r16_float,
+};
+
+static const pixman_format_code_t other_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a2r10g10b10,
+    PIXMAN_r5g6b5,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+static pixman_bool_t
+is_wide (pixman_format_code_t format)
+{
+    return PIXMAN_FORMAT_BPP (format) == 64;
+}
+
+static uint16_t
+random_half (void)
+{
+    /* Values from 0 to 1, since combiners clamp anything larger */
+    static const uint16_t specials[] = { 0x0000, 0x0001, 0x3bff, 0x3c00 };
+
+    if (prng_rand_n (8) == 0)
+	return RANDOM_ELT (specials);
+    else
+	return prng_rand_n (0x3c01);
+}
+
+static void
+on_destroy (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static pixman_image_t *
+make_image (pixman_format_code_t format, int width, int height)
+{
+    int bpp = PIXMAN_FORMAT_BPP (format);
+    int stride = ((width * bpp + 31) / 32) * 4;
+    pixman_image_t *image;
+    uint32_t *bits;
+    int i, n;
+
+    /* Odd numbers of words per row, so that 64 bit pixels aren't always
+     * aligned.
+     */
+    if (prng_rand_n (2))
+	stride += 4;
+
+    n = stride / 4 * height;
+    bits = malloc (stride * height);
+
+    if (format == PIXMAN_a16b16g16r16_float)
+    {
+	uint16_t *h = (uint16_t *)bits;
+
+	for (i = 0; i < n * 2; ++i)
+	    h[i] = random_half ();
+    }
+    else
+    {
+	prng_randmemset (bits, stride * height, 0);
+    }
+
+    image = pixman_image_create_bits (format, width, height, bits, stride);
+    pixman_image_set_destroy_function (image, on_destroy, bits);
+
+    return image;
+}
+
+static pixman_bool_t
+test_composite (int testnum, const char **imps, int n_imps)
+{
+    pixman_format_code_t src_format, dest_format;
+    pixman_image_t *src, *mask, *reference, *dest, *first = NULL;
+    int width, height, tolerance, i;
+    pixman_bool_t ok = TRUE;
+    pixman_op_t op;
+
+    prng_srand (testnum);
+
+    src_format = RANDOM_ELT (wide_formats);
+    dest_format = RANDOM_ELT (wide_formats);
+    if (prng_rand_n (2))
+    {
+	if (prng_rand_n (2))
+	    src_format = RANDOM_ELT (other_formats);
+	else
+	    dest_format = RANDOM_ELT (other_formats);
+    }
+
+    op = RANDOM_ELT (ops);
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+
+    src = make_image (src_format, width, height);
+    mask = prng_rand_n (4) ? NULL : make_image (PIXMAN_a8, width, height);
+    dest = make_image (dest_format, width, height);
+    reference = clone_image (dest);
+
+    /* The fast paths do OVER from 64 bpp sources with 8 bit channels */
+    tolerance = 0;
+    if (op == PIXMAN_OP_OVER && !mask && is_wide (src_format) &&
+	(dest_format == PIXMAN_a8r8g8b8 || dest_format == PIXMAN_x8r8g8b8))
+    {
+	tolerance = 2;
+    }
+
+    pixman_set_implementations ("general", NULL);
+    pixman_image_composite32 (op, src, mask, reference,
+			      0, 0, 0, 0, 0, 0, width, height);
+
+    for (i = 0; i < n_imps && ok; ++i)
+    {
+	pixman_image_t *d = clone_image (dest);
+
+	pixman_set_implementations (imps[i], NULL);
+	pixman_image_composite32 (op, src, mask, d,
+				  0, 0, 0, 0, 0, 0, width, height);
+
+	if (!compare_images (reference, d, tolerance))
+	{
+	    printf ("test %d: %s differs from general (%s, %s -> %s)\n",
+		    testnum, imps[i], operator_name (op),
+		    format_name (src_format), format_name (dest_format));
+	    ok = FALSE;
+	}
+
+	if (!first)
+	{
+	    first = d;
+	}
+	else
+	{
+	    if (!compare_images (first, d, 0))
+	    {
+		printf ("test %d: %s differs from %s (%s, %s -> %s)\n",
+			testnum, imps[i], imps[0], operator_name (op),
+			format_name (src_format), format_name (dest_format));
+		ok = FALSE;
+	    }
+
+	    pixman_image_unref (d);
+	}
+    }
+
+    if (first)
+	pixman_image_unref (first);
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (reference);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+/* a8r8g8b8 pixels survive a round trip through a16b16g16r16. They don't
+ * through the half float format, because conversions to 8 bits truncate.
+ */
+static pixman_bool_t
+test_round_trip (void)
+{
+    pixman_image_t *src, *wide, *dest;
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    prng_srand (0);
+
+    src = make_image (PIXMAN_a8r8g8b8, 256, 4);
+
+    /* Make sure every channel value appears */
+    for (i = 0; i < 256; ++i)
+	pixman_image_get_data (src)[i] = i * 0x01010101U;
+
+    dest = clone_image (src);
+    memset (pixman_image_get_data (dest), 0, pixman_image_get_stride (dest) * 4);
+
+    pixman_set_implementations (NULL, NULL);
+
+    wide = make_image (PIXMAN_a16b16g16r16, 256, 4);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, wide,
+			      0, 0, 0, 0, 0, 0, 256, 4);
+    pixman_image_composite32 (PIXMAN_OP_SRC, wide, NULL, dest,
+			      0, 0, 0, 0, 0, 0, 256, 4);
+
+    if (!compare_images (src, dest, 0))
+    {
+	printf ("round trip through a16b16g16r16 is lossy\n");
+	ok = FALSE;
+    }
+
+    pixman_image_unref (wide);
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *imps[ARRAY_LENGTH (candidates) + 1];
+    int n_names, n_imps = 0;
+    int i, j, n_failed = 0;
+
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		imps[n_imps++] = candidates[i];
+	}
+    }
+
+    if (!test_round_trip ())
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i, imps, n_imps))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}
@@ -0,0 +1,338 @@
+/*
+ * Check the YUV formats: every implementation must give exactly the
+ * same results as the general implementation, for unscaled composites
+ * and for nearest and bilinear scaling. Also check that images made
+ * with pixman_image_create_planar() read the same as images whose
+ * planes are in a single buffer.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_WIDTH	64
+#define MAX_HEIGHT	12
+#define MAX_IMPS	32
+#define N_TESTS		3000
+
+static const pixman_format_code_t yuv_formats[] =
+{
+    PIXMAN_yuy2,
+    PIXMAN_yv12,
+    PIXMAN_i420,
+    PIXMAN_nv12,
+};
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+};
+
+#define RANDOM_ELT(a) (a[prng_rand_n (ARRAY_LENGTH (a))])
+
+typedef struct
+{
+    uint8_t *planes[3];
+} planes_t;
+
+static void
+on_destroy (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static void
+on_destroy_planes (pixman_image_t *image, void *data)
+{
+    planes_t *p = data;
+    int i;
+
+    for (i = 0; i < 3; ++i)
+	free (p->planes[i]);
+    free (p);
+}
+
+/* Random samples, with extremes which push the channels out of range */
+static void
+random_samples (uint8_t *p, int n)
+{
+    int i;
+
+    prng_randmemset (p, n, 0);
+
+    for (i = 0; i < n; ++i)
+    {
+	switch (prng_rand_n (8))
+	{
+	case 0:
+	    p[i] = 0;
+	    break;
+	case 1:
+	    p[i] = 0xff;
+	    break;
+	}
+    }
+}
+
+static pixman_image_t *
+make_planar_image (pixman_format_code_t format, int width, int height)
+{
+    int chroma_width = (width + 1) / 2;
+    int chroma_height = (height + 1) / 2;
+    planes_t *p = calloc (1, sizeof (planes_t));
+    int strides[3];
+    int i, n_planes;
+    pixman_image_t *image;
+
+    /* Luma rows are padded to a multiple of 4 bytes, chroma rows may
+     * have any stride.
+     */
+    strides[0] = ((width + 3) & ~3) + 4 * prng_rand_n (2);
+
+    if (format == PIXMAN_nv12)
+    {
+	n_planes = 2;
+	strides[1] = chroma_width * 2 + prng_rand_n (3);
+    }
+    else
+    {
+	n_planes = 3;
+	strides[1] = chroma_width + prng_rand_n (3);
+	strides[2] = chroma_width + prng_rand_n (3);
+    }
+
+    for (i = 0; i < n_planes; ++i)
+    {
+	int rows = i ? chroma_height : height;
+
+	p->planes[i] = malloc (strides[i] * rows);
+	random_samples (p->planes[i], strides[i] * rows);
+    }
+
+    image = pixman_image_create_planar (
+	format, width, height, p->planes, strides);
+    pixman_image_set_destroy_function (image, on_destroy_planes, p);
+
+    return image;
+}
+
+static pixman_image_t *
+make_yuv_image (pixman_format_code_t format, int width, int height)
+{
+    pixman_image_t *image;
+    uint32_t *bits;
+    int stride;
+
+    if (format != PIXMAN_yuy2)
+	return make_planar_image (format, width, height);
+
+    stride = ((width * 2 + 3) & ~3) + 4 * prng_rand_n (2);
+    bits = malloc (stride * height);
+    random_samples ((uint8_t *)bits, stride * height);
+
+    image = pixman_image_create_bits (format, width, height, bits, stride);
+    pixman_image_set_destroy_function (image, on_destroy, bits);
+
+    return image;
+}
+
+static pixman_bool_t
+test_composite (int testnum, const char **imps, int n_imps)
+{
+    pixman_format_code_t src_format, dest_format;
+    pixman_image_t *src, *reference, *dest;
+    pixman_filter_t filter = PIXMAN_FILTER_NEAREST;
+    pixman_transform_t transform;
+    int src_width, src_height, width, height, src_x, src_y, i;
+    pixman_bool_t scaled, ok = TRUE;
+    pixman_fixed_t sx = pixman_fixed_1, sy = pixman_fixed_1;
+    pixman_op_t op;
+
+    prng_srand (testnum);
+
+    src_format = RANDOM_ELT (yuv_formats);
+    dest_format = RANDOM_ELT (dest_formats);
+    op = prng_rand_n (2) ? PIXMAN_OP_SRC : PIXMAN_OP_OVER;
+    width = prng_rand_n (MAX_WIDTH) + 1;
+    height = prng_rand_n (MAX_HEIGHT) + 1;
+
+    scaled = prng_rand_n (3) != 0;
+    if (scaled)
+    {
+	/* From a quarter to four times the size */
+	sx = pixman_fixed_1 / 4 + prng_rand_n (pixman_fixed_1 * 4);
+	sy = pixman_fixed_1 / 4 + prng_rand_n (pixman_fixed_1 * 4);
+	if (prng_rand_n (2))
+	    filter = PIXMAN_FILTER_BILINEAR;
+    }
+
+    /* Mostly large enough for the samples to be inside the source */
+    src_x = prng_rand_n (3);
+    src_y = prng_rand_n (3);
+    src_width = ((int64_t)(src_x + width) * sx >> 16) + 2 - prng_rand_n (2);
+    src_height = ((int64_t)(src_y + height) * sy >> 16) + 2 - prng_rand_n (2);
+
+    /* Samples off every edge, which only PAD fast paths handle */
+    if (scaled && prng_rand_n (4) == 0)
+    {
+	src_x -= prng_rand_n (8);
+	src_y -= prng_rand_n (8);
+	src_width = src_width / 2 + 1;
+	src_height = src_height / 2 + 1;
+    }
+
+    src = make_yuv_image (src_format, src_width, src_height);
+    if (scaled)
+    {
+	pixman_transform_init_scale (&transform, sx, sy);
+	pixman_image_set_transform (src, &transform);
+	pixman_image_set_filter (src, filter, NULL, 0);
+	if (prng_rand_n (2))
+	    pixman_image_set_repeat (src, PIXMAN_REPEAT_PAD);
+    }
+
+    dest = make_random_image (dest_format, width, height, FALSE);
+    reference = clone_image (dest);
+
+    pixman_set_implementations ("general", NULL);
+    pixman_image_composite32 (op, src, NULL, reference,
+			      src_x, src_y, 0, 0, 0, 0, width, height);
+
+    for (i = 0; i < n_imps && ok; ++i)
+    {
+	pixman_image_t *d = clone_image (dest);
+
+	pixman_set_implementations (imps[i], NULL);
+	pixman_image_composite32 (op, src, NULL, d,
+				  src_x, src_y, 0, 0, 0, 0, width, height);
+
+	if (!compare_images (reference, d, 0))
+	{
+	    printf ("test %d: %s differs from general (%s, %s %s -> %s)\n",
+		    testnum, imps[i], operator_name (op),
+		    !scaled ? "unscaled" :
+		    filter == PIXMAN_FILTER_NEAREST ? "nearest" : "bilinear",
+		    format_name (src_format), format_name (dest_format));
+	    ok = FALSE;
+	}
+
+	pixman_image_unref (d);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (reference);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+/* Images with the planes in one buffer must read the same as images
+ * with the same planes in separate buffers.
+ */
+static pixman_bool_t
+test_planar (void)
+{
+    static const pixman_format_code_t formats[] =
+    {
+	PIXMAN_yv12, PIXMAN_i420, PIXMAN_nv12,
+    };
+    int width = 24, height = 6, stride = 24;
+    pixman_bool_t ok = TRUE;
+    int i;
+
+    prng_srand (0);
+
+    for (i = 0; i < ARRAY_LENGTH (formats); ++i)
+    {
+	uint8_t *bits = malloc (stride * height * 3 / 2);
+	uint8_t *y = bits;
+	uint8_t *c0 = bits + stride * height;
+	uint8_t *c1 = c0 + (stride / 2) * (height / 2);
+	uint8_t *planes[3];
+	int strides[3];
+	pixman_image_t *single, *planar, *a, *b;
+
+	random_samples (bits, stride * height * 3 / 2);
+
+	planes[0] = y;
+	strides[0] = stride;
+	if (formats[i] == PIXMAN_nv12)
+	{
+	    planes[1] = c0;
+	    strides[1] = stride;
+	}
+	else
+	{
+	    /* yv12 stores V first, i420 U first */
+	    planes[1] = (formats[i] == PIXMAN_yv12) ? c1 : c0;
+	    planes[2] = (formats[i] == PIXMAN_yv12) ? c0 : c1;
+	    strides[1] = strides[2] = stride / 2;
+	}
+
+	single = pixman_image_create_bits (
+	    formats[i], width, height, (uint32_t *)bits, stride);
+	planar = pixman_image_create_planar (
+	    formats[i], width, height, planes, strides);
+
+	a = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+	b = make_random_image (PIXMAN_a8r8g8b8, width, height, FALSE);
+
+	pixman_set_implementations ("general", NULL);
+	pixman_image_composite32 (PIXMAN_OP_SRC, single, NULL, a,
+				  0, 0, 0, 0, 0, 0, width, height);
+	pixman_image_composite32 (PIXMAN_OP_SRC, planar, NULL, b,
+				  0, 0, 0, 0, 0, 0, width, height);
+
+	if (!compare_images (a, b, 0))
+	{
+	    printf ("%s planes in separate buffers read differently\n",
+		    format_name (formats[i]));
+	    ok = FALSE;
+	}
+
+	pixman_image_unref (a);
+	pixman_image_unref (b);
+	pixman_image_unref (single);
+	pixman_image_unref (planar);
+	free (bits);
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return ok;
+}
+
+int
+main (int argc, const char *argv[])
+{
+    static const char *const candidates[] = { "fast", "sse2", "avx2" };
+    const char *names[MAX_IMPS];
+    const char *imps[ARRAY_LENGTH (candidates) + 1];
+    int n_names, n_imps = 0;
+    int i, j, n_failed = 0;
+
+    n_names = pixman_get_implementations (names, MAX_IMPS);
+    for (i = 0; i < ARRAY_LENGTH (candidates); ++i)
+    {
+	for (j = 0; j < n_names; ++j)
+	{
+	    if (strcmp (names[j], candidates[i]) == 0)
+		imps[n_imps++] = candidates[i];
+	}
+    }
+
+    if (!test_planar ())
+	n_failed++;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_composite (i, imps, n_imps))
+	    n_failed++;
+    }
+
+    pixman_set_implementations (NULL, NULL);
+
+    return n_failed ? 1 : 0;
+}